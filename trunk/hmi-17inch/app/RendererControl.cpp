@@ -123,9 +123,11 @@ void RendererControl::updateVideoWindow()
 
     if (state == QnxCar::VideoPlayer::PlayingState && viewPort.isValid()) {
 
-        windowManager->setZValue(m_rendererPid, ZORDER_HIDE);
+        // applied at once, the video does not show at the old geometry
+        windowManager->begin();
         windowManager->setGeometry(m_rendererPid, viewPort);
         windowManager->setZValue(m_rendererPid, ZORDER_SHOW);
+        windowManager->commit();
         std::cout << "set video geometry ok" << std::endl;
     } else {
         windowManager->setZValue(m_rendererPid, ZORDER_HIDE);
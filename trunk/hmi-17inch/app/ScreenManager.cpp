@@ -1,4 +1,5 @@
 #include "ScreenManager.h"
+#include "WindowManager.h"
 #include <kanzi/kanzi.h>
 #include <iostream>
 #include <QString>
@@ -8,6 +9,7 @@ ScreenManager::ScreenManager(QObject *parent)
     , m_currentScreen(HomeScreen)
     , m_navi_pid(0)
     , m_cameracontrol(NULL)
+    , m_windowManager(NULL)
     , m_appRunning(false)
     , m_isInNavi(false)
 {
@@ -40,8 +42,15 @@ void ScreenManager::setIsInNavi(bool tmps)
 
 void ScreenManager::setCurrentScreen(Screen screen)
 {
+    // the modules show and hide their windows while handling screenSelected
+    if (m_windowManager)
+        m_windowManager->begin();
+
     emit screenSelected(screen, Programmatic);
 
+    if (m_windowManager)
+        m_windowManager->commit();
+
     if (m_currentScreen == screen)
         return;
 
@@ -69,8 +78,14 @@ void ScreenManager::userSelectScreen(Screen screen)
         m_cameracontrol->setCapture(QStringLiteral("stop"));
     }
 
+    if (m_windowManager)
+        m_windowManager->begin();
+
     emit screenSelected(screen, UserInteractive);
 
+    if (m_windowManager)
+        m_windowManager->commit();
+
     if (m_currentScreen == screen)
         return;
 
@@ -166,6 +181,12 @@ void ScreenManager::setCameraControl(QnxCar::CameraControl *cameracontrol)
 }
 
 
+void ScreenManager::setWindowManager(WindowManager *windowManager)
+{
+    m_windowManager = windowManager;
+}
+
+
 void ScreenManager::setAppRunning(bool running)
 {
     m_appRunning = running;
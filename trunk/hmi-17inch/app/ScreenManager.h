@@ -6,6 +6,8 @@
 
 #include "qnxcar/CameraControl.h"
 
+class WindowManager;
+
 /**
  * @short The class that coordinates the logic of switching screens
  */
@@ -84,6 +86,11 @@ public Q_SLOTS:
 
     void setCameraControl(QnxCar::CameraControl *cameracontrol);
 
+    /**
+     * Sets the window manager the window changes of a screen switch are applied with, at once.
+     */
+    void setWindowManager(WindowManager *windowManager);
+
     void setAppRunning(bool running);
 
     void naviTmpSolveHmiQue();
@@ -108,6 +115,7 @@ private:
     Screen m_lastScreen;
     Q_PID m_navi_pid;
     QnxCar::CameraControl *m_cameracontrol;
+    WindowManager *m_windowManager;
     bool m_appRunning;
     bool m_isInNavi;
 //    bool m_isFirstStartNavi;
@@ -0,0 +1,533 @@
+#include "ServiceRegistry.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QPointer>
+#include <QQmlContext>
+#include <QRunnable>
+#include <QSaveFile>
+#include <QSet>
+#include <QThread>
+#include <QThreadPool>
+#include <QVector>
+#include <QWaitCondition>
+
+ServiceRegistry *ServiceRegistry::s_instance = 0;
+
+struct ServiceEntry
+{
+    ServiceEntry()
+        : factory(0)
+        , phase(ServiceRegistry::BeforeFirstFrame)
+        , affinity(ServiceRegistry::AnyThread)
+        , created(false)
+    {
+    }
+
+    QString name;
+    ServiceRegistry::Factory factory;
+    ServiceRegistry::Phase phase;
+    QStringList dependencies;
+    ServiceRegistry::ThreadAffinity affinity;
+    /// the engine may delete QML singletons before the registry
+    QPointer<QObject> object;
+    bool created;
+};
+
+struct TimelineEvent
+{
+    QString name;
+    QString category;
+    QString phase;
+    /// in nanoseconds since the registry was created, duration is -1 for instant events
+    qint64 start;
+    qint64 duration;
+    int thread;
+};
+
+static QString phaseName(ServiceRegistry::Phase phase)
+{
+    switch (phase) {
+    case ServiceRegistry::BeforeFirstFrame:
+        return QStringLiteral("BeforeFirstFrame");
+    case ServiceRegistry::AfterFirstFrame:
+        return QStringLiteral("AfterFirstFrame");
+    case ServiceRegistry::OnDemand:
+        return QStringLiteral("OnDemand");
+    }
+
+    return QString();
+}
+
+class ServiceRegistry::Private
+{
+public:
+    explicit Private(ServiceRegistry *qq)
+        : q(qq)
+        , guiThread(QThread::currentThread())
+    {
+        timer.start();
+        threadIds.insert(guiThread, 0);
+    }
+
+    /// adds @p index after its dependencies to @p pending, the caller holds the mutex
+    bool resolve(int index, QList<int> *pending, QSet<int> *visiting);
+
+    /// creates the services in @p pending, which come after their dependencies
+    bool createServices(QList<int> pending);
+
+    /// creates the service on the calling thread, the caller holds the mutex
+    void createService(int index, bool moveToGuiThread);
+
+    /// the caller holds the mutex
+    int threadId(QThread *thread);
+    void addEvent(const QString &name, const QString &category, qint64 start, qint64 duration, const QString &phase = QString());
+
+    ServiceRegistry *q;
+    QThread *guiThread;
+
+    QMutex mutex;
+    /// woken up when a pool thread has created a service
+    QWaitCondition serviceFinished;
+    QVector<ServiceEntry> entries;
+    QHash<QString, int> indexes;
+    /// services in the order they were created, and those created on pool threads since the last look
+    QList<int> creationOrder;
+    QList<int> finished;
+
+    QHash<const QMetaObject *, QString> qmlSingletons;
+
+    QThreadPool pool;
+
+    QElapsedTimer timer;
+    QVector<TimelineEvent> timeline;
+    QHash<QThread *, int> threadIds;
+};
+
+/// Creates a service on a pool thread, and hands it over to the GUI thread
+class ServiceTask : public QRunnable
+{
+public:
+    ServiceTask(ServiceRegistry::Private *d, int index)
+        : m_d(d)
+        , m_index(index)
+    {
+    }
+
+    void run()
+    {
+        QMutexLocker locker(&m_d->mutex);
+        m_d->createService(m_index, true);
+
+        m_d->finished.append(m_index);
+        m_d->serviceFinished.wakeAll();
+    }
+
+private:
+    ServiceRegistry::Private *m_d;
+    const int m_index;
+};
+
+bool ServiceRegistry::Private::resolve(int index, QList<int> *pending, QSet<int> *visiting)
+{
+    const ServiceEntry &entry = entries.at(index);
+    if (entry.created || pending->contains(index))
+        return true;
+
+    if (visiting->contains(index)) {
+        qWarning() << "ServiceRegistry: circular dependency of service" << entry.name;
+        return false;
+    }
+    visiting->insert(index);
+
+    Q_FOREACH (const QString &dependency, entry.dependencies) {
+        const QHash<QString, int>::ConstIterator it = indexes.constFind(dependency);
+        if (it == indexes.constEnd()) {
+            qWarning() << "ServiceRegistry: service" << entry.name << "depends on unknown service" << dependency;
+            return false;
+        }
+
+        if (!resolve(*it, pending, visiting))
+            return false;
+    }
+
+    visiting->remove(index);
+    pending->append(index);
+    return true;
+}
+
+bool ServiceRegistry::Private::createServices(QList<int> pending)
+{
+    QList<int> created;
+    int running = 0;
+
+    mutex.lock();
+    while (!pending.isEmpty() || running > 0) {
+        // start all services whose dependencies are there, on the pool if they can
+        QList<int> guiThreadServices;
+        QList<int>::Iterator it = pending.begin();
+        while (it != pending.end()) {
+            const ServiceEntry &entry = entries.at(*it);
+
+            bool ready = true;
+            Q_FOREACH (const QString &dependency, entry.dependencies) {
+                if (!entries.at(indexes.value(dependency)).created) {
+                    ready = false;
+                    break;
+                }
+            }
+
+            if (!ready) {
+                ++it;
+                continue;
+            }
+
+            if (entry.affinity == AnyThread) {
+                pool.start(new ServiceTask(this, *it));
+                ++running;
+            } else {
+                guiThreadServices.append(*it);
+            }
+            it = pending.erase(it);
+        }
+
+        Q_FOREACH (int index, guiThreadServices) {
+            createService(index, false);
+            created.append(index);
+        }
+
+        if (guiThreadServices.isEmpty()) {
+            // nothing left that could become ready
+            if (running == 0)
+                break;
+
+            while (finished.isEmpty())
+                serviceFinished.wait(&mutex);
+        }
+
+        running -= finished.size();
+        created += finished;
+        finished.clear();
+    }
+
+    bool ok = pending.isEmpty();
+
+    QStringList names;
+    QList<QObject *> objects;
+    Q_FOREACH (int index, created) {
+        const ServiceEntry &entry = entries.at(index);
+        if (!entry.object) {
+            ok = false;
+            continue;
+        }
+
+        names.append(entry.name);
+        objects.append(entry.object);
+    }
+    mutex.unlock();
+
+    for (int i = 0; i < names.size(); ++i)
+        emit q->serviceCreated(names.at(i), objects.at(i));
+
+    return ok;
+}
+
+void ServiceRegistry::Private::createService(int index, bool moveToGuiThread)
+{
+    const Factory factory = entries.at(index).factory;
+    const int thread = threadId(QThread::currentThread());
+
+    // dependencies are looked up with service() while it is created
+    mutex.unlock();
+    const qint64 start = timer.nsecsElapsed();
+    QObject *object = factory(q);
+    const qint64 end = timer.nsecsElapsed();
+
+    // services depending on it may only see it on the GUI thread
+    if (object && moveToGuiThread)
+        object->moveToThread(guiThread);
+    mutex.lock();
+
+    ServiceEntry &entry = entries[index];
+    entry.object = object;
+    entry.created = true;
+    creationOrder.append(index);
+
+    if (!object)
+        qWarning() << "ServiceRegistry: could not create service" << entry.name;
+
+    TimelineEvent event;
+    event.name = entry.name;
+    event.category = QStringLiteral("service");
+    event.phase = phaseName(entry.phase);
+    event.start = start;
+    event.duration = end - start;
+    event.thread = thread;
+    timeline.append(event);
+}
+
+int ServiceRegistry::Private::threadId(QThread *thread)
+{
+    QHash<QThread *, int>::ConstIterator it = threadIds.constFind(thread);
+    if (it != threadIds.constEnd())
+        return *it;
+
+    const int id = threadIds.size();
+    threadIds.insert(thread, id);
+    return id;
+}
+
+void ServiceRegistry::Private::addEvent(const QString &name, const QString &category, qint64 start, qint64 duration, const QString &phase)
+{
+    TimelineEvent event;
+    event.name = name;
+    event.category = category;
+    event.phase = phase;
+    event.start = start;
+    event.duration = duration;
+    event.thread = threadId(QThread::currentThread());
+    timeline.append(event);
+}
+
+ServiceRegistry::ServiceRegistry(QObject *parent)
+    : QObject(parent)
+    , d(new Private(this))
+{
+    s_instance = this;
+}
+
+ServiceRegistry::~ServiceRegistry()
+{
+    d->pool.waitForDone();
+
+    for (int i = d->creationOrder.size() - 1; i >= 0; --i)
+        delete d->entries.at(d->creationOrder.at(i)).object.data();
+
+    delete d;
+    s_instance = 0;
+}
+
+ServiceRegistry *ServiceRegistry::self()
+{
+    if (!s_instance) {
+        qWarning() << Q_FUNC_INFO << "Accessing ServiceRegistry::self() in uninitialized state";
+    }
+    return s_instance;
+}
+
+void ServiceRegistry::add(const QString &name, Factory factory, Phase phase,
+                          const QStringList &dependencies, ThreadAffinity affinity)
+{
+    Q_ASSERT(factory);
+
+    QMutexLocker locker(&d->mutex);
+    if (d->indexes.contains(name)) {
+        qWarning() << "ServiceRegistry: service" << name << "added twice";
+        return;
+    }
+
+    ServiceEntry entry;
+    entry.name = name;
+    entry.factory = factory;
+    entry.phase = phase;
+    entry.dependencies = dependencies;
+    entry.affinity = affinity;
+
+    d->indexes.insert(name, d->entries.size());
+    d->entries.append(entry);
+}
+
+bool ServiceRegistry::start(Phase phase)
+{
+    Q_ASSERT(QThread::currentThread() == d->guiThread);
+
+    const qint64 start = timestamp();
+
+    QList<int> pending;
+    {
+        QMutexLocker locker(&d->mutex);
+        for (int i = 0; i < d->entries.size(); ++i) {
+            if (d->entries.at(i).phase != phase)
+                continue;
+
+            QSet<int> visiting;
+            if (!d->resolve(i, &pending, &visiting))
+                return false;
+        }
+    }
+
+    const bool ok = d->createServices(pending);
+
+    QMutexLocker locker(&d->mutex);
+    d->addEvent(phaseName(phase), QStringLiteral("phase"), start, timestamp() - start);
+
+    return ok;
+}
+
+QObject *ServiceRegistry::service(const QString &name)
+{
+    QMutexLocker locker(&d->mutex);
+
+    const QHash<QString, int>::ConstIterator it = d->indexes.constFind(name);
+    if (it == d->indexes.constEnd()) {
+        qWarning() << "ServiceRegistry: unknown service" << name;
+        return 0;
+    }
+
+    const int index = *it;
+    if (d->entries.at(index).created)
+        return d->entries.at(index).object;
+
+    if (QThread::currentThread() != d->guiThread) {
+        qWarning() << "ServiceRegistry: service" << name << "is not created yet, add it as a dependency";
+        return 0;
+    }
+
+    QList<int> pending;
+    QSet<int> visiting;
+    if (!d->resolve(index, &pending, &visiting))
+        return 0;
+
+    locker.unlock();
+    d->createServices(pending);
+    locker.relock();
+
+    return d->entries.at(index).object;
+}
+
+bool ServiceRegistry::isCreated(const QString &name) const
+{
+    QMutexLocker locker(&d->mutex);
+
+    const QHash<QString, int>::ConstIterator it = d->indexes.constFind(name);
+    return it != d->indexes.constEnd() && d->entries.at(*it).created;
+}
+
+void ServiceRegistry::exportTo(QQmlContext *context) const
+{
+    QMutexLocker locker(&d->mutex);
+
+    Q_FOREACH (int index, d->creationOrder) {
+        const ServiceEntry &entry = d->entries.at(index);
+        if (!entry.object)
+            continue;
+
+        // accessed through the singleton instead
+        if (d->qmlSingletons.values().contains(entry.name))
+            continue;
+
+        context->setContextProperty(QLatin1Char('_') + entry.name, entry.object);
+    }
+}
+
+void ServiceRegistry::setQmlSingletonName(const QMetaObject *metaObject, const QString &name)
+{
+    QMutexLocker locker(&d->mutex);
+    d->qmlSingletons.insert(metaObject, name);
+}
+
+QObject *ServiceRegistry::qmlSingletonService(const QMetaObject *metaObject)
+{
+    QString name;
+    {
+        QMutexLocker locker(&d->mutex);
+        name = d->qmlSingletons.value(metaObject);
+    }
+
+    if (name.isEmpty())
+        return 0;
+
+    const qint64 start = timestamp();
+    QObject *object = service(name);
+
+    QMutexLocker locker(&d->mutex);
+    d->addEvent(QStringLiteral("QML access: ") + name, QStringLiteral("startup"), start, timestamp() - start);
+
+    return object;
+}
+
+qint64 ServiceRegistry::timestamp() const
+{
+    return d->timer.nsecsElapsed();
+}
+
+void ServiceRegistry::addSpan(const QString &name, qint64 start)
+{
+    QMutexLocker locker(&d->mutex);
+    d->addEvent(name, QStringLiteral("startup"), start, timestamp() - start);
+}
+
+void ServiceRegistry::addMark(const QString &name)
+{
+    QMutexLocker locker(&d->mutex);
+    d->addEvent(name, QStringLiteral("startup"), timestamp(), -1);
+}
+
+bool ServiceRegistry::writeTimeline(const QString &fileName) const
+{
+    const qint64 pid = QCoreApplication::applicationPid();
+
+    QJsonArray events;
+    {
+        QMutexLocker locker(&d->mutex);
+
+        QHash<QThread *, int>::ConstIterator it = d->threadIds.constBegin();
+        for (; it != d->threadIds.constEnd(); ++it) {
+            QJsonObject args;
+            args.insert(QStringLiteral("name"), it.value() == 0 ? QStringLiteral("GUI thread")
+                                                                : QStringLiteral("Pool thread %1").arg(it.value()));
+
+            QJsonObject event;
+            event.insert(QStringLiteral("name"), QStringLiteral("thread_name"));
+            event.insert(QStringLiteral("ph"), QStringLiteral("M"));
+            event.insert(QStringLiteral("pid"), pid);
+            event.insert(QStringLiteral("tid"), it.value());
+            event.insert(QStringLiteral("args"), args);
+            events.append(event);
+        }
+
+        Q_FOREACH (const TimelineEvent &timelineEvent, d->timeline) {
+            // timestamps are in microseconds
+            QJsonObject event;
+            event.insert(QStringLiteral("name"), timelineEvent.name);
+            event.insert(QStringLiteral("cat"), timelineEvent.category);
+            event.insert(QStringLiteral("pid"), pid);
+            event.insert(QStringLiteral("tid"), timelineEvent.thread);
+            event.insert(QStringLiteral("ts"), timelineEvent.start / 1000.0);
+            if (timelineEvent.duration < 0) {
+                event.insert(QStringLiteral("ph"), QStringLiteral("i"));
+                event.insert(QStringLiteral("s"), QStringLiteral("p"));
+            } else {
+                event.insert(QStringLiteral("ph"), QStringLiteral("X"));
+                event.insert(QStringLiteral("dur"), timelineEvent.duration / 1000.0);
+            }
+
+            if (!timelineEvent.phase.isEmpty()) {
+                QJsonObject args;
+                args.insert(QStringLiteral("phase"), timelineEvent.phase);
+                event.insert(QStringLiteral("args"), args);
+            }
+
+            events.append(event);
+        }
+    }
+
+    QJsonObject trace;
+    trace.insert(QStringLiteral("traceEvents"), events);
+    trace.insert(QStringLiteral("displayTimeUnit"), QStringLiteral("ms"));
+
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "ServiceRegistry: could not write the timeline to" << fileName << file.errorString();
+        return false;
+    }
+
+    file.write(QJsonDocument(trace).toJson());
+    return file.commit();
+}
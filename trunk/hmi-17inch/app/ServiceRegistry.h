@@ -0,0 +1,161 @@
+#ifndef APP_SERVICEREGISTRY_H
+#define APP_SERVICEREGISTRY_H
+
+#include <QObject>
+#include <QQmlEngine>
+#include <QStringList>
+
+class QQmlContext;
+
+/**
+ * @short Creates the business logic objects the HMI exports to QML
+ *
+ * Services are added with the services they depend on and the phase of the startup they have to be
+ * ready in. start() creates the services of a phase after their dependencies, those that may be created
+ * on any thread concurrently on a thread pool. They are moved to the GUI thread before start() returns.
+ *
+ * The registry records when each service was created, and on which thread. writeTimeline() writes
+ * this as a Chrome trace (chrome://tracing, or the Perfetto UI), together with the spans added with
+ * addSpan() for the other steps of the startup.
+ */
+class ServiceRegistry : public QObject
+{
+    Q_OBJECT
+
+public:
+    /// When a service has to be ready
+    enum Phase {
+        /// The first frame binds to it, created before the QML view is loaded
+        BeforeFirstFrame,
+        /// Not bound to by QML, created once the first frame is shown
+        AfterFirstFrame,
+        /// Created when it is used the first time, by QML or by a service depending on it
+        OnDemand
+    };
+
+    enum ThreadAffinity {
+        /// Has to be created on the GUI thread, e.g. because it uses an SQL connection
+        GuiThread,
+        /// May be created on a pool thread, it is moved to the GUI thread with its children
+        AnyThread
+    };
+
+    /// Creates a service, dependencies are available with service()
+    typedef QObject *(*Factory)(ServiceRegistry *registry);
+
+    explicit ServiceRegistry(QObject *parent = 0);
+
+    /// Deletes the services in the reverse order of their creation
+    ~ServiceRegistry();
+
+    /// Access the single instance of this class
+    static ServiceRegistry *self();
+
+    /**
+     * Adds the service @p name, created by @p factory.
+     *
+     * @param dependencies services that are created before this one
+     */
+    void add(const QString &name, Factory factory, Phase phase,
+             const QStringList &dependencies = QStringList(), ThreadAffinity affinity = AnyThread);
+
+    /// Adds a service of type T created with its default constructor
+    template <typename T>
+    void add(const QString &name, Phase phase,
+             const QStringList &dependencies = QStringList(), ThreadAffinity affinity = AnyThread)
+    {
+        add(name, &createService<T>, phase, dependencies, affinity);
+    }
+
+    /**
+     * Creates the services of @p phase that have not been created yet, and those they depend on.
+     * Returns when all of them are created.
+     *
+     * @return false if a service could not be created, because a dependency is missing or circular
+     */
+    bool start(Phase phase);
+
+    /**
+     * Returns the service @p name, creating it and its dependencies first if it has not been created yet.
+     * Services are only created on the GUI thread, from other threads only created ones are returned.
+     */
+    QObject *service(const QString &name);
+
+    template <typename T>
+    T *service(const QString &name)
+    {
+        return qobject_cast<T *>(service(name));
+    }
+
+    /// Whether the service @p name has been created
+    bool isCreated(const QString &name) const;
+
+    /**
+     * Sets the services created so far as context properties of @p context,
+     * with the name of the service prefixed by an underscore.
+     */
+    void exportTo(QQmlContext *context) const;
+
+    /**
+     * Registers the service @p name as QML singleton @p qmlName of type T.
+     * It is created on demand when QML accesses it the first time.
+     */
+    template <typename T>
+    void registerQmlSingleton(const QString &name, const char *uri, int versionMajor, int versionMinor, const char *qmlName)
+    {
+        setQmlSingletonName(&T::staticMetaObject, name);
+        qmlRegisterSingletonType<T>(uri, versionMajor, versionMinor, qmlName, &qmlSingleton<T>);
+    }
+
+    /// Nanoseconds since the registry was created, the time base of the timeline
+    qint64 timestamp() const;
+
+    /// Adds a span from @p start, as returned by timestamp(), until now to the timeline
+    void addSpan(const QString &name, qint64 start);
+
+    /// Adds an instant event at the current time to the timeline
+    void addMark(const QString &name);
+
+    /**
+     * Writes the timeline as Chrome trace event JSON to @p fileName.
+     * @return false if the file could not be written
+     */
+    bool writeTimeline(const QString &fileName) const;
+
+Q_SIGNALS:
+    /// Emitted on the GUI thread when a service has been created
+    void serviceCreated(const QString &name, QObject *service);
+
+private:
+    template <typename T>
+    static QObject *createService(ServiceRegistry *registry)
+    {
+        Q_UNUSED(registry);
+        return new T;
+    }
+
+    template <typename T>
+    static QObject *qmlSingleton(QQmlEngine *engine, QJSEngine *scriptEngine)
+    {
+        Q_UNUSED(engine);
+        Q_UNUSED(scriptEngine);
+
+        QObject *service = self()->qmlSingletonService(&T::staticMetaObject);
+        // the registry deletes it
+        if (service)
+            QQmlEngine::setObjectOwnership(service, QQmlEngine::CppOwnership);
+        return service;
+    }
+
+    void setQmlSingletonName(const QMetaObject *metaObject, const QString &name);
+    QObject *qmlSingletonService(const QMetaObject *metaObject);
+
+    class Private;
+    Private *const d;
+
+    static ServiceRegistry *s_instance;
+
+    friend class ServiceTask;
+};
+
+#endif
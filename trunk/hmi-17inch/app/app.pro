@@ -17,6 +17,8 @@ DEPENDPATH += $$PWD/../qpps
 win32: LIBPATH += $$BUILD_ROOT/bin
 else: LIBPATH += $$BUILD_ROOT/lib
 LIBS += -lqpps
+# the same condition as simulator_build in qpps.pro
+!qnx:!pps_server: DEFINES += QPPS_SIMULATOR_BUILD
 
 # qtqnxcar2
 INCLUDEPATH += $$PWD/../qtqnxcar2/qtqnxcar2
@@ -66,6 +68,7 @@ SOURCES += \
 	ProfileSettingsManager.cpp \
 	RendererControl.cpp \
 	ScreenManager.cpp \
+	ServiceRegistry.cpp \
 	Status.cpp \
 	Util.cpp \
 		VoiceInput.cpp
@@ -80,6 +83,7 @@ HEADERS += \
 	ProfileSettingsManager.h \
 	RendererControl.h \
 	ScreenManager.h \
+	ServiceRegistry.h \
 	Status.h \
 	Util.h \
 		VoiceInput.h \
@@ -317,9 +317,11 @@ void ApplicationManager::hideApplication()
 
 void ApplicationManager::fitToViewPort(Q_PID pid)
 {
+    m_windowManager->begin();
     m_windowManager->setPosition(pid, m_applicationGeometry.topLeft());
     m_windowManager->setClipPosition(pid, m_applicationGeometry.topLeft());
     m_windowManager->setClipSize(pid, m_applicationGeometry.size());
+    m_windowManager->commit();
 }
 
 bool ApplicationManager::isExternalApplicaionLaunching() {
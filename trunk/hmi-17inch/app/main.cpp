@@ -44,6 +44,7 @@
 #include "ProfileSettingsManager.h"
 #include "RendererControl.h"
 #include "ScreenManager.h"
+#include "ServiceRegistry.h"
 #include "Status.h"
 #include "Util.h"
 #include "VoiceInput.h"
@@ -68,6 +69,7 @@
 #include <QQmlContext>
 #include <QQuickView>
 #include <QRect>
+#include <QStandardPaths>
 #include <QStringListModel>
 #include <QThread>
 #include <QDateTime>
@@ -193,36 +195,128 @@ void QuickViewStateHandler::handleWindowGroupPosted(const QString &windowGroup,
 #endif
 }
 
-//#define  DEBUG_TEST
-int main(int argc, char **argv)
+/**
+ * Creates the services not needed for the first frame once it has been shown,
+ * and writes the startup timeline if it was requested with --startup-trace=FILE.
+ */
+class StartupHandler : public QObject
 {
-#ifdef DEBUG_TEST
-    QString sFilePath = QStringLiteral( "/var/logg.txt");
+    Q_OBJECT
+public:
+    StartupHandler(QQuickView *view, ServiceRegistry *registry, const QString &traceFile, QObject *parent = 0)
+        : QObject(parent), m_view(view), m_registry(registry), m_traceFile(traceFile), m_frameSwappedHandled(false) {}
 
-    QFile file(sFilePath);
-    if (!file.open(QIODevice::WriteOnly|QIODevice::Text)) {
-        QMessageBox::critical(NULL, "提示", "无法创建文件");
-        return -1;
-    }
-    QTextStream out(&file);
-    QTime current_time ;
-    current_time = QTime::currentTime();
-    int hournow = current_time.hour();//当前的小时
-    int minutenow = current_time.minute();//当前的分
-    int secondnow = current_time.second();//当前的秒
-    int msecnow = current_time.msec();//当前的毫秒
-    out << "start:" << hournow << ":"<<minutenow << ":"<<secondnow << msecnow << endl;
-    qDebug() << "start:" << hournow << ":"<<minutenow << ":"<<secondnow << msecnow;
+public Q_SLOTS:
+    void frameSwapped();
+
+private:
+    QQuickView *m_view;
+    ServiceRegistry *m_registry;
+    QString m_traceFile;
+    bool m_frameSwappedHandled;
+};
+
+void StartupHandler::frameSwapped()
+{
+    if (m_frameSwappedHandled)
+        return;
+    m_frameSwappedHandled = true;
+
+    m_view->disconnect(this);
+    m_registry->addMark(QStringLiteral("First frame"));
+
+    if (!m_registry->start(ServiceRegistry::AfterFirstFrame))
+        qWarning() << "Could not create the services used after the first frame";
+
+    if (!m_traceFile.isEmpty())
+        m_registry->writeTimeline(m_traceFile);
+}
+
+static QObject *createRadio(ServiceRegistry *registry)
+{
+    Q_UNUSED(registry);
+
+    QnxCar::Radio *radio = new QnxCar::Radio;
+    radio->setSimulationModeEnabled(false);
+    return radio;
+}
+
+static QObject *createProfileModel(ServiceRegistry *registry)
+{
+    Q_UNUSED(registry);
+
+    // owned by the HMI, so its reads may run next to a write
+    QnxCar::DatabaseManager::setWriteAheadLogging(QStringLiteral("personalization.db"), true);
+    return new QnxCar::ProfileModel(QnxCar::DatabaseManager::database(QStringLiteral("personalization.db")));
+}
+
+static QObject *createProfileManager(ServiceRegistry *registry)
+{
+    return new QnxCar::ProfileManager(registry->service<QnxCar::ProfileModel>(QStringLiteral("profileModel")));
+}
+
+/**
+ * Adds the business logic objects exported to QML. The PPS based ones are created concurrently, except
+ * on the PPS simulator, those using an SQL connection or owning objects without parent on the GUI thread.
+ */
+static void addServices(ServiceRegistry *registry)
+{
+    const ServiceRegistry::Phase visible = ServiceRegistry::BeforeFirstFrame;
+
+#ifdef QPPS_SIMULATOR_BUILD
+    // the PPS simulator is a singleton without locking, its clients must not be created concurrently
+    const ServiceRegistry::ThreadAffinity pps = ServiceRegistry::GuiThread;
+#else
+    const ServiceRegistry::ThreadAffinity pps = ServiceRegistry::AnyThread;
 #endif
-    WindowManager windowManager;
-#ifdef DEBUG_TEST
-    current_time = QTime::currentTime();
-    hournow = current_time.hour();//当前的小时
-    minutenow = current_time.minute();//当前的分
-    secondnow = current_time.second();//当前的秒
-    //qDebug() << "window Manager initover:" << hournow << ":"<<minutenow << ":" <<secondnow<< msecnow;
-    out << "window Manager initover:" << hournow << ":"<<minutenow << ":"<<secondnow << msecnow << endl;
+
+    registry->add<QnxCar::AudioControl>(QStringLiteral("audioControl"), visible, QStringList(), pps);
+    registry->add<QnxCar::Bluetooth>(QStringLiteral("bluetooth"), visible, QStringList(), pps);
+    registry->add<QnxCar::Wifi>(QStringLiteral("wifi"), visible, QStringList(), pps);
+    registry->add<QnxCar::HotSpot>(QStringLiteral("hotspot"), visible, QStringList(), pps);
+    registry->add<QnxCar::Hvac>(QStringLiteral("hvac"), visible, QStringList(), pps);
+    registry->add<QnxCar::SmartDevice>(QStringLiteral("smartdevice"), visible, QStringList(), pps);
+    registry->add<QnxCar::ThemeControl>(QStringLiteral("themecontrol"), visible, QStringList(), pps);
+    registry->add<QnxCar::SeatControl>(QStringLiteral("seatcontrol"), visible, QStringList(), pps);
+    registry->add<QnxCar::MusicControl>(QStringLiteral("musiccontrol"), visible, QStringList(), pps);
+    registry->add<QnxCar::CarDoorControl>(QStringLiteral("cardoorcontrol"), visible, QStringList(), pps);
+    registry->add<QnxCar::AppStatus>(QStringLiteral("appstatus"), visible, QStringList(), pps);
+    registry->add<QnxCar::CameraControl>(QStringLiteral("cameracontrol"), visible, QStringList(), pps);
+    registry->add<QnxCar::LampStatus>(QStringLiteral("lampStatus"), visible, QStringList(), pps);
+    registry->add<QnxCar::Geolocation>(QStringLiteral("geolocation"), visible, QStringList(), pps);
+    registry->add(QStringLiteral("radio"), &createRadio, visible, QStringList(), pps);
+    registry->add<QnxCar::Sensors>(QStringLiteral("sensors"), visible, QStringList(), pps);
+    registry->add<QnxCar::Settings>(QStringLiteral("settings"), visible, QStringList(), pps);
+    registry->add<Status>(QStringLiteral("status"), visible, QStringList(), pps);
+    registry->add<QnxCar::Theme>(QStringLiteral("theme"), visible, QStringList(), pps);
+    registry->add<Util>(QStringLiteral("util"), visible, QStringList(), pps);
+    registry->add<QnxCar::User>(QStringLiteral("user"), visible, QStringList(), pps);
+    registry->add<QnxCar::HmiNotificationManager>(QStringLiteral("hmiNotificationManager"), visible, QStringList(), pps);
+
+    // the call duration timer of Phone, the VoiceControl of VoiceInput and the states of
+    // SmartDeviceWorkflow have no parent, they would stay on a pool thread
+    registry->add<QnxCar::Phone>(QStringLiteral("phone"), visible, QStringList(), ServiceRegistry::GuiThread);
+    registry->add<VoiceInput>(QStringLiteral("voiceInput"), visible, QStringList(), ServiceRegistry::GuiThread);
+    registry->add<SmartDeviceWorkflow>(QStringLiteral("smartDevices"), visible, QStringList(), ServiceRegistry::GuiThread);
+    registry->add(QStringLiteral("profileModel"), &createProfileModel, visible, QStringList(), ServiceRegistry::GuiThread);
+    registry->add(QStringLiteral("profileManager"), &createProfileManager, visible,
+                  QStringList() << QStringLiteral("profileModel"), ServiceRegistry::GuiThread);
+
+    // not used by the HMI itself
+    registry->add<QnxCar::VoiceControl>(QStringLiteral("voiceControl"), ServiceRegistry::AfterFirstFrame, QStringList(), pps);
+
+#ifndef NO_APP_SETTINGS
+    // only used by the settings pages
+    registry->add<QnxCar::SystemInfo>(QStringLiteral("systemInfo"), ServiceRegistry::OnDemand, QStringList(), ServiceRegistry::GuiThread);
+    registry->add<QnxCar::NetworkInfo>(QStringLiteral("networkInfo"), ServiceRegistry::OnDemand, QStringList(), ServiceRegistry::GuiThread);
+    registry->registerQmlSingleton<QnxCar::SystemInfo>(QStringLiteral("systemInfo"), "com.qnx.car.services", 2, 0, "SystemInfo");
+    registry->registerQmlSingleton<QnxCar::NetworkInfo>(QStringLiteral("networkInfo"), "com.qnx.car.services", 2, 0, "NetworkInfo");
 #endif
+}
+
+int main(int argc, char **argv)
+{
+    WindowManager windowManager;
     if (!windowManager.init()) {
         std::cerr << "Initializing window management failed" << std::endl;
         return 1;
@@ -256,8 +350,14 @@ int main(int argc, char **argv)
 
     QGuiApplication app(argc, argv);
 
+    // the time base of the startup timeline, and the owner of the services, which go before the application
+    ServiceRegistry registry;
+    addServices(&registry);
+
     // init Qt Resources from QnxCarUi library
+    qint64 start = registry.timestamp();
     QnxCarUi::initQtResources();
+    registry.addSpan(QStringLiteral("Qt resources"), start);
 
     const QString assetsPath = QnxCar::StandardDirs::assetsDirectory();
 
@@ -265,6 +365,13 @@ int main(int argc, char **argv)
         std::cerr << "Could not find assets path, exiting" << std::endl;
         return 1;
     }
+
+    QString startupTraceFile;
+    Q_FOREACH (const QString &argument, app.arguments()) {
+        if (argument.startsWith(QStringLiteral("--startup-trace=")))
+            startupTraceFile = argument.mid(argument.indexOf(QLatin1Char('=')) + 1);
+    }
+
     ApplicationManager applicationManager(&windowManager);
 
     applicationManager.setExternalApplicaionLaunching(false);
@@ -278,14 +385,6 @@ int main(int argc, char **argv)
     // initialize core instance
     Core core(&windowManager, &applicationManager);
 
-#ifdef DEBUG_TEST
-    current_time = QTime::currentTime();
-    hournow = current_time.hour();//当前的小时
-    minutenow = current_time.minute();//当前的分
-    secondnow = current_time.second();//当前的秒
-    qDebug() << "283" << hournow << ":"<<minutenow << ":"<<secondnow<< msecnow;
-    out << "281:" << hournow << ":"<<minutenow << ":"<<secondnow << msecnow << endl;
-#endif
     Q_UNUSED(core);
 /*
     if (!QnxCarUi::loadFonts(assetsPath + QStringLiteral("/fonts"))) {
@@ -295,14 +394,6 @@ int main(int argc, char **argv)
 
     */
 
-#ifdef DEBUG_TEST
-    current_time = QTime::currentTime();
-    hournow = current_time.hour();//当前的小时
-    minutenow = current_time.minute();//当前的分
-    secondnow = current_time.second();//当前的秒
-    qDebug() << "295" << hournow << ":"<<minutenow << ":"<<secondnow<< msecnow;
-    out << "293:" << hournow << ":"<<minutenow << ":"<<secondnow << msecnow << endl;
-#endif
     QThread windowManagerThread;
     windowManagerThread.moveToThread(&windowManagerThread);
     windowManager.moveToThread(&windowManagerThread);
@@ -312,14 +403,7 @@ int main(int argc, char **argv)
     QFont font(QLatin1String("arial"));
     font.setPixelSize(resolutionManager.defaultPixelSize());
     app.setFont(font);
-#ifdef DEBUG_TEST
-    current_time = QTime::currentTime();
-    hournow = current_time.hour();//当前的小时
-    minutenow = current_time.minute();//当前的分
-    secondnow = current_time.second();//当前的秒
-    qDebug() << "309 font over" << hournow << ":"<<minutenow << ":"<<secondnow<< msecnow;
-    out << "308:" << hournow << ":"<<minutenow << ":"<<secondnow << msecnow << endl;
-#endif
+
     if (setup_unix_signal_handlers() != 0)
         qFatal("Couldn't register unix signal handlers!");
 
@@ -355,180 +439,52 @@ int main(int argc, char **argv)
     }
     applicationManager.setApplicationGeometry(resolutionManager.externalApplicationGeometry());
     applicationManager.setScreenGeometry(resolutionManager.sizeForResolution());
-#ifdef DEBUG_TEST
-    current_time = QTime::currentTime();
-    hournow = current_time.hour();//当前的小时
-    minutenow = current_time.minute();//当前的分
-    secondnow = current_time.second();//当前的秒
-    qDebug() << "309 font over" << hournow << ":"<<minutenow << ":"<<secondnow<< msecnow;
-    out << "349:" << hournow << ":"<<minutenow << ":"<<secondnow << msecnow << endl;
-#endif
+
     ScreenManager screenManager;
     AppLauncherServer appLauncherServer;
 
-#ifdef DEBUG_TEST
-    current_time = QTime::currentTime();
-    hournow = current_time.hour();//当前的小时
-    minutenow = current_time.minute();//当前的分
-    secondnow = current_time.second();//当前的秒
-    qDebug() << "309 font over" << hournow << ":"<<minutenow << ":"<<secondnow<< msecnow;
-    out << "357:" << hournow << ":"<<minutenow << ":"<<secondnow << msecnow << endl;
-#endif
-#ifndef NO_APP_SETTINGS
-    QnxCar::SystemInfo systemInfo;
-
-#ifdef DEBUG_TEST
-    current_time = QTime::currentTime();
-    hournow = current_time.hour();//当前的小时
-    minutenow = current_time.minute();//当前的分
-    secondnow = current_time.second();//当前的秒
-    qDebug() << "309 font over" << hournow << ":"<<minutenow << ":"<<secondnow<< msecnow;
-    out << "357:" << hournow << ":"<<minutenow << ":"<<secondnow << msecnow << endl;
-#endif
-    // QnxCar::NetworkInfo networkInfo;
+    if (!registry.start(ServiceRegistry::BeforeFirstFrame))
+        qFatal("Couldn't create the services");
 
-    // networkInfoInitThread.wait();
-
-#endif
+    QnxCar::AudioControl *audioControl = registry.service<QnxCar::AudioControl>(QStringLiteral("audioControl"));
+    QnxCar::Hvac *hvac = registry.service<QnxCar::Hvac>(QStringLiteral("hvac"));
+    QnxCar::Radio *radio = registry.service<QnxCar::Radio>(QStringLiteral("radio"));
+    QnxCar::CameraControl *cameracontrol = registry.service<QnxCar::CameraControl>(QStringLiteral("cameracontrol"));
+    QnxCar::ProfileManager *profileManager = registry.service<QnxCar::ProfileManager>(QStringLiteral("profileManager"));
+    QnxCar::Theme *theme = registry.service<QnxCar::Theme>(QStringLiteral("theme"));
 
-#ifdef DEBUG_TEST
-    current_time = QTime::currentTime();
-    hournow = current_time.hour();//当前的小时
-    minutenow = current_time.minute();//当前的分
-    secondnow = current_time.second();//当前的秒
-    qDebug() << "309 font over" << hournow << ":"<<minutenow << ":"<<secondnow<< msecnow;
-    out << "367:" << hournow << ":"<<minutenow << ":"<<secondnow << msecnow << endl;
-#endif
-    QnxCar::AudioControl audioControl;
-
-#ifdef DEBUG_TEST
-    current_time = QTime::currentTime();
-    hournow = current_time.hour();//当前的小时
-    minutenow = current_time.minute();//当前的分
-    secondnow = current_time.second();//当前的秒
-    qDebug() << "309 font over" << hournow << ":"<<minutenow << ":"<<secondnow<< msecnow;
-    out << "374:" << hournow << ":"<<minutenow << ":"<<secondnow << msecnow << endl;
-#endif
-    QnxCar::Bluetooth bluetooth;
-
-#ifdef DEBUG_TEST
-    current_time = QTime::currentTime();
-    hournow = current_time.hour();//当前的小时
-    minutenow = current_time.minute();//当前的分
-    secondnow = current_time.second();//当前的秒
-    //qDebug() << "309 font over" << hournow << ":"<<minutenow << ":"<<secondnow<< msecnow;
-    out << "364:" << hournow << ":"<<minutenow << ":"<<secondnow << msecnow << endl;
-#endif
-    QnxCar::Wifi wifi;
-#ifdef DEBUG_TEST
-    current_time = QTime::currentTime();
-    hournow = current_time.hour();//当前的小时
-    minutenow = current_time.minute();//当前的分
-    secondnow = current_time.second();//当前的秒
-    //qDebug() << "309 font over" << hournow << ":"<<minutenow << ":"<<secondnow<< msecnow;
-    out << "371:" << hournow << ":"<<minutenow << ":"<<secondnow << msecnow << endl;
-#endif
-    QnxCar::HotSpot hotspot;
-
-    QnxCar::NetworkInfo networkInfo;
-
-    QnxCar::Hvac hvac;
-    QnxCar::SmartDevice smartdevice;
-    QnxCar::ThemeControl themecontrol;
-    QnxCar::SeatControl seatcontrol;
-    QnxCar::MusicControl musiccontrol;
-    QnxCar::CarDoorControl cardoorcontrol;
-    QnxCar::AppStatus appstatus;
-    QnxCar::CameraControl cameracontrol;
-    QnxCar::LampStatus lampstatus;
-    QnxCar::Geolocation geolocation;
-    QnxCar::Phone phone;
-    QnxCar::ProfileModel profileModel(QnxCar::DatabaseManager::database(QStringLiteral("personalization.db")));
-    QnxCar::ProfileManager profileManager(&profileModel);
-#ifdef DEBUG_TEST
-    current_time = QTime::currentTime();
-    hournow = current_time.hour();//当前的小时
-    minutenow = current_time.minute();//当前的分
-    secondnow = current_time.second();//当前的秒
-    //qDebug() << "309 font over" << hournow << ":"<<minutenow << ":"<<secondnow<< msecnow;
-    out << "391:" << hournow << ":"<<minutenow << ":"<<secondnow << msecnow << endl;
-#endif
-    QnxCar::Radio radio;
-    radio.setSimulationModeEnabled(false);
-#ifdef DEBUG_TEST
-    current_time = QTime::currentTime();
-    hournow = current_time.hour();//当前的小时
-    minutenow = current_time.minute();//当前的分
-    secondnow = current_time.second();//当前的秒
-    //qDebug() << "309 font over" << hournow << ":"<<minutenow << ":"<<secondnow<< msecnow;
-    out << "399:" << hournow << ":"<<minutenow << ":"<<secondnow << msecnow << endl;
-#endif
-    QnxCar::Sensors sensors;
-    QnxCar::Settings settings;
-    Status status;
-    QnxCar::Theme theme;
-    Util util;
-    QnxCarUi::ThemeManager themeManager(resolutionManager.resolution(), &theme);
+    QnxCarUi::ThemeManager themeManager(resolutionManager.resolution(), theme);
     themeManager.setAssetsDirectory(assetsPath);
+    themeManager.setCacheDirectory(QStandardPaths::writableLocation(QStandardPaths::CacheLocation));
     QnxCarUi::PaletteManager paletteManager(&themeManager);
-    QnxCar::User user;
-    QnxCar::VoiceControl voiceControl;
-    VoiceInput voiceInput;
-    QnxCar::HmiNotificationManager hmiNotificationManager;
-    SmartDeviceWorkflow smartDevices;
 
     ProfileSettingsManager profileSettingsManager;
-    profileSettingsManager.setHvac(&hvac);
-    profileSettingsManager.setAudioControl(&audioControl);
-    profileSettingsManager.setRadio(&radio);
-    profileManager.addSettingsListener(&profileSettingsManager);
-
-    screenManager.setCameraControl(&cameracontrol);
-#ifdef DEBUG_TEST
-    current_time = QTime::currentTime();
-    hournow = current_time.hour();//当前的小时
-    minutenow = current_time.minute();//当前的分
-    secondnow = current_time.second();//当前的秒
-    //qDebug() << "417wifi" << hournow << ":"<<minutenow << ":"<<secondnow<< msecnow;
-    out << "426:" << hournow << ":"<<minutenow << ":"<<secondnow << msecnow << endl;
-#endif
+    profileSettingsManager.setHvac(hvac);
+    profileSettingsManager.setAudioControl(audioControl);
+    profileSettingsManager.setRadio(radio);
+    profileManager->addSettingsListener(&profileSettingsManager);
+
+    screenManager.setCameraControl(cameracontrol);
+    screenManager.setWindowManager(&windowManager);
 #ifndef NO_APP_SETTINGS
+    QnxCar::Bluetooth *bluetooth = registry.service<QnxCar::Bluetooth>(QStringLiteral("bluetooth"));
+
     // create list of available pages
     QMap<int,bool> availPages;
 
-    availPages[BtWifi_SettingsWorkflow::BluetoothConnectivityPage] = bluetooth.active();
+    availPages[BtWifi_SettingsWorkflow::BluetoothConnectivityPage] = bluetooth->active();
     availPages[BtWifi_SettingsWorkflow::SoftwareUpdatesPage] = true; // alvays available
     availPages[BtWifi_SettingsWorkflow::WiredNetworkPage] = true; // alvays available
-    availPages[BtWifi_SettingsWorkflow::WifiClientPage] = wifi.isAvailable();
-    availPages[BtWifi_SettingsWorkflow::HotSpotPage] = hotspot.isAvailable();
-
-    BtWifi_SettingsModule bt_wifi_settingsModule(&bluetooth, availPages);
-#ifdef DEBUG_TEST
-    current_time = QTime::currentTime();
-    hournow = current_time.hour();//当前的小时
-    minutenow = current_time.minute();//当前的分
-    secondnow = current_time.second();//当前的秒
-    //qDebug() << "433wifiover" << hournow << ":"<<minutenow << ":"<<secondnow<< msecnow;
-    out << "414:" << hournow << ":"<<minutenow << ":"<<secondnow << msecnow << endl;
-#endif
+    availPages[BtWifi_SettingsWorkflow::WifiClientPage] = registry.service<QnxCar::Wifi>(QStringLiteral("wifi"))->isAvailable();
+    availPages[BtWifi_SettingsWorkflow::HotSpotPage] = registry.service<QnxCar::HotSpot>(QStringLiteral("hotspot"))->isAvailable();
+
+    BtWifi_SettingsModule bt_wifi_settingsModule(bluetooth, availPages);
 #endif
 
     QQuickView view;
     view.setColor(Qt::transparent);
     view.setResizeMode(QQuickView::SizeRootObjectToView);
 
-    //NetWorkInfo
-    //    NetWorkInfoInitThread networkInfoInitThread;
-    //    networkInfoInitThread.start();
-    //    networkInfoInitThread.wait();
-#ifdef DEBUG_TEST
-    current_time = QTime::currentTime();
-    hournow = current_time.hour();//当前的小时
-    minutenow = current_time.minute();//当前的分
-    secondnow = current_time.second();//当前的秒
-    //qDebug() << "458" << hournow << ":"<<minutenow << ":"<<secondnow<< msecnow;
-    out << "425:" << hournow << ":"<<minutenow << ":"<<secondnow << msecnow << endl;
-#endif
     ModuleManager moduleManager(&appLauncherServer, view.rootContext());
     QObject::connect(&appLauncherServer, &AppLauncherServer::selectScreen, &screenManager, &ScreenManager::setCurrentScreen);
     QObject::connect(&screenManager, &ScreenManager::screenSelected, &moduleManager, &ModuleManager::screenSelected);
@@ -536,66 +492,23 @@ int main(int argc, char **argv)
 
     //Restore tab selection state from PPS
     moduleManager.applyNavigatorCommandState();
-    cameracontrol.setCapture(QStringLiteral("stop"));
-
-#ifdef DEBUG_TEST
-    current_time = QTime::currentTime();
-    hournow = current_time.hour();//当前的小时
-    minutenow = current_time.minute();//当前的分
-    secondnow = current_time.second();//当前的秒
-    // qDebug() << "462" << hournow << ":"<<minutenow << ":"<<secondnow<< msecnow;
-    out << "439:" << hournow << ":"<<minutenow << ":"<<secondnow << msecnow << endl;
-#endif
+    cameracontrol->setCapture(QStringLiteral("stop"));
+
     // export business logic objects
+    registry.exportTo(view.rootContext());
     view.rootContext()->setContextProperty(QStringLiteral("_applicationManager"), &applicationManager);
-    view.rootContext()->setContextProperty(QStringLiteral("_audioControl"), &audioControl);
-    view.rootContext()->setContextProperty(QStringLiteral("_bluetooth"), &bluetooth);
-    view.rootContext()->setContextProperty(QStringLiteral("_wifi"), &wifi);
-    view.rootContext()->setContextProperty(QStringLiteral("_hotspot"), &hotspot);
-    view.rootContext()->setContextProperty(QStringLiteral("_hvac"), &hvac);
-    view.rootContext()->setContextProperty(QStringLiteral("_smartdevice"), &smartdevice);
-    view.rootContext()->setContextProperty(QStringLiteral("_themecontrol"), &themecontrol);
-    view.rootContext()->setContextProperty(QStringLiteral("_seatcontrol"), &seatcontrol);
-    view.rootContext()->setContextProperty(QStringLiteral("_musiccontrol"), &musiccontrol);
-    view.rootContext()->setContextProperty(QStringLiteral("_cardoorcontrol"), &cardoorcontrol);
-    view.rootContext()->setContextProperty(QStringLiteral("_appstatus"), &appstatus);
-    view.rootContext()->setContextProperty(QStringLiteral("_cameracontrol"), &cameracontrol);
-    view.rootContext()->setContextProperty(QStringLiteral("_lampStatus"), &lampstatus);
-    view.rootContext()->setContextProperty(QStringLiteral("_geolocation"), &geolocation);
     view.rootContext()->setContextProperty(QStringLiteral("_palette"), paletteManager.palette());
-    view.rootContext()->setContextProperty(QStringLiteral("_phone"), &phone);
-    view.rootContext()->setContextProperty(QStringLiteral("_profileManager"), &profileManager);
-    view.rootContext()->setContextProperty(QStringLiteral("_profileModel"), &profileModel);
-    view.rootContext()->setContextProperty(QStringLiteral("_radio"), &radio);
     view.rootContext()->setContextProperty(QStringLiteral("_screenManager"), &screenManager);
-    view.rootContext()->setContextProperty(QStringLiteral("_sensors"), &sensors);
-    view.rootContext()->setContextProperty(QStringLiteral("_settings"), &settings);
-    view.rootContext()->setContextProperty(QStringLiteral("_status"), &status);
-    view.rootContext()->setContextProperty(QStringLiteral("_theme"), &theme);
     view.rootContext()->setContextProperty(QStringLiteral("_themeManager"), &themeManager);
-    view.rootContext()->setContextProperty(QStringLiteral("_user"), &user);
-    view.rootContext()->setContextProperty(QStringLiteral("_util"), &util);
-    view.rootContext()->setContextProperty(QStringLiteral("_voiceInput"), &voiceInput);
-
-    view.rootContext()->setContextProperty(QStringLiteral("_hmiNotificationManager"), &hmiNotificationManager);
-    view.rootContext()->setContextProperty(QStringLiteral("_smartDevices"), &smartDevices);
 #ifndef NO_APP_SETTINGS
-    view.rootContext()->setContextProperty(QStringLiteral("_networkInfo"), &networkInfo);
-    view.rootContext()->setContextProperty(QStringLiteral("_systemInfo"), &systemInfo);
     view.rootContext()->setContextProperty(QStringLiteral("_bt_wifi_settingsModule"), &bt_wifi_settingsModule);
 #endif
     resolutionManager.setupQmlContext(view.rootContext());
 
+    start = registry.timestamp();
     view.setSource(QUrl::fromLocalFile(assetsPath + QStringLiteral("/qml/main.qml")));
+    registry.addSpan(QStringLiteral("Loading main.qml"), start);
 
-#ifdef DEBUG_TEST
-    current_time = QTime::currentTime();
-    hournow = current_time.hour();//当前的小时
-    minutenow = current_time.minute();//当前的分
-    secondnow = current_time.second();//当前的秒
-    // qDebug() << "517qml" << hournow << ":"<<minutenow << ":"<<secondnow<< msecnow;
-    out << "487:" << hournow << ":"<<minutenow << ":"<<secondnow << msecnow << endl;
-#endif
     MediaPlayerModule::ScreenManager = &screenManager;
     ApplicationManager::ScreenManager = &screenManager;
 
@@ -607,9 +520,12 @@ int main(int argc, char **argv)
     QObject::connect(&speechView, &QQuickView::frameSwapped, &quickViewStateHandler, &QuickViewStateHandler::frameSwapped);
     QObject::connect(&windowManager, &WindowManager::windowGroupPosted, &quickViewStateHandler, &QuickViewStateHandler::handleWindowGroupPosted);
 
-    speechView.rootContext()->setContextProperty(QStringLiteral("_util"), &util);
-    speechView.rootContext()->setContextProperty(QStringLiteral("_voiceInput"), &voiceInput);
-    speechView.rootContext()->setContextProperty(QStringLiteral("_theme"), &theme);
+    StartupHandler startupHandler(&view, &registry, startupTraceFile);
+    QObject::connect(&view, &QQuickView::frameSwapped, &startupHandler, &StartupHandler::frameSwapped);
+
+    speechView.rootContext()->setContextProperty(QStringLiteral("_util"), registry.service(QStringLiteral("util")));
+    speechView.rootContext()->setContextProperty(QStringLiteral("_voiceInput"), registry.service(QStringLiteral("voiceInput")));
+    speechView.rootContext()->setContextProperty(QStringLiteral("_theme"), theme);
     speechView.rootContext()->setContextProperty(QStringLiteral("_themeManager"), &themeManager);
     speechView.rootContext()->setContextProperty(QStringLiteral("_palette"), paletteManager.palette());
     resolutionManager.setupQmlContext(speechView.rootContext());
@@ -620,15 +536,7 @@ int main(int argc, char **argv)
     view.show();
     // Create this late in case input methods are initialized late at startup
     QnxCarUi::KeyboardAutoCloser keyboardAutoCloser;
-#ifdef DEBUG_TEST
-    current_time = QTime::currentTime();
-    hournow = current_time.hour();//当前的小时
-    minutenow = current_time.minute();//当前的分
-    secondnow = current_time.second();//当前的秒
-    out.flush();
-    file.close();
-    qDebug() << "551" << hournow << ":"<<minutenow << ":"<<secondnow<< msecnow;
-#endif
+
     const int returnCode = app.exec();
 
     windowManager.requestQuit();
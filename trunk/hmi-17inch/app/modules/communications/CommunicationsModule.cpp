@@ -61,14 +61,13 @@ CommunicationsModule::CommunicationsModule(QObject *parent)
     QSqlDatabase addressDb = DatabaseManager::database(QStringLiteral("phonebook.db"));
 
     m_addressbookModel = new AddressbookModel(this);
+    m_addressbookModel->setSortRole(QnxCar::AddressbookModel::DisplayName);
+    m_addressbookModel->sort(0);
     m_addressbookModel->setDatabase(addressDb);
 
+    // sorted by the model in the database, sorting in the proxy would read every contact
     m_sortedAddressbookModel = new QSortFilterProxyModel(this);
-    m_sortedAddressbookModel->setDynamicSortFilter(true);
     m_sortedAddressbookModel->setSourceModel(m_addressbookModel);
-    m_sortedAddressbookModel->setSortRole(QnxCar::AddressbookModel::DisplayName);
-    m_sortedAddressbookModel->setSortCaseSensitivity(Qt::CaseInsensitive);
-    m_sortedAddressbookModel->sort(0);
 
     m_addressbookSearchModel = new AddressbookSearchModel(this);
     m_addressbookSearchModel->setDatabase(addressDb);
@@ -39,17 +39,28 @@
 
 #ifdef PICTUREFLOW_QT4
 #include <QGuiApplication>
-#include <QCache>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
 #include <QHash>
 #include <QImage>
 #include <QKeyEvent>
+#include <QMap>
+#include <QMutex>
 #include <QPainter>
 #include <QPixmap>
+#include <QRunnable>
+#include <QSaveFile>
+#include <QSet>
+#include <QThread>
+#include <QThreadPool>
 #include <QTimer>
 #include <QVector>
 #include <QtWidgets/qwidget.h>
 #endif
 
+#include <string.h>
+
 // for fixed-point arithmetic, we need minimum 32-bit long
 // long long (64-bit) might be useful for multiplication and division
 typedef long PFreal;
@@ -59,6 +70,13 @@ typedef long PFreal;
 #define IANGLE_MAX 1024
 #define IANGLE_MASK 1023
 
+// how many slides beyond the visible ones are prepared ahead of the animation, on each side
+#define PREFETCH_SLIDES 4
+
+// memory for prepared surfaces, and disk space for those kept across restarts
+#define SURFACE_CACHE_BYTES (64*1024*1024)
+#define SURFACE_DISK_CACHE_BYTES (256*1024*1024)
+
 inline PFreal fmul(PFreal a, PFreal b)
 {
   return ((long long)(a))*((long long)(b)) >> PFREAL_SHIFT;
@@ -144,7 +162,12 @@ public:
   int slideWidth;
   int slideHeight;
   PictureFlow::ReflectionEffect reflectionEffect;
+  int renderThreads;
   QVector<QImage*> slideImages;
+  QVector<quint64> slideHashes; // of the slide images, 0 until needed
+  qint64 cacheBytes;
+  QString cacheDirectory;
+  qint64 cacheDirectoryBytes;
 
   int angle;
   int spacing;
@@ -185,6 +208,120 @@ public:
 
   virtual void init() = 0;
   virtual void paint() = 0;
+  virtual bool isPreparing() const { return false; }
+  virtual qint64 cachedBytes() const { return 0; }
+};
+
+// a screen column crossing a slide
+struct ColumnHit
+{
+  const QRgb* texels; // the surface scanline holding the slide column, 0 if missed
+  PFreal dist;
+};
+
+// the screen columns a slide is drawn to, see PictureFlowSoftwareRenderer::traceSlide()
+struct SlideColumns
+{
+  int blend;
+  int surfaceWidth;
+  int left;
+  int right;
+  QVector<ColumnHit> hits; // one per column from left to right
+};
+
+// Identifies a surface by everything prepareSurface() makes it from. The
+// slide image counts by its content, not by its index: surfaces survive
+// reordering, are shared by slides with the same artwork and are found
+// again in the disk cache after a restart.
+struct SurfaceKey
+{
+  quint64 imageHash;
+  int width;
+  int height;
+  int effect;
+  QRgb bgcolor;
+};
+
+inline bool operator==(const SurfaceKey& a, const SurfaceKey& b)
+{
+  return a.imageHash == b.imageHash && a.width == b.width && a.height == b.height
+    && a.effect == b.effect && a.bgcolor == b.bgcolor;
+}
+
+inline uint qHash(const SurfaceKey& key)
+{
+  return qHash(key.imageHash) ^ qHash((key.width << 16) ^ key.height) ^ qHash(key.bgcolor) ^ key.effect;
+}
+
+// Prepared surfaces by content, within a budget of bytes. The least
+// recently used ones are evicted by trim(), which the renderer calls once a
+// frame is done: the surfaces traced for a frame stay valid until then.
+// With a directory set, surfaces are kept on disk as well, and memory-mapped
+// when looked up, so only the pages drawn are ever read. The least recently
+// stored or loaded files are removed beyond a budget of their own.
+class PictureFlowSurfaceCache
+{
+public:
+  PictureFlowSurfaceCache();
+  ~PictureFlowSurfaceCache();
+
+  QImage* find(const SurfaceKey& key);
+  bool contains(const SurfaceKey& key) const;
+  void insert(const SurfaceKey& key, QImage* surface, bool stored);
+  void trim();
+  void clear();
+
+  qint64 bytes() const { return totalBytes; }
+  qint64 maximumBytes() const { return maxBytes; }
+  void setMaximumBytes(qint64 bytes) { maxBytes = bytes; }
+
+  QString directory() const { return dir; }
+  void setDirectory(const QString& path, qint64 maximumDiskBytes);
+
+  qint64 diskBytes() const { return totalDiskBytes; }
+  qint64 maximumDiskBytes() const { return maxDiskBytes; }
+  void setMaximumDiskBytes(qint64 bytes);
+
+  static bool store(const QString& directory, const SurfaceKey& key, const QImage& surface);
+
+private:
+  struct Entry
+  {
+    QImage* surface;
+    quint64 lastUse;
+  };
+
+  struct StoredFile
+  {
+    qint64 bytes;
+    quint64 lastUse;
+  };
+
+  QImage* load(const SurfaceKey& key);
+  void addStoredFile(const QString& name, qint64 bytes);
+  void removeStoredFile(const QString& name);
+  void trimStoredFiles(const QString& keep);
+
+  QHash<SurfaceKey,Entry> entries;
+  QMap<quint64,SurfaceKey> recent; // by last use, least recent first
+  quint64 useCount;
+  quint64 frameStart; // useCount at the last trim()
+  qint64 totalBytes;
+  qint64 maxBytes;
+  QString dir;
+  QHash<QString,StoredFile> storedFiles;
+  QMap<quint64,QString> recentFiles; // by last use, least recent first
+  quint64 fileUseCount;
+  qint64 totalDiskBytes;
+  qint64 maxDiskBytes;
+};
+
+// a surface prepared on a thread of the surface pool, until the GUI thread takes it
+struct PreparedSurface
+{
+  SurfaceKey key;
+  QImage* surface;
+  bool stored; // written to the disk cache
 };
 
 class PictureFlowSoftwareRenderer: public PictureFlowAbstractRenderer
@@ -195,38 +332,109 @@ public:
 
   virtual void init();
   virtual void paint();
+  virtual bool isPreparing() const;
+  virtual qint64 cachedBytes() const;
+
+  void renderColumns(int col1, int col2);
+#ifdef PICTUREFLOW_QT4
+  void surfacePrepared(const PreparedSurface& prepared);
+#endif
 
 private:
   QSize size;
   QRgb bgcolor;
   int effect;
+  QString cacheDirectory;
   QImage buffer;
+  // the frame transposed, one scanline per screen column, so that columns are rendered
+  // into contiguous memory
+  QImage columnBuffer;
   QVector<PFreal> rays;
+
+  // the slides to draw, in drawing order, valid for the frame being rendered
+  QVector<SlideColumns> traced;
+  int tracedCount;
+
+  // where the render threads write to, taken on the GUI thread
+  QRgb fillColor;
+  uchar* bufferBits;
+  int bufferStride;
+  uchar* columnBits;
+  int columnStride;
   QImage* blankSurface;
+  PictureFlowSurfaceCache surfaceCache;
 #ifdef PICTUREFLOW_QT4
-  QCache<int,QImage> surfaceCache;
-  QHash<int,QImage*> imageHash;
-#endif
-#ifdef PICTUREFLOW_QT3
-  QCache<QImage> surfaceCache;
-  QMap<int,QImage*> imageHash;
-#endif
-#ifdef PICTUREFLOW_QT2
-  QCache<QImage> surfaceCache;
-  QIntDict<QImage> imageHash;
+  QThreadPool renderPool;
+
+  // surfaces are prepared in the background, a placeholder is shown meanwhile
+  QThreadPool surfacePool;
+  QSet<SurfaceKey> preparing;
+  mutable QMutex preparedMutex;
+  QList<PreparedSurface> prepared;
+  int outstanding; // requested surfaces not in prepared yet
 #endif
 
   void render();
-  void renderSlides();
-  QRect renderSlide(const SlideInfo &slide, int col1 = -1, int col2 = -1);
+  QImage* placeholder();
+#ifdef PICTUREFLOW_QT4
+  void takePreparedSurfaces();
+  void prefetchSurfaces();
+  void requestSurface(int slideIndex, int priority);
+#endif
+  void traceSlides();
+  QRect traceSlide(const SlideInfo &slide, int col1 = -1, int col2 = -1);
+  void renderColumn(const SlideColumns& slide, const ColumnHit& hit, int x);
+  SurfaceKey surfaceKey(int slideIndex);
+  void releaseSlideImage(int slideIndex, const QImage& surface);
   QImage* surface(int slideIndex);
 };
 
+#ifdef PICTUREFLOW_QT4
+// renders a band of screen columns on a thread of the render pool
+class PictureFlowRenderTask: public QRunnable
+{
+public:
+  PictureFlowRenderTask(PictureFlowSoftwareRenderer* renderer, int col1, int col2):
+  renderer(renderer), col1(col1), col2(col2) {}
+
+  virtual void run() { renderer->renderColumns(col1, col2); }
+
+private:
+  PictureFlowSoftwareRenderer* renderer;
+  int col1;
+  int col2;
+};
+
+// prepares the surface of a slide on a thread of the surface pool
+class PictureFlowSurfaceTask: public QRunnable
+{
+public:
+  PictureFlowSurfaceTask(PictureFlowSoftwareRenderer* renderer, const PreparedSurface& request,
+    const QImage& image, int width, int height, QRgb bgcolor, PictureFlow::ReflectionEffect effect,
+    const QString& directory):
+  renderer(renderer), request(request), image(image), width(width), height(height),
+  bgcolor(bgcolor), effect(effect), directory(directory) {}
+
+  virtual void run();
+
+private:
+  PictureFlowSoftwareRenderer* renderer;
+  PreparedSurface request;
+  QImage image;
+  int width;
+  int height;
+  QRgb bgcolor;
+  PictureFlow::ReflectionEffect effect;
+  QString directory; // of the disk cache, empty if none
+};
+#endif
+
 // ------------- PictureFlowState ---------------------------------------
 
 PictureFlowState::PictureFlowState():
 backgroundColor(0), slideWidth(150), slideHeight(200),
-reflectionEffect(PictureFlow::BlurredReflection), centerIndex(0)
+reflectionEffect(PictureFlow::BlurredReflection), renderThreads(0),
+cacheBytes(SURFACE_CACHE_BYTES), cacheDirectoryBytes(SURFACE_DISK_CACHE_BYTES), centerIndex(0)
 {
 }
 
@@ -248,6 +456,264 @@ void PictureFlowState::reposition()
   spacing = 40;
 }
 
+// ------------- PictureFlowSurfaceCache ---------------------------------------
+
+// the header of a surface file, followed by the pixels; the files are local
+// to the device, so it is in native byte order
+struct SurfaceFileHeader
+{
+  quint32 magic;
+  qint32 width;
+  qint32 height;
+  qint32 bytesPerLine;
+};
+
+#define SURFACE_FILE_MAGIC 0x50465331 // "PFS1"
+
+static QString surfaceFileName(const SurfaceKey& key)
+{
+  return QString::fromLatin1("%1-%2x%3-%4-%5.surface")
+    .arg(key.imageHash, 16, 16, QLatin1Char('0'))
+    .arg(key.width).arg(key.height).arg(key.effect)
+    .arg(key.bgcolor, 8, 16, QLatin1Char('0'));
+}
+
+// a surface file mapped into memory, for as long as its image exists
+struct MappedSurface
+{
+  QFile file;
+  uchar* data;
+};
+
+static void unmapSurface(void* info)
+{
+  MappedSurface* mapped = static_cast<MappedSurface*>(info);
+  mapped->file.unmap(mapped->data);
+  delete mapped;
+}
+
+PictureFlowSurfaceCache::PictureFlowSurfaceCache():
+useCount(0), frameStart(0), totalBytes(0), maxBytes(SURFACE_CACHE_BYTES),
+fileUseCount(0), totalDiskBytes(0), maxDiskBytes(SURFACE_DISK_CACHE_BYTES)
+{
+}
+
+PictureFlowSurfaceCache::~PictureFlowSurfaceCache()
+{
+  clear();
+}
+
+QImage* PictureFlowSurfaceCache::find(const SurfaceKey& key)
+{
+  QHash<SurfaceKey,Entry>::iterator it = entries.find(key);
+  if(it == entries.end())
+  {
+    QImage* surface = load(key);
+    if(surface)
+      insert(key, surface, true);
+    return surface;
+  }
+
+  recent.remove(it.value().lastUse);
+  it.value().lastUse = ++useCount;
+  recent.insert(useCount, key);
+  return it.value().surface;
+}
+
+// in memory or on disk
+bool PictureFlowSurfaceCache::contains(const SurfaceKey& key) const
+{
+  return entries.contains(key) || storedFiles.contains(surfaceFileName(key));
+}
+
+// takes ownership of surface
+void PictureFlowSurfaceCache::insert(const SurfaceKey& key, QImage* surface, bool stored)
+{
+  QHash<SurfaceKey,Entry>::iterator it = entries.find(key);
+  if(it != entries.end())
+  {
+    totalBytes -= it.value().surface->byteCount();
+    recent.remove(it.value().lastUse);
+    delete it.value().surface;
+  }
+
+  Entry entry;
+  entry.surface = surface;
+  entry.lastUse = ++useCount;
+  entries.insert(key, entry);
+  recent.insert(entry.lastUse, key);
+  totalBytes += surface->byteCount();
+
+  // the file written by store(), or mapped by load()
+  if(stored && !dir.isEmpty())
+  {
+    const QString name = surfaceFileName(key);
+    addStoredFile(name, (qint64)sizeof(SurfaceFileHeader) + surface->byteCount());
+    trimStoredFiles(name);
+  }
+}
+
+// Evicts the least recently used surfaces beyond the budget, except those
+// used since the last call.
+void PictureFlowSurfaceCache::trim()
+{
+  while(totalBytes > maxBytes && !recent.isEmpty() && recent.begin().key() <= frameStart)
+  {
+    QMap<quint64,SurfaceKey>::iterator oldest = recent.begin();
+    QHash<SurfaceKey,Entry>::iterator it = entries.find(oldest.value());
+    totalBytes -= it.value().surface->byteCount();
+    delete it.value().surface;
+    entries.erase(it);
+    recent.erase(oldest);
+  }
+
+  frameStart = useCount;
+}
+
+void PictureFlowSurfaceCache::clear()
+{
+  QHash<SurfaceKey,Entry>::iterator it;
+  for(it = entries.begin(); it != entries.end(); ++it)
+    delete it.value().surface;
+  entries.clear();
+  recent.clear();
+  totalBytes = 0;
+}
+
+// Indexes the surface files in path, and removes the oldest ones beyond
+// maximumDiskBytes. An empty path disables the disk cache.
+void PictureFlowSurfaceCache::setDirectory(const QString& path, qint64 maximumDiskBytes)
+{
+  dir = path;
+  maxDiskBytes = maximumDiskBytes;
+  storedFiles.clear();
+  recentFiles.clear();
+  totalDiskBytes = 0;
+  if(dir.isEmpty())
+    return;
+
+  QDir directory(dir);
+  if(!directory.mkpath(QLatin1String(".")))
+  {
+    qWarning("PictureFlow: could not create the surface cache %s", qPrintable(dir));
+    dir.clear();
+    return;
+  }
+
+  // oldest first
+  QFileInfoList files = directory.entryInfoList(QStringList(QLatin1String("*.surface")),
+    QDir::Files, QDir::Time | QDir::Reversed);
+  for(int i = 0; i < files.count(); i++)
+    addStoredFile(files.at(i).fileName(), files.at(i).size());
+  trimStoredFiles(QString());
+}
+
+void PictureFlowSurfaceCache::setMaximumDiskBytes(qint64 bytes)
+{
+  maxDiskBytes = bytes;
+  trimStoredFiles(QString());
+}
+
+// Records a file in the directory as used last.
+void PictureFlowSurfaceCache::addStoredFile(const QString& name, qint64 bytes)
+{
+  QHash<QString,StoredFile>::iterator it = storedFiles.find(name);
+  if(it != storedFiles.end())
+  {
+    recentFiles.remove(it.value().lastUse);
+    totalDiskBytes -= it.value().bytes;
+  }
+  else
+    it = storedFiles.insert(name, StoredFile());
+
+  it.value().bytes = bytes;
+  it.value().lastUse = ++fileUseCount;
+  recentFiles.insert(fileUseCount, name);
+  totalDiskBytes += bytes;
+}
+
+void PictureFlowSurfaceCache::removeStoredFile(const QString& name)
+{
+  QHash<QString,StoredFile>::iterator it = storedFiles.find(name);
+  if(it == storedFiles.end())
+    return;
+
+  recentFiles.remove(it.value().lastUse);
+  totalDiskBytes -= it.value().bytes;
+  storedFiles.erase(it);
+}
+
+// Removes the least recently used files beyond the budget, except keep. Files
+// mapped by surfaces in memory stay readable until they are unmapped.
+void PictureFlowSurfaceCache::trimStoredFiles(const QString& keep)
+{
+  while(totalDiskBytes > maxDiskBytes && !recentFiles.isEmpty())
+  {
+    const QString name = recentFiles.begin().value();
+    if(name == keep)
+      break;
+
+    QFile::remove(dir + QLatin1Char('/') + name);
+    removeStoredFile(name);
+  }
+}
+
+// maps the surface file for key, if there is a valid one
+QImage* PictureFlowSurfaceCache::load(const SurfaceKey& key)
+{
+  QString name = surfaceFileName(key);
+  if(!storedFiles.contains(name))
+    return 0;
+
+  MappedSurface* mapped = new MappedSurface;
+  mapped->file.setFileName(dir + QLatin1Char('/') + name);
+  mapped->data = 0;
+  if(mapped->file.open(QIODevice::ReadOnly))
+    mapped->data = mapped->file.map(0, mapped->file.size());
+
+  const qint64 size = mapped->file.size();
+  const SurfaceFileHeader* header = (const SurfaceFileHeader*)(mapped->data);
+  bool valid = header && size >= (qint64)sizeof(SurfaceFileHeader)
+    && header->magic == SURFACE_FILE_MAGIC
+    && header->width == key.height * 2 && header->height == key.width
+    && header->bytesPerLine >= header->width * 4
+    && size == (qint64)sizeof(SurfaceFileHeader) + (qint64)header->bytesPerLine * header->height;
+
+  if(!valid)
+  {
+    // truncated or from another version, the surface is prepared again
+    if(mapped->data)
+      mapped->file.unmap(mapped->data);
+    mapped->file.close();
+    mapped->file.remove();
+    delete mapped;
+    removeStoredFile(name);
+    return 0;
+  }
+
+  // read-only: the renderer never writes to surfaces
+  return new QImage((const uchar*)(mapped->data + sizeof(SurfaceFileHeader)), header->width,
+    header->height, header->bytesPerLine, QImage::Format_RGB32, unmapSurface, mapped);
+}
+
+// Writes a surface to the disk cache. Safe to call from any thread.
+bool PictureFlowSurfaceCache::store(const QString& directory, const SurfaceKey& key, const QImage& surface)
+{
+  SurfaceFileHeader header;
+  header.magic = SURFACE_FILE_MAGIC;
+  header.width = surface.width();
+  header.height = surface.height();
+  header.bytesPerLine = surface.bytesPerLine();
+
+  // written aside and renamed, so that a crash leaves no partial file behind
+  QSaveFile file(directory + QLatin1Char('/') + surfaceFileName(key));
+  if(!file.open(QIODevice::WriteOnly))
+    return false;
+  file.write((const char*)(&header), sizeof(header));
+  file.write((const char*)(surface.constBits()), surface.byteCount());
+  return file.commit();
+}
+
 // adjust slides so that they are in "steady state" position
 void PictureFlowState::reset()
 {
@@ -441,15 +907,24 @@ void PictureFlowAnimator::update()
 // ------------- PictureFlowSoftwareRenderer ---------------------------------------
 
 PictureFlowSoftwareRenderer::PictureFlowSoftwareRenderer():
-PictureFlowAbstractRenderer(), size(0,0), bgcolor(0), effect(-1), blankSurface(0)
+PictureFlowAbstractRenderer(), size(0,0), bgcolor(0), effect(-1), tracedCount(0),
+fillColor(0), bufferBits(0), bufferStride(0), columnBits(0), columnStride(0), blankSurface(0)
 {
-#ifdef PICTUREFLOW_QT3
-  surfaceCache.setAutoDelete(true);
+#ifdef PICTUREFLOW_QT4
+  outstanding = 0;
+  // leave a core to the GUI thread
+  surfacePool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() - 1));
 #endif
 }
 
 PictureFlowSoftwareRenderer::~PictureFlowSoftwareRenderer()
 {
+#ifdef PICTUREFLOW_QT4
+  renderPool.waitForDone();
+  surfacePool.waitForDone();
+  for(int i = 0; i < prepared.count(); i++)
+    delete prepared.at(i).surface;
+#endif
   surfaceCache.clear();
   buffer = QImage();
   delete blankSurface;
@@ -463,18 +938,30 @@ void PictureFlowSoftwareRenderer::paint()
   if(widget->size() != size)
     init();
 
+  // the cached surfaces are kept, they are looked up by all of these
   if(state->backgroundColor != bgcolor)
   {
     bgcolor = state->backgroundColor;
-    surfaceCache.clear();
+    delete blankSurface;
+    blankSurface = 0;
   }
 
   if((int)(state->reflectionEffect) != effect)
   {
     effect = (int)state->reflectionEffect;
-    surfaceCache.clear();
+    delete blankSurface;
+    blankSurface = 0;
   }
 
+  surfaceCache.setMaximumBytes(state->cacheBytes);
+  if(state->cacheDirectory != cacheDirectory)
+  {
+    cacheDirectory = state->cacheDirectory;
+    surfaceCache.setDirectory(cacheDirectory, state->cacheDirectoryBytes);
+  }
+  else if(state->cacheDirectoryBytes != surfaceCache.maximumDiskBytes())
+    surfaceCache.setMaximumDiskBytes(state->cacheDirectoryBytes);
+
   if(dirty)
     render();
 
@@ -487,9 +974,6 @@ void PictureFlowSoftwareRenderer::init()
   if(!widget)
     return;
 
-  surfaceCache.clear();
-  blankSurface = 0;
-
   size = widget->size();
   int ww = size.width();
   int wh = size.height();
@@ -498,9 +982,11 @@ void PictureFlowSoftwareRenderer::init()
 
 #ifdef PICTUREFLOW_QT4
   buffer = QImage(ww, wh, QImage::Format_RGB32);
+  columnBuffer = QImage(wh, ww, QImage::Format_RGB32);
 #endif
 #if defined(PICTUREFLOW_QT3) || defined(PICTUREFLOW_QT2)
   buffer.create(ww, wh, 32);
+  columnBuffer.create(wh, ww, 32);
 #endif
   buffer.fill(bgcolor);
 
@@ -515,22 +1001,230 @@ void PictureFlowSoftwareRenderer::init()
   dirty = true;
 }
 
-// TODO: optimize this with lookup tables
-static QRgb blendColor(QRgb c1, QRgb c2, int blend)
+// ------------- pixel operations ---------------------------------------
+//
+// The inner loops of the renderer. Each has an SSE2 and a NEON version
+// next to the plain one, which handles the remainder and every other CPU.
+// All of them produce the same pixels. Define PICTUREFLOW_NO_SIMD to use
+// the plain versions only.
+
+#if !defined(PICTUREFLOW_NO_SIMD) && defined(__SSE2__)
+#define PICTUREFLOW_SSE2
+#include <emmintrin.h>
+#elif !defined(PICTUREFLOW_NO_SIMD) && (defined(__ARM_NEON__) || defined(__ARM_NEON))
+#define PICTUREFLOW_NEON
+#include <arm_neon.h>
+#endif
+
+// blend is 0 (only c2) to 256 (only c1)
+static inline QRgb blendColor(QRgb c1, QRgb c2, int blend)
 {
-  int r = qRed(c1) * blend/256 + qRed(c2)*(256-blend)/256;
-  int g = qGreen(c1) * blend/256 + qGreen(c2)*(256-blend)/256;
-  int b = qBlue(c1) * blend/256 + qBlue(c2)*(256-blend)/256;
+  int r = (qRed(c1) * blend + qRed(c2) * (256-blend)) >> 8;
+  int g = (qGreen(c1) * blend + qGreen(c2) * (256-blend)) >> 8;
+  int b = (qBlue(c1) * blend + qBlue(c2) * (256-blend)) >> 8;
   return qRgb(r, g, b);
 }
 
+// blendColor() for a run of pixels, in place
+static void blendPixels(QRgb* pixels, int count, QRgb bgcolor, int blend)
+{
+  int i = 0;
+
+#if defined(PICTUREFLOW_SSE2)
+  // four pixels at a time, with the channels widened to 16 bits:
+  // c * blend + bg * (256-blend) is at most 255 * 256 and does not overflow
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i factor = _mm_set1_epi16((short)blend);
+  const __m128i bgterm = _mm_mullo_epi16(_mm_unpacklo_epi8(_mm_set1_epi32((int)bgcolor), zero),
+                                         _mm_set1_epi16((short)(256-blend)));
+  const __m128i alpha = _mm_set1_epi32((int)0xff000000);
+  for(; i + 4 <= count; i += 4)
+  {
+    __m128i px = _mm_loadu_si128((const __m128i*)(pixels + i));
+    __m128i lo = _mm_unpacklo_epi8(px, zero);
+    __m128i hi = _mm_unpackhi_epi8(px, zero);
+    lo = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(lo, factor), bgterm), 8);
+    hi = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(hi, factor), bgterm), 8);
+    _mm_storeu_si128((__m128i*)(pixels + i), _mm_or_si128(_mm_packus_epi16(lo, hi), alpha));
+  }
+#elif defined(PICTUREFLOW_NEON)
+  const uint16x8_t factor = vdupq_n_u16((uint16_t)blend);
+  const uint16x8_t bgterm = vmulq_n_u16(vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(bgcolor))),
+                                        (uint16_t)(256-blend));
+  const uint32x4_t alpha = vdupq_n_u32(0xff000000);
+  for(; i + 4 <= count; i += 4)
+  {
+    uint8x16_t px = vreinterpretq_u8_u32(vld1q_u32((const uint32_t*)(pixels + i)));
+    uint16x8_t lo = vmlaq_u16(bgterm, vmovl_u8(vget_low_u8(px)), factor);
+    uint16x8_t hi = vmlaq_u16(bgterm, vmovl_u8(vget_high_u8(px)), factor);
+    uint8x16_t result = vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8));
+    vst1q_u32((uint32_t*)(pixels + i), vorrq_u32(vreinterpretq_u32_u8(result), alpha));
+  }
+#endif
+
+  for(; i < count; i++)
+    pixels[i] = blendColor(pixels[i], bgcolor, blend);
+}
+
+// dst[c][r] = src[r][c] for a block of rows x cols pixels, strides are in pixels
+static void transposePixels(const QRgb* src, int srcStride, QRgb* dst, int dstStride, int rows, int cols)
+{
+  // in tiles of 32x32 pixels, so that both sides of a tile stay in the L1 cache
+  for(int r0 = 0; r0 < rows; r0 += 32)
+    for(int c0 = 0; c0 < cols; c0 += 32)
+    {
+      int r1 = qMin(r0 + 32, rows);
+      int c1 = qMin(c0 + 32, cols);
+      int r = r0;
+
+#if defined(PICTUREFLOW_SSE2) || defined(PICTUREFLOW_NEON)
+      for(; r + 4 <= r1; r += 4)
+      {
+        int c = c0;
+        for(; c + 4 <= c1; c += 4)
+        {
+          const QRgb* s = src + r*srcStride + c;
+          QRgb* d = dst + c*dstStride + r;
+#if defined(PICTUREFLOW_SSE2)
+          __m128i a = _mm_loadu_si128((const __m128i*)(s));
+          __m128i b = _mm_loadu_si128((const __m128i*)(s + srcStride));
+          __m128i e = _mm_loadu_si128((const __m128i*)(s + 2*srcStride));
+          __m128i f = _mm_loadu_si128((const __m128i*)(s + 3*srcStride));
+          __m128i ab01 = _mm_unpacklo_epi32(a, b);
+          __m128i ab23 = _mm_unpackhi_epi32(a, b);
+          __m128i ef01 = _mm_unpacklo_epi32(e, f);
+          __m128i ef23 = _mm_unpackhi_epi32(e, f);
+          _mm_storeu_si128((__m128i*)(d), _mm_unpacklo_epi64(ab01, ef01));
+          _mm_storeu_si128((__m128i*)(d + dstStride), _mm_unpackhi_epi64(ab01, ef01));
+          _mm_storeu_si128((__m128i*)(d + 2*dstStride), _mm_unpacklo_epi64(ab23, ef23));
+          _mm_storeu_si128((__m128i*)(d + 3*dstStride), _mm_unpackhi_epi64(ab23, ef23));
+#else
+          uint32x4x2_t ab = vtrnq_u32(vld1q_u32((const uint32_t*)(s)),
+                                      vld1q_u32((const uint32_t*)(s + srcStride)));
+          uint32x4x2_t ef = vtrnq_u32(vld1q_u32((const uint32_t*)(s + 2*srcStride)),
+                                      vld1q_u32((const uint32_t*)(s + 3*srcStride)));
+          vst1q_u32((uint32_t*)(d), vcombine_u32(vget_low_u32(ab.val[0]), vget_low_u32(ef.val[0])));
+          vst1q_u32((uint32_t*)(d + dstStride), vcombine_u32(vget_low_u32(ab.val[1]), vget_low_u32(ef.val[1])));
+          vst1q_u32((uint32_t*)(d + 2*dstStride), vcombine_u32(vget_high_u32(ab.val[0]), vget_high_u32(ef.val[0])));
+          vst1q_u32((uint32_t*)(d + 3*dstStride), vcombine_u32(vget_high_u32(ab.val[1]), vget_high_u32(ef.val[1])));
+#endif
+        }
+        for(; c < c1; c++)
+          for(int i = 0; i < 4; i++)
+            dst[c*dstStride + r + i] = src[(r+i)*srcStride + c];
+      }
+#endif
+
+      for(; r < r1; r++)
+        for(int c = c0; c < c1; c++)
+          dst[c*dstStride + r] = src[r*srcStride + c];
+    }
+}
+
+
+// One step of the exponential blur, for a scanline at a time: acc holds
+// the blurred value of every byte of the previous scanline times 16.
+static void blurScanline(uchar* pixels, short* acc, int count)
+{
+  int i = 0;
+
+#if defined(PICTUREFLOW_SSE2)
+  const __m128i zero = _mm_setzero_si128();
+  for(; i + 16 <= count; i += 16)
+  {
+    __m128i px = _mm_loadu_si128((const __m128i*)(pixels + i));
+    __m128i lo = _mm_loadu_si128((const __m128i*)(acc + i));
+    __m128i hi = _mm_loadu_si128((const __m128i*)(acc + i + 8));
+    lo = _mm_add_epi16(lo, _mm_srai_epi16(_mm_sub_epi16(_mm_slli_epi16(_mm_unpacklo_epi8(px, zero), 4), lo), 1));
+    hi = _mm_add_epi16(hi, _mm_srai_epi16(_mm_sub_epi16(_mm_slli_epi16(_mm_unpackhi_epi8(px, zero), 4), hi), 1));
+    _mm_storeu_si128((__m128i*)(acc + i), lo);
+    _mm_storeu_si128((__m128i*)(acc + i + 8), hi);
+    _mm_storeu_si128((__m128i*)(pixels + i), _mm_packus_epi16(_mm_srai_epi16(lo, 4), _mm_srai_epi16(hi, 4)));
+  }
+#elif defined(PICTUREFLOW_NEON)
+  for(; i + 8 <= count; i += 8)
+  {
+    int16x8_t px = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(pixels + i)));
+    int16x8_t sum = vld1q_s16(acc + i);
+    sum = vaddq_s16(sum, vshrq_n_s16(vsubq_s16(vshlq_n_s16(px, 4), sum), 1));
+    vst1q_s16(acc + i, sum);
+    vst1_u8(pixels + i, vqmovun_s16(vshrq_n_s16(sum, 4)));
+  }
+#endif
+
+  for(; i < count; i++)
+    pixels[i] = (acc[i] += (((pixels[i]<<4)-acc[i])) >> 1) >> 4;
+}
+
+// Exponential blur, based on the algorithm by Jani Huhtanen. The passes
+// down and up a column run along whole scanlines, those along a row are
+// sequential by nature.
+static void blurPixels(QImage* image, const QRect& rect)
+{
+  int r1 = rect.top();
+  int r2 = rect.bottom();
+  int c1 = rect.left();
+  int c2 = rect.right();
+
+  int bpl = image->bytesPerLine();
+  int count = (c2 - c1 + 1) * 4;
+  QVector<short> acc(count);
+  int rgba[4];
+  unsigned char* p;
+
+  // how many times blur is applied?
+  // for low-end system, limit this to only 1 loop
+  for(int loop = 0; loop < 2; loop++)
+  {
+    p = image->scanLine(r1) + c1*4;
+    for(int i = 0; i < count; i++)
+      acc[i] = p[i] << 4;
+    for(int row = r1 + 1; row <= r2; row++)
+      blurScanline(image->scanLine(row) + c1*4, acc.data(), count);
+
+    for(int row = r1; row <= r2; row++)
+    {
+      p = image->scanLine(row) + c1*4;
+      for(int i = 0; i < 3; i++)
+        rgba[i] = p[i] << 4;
+
+      p += 4;
+      for(int j = c1; j < c2; j++, p+=4)
+        for(int i = 0; i < 3; i++)
+          p[i] = (rgba[i] += (((p[i]<<4)-rgba[i])) >> 1) >> 4;
+    }
 
+    p = image->scanLine(r2) + c1*4;
+    for(int i = 0; i < count; i++)
+      acc[i] = p[i] << 4;
+    for(int row = r2 - 1; row >= r1; row--)
+      blurScanline(image->scanLine(row) + c1*4, acc.data(), count);
+
+    for(int row = r1; row <= r2; row++)
+    {
+      p = image->scanLine(row) + c2*4;
+      for(int i = 0; i < 3; i++)
+        rgba[i] = p[i] << 4;
+
+      p -= 4;
+      for(int j = c1; j < c2; j++, p-=4)
+        for(int i = 0; i < 3; i++)
+          p[i] = (rgba[i] += (((p[i]<<4)-rgba[i])) >> 1) >> 4;
+    }
+  }
+}
+
+// Scales a slide image and lays it out for the renderer. Safe to call from
+// any thread.
 static QImage* prepareSurface(const QImage* slideImage, int w, int h, QRgb bgcolor,
 PictureFlow::ReflectionEffect reflectionEffect)
 {
 #ifdef PICTUREFLOW_QT4
   Qt::TransformationMode mode = Qt::SmoothTransformation;
   QImage img = slideImage->scaled(w, h, Qt::IgnoreAspectRatio, mode);
+  // the scanlines are processed as 32-bit pixels below
+  if(img.format() != QImage::Format_RGB32)
+    img = img.convertToFormat(QImage::Format_RGB32);
 #endif
 #if defined(PICTUREFLOW_QT3) || defined(PICTUREFLOW_QT2)
   QImage img = slideImage->smoothScale(w, h);
@@ -550,102 +1244,233 @@ PictureFlow::ReflectionEffect reflectionEffect)
 #endif
   result->fill(bgcolor);
 
+  const QRgb* imageBits = (const QRgb*)(img.constBits());
+  int imageStride = img.bytesPerLine() / 4;
+  QRgb* resultBits = (QRgb*)(result->bits());
+  int resultStride = result->bytesPerLine() / 4;
+
   // transpose the image, this is to speed-up the rendering
   // because we process one column at a time
   // (and much better and faster to work row-wise, i.e in one scanline)
-  for(int x = 0; x < w; x++)
-    for(int y = 0; y < h; y++)
-      result->setPixel(hofs + y, x, img.pixel(x, y));
+  transposePixels(imageBits, imageStride, resultBits + hofs, resultStride, h, w);
 
-  if(reflectionEffect != PictureFlow::NoReflection)
+  int ht = hs - h - hofs;
+  if(reflectionEffect != PictureFlow::NoReflection && ht > 0)
   {
-    // create the reflection
-    int ht = hs - h - hofs;
+    // create the reflection: the bottom of the image upside down, fading
+    // out line by line, transposed like the image
     int hte = ht;
-    for(int x = 0; x < w; x++)
-      for(int y = 0; y < ht; y++)
-      {
-        QRgb color = img.pixel(x, img.height()-y-1);
-        result->setPixel(h+hofs+y, x, blendColor(color,bgcolor,128*(hte-y)/hte));
-      }
+#ifdef PICTUREFLOW_QT4
+    QImage reflection(w, ht, QImage::Format_RGB32);
+#endif
+#if defined(PICTUREFLOW_QT3) || defined(PICTUREFLOW_QT2)
+    QImage reflection;
+    reflection.create(w, ht, 32);
+#endif
+    for(int y = 0; y < ht; y++)
+    {
+      QRgb* line = (QRgb*)(reflection.scanLine(y));
+      memcpy(line, imageBits + (img.height()-y-1)*imageStride, w * sizeof(QRgb));
+      blendPixels(line, w, bgcolor, 128*(hte-y)/hte);
+    }
+    transposePixels((const QRgb*)(reflection.constBits()), reflection.bytesPerLine() / 4,
+                    resultBits + h + hofs, resultStride, ht, w);
 
     if(reflectionEffect == PictureFlow::BlurredReflection)
     {
       // blur the reflection everything first
-      // Based on exponential blur algorithm by Jani Huhtanen
       QRect rect(hs/2, 0, hs/2, w);
       rect &= result->rect();
+      blurPixels(result, rect);
 
-      int r1 = rect.top();
-      int r2 = rect.bottom();
-      int c1 = rect.left();
-      int c2 = rect.right();
+      // overdraw to leave only the reflection blurred (but not the actual image)
+      transposePixels(imageBits, imageStride, resultBits + hofs, resultStride, h, w);
+    }
+  }
 
-      int bpl = result->bytesPerLine();
-      int rgba[4];
-      unsigned char* p;
+  return result;
+}
 
-      // how many times blur is applied?
-      // for low-end system, limit this to only 1 loop
-      for(int loop = 0; loop < 2; loop++)
-      {
-        for(int col = c1; col <= c2; col++)
-        {
-          p = result->scanLine(r1) + col*4;
-          for(int i = 0; i < 3; i++)
-            rgba[i] = p[i] << 4;
-
-          p += bpl;
-          for(int j = r1; j < r2; j++, p += bpl)
-            for(int i = 0; i < 3; i++)
-              p[i] = (rgba[i] += (((p[i]<<4)-rgba[i])) >> 1) >> 4;
-        }
+// A hash of the pixels of a slide image, to find its surface by content.
+// FNV-1a over 32-bit words, with the high bits folded back in after each
+// step so that every bit of the input reaches all of the hash.
+static quint64 hashImage(const QImage& image)
+{
+  const quint64 prime = Q_UINT64_C(1099511628211);
+  quint64 hash = Q_UINT64_C(14695981039346656037);
+  hash = (hash ^ (quint32)image.width()) * prime;
+  hash = (hash ^ (quint32)image.height()) * prime;
+  hash = (hash ^ (quint32)image.format()) * prime;
+
+  int bytes = (image.width() * image.depth() + 7) / 8;
+  for(int y = 0; y < image.height(); y++)
+  {
+    const uchar* line = image.constScanLine(y);
+    int i = 0;
+    for(; i + 4 <= bytes; i += 4)
+    {
+      quint32 word;
+      memcpy(&word, line + i, 4);
+      hash = (hash ^ word) * prime;
+      hash ^= hash >> 29;
+    }
+    for(; i < bytes; i++)
+      hash = (hash ^ line[i]) * prime;
+  }
 
-        for(int row = r1; row <= r2; row++)
-        {
-          p = result->scanLine(row) + c1*4;
-          for(int i = 0; i < 3; i++)
-            rgba[i] = p[i] << 4;
-
-          p += 4;
-          for(int j = c1; j < c2; j++, p+=4)
-            for(int i = 0; i < 3; i++)
-              p[i] = (rgba[i] += (((p[i]<<4)-rgba[i])) >> 1) >> 4;
-        }
+  QVector<QRgb> colors = image.colorTable();
+  for(int i = 0; i < colors.count(); i++)
+    hash = (hash ^ colors.at(i)) * prime;
 
-        for(int col = c1; col <= c2; col++)
-        {
-          p = result->scanLine(r2) + col*4;
-          for(int i = 0; i < 3; i++)
-            rgba[i] = p[i] << 4;
-
-          p -= bpl;
-          for(int j = r1; j < r2; j++, p -= bpl)
-            for(int i = 0; i < 3; i++)
-              p[i] = (rgba[i] += (((p[i]<<4)-rgba[i])) >> 1) >> 4;
-        }
+  // 0 marks slides not hashed yet
+  return hash ? hash : 1;
+}
 
-        for(int row = r1; row <= r2; row++)
-        {
-          p = result->scanLine(row) + c2*4;
-          for(int i = 0; i < 3; i++)
-            rgba[i] = p[i] << 4;
-
-          p -= 4;
-          for(int j = c1; j < c2; j++, p-=4)
-            for(int i = 0; i < 3; i++)
-              p[i] = (rgba[i] += (((p[i]<<4)-rgba[i])) >> 1) >> 4;
-        }
-      }
+#ifdef PICTUREFLOW_QT4
+void PictureFlowSurfaceTask::run()
+{
+  request.surface = prepareSurface(&image, width, height, bgcolor, effect);
+  if(!directory.isEmpty())
+    request.stored = PictureFlowSurfaceCache::store(directory, request.key, *request.surface);
+  renderer->surfacePrepared(request);
+}
 
-      // overdraw to leave only the reflection blurred (but not the actual image)
-      for(int x = 0; x < w; x++)
-        for(int y = 0; y < h; y++)
-          result->setPixel(hofs + y, x, img.pixel(x, y));
-    }
+// called on the surface threads
+void PictureFlowSoftwareRenderer::surfacePrepared(const PreparedSurface& surface)
+{
+  QMutexLocker locker(&preparedMutex);
+  prepared.append(surface);
+  outstanding--;
+  locker.unlock();
+
+  // render again, with the surface
+  QMetaObject::invokeMethod(widget, "triggerRender", Qt::QueuedConnection);
+}
+
+// moves the surfaces prepared since the last frame to the cache
+void PictureFlowSoftwareRenderer::takePreparedSurfaces()
+{
+  QMutexLocker locker(&preparedMutex);
+  QList<PreparedSurface> surfaces = prepared;
+  prepared.clear();
+  locker.unlock();
+
+  // also those of slides replaced in the meantime, the artwork may come back
+  for(int i = 0; i < surfaces.count(); i++)
+  {
+    const PreparedSurface& surface = surfaces.at(i);
+    preparing.remove(surface.key);
+    surfaceCache.insert(surface.key, surface.surface, surface.stored);
+  }
+}
+
+// queues the preparation of a slide surface, unless it is cached or queued already
+void PictureFlowSoftwareRenderer::requestSurface(int slideIndex, int priority)
+{
+  if(slideIndex < 0 || slideIndex >= state->slideImages.count())
+    return;
+
+  const QImage* img = state->slideImages.at(slideIndex);
+  if(!img || img->isNull())
+    return;
+
+  SurfaceKey key = surfaceKey(slideIndex);
+  if(preparing.contains(key) || surfaceCache.contains(key))
+    return;
+
+  PreparedSurface request;
+  request.key = key;
+  request.surface = 0;
+  request.stored = false;
+
+  preparing.insert(key);
+  preparedMutex.lock();
+  outstanding++;
+  preparedMutex.unlock();
+
+  surfacePool.start(new PictureFlowSurfaceTask(this, request, *img, state->slideWidth, state->slideHeight,
+    bgcolor, state->reflectionEffect, surfaceCache.directory()), priority);
+}
+
+// queues the slides the animation brings into view next, nearest first
+void PictureFlowSoftwareRenderer::prefetchSurfaces()
+{
+  int reach = qMax(state->leftSlides.count(), state->rightSlides.count()) + PREFETCH_SLIDES;
+  int center = state->centerIndex;
+
+  // no more than the cache holds, or the surfaces would evict each other
+  qint64 surfaceBytes = (qint64)state->slideWidth * state->slideHeight * 2 * 4;
+  qint64 budget = surfaceCache.maximumBytes() + surfaceBytes;
+
+  for(int distance = 0; distance <= reach; distance++)
+  {
+    budget -= 2 * surfaceBytes;
+    if(budget < 0)
+      break;
+    requestSurface(center - distance, -distance);
+    requestSurface(center + distance, -distance);
   }
+}
+#endif
 
-  return result;
+bool PictureFlowSoftwareRenderer::isPreparing() const
+{
+#ifdef PICTUREFLOW_QT4
+  QMutexLocker locker(&preparedMutex);
+  return outstanding > 0;
+#else
+  return false;
+#endif
+}
+
+qint64 PictureFlowSoftwareRenderer::cachedBytes() const
+{
+  return surfaceCache.bytes();
+}
+
+// the surface shown for slides without an image, and for those being prepared
+QImage* PictureFlowSoftwareRenderer::placeholder()
+{
+  int sw = state->slideWidth;
+  int sh = state->slideHeight;
+
+  if(blankSurface && (blankSurface->width() != sh*2 || blankSurface->height() != sw))
+  {
+    delete blankSurface;
+    blankSurface = 0;
+  }
+
+  if(!blankSurface)
+  {
+#ifdef PICTUREFLOW_QT4
+    QImage img = QImage(sw, sh, QImage::Format_RGB32);
+
+    QPainter painter(&img);
+    QPoint p1(sw*4/10, 0);
+    QPoint p2(sw*6/10, sh);
+    QLinearGradient linearGrad(p1, p2);
+    linearGrad.setColorAt(0, Qt::black);
+    linearGrad.setColorAt(1, Qt::white);
+    painter.setBrush(linearGrad);
+    painter.fillRect(0, 0, sw, sh, QBrush(linearGrad));
+
+    painter.setPen(QPen(QColor(64,64,64), 4));
+    painter.setBrush(QBrush());
+    painter.drawRect(2, 2, sw-3, sh-3);
+    painter.end();
+#endif
+#if defined(PICTUREFLOW_QT3) || defined(PICTUREFLOW_QT2)
+    QPixmap pixmap(sw, sh, 32);
+    QPainter painter(&pixmap);
+    painter.fillRect(pixmap.rect(), QColor(192,192,192));
+    painter.fillRect(5, 5, sw-10, sh-10, QColor(64,64,64));
+    painter.end();
+    QImage img = pixmap.convertToImage();
+#endif
+
+    blankSurface = prepareSurface(&img, sw, sh, bgcolor, state->reflectionEffect);
+  }
+  return blankSurface;
 }
 
 QImage* PictureFlowSoftwareRenderer::surface(int slideIndex)
@@ -657,81 +1482,67 @@ QImage* PictureFlowSoftwareRenderer::surface(int slideIndex)
   if(slideIndex >= (int)state->slideImages.count())
     return 0;
 
-#ifdef PICTUREFLOW_QT4
-  int key = slideIndex;
-#endif
-#if defined(PICTUREFLOW_QT3) || defined(PICTUREFLOW_QT2)
-  QString key = QString::number(slideIndex);
-#endif
-
   QImage* img = state->slideImages.at(slideIndex);
   bool empty = img ? img->isNull() : true;
   if(empty)
-  {
-    surfaceCache.remove(key);
-    imageHash.remove(slideIndex);
-    if(!blankSurface)
-    {
-      int sw = state->slideWidth;
-      int sh = state->slideHeight;
+    return placeholder();
 
-#ifdef PICTUREFLOW_QT4
-      QImage img = QImage(sw, sh, QImage::Format_RGB32);
-
-      QPainter painter(&img);
-      QPoint p1(sw*4/10, 0);
-      QPoint p2(sw*6/10, sh);
-      QLinearGradient linearGrad(p1, p2);
-      linearGrad.setColorAt(0, Qt::black);
-      linearGrad.setColorAt(1, Qt::white);
-      painter.setBrush(linearGrad);
-      painter.fillRect(0, 0, sw, sh, QBrush(linearGrad));
-
-      painter.setPen(QPen(QColor(64,64,64), 4));
-      painter.setBrush(QBrush());
-      painter.drawRect(2, 2, sw-3, sh-3);
-      painter.end();
-#endif
-#if defined(PICTUREFLOW_QT3) || defined(PICTUREFLOW_QT2)
-      QPixmap pixmap(sw, sh, 32);
-      QPainter painter(&pixmap);
-      painter.fillRect(pixmap.rect(), QColor(192,192,192));
-      painter.fillRect(5, 5, sw-10, sh-10, QColor(64,64,64));
-      painter.end();
-      QImage img = pixmap.convertToImage();
-#endif
-
-      blankSurface = prepareSurface(&img, sw, sh, bgcolor, state->reflectionEffect);
-    }
-    return blankSurface;
+  SurfaceKey key = surfaceKey(slideIndex);
+  QImage* sr = surfaceCache.find(key);
+  if(sr)
+  {
+    releaseSlideImage(slideIndex, *sr);
+    return sr;
   }
 
 #ifdef PICTUREFLOW_QT4
-  bool exist = imageHash.contains(slideIndex);
-  if(exist)
-  if(img == imageHash.find(slideIndex).value())
-#endif
-#ifdef PICTUREFLOW_QT3
-  bool exist = imageHash.find(slideIndex) != imageHash.end();
-  if(exist)
-  if(img == imageHash.find(slideIndex).data())
-#endif
-#ifdef PICTUREFLOW_QT2
-  if(img == imageHash[slideIndex])
+  requestSurface(slideIndex, -qAbs(slideIndex - state->centerIndex));
+  return placeholder();
+#else
+  sr = prepareSurface(img, state->slideWidth, state->slideHeight, bgcolor, state->reflectionEffect);
+  surfaceCache.insert(key, sr, false);
+  return sr;
 #endif
-    if(surfaceCache.contains(key))
-        return surfaceCache[key];
+}
+
+// the key of the current surface of a slide, hashing its image when first needed
+SurfaceKey PictureFlowSoftwareRenderer::surfaceKey(int slideIndex)
+{
+  quint64& hash = state->slideHashes[slideIndex];
+  if(!hash)
+    hash = hashImage(*state->slideImages.at(slideIndex));
+
+  SurfaceKey key;
+  key.imageHash = hash;
+  key.width = state->slideWidth;
+  key.height = state->slideHeight;
+  key.effect = (int)state->reflectionEffect;
+  key.bgcolor = bgcolor;
+  return key;
+}
 
-  QImage* sr = prepareSurface(img, state->slideWidth, state->slideHeight, bgcolor, state->reflectionEffect);
-  surfaceCache.insert(key, sr);
-  imageHash.insert(slideIndex, img);
+// Once a slide has its surface, its image is only needed to prepare the
+// surface again. Artwork larger than the slide is replaced by the copy in
+// the surface, which is already scaled. The hash stays that of the artwork.
+void PictureFlowSoftwareRenderer::releaseSlideImage(int slideIndex, const QImage& surface)
+{
+  QImage* img = state->slideImages.at(slideIndex);
+  int w = state->slideWidth;
+  int h = state->slideHeight;
+  if((qint64)img->width() * img->height() <= (qint64)w * h)
+    return;
 
-  return sr;
+  QImage* scaled = new QImage(w, h, QImage::Format_RGB32);
+  transposePixels((const QRgb*)(surface.constBits()) + h/3, surface.bytesPerLine() / 4,
+                  (QRgb*)(scaled->bits()), scaled->bytesPerLine() / 4, w, h);
+  delete img;
+  state->slideImages[slideIndex] = scaled;
 }
 
-// Renders a slide to offscreen buffer. Returns a rect of the rendered area.
+// Finds the screen columns a slide is drawn to, without drawing it, and
+// queues them for renderColumns(). Returns a rect of the area to be drawn.
 // col1 and col2 limit the column for rendering.
-QRect PictureFlowSoftwareRenderer::renderSlide(const SlideInfo &slide, int col1, int col2)
+QRect PictureFlowSoftwareRenderer::traceSlide(const SlideInfo &slide, int col1, int col2)
 {
   int blend = slide.blend;
   if(!blend)
@@ -772,6 +1583,16 @@ QRect PictureFlowSoftwareRenderer::renderSlide(const SlideInfo &slide, int col1,
   if(xi >= w)
     return rect;
 
+  // the entries are reused from frame to frame
+  if(tracedCount == traced.count())
+    traced.resize(tracedCount + 1);
+  SlideColumns& columns = traced[tracedCount];
+  columns.blend = blend;
+  columns.surfaceWidth = sh;
+  columns.hits.resize(0);
+
+  const ColumnHit miss = { 0, 0 };
+
   bool flag = false;
   rect.setLeft(xi);
   for(int x = qMax(xi, col1); x <= col2; x++)
@@ -799,82 +1620,167 @@ QRect PictureFlowSoftwareRenderer::renderSlide(const SlideInfo &slide, int col1,
 
     rect.setRight(x);
     if(!flag)
+    {
       rect.setLeft(x);
+      columns.left = x;
+    }
     flag = true;
 
-    int y1 = h/2;
-    int y2 = y1+ 1;
-    QRgb* pixel1 = (QRgb*)(buffer.scanLine(y1)) + x;
-    QRgb* pixel2 = (QRgb*)(buffer.scanLine(y2)) + x;
-    QRgb pixelstep = pixel2 - pixel1;
+    while(columns.left + columns.hits.count() < x)
+      columns.hits.append(miss);
 
-    int center = (sh/2);
-    int dy = dist / h;
-    int p1 = center*PFREAL_ONE - dy/2;
-    int p2 = center*PFREAL_ONE + dy/2;
+    ColumnHit hit = { (const QRgb*)(src->constScanLine(column)), dist };
+    columns.hits.append(hit);
+  }
 
-    const QRgb *ptr = (const QRgb*)(src->scanLine(column));
-    if(blend == 256)
-      while((y1 >= 0) && (y2 < h) && (p1 >= 0))
-      {
-        *pixel1 = ptr[p1 >> PFREAL_SHIFT];
-        *pixel2 = ptr[p2 >> PFREAL_SHIFT];
-        p1 -= dy;
-        p2 += dy;
-        y1--;
-        y2++;
-        pixel1 -= pixelstep;
-        pixel2 += pixelstep;
-      }
-    else
-      while((y1 >= 0) && (y2 < h) && (p1 >= 0))
-      {
-        QRgb c1 = ptr[p1 >> PFREAL_SHIFT];
-        QRgb c2 = ptr[p2 >> PFREAL_SHIFT];
-        *pixel1 = blendColor(c1, bgcolor, blend);
-        *pixel2 = blendColor(c2, bgcolor, blend);
-        p1 -= dy;
-        p2 += dy;
-        y1--;
-        y2++;
-        pixel1 -= pixelstep;
-        pixel2 += pixelstep;
-     }
-   }
-
-   rect.setTop(0);
-   rect.setBottom(h-1);
-   return rect;
-}
-
-void PictureFlowSoftwareRenderer::renderSlides()
+  if(flag)
+  {
+    columns.right = rect.right();
+    tracedCount++;
+  }
+
+  rect.setTop(0);
+  rect.setBottom(h-1);
+  return rect;
+}
+
+// Traces all slides, center first, each side from the inside out. A slide
+// only gets the columns not taken by the slides traced before it.
+void PictureFlowSoftwareRenderer::traceSlides()
 {
   int nleft = state->leftSlides.count();
   int nright = state->rightSlides.count();
 
-  QRect r = renderSlide(state->centerSlide);
+  tracedCount = 0;
+
+  QRect r = traceSlide(state->centerSlide);
   int c1 = r.left();
   int c2 = r.right();
 
   for(int index = 0; index < nleft; index++)
   {
-    QRect rs = renderSlide(state->leftSlides[index], 0, c1-1);
+    QRect rs = traceSlide(state->leftSlides[index], 0, c1-1);
     if(!rs.isEmpty())
       c1 = rs.left();
   }
   for(int index = 0; index < nright; index++)
   {
-    QRect rs = renderSlide(state->rightSlides[index], c2+1, buffer.width());
+    QRect rs = traceSlide(state->rightSlides[index], c2+1, buffer.width());
     if(!rs.isEmpty())
       c2 = rs.right();
   }
 }
 
+// Draws one screen column of a slide into the column buffer, ray-casting
+// from the middle of the screen up and down.
+void PictureFlowSoftwareRenderer::renderColumn(const SlideColumns& slide, const ColumnHit& hit, int x)
+{
+  int h = buffer.height();
+  QRgb* pixels = (QRgb*)(columnBits + x*columnStride);
+
+  int y1 = h/2;
+  int y2 = y1+ 1;
+
+  int center = (slide.surfaceWidth/2);
+  int dy = hit.dist / h;
+  int p1 = center*PFREAL_ONE - dy/2;
+  int p2 = center*PFREAL_ONE + dy/2;
+
+  const QRgb *ptr = hit.texels;
+  while((y1 >= 0) && (y2 < h) && (p1 >= 0))
+  {
+    pixels[y1] = ptr[p1 >> PFREAL_SHIFT];
+    pixels[y2] = ptr[p2 >> PFREAL_SHIFT];
+    p1 -= dy;
+    p2 += dy;
+    y1--;
+    y2++;
+  }
+
+  // the column is contiguous, fade it in one go
+  if(slide.blend != 256)
+    blendPixels(pixels + y1 + 1, y2 - y1 - 1, bgcolor, slide.blend);
+}
+
+// Renders the screen columns col1 to col2 of the traced slides into the
+// offscreen buffer. Called from several threads at once, for disjoint
+// ranges of columns.
+void PictureFlowSoftwareRenderer::renderColumns(int col1, int col2)
+{
+  int h = buffer.height();
+
+  for(int x = col1; x <= col2; x++)
+  {
+    QRgb* pixels = (QRgb*)(columnBits + x*columnStride);
+    for(int y = 0; y < h; y++)
+      pixels[y] = fillColor;
+  }
+
+  for(int index = 0; index < tracedCount; index++)
+  {
+    const SlideColumns& slide = traced.at(index);
+    int x1 = qMax(col1, slide.left);
+    int x2 = qMin(col2, slide.right);
+    for(int x = x1; x <= x2; x++)
+    {
+      const ColumnHit& hit = slide.hits.at(x - slide.left);
+      if(hit.texels)
+        renderColumn(slide, hit, x);
+    }
+  }
+
+  transposePixels((const QRgb*)(columnBits + col1*columnStride), columnStride/4,
+                  (QRgb*)(bufferBits) + col1, bufferStride/4, col2 - col1 + 1, h);
+}
+
 // Render the slides. Updates only the offscreen buffer.
 void PictureFlowSoftwareRenderer::render()
 {
-  buffer.fill(state->backgroundColor);
-  renderSlides();
+  int w = buffer.width();
+  int h = buffer.height();
+  if(w <= 0 || h <= 0)
+  {
+    dirty = false;
+    return;
+  }
+
+  // everything touching the slides and images happens here, the render
+  // threads only write to the buffers
+#ifdef PICTUREFLOW_QT4
+  takePreparedSurfaces();
+#endif
+  traceSlides();
+#ifdef PICTUREFLOW_QT4
+  prefetchSurfaces();
+#endif
+  fillColor = state->backgroundColor;
+  bufferBits = buffer.bits();
+  bufferStride = buffer.bytesPerLine();
+  columnBits = columnBuffer.bits();
+  columnStride = columnBuffer.bytesPerLine();
+
+#ifdef PICTUREFLOW_QT4
+  int threads = state->renderThreads > 0 ? state->renderThreads : QThread::idealThreadCount();
+  threads = qMax(threads, 1);
+
+  // bands are a multiple of 16 columns wide, so that the threads rarely
+  // write to the same cache line of the buffer
+  int band = (((w + threads - 1) / threads) + 15) & ~15;
+  int bands = (w + band - 1) / band;
+
+  renderPool.setMaxThreadCount(qMax(bands - 1, 1));
+  for(int index = 1; index < bands; index++)
+    renderPool.start(new PictureFlowRenderTask(this, index*band, qMin(w, (index+1)*band) - 1));
+
+  renderColumns(0, qMin(w, band) - 1);
+  renderPool.waitForDone();
+#else
+  renderColumns(0, w-1);
+#endif
+
+  // only now that no surface is in use
+  surfaceCache.trim();
+
   dirty = false;
 }
 
@@ -973,6 +1879,50 @@ void PictureFlow::setReflectionEffect(ReflectionEffect effect)
   triggerRender();
 }
 
+bool PictureFlow::isPreparingSlides() const
+{
+  return d->renderer->isPreparing();
+}
+
+qint64 PictureFlow::cacheSize() const
+{
+  return d->state->cacheBytes;
+}
+
+void PictureFlow::setCacheSize(qint64 bytes)
+{
+  d->state->cacheBytes = qMax(bytes, (qint64)0);
+  triggerRender();
+}
+
+qint64 PictureFlow::cachedBytes() const
+{
+  return d->renderer->cachedBytes();
+}
+
+QString PictureFlow::cacheDirectory() const
+{
+  return d->state->cacheDirectory;
+}
+
+void PictureFlow::setCacheDirectory(const QString& path, qint64 maximumBytes)
+{
+  d->state->cacheDirectory = path;
+  d->state->cacheDirectoryBytes = maximumBytes;
+  triggerRender();
+}
+
+int PictureFlow::renderThreadCount() const
+{
+  return d->state->renderThreads;
+}
+
+void PictureFlow::setRenderThreadCount(int threads)
+{
+  d->state->renderThreads = qMax(threads, 0);
+  triggerRender();
+}
+
 QImage PictureFlow::slide(int index) const
 {
   QImage* i = 0;
@@ -986,6 +1936,8 @@ void PictureFlow::addSlide(const QImage& image)
   int c = d->state->slideImages.count();
   d->state->slideImages.resize(c+1);
   d->state->slideImages[c] = new QImage(image);
+  d->state->slideHashes.resize(c+1);
+  d->state->slideHashes[c] = 0;
   triggerRender();
 }
 
@@ -1001,6 +1953,7 @@ void PictureFlow::setSlide(int index, const QImage& image)
     QImage* i = image.isNull() ? 0 : new QImage(image);
     delete d->state->slideImages[index];
     d->state->slideImages[index] = i;
+    d->state->slideHashes[index] = 0;
     triggerRender();
   }
 }
@@ -1031,6 +1984,7 @@ void PictureFlow::clear()
   for(int i = 0; i < c; i++)
     delete d->state->slideImages[i];
   d->state->slideImages.resize(0);
+  d->state->slideHashes.resize(0);
 
   d->state->reset();
   triggerRender();
@@ -96,7 +96,8 @@ public:
   int slideCount() const;
 
   /*!
-    Returns QImage of specified slide.
+    Returns QImage of specified slide. Once the slide has been shown, an
+    image larger than the slide size is replaced by a copy scaled to it.
   */
   QImage slide(int index) const;
 
@@ -115,6 +116,55 @@ public:
   */
   void setReflectionEffect(ReflectionEffect effect);
 
+  /*!
+    Returns the number of threads rendering a frame, 0 for one per CPU core.
+  */
+  int renderThreadCount() const;
+
+  /*!
+    Sets the number of threads rendering a frame. Each renders a band of
+    screen columns. The default is 0, one thread per CPU core.
+  */
+  void setRenderThreadCount(int threads);
+
+  /*!
+    Returns true while slide images are being prepared for display. This
+    happens in the background, slides show a placeholder until they are
+    ready.
+  */
+  bool isPreparingSlides() const;
+
+  /*!
+    Returns the most memory, in bytes, that prepared slides are kept in.
+  */
+  qint64 cacheSize() const;
+
+  /*!
+    Sets the most memory, in bytes, that prepared slides are kept in. The
+    least recently shown ones are dropped beyond it, except for those in
+    view. The default is 64 MB.
+  */
+  void setCacheSize(qint64 bytes);
+
+  /*!
+    Returns the memory, in bytes, that prepared slides take at the moment.
+  */
+  qint64 cachedBytes() const;
+
+  /*!
+    Returns the directory prepared slides are kept in across restarts, or an
+    empty string if there is none.
+  */
+  QString cacheDirectory() const;
+
+  /*!
+    Keeps prepared slides in the directory path as well, where they are found
+    again by the content of their image after a restart. The oldest files
+    beyond maximumBytes are removed when the directory is set. An empty path,
+    the default, keeps prepared slides in memory only.
+  */
+  void setCacheDirectory(const QString& path, qint64 maximumBytes = 256*1024*1024);
+
 
 public slots:
 
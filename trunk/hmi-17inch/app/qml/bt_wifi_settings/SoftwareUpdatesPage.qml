@@ -1,5 +1,6 @@
 import QtQuick 2.0
 import com.qnx.car.ui 2.0
+import com.qnx.car.services 2.0 as Services
 
 import "qrc:///qnxcarui/qml/common"
 import "qrc:///qnxcarui/qml/common/util.js" as Util
@@ -12,8 +13,8 @@ Item {
     property string updateDetailsText: processUpdateDetailsText();
 
     function processUpdateDetailsText() {
-        if(_systemInfo.updateDetails.length > 0) {
-            var updateDetailsObj = JSON.parse(_systemInfo.updateDetails);
+        if(Services.SystemInfo.updateDetails.length > 0) {
+            var updateDetailsObj = JSON.parse(Services.SystemInfo.updateDetails);
             //return "Update to version " + updateDetailsObj.targetVersion;
             return "更新至版本 " + updateDetailsObj.targetVersion;
         } else {
@@ -58,7 +59,7 @@ Item {
             anchors.top: softwareUpdateText.bottom
             anchors.left: softwareUpdateText.left
 
-            visible: !_systemInfo.available
+            visible: !Services.SystemInfo.available
 
             //text: qsTr("Software Update Service Not Available")
             text: qsTr("不能进行软件更新")
@@ -86,16 +87,16 @@ Item {
                     font.bold: true;
                 }
                 Label {
-                    //text: qsTr("Version: ") + _systemInfo.buildNumber
-                    text: qsTr("版本: ") + _systemInfo.buildNumber
+                    //text: qsTr("Version: ") + Services.SystemInfo.buildNumber
+                    text: qsTr("版本: ") + Services.SystemInfo.buildNumber
                 }
                 Label {
-                    //text: qsTr("Revision: ") + _systemInfo.revision
-                    text: qsTr("修订: ") + _systemInfo.revision
+                    //text: qsTr("Revision: ") + Services.SystemInfo.revision
+                    text: qsTr("修订: ") + Services.SystemInfo.revision
                 }
                 Label {
-                    //text: qsTr("Date: ") + _systemInfo.buildDate
-                    text: qsTr("日期: ") + _systemInfo.buildDate
+                    //text: qsTr("Date: ") + Services.SystemInfo.buildDate
+                    text: qsTr("日期: ") + Services.SystemInfo.buildDate
                 }
             }
         }
@@ -110,7 +111,7 @@ Item {
             anchors.left: updateButton.left
             anchors.right: parent.right
 
-            visible: (_systemInfo.updateDetails &&_systemInfo.updateDetails.length > 0)
+            visible: (Services.SystemInfo.updateDetails &&Services.SystemInfo.updateDetails.length > 0)
 
             Label {
                 //text: qsTr("Update Available: ")
@@ -122,15 +123,15 @@ Item {
                 text: qsTr("更新详细: ") + updateDetailsText
             }
             Label {
-                visible: _systemInfo.updateError.length > 0
-                //text: qsTr("Update error: ") + _systemInfo.updateError
-                text: qsTr("更新错误: ") + _systemInfo.updateError
+                visible: Services.SystemInfo.updateError.length > 0
+                //text: qsTr("Update error: ") + Services.SystemInfo.updateError
+                text: qsTr("更新错误: ") + Services.SystemInfo.updateError
                 anchors.left: parent.left;
                 anchors.right: parent.right;
                 wrapMode: Text.WordWrap
             }
             Label {
-                visible: !_systemInfo.updateError
+                visible: !Services.SystemInfo.updateError
                 //text: qsTr("To update your car to the latest software version, press Update");
                 text: qsTr("点击更新按钮，让你的车更新至最新版本软件");
             }
@@ -143,30 +144,30 @@ Item {
             anchors.top: softwareUpdateText.bottom
             anchors.left: softwareUpdateText.left
 
-            visible: _systemInfo.updateAvailable || ( _systemInfo.updateError && _systemInfo.updateError.length === 0)
+            visible: Services.SystemInfo.updateAvailable || ( Services.SystemInfo.updateError && Services.SystemInfo.updateError.length === 0)
 
             //label.text: qsTr("UPDATE")
             label.text: qsTr("更新")
             label.fontSize: 18
 
             onClicked: {
-                _systemInfo.performUpdate();
+                Services.SystemInfo.performUpdate();
             }
         }
     }
 
     Connections {
-        target: _systemInfo
+        target: Services.SystemInfo
 
         onUpdateAvailableChanged: {
 
-            if(_systemInfo.updateDetails.length > 0) {
+            if(Services.SystemInfo.updateDetails.length > 0) {
                 updateDetails.visible = true;
                 updateDetailsText = processUpdateDetailsText();
                 updateButton.visible = updateAvailable;
             }
 
-            if(!updateAvailable && !_systemInfo.updateDetails) {
+            if(!updateAvailable && !Services.SystemInfo.updateDetails) {
                 updateDetails.visible = false;
                 updateButton.visible = false;
             }
@@ -174,7 +175,7 @@ Item {
 
         onAvailableChanged: {
 
-            if(_systemInfo.available) {
+            if(Services.SystemInfo.available) {
                 updateDetails.visible = true;
                 notAvailalble.visible = false;
             } else {
@@ -1,4 +1,5 @@
 import QtQuick 2.0
+import com.qnx.car.services 2.0 as Services
 
 import "components"
 import "qrc:///qnxcarui/qml/common"
@@ -105,7 +106,7 @@ Item {
 
                    LineEdit {
                        id: ipAddress
-                       text: qsTr(_networkInfo.ipAddress)
+                       text: qsTr(Services.NetworkInfo.ipAddress)
                    }
                }
                Row {
@@ -123,7 +124,7 @@ Item {
 
                    LineEdit {
                        id: subnet
-                       text: qsTr(_networkInfo.netmask)
+                       text: qsTr(Services.NetworkInfo.netmask)
                    }
                }
                Row {
@@ -141,7 +142,7 @@ Item {
 
                    LineEdit {
                        id: gateway
-                       text: qsTr(_networkInfo.gateway)
+                       text: qsTr(Services.NetworkInfo.gateway)
                    }
                }
 
@@ -159,11 +160,11 @@ Item {
 
                     onClicked: {
                         if(radioBtDynamicIp.checked) {
-                            _networkInfo.setDynamicNetworkConfig();
+                            Services.NetworkInfo.setDynamicNetworkConfig();
                         } else {
                             // validate IP, Gateway and Subnet
                             if(ipAddress.text.length > 0 && subnet.text.length > 0 && gateway.text.length > 0) {
-                                _networkInfo.setStaticNetworkConfig(ipAddress.text,subnet.text,gateway.text);
+                                Services.NetworkInfo.setStaticNetworkConfig(ipAddress.text,subnet.text,gateway.text);
                             } else {
                                 console.debug("Error validating IP or Gateway or Subnet");
                             }
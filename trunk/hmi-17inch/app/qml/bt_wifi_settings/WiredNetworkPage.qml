@@ -1,5 +1,6 @@
 import QtQuick 2.0
 import com.qnx.car.ui 2.0
+import com.qnx.car.services 2.0 as Services
 
 import "qrc:///qnxcarui/qml/common"
 import "qrc:///qnxcarui/qml/common/util.js" as Util
@@ -66,7 +67,7 @@ Item {
         }
 
         Label {
-            text: _networkInfo.ipAddress !== "" ? _networkInfo.ipAddress : qsTr("---.---.---.---")
+            text: Services.NetworkInfo.ipAddress !== "" ? Services.NetworkInfo.ipAddress : qsTr("---.---.---.---")
             fontSize: 16
         }
 
@@ -78,7 +79,7 @@ Item {
         }
 
         Label {
-            text: _networkInfo.netmask !== "" ? _networkInfo.netmask : qsTr("---.---.---.---")
+            text: Services.NetworkInfo.netmask !== "" ? Services.NetworkInfo.netmask : qsTr("---.---.---.---")
             fontSize: 16
         }
 
@@ -90,7 +91,7 @@ Item {
         }
 
         Label {
-            text: _networkInfo.gateway !== "" ? _networkInfo.gateway : qsTr("---.---.---.---")
+            text: Services.NetworkInfo.gateway !== "" ? Services.NetworkInfo.gateway : qsTr("---.---.---.---")
             fontSize: 16
         }
     }
@@ -160,7 +161,7 @@ Item {
     }
 
     Connections {
-        target: _networkInfo
+        target: Services.NetworkInfo
 
         onConfigurationSaved: {
             networkConfigPane.active = false;
@@ -120,6 +120,14 @@ Item {
             _mediaPlayerModule.searchModel.search(_mediaPlayerModule.selectedSearchSourceId, searchText, "");
         }
 
+        // the model waits for the user to stop typing before searching
+        onSearchTextChanged: {
+            if (searchText.trim().length > 0)
+                _mediaPlayerModule.searchModel.search(_mediaPlayerModule.selectedSearchSourceId, searchText, "");
+            else
+                _mediaPlayerModule.searchModel.resetSearch();
+        }
+
         onSearchCleared: {
             _mediaPlayerModule.searchModel.resetSearch();
         }
@@ -0,0 +1,342 @@
+#include "MockScreen.h"
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QQueue>
+#include <QThread>
+#include <QVector>
+#include <QWaitCondition>
+
+#include <cerrno>
+
+struct _screen_event
+{
+    _screen_event()
+        : type(SCREEN_EVENT_NONE)
+        , window(0)
+    {
+    }
+
+    int type;
+    screen_window_t window;
+};
+
+struct _screen_window
+{
+    pid_t pid;
+    QByteArray group;
+    bool closed;
+    QHash<int, QVector<int> > properties;
+};
+
+struct _screen_context
+{
+    int flags;
+    QQueue<_screen_event> events;
+};
+
+namespace {
+
+struct MockScreenState
+{
+    MockScreenState()
+        : flushes(0)
+        , flushLatency(0)
+    {
+    }
+
+    QMutex mutex;
+    QWaitCondition eventsQueued;
+    QList<screen_context_t> contexts;
+    QList<screen_window_t> windows;
+    int flushes;
+    int flushLatency;
+};
+
+}
+
+Q_GLOBAL_STATIC(MockScreenState, mockScreen)
+
+/// Queues an event for all window manager contexts, the caller holds the mutex
+static void queueWindowManagerEvent(MockScreenState *state, int type, screen_window_t window)
+{
+    _screen_event event;
+    event.type = type;
+    event.window = window;
+
+    Q_FOREACH (screen_context_t context, state->contexts) {
+        if (context->flags & SCREEN_WINDOW_MANAGER_CONTEXT)
+            context->events.enqueue(event);
+    }
+
+    state->eventsQueued.wakeAll();
+}
+
+/// The number of values of an integer window property
+static int propertySize(int pname)
+{
+    switch (pname) {
+    case SCREEN_PROPERTY_POSITION:
+    case SCREEN_PROPERTY_SIZE:
+    case SCREEN_PROPERTY_CLIP_POSITION:
+    case SCREEN_PROPERTY_CLIP_SIZE:
+    case SCREEN_PROPERTY_SOURCE_SIZE:
+    case SCREEN_PROPERTY_SOURCE_CLIP_SIZE:
+        return 2;
+    default:
+        return 1;
+    }
+}
+
+int screen_create_context(screen_context_t *pctx, int flags)
+{
+    MockScreenState *state = mockScreen();
+    QMutexLocker locker(&state->mutex);
+
+    screen_context_t context = new _screen_context;
+    context->flags = flags;
+    state->contexts.append(context);
+
+    *pctx = context;
+    return 0;
+}
+
+int screen_destroy_context(screen_context_t ctx)
+{
+    MockScreenState *state = mockScreen();
+    QMutexLocker locker(&state->mutex);
+
+    if (!state->contexts.removeOne(ctx)) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    delete ctx;
+    return 0;
+}
+
+int screen_flush_context(screen_context_t ctx, int flags)
+{
+    Q_UNUSED(ctx);
+    Q_UNUSED(flags);
+
+    MockScreenState *state = mockScreen();
+    int latency;
+    {
+        QMutexLocker locker(&state->mutex);
+        ++state->flushes;
+        latency = state->flushLatency;
+    }
+
+    // a busy compositor takes a while to accept the changes
+    if (latency > 0)
+        QThread::msleep(latency);
+
+    return 0;
+}
+
+int screen_create_event(screen_event_t *pev)
+{
+    *pev = new _screen_event;
+    return 0;
+}
+
+int screen_destroy_event(screen_event_t ev)
+{
+    delete ev;
+    return 0;
+}
+
+int screen_get_event(screen_context_t ctx, screen_event_t ev, uint64_t timeout)
+{
+    MockScreenState *state = mockScreen();
+    QMutexLocker locker(&state->mutex);
+
+    // the timeout is in nanoseconds, -1 waits until an event arrives
+    QElapsedTimer timer;
+    timer.start();
+    while (ctx->events.isEmpty()) {
+        if (timeout == ~uint64_t(0)) {
+            state->eventsQueued.wait(&state->mutex);
+            continue;
+        }
+
+        const qint64 remaining = qint64(timeout / 1000000) - timer.elapsed();
+        if (remaining <= 0)
+            break;
+        state->eventsQueued.wait(&state->mutex, remaining);
+    }
+
+    *ev = ctx->events.isEmpty() ? _screen_event() : ctx->events.dequeue();
+    return 0;
+}
+
+int screen_get_event_property_iv(screen_event_t ev, int pname, int *param)
+{
+    if (pname != SCREEN_PROPERTY_TYPE) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    *param = ev->type;
+    return 0;
+}
+
+int screen_set_event_property_iv(screen_event_t ev, int pname, const int *param)
+{
+    if (pname != SCREEN_PROPERTY_TYPE) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    ev->type = *param;
+    return 0;
+}
+
+int screen_get_event_property_pv(screen_event_t ev, int pname, void **param)
+{
+    if (pname != SCREEN_PROPERTY_WINDOW) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    *param = ev->window;
+    return 0;
+}
+
+int screen_send_event(screen_context_t ctx, screen_event_t ev, pid_t pid)
+{
+    Q_UNUSED(ctx);
+
+    // all contexts belong to this process
+    if (pid != getpid()) {
+        errno = ESRCH;
+        return -1;
+    }
+
+    MockScreenState *state = mockScreen();
+    QMutexLocker locker(&state->mutex);
+
+    Q_FOREACH (screen_context_t context, state->contexts)
+        context->events.enqueue(*ev);
+
+    state->eventsQueued.wakeAll();
+    return 0;
+}
+
+int screen_get_window_property_cv(screen_window_t win, int pname, int len, char *param)
+{
+    MockScreenState *state = mockScreen();
+    QMutexLocker locker(&state->mutex);
+
+    if (pname != SCREEN_PROPERTY_GROUP || len <= 0) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    qstrncpy(param, win->group.constData(), len);
+    return 0;
+}
+
+int screen_get_window_property_iv(screen_window_t win, int pname, int *param)
+{
+    MockScreenState *state = mockScreen();
+    QMutexLocker locker(&state->mutex);
+
+    if (pname == SCREEN_PROPERTY_OWNER_PID) {
+        *param = win->pid;
+        return 0;
+    }
+
+    const QVector<int> values = win->properties.value(pname);
+    for (int i = 0; i < propertySize(pname); ++i)
+        param[i] = values.value(i);
+
+    return 0;
+}
+
+int screen_set_window_property_iv(screen_window_t win, int pname, const int *param)
+{
+    MockScreenState *state = mockScreen();
+    QMutexLocker locker(&state->mutex);
+
+    if (win->closed) {
+        errno = ENOENT;
+        return -1;
+    }
+
+    QVector<int> &values = win->properties[pname];
+    values.resize(propertySize(pname));
+    for (int i = 0; i < values.size(); ++i)
+        values[i] = param[i];
+
+    return 0;
+}
+
+namespace MockScreen
+{
+
+screen_window_t postWindow(pid_t pid, const QString &group)
+{
+    MockScreenState *state = mockScreen();
+    QMutexLocker locker(&state->mutex);
+
+    screen_window_t window = new _screen_window;
+    window->pid = pid;
+    window->group = group.toLocal8Bit();
+    window->closed = false;
+    state->windows.append(window);
+
+    queueWindowManagerEvent(state, SCREEN_EVENT_CREATE, window);
+    queueWindowManagerEvent(state, SCREEN_EVENT_POST, window);
+
+    return window;
+}
+
+void closeWindow(screen_window_t window)
+{
+    MockScreenState *state = mockScreen();
+    QMutexLocker locker(&state->mutex);
+
+    window->closed = true;
+    queueWindowManagerEvent(state, SCREEN_EVENT_CLOSE, window);
+}
+
+int windowProperty(screen_window_t window, int property, int index)
+{
+    MockScreenState *state = mockScreen();
+    QMutexLocker locker(&state->mutex);
+
+    return window->properties.value(property).value(index);
+}
+
+int flushCount()
+{
+    MockScreenState *state = mockScreen();
+    QMutexLocker locker(&state->mutex);
+
+    return state->flushes;
+}
+
+void setFlushLatency(int msecs)
+{
+    MockScreenState *state = mockScreen();
+    QMutexLocker locker(&state->mutex);
+
+    state->flushLatency = msecs;
+}
+
+void reset()
+{
+    MockScreenState *state = mockScreen();
+    QMutexLocker locker(&state->mutex);
+
+    qDeleteAll(state->windows);
+    state->windows.clear();
+    state->flushes = 0;
+    state->flushLatency = 0;
+}
+
+}
@@ -0,0 +1,51 @@
+#ifndef MOCKSCREEN_H
+#define MOCKSCREEN_H
+
+#include <QString>
+
+#include <unistd.h>
+#include <screen/screen.h>
+
+/**
+ * @brief A stand-in for the QNX screen library, so that the WindowManager runs on Linux.
+ *
+ * Implements the part of the screen API the WindowManager uses: contexts, events with screen_get_event()
+ * and screen_send_event(), and windows with integer and group name properties. Windows of other processes
+ * are simulated with the functions below, which queue the events screen would send to window manager contexts.
+ */
+namespace MockScreen
+{
+
+/**
+ * @brief Creates and posts a window of process @p pid in the window group @p group.
+ */
+screen_window_t postWindow(pid_t pid, const QString &group = QString());
+
+/**
+ * @brief Closes a window created by postWindow(). The handle stays valid until reset().
+ */
+void closeWindow(screen_window_t window);
+
+/**
+ * @brief Returns the value @p index of the integer property @p property of @p window, as last set.
+ */
+int windowProperty(screen_window_t window, int property, int index = 0);
+
+/**
+ * @brief Returns how many times screen_flush_context() has been called.
+ */
+int flushCount();
+
+/**
+ * @brief Makes screen_flush_context() take @p msecs milliseconds, like a busy compositor does.
+ */
+void setFlushLatency(int msecs);
+
+/**
+ * @brief Destroys all windows and resets the counters.
+ */
+void reset();
+
+}
+
+#endif
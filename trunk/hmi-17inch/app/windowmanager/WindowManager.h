@@ -135,7 +135,8 @@ public:
 
     /**
      * @brief set sensitivity on window for specified window group
-     * Function set sensitivity on window in specified window group
+     * Function set sensitivity on window in specified window group. The value is applied once, with the next
+     * flush, a later setSensitivity(Q_PID pid, Sensitivities sensitivity) for the process takes over again.
      * @param windowGroup window group
      * @param sensitivity sensitivity value, @c Sensitivities enumeration
      * @sa setSensitivity(Q_PID pid, Sensitivities sensitivity)
@@ -144,8 +145,52 @@ public:
 
     void registerWindowForProcess(Q_PID, WId);
 
+    /**
+     * @brief Starts a transaction
+     * The requests made until commit() are held back and applied together, with a single flush on
+     * the window manager thread, so that a screen switch touching several processes shows up at once.
+     * Transactions nest, the requests are applied when the outermost one is committed. They are shared
+     * by all threads, requests from other threads made while a transaction is open are held back as well.
+     * @return id of the transaction, the same for nested ones
+     * @sa commit(), transactionFlushed()
+     */
+    quint64 begin();
+
+    /**
+     * @brief Ends the transaction started with the last begin()
+     * Returns right away, transactionFlushed() is emitted once the requests have been submitted to the compositor.
+     * @return id of the transaction
+     */
+    quint64 commit();
+
     void requestQuit();
 
+    /**
+     * @brief Latency of the requests above, from a request until the flush applying it has been submitted.
+     * Requests made before the event loop picks them up are applied with a single flush, the latency is
+     * measured from the first of them. Latencies are in nanoseconds.
+     */
+    struct FlushStatistics
+    {
+        FlushStatistics()
+            : flushes(0)
+            , requests(0)
+            , lastLatency(0)
+            , maxLatency(0)
+            , totalLatency(0)
+        {
+        }
+
+        int flushes;
+        int requests;
+        qint64 lastLatency;
+        qint64 maxLatency;
+        qint64 totalLatency;
+    };
+
+    FlushStatistics flushStatistics() const;
+    void resetFlushStatistics();
+
     enum Error {
         NoError,
         Error
@@ -161,6 +206,14 @@ Q_SIGNALS:
     void windowClosed(Q_PID pid);
     void windowGroupPosted(const QString &windowGroup, Q_PID pid);
 
+    /**
+     * @brief Emitted from the window manager thread when the requests of transaction @p id have been flushed.
+     * The flush is submitted without waiting for the composition, the requests may not be on screen yet.
+     * Transactions committed before the event loop picks them up share a flush, which is reported with the
+     * id of the last of them only: the ids emitted increase, but some may be skipped.
+     */
+    void transactionFlushed(quint64 id);
+
 private:
     class Private;
     Private* const d;
@@ -3,13 +3,23 @@
 #include "Optional.h"
 
 #include <QDebug>
+#include <QElapsedTimer>
 #include <QGuiApplication>
 #include <QScreen>
 #include <QSet>
 
+#include <unistd.h>
 #include <screen/screen.h>
 
 #include <cerrno>
+#include <cstring>
+
+#ifndef EOK
+#define EOK 0
+#endif
+
+/// How long the event loop waits at most, in case a wake-up event got lost (in nanoseconds)
+static const uint64_t EVENT_TIMEOUT = 1000000000;
 
 static inline void toArray(const QSize &size, int a[2])
 {
@@ -178,6 +188,8 @@ struct ProcessPropertyData
     WindowPropertyData defaults;
     /// Window-specific properties
     QMap<screen_window_t, WindowPropertyData> windowSpecific;
+    /// Requests for window groups, applied once with the next flush, on top of the properties above
+    QMap<screen_window_t, WindowPropertyData> windowGroupRequests;
 };
 
 
@@ -203,6 +215,9 @@ QDebug operator<<(QDebug dbg, const ProcessPropertyData &data)
     for (; it != data.windowSpecific.constEnd(); ++it) {
         dbg.nospace() << "window: " << it.key() << " " << it.value();
     }
+    for (it = data.windowGroupRequests.constBegin(); it != data.windowGroupRequests.constEnd(); ++it) {
+        dbg.nospace() << "window group request: " << it.key() << " " << it.value();
+    }
     return dbg.space();
 }
 
@@ -212,21 +227,34 @@ public:
     Private()
         : quitRequested(false)
         , windowOrderDirty(false)
+        , flushScheduled(false)
+        , pendingRequests(0)
+        , firstRequestTime(0)
+        , transactionDepth(0)
+        , lastTransaction(0)
+        , committedTransaction(0)
+        , flushedTransaction(0)
         , windowManagerContext(0)
+        , wakeEvent(0)
     {
         qRegisterMetaType<Q_PID>("Q_PID");
+        latencyTimer.start();
     }
 
     ~Private()
     {
+        if (wakeEvent)
+            screen_destroy_event(wakeEvent);
         if (windowManagerContext)
             screen_destroy_context(windowManagerContext);
     }
 
-    void processLocalRequests(screen_context_t context);
+    quint64 processLocalRequests(screen_context_t context);
     void processLocalRequestsForPid(Q_PID pid);
+    void setWindowGroupRequest(const QString &windowGroup, const Optional<int> &zvalue, const Optional<int> &sensitivity);
 
     void markDirty(Q_PID pid);
+    void wake();
 
     bool quitRequested;
     QMutex quitRequestedLock; //should be atomic, i guess
@@ -240,8 +268,26 @@ public:
     bool windowOrderDirty;
     QHash<Q_PID, QVector<Window> > windowsByProcess;
     QHash<QString, Window> windowsByWindowGroup;
+    QHash<QString, Q_PID> processByWindowGroup;
+
+    /// whether the event loop has been woken up for the requests in updateQueue
+    bool flushScheduled;
+    /// number of requests since the last flush, and when the first of them was made
+    int pendingRequests;
+    qint64 firstRequestTime;
+    QElapsedTimer latencyTimer;
+    FlushStatistics flushStatistics;
+
+    /// nesting depth of begin(), requests are held back while it is not 0
+    int transactionDepth;
+    /// id of the last transaction started, committed and flushed
+    quint64 lastTransaction;
+    quint64 committedTransaction;
+    quint64 flushedTransaction;
 
     screen_context_t windowManagerContext;
+    /// user event sent to windowManagerContext to wake up the event loop, protected by windowHandlingLock
+    screen_event_t wakeEvent;
 
     inline bool getQuitRequested()
     {
@@ -294,11 +340,25 @@ bool WindowManager::init()
 {
     screen_context_t screen_ctx;
 
-    const int rc = screen_create_context(&screen_ctx, SCREEN_WINDOW_MANAGER_CONTEXT);
+    int rc = screen_create_context(&screen_ctx, SCREEN_WINDOW_MANAGER_CONTEXT);
     if (rc != 0)
         return false;
 
     d->windowManagerContext = screen_ctx;
+
+    screen_event_t wakeEvent;
+    rc = screen_create_event(&wakeEvent);
+    if (rc != 0)
+        return false;
+
+    const int type = SCREEN_EVENT_USER;
+    rc = screen_set_event_property_iv(wakeEvent, SCREEN_PROPERTY_TYPE, &type);
+    if (rc != 0) {
+        screen_destroy_event(wakeEvent);
+        return false;
+    }
+
+    d->wakeEvent = wakeEvent;
     return true;
 }
 
@@ -324,24 +384,55 @@ static int mapTransparencyEnums(WindowManager::TransparencyMode mode)
     return SCREEN_TRANSPARENCY_NONE;
 }
 
-void WindowManager::Private::processLocalRequests(screen_context_t context)
+quint64 WindowManager::Private::processLocalRequests(screen_context_t context)
 {
     QMutexLocker locker(&windowHandlingLock);
+
+    // held back until commit() wakes the event loop
+    if (transactionDepth > 0)
+        return 0;
+
+    // requests made from now on wake up the event loop again
+    flushScheduled = false;
+
+    const quint64 transaction = (committedTransaction != flushedTransaction) ? committedTransaction : 0;
+    flushedTransaction = committedTransaction;
+
     if (updateQueue.isEmpty())
-        return;
+        return transaction;
 
     Q_FOREACH(Q_PID pid, updateQueue) {
         processLocalRequestsForPid(pid);
     }
     updateQueue.clear();
 
-    const int rc = screen_flush_context(context, SCREEN_WAIT_IDLE);
+    const int requests = pendingRequests;
+    const qint64 requestTime = firstRequestTime;
+    pendingRequests = 0;
+
+    // requests coming in during the flush are applied with the next one
+    locker.unlock();
+
+    // not waiting for the composition, the next requests would be held up by it
+    const int rc = screen_flush_context(context, 0);
     throwIfSet(rc, QStringLiteral("screen_flush_context"));
+
+    locker.relock();
+
+    const qint64 latency = latencyTimer.nsecsElapsed() - requestTime;
+    ++flushStatistics.flushes;
+    flushStatistics.requests += requests;
+    flushStatistics.lastLatency = latency;
+    flushStatistics.maxLatency = qMax(flushStatistics.maxLatency, latency);
+    flushStatistics.totalLatency += latency;
+
+    return transaction;
 }
 
 void WindowManager::Private::processLocalRequestsForPid(Q_PID pid)
 {
     const ProcessPropertyData data = windowProperties[pid];
+    windowProperties[pid].windowGroupRequests.clear();
 
     Q_FOREACH(Window window, windowsByProcess.value(pid)) {
         const QMap<screen_window_t, WindowPropertyData>::ConstIterator winDataIt = data.windowSpecific.constFind(window.window);
@@ -395,15 +486,58 @@ void WindowManager::Private::processLocalRequestsForPid(Q_PID pid)
         if (zvalue.isSet()) {
             setWindowZValue(window.window, zvalue.value());
         }
+
+        const QMap<screen_window_t, WindowPropertyData>::ConstIterator groupRequestIt = data.windowGroupRequests.constFind(window.window);
+        if (groupRequestIt != data.windowGroupRequests.constEnd()) {
+            if (groupRequestIt->sensitivity.isSet())
+                setWindowTouchSensitivity(window.window, groupRequestIt->sensitivity.value());
+            if (groupRequestIt->zvalue.isSet())
+                setWindowZValue(window.window, groupRequestIt->zvalue.value());
+        }
     }
 }
 
+void WindowManager::Private::setWindowGroupRequest(const QString &windowGroup, const Optional<int> &zvalue, const Optional<int> &sensitivity)
+{
+    if (!windowsByWindowGroup.contains(windowGroup))
+        return;
+
+    const Q_PID pid = processByWindowGroup.value(windowGroup);
+    WindowPropertyData &request = windowProperties[pid].windowGroupRequests[windowsByWindowGroup.value(windowGroup).window];
+    if (zvalue.isSet())
+        request.zvalue = zvalue;
+    if (sensitivity.isSet())
+        request.sensitivity = sensitivity;
+    markDirty(pid);
+}
+
 void WindowManager::Private::markDirty(Q_PID pid)
 {
-    if (updateQueue.contains(pid))
+    if (pendingRequests++ == 0)
+        firstRequestTime = latencyTimer.nsecsElapsed();
+
+    if (!updateQueue.contains(pid))
+        updateQueue << pid;
+
+    // commit() wakes up the event loop
+    if (transactionDepth > 0)
         return;
 
-    updateQueue << pid;
+    // one wake-up for all requests until the event loop picks them up
+    if (!flushScheduled) {
+        flushScheduled = true;
+        wake();
+    }
+}
+
+void WindowManager::Private::wake()
+{
+    if (!wakeEvent)
+        return;
+
+    const int rc = screen_send_event(windowManagerContext, wakeEvent, getpid());
+    if (rc != 0)
+        qWarning() << "screen_send_event failed, requests are delayed:" << strerror(errno);
 }
 
 static bool get_window_and_pid(screen_event_t event, screen_window_t* winHandle, int* pid)
@@ -444,9 +578,12 @@ void WindowManager::run()
 
         bool quitRequested = false;
         while (!quitRequested) {
-            d->processLocalRequests(d->windowManagerContext);
-            //Set timeout to 100ms
-            rc = screen_get_event(d->windowManagerContext, screen_ev, 100000000);
+            const quint64 transaction = d->processLocalRequests(d->windowManagerContext);
+            if (transaction != 0)
+                emit transactionFlushed(transaction);
+
+            // woken up by screen events, and by the user events markDirty() sends for queued requests
+            rc = screen_get_event(d->windowManagerContext, screen_ev, EVENT_TIMEOUT);
 
             throwIfSet(rc, QStringLiteral("Could not retrieve event"));
 
@@ -457,7 +594,7 @@ void WindowManager::run()
             //update quit flag
             quitRequested = d->getQuitRequested();
 
-            if (type == 0)
+            if (type == SCREEN_EVENT_NONE || type == SCREEN_EVENT_USER)
                 continue;
 
             switch(type) {
@@ -483,6 +620,7 @@ void WindowManager::run()
                         const Window window(winHandle, /*isGroupParent=*/true);
                         d->windowsByProcess[Q_PID(pid)].append(window);
                         d->windowsByWindowGroup[windowGroup] = window;
+                        d->processByWindowGroup[windowGroup] = pid;
                         d->windowOrderDirty = true;
                         d->markDirty(pid);
                     }
@@ -506,6 +644,7 @@ void WindowManager::run()
                     }
                     d->windowProperties.remove(pid);
                     d->windowsByWindowGroup.remove(windowGroup);
+                    d->processByWindowGroup.remove(windowGroup);
                     d->windowOrderDirty = true;
                     emit windowClosed(pid);
                 }
@@ -525,26 +664,58 @@ void WindowManager::run()
     emit quit(NoError, QString());
 }
 
+quint64 WindowManager::begin()
+{
+    QMutexLocker locker(&d->windowHandlingLock);
+    if (d->transactionDepth++ == 0)
+        ++d->lastTransaction;
+
+    return d->lastTransaction;
+}
+
+quint64 WindowManager::commit()
+{
+    QMutexLocker locker(&d->windowHandlingLock);
+    Q_ASSERT(d->transactionDepth > 0);
+    if (d->transactionDepth == 0 || --d->transactionDepth > 0)
+        return d->lastTransaction;
+
+    // also when nothing was requested, so that transactionFlushed() is emitted
+    d->committedTransaction = d->lastTransaction;
+    d->flushScheduled = true;
+    d->wake();
+
+    return d->lastTransaction;
+}
+
 void WindowManager::requestQuit()
 {
-    QMutexLocker locker(&d->quitRequestedLock);
-    d->quitRequested = true;
+    {
+        QMutexLocker locker(&d->quitRequestedLock);
+        d->quitRequested = true;
+    }
+
+    QMutexLocker locker(&d->windowHandlingLock);
+    d->wake();
+}
+
+WindowManager::FlushStatistics WindowManager::flushStatistics() const
+{
+    QMutexLocker locker(&d->windowHandlingLock);
+    return d->flushStatistics;
+}
+
+void WindowManager::resetFlushStatistics()
+{
+    QMutexLocker locker(&d->windowHandlingLock);
+    d->flushStatistics = FlushStatistics();
 }
 
 void WindowManager::setVisible(Q_PID pid, bool visible)
 {
     QMutexLocker locker(&d->windowHandlingLock);
     d->windowProperties[pid].defaults.visible = visible;
-    Q_FOREACH(const Window &window, d->windowsByProcess.value(pid)) {
-        try {
-            setWindowVisible(window.window, visible);
-        } catch (const Exception &e) {
-            qWarning() << e.message();
-        }
-    }
-    const int rc = screen_flush_context(d->windowManagerContext, SCREEN_WAIT_IDLE);
-    if (rc != 0)
-        qWarning() << "screen_flush_context returned unexpected:" << rc;
+    d->markDirty(pid);
 }
 
 void WindowManager::setZValueForWindow(Q_PID pid, WId window, int zvalue)
@@ -557,17 +728,21 @@ void WindowManager::setZValueForWindow(Q_PID pid, WId window, int zvalue)
 void WindowManager::setZValue(Q_PID pid, int zvalue)
 {
     QMutexLocker locker(&d->windowHandlingLock);
-    d->windowProperties[pid].defaults.zvalue = zvalue;
+    ProcessPropertyData &props = d->windowProperties[pid];
+    props.defaults.zvalue = zvalue;
+
+    // a window group request not flushed yet is superseded
+    QMap<screen_window_t, WindowPropertyData>::Iterator it = props.windowGroupRequests.begin();
+    for (; it != props.windowGroupRequests.end(); ++it)
+        it->zvalue.unSet();
+
     d->markDirty(pid);
 }
 
 void WindowManager::setZValue(const QString &windowGroup, int zvalue)
 {
-    if (d->windowsByWindowGroup.contains(windowGroup)) {
-        setWindowZValue(d->windowsByWindowGroup.value(windowGroup).window, zvalue);
-        const int rc = screen_flush_context(d->windowManagerContext, SCREEN_WAIT_IDLE);
-        throwIfSet(rc, QStringLiteral("screen_flush_context"));
-    }
+    QMutexLocker locker(&d->windowHandlingLock);
+    d->setWindowGroupRequest(windowGroup, zvalue, Optional<int>());
 }
 
 
@@ -652,17 +827,21 @@ void WindowManager::setY(Q_PID pid, int y)
 void WindowManager::setSensitivity(Q_PID pid, Sensitivities sensitivity)
 {
     QMutexLocker locker(&d->windowHandlingLock);
-    d->windowProperties[pid].defaults.sensitivity = sensitivity;
+    ProcessPropertyData &props = d->windowProperties[pid];
+    props.defaults.sensitivity = sensitivity;
+
+    // a window group request not flushed yet is superseded
+    QMap<screen_window_t, WindowPropertyData>::Iterator it = props.windowGroupRequests.begin();
+    for (; it != props.windowGroupRequests.end(); ++it)
+        it->sensitivity.unSet();
+
     d->markDirty(pid);
 }
 
 void WindowManager::setSensitivity(const QString &windowGroup, Sensitivities sensitivity)
 {
-    if (d->windowsByWindowGroup.contains(windowGroup)) {
-        setWindowTouchSensitivity(d->windowsByWindowGroup.value(windowGroup).window, sensitivity);
-        const int rc = screen_flush_context(d->windowManagerContext, SCREEN_WAIT_IDLE);
-        throwIfSet(rc, QStringLiteral("screen_flush_context"));
-    }
+    QMutexLocker locker(&d->windowHandlingLock);
+    d->setWindowGroupRequest(windowGroup, Optional<int>(), int(sensitivity));
 }
 
 void WindowManager::registerWindowForProcess(Q_PID pid, WId winid)
@@ -12,4 +12,7 @@ HEADERS += \
 
 qnx {
     LIBS += -lscreen
+} else {
+    SOURCES += $$PWD/MockScreen.cpp
+    HEADERS += $$PWD/MockScreen.h
 }
@@ -15,6 +15,7 @@
 #include <QQuickView>
 #include <QFontDatabase>
 #include <QDir>
+#include <QStandardPaths>
 
 #include <qqml.h>
 
@@ -62,6 +63,7 @@ int main(int argc, char **argv)
     QnxCar::Theme theme;
     QnxCarUi::ThemeManager themeManager(resolutionManager.resolution(), &theme);
     themeManager.setAssetsDirectory(assetsPath);
+    themeManager.setCacheDirectory(QStandardPaths::writableLocation(QStandardPaths::CacheLocation));
     QnxCarUi::PaletteManager paletteManager(&themeManager);
 
     QnxCar::KeyboardServer keyboardServer;
@@ -5,6 +5,9 @@
 namespace QPlayer {
 
 BaseCommand::BaseCommand()
+    : m_priority(ForegroundPriority)
+    , m_cancellationToken(0)
+    , m_cancelled(0)
 {
     connect(this, &BaseCommand::complete, this, &BaseCommand::deleteLater);
     connect(this, &BaseCommand::error, this, &BaseCommand::deleteLater);
@@ -25,4 +28,44 @@ QString BaseCommand::errorMessage() const
     return m_errorMessage;
 }
 
+BaseCommand::Priority BaseCommand::priority() const
+{
+    return m_priority;
+}
+
+void BaseCommand::setPriority(Priority priority)
+{
+    m_priority = priority;
+}
+
+quint32 BaseCommand::cancellationToken() const
+{
+    return m_cancellationToken;
+}
+
+void BaseCommand::setCancellationToken(quint32 token)
+{
+    m_cancellationToken = token;
+}
+
+bool BaseCommand::isCancelled() const
+{
+    return m_cancelled.load() != 0;
+}
+
+void BaseCommand::setCancelled()
+{
+    m_cancelled.store(1);
+}
+
+QString BaseCommand::mergeKey() const
+{
+    return QString();
+}
+
+void BaseCommand::copyResult(const BaseCommand *other)
+{
+    Q_UNUSED(other);
+}
+
 }
@@ -1,6 +1,7 @@
 #ifndef BASECOMMAND_H
 #define BASECOMMAND_H
 
+#include <QAtomicInt>
 #include <QObject>
 
 namespace QPlayer {
@@ -9,18 +10,87 @@ class BaseCommand : public QObject
 {
     Q_OBJECT
 public:
+    /**
+     * @brief The order in which commands are executed. Commands of the same priority are executed in the order
+     * they were issued.
+     */
+    enum Priority {
+        /// Playback control and state, executed separately from all other commands
+        ControlPriority,
+        /// Results the user is waiting for, e.g. the visible page of a browse
+        ForegroundPriority,
+        /// Results that will likely be needed soon, e.g. the pages around the visible one
+        PrefetchPriority,
+        /// Everything else, e.g. the metadata of browsed nodes
+        BackgroundPriority
+    };
+
     explicit BaseCommand();
     ~BaseCommand();
 
     void setErrorMessage(QString message);
     QString errorMessage() const;
 
+    /**
+     * @brief Returns the priority of the command. Defaults to @c ForegroundPriority, unless noted otherwise by
+     * the command.
+     * @return The priority.
+     */
+    Priority priority() const;
+
+    /**
+     * @brief Sets the priority of the command. Must be called before the command is passed to QPlayer.
+     * @param priority The priority.
+     */
+    void setPriority(Priority priority);
+
+    /**
+     * @brief Returns the token used to cancel the command, 0 if the command cannot be cancelled.
+     * @return The cancellation token.
+     * @sa QPlayer::cancel
+     */
+    quint32 cancellationToken() const;
+
+    /**
+     * @brief Sets the token used to cancel the command. Must be called before the command is passed to QPlayer.
+     * @param token A token returned by QPlayer::createCancellationToken, shared by all commands that are
+     * superseded together.
+     */
+    void setCancellationToken(quint32 token);
+
+    /**
+     * @brief Returns whether the command has been cancelled. Cancelled commands emit neither complete nor error
+     * and delete themselves.
+     * @return @c True if the command has been cancelled.
+     */
+    bool isCancelled() const;
+
+    /**
+     * @brief Returns a key that is equal for commands requesting the same data. Commands with the same key that are
+     * waiting or running at the same time are executed once, and all of them receive the result.
+     * @return The merge key, or an empty string if the command is never merged (the default).
+     */
+    virtual QString mergeKey() const;
+
+    /**
+     * @brief Takes over the result of a merged command of the same type and merge key.
+     * @param other The command that was executed.
+     */
+    virtual void copyResult(const BaseCommand *other);
+
 signals:
     void complete(BaseCommand *command);    // Must be overridden in derived class
     void error(BaseCommand *command);       // Must be overridden in derived class
 
 private:
+    friend class CommandScheduler;
+
+    void setCancelled();
+
     QString m_errorMessage;
+    Priority m_priority;
+    quint32 m_cancellationToken;
+    QAtomicInt m_cancelled;
 };
 
 }
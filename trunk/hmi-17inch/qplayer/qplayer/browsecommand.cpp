@@ -1,5 +1,7 @@
 #include "browsecommand.h"
 
+#include <QStringList>
+
 namespace QPlayer {
 
 BrowseCommand::BrowseCommand(int mediaSourceId, QString mediaNodeId, int limit, int offset)
@@ -32,4 +34,15 @@ int BrowseCommand::offset() const
     return m_offset;
 }
 
+QString BrowseCommand::mergeKey() const
+{
+    // none of the parts can contain a null character
+    return (QStringList() << QString::number(m_mediaSourceId) << QString::number(m_limit) << QString::number(m_offset) << m_mediaNodeId).join(QChar());
+}
+
+void BrowseCommand::copyResult(const BaseCommand *other)
+{
+    m_result = static_cast<const BrowseCommand *>(other)->m_result;
+}
+
 }
@@ -69,6 +69,16 @@ public:
      */
     int offset() const;
 
+    /**
+     * @brief Browses of the same node with the same limit and offset are merged.
+     */
+    QString mergeKey() const Q_DECL_OVERRIDE;
+
+    /**
+     * @brief Takes over the result of a merged browse.
+     */
+    void copyResult(const BaseCommand *other) Q_DECL_OVERRIDE;
+
 signals:
     /**
      * @brief The complete signal is emitted when the @c browse command completes. The result of the command
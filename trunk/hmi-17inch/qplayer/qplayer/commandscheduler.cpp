@@ -0,0 +1,339 @@
+#include "commandscheduler.h"
+#include "commandworker.h"
+
+#include <QMetaMethod>
+#include <QThread>
+
+#include <algorithm>
+#include <climits>
+
+namespace QPlayer
+{
+
+/**
+ * @brief A thread executing the jobs of one lane.
+ */
+class CommandScheduler::Lane : public QThread
+{
+public:
+    Lane(CommandScheduler *scheduler, int lane, mmplayer_hdl_t *handle)
+        : m_scheduler(scheduler)
+        , m_lane(lane)
+        , m_worker(scheduler, handle, &scheduler->m_handleMutex)
+    {
+        setObjectName(lane == ControlLane ? QLatin1String("QPlayerControlThread") : QLatin1String("QPlayerCommandThread"));
+    }
+
+protected:
+    void run() Q_DECL_OVERRIDE
+    {
+        while (Job *job = m_scheduler->takeJob(m_lane)) {
+            const bool success = m_worker.execute(job);
+            m_scheduler->finishJob(m_lane, job, success);
+        }
+    }
+
+private:
+    CommandScheduler *m_scheduler;
+    const int m_lane;
+    CommandWorker m_worker;
+};
+
+static bool runsBefore(const CommandScheduler::Job *job, const CommandScheduler::Job *other)
+{
+    if (job->priority != other->priority)
+        return job->priority < other->priority;
+
+    return job->sequence < other->sequence;
+}
+
+static bool allCommandsCancelled(const CommandScheduler::Job *job)
+{
+    if (job->commands.isEmpty())
+        return false;
+
+    Q_FOREACH (const BaseCommand *command, job->commands) {
+        if (!command->isCancelled())
+            return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Emits the complete or error signal of @p command, queued to the thread of the command. Every command
+ * redeclares these signals with its own type, clients connect to the most derived declaration.
+ */
+static void emitResult(BaseCommand *command, bool success)
+{
+    const char *name = success ? "complete" : "error";
+    const QMetaObject *metaObject = command->metaObject();
+
+    for (int i = metaObject->methodCount() - 1; i >= 0; --i) {
+        const QMetaMethod method = metaObject->method(i);
+        if (method.methodType() != QMetaMethod::Signal || method.name() != name)
+            continue;
+
+        const QByteArray type = method.parameterTypes().value(0);
+        method.invoke(command, Qt::QueuedConnection, QGenericArgument(type.constData(), &command));
+        return;
+    }
+}
+
+CommandScheduler::CommandScheduler(QObject *parent)
+    : QObject(parent)
+    , m_stopping(false)
+    , m_nextSequence(0)
+{
+    for (int lane = 0; lane < LaneCount; ++lane) {
+        m_lanes[lane] = 0;
+        m_running[lane] = 0;
+    }
+}
+
+CommandScheduler::~CommandScheduler()
+{
+    // idle lanes finish right away
+    stop(ULONG_MAX);
+}
+
+void CommandScheduler::start(mmplayer_hdl_t *handle)
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_stopping = false;
+
+    for (int lane = 0; lane < LaneCount; ++lane) {
+        if (!m_lanes[lane]) {
+            m_lanes[lane] = new Lane(this, lane, handle);
+            m_lanes[lane]->start();
+        }
+    }
+}
+
+void CommandScheduler::stop(unsigned long timeout)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_stopping = true;
+        m_jobsAvailable.wakeAll();
+    }
+
+    for (int lane = 0; lane < LaneCount; ++lane) {
+        if (!m_lanes[lane])
+            continue;
+
+        if (!m_lanes[lane]->wait(timeout)) {
+            m_lanes[lane]->terminate();
+            m_lanes[lane]->wait();
+        }
+
+        delete m_lanes[lane];
+        m_lanes[lane] = 0;
+    }
+
+    QMutexLocker locker(&m_mutex);
+
+    for (int lane = 0; lane < LaneCount; ++lane) {
+        // jobs of terminated lanes are dropped as well
+        if (m_running[lane])
+            m_pending[lane].append(m_running[lane]);
+        m_running[lane] = 0;
+
+        Q_FOREACH (Job *job, m_pending[lane]) {
+            Q_FOREACH (BaseCommand *command, job->commands)
+                command->deleteLater();
+            delete job;
+        }
+        m_pending[lane].clear();
+    }
+
+    m_mergeable.clear();
+}
+
+void CommandScheduler::submit(Operation operation, BaseCommand *command)
+{
+    QMutexLocker locker(&m_mutex);
+
+    const QString mergeKey = command->mergeKey();
+
+    if (!mergeKey.isEmpty()) {
+        Job *job = m_mergeable.value(MergeKey(operation, mergeKey));
+
+        // a running job whose commands are all cancelled is about to stop, do not wait for it
+        if (job && !allCommandsCancelled(job)) {
+            job->commands.append(command);
+
+            // a waiting job moves up to the priority of its most urgent command, within its lane
+            const int lane = laneOf(job->priority);
+            if (command->priority() < job->priority && laneOf(command->priority()) == lane
+                    && m_pending[lane].removeOne(job)) {
+                job->priority = command->priority();
+                enqueue(job);
+            }
+
+            return;
+        }
+    }
+
+    Job *job = new Job;
+    job->operation = operation;
+    job->executed = 0;
+    job->priority = command->priority();
+    job->sequence = m_nextSequence++;
+    job->mergeKey = mergeKey;
+    job->commands.append(command);
+
+    if (!mergeKey.isEmpty())
+        m_mergeable.insert(MergeKey(operation, mergeKey), job);
+
+    enqueue(job);
+}
+
+void CommandScheduler::submitControl(Operation operation, const QVariant &argument)
+{
+    QMutexLocker locker(&m_mutex);
+
+    Job *job = new Job;
+    job->operation = operation;
+    job->executed = 0;
+    job->priority = BaseCommand::ControlPriority;
+    job->sequence = m_nextSequence++;
+    job->argument = argument;
+
+    enqueue(job);
+}
+
+void CommandScheduler::cancel(quint32 token)
+{
+    if (token == 0)
+        return;
+
+    QMutexLocker locker(&m_mutex);
+
+    for (int lane = 0; lane < LaneCount; ++lane) {
+        // waiting commands are dropped right away
+        QMutableListIterator<Job *> jobIt(m_pending[lane]);
+        while (jobIt.hasNext()) {
+            Job *job = jobIt.next();
+
+            bool removed = false;
+            QMutableListIterator<BaseCommand *> commandIt(job->commands);
+            while (commandIt.hasNext()) {
+                BaseCommand *command = commandIt.next();
+                if (command->cancellationToken() == token) {
+                    command->setCancelled();
+                    command->deleteLater();
+                    commandIt.remove();
+                    removed = true;
+                }
+            }
+
+            if (removed && job->commands.isEmpty()) {
+                const MergeKey key(job->operation, job->mergeKey);
+                if (!job->mergeKey.isEmpty() && m_mergeable.value(key) == job)
+                    m_mergeable.remove(key);
+                jobIt.remove();
+                delete job;
+            }
+        }
+
+        // running ones are still in use by the lane, they are dropped when it finishes
+        if (m_running[lane]) {
+            Q_FOREACH (BaseCommand *command, m_running[lane]->commands) {
+                if (command->cancellationToken() == token)
+                    command->setCancelled();
+            }
+        }
+    }
+}
+
+quint32 CommandScheduler::createCancellationToken()
+{
+    static QBasicAtomicInt lastToken = Q_BASIC_ATOMIC_INITIALIZER(0);
+
+    quint32 token;
+    do {
+        token = quint32(lastToken.fetchAndAddRelaxed(1) + 1);
+    } while (token == 0);
+
+    return token;
+}
+
+bool CommandScheduler::isCancelled(const Job *job) const
+{
+    QMutexLocker locker(&m_mutex);
+    return allCommandsCancelled(job);
+}
+
+void CommandScheduler::enqueue(Job *job)
+{
+    QList<Job *> &pending = m_pending[laneOf(job->priority)];
+    pending.insert(std::upper_bound(pending.begin(), pending.end(), job, runsBefore), job);
+
+    m_jobsAvailable.wakeAll();
+}
+
+CommandScheduler::Job *CommandScheduler::takeJob(int lane)
+{
+    QMutexLocker locker(&m_mutex);
+
+    while (!m_stopping && m_pending[lane].isEmpty())
+        m_jobsAvailable.wait(&m_mutex);
+
+    if (m_stopping)
+        return 0;
+
+    Job *job = m_pending[lane].takeFirst();
+    m_running[lane] = job;
+
+    // commands may be merged into the job while it runs, the lane must not read the list without the lock
+    job->executed = job->commands.value(0);
+
+    return job;
+}
+
+void CommandScheduler::finishJob(int lane, Job *job, bool success)
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_running[lane] = 0;
+
+    if (!job->mergeKey.isEmpty()) {
+        const MergeKey key(job->operation, job->mergeKey);
+        if (m_mergeable.value(key) == job)
+            m_mergeable.remove(key);
+    }
+
+    deliver(job, success);
+    delete job;
+}
+
+void CommandScheduler::deliver(Job *job, bool success)
+{
+    BaseCommand *executed = job->executed;
+
+    // The executed command goes last: once its result has been delivered, it deletes itself on its own thread
+    for (int i = job->commands.count() - 1; i >= 0; --i) {
+        BaseCommand *command = job->commands.at(i);
+
+        if (command->isCancelled()) {
+            command->deleteLater();
+            continue;
+        }
+
+        if (command != executed) {
+            command->copyResult(executed);
+            command->setErrorMessage(executed->errorMessage());
+        }
+
+        emitResult(command, success);
+    }
+}
+
+int CommandScheduler::laneOf(BaseCommand::Priority priority)
+{
+    return priority == BaseCommand::ControlPriority ? ControlLane : LibraryLane;
+}
+
+}
@@ -0,0 +1,166 @@
+#ifndef COMMANDSCHEDULER_H
+#define COMMANDSCHEDULER_H
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QPair>
+#include <QVariant>
+#include <QWaitCondition>
+
+#include "basecommand.h"
+#include "mmplayer/types.h"
+
+namespace QPlayer
+{
+
+/**
+ * @brief The CommandScheduler queues QPlayer commands and executes them on the mm-player client library.
+ *
+ * Commands are executed on two lanes, each with a thread of its own: commands with @c ControlPriority (playback
+ * control and state) on one, all other commands (browsing, searching, metadata, track sessions) on the other. A slow
+ * browse of a large source therefore never holds up play, pause or seek. Within a lane, commands are executed by
+ * priority, then in the order they were issued.
+ *
+ * Commands with the same merge key that are waiting or running at the same time are executed once, and all of them
+ * receive the result. Commands can be cancelled by their cancellation token: waiting commands are dropped, and a
+ * running browse or search stops after the chunk in progress once all commands merged into it are cancelled.
+ * Cancelled commands emit neither complete nor error.
+ */
+class CommandScheduler : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief The mm-player operations, one per QPlayer method.
+     */
+    enum Operation {
+        GetMediaSources,
+        GetPlayerState,
+        GetCurrentTrack,
+        GetCurrentTrackPosition,
+        Browse,
+        GetMetadata,
+        GetExtendedMetadata,
+        Search,
+        CreateTrackSession,
+        GetTrackSessionItems,
+        GetCurrentTrackSessionInfo,
+        Play,
+        Pause,
+        Stop,
+        Next,
+        Previous,
+        Seek,
+        Jump,
+        SetPlaybackRate,
+        SetShuffleMode,
+        SetRepeatMode
+    };
+
+    /**
+     * @brief An operation waiting for or being executed, together with the commands that requested it.
+     */
+    struct Job
+    {
+        Operation operation;
+        BaseCommand::Priority priority;
+        quint64 sequence;
+        /// The argument of control operations without a command, e.g. the seek position
+        QVariant argument;
+        QString mergeKey;
+        /// The commands merged into this job. Empty for control operations.
+        QList<BaseCommand *> commands;
+        /// The command the lane executes, set by takeJob(); the others receive a copy of its result
+        BaseCommand *executed;
+    };
+
+    explicit CommandScheduler(QObject *parent = 0);
+    ~CommandScheduler();
+
+    /**
+     * @brief Starts executing commands on the mm-player client library. Commands submitted before are kept
+     * until then.
+     * @param handle The mm-player client handle.
+     */
+    void start(mmplayer_hdl_t *handle);
+
+    /**
+     * @brief Stops executing commands and drops the waiting ones. Lanes that do not finish their current command
+     * within @p timeout milliseconds are terminated.
+     */
+    void stop(unsigned long timeout);
+
+    /**
+     * @brief Queues a command, or merges it into a waiting or running command with the same merge key.
+     * @param operation The operation to execute for the command.
+     * @param command The command, which receives the result.
+     */
+    void submit(Operation operation, BaseCommand *command);
+
+    /**
+     * @brief Queues a playback control operation, which has no command.
+     * @param operation The operation.
+     * @param argument The argument of the operation, if any.
+     */
+    void submitControl(Operation operation, const QVariant &argument = QVariant());
+
+    /**
+     * @brief Cancels all waiting and running commands with the cancellation token @p token.
+     */
+    void cancel(quint32 token);
+
+    /**
+     * @brief Returns a new cancellation token.
+     */
+    static quint32 createCancellationToken();
+
+    /**
+     * @brief Returns whether all commands of @p job have been cancelled since it started. Used by long running
+     * operations to stop early.
+     */
+    bool isCancelled(const Job *job) const;
+
+private:
+    class Lane;
+    friend class Lane;
+
+    enum {
+        ControlLane,
+        LibraryLane,
+        LaneCount
+    };
+
+    typedef QPair<int, QString> MergeKey;
+
+    void enqueue(Job *job);
+    Job *takeJob(int lane);
+    void finishJob(int lane, Job *job, bool success);
+    void deliver(Job *job, bool success);
+
+    static int laneOf(BaseCommand::Priority priority);
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_jobsAvailable;
+
+    /// Serializes the calls of the lanes on the mm-player client handle
+    QMutex m_handleMutex;
+    bool m_stopping;
+    quint64 m_nextSequence;
+
+    Lane *m_lanes[LaneCount];
+
+    /// Waiting jobs per lane, sorted by priority and sequence
+    QList<Job *> m_pending[LaneCount];
+
+    /// The job each lane is executing, if any
+    Job *m_running[LaneCount];
+
+    /// Waiting and running jobs with a merge key
+    QHash<MergeKey, Job *> m_mergeable;
+};
+
+}
+
+#endif // COMMANDSCHEDULER_H
@@ -4,25 +4,111 @@
 #include "mmplayer/types.h"
 
 #include <QDebug>
+#include <QMutexLocker>
 #include <iostream>
 
 namespace QPlayer
 {
 
-CommandWorker::CommandWorker(QPlayer *qq, mmplayer_hdl_t *handle)
-    : q(qq)
+CommandWorker::CommandWorker(CommandScheduler *scheduler, mmplayer_hdl_t *handle, QMutex *handleMutex)
+    : m_scheduler(scheduler)
     , m_mmPlayerHandle(handle)
+    , m_mmPlayerCommandMutex(handleMutex)
+    , m_job(0)
 {
 }
 
-void CommandWorker::getMediaSources(MediaSourcesCommand *command)
+bool CommandWorker::execute(CommandScheduler::Job *job)
+{
+    BaseCommand *command = job->executed;
+    bool success = true;
+
+    m_job = job;
+
+    switch (job->operation) {
+    case CommandScheduler::GetMediaSources:
+        success = getMediaSources(static_cast<MediaSourcesCommand *>(command));
+        break;
+    case CommandScheduler::GetPlayerState:
+        success = getPlayerState(static_cast<PlayerStateCommand *>(command));
+        break;
+    case CommandScheduler::GetCurrentTrack:
+        success = getCurrentTrack(static_cast<CurrentTrackCommand *>(command));
+        break;
+    case CommandScheduler::GetCurrentTrackPosition:
+        success = getCurrentTrackPosition(static_cast<CurrentTrackPositionCommand *>(command));
+        break;
+    case CommandScheduler::Browse:
+        success = browse(static_cast<BrowseCommand *>(command));
+        break;
+    case CommandScheduler::GetMetadata:
+        success = getMetadata(static_cast<MetadataCommand *>(command));
+        break;
+    case CommandScheduler::GetExtendedMetadata:
+        success = getExtendedMetadata(static_cast<ExtendedMetadataCommand *>(command));
+        break;
+    case CommandScheduler::Search:
+        success = search(static_cast<SearchCommand *>(command));
+        break;
+    case CommandScheduler::CreateTrackSession:
+        success = createTrackSession(static_cast<CreateTrackSessionCommand *>(command));
+        break;
+    case CommandScheduler::GetTrackSessionItems:
+        success = getTrackSessionItems(static_cast<TrackSessionItemsCommand *>(command));
+        break;
+    case CommandScheduler::GetCurrentTrackSessionInfo:
+        success = getCurrentTrackSessionInfo(static_cast<TrackSessionInfoCommand *>(command));
+        break;
+    case CommandScheduler::Play:
+        play();
+        break;
+    case CommandScheduler::Pause:
+        pause();
+        break;
+    case CommandScheduler::Stop:
+        stop();
+        break;
+    case CommandScheduler::Next:
+        next();
+        break;
+    case CommandScheduler::Previous:
+        previous();
+        break;
+    case CommandScheduler::Seek:
+        seek(job->argument.toInt());
+        break;
+    case CommandScheduler::Jump:
+        jump(job->argument.toInt());
+        break;
+    case CommandScheduler::SetPlaybackRate:
+        setPlaybackRate(job->argument.toFloat());
+        break;
+    case CommandScheduler::SetShuffleMode:
+        setShuffleMode(PlayerState::ShuffleMode(job->argument.toInt()));
+        break;
+    case CommandScheduler::SetRepeatMode:
+        setRepeatMode(PlayerState::RepeatMode(job->argument.toInt()));
+        break;
+    }
+
+    m_job = 0;
+
+    return success;
+}
+
+bool CommandWorker::isCancelled() const
+{
+    return m_job && m_scheduler->isCancelled(m_job);
+}
+
+bool CommandWorker::getMediaSources(MediaSourcesCommand *command)
 {
     int rc;
     int sourcesLength;
     mmp_ms_t *mmp_mediaSources = NULL;
     QList<MediaSource> mediaSources;
 
-    QMutexLocker locker(&m_mmPlayerCommandMutex);
+    QMutexLocker locker(m_mmPlayerCommandMutex);
     rc = mm_player_get_media_sources(m_mmPlayerHandle, &mmp_mediaSources, &sourcesLength);
     if (rc == NO_ERROR) {
         for (int i = 0; i < sourcesLength; i++) {
@@ -30,94 +116,85 @@ void CommandWorker::getMediaSources(MediaSourcesCommand *command)
         }
 
         command->setResult(mediaSources);
-        QMetaObject::invokeMethod(command, "complete", Qt::QueuedConnection,
-                                  Q_ARG(MediaSourcesCommand*, command));
 
         freeMediaSources(mmp_mediaSources, sourcesLength);
     } else {
         qDebug() << Q_FUNC_INFO << "Error getting media sources";
         command->setErrorMessage(tr("Error getting media sources"));
-        QMetaObject::invokeMethod(command, "error", Qt::QueuedConnection,
-                                  Q_ARG(MediaSourcesCommand*, command));
     }
+
+    return rc == NO_ERROR;
 }
 
-void CommandWorker::getPlayerState(PlayerStateCommand *command)
+bool CommandWorker::getPlayerState(PlayerStateCommand *command)
 {
     int rc;
     mmp_state_t *playerState = NULL;
 
-    QMutexLocker locker(&m_mmPlayerCommandMutex);
+    QMutexLocker locker(m_mmPlayerCommandMutex);
     rc = mm_player_get_current_state(m_mmPlayerHandle, &playerState);
 
     if (rc == NO_ERROR) {
         command->setResult(TypeConverter::convertPlayerState(*playerState));
-        QMetaObject::invokeMethod(command, "complete", Qt::QueuedConnection,
-                                  Q_ARG(PlayerStateCommand*, command));
 
         free(playerState);
     } else {
         qDebug() << Q_FUNC_INFO << "Error getting player state";
         command->setErrorMessage(tr("Error getting player state"));
-        QMetaObject::invokeMethod(command, "error", Qt::QueuedConnection,
-                                  Q_ARG(PlayerStateCommand*, command));
     }
+
+    return rc == NO_ERROR;
 }
 
-void CommandWorker::getCurrentTrack(CurrentTrackCommand *command)
+bool CommandWorker::getCurrentTrack(CurrentTrackCommand *command)
 {
     int rc;
     mmp_track_info_t *trackInfo = NULL;
 
-    QMutexLocker locker(&m_mmPlayerCommandMutex);
+    QMutexLocker locker(m_mmPlayerCommandMutex);
     rc = mm_player_get_current_track_info(m_mmPlayerHandle, &trackInfo);
 
     if (rc == NO_ERROR) {
         command->setResult(TypeConverter::convertTrack(*(trackInfo)));
-        QMetaObject::invokeMethod(command, "complete", Qt::QueuedConnection,
-                                  Q_ARG(CurrentTrackCommand*, command));
 
         freeTrackInfo(trackInfo);
     } else {
         qDebug() << Q_FUNC_INFO << "Error getting current track";
         command->setErrorMessage(tr("Error getting current track"));
-        QMetaObject::invokeMethod(command, "error", Qt::QueuedConnection,
-                                  Q_ARG(CurrentTrackCommand*, command));
     }
+
+    return rc == NO_ERROR;
 }
 
-void CommandWorker::getCurrentTrackPosition(CurrentTrackPositionCommand *command)
+bool CommandWorker::getCurrentTrackPosition(CurrentTrackPositionCommand *command)
 {
     int rc;
     int position;
 
-    QMutexLocker locker(&m_mmPlayerCommandMutex);
+    QMutexLocker locker(m_mmPlayerCommandMutex);
     rc = mm_player_get_current_track_position(m_mmPlayerHandle, &position);
     if (rc == NO_ERROR) {
         command->setResult(position);
-        QMetaObject::invokeMethod(command, "complete", Qt::QueuedConnection,
-                                  Q_ARG(CurrentTrackPositionCommand*, command));
     } else {
         qDebug() << Q_FUNC_INFO << "Error getting current track position";
         command->setErrorMessage(tr("Error getting current track position"));
-        QMetaObject::invokeMethod(command, "error", Qt::QueuedConnection,
-                                  Q_ARG(CurrentTrackPositionCommand*, command));
     }
+
+    return rc == NO_ERROR;
 }
 
-void CommandWorker::getMetadata(MetadataCommand *command)
+bool CommandWorker::getMetadata(MetadataCommand *command)
 {
     int rc;
     mmp_ms_node_metadata_t *metadata = NULL;
     QByteArray ba = command->mediaNodeId().toLatin1();
     const char* nodeIdStr = ba.data();
     //qDebug() << "getMetadata" << nodeIdStr;
+    QMutexLocker locker(m_mmPlayerCommandMutex);
     rc = mm_player_get_metadata(m_mmPlayerHandle, command->mediaSourceId(), nodeIdStr, &metadata);
 
     if (rc == NO_ERROR) {
         command->setResult(metadata != NULL ? TypeConverter::convertMetadata(*metadata) : Metadata());
-        QMetaObject::invokeMethod(command, "complete", Qt::QueuedConnection,
-                                  Q_ARG(MetadataCommand*, command));
 
         freeMetadata(metadata);
     } else {
@@ -127,12 +204,13 @@ void CommandWorker::getMetadata(MetadataCommand *command)
 //        qDebug() << "ba1" << tr(command->mediaNodeId().toUtf8().data());
 //        qDebug() << "ba2" << command->mediaNodeId();
         command->setErrorMessage(tr("Error getting metadata"));
-        QMetaObject::invokeMethod(command, "complete", Qt::QueuedConnection,
-                                  Q_ARG(MetadataCommand*, command));
     }
+
+    // errors are reported through complete as well, with the error message set
+    return true;
 }
 
-void CommandWorker::getExtendedMetadata(ExtendedMetadataCommand *command)
+bool CommandWorker::getExtendedMetadata(ExtendedMetadataCommand *command)
 {
     int rc;
     QByteArray ba = command->mediaNodeId().toLocal8Bit();
@@ -151,6 +229,7 @@ void CommandWorker::getExtendedMetadata(ExtendedMetadataCommand *command)
     }
 
     // Get the extended metadata
+    QMutexLocker locker(m_mmPlayerCommandMutex);
     rc = mm_player_get_extended_metadata(m_mmPlayerHandle, command->mediaSourceId(), nodeIdStr, keys, values);
 
     if (rc == NO_ERROR) {
@@ -163,15 +242,11 @@ void CommandWorker::getExtendedMetadata(ExtendedMetadataCommand *command)
             extendedMetadata.insert(command->properties().at(i), values[i] != NULL ? QVariant(QString::fromLocal8Bit(values[i])) : QVariant());
         }
 
-        // Set the result and emit the complete signal
+        // Set the result
         command->setResult(extendedMetadata);
-        QMetaObject::invokeMethod(command, "complete", Qt::QueuedConnection,
-                                  Q_ARG(ExtendedMetadataCommand*, command));
     } else {
 //        qDebug() << Q_FUNC_INFO << "Error getting extended metadata";
         command->setErrorMessage(tr("Error getting extended metadata"));
-        QMetaObject::invokeMethod(command, "error", Qt::QueuedConnection,
-                                  Q_ARG(ExtendedMetadataCommand*, command));
     }
 
     // Clean up
@@ -181,9 +256,11 @@ void CommandWorker::getExtendedMetadata(ExtendedMetadataCommand *command)
     }
     delete[] keys;
     delete[] values;
+
+    return rc == NO_ERROR;
 }
 
-void CommandWorker::browse(BrowseCommand *command)
+bool CommandWorker::browse(BrowseCommand *command)
 {
     int rc = 0;
     mmp_ms_node_t *nodeChunk = NULL;
@@ -196,16 +273,21 @@ void CommandWorker::browse(BrowseCommand *command)
     QList<MediaNode> result;
 
     while(!done && !error) {
+        // Stop between chunks once nobody is waiting for the result anymore
+        if (isCancelled())
+            return false;
+
         if (numRequested == -1) {
             nodesThisChunk = -1;
         } else {
             nodesThisChunk = numRequested - totalNodes;
         }
 
-        m_mmPlayerCommandMutex.lock();
         //qDebug() << "commandwork.cpp " << command->mediaSourceId() << nodeIdStr << command->offset() + totalNodes ;
+        // one chunk at a time, so that the control lane gets the handle in between
+        m_mmPlayerCommandMutex->lock();
         rc = mm_player_browse(m_mmPlayerHandle, command->mediaSourceId(), nodeIdStr, command->offset() + totalNodes, &nodesThisChunk, &nodeChunk);
-        m_mmPlayerCommandMutex.unlock();
+        m_mmPlayerCommandMutex->unlock();
         if(rc == NO_ERROR) {
             if (nodesThisChunk == 0) {
                 // EOF -- there are no more nodes -- totalNodes is a subset of numRequested
@@ -242,19 +324,16 @@ void CommandWorker::browse(BrowseCommand *command)
     }
 
     if(!error) {
-        // Emit the command complete signal
         command->setResult(result);
-        QMetaObject::invokeMethod(command, "complete", Qt::QueuedConnection,
-                                  Q_ARG(BrowseCommand*, command));
     } else {
         qDebug() << Q_FUNC_INFO << "Error performing browse";
         command->setErrorMessage(tr("Error performing browse"));
-        QMetaObject::invokeMethod(command, "error", Qt::QueuedConnection,
-                                  Q_ARG(BrowseCommand*, command));
     }
+
+    return !error;
 }
 
-void CommandWorker::search(SearchCommand *command)
+bool CommandWorker::search(SearchCommand *command)
 {
     int rc = 0;
     mmp_ms_node_t *nodeChunk = NULL;
@@ -270,6 +349,10 @@ void CommandWorker::search(SearchCommand *command)
 
     //aggregation
     while (!done && !error) {
+        // Stop between chunks once nobody is waiting for the result anymore
+        if (isCancelled())
+            return false;
+
         if (numRequested == -1) {
             nodesThisChunk = -1;
         }
@@ -277,9 +360,10 @@ void CommandWorker::search(SearchCommand *command)
             nodesThisChunk = numRequested - totalNodes;
         }
 
-        m_mmPlayerCommandMutex.lock();
+        // one chunk at a time, so that the control lane gets the handle in between
+        m_mmPlayerCommandMutex->lock();
         rc = mm_player_search(m_mmPlayerHandle, command->mediaSourceId(), filterStr, searchStr, command->offset() + totalNodes, &nodesThisChunk, &nodeChunk);
-        m_mmPlayerCommandMutex.unlock();
+        m_mmPlayerCommandMutex->unlock();
 
         if(rc == NO_ERROR) {
             if (nodesThisChunk == 0) {
@@ -317,19 +401,16 @@ void CommandWorker::search(SearchCommand *command)
     }
 
     if(!error) {
-        // Emit the command complete signal
         command->setResult(result);
-        QMetaObject::invokeMethod(command, "complete", Qt::QueuedConnection,
-                                  Q_ARG(SearchCommand*, command));
     } else {
         qDebug() << Q_FUNC_INFO << "Error performing search";
         command->setErrorMessage(tr("Error performing search"));
-        QMetaObject::invokeMethod(command, "error", Qt::QueuedConnection,
-                                  Q_ARG(SearchCommand*, command));
     }
+
+    return !error;
 }
 
-void CommandWorker::createTrackSession(CreateTrackSessionCommand *command)
+bool CommandWorker::createTrackSession(CreateTrackSessionCommand *command)
 {
     int rc;
     uint64_t tsid = 0;
@@ -337,8 +418,8 @@ void CommandWorker::createTrackSession(CreateTrackSessionCommand *command)
     QByteArray ba = command->mediaNodeId().toLocal8Bit();
     const char* nodeId = ba.data();
 
-    QMutexLocker locker(&m_mmPlayerCommandMutex);
     qDebug() << "mm_player_create_trksession front!";
+    QMutexLocker locker(m_mmPlayerCommandMutex);
     rc = mm_player_create_trksession(m_mmPlayerHandle, command->mediaSourceId(), nodeId, &length, command->index(), &tsid);
     qDebug() << "mm_player_create_trksession rear!";
     if (rc == NO_ERROR) {
@@ -347,26 +428,23 @@ void CommandWorker::createTrackSession(CreateTrackSessionCommand *command)
         ts.id = tsid;
         ts.length = length;
 
-        // Emit the complete signal
         command->setResult(ts);
-        QMetaObject::invokeMethod(command, "complete", Qt::QueuedConnection,
-                                  Q_ARG(CreateTrackSessionCommand*, command));
     } else {
         qDebug() << Q_FUNC_INFO << "Error creating track session";
         command->setErrorMessage(tr("Error creating track session"));
-        QMetaObject::invokeMethod(command, "error", Qt::QueuedConnection,
-                                  Q_ARG(CreateTrackSessionCommand*, command));
     }
+
+    return rc == NO_ERROR;
 }
 
-void CommandWorker::getTrackSessionItems(TrackSessionItemsCommand *command)
+bool CommandWorker::getTrackSessionItems(TrackSessionItemsCommand *command)
 {
     int rc;
     int limit = command->limit();
     mmp_ms_node_t *nodes = NULL;
     QList<MediaNode> result;
 
-    QMutexLocker locker(&m_mmPlayerCommandMutex);
+    QMutexLocker locker(m_mmPlayerCommandMutex);
     rc = mm_player_get_trksession_tracks(m_mmPlayerHandle, command->trackSessionId(), command->offset(), &limit, &nodes);
     if (rc == NO_ERROR) {
         for (int i=0; i<limit; i++) {
@@ -375,65 +453,65 @@ void CommandWorker::getTrackSessionItems(TrackSessionItemsCommand *command)
 
         command->setResult(result);
 
-        QMetaObject::invokeMethod(command, "complete", Qt::QueuedConnection,
-                                  Q_ARG(TrackSessionItemsCommand*, command));
-
         // Free memory
         freeMediaNodes(nodes, limit);
     } else {
         qDebug() << Q_FUNC_INFO << "Error getting track session items";
         command->setErrorMessage(tr("Error getting track session items"));
-        QMetaObject::invokeMethod(command, "error", Qt::QueuedConnection,
-                                  Q_ARG(TrackSessionItemsCommand*, command));
     }
+
+    return rc == NO_ERROR;
 }
 
-void CommandWorker::getCurrentTrackSessionInfo(TrackSessionInfoCommand *command)
+bool CommandWorker::getCurrentTrackSessionInfo(TrackSessionInfoCommand *command)
 {
     int rc;
     mmp_trksession_info_t *trackSessionInfo = NULL;
 
-    QMutexLocker locker(&m_mmPlayerCommandMutex);
+    QMutexLocker locker(m_mmPlayerCommandMutex);
     rc = mm_player_get_current_trksession_info(m_mmPlayerHandle, &trackSessionInfo);
     if (rc == NO_ERROR) {
         command->setResult(TypeConverter::convertTrackSessionInfo(*trackSessionInfo));
-
-        QMetaObject::invokeMethod(command, "complete", Qt::QueuedConnection,
-                                  Q_ARG(TrackSessionInfoCommand*, command));
     } else {
         command->setErrorMessage(tr("Error getting current track session info"));
-        QMetaObject::invokeMethod(command, "error", Qt::QueuedConnection,
-                                  Q_ARG(TrackSessionInfoCommand*, command));
     }
+
+    return rc == NO_ERROR;
 }
 
 void CommandWorker::play()
 {
+    QMutexLocker locker(m_mmPlayerCommandMutex);
     mm_player_play(m_mmPlayerHandle);
 }
 
 void CommandWorker::pause()
 {
+    QMutexLocker locker(m_mmPlayerCommandMutex);
     mm_player_pause(m_mmPlayerHandle);
 }
 
 void CommandWorker::stop()
 {
+    QMutexLocker locker(m_mmPlayerCommandMutex);
     mm_player_stop(m_mmPlayerHandle);
 }
 
 void CommandWorker::next()
 {
+    QMutexLocker locker(m_mmPlayerCommandMutex);
     mm_player_next(m_mmPlayerHandle);
 }
 
 void CommandWorker::previous()
 {
+    QMutexLocker locker(m_mmPlayerCommandMutex);
     mm_player_previous(m_mmPlayerHandle);
 }
 
 void CommandWorker::seek(const int position)
 {
+    QMutexLocker locker(m_mmPlayerCommandMutex);
     mm_player_seek(m_mmPlayerHandle, position);
 }
 
@@ -441,7 +519,7 @@ void CommandWorker::jump(const int index)
 {
     int rc;
 
-    QMutexLocker locker(&m_mmPlayerCommandMutex);
+    QMutexLocker locker(m_mmPlayerCommandMutex);
     rc = mm_player_jump(m_mmPlayerHandle, index);
     if (rc == ERROR) {
         qWarning() << "QPlayer, Error -- could not jump to index";
@@ -452,7 +530,7 @@ void CommandWorker::setPlaybackRate(const float rate)
 {
     int rc;
 
-    QMutexLocker locker(&m_mmPlayerCommandMutex);
+    QMutexLocker locker(m_mmPlayerCommandMutex);
     rc = mm_player_set_playback_rate(m_mmPlayerHandle, rate);
     if (rc == ERROR) {
         qWarning() << "QPlayer, Error -- could not set playback rate";
@@ -463,7 +541,7 @@ void CommandWorker::setShuffleMode(const PlayerState::ShuffleMode mode)
 {
     int rc;
 
-    QMutexLocker locker(&m_mmPlayerCommandMutex);
+    QMutexLocker locker(m_mmPlayerCommandMutex);
     rc = mm_player_shuffle(m_mmPlayerHandle, (shuffle_e)mode);
     if (rc == ERROR) {
         qWarning() << "QPlayer, Error -- could not set shuffle mode";
@@ -474,7 +552,7 @@ void CommandWorker::setRepeatMode(const PlayerState::RepeatMode mode)
 {
     int rc;
 
-    QMutexLocker locker(&m_mmPlayerCommandMutex);
+    QMutexLocker locker(m_mmPlayerCommandMutex);
     rc = mm_player_repeat(m_mmPlayerHandle, (repeat_e)mode);
     if (rc == ERROR) {
         qWarning() << "QPlayer, Error -- could not set repeat mode";
@@ -1,18 +1,19 @@
 #ifndef COMMANDWORKER_H
 #define COMMANDWORKER_H
 
-#include <QObject>
 #include <QMutex>
+#include <QObject>
 
 #include "qplayer.h"
+#include "commandscheduler.h"
 #include "mmplayer/types.h"
 
 namespace QPlayer
 {
 
 /**
- * @brief The CommandWorker executes commands on the mm-player client library and returns results
- * asynchronously via signals which are intended to be relayed through the QPlayer API.
+ * @brief The CommandWorker executes commands on the mm-player client library. Each lane of the CommandScheduler
+ * has a worker of its own; the results are stored in the commands and delivered by the scheduler.
  */
 class CommandWorker : public QObject
 {
@@ -20,40 +21,49 @@ class CommandWorker : public QObject
 public:
     /**
      * @brief CommandWorker constructor.
+     * @param scheduler The scheduler the executed jobs come from.
      * @param handle The mm-player client handle.
+     * @param handleMutex Serializes the calls on @p handle, shared by the workers of all lanes.
      */
-    explicit CommandWorker(QPlayer *qq, mmplayer_hdl_t *handle);
+    explicit CommandWorker(CommandScheduler *scheduler, mmplayer_hdl_t *handle, QMutex *handleMutex);
 
-public slots:
+    /**
+     * @brief Executes the operation of a job on the calling thread, for its executed command.
+     * @param job The job.
+     * @return @c True on success, @c false if the operation failed or was cancelled.
+     */
+    bool execute(CommandScheduler::Job *job);
+
+private:
     /**
      * @brief Gets a list of all connected media sources.
      * @param command A pointer to a MediaSourcesCommand instance.
      */
-    void getMediaSources(MediaSourcesCommand *command);
+    bool getMediaSources(MediaSourcesCommand *command);
 
     /**
      * @brief Gets the current player state.
      * @return A pointer to a PlayerStateCommand instance.
      */
-    void getPlayerState(PlayerStateCommand *command);
+    bool getPlayerState(PlayerStateCommand *command);
 
     /**
      * @brief Gets the current track.
      * @param command A pointer to a CurrentTrackCommand instance.
      */
-    void getCurrentTrack(CurrentTrackCommand *command);
+    bool getCurrentTrack(CurrentTrackCommand *command);
 
     /**
      * @brief Gets the current playback position of the current track.
      * @param command A poitner to a CurrentTrackPositionCommadn instance.
      */
-    void getCurrentTrackPosition(CurrentTrackPositionCommand *command);
+    bool getCurrentTrackPosition(CurrentTrackPositionCommand *command);
 
     /**
      * @brief Browses a media source for media.
      * @param command A pointer to a BrowseCommand instance.
      */
-    void browse(BrowseCommand *command);
+    bool browse(BrowseCommand *command);
 
     /**
      * @brief Gets metadata for the specified node.
@@ -61,37 +71,37 @@ public slots:
      * @param mediaSourceId The node's media source ID.
      * @param mediaNodeId The node ID.
      */
-    void getMetadata(MetadataCommand *command);
+    bool getMetadata(MetadataCommand *command);
 
     /**
      * @brief Gets extended metadata for the specified node.
      * @param command A pointer to an ExtendedMetadataCommand instance.
      */
-    void getExtendedMetadata(ExtendedMetadataCommand *command);
+    bool getExtendedMetadata(ExtendedMetadataCommand *command);
 
     /**
      * @brief Searches a media source for media.
      * @param command A pointer to a SearchCommand instance.
      */
-    void search(SearchCommand *command);
+    bool search(SearchCommand *command);
 
     /**
      * @brief Creates a track session.
      * @param command A pointer to a CreateTrackSessionCommand instance.
      */
-    void createTrackSession(CreateTrackSessionCommand *command);
+    bool createTrackSession(CreateTrackSessionCommand *command);
 
     /**
      * @brief Gets tracks from the current track session.
      * @param command A pointer to a TrackSessionItemsCommand instance.
      */
-    void getTrackSessionItems(TrackSessionItemsCommand *command);
+    bool getTrackSessionItems(TrackSessionItemsCommand *command);
 
     /**
      * @brief Gets the current track session information.
      * @param command A pointer to a TrackSessionInfoCommand instance.
      */
-    void getCurrentTrackSessionInfo(TrackSessionInfoCommand *command);
+    bool getCurrentTrackSessionInfo(TrackSessionInfoCommand *command);
 
     /**
      * @brief Begins or resumes playback.
@@ -149,13 +159,15 @@ public slots:
      */
     void setRepeatMode(const PlayerState::RepeatMode mode);
 
-signals:
-    void error(QString err);
+    /**
+     * @brief Returns whether all commands of the job being executed have been cancelled.
+     */
+    bool isCancelled() const;
 
-private:
-    QPlayer *q;
+    CommandScheduler *m_scheduler;
     mmplayer_hdl_t *m_mmPlayerHandle;
-    QMutex m_mmPlayerCommandMutex;
+    QMutex *m_mmPlayerCommandMutex;
+    CommandScheduler::Job *m_job;
 
     /**
      * @brief Utility function to free node memory allocated by mm-player.
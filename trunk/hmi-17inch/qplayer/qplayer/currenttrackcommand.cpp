@@ -6,6 +6,8 @@ CurrentTrackCommand::CurrentTrackCommand()
 {
     connect(this, &CurrentTrackCommand::complete, this, &CurrentTrackCommand::deleteLater);
     connect(this, &CurrentTrackCommand::error, this, &CurrentTrackCommand::deleteLater);
+
+    setPriority(ControlPriority);
 }
 
 }
@@ -13,6 +13,8 @@ namespace QPlayer {
  * The @c complete signal is emitted when the command is complete and the result is available.
  *
  * Instances of this class will delete themselves once all error and complete signal handlers have been invoked.
+ *
+ * Current track commands are executed with @c ControlPriority by default.
  */
 class CurrentTrackCommand : public BaseCommand
 {
@@ -6,6 +6,8 @@ CurrentTrackPositionCommand::CurrentTrackPositionCommand()
 {
     connect(this, &CurrentTrackPositionCommand::complete, this, &CurrentTrackPositionCommand::deleteLater);
     connect(this, &CurrentTrackPositionCommand::error, this, &CurrentTrackPositionCommand::deleteLater);
+
+    setPriority(ControlPriority);
 }
 
 }
@@ -9,6 +9,8 @@ ExtendedMetadataCommand::ExtendedMetadataCommand(int mediaSourceId, QString medi
 {
     connect(this, &ExtendedMetadataCommand::complete, this, &ExtendedMetadataCommand::deleteLater);
     connect(this, &ExtendedMetadataCommand::error, this, &ExtendedMetadataCommand::deleteLater);
+
+    setPriority(BackgroundPriority);
 }
 
 int ExtendedMetadataCommand::mediaSourceId() const
@@ -26,4 +28,15 @@ QStringList ExtendedMetadataCommand::properties() const
     return m_properties;
 }
 
+QString ExtendedMetadataCommand::mergeKey() const
+{
+    // none of the parts can contain a null character
+    return (QStringList() << QString::number(m_mediaSourceId) << m_mediaNodeId << m_properties).join(QChar());
+}
+
+void ExtendedMetadataCommand::copyResult(const BaseCommand *other)
+{
+    m_result = static_cast<const ExtendedMetadataCommand *>(other)->m_result;
+}
+
 }
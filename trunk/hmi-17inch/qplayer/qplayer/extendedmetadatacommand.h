@@ -17,6 +17,8 @@ namespace QPlayer {
  * complete signal is emitted when the command is complete and the result is available.
  *
  * Instances of this class will delete themselves once all error and complete signal handlers have been invoked.
+ *
+ * Extended metadata commands are executed with @c BackgroundPriority by default.
  */
 class ExtendedMetadataCommand : public BaseCommand
 {
@@ -68,6 +70,16 @@ public:
      */
     QStringList properties() const;
 
+    /**
+     * @brief Extended metadata requests for the same node and properties are merged.
+     */
+    QString mergeKey() const Q_DECL_OVERRIDE;
+
+    /**
+     * @brief Takes over the result of a merged extended metadata request.
+     */
+    void copyResult(const BaseCommand *other) Q_DECL_OVERRIDE;
+
 signals:
     /**
      * @brief The complete signal is emitted when the @c getExtendedMetadata command completes. The result of the command
@@ -1,6 +1,7 @@
 #include "metadatacommand.h"
 
 #include <QDebug>
+#include <QStringList>
 
 namespace QPlayer {
 
@@ -10,6 +11,8 @@ MetadataCommand::MetadataCommand(int mediaSourceId, QString mediaNodeId)
 {
     connect(this, &MetadataCommand::complete, this, &MetadataCommand::deleteLater);
     connect(this, &MetadataCommand::error, this, &MetadataCommand::deleteLater);
+
+    setPriority(BackgroundPriority);
 }
 
 MetadataCommand::~MetadataCommand()
@@ -27,4 +30,15 @@ QString MetadataCommand::mediaNodeId() const
     return m_mediaNodeId;
 }
 
+QString MetadataCommand::mergeKey() const
+{
+    // none of the parts can contain a null character
+    return (QStringList() << QString::number(m_mediaSourceId) << m_mediaNodeId).join(QChar());
+}
+
+void MetadataCommand::copyResult(const BaseCommand *other)
+{
+    m_result = static_cast<const MetadataCommand *>(other)->m_result;
+}
+
 }
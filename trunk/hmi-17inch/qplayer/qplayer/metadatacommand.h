@@ -13,6 +13,8 @@ namespace QPlayer {
  * The @c complete signal is emitted when the command is complete and the result is available.
  *
  * Instances of this class will delete themselves once all error and complete signal handlers have been invoked.
+ *
+ * Metadata commands are executed with @c BackgroundPriority by default.
  */
 class MetadataCommand : public BaseCommand
 {
@@ -56,6 +58,16 @@ public:
      */
     QString mediaNodeId() const;
 
+    /**
+     * @brief Metadata requests for the same node are merged.
+     */
+    QString mergeKey() const Q_DECL_OVERRIDE;
+
+    /**
+     * @brief Takes over the result of a merged metadata request.
+     */
+    void copyResult(const BaseCommand *other) Q_DECL_OVERRIDE;
+
 signals:
     /**
      * @brief The complete signal is emitted when the @c getMetadata command completes. The result of the command
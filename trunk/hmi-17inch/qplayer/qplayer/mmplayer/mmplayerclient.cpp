@@ -1,6 +1,71 @@
 
 #include <mmplayer/mmplayerclient.h>
 
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/*
+ * Stand-in for the mm-player client library, for running QPlayer off-target.
+ *
+ * Every media node browsed or searched has MMPLAYER_STUB_NODES audio children (default 1000), returned at most
+ * MMPLAYER_STUB_CHUNK (default 50) per call. Browse, search and metadata calls take MMPLAYER_STUB_LATENCY
+ * milliseconds (default 0), to benchmark QPlayer against a slow media source such as a large DLNA server.
+ */
+
+static int stub_setting(const char *name, int default_value)
+{
+    const char *value = getenv(name);
+    return value ? atoi(value) : default_value;
+}
+
+static void stub_wait(void)
+{
+    const int latency = stub_setting("MMPLAYER_STUB_LATENCY", 0);
+    if (latency > 0)
+        usleep(latency * 1000);
+}
+
+static int stub_nodes(const int media_source_id, const char *parent_id, const int offset, int *limit,
+        mmp_ms_node_t **media_nodes)
+{
+    const int total = stub_setting("MMPLAYER_STUB_NODES", 1000);
+    const int chunk = stub_setting("MMPLAYER_STUB_CHUNK", 50);
+    int count = total - offset;
+    int i;
+    char buffer[256];
+
+    stub_wait();
+
+    if (*limit >= 0 && *limit < count)
+        count = *limit;
+    if (count > chunk)
+        count = chunk;
+    if (count < 0)
+        count = 0;
+
+    *limit = count;
+    *media_nodes = NULL;
+    if (count == 0)
+        return 0;
+
+    *media_nodes = (mmp_ms_node_t *)calloc(count, sizeof(mmp_ms_node_t));
+    for (i = 0; i < count; i++) {
+        mmp_ms_node_t *node = &(*media_nodes)[i];
+
+        snprintf(buffer, sizeof(buffer), "%s/%d", parent_id, offset + i);
+        node->id = strdup(buffer);
+        snprintf(buffer, sizeof(buffer), "Track %d", offset + i);
+        node->name = strdup(buffer);
+        node->type = MS_NTYPE_AUDIO;
+        node->count = -1;
+        node->ms_id = media_source_id;
+    }
+
+    return 0;
+}
+
 
 /**
  * @brief Connect to mm-player and obtain a handle.
@@ -144,6 +209,7 @@ int mm_player_get_current_track_info(mmplayer_hdl_t *hdl, mmp_track_info_t **tra
  */
 int mm_player_get_current_track_position(mmplayer_hdl_t *hdl, int *position)
 {
+    *position = 0;
     return 0;
 }
 
@@ -163,7 +229,7 @@ int mm_player_browse(mmplayer_hdl_t *hdl, const int media_source_id,
 		const char * media_node_id, const int offset, int *limit,
         mmp_ms_node_t **media_nodes)
 {
-    return 0;
+    return stub_nodes(media_source_id, media_node_id, offset, limit, media_nodes);
 }
 
 /**
@@ -180,6 +246,12 @@ int mm_player_browse(mmplayer_hdl_t *hdl, const int media_source_id,
 int mm_player_get_metadata(mmplayer_hdl_t *hdl, const int media_source_id,
         const char *media_node_id, mmp_ms_node_metadata_t **metadata)
 {
+    stub_wait();
+
+    *metadata = (mmp_ms_node_metadata_t *)calloc(1, sizeof(mmp_ms_node_metadata_t));
+    (*metadata)->title = strdup(media_node_id);
+    (*metadata)->disc = -1;
+    (*metadata)->track = -1;
     return 0;
 }
 
@@ -218,7 +290,7 @@ int mm_player_search(mmplayer_hdl_t *hdl, const int media_source_id,
 		const char* filter, const char * search_term,
         const int offset, int *limit, mmp_ms_node_t **media_nodes)
 {
-    return 0;
+    return stub_nodes(media_source_id, search_term, offset, limit, media_nodes);
 }
 
 /**
@@ -6,6 +6,8 @@ PlayerStateCommand::PlayerStateCommand()
 {
     connect(this, &PlayerStateCommand::complete, this, &PlayerStateCommand::deleteLater);
     connect(this, &PlayerStateCommand::error, this, &PlayerStateCommand::deleteLater);
+
+    setPriority(ControlPriority);
 }
 
 }
@@ -25,9 +25,10 @@ QPlayer::Private::Private(const QString playerName, QPlayer *qq)
     , m_playerOpen(false)
     , m_playerName(playerName)
     , m_playerHandle(0)
+    , m_commandScheduler(new CommandScheduler(this))
 {
-    m_bootMgrDirWatcher = new QPps::DirWatcher(QStringLiteral("/pps/services/bootmgr/modules_ready"), this);
-    connect(m_bootMgrDirWatcher, &QPps::DirWatcher::objectAdded, this, &Private::bootMgrObjAdded);
+    m_bootMgrWaiter = new QPps::ServiceWaiter(QStringLiteral("/pps/services/bootmgr/modules_ready/MediaPlayer_mmplayer"), this);
+    connect(m_bootMgrWaiter, &QPps::ServiceWaiter::ready, this, &Private::bootMgrModuleReady);
 
     qRegisterMetaType<uint64_t>("uint64_t");
     qRegisterMetaType<MediaSourceEventType>("MediaSourceEventType");
@@ -65,18 +66,13 @@ QPlayer::Private::~Private()
     }
 }
 
-void QPlayer::Private::bootMgrObjAdded(const QString &object)
+void QPlayer::Private::bootMgrModuleReady()
 {
-    if (object == QStringLiteral("MediaPlayer_mmplayer")){
-        // Open the specified player name
-        if(open(m_playerName) != NO_ERROR) {
-            qCritical("%s: Unable to open player name '%s'", Q_FUNC_INFO, qPrintable(m_playerName));
-        } else {
-            emit q->playerReady();
-        }
-
-        // Destroy the dir watcher since it's no longer needed
-        m_bootMgrDirWatcher->deleteLater();
+    // Open the specified player name
+    if(open(m_playerName) != NO_ERROR) {
+        qCritical("%s: Unable to open player name '%s'", Q_FUNC_INFO, qPrintable(m_playerName));
+    } else {
+        emit q->playerReady();
     }
 }
 
@@ -177,18 +173,8 @@ int QPlayer::Private::startEventThread(mmplayer_hdl_t *handle)
 
 int QPlayer::Private::startCommandThread(mmplayer_hdl_t *handle)
 {
-    // Create command worker
-    m_commandThread = new QThread;
-    m_commandThread->setObjectName(QLatin1String("QPlayerCommandThread"));
-    m_commandWorker = new CommandWorker(q, handle);
-    m_commandWorker->moveToThread(m_commandThread);
-
-    // Connect terminate signals
-    connect(m_commandThread, SIGNAL(finished()), m_commandWorker, SLOT(deleteLater()));
-    connect(m_commandThread, SIGNAL(finished()), m_commandThread, SLOT(deleteLater()));
-
-    // Start
-    m_commandThread->start();
+    // Commands issued before the player was opened are executed now
+    m_commandScheduler->start(handle);
 
     return NO_ERROR;
 }
@@ -206,10 +192,8 @@ int QPlayer::Private::stopEventThread()
 
 int QPlayer::Private::stopCommandThread()
 {
-    m_commandThread->quit();
-    if(!m_commandThread->wait(THREAD_WAIT_MS)) {
-        m_commandThread->terminate();
-    }
+    m_commandScheduler->stop(THREAD_WAIT_MS);
+
     return NO_ERROR;
 }
 
@@ -231,44 +215,47 @@ QPlayer::~QPlayer()
 
 void QPlayer::getMediaSources(MediaSourcesCommand *command)
 {
-    QMetaObject::invokeMethod(d->m_commandWorker, "getMediaSources", Qt::QueuedConnection,
-                              Q_ARG(MediaSourcesCommand*, command));
+    d->m_commandScheduler->submit(CommandScheduler::GetMediaSources, command);
 }
 
 void QPlayer::getPlayerState(PlayerStateCommand *command)
 {
-    QMetaObject::invokeMethod(d->m_commandWorker, "getPlayerState", Qt::QueuedConnection,
-                              Q_ARG(PlayerStateCommand*, command));
+    d->m_commandScheduler->submit(CommandScheduler::GetPlayerState, command);
 }
 
 void QPlayer::getCurrentTrack(CurrentTrackCommand *command)
 {
-    QMetaObject::invokeMethod(d->m_commandWorker, "getCurrentTrack", Qt::QueuedConnection,
-                              Q_ARG(CurrentTrackCommand*, command));
+    d->m_commandScheduler->submit(CommandScheduler::GetCurrentTrack, command);
 }
 
 void QPlayer::getCurrentTrackPosition(CurrentTrackPositionCommand *command)
 {
-    QMetaObject::invokeMethod(d->m_commandWorker, "getCurrentTrackPosition", Qt::QueuedConnection,
-                              Q_ARG(CurrentTrackPositionCommand*, command));
+    d->m_commandScheduler->submit(CommandScheduler::GetCurrentTrackPosition, command);
 }
 
 void QPlayer::browse(BrowseCommand *command)
 {
-    QMetaObject::invokeMethod(d->m_commandWorker, "browse", Qt::QueuedConnection,
-                              Q_ARG(BrowseCommand*, command));
+    d->m_commandScheduler->submit(CommandScheduler::Browse, command);
 }
 
 void QPlayer::search(SearchCommand *command)
 {
-    QMetaObject::invokeMethod(d->m_commandWorker, "search", Qt::QueuedConnection,
-                              Q_ARG(SearchCommand*, command));
+    d->m_commandScheduler->submit(CommandScheduler::Search, command);
 }
 
 void QPlayer::createTrackSession(CreateTrackSessionCommand *command)
 {
-    QMetaObject::invokeMethod(d->m_commandWorker, "createTrackSession", Qt::QueuedConnection,
-                              Q_ARG(CreateTrackSessionCommand*, command));
+    d->m_commandScheduler->submit(CommandScheduler::CreateTrackSession, command);
+}
+
+quint32 QPlayer::createCancellationToken()
+{
+    return CommandScheduler::createCancellationToken();
+}
+
+void QPlayer::cancel(quint32 token)
+{
+    d->m_commandScheduler->cancel(token);
 }
 
 int QPlayer::destroyTrackSession(uint64_t tsid)
@@ -286,81 +273,72 @@ int QPlayer::destroyTrackSession(uint64_t tsid)
 
 void QPlayer::getCurrentTrackSessionInfo(TrackSessionInfoCommand *command)
 {
-    QMetaObject::invokeMethod(d->m_commandWorker, "getCurrentTrackSessionInfo", Qt::QueuedConnection,
-                              Q_ARG(TrackSessionInfoCommand*, command));
+    d->m_commandScheduler->submit(CommandScheduler::GetCurrentTrackSessionInfo, command);
 }
 
 void QPlayer::getTrackSessionItems(TrackSessionItemsCommand *command)
 {
-    QMetaObject::invokeMethod(d->m_commandWorker, "getTrackSessionItems", Qt::QueuedConnection,
-                              Q_ARG(TrackSessionItemsCommand*, command));
+    d->m_commandScheduler->submit(CommandScheduler::GetTrackSessionItems, command);
 }
 
 void QPlayer::getMetadata(MetadataCommand *command)
 {
-    QMetaObject::invokeMethod(d->m_commandWorker, "getMetadata", Qt::QueuedConnection,
-                              Q_ARG(MetadataCommand*, command));
+    d->m_commandScheduler->submit(CommandScheduler::GetMetadata, command);
 }
 
 void QPlayer::getExtendedMetadata(ExtendedMetadataCommand *command)
 {
-    QMetaObject::invokeMethod(d->m_commandWorker, "getExtendedMetadata", Qt::QueuedConnection,
-                              Q_ARG(ExtendedMetadataCommand*, command));
+    d->m_commandScheduler->submit(CommandScheduler::GetExtendedMetadata, command);
 }
 
 void QPlayer::play()
 {
-    QMetaObject::invokeMethod(d->m_commandWorker, "play", Qt::QueuedConnection);
+    d->m_commandScheduler->submitControl(CommandScheduler::Play);
 }
 
 void QPlayer::pause()
 {
-    QMetaObject::invokeMethod(d->m_commandWorker, "pause", Qt::QueuedConnection);
+    d->m_commandScheduler->submitControl(CommandScheduler::Pause);
 }
 
 void QPlayer::stop()
 {
-    QMetaObject::invokeMethod(d->m_commandWorker, "stop", Qt::QueuedConnection);
+    d->m_commandScheduler->submitControl(CommandScheduler::Stop);
 }
 
 void QPlayer::next()
 {
-    QMetaObject::invokeMethod(d->m_commandWorker, "next", Qt::QueuedConnection);
+    d->m_commandScheduler->submitControl(CommandScheduler::Next);
 }
 
 void QPlayer::previous()
 {
-    QMetaObject::invokeMethod(d->m_commandWorker, "previous", Qt::QueuedConnection);
+    d->m_commandScheduler->submitControl(CommandScheduler::Previous);
 }
 
 void QPlayer::seek(const int position)
 {
-    QMetaObject::invokeMethod(d->m_commandWorker, "seek", Qt::QueuedConnection,
-                              Q_ARG(const int, position));
+    d->m_commandScheduler->submitControl(CommandScheduler::Seek, position);
 }
 
 void QPlayer::jump(const int index)
 {
-    QMetaObject::invokeMethod(d->m_commandWorker, "jump", Qt::QueuedConnection,
-                              Q_ARG(const int, index));
+    d->m_commandScheduler->submitControl(CommandScheduler::Jump, index);
 }
 
 void QPlayer::setPlaybackRate(const float rate)
 {
-    QMetaObject::invokeMethod(d->m_commandWorker, "setPlaybackRate", Qt::QueuedConnection,
-                              Q_ARG(const float, rate));
+    d->m_commandScheduler->submitControl(CommandScheduler::SetPlaybackRate, rate);
 }
 
 void QPlayer::setShuffleMode(const PlayerState::ShuffleMode mode)
 {
-    QMetaObject::invokeMethod(d->m_commandWorker, "setShuffleMode", Qt::QueuedConnection,
-                              Q_ARG(const PlayerState::ShuffleMode, mode));
+    d->m_commandScheduler->submitControl(CommandScheduler::SetShuffleMode, int(mode));
 }
 
 void QPlayer::setRepeatMode(const PlayerState::RepeatMode mode)
 {
-    QMetaObject::invokeMethod(d->m_commandWorker, "setRepeatMode", Qt::QueuedConnection,
-                              Q_ARG(const PlayerState::RepeatMode, mode));
+    d->m_commandScheduler->submitControl(CommandScheduler::SetRepeatMode, int(mode));
 }
 
 }
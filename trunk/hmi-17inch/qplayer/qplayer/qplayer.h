@@ -118,6 +118,21 @@ public:
      */
     void getCurrentTrackSessionInfo(TrackSessionInfoCommand *command);
 
+    /**
+     * @brief Returns a new token for cancelling commands. Commands that are superseded together, e.g. the page loads
+     * of a browse, should share a token.
+     * @return The cancellation token.
+     * @sa BaseCommand::setCancellationToken
+     */
+    static quint32 createCancellationToken();
+
+    /**
+     * @brief Cancels all waiting and running commands with the specified cancellation token. Cancelled commands
+     * emit neither complete nor error, and delete themselves.
+     * @param token The cancellation token.
+     */
+    void cancel(quint32 token);
+
 public Q_SLOTS:
     /**
      * @brief Begins or resumes playback.
@@ -24,6 +24,7 @@ SOURCES += \
 	eventworker.cpp \
 	typeconverter.cpp \
 	commandworker.cpp \
+	commandscheduler.cpp \
 	basecommand.cpp \
 	createtracksessioncommand.cpp \
 	metadatacommand.cpp \
@@ -45,6 +46,7 @@ HEADERS += \
 	eventworker.h \
 	typeconverter.h \
 	commandworker.h \
+	commandscheduler.h \
 	metadatacommand.h \
 	basecommand.h \
 	createtracksessioncommand.h \
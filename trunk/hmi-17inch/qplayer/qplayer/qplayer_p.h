@@ -3,7 +3,7 @@
 
 #include "qplayer.h"
 #include "eventworker.h"
-#include "commandworker.h"
+#include "commandscheduler.h"
 
 #include <mmplayer/mmplayerclient.h>
 #include <mmplayer/types.h>
@@ -11,7 +11,7 @@
 #include <QMutex>
 #include <QTime>
 #include <QThread>
-#include "qpps/dirwatcher.h"
+#include "qpps/servicewaiter.h"
 
 namespace QPlayer {
 
@@ -56,7 +56,7 @@ public:
     int startEventThread(mmplayer_hdl_t *handle);
 
     /**
-     * @brief Starts the command thread, responsible for executing QPlayer commands.
+     * @brief Starts the command scheduler threads, responsible for executing QPlayer commands.
      * @param handle The mm-player handle acquired upon initialization.
      * @return
      */
@@ -69,7 +69,7 @@ public:
     int stopEventThread();
 
     /**
-     * @brief Stops the command thread.
+     * @brief Stops the command scheduler threads.
      * @return
      */
     int stopCommandThread();
@@ -83,12 +83,12 @@ public:
 
     EventWorker *m_eventWorker;
     QThread *m_eventThread;
-    CommandWorker *m_commandWorker;
-    QThread *m_commandThread;
-    QPps::DirWatcher *m_bootMgrDirWatcher;
+    CommandScheduler *m_commandScheduler;
+    QPps::ServiceWaiter *m_bootMgrWaiter;
 
 public Q_SLOTS:
-    void bootMgrObjAdded(const QString &object);
+    /// Opens the player once the boot manager reports mm-player as ready
+    void bootMgrModuleReady();
 
 };
 
@@ -1,5 +1,7 @@
 #include "searchcommand.h"
 
+#include <QStringList>
+
 namespace QPlayer {
 
 SearchCommand::SearchCommand(int mediaSourceId, QString searchTerm, QString filter, int limit, int offset)
@@ -38,4 +40,15 @@ int SearchCommand::offset() const
     return m_offset;
 }
 
+QString SearchCommand::mergeKey() const
+{
+    // none of the parts can contain a null character
+    return (QStringList() << QString::number(m_mediaSourceId) << QString::number(m_limit) << QString::number(m_offset) << m_filter << m_searchTerm).join(QChar());
+}
+
+void SearchCommand::copyResult(const BaseCommand *other)
+{
+    m_result = static_cast<const SearchCommand *>(other)->m_result;
+}
+
 }
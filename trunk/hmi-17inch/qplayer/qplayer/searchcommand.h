@@ -76,6 +76,16 @@ public:
      */
     int offset() const;
 
+    /**
+     * @brief Searches of the same media source, filter, term, limit and offset are merged.
+     */
+    QString mergeKey() const Q_DECL_OVERRIDE;
+
+    /**
+     * @brief Takes over the result of a merged search.
+     */
+    void copyResult(const BaseCommand *other) Q_DECL_OVERRIDE;
+
 signals:
     /**
      * @brief The complete signal is emitted when the @c search command completes. The result of the command
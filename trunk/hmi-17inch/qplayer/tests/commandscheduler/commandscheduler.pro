@@ -0,0 +1,56 @@
+include(../../common.pri)
+
+TEMPLATE = app
+
+QT += testlib
+
+# on QNX, do not run as part of make check/test
+!qnx:CONFIG += testcase
+
+TARGET = test_commandscheduler
+
+# The scheduler is internal to the library, so it is built into the test together with the stand-in for the
+# mm-player client library (qplayer/mmplayer/mmplayerclient.cpp)
+QPLAYER_SOURCE = $$PWD/../../qplayer
+INCLUDEPATH += $$QPLAYER_SOURCE
+DEPENDPATH += $$QPLAYER_SOURCE
+
+DEFINES += QPLAYER_STATIC_LIB QT_NO_CAST_FROM_ASCII
+
+HEADERS += \
+	test_commandscheduler_p.h \
+	$$QPLAYER_SOURCE/commandscheduler.h \
+	$$QPLAYER_SOURCE/commandworker.h \
+	$$QPLAYER_SOURCE/basecommand.h \
+	$$QPLAYER_SOURCE/browsecommand.h \
+	$$QPLAYER_SOURCE/createtracksessioncommand.h \
+	$$QPLAYER_SOURCE/currenttrackcommand.h \
+	$$QPLAYER_SOURCE/currenttrackpositioncommand.h \
+	$$QPLAYER_SOURCE/extendedmetadatacommand.h \
+	$$QPLAYER_SOURCE/mediasourcescommand.h \
+	$$QPLAYER_SOURCE/metadatacommand.h \
+	$$QPLAYER_SOURCE/playerstatecommand.h \
+	$$QPLAYER_SOURCE/searchcommand.h \
+	$$QPLAYER_SOURCE/tracksessioninfocommand.h \
+	$$QPLAYER_SOURCE/tracksessionitemscommand.h
+
+SOURCES += \
+	test_commandscheduler.cpp \
+	$$QPLAYER_SOURCE/commandscheduler.cpp \
+	$$QPLAYER_SOURCE/commandworker.cpp \
+	$$QPLAYER_SOURCE/typeconverter.cpp \
+	$$QPLAYER_SOURCE/basecommand.cpp \
+	$$QPLAYER_SOURCE/browsecommand.cpp \
+	$$QPLAYER_SOURCE/createtracksessioncommand.cpp \
+	$$QPLAYER_SOURCE/currenttrackcommand.cpp \
+	$$QPLAYER_SOURCE/currenttrackpositioncommand.cpp \
+	$$QPLAYER_SOURCE/extendedmetadatacommand.cpp \
+	$$QPLAYER_SOURCE/mediasourcescommand.cpp \
+	$$QPLAYER_SOURCE/metadatacommand.cpp \
+	$$QPLAYER_SOURCE/playerstatecommand.cpp \
+	$$QPLAYER_SOURCE/searchcommand.cpp \
+	$$QPLAYER_SOURCE/tracksessioninfocommand.cpp \
+	$$QPLAYER_SOURCE/tracksessionitemscommand.cpp \
+	$$QPLAYER_SOURCE/mmplayer/mmplayerclient.cpp
+
+QMAKE_CXXFLAGS += -Wno-unused-parameter
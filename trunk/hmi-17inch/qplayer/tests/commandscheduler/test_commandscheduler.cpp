@@ -0,0 +1,205 @@
+#include "test_commandscheduler_p.h"
+
+#include <QElapsedTimer>
+#include <QPointer>
+
+#include <climits>
+
+using namespace QPlayer;
+
+void CommandSchedulerTest::initTestCase()
+{
+    // done by QPlayer for its clients
+    qRegisterMetaType<BrowseCommand*>("BrowseCommand*");
+    qRegisterMetaType<CurrentTrackPositionCommand*>("CurrentTrackPositionCommand*");
+    qRegisterMetaType<SearchCommand*>("SearchCommand*");
+}
+
+void CommandSchedulerTest::init()
+{
+    // see mmplayer/mmplayerclient.cpp
+    qputenv("MMPLAYER_STUB_NODES", "1000");
+    qputenv("MMPLAYER_STUB_CHUNK", "50");
+    qputenv("MMPLAYER_STUB_LATENCY", "0");
+}
+
+void CommandSchedulerTest::testPriority()
+{
+    CommandScheduler scheduler;
+    ResultReceiver receiver;
+
+    // submitted before the lanes start, so that all of them are waiting
+    receiver.browse(&scheduler, QStringLiteral("/a"), 0, 20, BaseCommand::BackgroundPriority);
+    receiver.browse(&scheduler, QStringLiteral("/a"), 20, 20, BaseCommand::PrefetchPriority);
+    receiver.browse(&scheduler, QStringLiteral("/a"), 40, 20, BaseCommand::ForegroundPriority);
+    receiver.browse(&scheduler, QStringLiteral("/a"), 60, 20, BaseCommand::PrefetchPriority);
+
+    scheduler.start(0);
+
+    QTRY_COMPARE(receiver.completed.count(), 4);
+    QCOMPARE(receiver.completed, QStringList() << QStringLiteral("/a@40") << QStringLiteral("/a@20")
+                                               << QStringLiteral("/a@60") << QStringLiteral("/a@0"));
+    QCOMPARE(receiver.resultSizes, QList<int>() << 20 << 20 << 20 << 20);
+    QCOMPARE(receiver.errors, 0);
+}
+
+void CommandSchedulerTest::testMerge()
+{
+    qputenv("MMPLAYER_STUB_LATENCY", "100");
+
+    CommandScheduler scheduler;
+    ResultReceiver receiver;
+
+    for (int i = 0; i < 5; ++i)
+        receiver.browse(&scheduler, QStringLiteral("/a"), 0);
+
+    QElapsedTimer timer;
+    timer.start();
+    scheduler.start(0);
+
+    // executed once: five browses would take 500ms
+    QTRY_COMPARE(receiver.completed.count(), 5);
+    QVERIFY(timer.elapsed() < 300);
+    QCOMPARE(receiver.resultSizes, QList<int>() << 20 << 20 << 20 << 20 << 20);
+
+    // a waiting job moves up to the priority of a more urgent command merged into it
+    scheduler.stop(ULONG_MAX);
+    receiver.completed.clear();
+    qputenv("MMPLAYER_STUB_LATENCY", "0");
+
+    receiver.browse(&scheduler, QStringLiteral("/a"), 0, 20, BaseCommand::PrefetchPriority);
+    receiver.browse(&scheduler, QStringLiteral("/b"), 0, 20, BaseCommand::BackgroundPriority);
+    receiver.browse(&scheduler, QStringLiteral("/b"), 0, 20, BaseCommand::ForegroundPriority);
+
+    scheduler.start(0);
+
+    QTRY_COMPARE(receiver.completed.count(), 3);
+    QCOMPARE(receiver.completed, QStringList() << QStringLiteral("/b@0") << QStringLiteral("/b@0")
+                                               << QStringLiteral("/a@0"));
+}
+
+void CommandSchedulerTest::testCancelWaiting()
+{
+    CommandScheduler scheduler;
+    ResultReceiver receiver;
+
+    const quint32 token = CommandScheduler::createCancellationToken();
+    QVERIFY(token != 0);
+    QVERIFY(CommandScheduler::createCancellationToken() != token);
+
+    QPointer<BrowseCommand> cancelled = receiver.browse(&scheduler, QStringLiteral("/a"), 0, 20,
+                                                        BaseCommand::ForegroundPriority, token);
+    QPointer<BrowseCommand> merged = receiver.browse(&scheduler, QStringLiteral("/b"), 0, 20,
+                                                     BaseCommand::ForegroundPriority, token);
+    receiver.browse(&scheduler, QStringLiteral("/b"), 0);
+    receiver.browse(&scheduler, QStringLiteral("/c"), 0);
+
+    scheduler.cancel(token);
+    scheduler.start(0);
+
+    // the uncancelled command merged with a cancelled one still gets its result
+    QTRY_COMPARE(receiver.completed.count(), 2);
+    QCOMPARE(receiver.completed, QStringList() << QStringLiteral("/b@0") << QStringLiteral("/c@0"));
+
+    // cancelled commands are deleted without a result
+    QTRY_VERIFY(cancelled.isNull());
+    QTRY_VERIFY(merged.isNull());
+    QTest::qWait(50);
+    QCOMPARE(receiver.completed.count(), 2);
+    QCOMPARE(receiver.errors, 0);
+}
+
+void CommandSchedulerTest::testCancelRunning()
+{
+    // 21 chunks of 10ms
+    qputenv("MMPLAYER_STUB_LATENCY", "10");
+
+    CommandScheduler scheduler;
+    ResultReceiver receiver;
+    scheduler.start(0);
+
+    const quint32 token = CommandScheduler::createCancellationToken();
+    QPointer<BrowseCommand> running = receiver.browse(&scheduler, QStringLiteral("/a"), 0, -1,
+                                                      BaseCommand::ForegroundPriority, token);
+
+    QTest::qWait(50);
+    QVERIFY(!running.isNull());
+
+    QElapsedTimer timer;
+    timer.start();
+    scheduler.cancel(token);
+    receiver.browse(&scheduler, QStringLiteral("/b"), 0);
+
+    // the running browse stops after its current chunk
+    QTRY_COMPARE(receiver.completed, QStringList() << QStringLiteral("/b@0"));
+    QVERIFY(timer.elapsed() < 100);
+    QTRY_VERIFY(running.isNull());
+    QCOMPARE(receiver.errors, 0);
+}
+
+void CommandSchedulerTest::testCancelRunningSearch()
+{
+    // 21 chunks of 10ms
+    qputenv("MMPLAYER_STUB_LATENCY", "10");
+
+    CommandScheduler scheduler;
+    ResultReceiver receiver;
+    scheduler.start(0);
+
+    // superseded by a longer search term while it is running
+    const quint32 token = CommandScheduler::createCancellationToken();
+    QPointer<SearchCommand> running = receiver.search(&scheduler, QStringLiteral("Tr"), -1, token);
+
+    QTest::qWait(50);
+    QVERIFY(!running.isNull());
+
+    QElapsedTimer timer;
+    timer.start();
+    scheduler.cancel(token);
+    receiver.search(&scheduler, QStringLiteral("Track"), 20);
+
+    // the running search stops after its current chunk
+    QTRY_COMPARE(receiver.completed, QStringList() << QStringLiteral("search:Track"));
+    QVERIFY(timer.elapsed() < 100);
+    QCOMPARE(receiver.resultSizes, QList<int>() << 20);
+    QTRY_VERIFY(running.isNull());
+    QCOMPARE(receiver.errors, 0);
+}
+
+void CommandSchedulerTest::benchmarkTransportLatency_data()
+{
+    QTest::addColumn<int>("priority");
+
+    QTest::newRow("control lane") << int(BaseCommand::ControlPriority);
+    // where a single command queue leaves it
+    QTest::newRow("behind browsing") << int(BaseCommand::BackgroundPriority);
+}
+
+/**
+ * Measures how long a playback state request takes while a slow media source is being browsed, a page at a time.
+ */
+void CommandSchedulerTest::benchmarkTransportLatency()
+{
+    QFETCH(int, priority);
+
+    qputenv("MMPLAYER_STUB_LATENCY", "20");
+
+    CommandScheduler scheduler;
+    ResultReceiver receiver;
+    scheduler.start(0);
+
+    for (int page = 0; page < 10; ++page)
+        receiver.browse(&scheduler, QStringLiteral("/a"), page * 20, 20, BaseCommand::PrefetchPriority);
+
+    QBENCHMARK_ONCE {
+        CurrentTrackPositionCommand *command = new CurrentTrackPositionCommand;
+        command->setPriority(BaseCommand::Priority(priority));
+        connect(command, &CurrentTrackPositionCommand::complete, &receiver, &ResultReceiver::positionReceived);
+        scheduler.submit(CommandScheduler::GetCurrentTrackPosition, command);
+
+        while (!receiver.completed.contains(QStringLiteral("position")))
+            QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents);
+    }
+}
+
+QTEST_MAIN(CommandSchedulerTest)
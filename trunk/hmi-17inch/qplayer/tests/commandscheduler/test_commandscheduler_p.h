@@ -0,0 +1,103 @@
+#ifndef TEST_COMMANDSCHEDULER_P_H
+#define TEST_COMMANDSCHEDULER_P_H
+
+#include <QTest>
+
+#include "commandscheduler.h"
+#include "browsecommand.h"
+#include "currenttrackpositioncommand.h"
+#include "searchcommand.h"
+
+#include <QStringList>
+
+/// Records the results the scheduler delivers, in the order they arrive
+class ResultReceiver : public QObject
+{
+    Q_OBJECT
+
+public:
+    ResultReceiver()
+        : errors(0)
+    {}
+
+    /// Submits a browse of @p limit nodes at @p offset below @p nodeId, recorded as "<nodeId>@<offset>"
+    QPlayer::BrowseCommand *browse(QPlayer::CommandScheduler *scheduler, const QString &nodeId, int offset,
+                                   int limit = 20,
+                                   QPlayer::BaseCommand::Priority priority = QPlayer::BaseCommand::ForegroundPriority,
+                                   quint32 token = 0)
+    {
+        QPlayer::BrowseCommand *command = new QPlayer::BrowseCommand(1, nodeId, limit, offset);
+        command->setPriority(priority);
+        command->setCancellationToken(token);
+        connect(command, &QPlayer::BrowseCommand::complete, this, &ResultReceiver::browsed);
+        connect(command, &QPlayer::BrowseCommand::error, this, &ResultReceiver::failed);
+        scheduler->submit(QPlayer::CommandScheduler::Browse, command);
+        return command;
+    }
+
+    /// Submits a search for @p searchTerm, recorded as "search:<searchTerm>"
+    QPlayer::SearchCommand *search(QPlayer::CommandScheduler *scheduler, const QString &searchTerm, int limit = -1,
+                                   quint32 token = 0)
+    {
+        QPlayer::SearchCommand *command = new QPlayer::SearchCommand(1, searchTerm, QString(), limit);
+        command->setCancellationToken(token);
+        connect(command, &QPlayer::SearchCommand::complete, this, &ResultReceiver::searched);
+        connect(command, &QPlayer::SearchCommand::error, this, &ResultReceiver::searchFailed);
+        scheduler->submit(QPlayer::CommandScheduler::Search, command);
+        return command;
+    }
+
+    QStringList completed;
+    QList<int> resultSizes;
+    int errors;
+
+public Q_SLOTS:
+    void browsed(QPlayer::BrowseCommand *command)
+    {
+        completed << QString::fromLatin1("%1@%2").arg(command->mediaNodeId()).arg(command->offset());
+        resultSizes << command->result().count();
+    }
+
+    void failed(QPlayer::BrowseCommand *command)
+    {
+        Q_UNUSED(command);
+        ++errors;
+    }
+
+    void searched(QPlayer::SearchCommand *command)
+    {
+        completed << QString::fromLatin1("search:%1").arg(command->searchTerm());
+        resultSizes << command->result().count();
+    }
+
+    void searchFailed(QPlayer::SearchCommand *command)
+    {
+        Q_UNUSED(command);
+        ++errors;
+    }
+
+    void positionReceived(QPlayer::CurrentTrackPositionCommand *command)
+    {
+        Q_UNUSED(command);
+        completed << QStringLiteral("position");
+    }
+};
+
+class CommandSchedulerTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+
+    void testPriority();
+    void testMerge();
+    void testCancelWaiting();
+    void testCancelRunning();
+    void testCancelRunningSearch();
+
+    void benchmarkTransportLatency_data();
+    void benchmarkTransportLatency();
+};
+
+#endif
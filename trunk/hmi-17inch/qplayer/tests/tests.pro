@@ -0,0 +1,4 @@
+TEMPLATE = subdirs
+
+# runs against the mm-player client stand-in, not on target
+!qnx: SUBDIRS += commandscheduler
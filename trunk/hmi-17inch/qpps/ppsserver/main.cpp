@@ -0,0 +1,49 @@
+#include <QCoreApplication>
+#include <QStringList>
+
+#include <qpps/serverclient_p.h>
+
+#include "ppsserver.h"
+
+#include <stdio.h>
+
+static void printUsage()
+{
+    fprintf(stderr, "Usage: qppsserver [--socket <path>] [--root <directory>]\n"
+                    "  --socket <path>       listen on <path> instead of $QPPS_SERVER_SOCKET or /tmp/qppsserver\n"
+                    "  --root <directory>    load objects from and persist them to <directory>\n");
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QString socketPath = QString::fromLocal8Bit(QPps::ServerClient::socketPath());
+    QString root;
+
+    const QStringList arguments = app.arguments();
+    for (int i = 1; i < arguments.count(); ++i) {
+        if (arguments.at(i) == QStringLiteral("--socket") && i + 1 < arguments.count()) {
+            socketPath = arguments.at(++i);
+        } else if (arguments.at(i) == QStringLiteral("--root") && i + 1 < arguments.count()) {
+            root = arguments.at(++i);
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    PpsServer server;
+
+    if (!root.isEmpty() && !server.setPersistenceDirectory(root)) {
+        qCritical("%s", qPrintable(server.errorString()));
+        return 1;
+    }
+
+    if (!server.listen(socketPath)) {
+        qCritical("%s", qPrintable(server.errorString()));
+        return 1;
+    }
+
+    return app.exec();
+}
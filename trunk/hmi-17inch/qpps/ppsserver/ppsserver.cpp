@@ -0,0 +1,422 @@
+#include "ppsserver.h"
+
+#include <qpps/deltaparser_p.h>
+#include <qpps/encoding_p.h>
+
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QStringList>
+
+#include <errno.h>
+
+using namespace QPps;
+
+static QByteArray objectName(const QByteArray &path)
+{
+    return path.mid(path.lastIndexOf('/') + 1);
+}
+
+static QByteArray parentDirectory(const QByteArray &path)
+{
+    return path.left(path.lastIndexOf('/'));
+}
+
+static QByteArray errorReply(int error)
+{
+    return "error " + QByteArray::number(error) + '\n';
+}
+
+PpsServer::PpsServer(QObject *parent)
+    : QObject(parent)
+    , m_server(new QLocalServer(this))
+{
+    connect(m_server, SIGNAL(newConnection()), this, SLOT(newConnection()));
+}
+
+PpsServer::~PpsServer()
+{
+}
+
+bool PpsServer::listen(const QString &socketPath)
+{
+    QLocalServer::removeServer(socketPath);
+
+    if (!m_server->listen(socketPath)) {
+        m_errorString = tr("Unable to listen on %1: %2").arg(socketPath, m_server->errorString());
+        return false;
+    }
+
+    return true;
+}
+
+bool PpsServer::setPersistenceDirectory(const QString &directory)
+{
+    if (!QDir().mkpath(directory)) {
+        m_errorString = tr("Unable to create %1").arg(directory);
+        return false;
+    }
+
+    const QDir root(directory);
+    QDirIterator it(directory, QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        const QString fileName = it.next();
+        const QByteArray path = "/pps/" + root.relativeFilePath(fileName).toLocal8Bit();
+        if (!loadObject(fileName, path))
+            return false;
+    }
+
+    m_persistenceDirectory = directory;
+    return true;
+}
+
+QString PpsServer::errorString() const
+{
+    return m_errorString;
+}
+
+void PpsServer::newConnection()
+{
+    while (m_server->hasPendingConnections()) {
+        QLocalSocket *socket = m_server->nextPendingConnection();
+        m_clients.insert(socket, Client());
+
+        connect(socket, SIGNAL(readyRead()), this, SLOT(readClient()));
+        connect(socket, SIGNAL(disconnected()), this, SLOT(clientDisconnected()));
+    }
+}
+
+void PpsServer::readClient()
+{
+    QLocalSocket *socket = qobject_cast<QLocalSocket *>(sender());
+    QHash<QLocalSocket *, Client>::Iterator it = m_clients.find(socket);
+    if (it == m_clients.end())
+        return;
+
+    Client &client = it.value();
+    client.buffer += socket->readAll();
+
+    // everything that arrived with this read is applied as one change, like a single write() to PPS
+    QList<QByteArray> lines;
+    int begin = 0;
+    int end = 0;
+    while ((end = client.buffer.indexOf('\n', begin)) != -1) {
+        const QByteArray line = client.buffer.mid(begin, end - begin);
+        begin = end + 1;
+
+        if (!client.opened) {
+            handleRequest(socket, &client, line);
+            if (!client.opened) {
+                // failed to open, or done with a one-shot request
+                socket->disconnectFromServer();
+                return;
+            }
+        } else if (!line.isEmpty()) {
+            lines.append(line);
+        }
+    }
+
+    client.buffer.remove(0, begin);
+
+    if (!lines.isEmpty())
+        handleWrite(socket, client, lines);
+}
+
+void PpsServer::clientDisconnected()
+{
+    QLocalSocket *socket = qobject_cast<QLocalSocket *>(sender());
+    const Client client = m_clients.take(socket);
+
+    if (client.readable) {
+        QHash<QByteArray, QSet<QLocalSocket *> > &readers = client.directory ? m_directoryReaders : m_objectReaders;
+        QHash<QByteArray, QSet<QLocalSocket *> >::Iterator it = readers.find(client.path);
+        if (it != readers.end()) {
+            it->remove(socket);
+            if (it->isEmpty())
+                readers.erase(it);
+        }
+    }
+
+    socket->deleteLater();
+}
+
+void PpsServer::handleRequest(QLocalSocket *socket, Client *client, const QByteArray &request)
+{
+    const int firstSpace = request.indexOf(' ');
+    const QByteArray command = request.left(firstSpace);
+
+    if (command == "unlink") {
+        const QByteArray path = request.mid(firstSpace + 1);
+        if (!m_objects.contains(path)) {
+            socket->write(errorReply(ENOENT));
+            return;
+        }
+
+        removeObject(path);
+        socket->write("ok\n");
+        return;
+    }
+
+    const int secondSpace = request.indexOf(' ', firstSpace + 1);
+    if (command != "open" || firstSpace == -1 || secondSpace == -1) {
+        socket->write(errorReply(EINVAL));
+        return;
+    }
+
+    const QByteArray mode = request.mid(firstSpace + 1, secondSpace - firstSpace - 1);
+    QByteArray path = request.mid(secondSpace + 1);
+
+    const int questionMark = path.indexOf('?');
+    if (questionMark != -1) {
+        // unknown options (e.g. "wait" or "nopersist") are accepted and ignored
+        Q_FOREACH (const QByteArray &option, path.mid(questionMark + 1).split(',')) {
+            if (option == "delta")
+                client->delta = true;
+            else if (option == "deltadir")
+                client->deltaDir = true;
+        }
+        path.truncate(questionMark);
+    }
+
+    if (!path.startsWith('/')) {
+        socket->write(errorReply(EINVAL));
+        return;
+    }
+
+    client->readable = mode.contains('r');
+    client->writable = mode.contains('w');
+
+    if (path.endsWith("/.all")) {
+        client->directory = true;
+        client->writable = false;
+        path.chop(5);
+    } else if (!m_objects.contains(path)) {
+        if (!mode.contains('c')) {
+            socket->write(errorReply(ENOENT));
+            return;
+        }
+        createObject(path);
+    }
+
+    client->path = path;
+    client->opened = true;
+    socket->write("ok\n");
+
+    if (!client->readable)
+        return;
+
+    if (client->directory) {
+        m_directoryReaders[path].insert(socket);
+        sendDirectoryListing(socket, path, client->deltaDir);
+    } else {
+        m_objectReaders[path].insert(socket);
+        sendObject(socket, path);
+    }
+}
+
+void PpsServer::handleWrite(QLocalSocket *writer, const Client &client, const QList<QByteArray> &lines)
+{
+    // like PPS, the object might have been unlinked while it was open
+    if (!client.writable || !m_objects.contains(client.path))
+        return;
+
+    Attributes &attributes = m_objects[client.path];
+
+    QByteArray changes;
+    bool persistentChange = false;
+
+    Q_FOREACH (const QByteArray &line, lines) {
+        DeltaParser::Line parsed;
+        QString errorString;
+        if (!DeltaParser::parseLine(ByteRef(line.constData(), line.size()), &parsed, &errorString)) {
+            qWarning("%s: %s", client.path.constData(), qPrintable(errorString));
+            continue;
+        }
+
+        switch (parsed.type) {
+        case DeltaParser::AssignmentLine: {
+            Attribute attribute;
+            attribute.qualifiers = parsed.qualifiers.toByteArray();
+            attribute.encoding = encodingToByteArray(parsed.encoding);
+            attribute.value = parsed.value.toByteArray();
+            attributes.insert(parsed.name.toByteArray(), attribute);
+
+            persistentChange = persistentChange || !attribute.qualifiers.contains('n');
+            changes += line;
+            changes += '\n';
+            break;
+        }
+        case DeltaParser::RemovalLine:
+            if (attributes.remove(parsed.name.toByteArray()) > 0) {
+                persistentChange = true;
+                changes += line;
+                changes += '\n';
+            }
+            break;
+        case DeltaParser::ObjectLine:
+            // names the object that is written to, which is implied by the connection
+            break;
+        default:
+            qWarning("%s: ignoring unexpected line '%s'", client.path.constData(), line.constData());
+            break;
+        }
+    }
+
+    if (changes.isEmpty())
+        return;
+
+    const QByteArray delta = '@' + objectName(client.path) + '\n' + changes;
+
+    Q_FOREACH (QLocalSocket *reader, m_objectReaders.value(client.path)) {
+        if (reader == writer)
+            continue;
+
+        if (m_clients.value(reader).delta)
+            reader->write(delta);
+        else
+            sendObject(reader, client.path);
+    }
+
+    sendToDirectoryReaders(parentDirectory(client.path), delta, false, writer);
+
+    if (persistentChange)
+        storeObject(client.path);
+}
+
+void PpsServer::createObject(const QByteArray &path)
+{
+    m_objects.insert(path, Attributes());
+    sendToDirectoryReaders(parentDirectory(path), "+@" + objectName(path) + '\n', true, 0);
+
+    storeObject(path);
+}
+
+void PpsServer::removeObject(const QByteArray &path)
+{
+    m_objects.remove(path);
+    sendToDirectoryReaders(parentDirectory(path), "-@" + objectName(path) + '\n', true, 0);
+
+    if (!m_persistenceDirectory.isEmpty())
+        QFile::remove(fileName(path));
+}
+
+void PpsServer::sendObject(QLocalSocket *socket, const QByteArray &path) const
+{
+    const Attributes attributes = m_objects.value(path);
+
+    QByteArray data = '@' + objectName(path) + '\n';
+    for (Attributes::ConstIterator it = attributes.constBegin(); it != attributes.constEnd(); ++it)
+        data += attributeLine(it.key(), it.value());
+
+    socket->write(data);
+}
+
+void PpsServer::sendDirectoryListing(QLocalSocket *socket, const QByteArray &directory, bool deltaDir) const
+{
+    QList<QByteArray> paths;
+    for (QHash<QByteArray, Attributes>::ConstIterator it = m_objects.constBegin(); it != m_objects.constEnd(); ++it) {
+        if (parentDirectory(it.key()) == directory)
+            paths.append(it.key());
+    }
+    qSort(paths);
+
+    Q_FOREACH (const QByteArray &path, paths) {
+        if (deltaDir)
+            socket->write('@' + objectName(path) + '\n');
+        else
+            sendObject(socket, path);
+    }
+}
+
+void PpsServer::sendToDirectoryReaders(const QByteArray &directory, const QByteArray &data, bool deltaDir, QLocalSocket *except)
+{
+    Q_FOREACH (QLocalSocket *reader, m_directoryReaders.value(directory)) {
+        if (reader != except && m_clients.value(reader).deltaDir == deltaDir)
+            reader->write(data);
+    }
+}
+
+QString PpsServer::fileName(const QByteArray &path) const
+{
+    const QByteArray relativePath = path.startsWith("/pps/") ? path.mid(5) : path.mid(1);
+    return m_persistenceDirectory + QLatin1Char('/') + QString::fromLocal8Bit(relativePath);
+}
+
+bool PpsServer::loadObject(const QString &fileName, const QByteArray &path)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        m_errorString = tr("Unable to read %1: %2").arg(fileName, file.errorString());
+        return false;
+    }
+
+    Attributes attributes;
+    Q_FOREACH (const QByteArray &line, file.readAll().split('\n')) {
+        if (line.isEmpty())
+            continue;
+
+        DeltaParser::Line parsed;
+        QString errorString;
+        if (!DeltaParser::parseLine(ByteRef(line.constData(), line.size()), &parsed, &errorString)) {
+            m_errorString = tr("%1 in %2").arg(errorString, fileName);
+            return false;
+        }
+
+        // the leading "@name" line is implied by the file name
+        if (parsed.type != DeltaParser::AssignmentLine)
+            continue;
+
+        Attribute attribute;
+        attribute.qualifiers = parsed.qualifiers.toByteArray();
+        attribute.encoding = encodingToByteArray(parsed.encoding);
+        attribute.value = parsed.value.toByteArray();
+        attributes.insert(parsed.name.toByteArray(), attribute);
+    }
+
+    m_objects.insert(path, attributes);
+    return true;
+}
+
+void PpsServer::storeObject(const QByteArray &path) const
+{
+    if (m_persistenceDirectory.isEmpty())
+        return;
+
+    const QString objectFileName = fileName(path);
+    QDir().mkpath(QFileInfo(objectFileName).absolutePath());
+
+    QFile file(objectFileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning("Unable to write %s: %s", qPrintable(objectFileName), qPrintable(file.errorString()));
+        return;
+    }
+
+    QByteArray data = '@' + objectName(path) + '\n';
+
+    const Attributes attributes = m_objects.value(path);
+    for (Attributes::ConstIterator it = attributes.constBegin(); it != attributes.constEnd(); ++it) {
+        // [n] marks attributes that do not survive a restart
+        if (!it.value().qualifiers.contains('n'))
+            data += attributeLine(it.key(), it.value());
+    }
+
+    file.write(data);
+}
+
+QByteArray PpsServer::attributeLine(const QByteArray &name, const Attribute &attribute)
+{
+    QByteArray line;
+    if (!attribute.qualifiers.isEmpty())
+        line += '[' + attribute.qualifiers + ']';
+
+    line += name;
+    line += ':';
+    line += attribute.encoding;
+    line += ':';
+    line += attribute.value;
+    line += '\n';
+    return line;
+}
@@ -0,0 +1,99 @@
+#ifndef PPSSERVER_H
+#define PPSSERVER_H
+
+#include <QHash>
+#include <QMap>
+#include <QObject>
+#include <QSet>
+
+class QLocalServer;
+class QLocalSocket;
+
+/**
+ * @short Serves PPS objects from memory over a unix socket
+ *
+ * A stand-in for the QNX PPS file system, so that the QNX backend of qpps (built with
+ * CONFIG+=pps_server) can run and be benchmarked on Linux. See QPps::ServerClient for the
+ * protocol.
+ *
+ * Supported are the parts of PPS that qpps uses: objects opened in delta and full mode, with
+ * and without creation, attribute removal, qualifiers, unlinking objects, and directory
+ * listings through "<dir>/.all" with and without the @c deltadir option. Changes are sent to
+ * all readers of an object except the one that wrote them.
+ */
+class PpsServer : public QObject
+{
+    Q_OBJECT
+public:
+    explicit PpsServer(QObject *parent = 0);
+    ~PpsServer();
+
+    /// Starts listening on @p socketPath, replacing a stale socket
+    bool listen(const QString &socketPath);
+
+    /**
+     * Loads the objects stored below @p directory in the PPS file format, mapped to /pps, and
+     * writes persistent attributes back whenever they change.
+     */
+    bool setPersistenceDirectory(const QString &directory);
+
+    QString errorString() const;
+
+private Q_SLOTS:
+    void newConnection();
+    void readClient();
+    void clientDisconnected();
+
+private:
+    struct Attribute
+    {
+        QByteArray qualifiers;
+        QByteArray encoding;
+        QByteArray value;
+    };
+
+    typedef QMap<QByteArray, Attribute> Attributes;
+
+    struct Client
+    {
+        Client() : opened(false), readable(false), writable(false), delta(false), deltaDir(false), directory(false) {}
+
+        bool opened;
+        bool readable;
+        bool writable;
+        bool delta;
+        bool deltaDir;
+        bool directory;   ///< opened "<path>/.all"
+        QByteArray path;  ///< object path, or directory path for "/.all"
+        QByteArray buffer;
+    };
+
+    void handleRequest(QLocalSocket *socket, Client *client, const QByteArray &request);
+    void handleWrite(QLocalSocket *socket, const Client &client, const QList<QByteArray> &lines);
+
+    void createObject(const QByteArray &path);
+    void removeObject(const QByteArray &path);
+
+    void sendObject(QLocalSocket *socket, const QByteArray &path) const;
+    void sendDirectoryListing(QLocalSocket *socket, const QByteArray &directory, bool deltaDir) const;
+    void sendToDirectoryReaders(const QByteArray &directory, const QByteArray &data, bool deltaDir, QLocalSocket *except);
+
+    QString fileName(const QByteArray &path) const;
+    bool loadObject(const QString &fileName, const QByteArray &path);
+    void storeObject(const QByteArray &path) const;
+
+    static QByteArray attributeLine(const QByteArray &name, const Attribute &attribute);
+
+    QLocalServer *m_server;
+    QString m_errorString;
+    QString m_persistenceDirectory;
+
+    QHash<QByteArray, Attributes> m_objects;
+    QHash<QLocalSocket *, Client> m_clients;
+
+    // readers by object path and by directory path, to find the receivers of a change quickly
+    QHash<QByteArray, QSet<QLocalSocket *> > m_objectReaders;
+    QHash<QByteArray, QSet<QLocalSocket *> > m_directoryReaders;
+};
+
+#endif // PPSSERVER_H
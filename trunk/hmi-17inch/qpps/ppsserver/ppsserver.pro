@@ -0,0 +1,26 @@
+include(../../common.pri)
+
+QT += core network
+QT -= gui
+
+DESTDIR = $$BUILD_ROOT/bin
+
+# qpps
+INCLUDEPATH += $$PWD/..
+DEPENDPATH += $$PWD/..
+LIBPATH += $$BUILD_ROOT/lib
+LIBS += -lqpps
+
+TARGET = qppsserver
+CONFIG += console
+CONFIG -= app_bundle
+
+TEMPLATE = app
+
+target.path = $$INSTALL_PREFIX/bin
+INSTALLS += target
+
+SOURCES += main.cpp \
+           ppsserver.cpp
+
+HEADERS += ppsserver.h
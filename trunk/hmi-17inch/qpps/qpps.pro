@@ -3,6 +3,8 @@ CONFIG += ordered
 
 SUBDIRS = qpps
 !win32: SUBDIRS += monitor
+# stand-in for the PPS file system, for CONFIG+=pps_server builds of qpps
+linux: SUBDIRS += ppsserver
 
 SUBDIRS += tests
 
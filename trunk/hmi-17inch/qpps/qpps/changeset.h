@@ -3,6 +3,7 @@
 
 #include "variant.h"
 
+#include <QHash>
 #include <QMap>
 #include <QSet>
 
@@ -13,6 +14,13 @@ struct Changeset
 {
     QMap<QString, Variant> assignments;
     QSet<QString> removals;
+
+    /**
+     * The ids (see Key) of the assignments whose names are interned. Filled in by the backend for the
+     * changes it delivers, so that receivers do not have to look names up again; an assignment without
+     * an entry has not been interned.
+     */
+    QHash<QString, int> keys;
 };
 
 }
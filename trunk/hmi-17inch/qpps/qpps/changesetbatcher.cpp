@@ -0,0 +1,89 @@
+#include "changesetbatcher_p.h"
+
+using namespace QPps;
+
+ChangesetBatcher::ChangesetBatcher(QObject *parent)
+    : QObject(parent)
+{
+    m_timer.setSingleShot(true);
+    m_timer.setInterval(0);
+    connect(&m_timer, SIGNAL(timeout()), this, SIGNAL(flushRequested()));
+}
+
+void ChangesetBatcher::setInterval(int msec)
+{
+    m_timer.setInterval(qMax(0, msec));
+}
+
+int ChangesetBatcher::interval() const
+{
+    return m_timer.interval();
+}
+
+void ChangesetBatcher::add(const Changeset &changes)
+{
+    QMap<QString, Variant>::ConstIterator it = changes.assignments.constBegin();
+    for (; it != changes.assignments.constEnd(); ++it)
+        addChange(it.key(), it.value(), false);
+
+    Q_FOREACH (const QString &removal, changes.removals)
+        addChange(removal, Variant(), true);
+
+    // do not restart a running timer, so that continuous changes still get flushed in time
+    if (!m_timer.isActive() && !isEmpty())
+        m_timer.start();
+}
+
+bool ChangesetBatcher::isEmpty() const
+{
+    return m_pending.isEmpty();
+}
+
+const ChangesetBatcher::Change *ChangesetBatcher::pendingChange(const QString &name) const
+{
+    const QHash<QString, int>::ConstIterator index = m_indexes.constFind(name);
+    if (index == m_indexes.constEnd())
+        return 0;
+
+    return &m_pending.at(index.value());
+}
+
+QList<ChangesetBatcher::Change> ChangesetBatcher::take()
+{
+    m_timer.stop();
+    m_indexes.clear();
+
+    QList<Change> changes;
+    changes.swap(m_pending);
+    return changes;
+}
+
+Changeset ChangesetBatcher::toChangeset(const QList<Change> &changes)
+{
+    Changeset changeset;
+    Q_FOREACH (const Change &change, changes) {
+        if (change.isRemoval)
+            changeset.removals.insert(change.name);
+        else
+            changeset.assignments.insert(change.name, change.value);
+    }
+
+    return changeset;
+}
+
+void ChangesetBatcher::addChange(const QString &name, const Variant &value, bool isRemoval)
+{
+    // a later change of an attribute replaces the pending one in place
+    const QHash<QString, int>::ConstIterator index = m_indexes.constFind(name);
+    if (index != m_indexes.constEnd()) {
+        Change &change = m_pending[index.value()];
+        change.value = value;
+        change.isRemoval = isRemoval;
+        return;
+    }
+
+    m_indexes.insert(name, m_pending.size());
+
+    const Change change = { name, value, isRemoval };
+    m_pending.append(change);
+}
@@ -0,0 +1,73 @@
+#ifndef QPPS_CHANGESETBATCHER_P_H
+#define QPPS_CHANGESETBATCHER_P_H
+
+#include "changeset.h"
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QTimer>
+
+namespace QPps
+{
+
+/**
+ * @short Collects attribute changes for write-behind mode of Object
+ *
+ * Changes added via add() are merged per attribute, so that only the latest assignment or
+ * removal of each attribute survives. The attributes are kept in the order they were first
+ * changed in, so that they are written in that order. flushRequested() is emitted once the
+ * configured interval has passed since the first pending change, or in the next event loop
+ * iteration for an interval of 0.
+ */
+class ChangesetBatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    /// The pending assignment or removal of one attribute
+    struct Change
+    {
+        QString name;
+        Variant value; ///< invalid for a removal
+        bool isRemoval;
+    };
+
+    explicit ChangesetBatcher(QObject *parent = 0);
+
+    /// Sets the minimum time in milliseconds between two flushes
+    void setInterval(int msec);
+    int interval() const;
+
+    /// Merges @p changes into the pending changes and schedules a flush
+    void add(const Changeset &changes);
+
+    /// Returns true if there are no pending changes
+    bool isEmpty() const;
+
+    /// Returns the pending change of attribute @p name, or 0 if there is none
+    const Change *pendingChange(const QString &name) const;
+
+    /// Returns the pending changes in the order the attributes were first changed
+    const QList<Change> &pendingChanges() const { return m_pending; }
+
+    /// Returns the pending changes in the order the attributes were first changed, and resets the batcher
+    QList<Change> take();
+
+    /// Returns @p changes as a changeset, which does not keep their order
+    static Changeset toChangeset(const QList<Change> &changes);
+
+Q_SIGNALS:
+    void flushRequested();
+
+private:
+    void addChange(const QString &name, const Variant &value, bool isRemoval);
+
+    QList<Change> m_pending;
+    QHash<QString, int> m_indexes; ///< position of each attribute in m_pending
+    QTimer m_timer;
+};
+
+}
+
+#endif
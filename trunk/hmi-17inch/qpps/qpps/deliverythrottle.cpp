@@ -0,0 +1,222 @@
+#include "deliverythrottle_p.h"
+
+using namespace QPps;
+
+/**
+ * Inserts the assignment of @p name with @p value into @p changes, along with its interned id from @p keys.
+ */
+static void insertAssignment(Changeset *changes, const QString &name, const Variant &value, const QHash<QString, int> &keys)
+{
+    changes->assignments.insert(name, value);
+
+    const QHash<QString, int>::ConstIterator key = keys.constFind(name);
+    if (key != keys.constEnd())
+        changes->keys.insert(name, key.value());
+    else
+        changes->keys.remove(name);
+}
+
+DeliveryThrottle::DeliveryThrottle(QObject *parent)
+    : QObject(parent)
+    , m_coalescingEnabled(false)
+    , m_coalescingInterval(DefaultCoalescingInterval)
+    , m_nextDue(0)
+{
+    m_clock.start();
+
+    // a coarse timer may fire early, which would only cause another round trip
+    m_timer.setTimerType(Qt::PreciseTimer);
+    m_timer.setSingleShot(true);
+    connect(&m_timer, SIGNAL(timeout()), this, SIGNAL(deliveryRequested()));
+}
+
+void DeliveryThrottle::setCoalescingEnabled(bool enabled)
+{
+    m_coalescingEnabled = enabled;
+}
+
+bool DeliveryThrottle::coalescingEnabled() const
+{
+    return m_coalescingEnabled;
+}
+
+void DeliveryThrottle::setCoalescingInterval(int msec)
+{
+    m_coalescingInterval = qMax(0, msec);
+}
+
+int DeliveryThrottle::coalescingInterval() const
+{
+    return m_coalescingInterval;
+}
+
+void DeliveryThrottle::setMinimumInterval(const QString &name, int msec)
+{
+    KeyPolicy &policy = m_policies[name];
+    policy.minimumInterval = qMax(0, msec);
+    if (policy.isNull())
+        m_policies.remove(name);
+}
+
+int DeliveryThrottle::minimumInterval(const QString &name) const
+{
+    return m_policies.value(name).minimumInterval;
+}
+
+void DeliveryThrottle::setDeadband(const QString &name, double deadband)
+{
+    KeyPolicy &policy = m_policies[name];
+    policy.deadband = qMax(0.0, deadband);
+    if (policy.isNull())
+        m_policies.remove(name);
+}
+
+double DeliveryThrottle::deadband(const QString &name) const
+{
+    return m_policies.value(name).deadband;
+}
+
+Changeset DeliveryThrottle::filter(const Changeset &changes)
+{
+    const qint64 now = m_clock.elapsed();
+    Changeset deliverable;
+
+    QMap<QString, Variant>::ConstIterator it = changes.assignments.constBegin();
+    for (; it != changes.assignments.constEnd(); ++it) {
+        const PolicyHash::Iterator policy = m_policies.find(it.key());
+
+        if (policy != m_policies.end() && policy->deadband > 0 && policy->hasLastValue) {
+            bool ok = false;
+            const double value = it.value().toDouble(&ok);
+            if (ok && qAbs(value - policy->lastValue) < policy->deadband) {
+                // the last delivered value is still close enough, which also makes a held back one obsolete
+                dropPending(it.key());
+                continue;
+            }
+        }
+
+        const qint64 due = dueTime(it.key(), policy, now);
+        if (due <= now) {
+            dropPending(it.key());
+            insertAssignment(&deliverable, it.key(), it.value(), changes.keys);
+            markDelivered(policy, it.value(), now);
+        } else {
+            m_pending.removals.remove(it.key());
+            insertAssignment(&m_pending, it.key(), it.value(), changes.keys);
+            schedule(it.key(), due, now);
+        }
+    }
+
+    Q_FOREACH (const QString &removal, changes.removals) {
+        const PolicyHash::Iterator policy = m_policies.find(removal);
+        if (policy != m_policies.end())
+            policy->hasLastValue = false;
+
+        if (m_coalescingEnabled) {
+            m_pending.assignments.remove(removal);
+            m_pending.keys.remove(removal);
+            m_pending.removals.insert(removal);
+            schedule(removal, dueTime(removal, m_policies.constEnd(), now), now);
+        } else {
+            // removals are never throttled, but they supersede a held back value
+            dropPending(removal);
+            deliverable.removals.insert(removal);
+        }
+    }
+
+    return deliverable;
+}
+
+Changeset DeliveryThrottle::takeDue()
+{
+    const qint64 now = m_clock.elapsed();
+    Changeset due;
+    qint64 nextDue = -1;
+
+    QHash<QString, qint64>::Iterator it = m_dueTimes.begin();
+    while (it != m_dueTimes.end()) {
+        if (it.value() > now) {
+            nextDue = (nextDue == -1) ? it.value() : qMin(nextDue, it.value());
+            ++it;
+            continue;
+        }
+
+        const QString &name = it.key();
+        if (m_pending.removals.remove(name)) {
+            due.removals.insert(name);
+        } else {
+            const Variant value = m_pending.assignments.take(name);
+            insertAssignment(&due, name, value, m_pending.keys);
+            m_pending.keys.remove(name);
+            markDelivered(m_policies.find(name), value, now);
+        }
+
+        it = m_dueTimes.erase(it);
+    }
+
+    if (nextDue != -1) {
+        m_nextDue = nextDue;
+        m_timer.start(int(nextDue - now));
+    }
+
+    return due;
+}
+
+bool DeliveryThrottle::hasPending() const
+{
+    return !m_dueTimes.isEmpty();
+}
+
+qint64 DeliveryThrottle::dueTime(const QString &name, PolicyHash::ConstIterator policy, qint64 now) const
+{
+    // a held back change keeps its due time, later values only replace it
+    const QHash<QString, qint64>::ConstIterator pending = m_dueTimes.constFind(name);
+    if (pending != m_dueTimes.constEnd())
+        return pending.value();
+
+    qint64 due = now;
+
+    if (m_coalescingEnabled) {
+        // join an already scheduled delivery, so that all changes of a frame arrive together
+        due = (m_timer.isActive() && m_nextDue <= now + m_coalescingInterval) ? m_nextDue : now + m_coalescingInterval;
+    }
+
+    if (policy != m_policies.constEnd() && policy->minimumInterval > 0 && policy->lastDelivery != -1)
+        due = qMax(due, policy->lastDelivery + policy->minimumInterval);
+
+    return due;
+}
+
+void DeliveryThrottle::schedule(const QString &name, qint64 due, qint64 now)
+{
+    m_dueTimes.insert(name, due);
+
+    if (!m_timer.isActive() || due < m_nextDue) {
+        m_nextDue = due;
+        m_timer.start(int(qMax<qint64>(0, due - now)));
+    }
+}
+
+void DeliveryThrottle::dropPending(const QString &name)
+{
+    if (m_dueTimes.remove(name)) {
+        m_pending.assignments.remove(name);
+        m_pending.keys.remove(name);
+        m_pending.removals.remove(name);
+    }
+}
+
+void DeliveryThrottle::markDelivered(PolicyHash::Iterator policy, const Variant &value, qint64 now)
+{
+    if (policy == m_policies.end())
+        return;
+
+    policy->lastDelivery = now;
+
+    if (policy->deadband > 0) {
+        bool ok = false;
+        const double number = value.toDouble(&ok);
+        policy->hasLastValue = ok;
+        policy->lastValue = number;
+    }
+}
@@ -0,0 +1,105 @@
+#ifndef QPPS_DELIVERYTHROTTLE_P_H
+#define QPPS_DELIVERYTHROTTLE_P_H
+
+#include "changeset.h"
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QTimer>
+
+namespace QPps
+{
+
+/**
+ * @short Limits how often attribute changes received by an Object are delivered
+ *
+ * Three policies can be combined:
+ * - Coalescing: changes are held back and delivered together once per interval, only the latest
+ *   value of each attribute survives.
+ * - Minimum interval: an attribute is delivered at most once per interval, a change arriving
+ *   earlier is held back until the interval has passed (and replaced by later changes).
+ * - Deadband: a numeric attribute is only delivered if it differs from the last delivered value
+ *   by at least the deadband; smaller changes are dropped.
+ *
+ * filter() returns the part of incoming changes that can be delivered right away, and
+ * deliveryRequested() is emitted when held back changes are due to be fetched with takeDue().
+ */
+class DeliveryThrottle : public QObject
+{
+    Q_OBJECT
+
+public:
+    /// Default interval for coalesced deliveries, one frame at 60 Hz
+    static const int DefaultCoalescingInterval = 16;
+
+    explicit DeliveryThrottle(QObject *parent = 0);
+
+    void setCoalescingEnabled(bool enabled);
+    bool coalescingEnabled() const;
+
+    void setCoalescingInterval(int msec);
+    int coalescingInterval() const;
+
+    /// Sets the minimum time between two deliveries of attribute @p name, 0 disables the limit
+    void setMinimumInterval(const QString &name, int msec);
+    int minimumInterval(const QString &name) const;
+
+    /// Sets the deadband of the numeric attribute @p name, 0 disables it
+    void setDeadband(const QString &name, double deadband);
+    double deadband(const QString &name) const;
+
+    /// Returns the part of @p changes that is due now and holds back the rest
+    Changeset filter(const Changeset &changes);
+
+    /// Returns the held back changes that are due now
+    Changeset takeDue();
+
+    /// Returns true if there are held back changes
+    bool hasPending() const;
+
+Q_SIGNALS:
+    void deliveryRequested();
+
+private:
+    struct KeyPolicy
+    {
+        KeyPolicy()
+            : minimumInterval(0)
+            , deadband(0)
+            , lastDelivery(-1)
+            , hasLastValue(false)
+            , lastValue(0)
+        {}
+
+        bool isNull() const { return minimumInterval <= 0 && deadband <= 0; }
+
+        int minimumInterval;
+        double deadband;
+        qint64 lastDelivery; ///< in msecs of m_clock, -1 if never delivered
+        bool hasLastValue;
+        double lastValue; ///< last delivered numeric value, for the deadband
+    };
+
+    typedef QHash<QString, KeyPolicy> PolicyHash;
+
+    qint64 dueTime(const QString &name, PolicyHash::ConstIterator policy, qint64 now) const;
+    void schedule(const QString &name, qint64 due, qint64 now);
+    void dropPending(const QString &name);
+    void markDelivered(PolicyHash::Iterator policy, const Variant &value, qint64 now);
+
+    bool m_coalescingEnabled;
+    int m_coalescingInterval;
+    PolicyHash m_policies;
+
+    Changeset m_pending;
+    QHash<QString, qint64> m_dueTimes; ///< when each held back attribute is due
+    qint64 m_nextDue;
+
+    QElapsedTimer m_clock;
+    QTimer m_timer;
+};
+
+}
+
+#endif
@@ -0,0 +1,174 @@
+#include "deltaparser_p.h"
+
+#include <QObject>
+
+#include <string.h>
+
+using namespace QPps;
+
+int ByteRef::indexOf(char c, int from) const
+{
+    if (from >= size)
+        return -1;
+
+    const void *found = memchr(data + from, c, size - from);
+    return found ? static_cast<const char *>(found) - data : -1;
+}
+
+ByteRef ByteRef::mid(int pos, int len) const
+{
+    if (pos >= size)
+        return ByteRef(data + size, 0);
+
+    if (len < 0 || pos + len > size)
+        len = size - pos;
+
+    return ByteRef(data + pos, len);
+}
+
+bool ByteRef::operator==(const char *str) const
+{
+    const int length = str ? qstrlen(str) : 0;
+    return length == size && memcmp(data, str, size) == 0;
+}
+
+DeltaParser::DeltaParser(int capacity)
+    : m_buffer(capacity, Qt::Uninitialized)
+    , m_begin(0)
+    , m_end(0)
+{
+}
+
+char *DeltaParser::writePointer()
+{
+    return m_buffer.data() + m_end;
+}
+
+int DeltaParser::writeCapacity()
+{
+    if (m_end == m_buffer.size()) {
+        // make room by dropping consumed bytes first, grow only if a single line fills the buffer
+        compact();
+        if (m_end == m_buffer.size())
+            m_buffer.resize(m_buffer.size() * 2);
+    }
+
+    return m_buffer.size() - m_end;
+}
+
+void DeltaParser::commit(int count)
+{
+    Q_ASSERT(count >= 0 && m_end + count <= m_buffer.size());
+    m_end += count;
+}
+
+void DeltaParser::append(const char *data, int count)
+{
+    while (count > 0) {
+        const int chunk = qMin(count, writeCapacity());
+        memcpy(writePointer(), data, chunk);
+        commit(chunk);
+        data += chunk;
+        count -= chunk;
+    }
+}
+
+bool DeltaParser::nextLine(Line *line)
+{
+    const char *buffer = m_buffer.constData();
+
+    forever {
+        if (m_begin == m_end)
+            return false;
+
+        const void *newline = memchr(buffer + m_begin, '\n', m_end - m_begin);
+        if (!newline) // incomplete line, wait for more data
+            return false;
+
+        const int lineEnd = static_cast<const char *>(newline) - buffer;
+        const ByteRef raw(buffer + m_begin, lineEnd - m_begin);
+        m_begin = lineEnd + 1;
+
+        // ignore empty lines
+        if (raw.isEmpty())
+            continue;
+
+        parseLine(raw, line, &m_errorString);
+        return true;
+    }
+}
+
+void DeltaParser::compact()
+{
+    if (m_begin == 0)
+        return;
+
+    const int pending = m_end - m_begin;
+    if (pending > 0)
+        memmove(m_buffer.data(), m_buffer.constData() + m_begin, pending);
+
+    m_begin = 0;
+    m_end = pending;
+}
+
+void DeltaParser::clear()
+{
+    m_begin = 0;
+    m_end = 0;
+}
+
+bool DeltaParser::parseLine(const ByteRef &raw, Line *line, QString *errorString)
+{
+    *line = Line();
+    line->raw = raw;
+
+    ByteRef rest = raw;
+
+    // parse [ni] qualifiers; for now they are just passed on
+    if (rest.startsWith('[')) {
+        const int closingBrace = rest.indexOf(']');
+        if (closingBrace == -1) {
+            if (errorString)
+                *errorString = QObject::tr("Invalid format (no closing brace ']'): '%1'").arg(raw.toString());
+            return false;
+        }
+        line->qualifiers = rest.mid(1, closingBrace - 1);
+        rest = rest.mid(closingBrace + 1);
+    }
+
+    if (rest.startsWith('@')) {
+        line->type = ObjectLine;
+        line->name = rest.mid(1);
+    } else if (rest.startsWith('+')) {
+        if (rest.size < 2 || rest.data[1] != '@') {
+            if (errorString)
+                *errorString = QObject::tr("Invalid line: '%1'").arg(raw.toString());
+            return false;
+        }
+        line->type = ObjectAddedLine;
+        line->name = rest.mid(2);
+    } else if (rest.startsWith('-')) {
+        if (rest.size >= 2 && rest.data[1] == '@') {
+            line->type = ObjectRemovedLine;
+            line->name = rest.mid(2);
+        } else {
+            line->type = RemovalLine;
+            line->name = rest.mid(1);
+        }
+    } else {
+        const int firstColon = rest.indexOf(':');
+        const int secondColon = rest.indexOf(':', firstColon + 1);
+        if (firstColon == -1 || secondColon == -1) { // bad format
+            if (errorString)
+                *errorString = QObject::tr("Invalid format (no '::' encountered): '%1'").arg(raw.toString());
+            return false;
+        }
+
+        line->type = AssignmentLine;
+        line->name = rest.mid(0, firstColon);
+        line->encoding = rest.mid(firstColon + 1, secondColon - firstColon - 1);
+        line->value = rest.mid(secondColon + 1);
+    }
+
+    return true;
+}
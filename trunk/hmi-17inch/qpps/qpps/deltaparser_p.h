@@ -0,0 +1,146 @@
+#ifndef QPPS_DELTAPARSER_P_H
+#define QPPS_DELTAPARSER_P_H
+
+#include "qpps_export.h"
+
+#include <QByteArray>
+#include <QString>
+
+namespace QPps
+{
+
+/**
+ * @short A non-owning view into a range of bytes
+ *
+ * Used by DeltaParser to hand out parts of a PPS line without copying them.
+ * The referenced data is only valid until the parser's buffer is refilled.
+ */
+struct ByteRef
+{
+    ByteRef() : data(0), size(0) {}
+    ByteRef(const char *d, int s) : data(d), size(s) {}
+
+    bool isEmpty() const { return size == 0; }
+    bool startsWith(char c) const { return size > 0 && data[0] == c; }
+    int indexOf(char c, int from = 0) const;
+    ByteRef mid(int pos, int len = -1) const;
+
+    /// Compares the referenced bytes with the null terminated @p str
+    bool operator==(const char *str) const;
+    bool operator!=(const char *str) const { return !operator==(str); }
+
+    /// Returns a deep copy of the referenced bytes
+    QByteArray toByteArray() const { return QByteArray(data, size); }
+
+    /// Returns the referenced bytes decoded as local 8 bit string
+    QString toString() const { return QString::fromLocal8Bit(data, size); }
+
+    const char *data;
+    int size;
+};
+
+/**
+ * @short Incremental parser for the PPS delta format
+ *
+ * The parser owns a persistent buffer that the caller fills directly (e.g. via ::read() into
+ * writePointer()), so no intermediate copy is needed. Complete lines are handed out as ByteRef
+ * views into that buffer; a line that is cut in half by a read is carried over and completed
+ * by the next one.
+ *
+ * Typical usage:
+ * \code
+ * const int count = ::read(fd, parser.writePointer(), parser.writeCapacity());
+ * parser.commit(count);
+ *
+ * DeltaParser::Line line;
+ * while (parser.nextLine(&line)) {
+ *     ...
+ * }
+ * parser.compact();
+ * \endcode
+ */
+class QPPS_EXPORT DeltaParser
+{
+public:
+    /// The kind of a single line in the PPS delta format
+    enum LineType
+    {
+        InvalidLine = 0,   ///< Line could not be parsed, see errorString()
+        ObjectLine,        ///< "@name", starts the attributes of an object (or lists it in a directory)
+        ObjectAddedLine,   ///< "+@name", an object was added to a watched directory
+        ObjectRemovedLine, ///< "-@name", an object was removed from a watched directory
+        AssignmentLine,    ///< "name:encoding:value", an attribute was set
+        RemovalLine        ///< "-name", an attribute was removed
+    };
+
+    /// A parsed line, all members are views into the parser's buffer
+    struct Line
+    {
+        Line() : type(InvalidLine) {}
+
+        LineType type;
+        ByteRef qualifiers; ///< the content of an optional leading "[...]" qualifier, e.g. "n" or "i"
+        ByteRef name;       ///< object or attribute name
+        ByteRef encoding;   ///< only set for AssignmentLine
+        ByteRef value;      ///< only set for AssignmentLine
+        ByteRef raw;        ///< the whole line without the trailing newline
+    };
+
+    /// Default initial buffer size, the buffer grows if a single line does not fit
+    static const int DefaultCapacity = 1 << 16;
+
+    explicit DeltaParser(int capacity = DefaultCapacity);
+
+    /// Returns the position where the next chunk of raw data should be written to
+    char *writePointer();
+
+    /// Returns how many bytes can be written at writePointer(), growing the buffer if it is full
+    int writeCapacity();
+
+    /// Marks @p count bytes at writePointer() as filled
+    void commit(int count);
+
+    /// Convenience method that copies @p count bytes from @p data into the buffer
+    void append(const char *data, int count);
+
+    /**
+     * Parses the next complete line. Empty lines are skipped.
+     *
+     * @return False if no complete line is available anymore. @p line may be of type
+     *         InvalidLine, in which case errorString() describes the problem.
+     */
+    bool nextLine(Line *line);
+
+    /**
+     * Moves an incomplete trailing line to the front of the buffer.
+     *
+     * Must be called after all complete lines have been consumed via nextLine() and before
+     * the buffer is filled again. Invalidates all ByteRefs handed out so far.
+     */
+    void compact();
+
+    /// Drops all buffered data, including a pending incomplete line
+    void clear();
+
+    /// Returns the number of buffered bytes that have not been consumed yet
+    int pendingBytes() const { return m_end - m_begin; }
+
+    /// Returns a description of the last InvalidLine
+    QString errorString() const { return m_errorString; }
+
+    /**
+     * Parses a single line without trailing newline.
+     * Only the line framing is handled by nextLine(), so this can also be used on its own.
+     */
+    static bool parseLine(const ByteRef &raw, Line *line, QString *errorString = 0);
+
+private:
+    QByteArray m_buffer;
+    int m_begin;
+    int m_end;
+    QString m_errorString;
+};
+
+}
+
+#endif
@@ -1,5 +1,8 @@
 #include "dirwatcher.h"
 #include "dirwatcher_p.h"
+#ifdef QPPS_SERVER_BUILD
+#include "serverclient_p.h"
+#endif
 
 #include <QList>
 #include <QStringList>
@@ -11,89 +14,81 @@
 
 using namespace QPps;
 
-static const int QPPS_DEFAULT_PPS_OBJECT_SIZE = 1 << 16;
-
-DirWatcher::Private::Private(DirWatcher *parent)
-    : QObject(parent)
-    , notifier(0)
+DirectoryReader::DirectoryReader(int fd, const QString &path, QObject *receiver, const char *deliverSlot)
+    : ReactorReader(fd, path, receiver, deliverSlot)
 {
 }
 
-DirWatcher::Private::~Private()
+QList<DirectoryReader::Event> DirectoryReader::takeEvents()
 {
+    QMutexLocker locker(&m_mutex);
+    deliveryTaken();
+
+    QList<Event> events;
+    events.swap(m_events);
+    return events;
 }
 
-void DirWatcher::Private::readData()
+bool DirectoryReader::parseLines(DeltaParser *parser, QString *errorString)
 {
-    if (!notifier)
-        return;
-
-    errorString.clear();
-
-    char buffer[QPPS_DEFAULT_PPS_OBJECT_SIZE];
-
-    forever {
-        const int count = ::read(notifier->socket(), buffer, sizeof(buffer));
-        if (count == -1) {
-            errorString = QObject::tr("Unable to read data from %1: %2").arg(path, QString::fromLocal8Bit(strerror(errno)));
-            return;
-        } else if (count == 0) {
-            // end of data
+    DeltaParser::Line line;
+    while (parser->nextLine(&line)) {
+        switch (line.type) {
+        case DeltaParser::ObjectRemovedLine: // "-@<objectName>"
+        case DeltaParser::ObjectAddedLine: // object added, either "+@..." or "@..."
+        case DeltaParser::ObjectLine: {
+            Event event;
+            event.type = line.type;
+            event.name = line.name.toString();
+            m_events.append(event);
             break;
         }
-
-        const QList<QByteArray> lines = QByteArray::fromRawData(buffer, count).split('\n');
-        if (!parseLines(lines)) {
-            // stop in case we failed to parse lines
-            return;
+        case DeltaParser::InvalidLine:
+            *errorString = QObject::tr("%1 from %2").arg(parser->errorString(), path());
+            return false;
+        default:
+            *errorString = QObject::tr("Invalid line from %1: '%2'")
+                                    .arg(path(), line.raw.toString());
+            return false;
         }
     }
+    return true;
 }
 
-bool DirWatcher::Private::parseLines(const QList<QByteArray> &lines)
+DirWatcher::Private::Private(DirWatcher *parent)
+    : QObject(parent)
+    , reader(0)
 {
-    foreach (QByteArray line, lines) {
-        // ignore empty lines
-        if (line.isEmpty())
-            continue;
+}
 
-        // parse qualifiers; for now we just recognize and remove them to avoid unnecessary parsing errors
-        if (line.startsWith('[')) {
-            const int closingBrace = line.indexOf(']');
-            if (closingBrace == -1) {
-                errorString = QObject::tr("Invalid format (no closing brace ']') from %1: '%2'")
-                                        .arg(path, QString::fromLocal8Bit(line));
-                return false;
-            }
-            line.remove(0, closingBrace + 1);
-        }
+DirWatcher::Private::~Private()
+{
+}
 
-        if (line.startsWith('-')) { // object removed, "-@<objectName>"
-            const QString name = QString::fromLocal8Bit(line.mid(2));
+void DirWatcher::Private::deliverEvents()
+{
+    const QString readError = reader->takeErrorString();
+    if (!readError.isEmpty())
+        errorString = readError;
 
-            cache.remove(name);
+    Q_FOREACH (const DirectoryReader::Event &event, reader->takeEvents()) {
+        if (event.type == DeltaParser::ObjectRemovedLine) {
+            cache.remove(event.name);
 
-            emit q()->objectRemoved(name);
-        } else if (line.startsWith('+') || line.startsWith('@')) { // object added, either "+@..." or "@..."
-            const bool hasPlus = line.startsWith('+');
-            const QString name = QString::fromLocal8Bit(line.mid(hasPlus ? 2 : 1));
+            emit q()->objectRemoved(event.name);
+            continue;
+        }
 
-            // There is a bug in PPS: when n objects already exist in the directory, PPS reports n objects n times
-            // for n^2 updates total. While we can't do much about the performance issue, we can filter out the
-            // redundant updates.
-            if (!hasPlus && cache.contains(name)) // duplicate in initial listing
-                continue;
+        // There is a bug in PPS: when n objects already exist in the directory, PPS reports n objects n times
+        // for n^2 updates total. While we can't do much about the performance issue, we can filter out the
+        // redundant updates.
+        if (event.type == DeltaParser::ObjectLine && cache.contains(event.name)) // duplicate in initial listing
+            continue;
 
-            cache.insert(name);
+        cache.insert(event.name);
 
-            emit q()->objectAdded(name);
-        } else {
-            errorString = QObject::tr("Invalid line from %1: '%2'")
-                                    .arg(path, QString::fromLocal8Bit(line));
-            return false;
-        }
+        emit q()->objectAdded(event.name);
     }
-    return true;
 }
 
 DirWatcher::DirWatcher(const QString &path, QObject *parent)
@@ -103,26 +98,30 @@ DirWatcher::DirWatcher(const QString &path, QObject *parent)
     d->path = path;
 
     const QString openPath = path + QStringLiteral("/.all?deltadir");
+#ifdef QPPS_SERVER_BUILD
+    const int fd = ServerClient::open(openPath.toLocal8Bit(), O_RDONLY);
+#else
     const int fd = ::open(openPath.toLocal8Bit(), O_RDONLY);
+#endif
     if (fd == -1) {
         d->errorString = QObject::tr("Unable to open %1: %2").arg(d->path, QString::fromLocal8Bit(strerror(errno)));
         return;
     }
 
-    d->notifier = new QSocketNotifier(fd, QSocketNotifier::Read, d);
-    d->notifier->setParent(d);
-    connect(d->notifier, SIGNAL(activated(int)), d, SLOT(readData()));
+    d->reader = new DirectoryReader(fd, path, d, "deliverEvents");
+    Reactor::self()->attach(d->reader);
 }
 
 DirWatcher::~DirWatcher()
 {
-    if (d->notifier)
-        ::close(d->notifier->socket());
+    // closes the file descriptor
+    if (d->reader)
+        Reactor::self()->detach(d->reader);
 }
 
 bool DirWatcher::isValid() const
 {
-    return d->notifier != 0;
+    return d->reader != 0;
 }
 
 QString DirWatcher::errorString() const
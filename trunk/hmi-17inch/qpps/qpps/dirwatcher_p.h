@@ -2,13 +2,41 @@
 #define QPPS_DIRWATCHER_P_H
 
 #include "dirwatcher.h"
+#include "reactor_p.h"
 
 #include <QSet>
-#include <QSocketNotifier>
 
 namespace QPps
 {
 
+/**
+ * @short Reader for the object listing of a PPS directory
+ *
+ * Added and removed objects are handed out in the order they were read by takeEvents().
+ */
+class DirectoryReader : public ReactorReader
+{
+    Q_OBJECT
+
+public:
+    struct Event
+    {
+        DeltaParser::LineType type; ///< ObjectLine, ObjectAddedLine or ObjectRemovedLine
+        QString name;
+    };
+
+    DirectoryReader(int fd, const QString &path, QObject *receiver, const char *deliverSlot);
+
+    /// Returns the events parsed since the last call, oldest first
+    QList<Event> takeEvents();
+
+protected:
+    bool parseLines(DeltaParser *parser, QString *errorString);
+
+private:
+    QList<Event> m_events;
+};
+
 class DirWatcher::Private : public QObject
 {
     Q_OBJECT
@@ -17,17 +45,15 @@ public:
     Private(DirWatcher *parent);
     ~Private();
 
-    /// @return False in case the parsing failed, else True
-    bool parseLines(const QList<QByteArray> &lines);
-
     DirWatcher *q() const { return static_cast<DirWatcher *>(parent()); }
     QString path;
     QString errorString;
-    QSocketNotifier *notifier;
+    DirectoryReader *reader;
     QSet<QString> cache;
 
 public Q_SLOTS:
-    void readData();
+    /// Takes the events that the reactor thread has parsed and emits them
+    void deliverEvents();
 };
 
 }
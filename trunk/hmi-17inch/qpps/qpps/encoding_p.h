@@ -0,0 +1,44 @@
+#ifndef QPPS_ENCODING_P_H
+#define QPPS_ENCODING_P_H
+
+#include "deltaparser_p.h"
+
+#include <QByteArray>
+
+namespace QPps
+{
+
+/**
+ * Returns @p encoding as a QByteArray, without allocating for the encodings that are commonly used.
+ */
+inline QByteArray encodingToByteArray(const ByteRef &encoding)
+{
+    switch (encoding.size) {
+    case 0:
+        return QByteArray();
+    case 1:
+        if (encoding == "n")
+            return QByteArrayLiteral("n");
+        if (encoding == "s")
+            return QByteArrayLiteral("s");
+        if (encoding == "b")
+            return QByteArrayLiteral("b");
+        break;
+    case 3:
+        if (encoding == "b64")
+            return QByteArrayLiteral("b64");
+        break;
+    case 4:
+        if (encoding == "json")
+            return QByteArrayLiteral("json");
+        break;
+    default:
+        break;
+    }
+
+    return encoding.toByteArray();
+}
+
+}
+
+#endif
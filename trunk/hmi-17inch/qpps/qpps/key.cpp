@@ -0,0 +1,167 @@
+#include "key.h"
+
+#include <QHash>
+#include <QReadWriteLock>
+
+#include <string.h>
+
+using namespace QPps;
+
+namespace {
+
+/**
+ * Holds all interned names.
+ *
+ * Names are indexed twice: by QString for lookups coming from the public API, and by their
+ * raw bytes in an open addressing table, so that the delta parser can look up a name straight
+ * from its read buffer without creating a QString first.
+ */
+class KeyRegistry
+{
+public:
+    KeyRegistry()
+        : m_buckets(64, Key::Invalid)
+    {
+    }
+
+    int intern(const QString &name, const QByteArray &bytes)
+    {
+        {
+            QReadLocker locker(&m_lock);
+            const int key = m_byName.value(name, Key::Invalid);
+            if (key != Key::Invalid)
+                return key;
+        }
+
+        QWriteLocker locker(&m_lock);
+
+        // somebody else might have been faster
+        const int existing = m_byName.value(name, Key::Invalid);
+        if (existing != Key::Invalid)
+            return existing;
+
+        const int key = m_names.size();
+        m_names.append(name);
+        m_bytes.append(bytes);
+        m_byName.insert(name, key);
+
+        if (m_names.size() * 2 > m_buckets.size())
+            rehash(m_buckets.size() * 2);
+        else
+            insertBucket(key);
+
+        return key;
+    }
+
+    int lookup(const QString &name) const
+    {
+        QReadLocker locker(&m_lock);
+        return m_byName.value(name, Key::Invalid);
+    }
+
+    int lookup(const char *data, int size) const
+    {
+        const uint hash = hashBytes(data, size);
+
+        QReadLocker locker(&m_lock);
+        const int mask = m_buckets.size() - 1;
+        for (int i = hash & mask; ; i = (i + 1) & mask) {
+            const int key = m_buckets.at(i);
+            if (key == Key::Invalid)
+                return Key::Invalid;
+
+            const QByteArray &bytes = m_bytes.at(key);
+            if (bytes.size() == size && memcmp(bytes.constData(), data, size) == 0)
+                return key;
+        }
+    }
+
+    QString name(int key) const
+    {
+        QReadLocker locker(&m_lock);
+        return (key >= 0 && key < m_names.size()) ? m_names.at(key) : QString();
+    }
+
+private:
+    // FNV-1a, good enough for short attribute names
+    static uint hashBytes(const char *data, int size)
+    {
+        uint hash = 2166136261u;
+        for (int i = 0; i < size; ++i) {
+            hash ^= static_cast<uchar>(data[i]);
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    void insertBucket(int key)
+    {
+        const QByteArray &bytes = m_bytes.at(key);
+        const int mask = m_buckets.size() - 1;
+        int i = hashBytes(bytes.constData(), bytes.size()) & mask;
+        while (m_buckets.at(i) != Key::Invalid)
+            i = (i + 1) & mask;
+        m_buckets[i] = key;
+    }
+
+    void rehash(int bucketCount)
+    {
+        m_buckets.fill(Key::Invalid, bucketCount);
+        for (int key = 0; key < m_bytes.size(); ++key)
+            insertBucket(key);
+    }
+
+    mutable QReadWriteLock m_lock;
+    QVector<QString> m_names;
+    QVector<QByteArray> m_bytes;
+    QHash<QString, int> m_byName;
+    QVector<int> m_buckets; // size is a power of two, at most half full
+};
+
+}
+
+Q_GLOBAL_STATIC(KeyRegistry, s_registry)
+
+int Key::intern(const QString &name)
+{
+    return s_registry()->intern(name, name.toLocal8Bit());
+}
+
+int Key::intern(const char *name)
+{
+    return s_registry()->intern(QString::fromLatin1(name), QByteArray(name));
+}
+
+int Key::lookup(const QString &name)
+{
+    return s_registry()->lookup(name);
+}
+
+int Key::lookup(const char *data, int size)
+{
+    return s_registry()->lookup(data, size);
+}
+
+QString Key::name(int key)
+{
+    return s_registry()->name(key);
+}
+
+KeyTable::KeyTable(const char * const names[], int count)
+{
+    m_keys.reserve(count);
+
+    int maxKey = -1;
+    for (int i = 0; i < count; ++i) {
+        const int key = Key::intern(names[i]);
+        m_keys.append(key);
+        maxKey = qMax(maxKey, key);
+    }
+
+    m_indexes.fill(-1, maxKey + 1);
+    for (int i = 0; i < count; ++i) {
+        // keep the first position if a name is listed twice
+        if (m_indexes.at(m_keys.at(i)) == -1)
+            m_indexes[m_keys.at(i)] = i;
+    }
+}
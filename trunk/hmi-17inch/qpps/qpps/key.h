@@ -0,0 +1,102 @@
+#ifndef QPPS_KEY_H
+#define QPPS_KEY_H
+
+#include "qpps_export.h"
+
+#include <QString>
+#include <QVector>
+
+namespace QPps
+{
+
+/**
+ * \class Key
+ *
+ * \brief Process wide registry of interned attribute names.
+ *
+ * Every interned attribute name gets a small, dense integer id that stays valid for the
+ * lifetime of the process. The backend looks up the id of every changed attribute once, when
+ * it builds the Changeset, and Object passes it along with Object::attributeKeyChanged(), so
+ * that receivers can dispatch on an integer instead of comparing strings.
+ *
+ * Only names that have been interned explicitly (usually through a KeyTable) get an id,
+ * all other names are reported as Key::Invalid. All methods are thread-safe.
+ */
+class QPPS_EXPORT Key
+{
+public:
+    enum {
+        Invalid = -1 ///< Id of a name that has not been interned
+    };
+
+    /// Returns the id of @p name, registering it if it is not known yet.
+    static int intern(const QString &name);
+
+    /// Returns the id of the Latin-1 encoded @p name, registering it if it is not known yet.
+    static int intern(const char *name);
+
+    /// Returns the id of @p name, or Key::Invalid if it has not been interned.
+    static int lookup(const QString &name);
+
+    /// Returns the id of the local 8 bit encoded name of @p size bytes at @p data, or Key::Invalid if it has not been interned.
+    static int lookup(const char *data, int size);
+
+    /// Returns the name of @p key, or a null string for an unknown id.
+    static QString name(int key);
+};
+
+/**
+ * \class KeyTable
+ *
+ * \brief Maps interned attribute names to a class specific enumeration.
+ *
+ * A KeyTable is meant to be a static member of a class that handles the attributes of a PPS object.
+ * It is created from an array of attribute names whose order matches a local enum, and translates
+ * the ids delivered by Object::attributeKeyChanged() back to that enum in O(1):
+ *
+ * \code
+ * enum SensorKey { Key_speed, Key_rpm };
+ * static const char * const pps_keys[] = { "speed", "rpm" };
+ * static const QPps::KeyTable s_keys(pps_keys, 2);
+ *
+ * void Sensors::Private::ppsAttributeChanged(int key, const QString &, const QPps::Variant &attribute)
+ * {
+ *     switch (s_keys.indexOf(key)) {
+ *     case Key_speed:
+ *         ...
+ *     }
+ * }
+ * \endcode
+ */
+class QPPS_EXPORT KeyTable
+{
+public:
+    /// Interns the @p count Latin-1 encoded attribute @p names.
+    KeyTable(const char * const names[], int count);
+
+    /// Returns the position of the name with id @p key in the table, or -1 if it is not part of it.
+    int indexOf(int key) const
+    {
+        return (key >= 0 && key < m_indexes.size()) ? m_indexes.at(key) : -1;
+    }
+
+    /// Returns the position of @p name in the table, or -1 if it is not part of it.
+    int indexOf(const QString &name) const { return indexOf(Key::lookup(name)); }
+
+    /// Returns the id of the name at @p index
+    int key(int index) const { return m_keys.at(index); }
+
+    /// Returns the name at @p index
+    QString name(int index) const { return Key::name(m_keys.at(index)); }
+
+    /// Returns the number of names in the table
+    int count() const { return m_keys.size(); }
+
+private:
+    QVector<int> m_indexes; // indexed by key id
+    QVector<int> m_keys; // indexed by table position
+};
+
+}
+
+#endif
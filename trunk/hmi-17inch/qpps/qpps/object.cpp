@@ -1,9 +1,17 @@
 #include "object.h"
 #include "object_p.h"
+#include "changesetbatcher_p.h"
+#include "deliverythrottle_p.h"
+#include "reactor_p.h"
+#ifdef QPPS_SERVER_BUILD
+#include "serverclient_p.h"
+#endif
 
 #include <changeset.h>
+#include <key.h>
 
 #include <QList>
+#include <QMetaMethod>
 #include <QStringList>
 
 #include <errno.h>
@@ -14,8 +22,6 @@
 
 using namespace QPps;
 
-static const int QPPS_DEFAULT_PPS_OBJECT_SIZE = 1 << 16;
-
 static int openFlags(Object::PublicationMode mode, bool create)
 {
     int flags = O_RDONLY;
@@ -40,8 +46,13 @@ static int openFlags(Object::PublicationMode mode, bool create)
 
 Object::Private::Private(Object *parent)
     : QObject(parent)
-    , notifier(0)
+    , reader(0)
     , cache(0)
+    , batcher(0)
+    , writeBehindInterval(0)
+    , throttle(0)
+    , receivedUpdates(0)
+    , deliveredUpdates(0)
 {
 }
 
@@ -53,8 +64,13 @@ Object::Private::~Private()
 
 bool Object::Private::writeChanges(const QByteArray &changes)
 {
-    const ssize_t written = ::write(notifier->socket(), changes.constData(), changes.length());
+#ifdef QPPS_SERVER_BUILD
+    // the server connection is a non-blocking socket, which may take a large write in parts
+    const bool ok = ServerClient::write(reader->fd(), changes);
+#else
+    const ssize_t written = ::write(reader->fd(), changes.constData(), changes.length());
     const bool ok = (written == changes.length());
+#endif
 
     if (!ok)
         errorString = QObject::tr("Unable to write data to %1: %2").arg(path, QString::fromLocal8Bit(strerror(errno)));
@@ -62,99 +78,141 @@ bool Object::Private::writeChanges(const QByteArray &changes)
     return ok;
 }
 
-void Object::Private::readData()
+static void appendAssignment(QByteArray *data, const QString &name, const Variant &value)
 {
-    if (!notifier) // if called from setAttributeCacheEnabled
-        return;
+    *data += name.toLocal8Bit();
+    *data += ':';
+    *data += value.encoding();
+    *data += ':';
+    *data += value.value();
+    *data += '\n';
+}
 
-    errorString.clear();
+static void appendRemoval(QByteArray *data, const QString &name)
+{
+    *data += '-';
+    *data += name.toLocal8Bit();
+    *data += '\n';
+}
 
-    char buffer[QPPS_DEFAULT_PPS_OBJECT_SIZE];
+bool Object::Private::writeChangeset(const Changeset &changeset)
+{
+    QByteArray data;
+    data.reserve(64 * (changeset.assignments.size() + changeset.removals.size()));
 
-    forever {
-        const int count = ::read(notifier->socket(), buffer, sizeof(buffer));
-        if (count == -1) {
-            errorString = QObject::tr("Unable to read data from %1: %2").arg(path, QString::fromLocal8Bit(strerror(errno)));
-            return;
-        }
+    QMap<QString, Variant>::ConstIterator it = changeset.assignments.constBegin();
+    for (; it != changeset.assignments.constEnd(); ++it)
+        appendAssignment(&data, it.key(), it.value());
 
-        if (count == 0) {
-            // no more data to read, jump out
-            break;
-        }
+    Q_FOREACH (const QString &removedAttr, changeset.removals)
+        appendRemoval(&data, removedAttr);
+
+    updateCache(changeset);
+    return writeChanges(data);
+}
+
+bool Object::Private::writePending(const QList<ChangesetBatcher::Change> &changes)
+{
+    QByteArray data;
+    data.reserve(64 * changes.size());
 
-        const QList<QByteArray> lines = QByteArray::fromRawData(buffer, count).split('\n');
-        if (!parseLines(lines)) {
-            // stop in case we failed to parse lines
-            return;
+    // in the order the attributes were changed in, a subscriber may rely on it
+    Q_FOREACH (const ChangesetBatcher::Change &change, changes) {
+        if (change.isRemoval) {
+            appendRemoval(&data, change.name);
+            if (cache)
+                cache->remove(change.name);
+        } else {
+            appendAssignment(&data, change.name, change.value);
+            if (cache)
+                cache->insert(change.name, change.value);
         }
     }
+
+    return writeChanges(data);
 }
 
-bool Object::Private::parseLines(const QList<QByteArray> &lines)
+void Object::Private::updateCache(const Changeset &changeset)
 {
-    Changeset changeset;
-    foreach (QByteArray line, lines) {
-        // ignore empty lines
-        if (line.isEmpty())
-            continue;
-
-        // parse [ni] qualifiers; for now we just recognize and remove them to avoid unnecessary parsing errors
-        if (line.startsWith('[')) {
-            const int closingBrace = line.indexOf(']');
-            if (closingBrace == -1) {
-                errorString = QObject::tr("Invalid format (no closing brace ']') from %1: '%2'")
-                                        .arg(path, QString::fromLocal8Bit(line));
-                return false;
-            }
-            line.remove(0, closingBrace + 1);
-        }
+    if (!cache)
+        return;
 
-        // line tells us which object the following attribute changes belong to
-        if (line.startsWith('@')) // object name ### we could compare it to the expected one
-            continue;
+    QMap<QString, Variant>::ConstIterator it = changeset.assignments.constBegin();
+    for (; it != changeset.assignments.constEnd(); ++it)
+        cache->insert(it.key(), it.value());
 
-        if (line.startsWith('-')) { // attribute removed
-            const QString name = QString::fromLocal8Bit(line.mid(1));
+    Q_FOREACH (const QString &removal, changeset.removals)
+        cache->remove(removal);
+}
 
-            if (cache)
-                cache->remove(name);
+void Object::Private::deliverChangesets()
+{
+    if (!reader)
+        return;
 
-            changeset.removals += name;
-        } else { // attribute added or modified
-            const int firstColon = line.indexOf(':');
-            const int secondColon = line.indexOf(':', firstColon + 1);
-            if (firstColon == -1 || secondColon == -1) { // bad format
-                errorString = QObject::tr("Invalid format (no '::' encountered) from %1: '%2'")
-                                        .arg(path, QString::fromLocal8Bit(line));
-                return false;
-            }
+    const QString readError = reader->takeErrorString();
+    if (!readError.isEmpty())
+        errorString = readError;
 
-            const QString name = QString::fromLocal8Bit(line.left(firstColon));
-            const QByteArray encoding = line.mid(firstColon + 1, secondColon - firstColon - 1);
-            const QByteArray value = line.mid(secondColon + 1);
+    Q_FOREACH (const Changeset &changeset, reader->takeChangesets()) {
+        updateCache(changeset);
+        deliverChanges(changeset);
+    }
+}
 
-            Variant variant(value, encoding);
+void Object::Private::deliverChanges(const Changeset &changes)
+{
+    receivedUpdates += changes.assignments.size() + changes.removals.size();
 
-            if (cache)
-                cache->insert(name, variant);
+    if (throttle)
+        emitChanges(throttle->filter(changes));
+    else
+        emitChanges(changes);
+}
 
-            changeset.assignments.insert(name, variant);
-        }
-    }
+void Object::Private::deliverPending()
+{
+    emitChanges(throttle->takeDue());
+}
+
+void Object::Private::emitChanges(const Changeset &changes)
+{
+    if (changes.assignments.isEmpty() && changes.removals.isEmpty())
+        return;
 
-    //emit single attribute notifications
-    for (QMap<QString, Variant>::ConstIterator assignIt = changeset.assignments.constBegin();
-         assignIt != changeset.assignments.constEnd();
-         ++assignIt) {
-        emit q()->attributeChanged(assignIt.key(), assignIt.value());
+    deliveredUpdates += changes.assignments.size() + changes.removals.size();
+
+    // emit single attribute notifications, receivers usually connect to only one of the two signals
+    static const QMetaMethod attributeChangedSignal = QMetaMethod::fromSignal(&Object::attributeChanged);
+    static const QMetaMethod attributeKeyChangedSignal = QMetaMethod::fromSignal(&Object::attributeKeyChanged);
+    const bool emitNamed = q()->isSignalConnected(attributeChangedSignal);
+    const bool emitKeyed = q()->isSignalConnected(attributeKeyChangedSignal);
+
+    if (emitNamed || emitKeyed) {
+        for (QMap<QString, Variant>::ConstIterator assignIt = changes.assignments.constBegin();
+             assignIt != changes.assignments.constEnd();
+             ++assignIt) {
+            if (emitNamed)
+                emit q()->attributeChanged(assignIt.key(), assignIt.value());
+            if (emitKeyed)
+                emit q()->attributeKeyChanged(changes.keys.value(assignIt.key(), Key::Invalid), assignIt.key(), assignIt.value());
+        }
     }
 
-    Q_FOREACH(const QString &removal, changeset.removals)
+    Q_FOREACH(const QString &removal, changes.removals)
         emit q()->attributeRemoved(removal);
 
-    emit q()->attributesChanged(changeset);
-    return true;
+    emit q()->attributesChanged(changes);
+}
+
+DeliveryThrottle *Object::Private::deliveryThrottle()
+{
+    if (!throttle) {
+        throttle = new DeliveryThrottle(this);
+        connect(throttle, SIGNAL(deliveryRequested()), this, SLOT(deliverPending()));
+    }
+
+    return throttle;
 }
 
 /**
@@ -187,21 +245,30 @@ Object::Object(const QString &path, PublicationMode mode, bool create, QObject *
 
     const QString openPath = buildPath(path, QStringLiteral("delta"));
     // the 3rd argument to open() is mandatory with O_CREAT, according to POSIX...
+#ifdef QPPS_SERVER_BUILD
+    const int fd = ServerClient::open(openPath.toLocal8Bit(), openFlags(mode, create));
+#else
     const int perm = S_IRUSR | S_IWUSR | S_IRGRP; // TODO configurable?
     const int fd = ::open(openPath.toLocal8Bit(), openFlags(mode, create), perm);
+#endif
     if (fd == -1) {
         d->errorString = QObject::tr("Unable to open %1: %2").arg(d->path, QString::fromLocal8Bit(strerror(errno)));
         return;
     }
 
-    d->notifier = new QSocketNotifier(fd, QSocketNotifier::Read, d);
-    connect(d->notifier, SIGNAL(activated(int)), d, SLOT(readData()));
+    // reading and parsing happens on the reactor thread, the changesets are delivered to deliverChangesets()
+    d->reader = new ChangesetReader(fd, path, d, "deliverChangesets");
+    Reactor::self()->attach(d->reader);
 }
 
 Object::~Object()
 {
-    if (d->notifier)
-        ::close(d->notifier->socket());
+    // do not lose commands that are still pending in write-behind mode
+    flush();
+
+    // closes the file descriptor
+    if (d->reader)
+        Reactor::self()->detach(d->reader);
 }
 
 bool Object::attributeCacheEnabled() const
@@ -218,7 +285,10 @@ void Object::setAttributeCacheEnabled(bool cacheEnabled)
         d->cache = new QHash<QString, Variant>();
 
         // force initial update, so that we have it as soon as this method returns
-        d->readData();
+        if (d->reader) {
+            Reactor::self()->readNow(d->reader);
+            d->deliverChangesets();
+        }
     } else {
         delete d->cache;
         d->cache = 0;
@@ -227,7 +297,7 @@ void Object::setAttributeCacheEnabled(bool cacheEnabled)
 
 bool Object::isValid() const
 {
-    return d->notifier != 0;
+    return d->reader != 0;
 }
 
 QString Object::errorString() const
@@ -269,27 +339,122 @@ bool Object::setAttribute(const QString &name, const Variant &value)
 bool Object::setAttributes(const Changeset &changeset)
 {
     d->errorString.clear();
-    if (!d->notifier) {
+    if (!d->reader) {
         d->errorString = tr("Object not valid");
         return false;
     }
 
-    QByteArray data;
-
-    QMap<QString, Variant>::ConstIterator it = changeset.assignments.constBegin();
-    for (; it != changeset.assignments.constEnd(); ++it) {
-        if (d->cache)
-            d->cache->insert(it.key(), it.value());
-         data += it.key().toLocal8Bit() + ':' + it.value().encoding() + ':' + it.value().value() + '\n';
+    if (d->batcher) {
+        // attribute() returns what has been set, even before it is written
+        d->updateCache(changeset);
+        d->batcher->add(changeset);
+        return true;
     }
 
-    Q_FOREACH (const QString &removedAttr, changeset.removals) {
-        if (d->cache)
-            d->cache->remove(removedAttr);
-        data += '-' + removedAttr.toLocal8Bit() + '\n';
+    return d->writeChangeset(changeset);
+}
+
+bool Object::writeBehindEnabled() const
+{
+    return d->batcher != 0;
+}
+
+void Object::setWriteBehindEnabled(bool enabled)
+{
+    if (enabled == (d->batcher != 0))
+        return;
+
+    if (enabled) {
+        d->batcher = new ChangesetBatcher(d);
+        d->batcher->setInterval(d->writeBehindInterval);
+        connect(d->batcher, SIGNAL(flushRequested()), this, SLOT(flush()));
+    } else {
+        flush();
+        delete d->batcher;
+        d->batcher = 0;
     }
+}
+
+int Object::writeBehindInterval() const
+{
+    return d->writeBehindInterval;
+}
+
+void Object::setWriteBehindInterval(int msec)
+{
+    d->writeBehindInterval = msec;
+    if (d->batcher)
+        d->batcher->setInterval(msec);
+}
+
+bool Object::hasPendingChanges() const
+{
+    return d->batcher && !d->batcher->isEmpty();
+}
+
+bool Object::flush()
+{
+    if (!d->batcher || d->batcher->isEmpty())
+        return true;
+
+    d->errorString.clear();
+    return d->writePending(d->batcher->take());
+}
+
+bool Object::updateCoalescingEnabled() const
+{
+    return d->throttle && d->throttle->coalescingEnabled();
+}
+
+void Object::setUpdateCoalescingEnabled(bool enabled)
+{
+    d->deliveryThrottle()->setCoalescingEnabled(enabled);
+}
+
+int Object::updateCoalescingInterval() const
+{
+    return d->throttle ? d->throttle->coalescingInterval() : DeliveryThrottle::DefaultCoalescingInterval;
+}
+
+void Object::setUpdateCoalescingInterval(int msec)
+{
+    d->deliveryThrottle()->setCoalescingInterval(msec);
+}
+
+int Object::minimumUpdateInterval(const QString &name) const
+{
+    return d->throttle ? d->throttle->minimumInterval(name) : 0;
+}
+
+void Object::setMinimumUpdateInterval(const QString &name, int msec)
+{
+    d->deliveryThrottle()->setMinimumInterval(name, msec);
+}
 
-    return d->writeChanges(data);
+double Object::updateDeadband(const QString &name) const
+{
+    return d->throttle ? d->throttle->deadband(name) : 0;
+}
+
+void Object::setUpdateDeadband(const QString &name, double deadband)
+{
+    d->deliveryThrottle()->setDeadband(name, deadband);
+}
+
+quint64 Object::receivedUpdates() const
+{
+    return d->receivedUpdates;
+}
+
+quint64 Object::deliveredUpdates() const
+{
+    return d->deliveredUpdates;
+}
+
+void Object::resetUpdateCounters()
+{
+    d->receivedUpdates = 0;
+    d->deliveredUpdates = 0;
 }
 
 bool Object::removeAttribute(const QString &name)
@@ -108,6 +108,135 @@ public:
      */
     bool setAttributes(const Changeset &changes);
 
+    /**
+     * Returns whether write-behind mode is enabled.
+     * The default is false.
+     *
+     * \sa setWriteBehindEnabled()
+     */
+    bool writeBehindEnabled() const;
+
+    /**
+     * When \p enabled is \a true, setAttribute(), removeAttribute() and setAttributes() do not write
+     * to the underlying PPS object immediately. Instead the changes are merged per attribute, so that
+     * only the latest value of each attribute is kept, and written together once
+     * writeBehindInterval() has passed, in the order the attributes were first changed in. This is meant for values driven by UI controls like
+     * sliders, which would otherwise cause a write for every intermediate value.
+     *
+     * The setters return true as long as the object is writable; errors that occur when the pending
+     * changes are written later can be queried with errorString().
+     * attribute() and attributeNames() include the pending changes right away.
+     *
+     * Disabling write-behind mode writes all pending changes.
+     *
+     * \sa flush(), setWriteBehindInterval()
+     */
+    void setWriteBehindEnabled(bool enabled);
+
+    /**
+     * Returns the minimum time in milliseconds between two writes in write-behind mode.
+     *
+     * \sa setWriteBehindInterval()
+     */
+    int writeBehindInterval() const;
+
+    /**
+     * Sets the minimum time in milliseconds between two writes in write-behind mode, e.g. 16
+     * to write at most at 60 Hz. For the default of 0 pending changes are written once per
+     * event loop iteration.
+     *
+     * \sa setWriteBehindEnabled()
+     */
+    void setWriteBehindInterval(int msec);
+
+    /// Returns true if there are changes that have not been written yet in write-behind mode.
+    bool hasPendingChanges() const;
+
+    /**
+     * Returns whether delivery of attribute changes is coalesced.
+     * The default is false.
+     *
+     * \sa setUpdateCoalescingEnabled()
+     */
+    bool updateCoalescingEnabled() const;
+
+    /**
+     * When \p enabled is \a true, attribute changes read from the underlying PPS object are not
+     * emitted right away. Instead they are merged per attribute, so that only the latest value of
+     * each attribute is kept, and emitted together once per updateCoalescingInterval(). This is
+     * meant for attributes that change faster than the UI can show them, e.g. sensor values.
+     *
+     * The attribute cache is not affected, attribute() always returns the latest value.
+     *
+     * \sa setMinimumUpdateInterval(), setUpdateDeadband()
+     */
+    void setUpdateCoalescingEnabled(bool enabled);
+
+    /**
+     * Returns the interval in milliseconds in which coalesced changes are emitted.
+     *
+     * \sa setUpdateCoalescingInterval()
+     */
+    int updateCoalescingInterval() const;
+
+    /**
+     * Sets the interval in milliseconds in which coalesced changes are emitted.
+     * The default of 16 matches a 60 Hz display.
+     *
+     * \sa setUpdateCoalescingEnabled()
+     */
+    void setUpdateCoalescingInterval(int msec);
+
+    /**
+     * Returns the minimum time in milliseconds between two change notifications of attribute \p name.
+     *
+     * \sa setMinimumUpdateInterval()
+     */
+    int minimumUpdateInterval(const QString &name) const;
+
+    /**
+     * Emits changes of attribute \p name at most once every \p msec milliseconds. A change that arrives
+     * earlier is held back until the interval has passed, and replaced if a newer value arrives in
+     * the meantime. 0, the default, disables the limit.
+     *
+     * \sa setUpdateCoalescingEnabled()
+     */
+    void setMinimumUpdateInterval(const QString &name, int msec);
+
+    /**
+     * Returns the deadband of the numeric attribute \p name.
+     *
+     * \sa setUpdateDeadband()
+     */
+    double updateDeadband(const QString &name) const;
+
+    /**
+     * Emits changes of the numeric attribute \p name only if the new value differs from the last
+     * emitted one by at least \p deadband. Smaller changes are dropped. 0, the default, disables
+     * the deadband.
+     *
+     * \sa setUpdateCoalescingEnabled()
+     */
+    void setUpdateDeadband(const QString &name, double deadband);
+
+    /**
+     * Returns the number of attribute changes and removals received from the underlying PPS object.
+     *
+     * \sa deliveredUpdates(), resetUpdateCounters()
+     */
+    quint64 receivedUpdates() const;
+
+    /**
+     * Returns the number of attribute changes and removals that have been emitted. Together with
+     * receivedUpdates() this shows how much work coalescing, minimum intervals and deadbands save.
+     *
+     * \sa receivedUpdates(), resetUpdateCounters()
+     */
+    quint64 deliveredUpdates() const;
+
+    /// Resets receivedUpdates() and deliveredUpdates() to 0.
+    void resetUpdateCounters();
+
 Q_SIGNALS:
     /**
      * Emitted when attributes in the underlying PPS object were changed or removed.
@@ -128,6 +257,20 @@ Q_SIGNALS:
      */
     void attributeChanged(const QString &name, const QPps::Variant &value);
 
+    /**
+     * Emitted together with attributeChanged(), additionally carrying the interned id of the attribute name.
+     *
+     * \p key The id of \p name as returned by Key::lookup(), or Key::Invalid if the name has not been interned
+     * \p name The name of the attribute that has changed
+     * \p value The new value of the attribute
+     *
+     * Connect to this signal and translate \p key with a KeyTable to dispatch on the attribute name
+     * without any string comparisons.
+     *
+     * \sa Key, KeyTable
+     */
+    void attributeKeyChanged(int key, const QString &name, const QPps::Variant &value);
+
     /**
      * Emitted when the attribute \p name was removed from the underlying PPS object.
      */
@@ -153,6 +296,16 @@ public Q_SLOTS:
      */
     bool removeAttribute(const QString &name);
 
+    /**
+     * Writes all changes that are pending in write-behind mode immediately.
+     * Use this for commands that must not be delayed.
+     *
+     * Returns false if writing the changes failed, true otherwise (including when nothing was pending).
+     *
+     * \sa setWriteBehindEnabled()
+     */
+    bool flush();
+
 private:
     class Private;
     Private *d;
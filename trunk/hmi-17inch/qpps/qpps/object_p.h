@@ -2,13 +2,17 @@
 #define QPPS_OBJECT_P_H
 
 #include "object.h"
+#include "changesetbatcher_p.h"
 
 #include <QHash>
-#include <QSocketNotifier>
+#include <QList>
 
 namespace QPps
 {
 
+class ChangesetReader;
+class DeliveryThrottle;
+
 class Object::Private : public QObject
 {
     Q_OBJECT
@@ -19,17 +23,39 @@ public:
 
     bool writeChanges(const QByteArray &changes);
 
-    /// @return False in case the parsing failed, else True
-    bool parseLines(const QList<QByteArray> &lines);
+    /// Serializes @p changeset, updates the cache and writes it
+    bool writeChangeset(const Changeset &changeset);
+
+    /// Serializes the pending @p changes of write-behind mode in their order, updates the cache and writes them
+    bool writePending(const QList<ChangesetBatcher::Change> &changes);
+
+    /// Applies @p changeset to the cache, if enabled
+    void updateCache(const Changeset &changeset);
+
+    /// Passes @p changes read from the PPS object through the throttle, if any, and emits them
+    void deliverChanges(const Changeset &changes);
+
+    /// Emits the signals for @p changes
+    void emitChanges(const Changeset &changes);
+
+    /// Returns the throttle, creating it on first use
+    DeliveryThrottle *deliveryThrottle();
 
     Object *q() const { return static_cast<Object *>(parent()); }
     QString path;
     QString errorString;
-    QSocketNotifier *notifier;
+    ChangesetReader *reader;
     QHash<QString, Variant> *cache;
+    ChangesetBatcher *batcher;
+    int writeBehindInterval;
+    DeliveryThrottle *throttle;
+    quint64 receivedUpdates;
+    quint64 deliveredUpdates;
 
 public Q_SLOTS:
-    void readData();
+    /// Takes the changesets that the reactor thread has parsed and delivers them
+    void deliverChangesets();
+    void deliverPending();
 };
 
 }
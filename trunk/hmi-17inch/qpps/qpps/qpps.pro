@@ -12,21 +12,40 @@ INSTALLS += target
 
 QT -= gui
 
-!qnx {
+# qmake CONFIG+=pps_server builds the QNX backend on Linux, talking to qppsserver instead of /pps
+!qnx:!pps_server {
     CONFIG += simulator_build
 }
 
 DEFINES += MAKE_QPPS_LIB QT_NO_CAST_FROM_ASCII QT_NO_CAST_TO_ASCII QT_NO_URL_CAST_FROM_STRING
 
 SOURCES += \
+    changesetbatcher.cpp \
+    deliverythrottle.cpp \
+    deltaparser.cpp \
+    key.cpp \
+    servicewaiter.cpp \
     variant.cpp
 
 HEADERS += \
     changeset.h \
+    changesetbatcher_p.h \
+    deliverythrottle_p.h \
+    deltaparser_p.h \
     dirwatcher.h \
+    encoding_p.h \
+    key.h \
     object.h \
+    servicewaiter.h \
+    servicewaiter_p.h \
     variant.h
 
+# reads file descriptors, used by the QNX backend
+unix {
+    SOURCES += reactor.cpp
+    HEADERS += reactor_p.h
+}
+
 simulator_build {
     DEFINES += SIMULATOR_BUILD
     SOURCES += \
@@ -49,4 +68,10 @@ simulator_build {
         object_p.h
 }
 
+pps_server {
+    DEFINES += QPPS_SERVER_BUILD
+    SOURCES += serverclient.cpp
+    HEADERS += serverclient_p.h
+}
+
 OTHER_FILES += Mainpage.dox
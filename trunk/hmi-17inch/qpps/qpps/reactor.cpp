@@ -0,0 +1,211 @@
+#include "reactor_p.h"
+
+#include "encoding_p.h"
+#include "key.h"
+
+#include <QSocketNotifier>
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+using namespace QPps;
+
+ReactorReader::ReactorReader(int fd, const QString &path, QObject *receiver, const char *deliverSlot)
+    : m_fd(fd)
+    , m_path(path)
+    , m_receiver(receiver)
+    , m_deliverSlot(deliverSlot)
+    , m_deliveryRequested(false)
+    , m_notifier(0)
+{
+}
+
+ReactorReader::~ReactorReader()
+{
+    // stop watching before the descriptor is gone
+    delete m_notifier;
+    m_notifier = 0;
+
+    if (m_fd != -1)
+        ::close(m_fd);
+}
+
+QString ReactorReader::takeErrorString()
+{
+    QMutexLocker locker(&m_mutex);
+
+    QString errorString;
+    qSwap(errorString, m_errorString);
+    return errorString;
+}
+
+void ReactorReader::start()
+{
+    m_notifier = new QSocketNotifier(m_fd, QSocketNotifier::Read, this);
+    connect(m_notifier, SIGNAL(activated(int)), this, SLOT(readData()));
+}
+
+void ReactorReader::readData()
+{
+    forever {
+        // read straight into the parser's buffer, behind a possibly incomplete line from the last read
+        const int capacity = m_parser.writeCapacity();
+        const int count = ::read(m_fd, m_parser.writePointer(), capacity);
+        if (count == -1) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) // non-blocking descriptor without more data
+                break;
+
+            QMutexLocker locker(&m_mutex);
+            m_errorString = QObject::tr("Unable to read data from %1: %2").arg(m_path, QString::fromLocal8Bit(strerror(errno)));
+            requestDelivery();
+            return;
+        }
+
+        if (count == 0) {
+            // no more data to read, jump out
+            break;
+        }
+
+        m_parser.commit(count);
+
+        QMutexLocker locker(&m_mutex);
+        QString errorString;
+        const bool ok = parseLines(&m_parser, &errorString);
+        m_parser.compact();
+        if (!ok)
+            m_errorString = errorString;
+
+        requestDelivery();
+
+        if (!ok) {
+            // stop in case we failed to parse lines
+            return;
+        }
+    }
+}
+
+void ReactorReader::requestDelivery()
+{
+    // one pending invocation is enough, the receiver takes everything that has been collected until then
+    if (!m_receiver || m_deliveryRequested)
+        return;
+
+    m_deliveryRequested = true;
+    QMetaObject::invokeMethod(m_receiver, m_deliverSlot, Qt::QueuedConnection);
+}
+
+/**
+ * Returns the attribute @p name as a QString, sharing the string of interned names.
+ * @p key is set to the id of the name, or Key::Invalid.
+ */
+static QString attributeName(const ByteRef &name, int *key)
+{
+    *key = Key::lookup(name.data, name.size);
+    return (*key != Key::Invalid) ? Key::name(*key) : name.toString();
+}
+
+ChangesetReader::ChangesetReader(int fd, const QString &path, QObject *receiver, const char *deliverSlot)
+    : ReactorReader(fd, path, receiver, deliverSlot)
+{
+}
+
+QList<Changeset> ChangesetReader::takeChangesets()
+{
+    QMutexLocker locker(&m_mutex);
+    deliveryTaken();
+
+    QList<Changeset> changesets;
+    changesets.swap(m_changesets);
+    return changesets;
+}
+
+bool ChangesetReader::parseLines(DeltaParser *parser, QString *errorString)
+{
+    Changeset changeset;
+    DeltaParser::Line line;
+    int key;
+    while (parser->nextLine(&line)) {
+        switch (line.type) {
+        case DeltaParser::ObjectLine:
+            // line tells us which object the following attribute changes belong to
+            // ### we could compare it to the expected one
+            break;
+        case DeltaParser::RemovalLine:
+            changeset.removals += attributeName(line.name, &key);
+            break;
+        case DeltaParser::AssignmentLine: {
+            // the value is the only copy, names of interned keys and common encodings are shared
+            const QString name = attributeName(line.name, &key);
+            changeset.assignments.insert(name, Variant(line.value.toByteArray(), encodingToByteArray(line.encoding)));
+            if (key != Key::Invalid)
+                changeset.keys.insert(name, key);
+            break;
+        }
+        case DeltaParser::InvalidLine:
+            *errorString = QObject::tr("%1 from %2").arg(parser->errorString(), path());
+            return false;
+        default:
+            *errorString = QObject::tr("Invalid line from %1: '%2'").arg(path(), line.raw.toString());
+            return false;
+        }
+    }
+
+    if (!changeset.assignments.isEmpty() || !changeset.removals.isEmpty())
+        m_changesets.append(changeset);
+
+    return true;
+}
+
+Q_GLOBAL_STATIC(Reactor, s_reactor)
+
+Reactor::Reactor()
+{
+    m_thread.setObjectName(QStringLiteral("QPpsReactor"));
+}
+
+Reactor::~Reactor()
+{
+    m_thread.quit();
+    m_thread.wait();
+}
+
+Reactor *Reactor::self()
+{
+    return s_reactor();
+}
+
+void Reactor::attach(ReactorReader *reader)
+{
+    {
+        QMutexLocker locker(&m_startMutex);
+        if (!m_thread.isRunning())
+            m_thread.start();
+    }
+
+    reader->moveToThread(&m_thread);
+    QMetaObject::invokeMethod(reader, "start", Qt::QueuedConnection);
+}
+
+void Reactor::detach(ReactorReader *reader)
+{
+    {
+        QMutexLocker locker(&reader->m_mutex);
+        reader->m_receiver = 0;
+    }
+
+    reader->deleteLater();
+}
+
+void Reactor::readNow(ReactorReader *reader)
+{
+    if (QThread::currentThread() == &m_thread)
+        reader->readData();
+    else
+        QMetaObject::invokeMethod(reader, "readData", Qt::BlockingQueuedConnection);
+}
+
+QThread *Reactor::thread()
+{
+    return &m_thread;
+}
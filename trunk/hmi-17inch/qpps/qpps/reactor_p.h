@@ -0,0 +1,144 @@
+#ifndef QPPS_REACTOR_P_H
+#define QPPS_REACTOR_P_H
+
+#include "qpps_export.h"
+
+#include "changeset.h"
+#include "deltaparser_p.h"
+
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QThread>
+
+class QSocketNotifier;
+
+namespace QPps
+{
+
+/**
+ * @short Reads and parses a PPS file descriptor on the reactor thread
+ *
+ * A reader owns its file descriptor. Once attached to the Reactor, all reading and parsing
+ * happens on the reactor thread; subclasses collect the parsed results in parseLines() and
+ * hand them out to the receiver's thread in a take...() method.
+ *
+ * Whenever new results are available, the receiver's @p deliverSlot is invoked through a queued
+ * connection. Results that arrive before the receiver got around to take them are collected
+ * and delivered in the same batch, so a busy receiver gets one call per event loop iteration
+ * instead of one per read.
+ */
+class QPPS_EXPORT ReactorReader : public QObject
+{
+    Q_OBJECT
+
+public:
+    ReactorReader(int fd, const QString &path, QObject *receiver, const char *deliverSlot);
+    ~ReactorReader();
+
+    int fd() const { return m_fd; }
+    QString path() const { return m_path; }
+
+    /// Returns and clears the last read or parse error, thread-safe
+    QString takeErrorString();
+
+protected:
+    /**
+     * Consumes all complete lines available in @p parser. Runs on the reactor thread with
+     * m_mutex locked.
+     *
+     * @return False in case the parsing failed, in which case @p errorString describes the problem.
+     */
+    virtual bool parseLines(DeltaParser *parser, QString *errorString) = 0;
+
+    /// Must be called by the take...() methods of subclasses, with m_mutex locked
+    void deliveryTaken() { m_deliveryRequested = false; }
+
+    /// Guards everything that is shared with the receiver's thread
+    mutable QMutex m_mutex;
+
+private Q_SLOTS:
+    void start();
+    void readData();
+
+private:
+    friend class Reactor;
+
+    void requestDelivery();
+
+    const int m_fd;
+    const QString m_path;
+    QObject *m_receiver; // guarded by m_mutex, reset by Reactor::detach()
+    const char *m_deliverSlot;
+    bool m_deliveryRequested;
+    QString m_errorString;
+    QSocketNotifier *m_notifier;
+    DeltaParser m_parser;
+};
+
+/**
+ * @short Reader for the attributes of a PPS object
+ *
+ * Every read results in one changeset; they are handed out in order by takeChangesets().
+ */
+class QPPS_EXPORT ChangesetReader : public ReactorReader
+{
+    Q_OBJECT
+
+public:
+    ChangesetReader(int fd, const QString &path, QObject *receiver, const char *deliverSlot);
+
+    /// Returns the changesets parsed since the last call, oldest first
+    QList<Changeset> takeChangesets();
+
+protected:
+    bool parseLines(DeltaParser *parser, QString *errorString);
+
+private:
+    QList<Changeset> m_changesets;
+};
+
+/**
+ * @short The I/O thread that reads all PPS file descriptors of the process
+ *
+ * Instead of every Object and DirWatcher watching its file descriptor on the thread it lives in
+ * (usually the GUI thread), all of them are watched by the event dispatcher of a single reactor
+ * thread, which waits for all of them at once, reads and parses the deltas and posts the parsed
+ * results back. The thread is started when the first reader is attached.
+ */
+class QPPS_EXPORT Reactor
+{
+public:
+    Reactor();
+    ~Reactor();
+
+    static Reactor *self();
+
+    /// Moves @p reader to the reactor thread and starts watching its file descriptor
+    void attach(ReactorReader *reader);
+
+    /**
+     * Stops delivering results of @p reader and deletes it on the reactor thread, which also
+     * closes its file descriptor. Results that have not been taken yet are dropped.
+     */
+    void detach(ReactorReader *reader);
+
+    /**
+     * Reads and parses everything that is available on the file descriptor of @p reader right
+     * now, and blocks until that is done. The results can be taken right after.
+     */
+    void readNow(ReactorReader *reader);
+
+    /// Returns the reactor thread
+    QThread *thread();
+
+private:
+    Q_DISABLE_COPY(Reactor)
+
+    QThread m_thread;
+    QMutex m_startMutex;
+};
+
+}
+
+#endif
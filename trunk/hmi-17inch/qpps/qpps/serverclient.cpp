@@ -0,0 +1,158 @@
+#include "serverclient_p.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace QPps;
+
+static int connectToServer()
+{
+    const QByteArray path = ServerClient::socketPath();
+
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.size() >= int(sizeof(address.sun_path))) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    memcpy(address.sun_path, path.constData(), path.size());
+
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd == -1)
+        return -1;
+
+    if (::connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == -1) {
+        const int error = errno;
+        ::close(fd);
+        errno = error;
+        return -1;
+    }
+
+    return fd;
+}
+
+/**
+ * Sends @p request and waits for the reply. The reply is read byte by byte, so that none of the
+ * PPS data that follows it is consumed.
+ */
+static bool sendRequest(int fd, const QByteArray &request)
+{
+    if (!ServerClient::write(fd, request))
+        return false;
+
+    QByteArray reply;
+    forever {
+        char c;
+        const ssize_t count = ::read(fd, &c, 1);
+        if (count == -1 && errno == EINTR)
+            continue;
+        if (count <= 0) {
+            if (count == 0)
+                errno = ECONNRESET;
+            return false;
+        }
+        if (c == '\n')
+            break;
+        reply += c;
+    }
+
+    if (reply == "ok")
+        return true;
+
+    if (reply.startsWith("error ")) {
+        errno = reply.mid(6).toInt();
+        return false;
+    }
+
+    errno = EPROTO;
+    return false;
+}
+
+QByteArray ServerClient::socketPath()
+{
+    const QByteArray path = qgetenv("QPPS_SERVER_SOCKET");
+    return path.isEmpty() ? QByteArrayLiteral("/tmp/qppsserver") : path;
+}
+
+int ServerClient::open(const QByteArray &path, int flags)
+{
+    QByteArray mode;
+    switch (flags & O_ACCMODE) {
+    case O_WRONLY:
+        mode = "w"; break;
+    case O_RDWR:
+        mode = "rw"; break;
+    default:
+        mode = "r"; break;
+    }
+
+    if (flags & O_CREAT)
+        mode += 'c';
+
+    const int fd = connectToServer();
+    if (fd == -1)
+        return -1;
+
+    if (!sendRequest(fd, "open " + mode + ' ' + path + '\n')) {
+        const int error = errno;
+        ::close(fd);
+        errno = error;
+        return -1;
+    }
+
+    // PPS reads do not block when there is no new data, neither should ours
+    ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+    return fd;
+}
+
+bool ServerClient::unlink(const QByteArray &path)
+{
+    const int fd = connectToServer();
+    if (fd == -1)
+        return false;
+
+    const bool ok = sendRequest(fd, "unlink " + path + '\n');
+
+    const int error = errno;
+    ::close(fd);
+    errno = error;
+
+    return ok;
+}
+
+bool ServerClient::write(int fd, const QByteArray &data)
+{
+    const char *begin = data.constData();
+    const char *end = begin + data.size();
+
+    while (begin < end) {
+        const ssize_t count = ::write(fd, begin, end - begin);
+        if (count >= 0) {
+            begin += count;
+            continue;
+        }
+
+        if (errno == EINTR)
+            continue;
+
+        if (errno != EAGAIN && errno != EWOULDBLOCK)
+            return false;
+
+        // socket buffer is full, wait until the server caught up
+        pollfd pfd;
+        pfd.fd = fd;
+        pfd.events = POLLOUT;
+        pfd.revents = 0;
+        if (::poll(&pfd, 1, -1) == -1 && errno != EINTR)
+            return false;
+    }
+
+    return true;
+}
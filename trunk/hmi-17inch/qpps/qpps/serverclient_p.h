@@ -0,0 +1,52 @@
+#ifndef QPPS_SERVERCLIENT_P_H
+#define QPPS_SERVERCLIENT_P_H
+
+#include "qpps_export.h"
+
+#include <QByteArray>
+
+namespace QPps
+{
+
+/**
+ * @short Opens PPS objects served by qppsserver instead of the PPS file system
+ *
+ * Used by Object and DirWatcher on Linux builds with CONFIG+=pps_server, so that the code that
+ * reads, parses and writes PPS file descriptors can run off-target.
+ *
+ * The protocol is line based. A client connects to the unix socket at socketPath() and sends
+ * one request:
+ * \code
+ * open <r|w|rw>[c] <path>[?<options>]\n
+ * unlink <path>\n
+ * \endcode
+ * where @c c requests creation of a missing object. The server replies with @c ok or
+ * <tt>error <errno></tt>. After a successful @c open, the connection behaves like a PPS file
+ * descriptor opened with the same path and flags: the server sends the object in PPS format,
+ * and the client writes attribute changes in the same format. After @c unlink the server
+ * closes the connection.
+ */
+class QPPS_EXPORT ServerClient
+{
+public:
+    /// Returns the socket path of the server, $QPPS_SERVER_SOCKET or /tmp/qppsserver
+    static QByteArray socketPath();
+
+    /**
+     * Opens @p path with the open() @p flags O_RDONLY, O_WRONLY, O_RDWR and O_CREAT.
+     * Reading the returned descriptor does not block.
+     *
+     * @return The file descriptor, or -1 with errno set.
+     */
+    static int open(const QByteArray &path, int flags);
+
+    /// Removes the object at @p path. Returns false with errno set on failure.
+    static bool unlink(const QByteArray &path);
+
+    /// Writes all of @p data to the non-blocking @p fd, waiting for room if needed
+    static bool write(int fd, const QByteArray &data);
+};
+
+}
+
+#endif
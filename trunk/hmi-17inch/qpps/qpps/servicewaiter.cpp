@@ -0,0 +1,188 @@
+#include "servicewaiter.h"
+#include "servicewaiter_p.h"
+
+#include "dirwatcher.h"
+
+#include <QDebug>
+#include <QTimer>
+
+using namespace QPps;
+
+/// First interval for retrying to open a directory that does not exist yet, doubled on every retry
+static const int MIN_RETRY_INTERVAL = 100;
+static const int MAX_RETRY_INTERVAL = 2000;
+
+static QString directoryOf(const QString &objectPath)
+{
+    return objectPath.left(objectPath.lastIndexOf(QLatin1Char('/')));
+}
+
+ServiceWaiter::Private::Private(ServiceWaiter *parent)
+    : QObject(parent)
+    , timeoutTimer(new QTimer(this))
+    , retryTimer(new QTimer(this))
+    , retryInterval(MIN_RETRY_INTERVAL)
+    , singleShot(true)
+    , ready(false)
+{
+    timeoutTimer->setSingleShot(true);
+    connect(timeoutTimer, &QTimer::timeout, this, &Private::timeout);
+
+    retryTimer->setSingleShot(true);
+    connect(retryTimer, &QTimer::timeout, this, &Private::openWatchers);
+}
+
+ServiceWaiter::Private::~Private()
+{
+}
+
+void ServiceWaiter::Private::init(const QStringList &paths)
+{
+    objectPaths = paths;
+    Q_FOREACH (const QString &path, paths) {
+        missing.insert(path);
+        directories.insert(directoryOf(path));
+    }
+
+    openWatchers();
+}
+
+void ServiceWaiter::Private::openWatchers()
+{
+    QSet<QString> unwatched = directories;
+    Q_FOREACH (const QString &directory, watchers)
+        unwatched.remove(directory);
+
+    bool retry = false;
+    Q_FOREACH (const QString &directory, unwatched) {
+        DirWatcher *watcher = new DirWatcher(directory, this);
+        if (!watcher->isValid()) {
+            // the service has not created its directory yet
+            delete watcher;
+            retry = true;
+            continue;
+        }
+
+        watchers.insert(watcher, directory);
+        connect(watcher, &DirWatcher::objectAdded, this, &Private::objectAdded);
+        connect(watcher, &DirWatcher::objectRemoved, this, &Private::objectRemoved);
+    }
+
+    if (retry) {
+        retryTimer->start(retryInterval);
+        retryInterval = qMin(retryInterval * 2, MAX_RETRY_INTERVAL);
+    }
+}
+
+void ServiceWaiter::Private::stopWatching()
+{
+    retryTimer->stop();
+    timeoutTimer->stop();
+
+    // called from the signals of the watchers
+    Q_FOREACH (DirWatcher *watcher, watchers.keys()) {
+        watcher->disconnect(this);
+        watcher->deleteLater();
+    }
+    watchers.clear();
+    directories.clear();
+}
+
+void ServiceWaiter::Private::objectAdded(const QString &name)
+{
+    DirWatcher *watcher = static_cast<DirWatcher *>(sender());
+    const QString path = watchers.value(watcher) + QLatin1Char('/') + name;
+    if (!missing.remove(path))
+        return;
+
+    emit q()->objectReady(path);
+
+    if (!missing.isEmpty())
+        return;
+
+    ready = true;
+    if (singleShot)
+        stopWatching();
+    else
+        timeoutTimer->stop();
+
+    emit q()->ready();
+}
+
+void ServiceWaiter::Private::objectRemoved(const QString &name)
+{
+    DirWatcher *watcher = static_cast<DirWatcher *>(sender());
+    const QString path = watchers.value(watcher) + QLatin1Char('/') + name;
+    if (missing.contains(path) || !objectPaths.contains(path))
+        return;
+
+    missing.insert(path);
+
+    if (ready) {
+        ready = false;
+        emit q()->lost(path);
+    }
+}
+
+void ServiceWaiter::Private::timeout()
+{
+    if (ready)
+        return;
+
+    qWarning() << Q_FUNC_INFO << "Still waiting for PPS objects:" << q()->missingObjectPaths();
+    emit q()->timedOut();
+}
+
+ServiceWaiter::ServiceWaiter(const QStringList &objectPaths, QObject *parent)
+    : QObject(parent)
+    , d(new Private(this))
+{
+    d->init(objectPaths);
+}
+
+ServiceWaiter::ServiceWaiter(const QString &objectPath, QObject *parent)
+    : QObject(parent)
+    , d(new Private(this))
+{
+    d->init(QStringList(objectPath));
+}
+
+ServiceWaiter::~ServiceWaiter()
+{
+}
+
+QStringList ServiceWaiter::objectPaths() const
+{
+    return d->objectPaths;
+}
+
+QStringList ServiceWaiter::missingObjectPaths() const
+{
+    QStringList paths;
+    Q_FOREACH (const QString &path, d->objectPaths) {
+        if (d->missing.contains(path))
+            paths.append(path);
+    }
+    return paths;
+}
+
+bool ServiceWaiter::isReady() const
+{
+    return d->ready;
+}
+
+void ServiceWaiter::setTimeout(int msecs)
+{
+    if (!d->ready)
+        d->timeoutTimer->start(msecs);
+}
+
+bool ServiceWaiter::isSingleShot() const
+{
+    return d->singleShot;
+}
+
+void ServiceWaiter::setSingleShot(bool singleShot)
+{
+    d->singleShot = singleShot;
+}
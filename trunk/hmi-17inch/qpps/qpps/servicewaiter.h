@@ -0,0 +1,108 @@
+#ifndef QPPS_SERVICEWAITER_H
+#define QPPS_SERVICEWAITER_H
+
+#include "qpps_export.h"
+
+#include <QObject>
+#include <QStringList>
+
+namespace QPps
+{
+
+/**
+ * \class ServiceWaiter
+ *
+ * \brief Waits for the PPS objects of a service to exist.
+ *
+ * Services publish their PPS objects once they are up, which can be long after the HMI started on a slow boot.
+ * ServiceWaiter watches the directories of the objects with a DirWatcher and emits ready() once all of them exist,
+ * without blocking the event loop. If a directory does not exist yet either, opening it is retried with a backoff.
+ *
+ * \code
+    m_waiter = new QPps::ServiceWaiter(QStringList() << QStringLiteral("/pps/services/wifi/control")
+                                                     << QStringLiteral("/pps/services/wifi/status"), this);
+    m_waiter->setTimeout(10000);
+    connect(m_waiter, &QPps::ServiceWaiter::ready, this, &Wifi::Private::initPPS);
+ * \endcode
+ *
+ * Like the initial listing of a DirWatcher, ready() is emitted from the event loop even if all objects exist already.
+ */
+class QPPS_EXPORT ServiceWaiter : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * Create a ServiceWaiter waiting for the objects at @p objectPaths.
+     */
+    explicit ServiceWaiter(const QStringList &objectPaths, QObject *parent = 0);
+
+    /**
+     * Create a ServiceWaiter waiting for the object at @p objectPath.
+     */
+    explicit ServiceWaiter(const QString &objectPath, QObject *parent = 0);
+
+    /**
+     * Destroys the ServiceWaiter.
+     */
+    ~ServiceWaiter();
+
+    /// Returns the paths of the objects waited for.
+    QStringList objectPaths() const;
+
+    /// Returns the paths of the objects that do not exist (yet).
+    QStringList missingObjectPaths() const;
+
+    /// Returns true when all objects exist.
+    bool isReady() const;
+
+    /**
+     * Emit timedOut() if the objects are still missing @p msecs milliseconds from now.
+     *
+     * \sa timedOut()
+     */
+    void setTimeout(int msecs);
+
+    /**
+     * Returns whether the waiter stops watching once it is ready, which is the default.
+     *
+     * \sa setSingleShot()
+     */
+    bool isSingleShot() const;
+
+    /**
+     * When @p singleShot is false, the waiter keeps watching once it is ready: it emits lost() when one of the objects
+     * is removed and ready() again when all of them are back. Set this before returning to the event loop.
+     */
+    void setSingleShot(bool singleShot);
+
+Q_SIGNALS:
+    /**
+     * Emitted when the object \p objectPath has been added while it was missing.
+     */
+    void objectReady(const QString &objectPath);
+
+    /**
+     * Emitted when all objects exist.
+     */
+    void ready();
+
+    /**
+     * Emitted once when the timeout set with setTimeout() passed before all objects existed.
+     * The waiter keeps waiting, delete it to give up.
+     */
+    void timedOut();
+
+    /**
+     * Emitted when the object \p objectPath has been removed while the waiter was ready.
+     * Only emitted when the waiter is not single shot.
+     */
+    void lost(const QString &objectPath);
+
+private:
+    class Private;
+    Private *d;
+};
+
+}
+
+#endif
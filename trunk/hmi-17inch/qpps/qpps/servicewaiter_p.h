@@ -0,0 +1,51 @@
+#ifndef QPPS_SERVICEWAITER_P_H
+#define QPPS_SERVICEWAITER_P_H
+
+#include "servicewaiter.h"
+
+#include <QHash>
+#include <QSet>
+
+class QTimer;
+
+namespace QPps
+{
+
+class DirWatcher;
+
+class ServiceWaiter::Private : public QObject
+{
+    Q_OBJECT
+
+public:
+    Private(ServiceWaiter *parent);
+    ~Private();
+
+    ServiceWaiter *q() const { return static_cast<ServiceWaiter *>(parent()); }
+
+    void init(const QStringList &paths);
+
+    /// Creates a watcher for each directory that has none yet, schedules a retry for those that do not exist
+    void openWatchers();
+    void stopWatching();
+
+    QStringList objectPaths;
+    QSet<QString> missing;
+    /// The directories of the objects, without a watcher while they cannot be opened
+    QSet<QString> directories;
+    QHash<DirWatcher *, QString> watchers;
+    QTimer *timeoutTimer;
+    QTimer *retryTimer;
+    int retryInterval;
+    bool singleShot;
+    bool ready;
+
+private Q_SLOTS:
+    void objectAdded(const QString &name);
+    void objectRemoved(const QString &name);
+    void timeout();
+};
+
+}
+
+#endif
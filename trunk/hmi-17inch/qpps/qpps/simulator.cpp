@@ -1,12 +1,25 @@
 #include "simulator.h"
 #include "simulator_p.h"
 
+#include "changeset.h"
+#include "key.h"
+
 #include <QDebug>
 #include <QRegExp>
 #include <QStringList>
 
 using namespace QPps;
 
+/**
+ * Adds the interned id of the assigned attribute @p name to @p changes, like the QNX backend's parser does.
+ */
+static void resolveKey(Changeset *changes, const QString &name)
+{
+    const int key = Key::lookup(name);
+    if (key != Key::Invalid)
+        changes->keys.insert(name, key);
+}
+
 /**
  * Throw away pathname open options
  *
@@ -38,9 +51,37 @@ static QString normalizedKey(const QString &key)
     return rx.cap(2);
 }
 
-SimulatorPrivate::SimulatorPrivate(QObject *parent)
+SimulatorPrivate::SimulatorPrivate(Simulator *parent)
     : QObject(parent)
+    , q(parent)
+{
+}
+
+SimulatorObject *SimulatorPrivate::ensureObject(const QString &objectPath)
+{
+    QHash<QString, SimulatorObject>::Iterator it = m_ppsObjects.find(objectPath);
+    if (it != m_ppsObjects.end())
+        return &it.value();
+
+    it = m_ppsObjects.insert(objectPath, SimulatorObject());
+    emit q->objectAdded(objectPath);
+    return &it.value();
+}
+
+SimulatorObject *SimulatorPrivate::clientObject(QObject *client)
+{
+    Q_ASSERT(m_clients.contains(client));
+
+    // values of a QHash stay where they are until removed, but the object may be gone after a reset()
+    QHash<QString, SimulatorObject>::Iterator it = m_ppsObjects.find(m_clients.value(client));
+    return (it != m_ppsObjects.end()) ? &it.value() : 0;
+}
+
+QStringList SimulatorPrivate::sortedObjectPaths() const
 {
+    QStringList paths = m_ppsObjects.keys();
+    paths.sort();
+    return paths;
 }
 
 
@@ -59,18 +100,34 @@ Simulator::Simulator()
 {
 }
 
-bool Simulator::registerClient(const QString &path, QObject *client, QString *errorMessage)
+bool Simulator::registerClient(const QString &path, QObject *client, QString *errorMessage, bool create)
 {
     const QString normalizedPath = ::normalizedPath(path);
 
-    if (!d->m_ppsObjects.contains(normalizedPath)) {
+    SimulatorObject *object = 0;
+    if (create) {
+        object = d->ensureObject(normalizedPath);
+    } else {
+        QHash<QString, SimulatorObject>::Iterator it = d->m_ppsObjects.find(normalizedPath);
+        if (it != d->m_ppsObjects.end())
+            object = &it.value();
+    }
+
+    if (!object) {
         if (errorMessage)
             *errorMessage = QString::fromLatin1("Unable to open '%1', file does not exist").arg(normalizedPath);
 
         return false;
     }
 
+    // a client is registered for one object at a time
+    if (d->m_clients.contains(client)) {
+        if (SimulatorObject *previous = d->clientObject(client))
+            previous->subscribers.removeOne(client);
+    }
+
     d->m_clients.insert(client, normalizedPath);
+    object->subscribers.append(client);
     emit clientConnected(reinterpret_cast<qulonglong>(client));
 
     return true;
@@ -78,154 +135,83 @@ bool Simulator::registerClient(const QString &path, QObject *client, QString *er
 
 void Simulator::unregisterClient(QObject *client)
 {
-    d->m_clients.remove(client);
+    if (d->m_clients.contains(client)) {
+        if (SimulatorObject *object = d->clientObject(client))
+            object->subscribers.removeOne(client);
+        d->m_clients.remove(client);
+    }
+
     emit clientDisconnected(reinterpret_cast<qulonglong>(client));
 }
 
 void Simulator::triggerInitialListing(QObject *client)
 {
-    Q_ASSERT(d->m_clients.contains(client));
-
-    // lookup associated PPS object path
-    const QString ppsObjectPath = d->m_clients.value(client);
-
-    // get PPS object data
-    const QVariantMap ppsObject = d->m_ppsObjects[ppsObjectPath];
-
-    QMapIterator<QString, QVariant> it(ppsObject);
-    while (it.hasNext()) {
-        it.next();
-        const QVariantMap entry = it.value().toMap();
-        QMetaObject::invokeMethod(client, "notifyAttributeChanged", Qt::DirectConnection,
-                                  Q_ARG(QString, it.key()),
-                                  Q_ARG(QByteArray, entry.value(QStringLiteral("value")).toByteArray()),
-                                  Q_ARG(QByteArray, entry.value(QStringLiteral("encoding")).toByteArray()));
+    const SimulatorObject *object = d->clientObject(client);
+    if (!object || object->attributes.isEmpty())
+        return;
+
+    // all attributes in one go, like the initial read of a real PPS object
+    Changeset changeset;
+    QHash<QString, SimulatorAttribute>::ConstIterator it = object->attributes.constBegin();
+    for (; it != object->attributes.constEnd(); ++it) {
+        changeset.assignments.insert(it.key(), Variant(it.value().value, it.value().encoding));
+        resolveKey(&changeset, it.key());
     }
+
+    QMetaObject::invokeMethod(client, "notifyChanges", Qt::DirectConnection,
+                              Q_ARG(QPps::Changeset, changeset));
 }
 
 QStringList Simulator::clientGetAttributeNames(QObject *client) const
 {
-    Q_ASSERT(d->m_clients.contains(client));
+    const SimulatorObject *object = d->clientObject(client);
+    if (!object)
+        return QStringList();
 
-    // lookup associated PPS object path
-    const QString ppsObjectPath = d->m_clients.value(client);
+    QStringList names = object->attributes.keys();
+    names.sort();
+    return names;
+}
 
-    // get PPS object data
-    QVariantMap ppsObject = d->m_ppsObjects.value(ppsObjectPath);
+bool Simulator::clientSetAttributes(QObject *client, const Changeset &changeset)
+{
+    SimulatorObject *object = d->clientObject(client);
+    if (!object)
+        return false;
 
-    return ppsObject.keys();
+    applyChangeset(d->m_clients.value(client), object, changeset, client);
+    return true;
 }
 
 bool Simulator::clientSetAttribute(QObject *client, const QString &key, const QByteArray &value,
                                    const QByteArray &encoding)
 {
-    return false;
-
-    Q_ASSERT(d->m_clients.contains(client));
-
-    // lookup associated PPS object path
-    const QString ppsObjectPath = d->m_clients.value(client);
-
-    // get PPS object data
-    QVariantMap ppsObject = d->m_ppsObjects.value(ppsObjectPath);
-
-    // get PPS object entry for given key
-    bool changed = false;
-    if (!ppsObject.contains(key))
-        changed = true; // new key
-
-    QVariantMap entry = ppsObject[key].toMap();
-
-    // update value
-    if (entry[QStringLiteral("value")].toByteArray() != value)
-        changed = true;
-
-    entry[QStringLiteral("value")] = value;
-
-    // update encoding
-    if (entry[QStringLiteral("encoding")].toByteArray() != encoding)
-        changed = true;
-
-    entry[QStringLiteral("encoding")] = encoding;
-
-    // store updated entry
-    ppsObject[key] = entry;
-    setObjectAttributes(ppsObjectPath, ppsObject);
-
-    if (!changed)
-        return true;
-
-    emit attributeChanged(ppsObjectPath, key, value, encoding);
-
-    // notify all clients that listen on this PPS path
-    QMapIterator<QObject*, QString> it(d->m_clients);
-    while (it.hasNext()) {
-        it.next();
-
-        if ((it.key() != client) && (it.value() == ppsObjectPath))
-            QMetaObject::invokeMethod(it.key(), "notifyAttributeChanged", Qt::DirectConnection,
-                                      Q_ARG(QString, key), Q_ARG(QByteArray, value),
-                                      Q_ARG(QByteArray, encoding));
-    }
-
-    return true;
+    Changeset changeset;
+    changeset.assignments.insert(key, Variant(value, encoding));
+    return clientSetAttributes(client, changeset);
 }
 
 bool Simulator::clientGetAttribute(QObject *client, const QString &key, QByteArray &value, QByteArray &encoding) const
 {
-    Q_ASSERT(d->m_clients.contains(client));
-
-    // lookup associated PPS object path
-    const QString ppsObjectPath = d->m_clients.value(client);
-
-    // get PPS object data
-    const QVariantMap ppsObject = d->m_ppsObjects.value(ppsObjectPath);
-
-    // get PPS object entry for given key
-    if (!ppsObject.contains(key))
+    const SimulatorObject *object = d->clientObject(client);
+    if (!object)
         return false;
 
-    const QVariantMap entry = ppsObject[key].toMap();
+    QHash<QString, SimulatorAttribute>::ConstIterator it = object->attributes.constFind(key);
+    if (it == object->attributes.constEnd())
+        return false;
 
-    value = entry[QStringLiteral("value")].toByteArray();
-    encoding = entry[QStringLiteral("encoding")].toByteArray();
+    value = it->value;
+    encoding = it->encoding;
 
     return true;
 }
 
 bool Simulator::clientRemoveAttribute(QObject *client, const QString &key)
 {
-    Q_ASSERT(d->m_clients.contains(client));
-
-    // lookup associated PPS object path
-    const QString ppsObjectPath = d->m_clients.value(client);
-
-    // get PPS object data
-    if (!d->m_ppsObjects.contains(ppsObjectPath))
-        return true; // nothing to do
-    QVariantMap ppsObject = d->m_ppsObjects.value(ppsObjectPath);
-
-    // get PPS object entry for given key
-    if (!ppsObject.contains(key))
-        return true; // nothing to do
-
-    ppsObject.remove(key);
-
-    // store updated entry
-    d->m_ppsObjects[ppsObjectPath] = ppsObject;
-
-    emit attributeRemoved(ppsObjectPath, key);
-
-    // notify all clients that listen on this PPS path
-    QMapIterator<QObject*, QString> it(d->m_clients);
-    while (it.hasNext()) {
-        it.next();
-
-        if ((it.key() != client) && (it.value() == ppsObjectPath))
-            QMetaObject::invokeMethod(it.key(), "notifyAttributeRemoved", Qt::DirectConnection, Q_ARG(QString, key));
-    }
-
-    return true;
+    Changeset changeset;
+    changeset.removals.insert(key);
+    return clientSetAttributes(client, changeset);
 }
 
 void Simulator::insertAttribute(const QString &objectPath, const QString &key, const QByteArray &value, const QByteArray &encoding)
@@ -235,26 +221,28 @@ void Simulator::insertAttribute(const QString &objectPath, const QString &key, c
         return;
     }
 
-    const QString normalizedKey = ::normalizedKey(key);
+    SimulatorAttribute &attribute = d->ensureObject(objectPath)->attributes[::normalizedKey(key)];
+    attribute.value = value;
+    attribute.encoding = encoding;
+}
 
-    // get PPS object data
-    QVariantMap ppsObject = d->m_ppsObjects.value(objectPath);
+void Simulator::setObjectAttributes(const QString &objectPath, const Changeset &changeset)
+{
+    Changeset normalized;
 
-    // get PPS object entry for given key
-    QVariantMap entry = ppsObject[normalizedKey].toMap();
+    QMap<QString, Variant>::ConstIterator it = changeset.assignments.constBegin();
+    for (; it != changeset.assignments.constEnd(); ++it)
+        normalized.assignments.insert(::normalizedKey(it.key()), it.value());
 
-    entry[QStringLiteral("value")] = value;
-    entry[QStringLiteral("encoding")] = encoding;
+    Q_FOREACH (const QString &key, changeset.removals)
+        normalized.removals.insert(::normalizedKey(key));
 
-    // store updated entry
-    ppsObject[normalizedKey] = entry;
-    setObjectAttributes(objectPath, ppsObject);
+    applyChangeset(objectPath, d->ensureObject(objectPath), normalized, 0);
 }
 
 void Simulator::insertObject(const QString& objectPath)
 {
-    const QVariantMap ppsObject = d->m_ppsObjects.value(objectPath);
-    setObjectAttributes(objectPath, ppsObject); // this might insert an empty QVariantMap
+    d->ensureObject(objectPath);
 }
 
 void Simulator::reset()
@@ -263,29 +251,94 @@ void Simulator::reset()
     d->m_ppsObjects.clear();
 }
 
-QMap<QString, QVariantMap> Simulator::ppsObjects() const
+QStringList Simulator::objectPaths() const
 {
-    return d->m_ppsObjects;
+    return d->sortedObjectPaths();
 }
 
-static void dumpEntry(const QVariantMap &entry)
+QMap<QString, QVariantMap> Simulator::ppsObjects() const
 {
+    QMap<QString, QVariantMap> objects;
 
+    QHash<QString, SimulatorObject>::ConstIterator it = d->m_ppsObjects.constBegin();
+    for (; it != d->m_ppsObjects.constEnd(); ++it) {
+        QVariantMap attributes;
+
+        QHash<QString, SimulatorAttribute>::ConstIterator attribute = it->attributes.constBegin();
+        for (; attribute != it->attributes.constEnd(); ++attribute) {
+            QVariantMap entry;
+            entry[QStringLiteral("value")] = attribute->value;
+            entry[QStringLiteral("encoding")] = attribute->encoding;
+            attributes.insert(attribute.key(), entry);
+        }
+
+        objects.insert(it.key(), attributes);
+    }
+
+    return objects;
 }
 
-void Simulator::dumpTree(const QString& pathPrefix)
+void Simulator::applyChangeset(const QString &objectPath, SimulatorObject *object, const Changeset &changeset, QObject *writer)
 {
-    Q_FOREACH (const QString& path, d->m_ppsObjects.keys()) {
-        if (!path.startsWith(pathPrefix))
+    // only what actually changed is passed on
+    Changeset changes;
+
+    QMap<QString, Variant>::ConstIterator it = changeset.assignments.constBegin();
+    for (; it != changeset.assignments.constEnd(); ++it) {
+        const QByteArray value = it.value().value();
+        const QByteArray encoding = it.value().encoding();
+
+        QHash<QString, SimulatorAttribute>::Iterator attribute = object->attributes.find(it.key());
+        if (attribute == object->attributes.end()) {
+            attribute = object->attributes.insert(it.key(), SimulatorAttribute());
+        } else if (attribute->value == value && attribute->encoding == encoding) {
+            continue;
+        }
+
+        attribute->value = value;
+        attribute->encoding = encoding;
+        changes.assignments.insert(it.key(), it.value());
+        resolveKey(&changes, it.key());
+
+        emit attributeChanged(objectPath, it.key(), value, encoding);
+    }
+
+    Q_FOREACH (const QString &key, changeset.removals) {
+        if (object->attributes.remove(key) == 0)
             continue;
 
-        dumpEntry(d->m_ppsObjects[path]);
+        changes.assignments.remove(key);
+        changes.keys.remove(key);
+        changes.removals.insert(key);
+
+        emit attributeRemoved(objectPath, key);
+    }
+
+    if (changes.assignments.isEmpty() && changes.removals.isEmpty())
+        return;
+
+    // notify all other clients that listen on this PPS path, with one changeset each
+    Q_FOREACH (QObject *subscriber, object->subscribers) {
+        if (subscriber != writer)
+            QMetaObject::invokeMethod(subscriber, "notifyChanges", Qt::DirectConnection,
+                                      Q_ARG(QPps::Changeset, changes));
     }
 }
 
-void Simulator::setObjectAttributes(const QString &objectPath, const QVariantMap &attributes)
+void Simulator::dumpTree(const QString& pathPrefix)
 {
-    if (!d->m_ppsObjects.contains(objectPath))
-        emit objectAdded(objectPath);
-    d->m_ppsObjects[objectPath] = attributes;
+    Q_FOREACH (const QString& path, d->sortedObjectPaths()) {
+        if (!path.startsWith(pathPrefix))
+            continue;
+
+        qDebug() << path;
+
+        const SimulatorObject &object = d->m_ppsObjects[path];
+        QStringList names = object.attributes.keys();
+        names.sort();
+        Q_FOREACH (const QString &name, names) {
+            const SimulatorAttribute &attribute = object.attributes[name];
+            qDebug("    %s:%s:%s", qPrintable(name), attribute.encoding.constData(), attribute.value.constData());
+        }
+    }
 }
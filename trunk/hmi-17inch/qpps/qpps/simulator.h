@@ -5,9 +5,13 @@
 
 #include <QObject>
 #include <QHash>
+#include <QStringList>
+#include <QVariant>
 
 namespace QPps {
 
+struct Changeset;
+struct SimulatorObject;
 class SimulatorPrivate;
 
 /**
@@ -34,11 +38,12 @@ public:
      * Registers the @p client for the @p objectPath.
      *
      * The client object will be notified for changes to this PPS object.
+     * If @p create is @c true, an empty PPS object is created if it does not exist yet.
      *
      * Returns @c true on success or @c false if an error occurred.
      * In the latter case the error message is placed in @p errorMessage.
      */
-    bool registerClient(const QString &objectPath, QObject *client, QString *errorMessage = 0);
+    bool registerClient(const QString &objectPath, QObject *client, QString *errorMessage = 0, bool create = false);
 
     /**
      * Unregisters the @p client from the object path.
@@ -57,6 +62,17 @@ public:
      */
     QStringList clientGetAttributeNames(QObject *client) const;
 
+    /**
+     * Applies the assignments and removals of @p changeset to the PPS object the @p client has
+     * registered for.
+     *
+     * All other clients registered for that object are notified with one changeset that holds
+     * the attributes that actually changed.
+     *
+     * Returns @c true on success, @c false otherwise.
+     */
+    bool clientSetAttributes(QObject *client, const Changeset &changeset);
+
     /**
      * Sets the attribute in the PPS object the @p client has registered for.
      *
@@ -86,6 +102,15 @@ public:
      */
     void insertAttribute(const QString &objectPath, const QString &key, const QByteArray &value, const QByteArray &encoding);
 
+    /**
+     * Applies the assignments and removals of @p changeset to the object specified by
+     * @p objectPath, creating it if needed.
+     *
+     * Unlike insertAttribute(), all clients registered for the object are notified, with one
+     * changeset for the whole batch, just like when another process writes to a PPS object.
+     */
+    void setObjectAttributes(const QString &objectPath, const Changeset &changeset);
+
     /**
      * Inserts a @p objectPath
      */
@@ -97,7 +122,15 @@ public:
     void reset();
 
     /**
-     * Returns the list of currently known PPS objects.
+     * Returns the paths of the currently known PPS objects, sorted.
+     */
+    QStringList objectPaths() const;
+
+    /**
+     * Returns a copy of the currently known PPS objects, with the attributes as "value" and
+     * "encoding" entries of a QVariantMap.
+     *
+     * This copies everything, use objectPaths() to only list the objects.
      */
     QMap<QString, QVariantMap> ppsObjects() const;
 
@@ -141,9 +174,11 @@ private:
     Simulator();
 
     /**
-     * Store \p attributes in d->m_ppsObjects and emit objectAdded() if the object was previously unknown.
+     * Stores what changes with @p changeset in @p object, and notifies all clients of the object
+     * except @p writer.
      */
-    void setObjectAttributes(const QString &objectPath, const QVariantMap &attributes);
+    void applyChangeset(const QString &objectPath, SimulatorObject *object, const Changeset &changeset, QObject *writer);
+
     static Simulator* m_self;
 
     SimulatorPrivate *d;
@@ -3,6 +3,7 @@
 
 #include "simulator.h"
 
+#include <QDir>
 #include <QFileInfo>
 #include <QList>
 #include <QStringList>
@@ -17,8 +18,7 @@ DirWatcher::Private::Private(DirWatcher *parent)
 
 void DirWatcher::Private::doInitialObjectListing()
 {
-    // ### very inefficient
-    foreach (const QString &objectPath, Simulator::self()->ppsObjects().keys())
+    foreach (const QString &objectPath, Simulator::self()->objectPaths())
         notifyObjectAdded(objectPath);
 }
 
@@ -40,7 +40,7 @@ DirWatcher::DirWatcher(const QString &path, QObject *parent)
     , d(new Private(this))
 {
     // strip trailing slash, etc.
-    d->path = QFileInfo(path).path();
+    d->path = QDir::cleanPath(path);
 
     QMetaObject::invokeMethod(d, "doInitialObjectListing", Qt::QueuedConnection);
     connect(Simulator::self(), SIGNAL(objectAdded(QString)),
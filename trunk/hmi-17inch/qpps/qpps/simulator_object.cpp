@@ -2,50 +2,109 @@
 #include "simulator_object_p.h"
 
 #include "changeset.h"
+#include "changesetbatcher_p.h"
+#include "deliverythrottle_p.h"
+#include "key.h"
 #include "simulator.h"
 
 #include <QMap>
+#include <QMetaMethod>
 #include <QStringList>
 
 using namespace QPps;
 
-Object::Private::Private(const QString &path, Object::PublicationMode mode, QObject *parent)
+Object::Private::Private(const QString &path, Object::PublicationMode mode, bool create, QObject *parent)
     : QObject(parent)
     , m_isValid(false)
     , m_attributeCacheEnabled(false)
     , m_ppsObjectPath(path)
     , m_mode(mode)
+    , m_batcher(0)
+    , m_writeBehindInterval(0)
+    , m_throttle(0)
+    , m_receivedUpdates(0)
+    , m_deliveredUpdates(0)
 {
-    m_isValid = Simulator::self()->registerClient(m_ppsObjectPath, this, &m_errorString);
+    m_isValid = Simulator::self()->registerClient(m_ppsObjectPath, this, &m_errorString, create);
 }
 
-// TODO: for now attributesChanged is only called with a single changeset. We should be able to carry more complex changesets.
-void Object::Private::notifyAttributeChanged(const QString &key, const QByteArray &value, const QByteArray &encoding)
+bool Object::Private::writeChangeset(const Changeset &changeset)
 {
-    emit qobject_cast<Object*>(parent())->attributeChanged(key, Variant(value, encoding));
+    return Simulator::self()->clientSetAttributes(this, changeset);
+}
+
+void Object::Private::deliverChanges(const Changeset &changes)
+{
+    m_receivedUpdates += changes.assignments.size() + changes.removals.size();
+
+    if (m_throttle)
+        emitChanges(m_throttle->filter(changes));
+    else
+        emitChanges(changes);
+}
+
+void Object::Private::emitChanges(const Changeset &changes)
+{
+    if (changes.assignments.isEmpty() && changes.removals.isEmpty())
+        return;
+
+    m_deliveredUpdates += changes.assignments.size() + changes.removals.size();
+
+    Object *object = qobject_cast<Object*>(parent());
+
+    // receivers usually connect to only one of the per attribute signals
+    static const QMetaMethod attributeChangedSignal = QMetaMethod::fromSignal(&Object::attributeChanged);
+    static const QMetaMethod attributeKeyChangedSignal = QMetaMethod::fromSignal(&Object::attributeKeyChanged);
+    const bool emitNamed = object->isSignalConnected(attributeChangedSignal);
+    const bool emitKeyed = object->isSignalConnected(attributeKeyChangedSignal);
 
-    Changeset singleChangeSet;
-    singleChangeSet.assignments.insert(key, Variant(value, encoding));
-    emit qobject_cast<Object*>(parent())->attributesChanged(singleChangeSet);
+    if (emitNamed || emitKeyed) {
+        QMap<QString, Variant>::ConstIterator it = changes.assignments.constBegin();
+        for (; it != changes.assignments.constEnd(); ++it) {
+            if (emitNamed)
+                emit object->attributeChanged(it.key(), it.value());
+            if (emitKeyed)
+                emit object->attributeKeyChanged(changes.keys.value(it.key(), Key::Invalid), it.key(), it.value());
+        }
+    }
+
+    Q_FOREACH(const QString &removal, changes.removals)
+        emit object->attributeRemoved(removal);
+
+    emit object->attributesChanged(changes);
 }
 
-void Object::Private::notifyAttributeRemoved(const QString &key)
+DeliveryThrottle *Object::Private::deliveryThrottle()
 {
-    emit qobject_cast<Object*>(parent())->attributeRemoved(key);
+    if (!m_throttle) {
+        m_throttle = new DeliveryThrottle(this);
+        connect(m_throttle, SIGNAL(deliveryRequested()), this, SLOT(deliverPending()));
+    }
 
-    Changeset singleChangeSet;
-    singleChangeSet.removals << key;
-    emit qobject_cast<Object*>(parent())->attributesChanged(singleChangeSet);
+    return m_throttle;
 }
 
-Object::Object(const QString &path, PublicationMode mode, QObject *parent)
+void Object::Private::notifyChanges(const Changeset &changes)
+{
+    deliverChanges(changes);
+}
+
+void Object::Private::deliverPending()
+{
+    emitChanges(m_throttle->takeDue());
+}
+
+Object::Object(const QString &path, PublicationMode mode, bool create, QObject *parent)
     : QObject(parent)
-    , d(new Private(path, mode, this))
+    , d(new Private(path, mode, create, this))
 {
 }
 
 Object::~Object()
 {
+    // do not lose commands that are still pending in write-behind mode
+    flush();
+
     Simulator::self()->unregisterClient(d);
 }
 
@@ -86,6 +145,13 @@ Variant Object::attribute(const QString &name, const Variant &defaultAttribute)
         return Variant();
     }
 
+    // what has been set in write-behind mode, even before it is written
+    if (d->m_batcher) {
+        const ChangesetBatcher::Change *change = d->m_batcher->pendingChange(name);
+        if (change)
+            return change->isRemoval ? defaultAttribute : change->value;
+    }
+
     QByteArray value;
     QByteArray encoding;
 
@@ -100,24 +166,36 @@ QStringList Object::attributeNames() const
 {
     if (!d->m_attributeCacheEnabled)
         return QStringList();
-    else
-        return Simulator::self()->clientGetAttributeNames(d);
+
+    QStringList names = Simulator::self()->clientGetAttributeNames(d);
+    if (!d->m_batcher || d->m_batcher->isEmpty())
+        return names;
+
+    // include what has been set or removed in write-behind mode
+    Q_FOREACH (const ChangesetBatcher::Change &change, d->m_batcher->pendingChanges()) {
+        if (change.isRemoval)
+            names.removeOne(change.name);
+        else if (!names.contains(change.name))
+            names.append(change.name);
+    }
+
+    names.sort();
+    return names;
 }
 
 bool Object::setAttributes(const Changeset &changeset)
 {
-    QMap<QString, Variant>::ConstIterator it = changeset.assignments.constBegin();
-    for (; it != changeset.assignments.constEnd(); ++it) {
-        if (!setAttribute(it.key(), it.value()))
-            return false;
+    if (!(d->m_mode == PublishMode || d->m_mode == PublishAndSubscribeMode)) {
+        d->m_errorString = tr("Not allowed to write to %1").arg(d->m_ppsObjectPath);
+        return false;
     }
 
-    Q_FOREACH(const QString &removedAttr, changeset.removals) {
-        if (!removeAttribute(removedAttr))
-            return false;
+    if (d->m_batcher) {
+        d->m_batcher->add(changeset);
+        return true;
     }
 
-    return true;
+    return d->writeChangeset(changeset);
 }
 
 bool Object::setAttribute(const QString &name, const Variant &attribute)
@@ -127,7 +205,9 @@ bool Object::setAttribute(const QString &name, const Variant &attribute)
         return false;
     }
 
-    return Simulator::self()->clientSetAttribute(d, name, attribute.value(), attribute.encoding());
+    Changeset changeset;
+    changeset.assignments.insert(name, attribute);
+    return setAttributes(changeset);
 }
 
 bool Object::removeAttribute(const QString &name)
@@ -137,5 +217,110 @@ bool Object::removeAttribute(const QString &name)
         return false;
     }
 
-    return Simulator::self()->clientRemoveAttribute(d, name);
+    Changeset changeset;
+    changeset.removals += name;
+    return setAttributes(changeset);
+}
+
+bool Object::writeBehindEnabled() const
+{
+    return d->m_batcher != 0;
+}
+
+void Object::setWriteBehindEnabled(bool enabled)
+{
+    if (enabled == (d->m_batcher != 0))
+        return;
+
+    if (enabled) {
+        d->m_batcher = new ChangesetBatcher(d);
+        d->m_batcher->setInterval(d->m_writeBehindInterval);
+        connect(d->m_batcher, SIGNAL(flushRequested()), this, SLOT(flush()));
+    } else {
+        flush();
+        delete d->m_batcher;
+        d->m_batcher = 0;
+    }
+}
+
+int Object::writeBehindInterval() const
+{
+    return d->m_writeBehindInterval;
+}
+
+void Object::setWriteBehindInterval(int msec)
+{
+    d->m_writeBehindInterval = msec;
+    if (d->m_batcher)
+        d->m_batcher->setInterval(msec);
+}
+
+bool Object::hasPendingChanges() const
+{
+    return d->m_batcher && !d->m_batcher->isEmpty();
+}
+
+bool Object::flush()
+{
+    if (!d->m_batcher || d->m_batcher->isEmpty())
+        return true;
+
+    // the simulator keeps no order of attributes, so the order of the pending changes does not matter
+    return d->writeChangeset(ChangesetBatcher::toChangeset(d->m_batcher->take()));
+}
+
+bool Object::updateCoalescingEnabled() const
+{
+    return d->m_throttle && d->m_throttle->coalescingEnabled();
+}
+
+void Object::setUpdateCoalescingEnabled(bool enabled)
+{
+    d->deliveryThrottle()->setCoalescingEnabled(enabled);
+}
+
+int Object::updateCoalescingInterval() const
+{
+    return d->m_throttle ? d->m_throttle->coalescingInterval() : DeliveryThrottle::DefaultCoalescingInterval;
+}
+
+void Object::setUpdateCoalescingInterval(int msec)
+{
+    d->deliveryThrottle()->setCoalescingInterval(msec);
+}
+
+int Object::minimumUpdateInterval(const QString &name) const
+{
+    return d->m_throttle ? d->m_throttle->minimumInterval(name) : 0;
+}
+
+void Object::setMinimumUpdateInterval(const QString &name, int msec)
+{
+    d->deliveryThrottle()->setMinimumInterval(name, msec);
+}
+
+double Object::updateDeadband(const QString &name) const
+{
+    return d->m_throttle ? d->m_throttle->deadband(name) : 0;
+}
+
+void Object::setUpdateDeadband(const QString &name, double deadband)
+{
+    d->deliveryThrottle()->setDeadband(name, deadband);
+}
+
+quint64 Object::receivedUpdates() const
+{
+    return d->m_receivedUpdates;
+}
+
+quint64 Object::deliveredUpdates() const
+{
+    return d->m_deliveredUpdates;
+}
+
+void Object::resetUpdateCounters()
+{
+    d->m_receivedUpdates = 0;
+    d->m_deliveredUpdates = 0;
 }
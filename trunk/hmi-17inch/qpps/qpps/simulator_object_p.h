@@ -3,25 +3,41 @@
 
 #include "object.h"
 
+#include "changeset.h"
+
 namespace QPps
 {
 
+class ChangesetBatcher;
+class DeliveryThrottle;
+
 class Object::Private : public QObject
 {
     Q_OBJECT
 
 public:
-    Private(const QString &path, Object::PublicationMode mode, QObject *parent = 0);
+    Private(const QString &path, Object::PublicationMode mode, bool create, QObject *parent = 0);
+
+    bool writeChangeset(const Changeset &changeset);
+
+    void deliverChanges(const Changeset &changes);
+    void emitChanges(const Changeset &changes);
+    DeliveryThrottle *deliveryThrottle();
 
     bool m_isValid;
     bool m_attributeCacheEnabled;
     QString m_ppsObjectPath;
     PublicationMode m_mode;
     QString m_errorString;
+    ChangesetBatcher *m_batcher;
+    int m_writeBehindInterval;
+    DeliveryThrottle *m_throttle;
+    quint64 m_receivedUpdates;
+    quint64 m_deliveredUpdates;
 
 public Q_SLOTS:
-    void notifyAttributeChanged(const QString &key, const QByteArray &value, const QByteArray &encoding);
-    void notifyAttributeRemoved(const QString &key);
+    void notifyChanges(const QPps::Changeset &changes);
+    void deliverPending();
 
 };
 
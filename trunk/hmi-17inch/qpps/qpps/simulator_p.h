@@ -1,27 +1,62 @@
 #ifndef QPPS_SIMULATOR_P_H
 #define QPPS_SIMULATOR_P_H
 
+#include <QHash>
+#include <QList>
 #include <QMap>
-#include <QStack>
 #include <QVariant>
 
 namespace QPps {
 
+class Simulator;
+
+/**
+ * One attribute of a simulated PPS object
+ */
+struct SimulatorAttribute
+{
+    QByteArray value;
+    QByteArray encoding;
+};
+
+/**
+ * A simulated PPS object: a flat attribute table and the clients registered for it
+ */
+struct SimulatorObject
+{
+    QHash<QString, SimulatorAttribute> attributes;
+
+    // in registration order, so that notifications are delivered in a predictable order
+    QList<QObject*> subscribers;
+};
+
 class SimulatorPrivate : public QObject
 {
     Q_OBJECT
 
 public:
-    SimulatorPrivate(QObject *parent = 0);
+    SimulatorPrivate(Simulator *parent);
+
+    /**
+     * Returns the object at @p objectPath, creating it (and emitting Simulator::objectAdded())
+     * if it does not exist yet.
+     */
+    SimulatorObject *ensureObject(const QString &objectPath);
 
-    //uses QMap here to get predictable orders when iterating for unit tests.
-    //QHash uses a random seed which defines the iteration order.
+    /// Returns the object @p client is registered for
+    SimulatorObject *clientObject(QObject *client);
+
+    Simulator *q;
 
     // key: the SimulatorPpsObject client   value: the PPS object path
-    QMap<QObject*, QString> m_clients;
+    QHash<QObject*, QString> m_clients;
+
+    // key: the PPS object path   value: the PPS object
+    // QHash does not have a predictable iteration order, use sortedObjectPaths() where it matters
+    QHash<QString, SimulatorObject> m_ppsObjects;
 
-    // key: the PPS object path   value: the entries of the PPS object
-    QMap<QString, QVariantMap> m_ppsObjects;
+    /// Returns the paths of all objects, sorted
+    QStringList sortedObjectPaths() const;
 };
 
 }
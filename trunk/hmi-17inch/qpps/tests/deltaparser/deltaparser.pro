@@ -0,0 +1,23 @@
+include(../../common.pri)
+
+TEMPLATE = app
+
+QT += testlib
+
+# on QNX, do not run as part of make check/test
+!qnx:CONFIG += testcase
+
+TARGET = test_deltaparser
+
+include(../../addlibraries.pri)
+
+INCLUDEPATH += $$PWD/../../qpps
+
+target.path = $$INSTALL_PREFIX
+INSTALLS += target
+
+HEADERS += test_deltaparser_p.h
+
+SOURCES += test_deltaparser.cpp
+
+OTHER_FILES += data/sensors.delta
@@ -0,0 +1,356 @@
+#include "test_deltaparser_p.h"
+
+#include "changeset.h"
+#include "deltaparser_p.h"
+#include "key.h"
+#ifdef Q_OS_UNIX
+#include "reactor_p.h"
+#endif
+
+#include <QElapsedTimer>
+
+#include <new>
+#include <stdlib.h>
+
+using namespace QPps;
+
+// count heap allocations, so the benchmarks can report allocations per line
+static qint64 s_allocations = 0;
+
+void *operator new(size_t size)
+{
+    ++s_allocations;
+    void *p = malloc(size ? size : 1);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *p) throw()
+{
+    free(p);
+}
+
+void operator delete[](void *p) throw()
+{
+    free(p);
+}
+
+Q_DECLARE_METATYPE(QPps::DeltaParser::LineType)
+
+void DeltaParserTest::initTestCase()
+{
+    QFile file(QFINDTESTDATA("data/sensors.delta"));
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    m_recordedStream = file.readAll();
+    QVERIFY(!m_recordedStream.isEmpty());
+}
+
+void DeltaParserTest::testParseLine_data()
+{
+    QTest::addColumn<QByteArray>("raw");
+    QTest::addColumn<QPps::DeltaParser::LineType>("type");
+    QTest::addColumn<QByteArray>("qualifiers");
+    QTest::addColumn<QByteArray>("name");
+    QTest::addColumn<QByteArray>("encoding");
+    QTest::addColumn<QByteArray>("value");
+
+    QTest::newRow("object") << QByteArray("@sensors") << DeltaParser::ObjectLine
+                            << QByteArray() << QByteArray("sensors") << QByteArray() << QByteArray();
+    QTest::newRow("object added") << QByteArray("+@bluetooth") << DeltaParser::ObjectAddedLine
+                                  << QByteArray() << QByteArray("bluetooth") << QByteArray() << QByteArray();
+    QTest::newRow("object removed") << QByteArray("-@bluetooth") << DeltaParser::ObjectRemovedLine
+                                    << QByteArray() << QByteArray("bluetooth") << QByteArray() << QByteArray();
+    QTest::newRow("assignment") << QByteArray("speed:n:42") << DeltaParser::AssignmentLine
+                                << QByteArray() << QByteArray("speed") << QByteArray("n") << QByteArray("42");
+    QTest::newRow("no encoding") << QByteArray("name::John Doe") << DeltaParser::AssignmentLine
+                                 << QByteArray() << QByteArray("name") << QByteArray() << QByteArray("John Doe");
+    QTest::newRow("colon in value") << QByteArray("json:json:{\"a\":1}") << DeltaParser::AssignmentLine
+                                    << QByteArray() << QByteArray("json") << QByteArray("json") << QByteArray("{\"a\":1}");
+    QTest::newRow("qualified assignment") << QByteArray("[n]fanSpeed:n:3") << DeltaParser::AssignmentLine
+                                          << QByteArray("n") << QByteArray("fanSpeed") << QByteArray("n") << QByteArray("3");
+    QTest::newRow("removal") << QByteArray("-fanSpeed") << DeltaParser::RemovalLine
+                             << QByteArray() << QByteArray("fanSpeed") << QByteArray() << QByteArray();
+    QTest::newRow("qualified removal") << QByteArray("[i]-fanSpeed") << DeltaParser::RemovalLine
+                                       << QByteArray("i") << QByteArray("fanSpeed") << QByteArray() << QByteArray();
+}
+
+void DeltaParserTest::testParseLine()
+{
+    QFETCH(QByteArray, raw);
+    QFETCH(QPps::DeltaParser::LineType, type);
+    QFETCH(QByteArray, qualifiers);
+    QFETCH(QByteArray, name);
+    QFETCH(QByteArray, encoding);
+    QFETCH(QByteArray, value);
+
+    DeltaParser::Line line;
+    QVERIFY(DeltaParser::parseLine(ByteRef(raw.constData(), raw.size()), &line));
+    QCOMPARE(line.type, type);
+    QCOMPARE(line.qualifiers.toByteArray(), qualifiers);
+    QCOMPARE(line.name.toByteArray(), name);
+    QCOMPARE(line.encoding.toByteArray(), encoding);
+    QCOMPARE(line.value.toByteArray(), value);
+    QCOMPARE(line.raw.toByteArray(), raw);
+}
+
+void DeltaParserTest::testInvalidLines()
+{
+    DeltaParser parser;
+    const QByteArray data("[nfoo:n:1\nfoo\nfoo:n:1\n");
+    parser.append(data.constData(), data.size());
+
+    DeltaParser::Line line;
+    QVERIFY(parser.nextLine(&line));
+    QCOMPARE(line.type, DeltaParser::InvalidLine);
+    QVERIFY(!parser.errorString().isEmpty());
+
+    QVERIFY(parser.nextLine(&line));
+    QCOMPARE(line.type, DeltaParser::InvalidLine);
+
+    // parsing continues behind a broken line
+    QVERIFY(parser.nextLine(&line));
+    QCOMPARE(line.type, DeltaParser::AssignmentLine);
+    QVERIFY(!parser.nextLine(&line));
+}
+
+void DeltaParserTest::testCarryOver()
+{
+    DeltaParser parser;
+    DeltaParser::Line line;
+
+    const QByteArray first("@sensors\nspeed:n:4");
+    parser.append(first.constData(), first.size());
+
+    QVERIFY(parser.nextLine(&line));
+    QCOMPARE(line.type, DeltaParser::ObjectLine);
+    QVERIFY(!parser.nextLine(&line)); // "speed" is incomplete
+    parser.compact();
+    QCOMPARE(parser.pendingBytes(), 9);
+
+    const QByteArray second("2\n\nrpm:n:3000\n");
+    parser.append(second.constData(), second.size());
+
+    QVERIFY(parser.nextLine(&line));
+    QCOMPARE(line.type, DeltaParser::AssignmentLine);
+    QCOMPARE(line.name.toByteArray(), QByteArray("speed"));
+    QCOMPARE(line.value.toByteArray(), QByteArray("42"));
+
+    QVERIFY(parser.nextLine(&line)); // the empty line is skipped
+    QCOMPARE(line.name.toByteArray(), QByteArray("rpm"));
+    QVERIFY(!parser.nextLine(&line));
+    parser.compact();
+    QCOMPARE(parser.pendingBytes(), 0);
+}
+
+void DeltaParserTest::testGrowBuffer()
+{
+    DeltaParser parser(16);
+    const QByteArray value(100, 'x');
+    const QByteArray data = "long:s:" + value + "\nshort:n:1\n";
+
+    // feed in small chunks, like a reader with a tiny buffer would do
+    QList<QByteArray> names;
+    int offset = 0;
+    while (offset < data.size()) {
+        const int count = qMin(parser.writeCapacity(), qMin(7, data.size() - offset));
+        memcpy(parser.writePointer(), data.constData() + offset, count);
+        parser.commit(count);
+        offset += count;
+
+        DeltaParser::Line line;
+        while (parser.nextLine(&line))
+            names << line.name.toByteArray();
+        parser.compact();
+    }
+
+    QCOMPARE(names, QList<QByteArray>() << QByteArray("long") << QByteArray("short"));
+    QCOMPARE(parser.pendingBytes(), 0);
+}
+
+#ifdef Q_OS_UNIX
+namespace {
+
+/**
+ * Runs the parsing of ChangesetReader, the path every Object update takes, without a file
+ * descriptor and without the reactor thread.
+ */
+class ReplayReader : public ChangesetReader
+{
+public:
+    ReplayReader() : ChangesetReader(-1, QStringLiteral("replay"), 0, 0) {}
+
+    bool parse(DeltaParser *parser, QString *errorString)
+    {
+        QMutexLocker locker(&m_mutex);
+        return parseLines(parser, errorString);
+    }
+};
+
+}
+#endif
+
+static void countChangesets(const QList<Changeset> &changesets, qint64 *attributes, int *checksum)
+{
+    foreach (const Changeset &changeset, changesets) {
+        for (QMap<QString, Variant>::ConstIterator it = changeset.assignments.constBegin();
+             it != changeset.assignments.constEnd(); ++it) {
+            *checksum += it.key().size() + it.value().value().size();
+        }
+        *attributes += changeset.assignments.size() + changeset.removals.size();
+    }
+}
+
+void DeltaParserTest::benchmarkReplay_data()
+{
+    QTest::addColumn<int>("readSize");
+    QTest::addColumn<bool>("internKeys");
+
+    QTest::newRow("512 bytes per read") << 512 << false;
+    QTest::newRow("4 KB per read") << 4096 << false;
+    QTest::newRow("64 KB per read") << 65536 << false;
+    // the car models intern the attributes they handle through their KeyTables
+    QTest::newRow("4 KB per read, interned keys") << 4096 << true;
+}
+
+/**
+ * Replays the recorded stream through ChangesetReader, i.e. DeltaParser plus building the
+ * changeset that is delivered to Object.
+ */
+void DeltaParserTest::benchmarkReplay()
+{
+#ifdef Q_OS_UNIX
+    QFETCH(int, readSize);
+    QFETCH(bool, internKeys);
+
+    if (internKeys) {
+        DeltaParser parser;
+        memcpy(parser.writePointer(), m_recordedStream.constData(), m_recordedStream.size());
+        parser.commit(m_recordedStream.size());
+
+        DeltaParser::Line line;
+        while (parser.nextLine(&line)) {
+            if (line.type == DeltaParser::AssignmentLine || line.type == DeltaParser::RemovalLine)
+                Key::intern(line.name.toString());
+        }
+    }
+
+    ReplayReader reader;
+    DeltaParser parser;
+    qint64 attributes = 0;
+    qint64 allocations = 0;
+    qint64 elapsed = 0;
+    int checksum = 0;
+
+    QBENCHMARK {
+        QElapsedTimer timer;
+        timer.start();
+        const qint64 allocationsBefore = s_allocations;
+
+        // replay the recorded stream in reads of readSize bytes, most reads cut a line in half
+        int offset = 0;
+        while (offset < m_recordedStream.size()) {
+            const int count = qMin(qMin(readSize, parser.writeCapacity()), m_recordedStream.size() - offset);
+            memcpy(parser.writePointer(), m_recordedStream.constData() + offset, count);
+            parser.commit(count);
+            offset += count;
+
+            QString errorString;
+            QVERIFY2(reader.parse(&parser, &errorString), qPrintable(errorString));
+            parser.compact();
+
+            countChangesets(reader.takeChangesets(), &attributes, &checksum);
+        }
+
+        allocations += s_allocations - allocationsBefore;
+        elapsed += timer.nsecsElapsed();
+    }
+
+    QVERIFY(checksum > 0);
+    QCOMPARE(parser.pendingBytes(), 0);
+    qDebug("%.0f attributes/s, %.3f allocations/attribute",
+           attributes * 1e9 / qMax<qint64>(elapsed, 1), double(allocations) / qMax<qint64>(attributes, 1));
+#else
+    QSKIP("ChangesetReader is only built on Unix");
+#endif
+}
+
+void DeltaParserTest::benchmarkReplayBaseline_data()
+{
+    QTest::addColumn<int>("readSize");
+
+    QTest::newRow("512 bytes per read") << 512;
+    QTest::newRow("4 KB per read") << 4096;
+    QTest::newRow("64 KB per read") << 65536;
+}
+
+/**
+ * The way Object::Private used to parse: split every read into lines and copy name,
+ * encoding and value into the changeset. Lines straddling two reads are lost.
+ */
+void DeltaParserTest::benchmarkReplayBaseline()
+{
+    QFETCH(int, readSize);
+
+    qint64 attributes = 0;
+    qint64 allocations = 0;
+    qint64 elapsed = 0;
+    int checksum = 0;
+
+    QBENCHMARK {
+        QElapsedTimer timer;
+        timer.start();
+        const qint64 allocationsBefore = s_allocations;
+
+        int offset = 0;
+        while (offset < m_recordedStream.size()) {
+            const int count = qMin(readSize, m_recordedStream.size() - offset);
+            const QList<QByteArray> split = QByteArray::fromRawData(m_recordedStream.constData() + offset, count).split('\n');
+            offset += count;
+
+            Changeset changeset;
+            foreach (QByteArray line, split) {
+                if (line.isEmpty())
+                    continue;
+                if (line.startsWith('['))
+                    line.remove(0, line.indexOf(']') + 1);
+                if (line.startsWith('@'))
+                    continue;
+
+                if (line.startsWith('-')) {
+                    changeset.removals += QString::fromLocal8Bit(line.mid(1));
+                    continue;
+                }
+
+                const int firstColon = line.indexOf(':');
+                const int secondColon = line.indexOf(':', firstColon + 1);
+                if (firstColon == -1 || secondColon == -1)
+                    continue;
+
+                const QString name = QString::fromLocal8Bit(line.left(firstColon));
+                const QByteArray encoding = line.mid(firstColon + 1, secondColon - firstColon - 1);
+                const QByteArray value = line.mid(secondColon + 1);
+                changeset.assignments.insert(name, Variant(value, encoding));
+            }
+
+            QList<Changeset> changesets;
+            if (!changeset.assignments.isEmpty() || !changeset.removals.isEmpty())
+                changesets.append(changeset);
+            countChangesets(changesets, &attributes, &checksum);
+        }
+
+        allocations += s_allocations - allocationsBefore;
+        elapsed += timer.nsecsElapsed();
+    }
+
+    QVERIFY(checksum > 0);
+    qDebug("%.0f attributes/s, %.3f allocations/attribute",
+           attributes * 1e9 / qMax<qint64>(elapsed, 1), double(allocations) / qMax<qint64>(attributes, 1));
+}
+
+QTEST_MAIN(DeltaParserTest)
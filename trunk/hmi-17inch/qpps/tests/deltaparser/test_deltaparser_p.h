@@ -0,0 +1,30 @@
+#ifndef TEST_DELTAPARSER_P_H
+#define TEST_DELTAPARSER_P_H
+
+#include <QTest>
+
+#include <QDebug>
+#include <QFile>
+
+class DeltaParserTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+
+    void testParseLine_data();
+    void testParseLine();
+    void testInvalidLines();
+    void testCarryOver();
+    void testGrowBuffer();
+
+    void benchmarkReplay_data();
+    void benchmarkReplay();
+    void benchmarkReplayBaseline_data();
+    void benchmarkReplayBaseline();
+
+private:
+    QByteArray m_recordedStream;
+};
+
+#endif
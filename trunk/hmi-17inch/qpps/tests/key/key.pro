@@ -0,0 +1,21 @@
+include(../../common.pri)
+
+TEMPLATE = app
+
+QT += testlib
+
+# on QNX, do not run as part of make check/test
+!qnx:CONFIG += testcase
+
+TARGET = test_key
+
+include(../../addlibraries.pri)
+
+INCLUDEPATH += $$PWD/../../qpps
+
+target.path = $$INSTALL_PREFIX
+INSTALLS += target
+
+HEADERS += test_key_p.h
+
+SOURCES += test_key.cpp
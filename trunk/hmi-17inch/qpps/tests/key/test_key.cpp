@@ -0,0 +1,54 @@
+#include "test_key_p.h"
+
+#include "key.h"
+
+using namespace QPps;
+
+void KeyTest::testIntern()
+{
+    QCOMPARE(Key::lookup(QStringLiteral("__qppstest_unknown__")), int(Key::Invalid));
+
+    const int key = Key::intern("__qppstest_speed__");
+    QVERIFY(key != Key::Invalid);
+    QCOMPARE(Key::intern(QStringLiteral("__qppstest_speed__")), key);
+    QCOMPARE(Key::lookup(QStringLiteral("__qppstest_speed__")), key);
+    QCOMPARE(Key::name(key), QStringLiteral("__qppstest_speed__"));
+
+    QVERIFY(Key::name(Key::Invalid).isNull());
+    QVERIFY(Key::intern("__qppstest_rpm__") != key);
+}
+
+void KeyTest::testLookupBytes()
+{
+    // enough names to force the byte index to grow a few times
+    QList<int> keys;
+    for (int i = 0; i < 500; ++i)
+        keys << Key::intern(QStringLiteral("__qppstest_bytes_%1__").arg(i));
+
+    for (int i = 0; i < 500; ++i) {
+        const QByteArray name = QByteArray("__qppstest_bytes_") + QByteArray::number(i) + "__";
+        QCOMPARE(Key::lookup(name.constData(), name.size()), keys.at(i));
+    }
+
+    // prefixes of interned names are different names
+    const QByteArray prefix("__qppstest_bytes_1");
+    QCOMPARE(Key::lookup(prefix.constData(), prefix.size()), int(Key::Invalid));
+}
+
+void KeyTest::testKeyTable()
+{
+    enum { SpeedKey, RpmKey, KeyCount };
+    static const char * const names[KeyCount] = { "__qppstest_table_speed__", "__qppstest_table_rpm__" };
+
+    const KeyTable table(names, KeyCount);
+    QCOMPARE(table.count(), int(KeyCount));
+    QCOMPARE(table.indexOf(Key::lookup(QStringLiteral("__qppstest_table_speed__"))), int(SpeedKey));
+    QCOMPARE(table.indexOf(QStringLiteral("__qppstest_table_rpm__")), int(RpmKey));
+    QCOMPARE(table.name(RpmKey), QStringLiteral("__qppstest_table_rpm__"));
+
+    // names interned after the table was built, and invalid keys, are not part of it
+    QCOMPARE(table.indexOf(Key::intern("__qppstest_table_later__")), -1);
+    QCOMPARE(table.indexOf(int(Key::Invalid)), -1);
+}
+
+QTEST_MAIN(KeyTest)
@@ -0,0 +1,15 @@
+#ifndef TEST_KEY_P_H
+#define TEST_KEY_P_H
+
+#include <QTest>
+
+class KeyTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testIntern();
+    void testLookupBytes();
+    void testKeyTable();
+};
+
+#endif
@@ -296,4 +296,34 @@ void ObjectTest::testNonAscii()
     QVERIFY(subscriber.errorString().isEmpty());
 }
 
+void ObjectTest::testWriteBehind()
+{
+    Object publisher(m_ppsObjectFilePath, Object::PublishAndSubscribeMode, true);
+    QVERIFY(publisher.isValid());
+    publisher.setAttributeCacheEnabled(true);
+    publisher.setWriteBehindEnabled(true);
+    publisher.setWriteBehindInterval(60000);
+
+    QFile delta(m_ppsObjectFilePath + QLatin1String("?delta"));
+    QVERIFY(delta.open(QIODevice::ReadOnly | QIODevice::Unbuffered));
+    delta.read(4096); // the initial listing
+
+    // pending changes are visible before they are written
+    QVERIFY(publisher.setAttribute(QLatin1String("zeta"), Variant(1)));
+    QVERIFY(publisher.setAttribute(QLatin1String("alpha"), Variant(2)));
+    QVERIFY(publisher.setAttribute(QLatin1String("zeta"), Variant(3)));
+    QCOMPARE(publisher.attribute(QLatin1String("zeta")), Variant(3));
+    QCOMPARE(publisher.attribute(QLatin1String("alpha")), Variant(2));
+
+    // they are written in the order the attributes were first changed in
+    QVERIFY(publisher.flush());
+    const QByteArray written = delta.read(4096);
+    const int zeta = written.indexOf("zeta:n:3");
+    const int alpha = written.indexOf("alpha:n:2");
+    QVERIFY(zeta != -1);
+    QVERIFY(alpha != -1);
+    QVERIFY(zeta < alpha);
+    QCOMPARE(publisher.attribute(QLatin1String("zeta")), Variant(3));
+}
+
 QTEST_MAIN(ObjectTest)
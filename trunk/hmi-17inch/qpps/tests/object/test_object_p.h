@@ -25,6 +25,7 @@ private Q_SLOTS:
     void testCache1();
     void testCache2();
     void testNonAscii();
+    void testWriteBehind();
 
 public Q_SLOTS:
     void attributeChanged(const QString &name, const QPps::Variant &value);
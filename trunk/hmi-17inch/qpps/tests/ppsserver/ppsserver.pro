@@ -0,0 +1,24 @@
+include(../../common.pri)
+
+TEMPLATE = app
+
+QT += testlib
+
+CONFIG += testcase
+
+TARGET = test_ppsserver
+
+include(../../addlibraries.pri)
+
+INCLUDEPATH += $$PWD/../../qpps
+
+DEFINES += QPPS_SERVER_BINARY=\\\"$$BUILD_ROOT/bin/qppsserver\\\"
+
+target.path = $$INSTALL_PREFIX
+INSTALLS += target
+
+HEADERS += \
+    serverprocess.h \
+    test_ppsserver_p.h
+
+SOURCES += test_ppsserver.cpp
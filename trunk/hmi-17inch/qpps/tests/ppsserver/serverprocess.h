@@ -0,0 +1,53 @@
+#ifndef SERVERPROCESS_H
+#define SERVERPROCESS_H
+
+#include <QFile>
+#include <QProcess>
+#include <QStringList>
+#include <QTemporaryDir>
+#include <QTest>
+
+/**
+ * Runs a private qppsserver for the duration of a test, and points the qpps library in this
+ * process to it.
+ */
+class ServerProcess
+{
+public:
+    ~ServerProcess()
+    {
+        stop();
+    }
+
+    bool start()
+    {
+        const QString socketPath = m_directory.path() + QStringLiteral("/socket");
+        qputenv("QPPS_SERVER_SOCKET", socketPath.toLocal8Bit());
+
+        m_process.setProcessChannelMode(QProcess::ForwardedChannels);
+        m_process.start(QStringLiteral(QPPS_SERVER_BINARY), QStringList() << QStringLiteral("--socket") << socketPath);
+        if (!m_process.waitForStarted())
+            return false;
+
+        // listening as soon as the socket exists
+        for (int i = 0; i < 500 && !QFile::exists(socketPath); ++i)
+            QTest::qWait(10);
+
+        return QFile::exists(socketPath);
+    }
+
+    void stop()
+    {
+        if (m_process.state() == QProcess::NotRunning)
+            return;
+
+        m_process.terminate();
+        m_process.waitForFinished();
+    }
+
+private:
+    QTemporaryDir m_directory;
+    QProcess m_process;
+};
+
+#endif
@@ -0,0 +1,186 @@
+#include "test_ppsserver_p.h"
+
+#include "changeset.h"
+#include "dirwatcher.h"
+#include "object.h"
+#include "serverclient_p.h"
+#include "variant.h"
+
+#include <QSignalSpy>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+Q_DECLARE_METATYPE(QPps::Variant)
+
+using namespace QPps;
+
+void PpsServerTest::initTestCase()
+{
+    qRegisterMetaType<QPps::Variant>("QPps::Variant");
+
+    QVERIFY(m_server.start());
+}
+
+void PpsServerTest::cleanupTestCase()
+{
+    m_server.stop();
+}
+
+void PpsServerTest::testOpenMissing()
+{
+    Object object(QStringLiteral("/pps/test/missing"), Object::SubscribeMode);
+    QVERIFY(!object.isValid());
+    QVERIFY(!object.errorString().isEmpty());
+
+    QVERIFY(!ServerClient::unlink("/pps/test/missing"));
+    QCOMPARE(errno, ENOENT);
+}
+
+void PpsServerTest::testPublishSubscribe()
+{
+    Object publisher(QStringLiteral("/pps/test/publishSubscribe"), Object::PublishMode, true);
+    QVERIFY2(publisher.isValid(), qPrintable(publisher.errorString()));
+
+    Object subscriber(QStringLiteral("/pps/test/publishSubscribe"), Object::SubscribeMode);
+    QVERIFY2(subscriber.isValid(), qPrintable(subscriber.errorString()));
+    QSignalSpy spy(&subscriber, SIGNAL(attributeChanged(QString,QPps::Variant)));
+
+    QVERIFY(publisher.setAttribute(QStringLiteral("speed"), Variant(42)));
+    QTRY_COMPARE(spy.count(), 1);
+    QCOMPARE(spy.at(0).at(0).toString(), QStringLiteral("speed"));
+    QCOMPARE(spy.at(0).at(1).value<Variant>(), Variant(42));
+
+    // a writer does not get its own changes back
+    Object both(QStringLiteral("/pps/test/publishSubscribe"), Object::PublishAndSubscribeMode);
+    QSignalSpy ownSpy(&both, SIGNAL(attributeChanged(QString,QPps::Variant)));
+    QTRY_COMPARE(ownSpy.count(), 1); // the initial content
+    QVERIFY(both.setAttribute(QStringLiteral("speed"), Variant(43)));
+    QTRY_COMPARE(spy.count(), 2);
+    QCOMPARE(spy.at(1).at(1).value<Variant>(), Variant(43));
+    QTest::qWait(50);
+    QCOMPARE(ownSpy.count(), 1);
+}
+
+void PpsServerTest::testMultipleSubscribers()
+{
+    Object publisher(QStringLiteral("/pps/test/multiple"), Object::PublishMode, true);
+    QVERIFY(publisher.isValid());
+
+    QList<Object *> subscribers;
+    QList<QSignalSpy *> spies;
+    for (int i = 0; i < 10; ++i) {
+        subscribers << new Object(QStringLiteral("/pps/test/multiple"), Object::SubscribeMode);
+        spies << new QSignalSpy(subscribers.last(), SIGNAL(attributeChanged(QString,QPps::Variant)));
+    }
+
+    Changeset changeset;
+    changeset.assignments.insert(QStringLiteral("rpm"), Variant(3000));
+    changeset.assignments.insert(QStringLiteral("gear"), Variant(QStringLiteral("D")));
+    QVERIFY(publisher.setAttributes(changeset));
+
+    for (int i = 0; i < subscribers.count(); ++i) {
+        QTRY_COMPARE(spies.at(i)->count(), 2);
+        QCOMPARE(subscribers.at(i)->attribute(QStringLiteral("rpm")), Variant(3000));
+        QCOMPARE(subscribers.at(i)->attribute(QStringLiteral("gear")).toString(), QStringLiteral("D"));
+    }
+
+    qDeleteAll(spies);
+    qDeleteAll(subscribers);
+}
+
+void PpsServerTest::testInitialContent()
+{
+    {
+        Object publisher(QStringLiteral("/pps/test/initial"), Object::PublishMode, true);
+        QVERIFY(publisher.setAttribute(QStringLiteral("speed"), Variant(42)));
+        QVERIFY(publisher.setAttribute(QStringLiteral("rpm"), Variant(3000)));
+    }
+
+    // the object outlives its writer, a new reader gets the current state
+    Object subscriber(QStringLiteral("/pps/test/initial"), Object::SubscribeMode);
+    QVERIFY(subscriber.isValid());
+    QTRY_COMPARE(subscriber.attributeNames().count(), 2);
+    QCOMPARE(subscriber.attribute(QStringLiteral("speed")), Variant(42));
+
+    // also when the cache is enabled later, which reads synchronously
+    Object late(QStringLiteral("/pps/test/initial"), Object::SubscribeMode);
+    late.setAttributeCacheEnabled(false);
+    late.setAttributeCacheEnabled(true);
+    QTRY_COMPARE(late.attribute(QStringLiteral("rpm")), Variant(3000));
+}
+
+void PpsServerTest::testAttributeRemoval()
+{
+    Object publisher(QStringLiteral("/pps/test/removal"), Object::PublishMode, true);
+    QVERIFY(publisher.setAttribute(QStringLiteral("speed"), Variant(42)));
+
+    Object subscriber(QStringLiteral("/pps/test/removal"), Object::SubscribeMode);
+    QTRY_COMPARE(subscriber.attribute(QStringLiteral("speed")), Variant(42));
+
+    QSignalSpy spy(&subscriber, SIGNAL(attributeRemoved(QString)));
+    QVERIFY(publisher.removeAttribute(QStringLiteral("speed")));
+    QTRY_COMPARE(spy.count(), 1);
+    QCOMPARE(spy.at(0).at(0).toString(), QStringLiteral("speed"));
+    QVERIFY(!subscriber.attributeNames().contains(QStringLiteral("speed")));
+}
+
+void PpsServerTest::testQualifiers()
+{
+    // written straight to the connection, Object does not write qualifiers itself
+    const int fd = ServerClient::open("/pps/test/qualifiers?delta", O_WRONLY | O_CREAT);
+    QVERIFY(fd != -1);
+
+    Object subscriber(QStringLiteral("/pps/test/qualifiers"), Object::SubscribeMode);
+    QVERIFY(subscriber.isValid());
+
+    QVERIFY(ServerClient::write(fd, "[n]speed:n:42\n[i]rpm:n:3000\n"));
+    QTRY_COMPARE(subscriber.attribute(QStringLiteral("speed")), Variant(42));
+    QTRY_COMPARE(subscriber.attribute(QStringLiteral("rpm")), Variant(3000));
+
+    ::close(fd);
+}
+
+void PpsServerTest::testLargeWrite()
+{
+    Object publisher(QStringLiteral("/pps/test/large"), Object::PublishMode, true);
+    Object subscriber(QStringLiteral("/pps/test/large"), Object::SubscribeMode);
+
+    // larger than the socket buffer, so it is written in parts
+    Changeset changeset;
+    for (int i = 0; i < 5000; ++i)
+        changeset.assignments.insert(QStringLiteral("attribute%1").arg(i), Variant(QString(100, QLatin1Char('x'))));
+    QVERIFY(publisher.setAttributes(changeset));
+
+    QTRY_COMPARE(subscriber.attributeNames().count(), 5000);
+}
+
+void PpsServerTest::testDirWatcher()
+{
+    Object existing(QStringLiteral("/pps/test/dir/existing"), Object::PublishMode, true);
+
+    DirWatcher watcher(QStringLiteral("/pps/test/dir"));
+    QVERIFY2(watcher.isValid(), qPrintable(watcher.errorString()));
+    QSignalSpy addedSpy(&watcher, SIGNAL(objectAdded(QString)));
+    QSignalSpy removedSpy(&watcher, SIGNAL(objectRemoved(QString)));
+
+    QTRY_COMPARE(addedSpy.count(), 1);
+    QCOMPARE(addedSpy.at(0).at(0).toString(), QStringLiteral("existing"));
+
+    Object added(QStringLiteral("/pps/test/dir/added"), Object::PublishMode, true);
+    QTRY_COMPARE(addedSpy.count(), 2);
+    QCOMPARE(addedSpy.at(1).at(0).toString(), QStringLiteral("added"));
+
+    // objects elsewhere are not listed
+    Object other(QStringLiteral("/pps/test/other"), Object::PublishMode, true);
+
+    QVERIFY(ServerClient::unlink("/pps/test/dir/added"));
+    QTRY_COMPARE(removedSpy.count(), 1);
+    QCOMPARE(removedSpy.at(0).at(0).toString(), QStringLiteral("added"));
+
+    QCOMPARE(addedSpy.count(), 2);
+    QCOMPARE(watcher.objectNames().count(), 1);
+}
+
+QTEST_MAIN(PpsServerTest)
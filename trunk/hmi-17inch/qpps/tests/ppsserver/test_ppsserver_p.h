@@ -0,0 +1,31 @@
+#ifndef TEST_PPSSERVER_P_H
+#define TEST_PPSSERVER_P_H
+
+#include <QTest>
+
+#include "serverprocess.h"
+
+/**
+ * Runs the QNX backend of Object and DirWatcher against qppsserver.
+ */
+class PpsServerTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void testOpenMissing();
+    void testPublishSubscribe();
+    void testMultipleSubscribers();
+    void testInitialContent();
+    void testAttributeRemoval();
+    void testQualifiers();
+    void testLargeWrite();
+    void testDirWatcher();
+
+private:
+    ServerProcess m_server;
+};
+
+#endif
@@ -0,0 +1,21 @@
+include(../../common.pri)
+
+TEMPLATE = app
+
+QT += testlib
+
+# on QNX, do not run as part of make check/test
+!qnx:CONFIG += testcase
+
+TARGET = test_reactor
+
+include(../../addlibraries.pri)
+
+INCLUDEPATH += $$PWD/../../qpps
+
+target.path = $$INSTALL_PREFIX
+INSTALLS += target
+
+HEADERS += test_reactor_p.h
+
+SOURCES += test_reactor.cpp
@@ -0,0 +1,241 @@
+#include "test_reactor_p.h"
+
+#include <QEventLoop>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace QPps;
+
+static const char * const s_attributeNames[] = {
+    "rpm", "speed", "fuelLevel", "engineOilPressure", "transmissionFluidTemperature"
+};
+static const int s_attributeCount = sizeof(s_attributeNames) / sizeof(s_attributeNames[0]);
+
+/// Creates a pipe with a non-blocking read end, like a PPS object opened for delta reads
+static bool createPipe(int *readFd, int *writeFd)
+{
+    int fds[2];
+    if (::pipe(fds) != 0)
+        return false;
+
+    ::fcntl(fds[0], F_SETFL, ::fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+    *readFd = fds[0];
+    *writeFd = fds[1];
+    return true;
+}
+
+static void writeAll(int fd, const QByteArray &data)
+{
+    int written = 0;
+    while (written < data.size()) {
+        const int count = ::write(fd, data.constData() + written, data.size() - written);
+        if (count == -1 && errno != EINTR)
+            return;
+        if (count > 0)
+            written += count;
+    }
+}
+
+FrameClock::FrameClock(int interval)
+    : frames(0)
+    , maxFrameGap(0)
+    , stall(0)
+    , m_interval(interval)
+    , m_lastFrame(0)
+{
+    m_timer.setTimerType(Qt::PreciseTimer);
+    m_timer.setInterval(interval);
+    connect(&m_timer, SIGNAL(timeout()), this, SLOT(frame()));
+}
+
+void FrameClock::start()
+{
+    m_clock.start();
+    m_timer.start();
+}
+
+void FrameClock::stop()
+{
+    m_timer.stop();
+}
+
+void FrameClock::frame()
+{
+    const qint64 now = m_clock.elapsed();
+    const qint64 gap = now - m_lastFrame;
+    maxFrameGap = qMax(maxFrameGap, gap);
+    stall += qMax<qint64>(0, gap - m_interval);
+    m_lastFrame = now;
+    ++frames;
+}
+
+void PipeWriter::run()
+{
+    QByteArray delta;
+    for (int round = 0; round < m_rounds; ++round) {
+        Q_FOREACH (int fd, m_fds) {
+            delta.clear();
+            delta += "@sensors\n";
+            for (int i = 0; i < m_linesPerWrite; ++i) {
+                delta += s_attributeNames[i % s_attributeCount];
+                delta += ":n:";
+                delta += QByteArray::number(round);
+                delta += '\n';
+            }
+            writeAll(fd, delta);
+        }
+        QThread::msleep(1);
+    }
+}
+
+void ReactorTest::testDelivery()
+{
+    int readFd, writeFd;
+    QVERIFY(createPipe(&readFd, &writeFd));
+
+    ChangesetReceiver receiver;
+    receiver.reader = new ChangesetReader(readFd, QStringLiteral("/pps/test"), &receiver, "deliver");
+    Reactor::self()->attach(receiver.reader);
+    QCOMPARE(receiver.reader->thread(), Reactor::self()->thread());
+
+    // the second line is cut in half and completed by the next write
+    writeAll(writeFd, QByteArray("@test\nspeed:n:42\nrp"));
+    QTRY_COMPARE(receiver.values.value(QStringLiteral("speed")), Variant(42));
+    QVERIFY(!receiver.values.contains(QStringLiteral("rpm")));
+
+    writeAll(writeFd, QByteArray("m:n:3000\n"));
+    QTRY_COMPARE(receiver.values.value(QStringLiteral("rpm")), Variant(3000));
+
+    // parsed on the reactor thread, delivered on the receiver's
+    QCOMPARE(receiver.deliveryThread, QThread::currentThread());
+
+    // parse errors are reported
+    writeAll(writeFd, QByteArray("[broken\n"));
+    QTRY_VERIFY(!receiver.reader->takeErrorString().isEmpty());
+
+    Reactor::self()->detach(receiver.reader);
+    ::close(writeFd);
+}
+
+void ReactorTest::testReadNow()
+{
+    int readFd, writeFd;
+    QVERIFY(createPipe(&readFd, &writeFd));
+
+    ChangesetReceiver receiver;
+    receiver.reader = new ChangesetReader(readFd, QStringLiteral("/pps/test"), &receiver, "deliver");
+    Reactor::self()->attach(receiver.reader);
+
+    writeAll(writeFd, QByteArray("@test\nspeed:n:42\n"));
+    Reactor::self()->readNow(receiver.reader);
+
+    // available right away, without going through the event loop
+    const QList<Changeset> changesets = receiver.reader->takeChangesets();
+    QCOMPARE(changesets.count(), 1);
+    QCOMPARE(changesets.first().assignments.value(QStringLiteral("speed")), Variant(42));
+
+    Reactor::self()->detach(receiver.reader);
+    ::close(writeFd);
+}
+
+void ReactorTest::testBatching()
+{
+    int readFd, writeFd;
+    QVERIFY(createPipe(&readFd, &writeFd));
+
+    ChangesetReceiver receiver;
+    receiver.reader = new ChangesetReader(readFd, QStringLiteral("/pps/test"), &receiver, "deliver");
+    Reactor::self()->attach(receiver.reader);
+
+    // the receiver's thread is busy while the reactor reads many small deltas
+    static const int writes = 50;
+    for (int i = 0; i < writes; ++i) {
+        writeAll(writeFd, "speed:n:" + QByteArray::number(i) + '\n');
+        QThread::msleep(1);
+    }
+    QThread::msleep(50);
+
+    // all of them arrive with a single delivery, in order
+    QTRY_COMPARE(receiver.values.value(QStringLiteral("speed")), Variant(writes - 1));
+    QCOMPARE(receiver.deliveries, 1);
+    QVERIFY(receiver.changesets > 1);
+
+    Reactor::self()->detach(receiver.reader);
+    ::close(writeFd);
+}
+
+void ReactorTest::benchmarkStall_data()
+{
+    QTest::addColumn<bool>("useReactor");
+
+    QTest::newRow("parse on the GUI thread") << false;
+    QTest::newRow("parse on the reactor thread") << true;
+}
+
+/**
+ * Sixty objects, each receiving a sensor like delta every millisecond, while the GUI thread
+ * tries to render a frame every 16 ms. Measures how late the frames are.
+ */
+void ReactorTest::benchmarkStall()
+{
+    QFETCH(bool, useReactor);
+
+    static const int objectCount = 60;
+    static const int rounds = 500;
+    static const int linesPerWrite = 20;
+    static const int frameInterval = 16;
+
+    QList<int> writeFds;
+    QList<ChangesetReceiver *> receivers;
+    for (int i = 0; i < objectCount; ++i) {
+        int readFd, writeFd;
+        QVERIFY(createPipe(&readFd, &writeFd));
+        writeFds << writeFd;
+
+        ChangesetReceiver *receiver = new ChangesetReceiver;
+        receiver->reader = new ChangesetReader(readFd, QStringLiteral("/pps/test"), receiver, "deliver");
+        if (useReactor)
+            Reactor::self()->attach(receiver->reader);
+        else // the way every Object used to read: a socket notifier on the GUI thread
+            QMetaObject::invokeMethod(receiver->reader, "start");
+        receivers << receiver;
+    }
+
+    FrameClock frameClock(frameInterval);
+    QEventLoop loop;
+    QElapsedTimer clock;
+
+    PipeWriter writer(writeFds, rounds, linesPerWrite);
+    connect(&writer, SIGNAL(finished()), &loop, SLOT(quit()));
+
+    QBENCHMARK_ONCE {
+        clock.start();
+        frameClock.start();
+        writer.start();
+        loop.exec();
+        frameClock.stop();
+    }
+
+    // everything has been delivered in the end
+    Q_FOREACH (ChangesetReceiver *receiver, receivers)
+        QTRY_COMPARE(receiver->values.value(QStringLiteral("rpm")), Variant(rounds - 1));
+
+    qDebug("%d updates/s, %d frames, max frame gap %lld ms, total stall %lld ms",
+           int(qint64(objectCount) * rounds * linesPerWrite * 1000 / qMax<qint64>(clock.elapsed(), 1)),
+           frameClock.frames, frameClock.maxFrameGap, frameClock.stall);
+
+    Q_FOREACH (ChangesetReceiver *receiver, receivers) {
+        if (useReactor)
+            Reactor::self()->detach(receiver->reader);
+        else
+            delete receiver->reader;
+        delete receiver;
+    }
+
+    Q_FOREACH (int fd, writeFds)
+        ::close(fd);
+}
+
+QTEST_MAIN(ReactorTest)
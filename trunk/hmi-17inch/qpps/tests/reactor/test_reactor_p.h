@@ -0,0 +1,106 @@
+#ifndef TEST_REACTOR_P_H
+#define TEST_REACTOR_P_H
+
+#include <QTest>
+
+#include "reactor_p.h"
+#include "variant.h"
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QThread>
+#include <QTimer>
+
+/// Collects what a ChangesetReader delivers
+class ChangesetReceiver : public QObject
+{
+    Q_OBJECT
+
+public:
+    ChangesetReceiver()
+        : reader(0)
+        , deliveries(0)
+        , changesets(0)
+        , deliveryThread(0)
+    {}
+
+    QPps::ChangesetReader *reader;
+    int deliveries;
+    int changesets;
+    QHash<QString, QPps::Variant> values;
+    QThread *deliveryThread;
+
+public Q_SLOTS:
+    void deliver()
+    {
+        ++deliveries;
+        deliveryThread = QThread::currentThread();
+
+        Q_FOREACH (const QPps::Changeset &changeset, reader->takeChangesets()) {
+            ++changesets;
+            QMap<QString, QPps::Variant>::ConstIterator it = changeset.assignments.constBegin();
+            for (; it != changeset.assignments.constEnd(); ++it)
+                values.insert(it.key(), it.value());
+        }
+    }
+};
+
+/// Measures how late the frames of a GUI thread rendering at a fixed interval are
+class FrameClock : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit FrameClock(int interval);
+
+    void start();
+    void stop();
+
+    int frames;
+    qint64 maxFrameGap;
+    qint64 stall; ///< sum of all frame delays, in msecs
+
+private Q_SLOTS:
+    void frame();
+
+private:
+    int m_interval;
+    qint64 m_lastFrame;
+    QElapsedTimer m_clock;
+    QTimer m_timer;
+};
+
+/// Writes sensor like deltas into a set of pipes at a fixed rate
+class PipeWriter : public QThread
+{
+    Q_OBJECT
+
+public:
+    PipeWriter(const QList<int> &fds, int rounds, int linesPerWrite)
+        : m_fds(fds)
+        , m_rounds(rounds)
+        , m_linesPerWrite(linesPerWrite)
+    {}
+
+protected:
+    void run();
+
+private:
+    QList<int> m_fds;
+    int m_rounds;
+    int m_linesPerWrite;
+};
+
+class ReactorTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testDelivery();
+    void testReadNow();
+    void testBatching();
+
+    void benchmarkStall_data();
+    void benchmarkStall();
+};
+
+#endif
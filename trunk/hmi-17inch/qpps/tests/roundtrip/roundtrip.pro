@@ -0,0 +1,23 @@
+include(../../common.pri)
+
+TEMPLATE = app
+
+QT += testlib
+
+CONFIG += testcase
+
+TARGET = test_roundtrip
+
+include(../../addlibraries.pri)
+
+INCLUDEPATH += $$PWD/../../qpps
+
+# measures the QNX backend against qppsserver instead of the simulator
+pps_server: DEFINES += QPPS_SERVER_BUILD QPPS_SERVER_BINARY=\\\"$$BUILD_ROOT/bin/qppsserver\\\"
+
+target.path = $$INSTALL_PREFIX
+INSTALLS += target
+
+HEADERS += test_roundtrip_p.h
+
+SOURCES += test_roundtrip.cpp
@@ -0,0 +1,105 @@
+#include "test_roundtrip_p.h"
+
+#include <QElapsedTimer>
+#include <QEventLoop>
+
+using namespace QPps;
+
+void RoundtripTest::initTestCase()
+{
+    qRegisterMetaType<QPps::Variant>("QPps::Variant");
+
+#ifdef QPPS_SERVER_BUILD
+    QVERIFY(m_server.start());
+#endif
+}
+
+/**
+ * One publisher writing single attribute updates as fast as it can, one subscriber receiving
+ * them.
+ */
+void RoundtripTest::benchmarkThroughput()
+{
+    static const int updates = 10000;
+
+    Object publisher(QStringLiteral("/pps/test/throughput"), Object::PublishMode, true);
+    QVERIFY2(publisher.isValid(), qPrintable(publisher.errorString()));
+
+    Object subscriber(QStringLiteral("/pps/test/throughput"), Object::SubscribeMode);
+    QVERIFY2(subscriber.isValid(), qPrintable(subscriber.errorString()));
+
+    UpdateCounter counter;
+    connect(&subscriber, SIGNAL(attributeChanged(QString,QPps::Variant)),
+            &counter, SLOT(attributeChanged(QString,QPps::Variant)));
+
+    QEventLoop loop;
+    connect(&counter, SIGNAL(done()), &loop, SLOT(quit()));
+
+    QElapsedTimer clock;
+    int round = 0;
+
+    QBENCHMARK {
+        // distinct values, unchanged ones are not delivered by the simulator
+        const int base = round++ * updates;
+        counter.count = 0;
+        counter.expectedValue = base + updates - 1;
+
+        clock.start();
+        for (int i = 0; i < updates; ++i)
+            publisher.setAttribute(QStringLiteral("rpm"), Variant(base + i));
+
+        if (counter.lastValue != counter.expectedValue)
+            loop.exec();
+    }
+
+    QCOMPARE(counter.lastValue, counter.expectedValue);
+    qDebug("%d updates in %lld ms, %d delivered", updates, clock.elapsed(), counter.count);
+}
+
+/**
+ * Time from writing an attribute until the answer of a subscriber, which writes it back to
+ * another object, arrives.
+ */
+void RoundtripTest::benchmarkLatency()
+{
+    static const int roundtrips = 1000;
+
+    Object ping(QStringLiteral("/pps/test/ping"), Object::PublishMode, true);
+    Object pong(QStringLiteral("/pps/test/pong"), Object::PublishMode, true);
+    QVERIFY2(ping.isValid(), qPrintable(ping.errorString()));
+    QVERIFY2(pong.isValid(), qPrintable(pong.errorString()));
+
+    Object pingSubscriber(QStringLiteral("/pps/test/ping"), Object::SubscribeMode);
+    Object pongSubscriber(QStringLiteral("/pps/test/pong"), Object::SubscribeMode);
+
+    Echo echo(&pong);
+    connect(&pingSubscriber, SIGNAL(attributeChanged(QString,QPps::Variant)),
+            &echo, SLOT(ping(QString,QPps::Variant)));
+
+    UpdateCounter counter;
+    connect(&pongSubscriber, SIGNAL(attributeChanged(QString,QPps::Variant)),
+            &counter, SLOT(attributeChanged(QString,QPps::Variant)));
+
+    QEventLoop loop;
+    connect(&counter, SIGNAL(done()), &loop, SLOT(quit()));
+
+    QElapsedTimer clock;
+    int value = 0;
+
+    QBENCHMARK {
+        clock.start();
+        for (int i = 0; i < roundtrips; ++i) {
+            counter.expectedValue = value;
+            ping.setAttribute(QStringLiteral("value"), Variant(value++));
+
+            // the simulator answers right away, the server through the event loop
+            if (counter.lastValue != counter.expectedValue)
+                loop.exec();
+        }
+    }
+
+    QCOMPARE(counter.lastValue, value - 1);
+    qDebug("%d roundtrips in %lld ms", roundtrips, clock.elapsed());
+}
+
+QTEST_MAIN(RoundtripTest)
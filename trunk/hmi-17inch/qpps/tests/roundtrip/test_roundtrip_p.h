@@ -0,0 +1,86 @@
+#ifndef TEST_ROUNDTRIP_P_H
+#define TEST_ROUNDTRIP_P_H
+
+#include <QTest>
+
+#include "object.h"
+
+#ifdef QPPS_SERVER_BUILD
+#include "../ppsserver/serverprocess.h"
+#endif
+
+/**
+ * Answers every "ping" written to one object with the same value on another one.
+ */
+class Echo : public QObject
+{
+    Q_OBJECT
+public:
+    Echo(QPps::Object *pong)
+        : m_pong(pong)
+    {
+    }
+
+public Q_SLOTS:
+    void ping(const QString &name, const QPps::Variant &value)
+    {
+        m_pong->setAttribute(name, value);
+    }
+
+private:
+    QPps::Object *m_pong;
+};
+
+/**
+ * Counts the updates of a subscriber, and stops an event loop once the expected value arrived.
+ */
+class UpdateCounter : public QObject
+{
+    Q_OBJECT
+public:
+    UpdateCounter()
+        : count(0)
+        , lastValue(-1)
+        , expectedValue(-1)
+    {
+    }
+
+    int count;
+    int lastValue;
+    int expectedValue;
+
+Q_SIGNALS:
+    void done();
+
+public Q_SLOTS:
+    void attributeChanged(const QString &name, const QPps::Variant &value)
+    {
+        Q_UNUSED(name);
+        ++count;
+        lastValue = value.toInt();
+        if (lastValue == expectedValue)
+            emit done();
+    }
+};
+
+/**
+ * Throughput and latency of a publisher and a subscriber in the same process. Built against the
+ * simulator by default; with CONFIG+=pps_server every update goes through qppsserver and the
+ * reactor thread, like on the target.
+ */
+class RoundtripTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+
+    void benchmarkThroughput();
+    void benchmarkLatency();
+
+private:
+#ifdef QPPS_SERVER_BUILD
+    ServerProcess m_server;
+#endif
+};
+
+#endif
@@ -0,0 +1,18 @@
+include(../../common.pri)
+
+TEMPLATE = app
+
+QT += testlib
+
+CONFIG += testcase
+
+TARGET = test_servicewaiter
+
+include(../../addlibraries.pri)
+
+INCLUDEPATH += $$PWD/../../qpps
+
+target.path = $$INSTALL_PREFIX
+INSTALLS += target
+
+SOURCES += test_servicewaiter.cpp
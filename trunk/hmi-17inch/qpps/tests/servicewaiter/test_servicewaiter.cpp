@@ -0,0 +1,87 @@
+#include <QtTest/QtTest>
+
+#include "servicewaiter.h"
+#include "simulator.h"
+
+using namespace QPps;
+
+class ServiceWaiterTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void init();
+
+    void testExistingObjects();
+    void testAddedObjects();
+    void testTimeout();
+};
+
+void ServiceWaiterTest::init()
+{
+    Simulator::self()->reset();
+}
+
+void ServiceWaiterTest::testExistingObjects()
+{
+    Simulator::self()->insertObject(QStringLiteral("/pps/services/test/control"));
+    Simulator::self()->insertObject(QStringLiteral("/pps/services/test/status"));
+    // not waited for
+    Simulator::self()->insertObject(QStringLiteral("/pps/services/test/other"));
+
+    ServiceWaiter waiter(QStringList() << QStringLiteral("/pps/services/test/control")
+                                       << QStringLiteral("/pps/services/test/status"));
+    QSignalSpy readySpy(&waiter, SIGNAL(ready()));
+    QSignalSpy objectReadySpy(&waiter, SIGNAL(objectReady(QString)));
+
+    // emitted from the event loop, after the caller connected
+    QVERIFY(!waiter.isReady());
+    QTRY_COMPARE(readySpy.count(), 1);
+    QVERIFY(waiter.isReady());
+    QVERIFY(waiter.missingObjectPaths().isEmpty());
+    QCOMPARE(objectReadySpy.count(), 2);
+}
+
+void ServiceWaiterTest::testAddedObjects()
+{
+    Simulator::self()->insertObject(QStringLiteral("/pps/services/networking/control"));
+
+    // objects in different directories
+    ServiceWaiter waiter(QStringList() << QStringLiteral("/pps/services/networking/control")
+                                       << QStringLiteral("/pps/services/networking/all/status_public"));
+    QSignalSpy readySpy(&waiter, SIGNAL(ready()));
+    QSignalSpy objectReadySpy(&waiter, SIGNAL(objectReady(QString)));
+
+    QTRY_COMPARE(objectReadySpy.count(), 1);
+    QCOMPARE(objectReadySpy.at(0).at(0).toString(), QStringLiteral("/pps/services/networking/control"));
+    QCOMPARE(waiter.missingObjectPaths(), QStringList(QStringLiteral("/pps/services/networking/all/status_public")));
+    QCOMPARE(readySpy.count(), 0);
+
+    Simulator::self()->insertObject(QStringLiteral("/pps/services/networking/all/status_public"));
+    QTRY_COMPARE(readySpy.count(), 1);
+    QCOMPARE(objectReadySpy.count(), 2);
+
+    // single shot, objects added later are not reported
+    Simulator::self()->insertObject(QStringLiteral("/pps/services/networking/all/other"));
+    QTest::qWait(50);
+    QCOMPARE(readySpy.count(), 1);
+}
+
+void ServiceWaiterTest::testTimeout()
+{
+    ServiceWaiter waiter(QStringLiteral("/pps/services/test/late"));
+    waiter.setTimeout(50);
+    QSignalSpy readySpy(&waiter, SIGNAL(ready()));
+    QSignalSpy timedOutSpy(&waiter, SIGNAL(timedOut()));
+
+    QTRY_COMPARE(timedOutSpy.count(), 1);
+    QVERIFY(!waiter.isReady());
+
+    // keeps waiting after the timeout
+    Simulator::self()->insertObject(QStringLiteral("/pps/services/test/late"));
+    QTRY_COMPARE(readySpy.count(), 1);
+    QCOMPARE(timedOutSpy.count(), 1);
+}
+
+QTEST_MAIN(ServiceWaiterTest)
+#include "test_servicewaiter.moc"
@@ -1,10 +1,15 @@
 #include <QtTest/QtTest>
 
+#include "changeset.h"
+#include "key.h"
 #include "object.h"
 #include "simulator.h"
 
 using namespace QPps;
 
+Q_DECLARE_METATYPE(QPps::Variant)
+Q_DECLARE_METATYPE(QPps::Changeset)
+
 static void initDemoData()
 {
     QPps::Simulator::self()->insertAttribute(QStringLiteral("/pps/qnxcar/profile/user"), QStringLiteral("id"), QByteArrayLiteral("1"), QByteArrayLiteral("n"));
@@ -17,13 +22,29 @@ class SimulatorTest : public QObject
     Q_OBJECT
 
 private Q_SLOTS:
+    void initTestCase();
     void simulatorObject_publishModes();
     void simulatorObject_withoutAttributeCache();
+    void simulatorObject_writeBehind();
+    void simulatorObject_writeBehindReadBack();
+    void simulatorObject_coalescedDelivery();
+    void simulatorObject_deadband();
+    void simulatorObject_minimumUpdateInterval();
+    void simulatorObject_attributeKeys();
+    void simulatorObject_changesets();
+    void simulatorObject_largeObject();
+    void simulator_setObjectAttributes();
 };
 
 /// This PPS Object has attributes such as 'id', ...
 static const QString PPS_PATH = QStringLiteral("/pps/qnxcar/profile/user");
 
+void SimulatorTest::initTestCase()
+{
+    qRegisterMetaType<QPps::Variant>("QPps::Variant");
+    qRegisterMetaType<QPps::Changeset>("QPps::Changeset");
+}
+
 void SimulatorTest::simulatorObject_publishModes()
 {
     QPps::Simulator::self()->reset();
@@ -117,5 +138,327 @@ void SimulatorTest::simulatorObject_withoutAttributeCache()
     QVERIFY(object.errorString().isEmpty());
 }
 
+void SimulatorTest::simulatorObject_writeBehind()
+{
+    Simulator::self()->reset();
+    initDemoData();
+
+    Object reader(PPS_PATH, Object::SubscribeMode);
+    QSignalSpy spy(&reader, SIGNAL(attributeChanged(QString,QPps::Variant)));
+
+    Object writer(PPS_PATH, Object::PublishMode);
+    QVERIFY(!writer.writeBehindEnabled());
+    writer.setWriteBehindEnabled(true);
+    QVERIFY(writer.writeBehindEnabled());
+
+    // a slider being dragged: only the last value must be written
+    for (int i = 0; i < 10; ++i)
+        QVERIFY(writer.setAttribute(QStringLiteral("temperature"), Variant(i)));
+    QVERIFY(writer.hasPendingChanges());
+    QCOMPARE(spy.count(), 0);
+
+    QTRY_VERIFY(!writer.hasPendingChanges());
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(spy.at(0).at(0).toString(), QStringLiteral("temperature"));
+    QCOMPARE(spy.at(0).at(1).value<QPps::Variant>(), Variant(9));
+
+    // a removal replaces a pending assignment of the same attribute
+    spy.clear();
+    QVERIFY(writer.setAttribute(QStringLiteral("fanSpeed"), Variant(3)));
+    QVERIFY(writer.removeAttribute(QStringLiteral("fanSpeed")));
+    QVERIFY(writer.flush());
+    QVERIFY(!writer.hasPendingChanges());
+    QCOMPARE(spy.count(), 0);
+
+    // commands are written on flush() without waiting for the interval
+    writer.setWriteBehindInterval(60000);
+    QCOMPARE(writer.writeBehindInterval(), 60000);
+    QVERIFY(writer.setAttribute(QStringLiteral("store_cmd"), Variant(1)));
+    QCOMPARE(spy.count(), 0);
+    QVERIFY(writer.flush());
+    QCOMPARE(spy.count(), 1);
+
+    // disabling write-behind mode writes what is pending
+    QVERIFY(writer.setAttribute(QStringLiteral("store_cmd"), Variant(2)));
+    writer.setWriteBehindEnabled(false);
+    QVERIFY(!writer.hasPendingChanges());
+    QCOMPARE(spy.count(), 2);
+
+    // writing is still checked against the publication mode
+    reader.setWriteBehindEnabled(true);
+    QVERIFY(!reader.setAttribute(QStringLiteral("foo"), Variant("bar")));
+    QVERIFY(!reader.hasPendingChanges());
+}
+
+void SimulatorTest::simulatorObject_writeBehindReadBack()
+{
+    Simulator::self()->reset();
+    initDemoData();
+
+    Object object(PPS_PATH, Object::PublishAndSubscribeMode);
+    object.setAttributeCacheEnabled(true);
+    object.setWriteBehindEnabled(true);
+    object.setWriteBehindInterval(60000);
+
+    // pending changes are visible before they are written
+    QVERIFY(object.setAttribute(QStringLiteral("fullName"), Variant(QStringLiteral("Jane Doe"))));
+    QVERIFY(object.setAttribute(QStringLiteral("theme"), Variant(QStringLiteral("jeep"))));
+    QVERIFY(object.removeAttribute(QStringLiteral("avatar")));
+    QVERIFY(object.hasPendingChanges());
+    QCOMPARE(object.attribute(QStringLiteral("fullName")), Variant(QStringLiteral("Jane Doe")));
+    QCOMPARE(object.attribute(QStringLiteral("theme")), Variant(QStringLiteral("jeep")));
+    QCOMPARE(object.attribute(QStringLiteral("avatar"), Variant(42)), Variant(42));
+    QCOMPARE(object.attributeNames(), QStringList() << QStringLiteral("fullName") << QStringLiteral("id") << QStringLiteral("theme"));
+
+    // and stay so once they are
+    QVERIFY(object.flush());
+    QCOMPARE(object.attribute(QStringLiteral("fullName")), Variant(QStringLiteral("Jane Doe")));
+    QCOMPARE(object.attributeNames(), QStringList() << QStringLiteral("fullName") << QStringLiteral("id") << QStringLiteral("theme"));
+}
+
+void SimulatorTest::simulatorObject_coalescedDelivery()
+{
+    Simulator::self()->reset();
+    initDemoData();
+
+    Object reader(PPS_PATH, Object::SubscribeMode);
+    reader.setAttributeCacheEnabled(true);
+    reader.setUpdateCoalescingEnabled(true);
+    QVERIFY(reader.updateCoalescingEnabled());
+    QCOMPARE(reader.updateCoalescingInterval(), 16);
+    QSignalSpy changeSpy(&reader, SIGNAL(attributeChanged(QString,QPps::Variant)));
+    QSignalSpy changesetSpy(&reader, SIGNAL(attributesChanged(QPps::Changeset)));
+
+    QObject writer;
+    QVERIFY(Simulator::self()->registerClient(PPS_PATH, &writer));
+
+    for (int i = 0; i < 100; ++i) {
+        Simulator::self()->clientSetAttribute(&writer, QStringLiteral("rpm"), QByteArray::number(1000 + i), QByteArrayLiteral("n"));
+        Simulator::self()->clientSetAttribute(&writer, QStringLiteral("speed"), QByteArray::number(i), QByteArrayLiteral("n"));
+    }
+
+    // nothing is delivered before the next frame, but the cache is up to date
+    QCOMPARE(changeSpy.count(), 0);
+    QCOMPARE(reader.attribute(QStringLiteral("rpm")), Variant(1099));
+
+    // both attributes arrive in one changeset, with their latest values
+    QTRY_COMPARE(changesetSpy.count(), 1);
+    QCOMPARE(changeSpy.count(), 2);
+    QCOMPARE(reader.receivedUpdates(), quint64(200));
+    QCOMPARE(reader.deliveredUpdates(), quint64(2));
+
+    reader.resetUpdateCounters();
+    QCOMPARE(reader.receivedUpdates(), quint64(0));
+    QCOMPARE(reader.deliveredUpdates(), quint64(0));
+
+    // a removal replaces a pending value
+    Simulator::self()->clientSetAttribute(&writer, QStringLiteral("fuel"), QByteArrayLiteral("50"), QByteArrayLiteral("n"));
+    Simulator::self()->clientRemoveAttribute(&writer, QStringLiteral("fuel"));
+    QSignalSpy removalSpy(&reader, SIGNAL(attributeRemoved(QString)));
+    QTRY_COMPARE(removalSpy.count(), 1);
+    QCOMPARE(changeSpy.count(), 2);
+
+    Simulator::self()->unregisterClient(&writer);
+}
+
+void SimulatorTest::simulatorObject_deadband()
+{
+    Simulator::self()->reset();
+    initDemoData();
+
+    Object reader(PPS_PATH, Object::SubscribeMode);
+    reader.setUpdateDeadband(QStringLiteral("rpm"), 10);
+    QCOMPARE(reader.updateDeadband(QStringLiteral("rpm")), 10.0);
+    QCOMPARE(reader.updateDeadband(QStringLiteral("speed")), 0.0);
+    QSignalSpy spy(&reader, SIGNAL(attributeChanged(QString,QPps::Variant)));
+
+    QObject writer;
+    QVERIFY(Simulator::self()->registerClient(PPS_PATH, &writer));
+
+    const int values[] = { 1000, 1005, 1009, 1010, 1001, 990, 995 };
+    for (unsigned int i = 0; i < sizeof(values) / sizeof(values[0]); ++i)
+        Simulator::self()->clientSetAttribute(&writer, QStringLiteral("rpm"), QByteArray::number(values[i]), QByteArrayLiteral("n"));
+
+    // 1000 is delivered, 1010 and 990 differ enough from the last delivered value
+    QCOMPARE(spy.count(), 3);
+    QCOMPARE(spy.at(0).at(1).value<QPps::Variant>(), Variant(1000));
+    QCOMPARE(spy.at(1).at(1).value<QPps::Variant>(), Variant(1010));
+    QCOMPARE(spy.at(2).at(1).value<QPps::Variant>(), Variant(990));
+    QCOMPARE(reader.receivedUpdates(), quint64(7));
+    QCOMPARE(reader.deliveredUpdates(), quint64(3));
+
+    // non numeric values are not affected
+    Simulator::self()->clientSetAttribute(&writer, QStringLiteral("rpm"), QByteArrayLiteral("unknown"), QByteArrayLiteral("s"));
+    QCOMPARE(spy.count(), 4);
+
+    Simulator::self()->unregisterClient(&writer);
+}
+
+void SimulatorTest::simulatorObject_minimumUpdateInterval()
+{
+    Simulator::self()->reset();
+    initDemoData();
+
+    Object reader(PPS_PATH, Object::SubscribeMode);
+    reader.setMinimumUpdateInterval(QStringLiteral("rpm"), 100);
+    QCOMPARE(reader.minimumUpdateInterval(QStringLiteral("rpm")), 100);
+    QSignalSpy spy(&reader, SIGNAL(attributeChanged(QString,QPps::Variant)));
+
+    QObject writer;
+    QVERIFY(Simulator::self()->registerClient(PPS_PATH, &writer));
+
+    // the first change is delivered right away, the following ones are held back
+    for (int i = 0; i < 10; ++i)
+        Simulator::self()->clientSetAttribute(&writer, QStringLiteral("rpm"), QByteArray::number(1000 + i), QByteArrayLiteral("n"));
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(spy.at(0).at(1).value<QPps::Variant>(), Variant(1000));
+
+    // other attributes are not limited
+    Simulator::self()->clientSetAttribute(&writer, QStringLiteral("speed"), QByteArrayLiteral("50"), QByteArrayLiteral("n"));
+    QCOMPARE(spy.count(), 2);
+
+    // the latest held back value follows once the interval has passed
+    QTRY_COMPARE(spy.count(), 3);
+    QCOMPARE(spy.at(2).at(1).value<QPps::Variant>(), Variant(1009));
+    QCOMPARE(reader.receivedUpdates(), quint64(11));
+    QCOMPARE(reader.deliveredUpdates(), quint64(3));
+
+    Simulator::self()->unregisterClient(&writer);
+}
+
+void SimulatorTest::simulatorObject_attributeKeys()
+{
+    Simulator::self()->reset();
+    initDemoData();
+
+    const int rpmKey = Key::intern(QStringLiteral("rpm"));
+
+    Object reader(PPS_PATH, Object::SubscribeMode);
+    reader.setUpdateCoalescingEnabled(true);
+    QSignalSpy keySpy(&reader, SIGNAL(attributeKeyChanged(int,QString,QPps::Variant)));
+    QSignalSpy changesetSpy(&reader, SIGNAL(attributesChanged(QPps::Changeset)));
+
+    QObject writer;
+    QVERIFY(Simulator::self()->registerClient(PPS_PATH, &writer));
+
+    Simulator::self()->clientSetAttribute(&writer, QStringLiteral("rpm"), QByteArrayLiteral("1000"), QByteArrayLiteral("n"));
+    Simulator::self()->clientSetAttribute(&writer, QStringLiteral("notInterned"), QByteArrayLiteral("1"), QByteArrayLiteral("n"));
+
+    // the ids are resolved once by the simulator and survive being held back
+    QTRY_COMPARE(changesetSpy.count(), 1);
+    QCOMPARE(keySpy.count(), 2);
+    QCOMPARE(keySpy.at(0).at(1).toString(), QStringLiteral("notInterned"));
+    QCOMPARE(keySpy.at(0).at(0).toInt(), int(Key::Invalid));
+    QCOMPARE(keySpy.at(1).at(1).toString(), QStringLiteral("rpm"));
+    QCOMPARE(keySpy.at(1).at(0).toInt(), rpmKey);
+
+    const Changeset changes = changesetSpy.at(0).at(0).value<QPps::Changeset>();
+    QCOMPARE(changes.keys.value(QStringLiteral("rpm"), Key::Invalid), rpmKey);
+    QVERIFY(!changes.keys.contains(QStringLiteral("notInterned")));
+
+    Simulator::self()->unregisterClient(&writer);
+}
+
+void SimulatorTest::simulatorObject_changesets()
+{
+    Simulator::self()->reset();
+    initDemoData();
+
+    Object reader(PPS_PATH, Object::SubscribeMode);
+    QSignalSpy spy(&reader, SIGNAL(attributesChanged(QPps::Changeset)));
+
+    Object writer(PPS_PATH, Object::PublishMode);
+
+    // one write, one changeset, holding only what changed
+    Changeset changeset;
+    changeset.assignments.insert(QStringLiteral("id"), Variant(1)); // unchanged
+    changeset.assignments.insert(QStringLiteral("fullName"), Variant(QStringLiteral("Jane Doe")));
+    changeset.assignments.insert(QStringLiteral("theme"), Variant(QStringLiteral("jeep")));
+    changeset.removals << QStringLiteral("avatar") << QStringLiteral("unknown");
+    QVERIFY(writer.setAttributes(changeset));
+
+    QCOMPARE(spy.count(), 1);
+    const Changeset changes = spy.at(0).at(0).value<QPps::Changeset>();
+    QCOMPARE(changes.assignments.keys(), QStringList() << QStringLiteral("fullName") << QStringLiteral("theme"));
+    QCOMPARE(changes.removals, QSet<QString>() << QStringLiteral("avatar"));
+
+    // nothing changed, nothing delivered
+    QVERIFY(writer.setAttributes(changeset));
+    QCOMPARE(spy.count(), 1);
+
+    // the initial listing is one changeset as well
+    spy.clear();
+    reader.setAttributeCacheEnabled(true);
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(spy.at(0).at(0).value<QPps::Changeset>().assignments.count(), 3);
+    QCOMPARE(reader.attributeNames(), QStringList() << QStringLiteral("fullName") << QStringLiteral("id") << QStringLiteral("theme"));
+}
+
+/**
+ * A contact list sized object: loading it, and changing single attributes of it while many
+ * other objects have clients.
+ */
+void SimulatorTest::simulatorObject_largeObject()
+{
+    static const int attributeCount = 5000;
+
+    Simulator::self()->reset();
+
+    QList<Object *> others;
+    for (int i = 0; i < 200; ++i)
+        others << new Object(QStringLiteral("/pps/test/other%1").arg(i), Object::SubscribeMode, true);
+
+    Object reader(PPS_PATH, Object::SubscribeMode, true);
+    reader.setAttributeCacheEnabled(true);
+    Object writer(PPS_PATH, Object::PublishMode);
+
+    int round = 0;
+    QBENCHMARK {
+        Changeset changeset;
+        for (int i = 0; i < attributeCount; ++i)
+            changeset.assignments.insert(QStringLiteral("contact%1").arg(i), Variant(round));
+        QVERIFY(writer.setAttributes(changeset));
+
+        for (int i = 0; i < attributeCount; ++i) {
+            writer.setAttribute(QStringLiteral("contact%1").arg(i), Variant(round + i + 1));
+            reader.attribute(QStringLiteral("contact%1").arg(i));
+        }
+
+        ++round;
+    }
+
+    QCOMPARE(reader.attributeNames().count(), attributeCount);
+
+    qDeleteAll(others);
+}
+
+void SimulatorTest::simulator_setObjectAttributes()
+{
+    Simulator::self()->reset();
+    initDemoData();
+
+    Object reader(PPS_PATH, Object::SubscribeMode);
+    reader.setAttributeCacheEnabled(true);
+    QSignalSpy spy(&reader, SIGNAL(attributesChanged(QPps::Changeset)));
+
+    // a command and its reply arrive together, like from another process
+    Changeset reply;
+    reply.assignments.insert(QStringLiteral("[n]id"), Variant(2));
+    reply.assignments.insert(QStringLiteral("err"), Variant(QStringLiteral("ENOENT")));
+    reply.assignments.insert(QStringLiteral("dat"), Variant(QStringLiteral("no such profile")));
+    reply.removals << QStringLiteral("avatar");
+    Simulator::self()->setObjectAttributes(PPS_PATH, reply);
+
+    QCOMPARE(spy.count(), 1);
+    const Changeset changes = spy.at(0).at(0).value<QPps::Changeset>();
+    QCOMPARE(changes.assignments.keys(), QStringList() << QStringLiteral("dat") << QStringLiteral("err") << QStringLiteral("id"));
+    QCOMPARE(changes.removals, QSet<QString>() << QStringLiteral("avatar"));
+    QCOMPARE(reader.attribute(QStringLiteral("id")), Variant(2));
+
+    // creates missing objects
+    Simulator::self()->setObjectAttributes(QStringLiteral("/pps/test/new"), reply);
+    QVERIFY(Simulator::self()->objectPaths().contains(QStringLiteral("/pps/test/new")));
+}
+
 QTEST_MAIN(SimulatorTest)
 #include "test_simulator.moc"
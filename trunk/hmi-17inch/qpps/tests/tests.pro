@@ -1,5 +1,11 @@
 TEMPLATE = subdirs
 
 qnx:SUBDIRS += dirwatcher object
-SUBDIRS += variant
-!qnx: SUBDIRS += simulator
+SUBDIRS += deltaparser key variant
+# the reactor test feeds pipes
+unix: SUBDIRS += reactor
+!qnx:!pps_server: SUBDIRS += simulator servicewaiter
+# the QNX backend against qppsserver, see qpps.pro
+pps_server: SUBDIRS += ppsserver
+# simulator or qppsserver
+!qnx: SUBDIRS += roundtrip
@@ -1,5 +1,6 @@
 #include "Palette.h"
 
+#include <QDataStream>
 #include <QMetaEnum>
 #include <QMetaObject>
 
@@ -40,6 +41,39 @@ QDebug operator<<(QDebug dbg, const PaletteData& o)
     return dbg << o.m_colorMap;
 }
 
+QDataStream &operator<<(QDataStream &stream, const PaletteData &o)
+{
+    stream << qint32(o.m_colorMap.count());
+
+    QHash<int, QColor>::const_iterator it = o.m_colorMap.constBegin();
+    for (; it != o.m_colorMap.constEnd(); ++it)
+        stream << qint32(it.key()) << quint32(it.value().rgba());
+
+    return stream;
+}
+
+QDataStream &operator>>(QDataStream &stream, PaletteData &o)
+{
+    o.m_colorMap.clear();
+
+    qint32 count = 0;
+    stream >> count;
+    if (count < 0 || count > PaletteItem::NoRole) {
+        stream.setStatus(QDataStream::ReadCorruptData);
+        return stream;
+    }
+
+    o.m_colorMap.reserve(count);
+    for (int i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+        qint32 role = 0;
+        quint32 rgba = 0;
+        stream >> role >> rgba;
+        o.m_colorMap.insert(role, QColor::fromRgba(rgba));
+    }
+
+    return stream;
+}
+
 PaletteParser::PaletteParser(const QVariant &data, QObject *parent)
     : QObject(parent)
     , m_data(data)
@@ -8,6 +8,8 @@
 #include <QColor>
 #include <QHash>
 
+class QDataStream;
+
 namespace QnxCarUi {
 
 class QTQNXCAR_UI_EXPORT PaletteData
@@ -24,12 +26,18 @@ public:
 
 private:
     friend QDebug operator<<(QDebug dbg, const PaletteData &o);
+    friend QDataStream &operator<<(QDataStream &stream, const PaletteData &o);
+    friend QDataStream &operator>>(QDataStream &stream, PaletteData &o);
 
     QHash<int, QColor> m_colorMap;
 };
 
 QDebug operator<<(QDebug dbg, const PaletteData &o);
 
+/// Writes the colors as pairs of role and ARGB value, see PaletteManager for the compiled palettes
+QTQNXCAR_UI_EXPORT QDataStream &operator<<(QDataStream &stream, const PaletteData &o);
+QTQNXCAR_UI_EXPORT QDataStream &operator>>(QDataStream &stream, PaletteData &o);
+
 class QTQNXCAR_UI_EXPORT PaletteParser : public QObject
 {
     Q_OBJECT
@@ -5,17 +5,48 @@
 
 #include "qnxcar/Theme.h"
 
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
 #include <QFile>
+#include <QFileInfo>
+#include <QMetaEnum>
 #include <QQmlEngine>
 #include <QQmlComponent>
-#include <iostream>
+#include <QSaveFile>
+#include <QScopedPointer>
 
 namespace QnxCarUi {
 
+/// Leads every compiled palette, bump the version when the format changes
+static const quint32 compiledPaletteMagic = 0x51504c54; // "QPLT"
+static const quint32 compiledPaletteVersion = 1;
+
+/**
+ * Hashes the names and values of PaletteItem::ColorRole, compiled palettes store the
+ * roles as numbers and have to be compiled again when the enum changes.
+ */
+static QByteArray colorRolesFingerprint()
+{
+    const QMetaObject &metaObject = PaletteItem::staticMetaObject;
+    const QMetaEnum roles = metaObject.enumerator(metaObject.indexOfEnumerator("ColorRole"));
+
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    for (int i = 0; i < roles.keyCount(); ++i) {
+        hash.addData(roles.key(i));
+        hash.addData(QByteArray::number(roles.value(i)));
+    }
+
+    return hash.result();
+}
+
 PaletteManager::PaletteManager(ThemeManager *theme, QObject *parent)
     : QObject(parent)
     , m_paletteItem(new PaletteItem(this))
     , m_themeManager(theme)
+    , m_palettesLoaded(false)
 {
     connect(m_themeManager->theme(), SIGNAL(themeChanged(QString)), this, SLOT(updatePalette()));
 
@@ -28,34 +59,137 @@ PaletteItem* PaletteManager::palette() const
     return m_paletteItem;
 }
 
-PaletteData PaletteManager::paletteForTheme(const QString& theme) const
+QStringList PaletteManager::themes() const
 {
-    QString path = QString(QStringLiteral("%1/palettes/%2.qml"))
-        .arg(m_themeManager->assetsDirectory())
-        .arg(theme);
+    return m_palettes.keys();
+}
 
-    if (!QFile(path).exists()) {
-        qWarning() << "Palette definition not found in:" << path;
-        return PaletteData();
+PaletteData PaletteManager::paletteForTheme(const QString &theme) const
+{
+    return m_palettes.value(theme);
+}
+
+void PaletteManager::updatePalette()
+{
+    if (!m_palettesLoaded) {
+        loadPalettes();
+        m_palettesLoaded = true;
     }
 
-    QQmlEngine engine;
-    QQmlComponent component(&engine, path);
-    QObject *object = component.create();
+    const QString theme = m_themeManager->theme()->current();
+    if (!m_palettes.contains(theme))
+        qWarning() << "No palette for theme:" << theme;
+
+    // implicitly shared, no copy of the colors
+    m_paletteItem->setPalette(m_palettes.value(theme));
+}
+
+void PaletteManager::loadPalettes()
+{
+    const QDir sourceDirectory(m_themeManager->assetsDirectory() + QStringLiteral("/palettes"));
+    const QFileInfoList sources = sourceDirectory.entryInfoList(QStringList(QStringLiteral("*.qml")), QDir::Files);
+    if (sources.isEmpty()) {
+        qWarning() << "No palette definitions found in:" << sourceDirectory.path();
+        return;
+    }
+
+    const QString cacheDirectory = m_themeManager->cacheDirectory();
+
+    // only created if a palette has to be compiled
+    QScopedPointer<QQmlEngine> engine;
+
+    Q_FOREACH (const QFileInfo &source, sources) {
+        const QString theme = source.completeBaseName();
+        const QString compiledFile = cacheDirectory.isEmpty()
+                                   ? QString()
+                                   : cacheDirectory + QStringLiteral("palettes/") + theme + QStringLiteral(".palette");
+
+        PaletteData palette;
+        if (compiledFile.isEmpty() || !readCompiledPalette(compiledFile, source, &palette)) {
+            if (!engine)
+                engine.reset(new QQmlEngine);
+
+            palette = compilePalette(engine.data(), source.filePath());
+            if (palette.isEmpty())
+                continue;
+
+            if (!compiledFile.isEmpty() && !writeCompiledPalette(compiledFile, source, palette))
+                qWarning() << "Could not write compiled palette:" << compiledFile;
+        }
+
+        m_palettes.insert(theme, palette);
+    }
+}
+
+PaletteData PaletteManager::compilePalette(QQmlEngine *engine, const QString &path) const
+{
+    QQmlComponent component(engine, path);
+    QScopedPointer<QObject> object(component.create());
     if (!object) {
+        qWarning() << "Could not load palette definition:" << path << component.errorString();
         return PaletteData();
     }
 
-    QVariant paletteProp = object->property("palette");
+    const QVariant paletteProp = object->property("palette");
     PaletteParser parser(paletteProp);
     return parser.parse();
 }
 
-void PaletteManager::updatePalette()
+bool PaletteManager::readCompiledPalette(const QString &fileName, const QFileInfo &source, PaletteData *palette) const
 {
-    const QString theme = m_themeManager->theme()->current();
-    PaletteData p = paletteForTheme(theme);
-    m_paletteItem->setPalette(p);
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    // a few hundred bytes, read in one go
+    const QByteArray data = file.readAll();
+    QDataStream stream(data);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    QByteArray fingerprint;
+    QString sourcePath;
+    qint64 sourceSize = 0;
+    qint64 sourceModified = 0;
+    stream >> magic >> version;
+    if (magic != compiledPaletteMagic || version != compiledPaletteVersion)
+        return false;
+
+    stream >> fingerprint >> sourcePath >> sourceSize >> sourceModified;
+    if (stream.status() != QDataStream::Ok
+            || fingerprint != colorRolesFingerprint()
+            || sourcePath != source.absoluteFilePath()
+            || sourceSize != source.size()
+            || sourceModified != source.lastModified().toMSecsSinceEpoch()) {
+        return false;
+    }
+
+    PaletteData result;
+    stream >> result;
+    if (stream.status() != QDataStream::Ok || !stream.atEnd())
+        return false;
+
+    *palette = result;
+    return true;
+}
+
+bool PaletteManager::writeCompiledPalette(const QString &fileName, const QFileInfo &source, const PaletteData &palette) const
+{
+    QDir().mkpath(QFileInfo(fileName).path());
+
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream << compiledPaletteMagic << compiledPaletteVersion
+           << colorRolesFingerprint()
+           << source.absoluteFilePath() << qint64(source.size()) << qint64(source.lastModified().toMSecsSinceEpoch())
+           << palette;
+
+    return file.commit();
 }
 
 }
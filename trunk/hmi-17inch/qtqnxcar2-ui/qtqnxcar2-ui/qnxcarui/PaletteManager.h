@@ -3,13 +3,26 @@
 
 #include "qtqnxcar_ui_export.h"
 
+#include "Palette.h"
+
+#include <QHash>
 #include <QObject>
 
+class QFileInfo;
+class QQmlEngine;
+
 namespace QnxCarUi {
-    class PaletteData;
     class PaletteItem;
     class ThemeManager;
 
+/**
+ * @short Provides the palette of the current theme
+ *
+ * The palettes of all themes are loaded up front, so switching the theme only swaps the palette.
+ * Evaluating the QML palette definitions is slow, so each palette is compiled once into a small
+ * binary file in the cache directory of the ThemeManager and read from there on later runs, until
+ * its definition changes.
+ */
 class QTQNXCAR_UI_EXPORT PaletteManager : public QObject
 {
     Q_OBJECT
@@ -21,14 +34,25 @@ public:
 
     PaletteItem *palette() const;
 
+    /// Returns the names of the themes with a palette
+    QStringList themes() const;
+
+    /// Returns the palette of @p theme, empty if it has none
+    PaletteData paletteForTheme(const QString &theme) const;
+
 private Q_SLOTS:
     void updatePalette();
 
 private:
-    PaletteData paletteForTheme(const QString& theme) const;
+    void loadPalettes();
+    PaletteData compilePalette(QQmlEngine *engine, const QString &path) const;
+    bool readCompiledPalette(const QString &fileName, const QFileInfo &source, PaletteData *palette) const;
+    bool writeCompiledPalette(const QString &fileName, const QFileInfo &source, const PaletteData &palette) const;
 
     PaletteItem *m_paletteItem;
     ThemeManager *m_themeManager;
+    QHash<QString, PaletteData> m_palettes;
+    bool m_palettesLoaded;
 };
 
 }
@@ -0,0 +1,179 @@
+#include "ThemeAssetIndex.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStringList>
+
+#include <algorithm>
+
+namespace QnxCarUi {
+
+/// First line of an index file, bump the version when the format changes
+static const char indexHeader[] = "qnxcar-theme-index 1";
+
+static qint64 modificationTime(const QString &path)
+{
+    const QFileInfo info(path);
+    return info.exists() ? info.lastModified().toMSecsSinceEpoch() : -1;
+}
+
+ThemeAssetIndex::ThemeAssetIndex()
+    : m_cached(false)
+{
+}
+
+void ThemeAssetIndex::load(const QString &themesDirectory, const QString &indexFile)
+{
+    m_themesDirectory = themesDirectory;
+    if (!m_themesDirectory.endsWith(QLatin1Char('/')))
+        m_themesDirectory.append(QLatin1Char('/'));
+
+    m_cached = !indexFile.isEmpty() && read(indexFile);
+    if (m_cached)
+        return;
+
+    scan();
+
+    if (!indexFile.isEmpty() && !write(indexFile))
+        qWarning() << "Could not write theme asset index:" << indexFile;
+}
+
+QString ThemeAssetIndex::themesDirectory() const
+{
+    return m_themesDirectory;
+}
+
+bool ThemeAssetIndex::isCached() const
+{
+    return m_cached;
+}
+
+int ThemeAssetIndex::count() const
+{
+    return m_files.count();
+}
+
+bool ThemeAssetIndex::contains(const QString &relativePath) const
+{
+    return m_files.contains(relativePath);
+}
+
+void ThemeAssetIndex::scan()
+{
+    m_directories.clear();
+    m_files.clear();
+
+    const Directory root = { QString(), modificationTime(m_themesDirectory) };
+    m_directories.append(root);
+
+    const QDir base(m_themesDirectory);
+    QDirIterator it(m_themesDirectory, QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+
+        const QFileInfo info = it.fileInfo();
+        const QString path = base.relativeFilePath(info.filePath());
+        if (info.isDir()) {
+            const Directory directory = { path, info.lastModified().toMSecsSinceEpoch() };
+            m_directories.append(directory);
+        } else {
+            m_files.insert(path);
+        }
+    }
+
+    std::sort(m_directories.begin(), m_directories.end());
+}
+
+bool ThemeAssetIndex::read(const QString &indexFile)
+{
+    QFile file(indexFile);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    const QList<QByteArray> lines = file.readAll().split('\n');
+    // header, stamp and the trailing empty line at least
+    if (lines.count() < 3 || lines.at(0) != indexHeader || !lines.last().isEmpty())
+        return false;
+
+    QVector<Directory> directories;
+    QSet<QString> files;
+    files.reserve(lines.count());
+
+    for (int i = 2; i < lines.count() - 1; ++i) {
+        // "d <path>" or "f <path>"
+        const QByteArray &line = lines.at(i);
+        if (line.size() < 2 || line.at(1) != ' ')
+            return false;
+
+        const QString path = QString::fromUtf8(line.constData() + 2, line.size() - 2);
+        if (line.at(0) == 'd') {
+            const Directory directory = { path, modificationTime(m_themesDirectory + path) };
+            directories.append(directory);
+        } else if (line.at(0) == 'f') {
+            files.insert(path);
+        } else {
+            return false;
+        }
+    }
+
+    m_directories.swap(directories);
+    m_files.swap(files);
+
+    // an asset has been added, removed or renamed since the index was written
+    return stamp() == lines.at(1);
+}
+
+bool ThemeAssetIndex::write(const QString &indexFile) const
+{
+    QDir().mkpath(QFileInfo(indexFile).path());
+
+    QSaveFile file(indexFile);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    QByteArray data;
+    data += indexHeader;
+    data += '\n';
+    data += stamp();
+    data += '\n';
+
+    Q_FOREACH (const Directory &directory, m_directories) {
+        data += "d ";
+        data += directory.path.toUtf8();
+        data += '\n';
+    }
+
+    QStringList files = m_files.toList();
+    files.sort();
+    Q_FOREACH (const QString &path, files) {
+        data += "f ";
+        data += path.toUtf8();
+        data += '\n';
+    }
+
+    file.write(data);
+    return file.commit();
+}
+
+QByteArray ThemeAssetIndex::stamp() const
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(m_themesDirectory.toUtf8());
+
+    Q_FOREACH (const Directory &directory, m_directories) {
+        hash.addData("\n", 1);
+        hash.addData(directory.path.toUtf8());
+        hash.addData(" ", 1);
+        hash.addData(QByteArray::number(directory.modified));
+    }
+
+    return hash.result().toHex();
+}
+
+}
@@ -0,0 +1,70 @@
+#ifndef THEMEASSETINDEX_H
+#define THEMEASSETINDEX_H
+
+#include "qtqnxcar_ui_export.h"
+
+#include <QSet>
+#include <QString>
+#include <QVector>
+
+namespace QnxCarUi {
+
+/**
+ * @short The files below a themes directory, looked up without touching the file system
+ *
+ * The index is a sorted flat file listing the directories and files below the themes directory,
+ * headed by a stamp hashing the path of the themes directory and the modification time of each of
+ * its directories. Adding, removing or renaming an asset changes the modification time of its
+ * directory, so checking the stamp takes one stat() per directory instead of one per lookup.
+ */
+class QTQNXCAR_UI_EXPORT ThemeAssetIndex
+{
+public:
+    ThemeAssetIndex();
+
+    /**
+     * Indexes the files below @p themesDirectory. The index is read from @p indexFile if its stamp
+     * is still up to date, otherwise the directory is scanned and the index written to @p indexFile.
+     * Without an @p indexFile the directory is always scanned.
+     */
+    void load(const QString &themesDirectory, const QString &indexFile = QString());
+
+    /// Returns the directory the index was loaded for
+    QString themesDirectory() const;
+
+    /// Whether the last load() read the index file instead of scanning the directory
+    bool isCached() const;
+
+    /// Returns the number of indexed files
+    int count() const;
+
+    /**
+     * Whether there is a file at @p relativePath, e.g. "classic/Home/background.png".
+     */
+    bool contains(const QString &relativePath) const;
+
+private:
+    struct Directory
+    {
+        QString path;
+        /// Milliseconds since the epoch, -1 if it does not exist
+        qint64 modified;
+
+        bool operator<(const Directory &other) const { return path < other.path; }
+    };
+
+    void scan();
+    bool read(const QString &indexFile);
+    bool write(const QString &indexFile) const;
+    QByteArray stamp() const;
+
+    QString m_themesDirectory;
+    /// Relative to the themes directory, sorted
+    QVector<Directory> m_directories;
+    QSet<QString> m_files;
+    bool m_cached;
+};
+
+}
+
+#endif
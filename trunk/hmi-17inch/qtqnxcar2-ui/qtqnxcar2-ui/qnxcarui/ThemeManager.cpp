@@ -1,7 +1,6 @@
 #include "ThemeManager.h"
 
 #include <QDebug>
-#include <QFile>
 
 using QnxCar::Theme;
 
@@ -11,6 +10,7 @@ ThemeManager::ThemeManager(ResolutionManager::Resolution resolution, Theme* them
     : QObject(parent)
     , m_theme(theme)
     , m_resolution(resolution)
+    , m_indexLoaded(false)
 {
 }
 
@@ -34,15 +34,15 @@ static QString folderForResolution(ResolutionManager::Resolution r)
     return QString();
 }
 
-QString ThemeManager::pathForTheme(const QString &theme, Theme::Mode mode) const
+QString ThemeManager::themesDirectory() const
 {
-    QString path = m_assetsDirectory;
-
-    path += QStringLiteral("images/themes/");
+    return m_assetsDirectory + QStringLiteral("images/themes/") + folderForResolution(m_resolution) + QLatin1Char('/');
+}
 
-    path += folderForResolution(m_resolution) + QLatin1Char('/');
+QString ThemeManager::relativePathForTheme(const QString &theme, Theme::Mode mode) const
+{
     // TODO: Check against available themes?
-    path += theme + QLatin1Char('/');
+    QString path = theme + QLatin1Char('/');
 
     switch (mode) {
         case Theme::Day:
@@ -61,6 +61,11 @@ QString ThemeManager::pathForTheme(const QString &theme, Theme::Mode mode) const
     return path;
 }
 
+QString ThemeManager::pathForTheme(const QString &theme, Theme::Mode mode) const
+{
+    return themesDirectory() + relativePathForTheme(theme, mode);
+}
+
 QString ThemeManager::path() const
 {
     return pathForTheme(m_theme->current(), m_theme->mode());
@@ -68,21 +73,40 @@ QString ThemeManager::path() const
 
 QUrl ThemeManager::fromTheme(const QString& iconName) const
 {
-    // check if there is an icon for current-theme/current-mode
-    QString icon = path() + iconName;
-    if (QFile(icon).exists())
-        return QUrl::fromLocalFile(icon);
-
-    // fallback: check if there is an icon for current-theme/day-mode
-    icon = pathForTheme(m_theme->current(), Theme::Day) + iconName;
-    if (QFile(icon).exists()) {
-        return QUrl::fromLocalFile(icon);
+    QHash<QString, QUrl> &urls = m_urls[relativePathForTheme(m_theme->current(), m_theme->mode())];
+
+    QHash<QString, QUrl>::ConstIterator it = urls.constFind(iconName);
+    if (it != urls.constEnd())
+        return *it;
+
+    const QUrl url = resolve(iconName);
+    urls.insert(iconName, url);
+    return url;
+}
+
+QUrl ThemeManager::resolve(const QString &iconName) const
+{
+    if (!m_indexLoaded) {
+        const QString indexFile = m_cacheDirectory.isEmpty()
+                                ? QString()
+                                : m_cacheDirectory + QStringLiteral("theme-assets.index");
+        m_index.load(themesDirectory(), indexFile);
+        m_indexLoaded = true;
     }
 
+    // check if there is an icon for current-theme/current-mode,
+    // fallback: check if there is an icon for current-theme/day-mode,
     // fallback: check if there is an icon for default-theme/day-mode
-    icon = pathForTheme(m_theme->defaultTheme(), Theme::Day) + iconName;
-    if (QFile(icon).exists()) {
-        return QUrl::fromLocalFile(icon);
+    const QString candidates[] = {
+        relativePathForTheme(m_theme->current(), m_theme->mode()),
+        relativePathForTheme(m_theme->current(), Theme::Day),
+        relativePathForTheme(Theme::defaultTheme(), Theme::Day)
+    };
+
+    for (size_t i = 0; i < sizeof(candidates) / sizeof(candidates[0]); ++i) {
+        const QString icon = candidates[i] + iconName;
+        if (m_index.contains(icon))
+            return QUrl::fromLocalFile(m_index.themesDirectory() + icon);
     }
 
     // fallback: return empty string
@@ -105,6 +129,27 @@ void ThemeManager::setAssetsDirectory(const QString &assetsDirectory)
         return;
 
     m_assetsDirectory = path;
+    m_indexLoaded = false;
+    m_urls.clear();
+}
+
+QString ThemeManager::cacheDirectory() const
+{
+    return m_cacheDirectory;
+}
+
+void ThemeManager::setCacheDirectory(const QString &cacheDirectory)
+{
+    QString path = cacheDirectory;
+    if (!path.isEmpty() && !path.endsWith(QLatin1Char('/')))
+        path.append(QLatin1Char('/'));
+
+    if (m_cacheDirectory == path)
+        return;
+
+    m_cacheDirectory = path;
+    m_indexLoaded = false;
+    m_urls.clear();
 }
 
 Theme* ThemeManager::theme() const
@@ -4,12 +4,13 @@
 #include "qtqnxcar_ui_export.h"
 
 #include "ResolutionManager.h"
+#include "ThemeAssetIndex.h"
 
 #include "qnxcar/Theme.h"
 
+#include <QHash>
 #include <QObject>
-
-class QUrl;
+#include <QUrl>
 
 namespace QnxCarUi {
 
@@ -25,6 +26,9 @@ public:
 
     /**
      * Returns the absolute and themed path for the given @p iconName.
+     *
+     * Icons are looked up in the asset index, and the result is remembered per theme and mode,
+     * so neither the first lookup nor those after a theme switch access the file system.
      */
     Q_INVOKABLE QUrl fromTheme(const QString& iconName) const;
 
@@ -38,6 +42,19 @@ public:
      */
     void setAssetsDirectory(const QString &assetsDirectory);
 
+    /**
+     * Returns the directory theme data derived from the assets is kept in across restarts.
+     */
+    QString cacheDirectory() const;
+
+    /**
+     * Sets the directory theme data derived from the assets is kept in across restarts,
+     * like the asset index. Without one, it is derived again on every run.
+     *
+     * @sa ThemeAssetIndex
+     */
+    void setCacheDirectory(const QString &cacheDirectory);
+
     QString path() const;
 
     /**
@@ -48,12 +65,22 @@ public:
     QnxCar::Theme *theme() const;
 
 private:
+    QString themesDirectory() const;
+    QString relativePathForTheme(const QString &theme, QnxCar::Theme::Mode mode) const;
     QString pathForTheme(const QString &theme, QnxCar::Theme::Mode mode) const;
+    QUrl resolve(const QString &iconName) const;
 
     QnxCar::Theme *m_theme;
 
     QString m_assetsDirectory;
+    QString m_cacheDirectory;
     ResolutionManager::Resolution m_resolution;
+
+    /// Loaded on the first lookup, after the assets and cache directories have been set
+    mutable ThemeAssetIndex m_index;
+    mutable bool m_indexLoaded;
+    /// Resolved icons by the relative path of the theme and mode they were looked up for
+    mutable QHash<QString, QHash<QString, QUrl> > m_urls;
 };
 
 }
@@ -6,6 +6,7 @@ SOURCES += \
     $$PWD/Palette.cpp \
     $$PWD/PaletteManager.cpp \
     $$PWD/ResolutionManager.cpp \
+    $$PWD/ThemeAssetIndex.cpp \
     $$PWD/ThemeManager.cpp \
     $$PWD/qtresourceinit.cpp \
     $$PWD/Fonts.cpp
@@ -15,6 +16,7 @@ HEADERS += \
     $$PWD/Palette.h \
     $$PWD/PaletteManager.h \
     $$PWD/ResolutionManager.h \
+    $$PWD/ThemeAssetIndex.h \
     $$PWD/ThemeManager.h \
     $$PWD/qtresourceinit.h \
     $$PWD/Fonts.h
@@ -1,13 +1,44 @@
 #include <QtTest/QtTest>
 
 #include "qnxcarui/Palette.h"
+#include "qnxcarui/PaletteManager.h"
+#include "qnxcarui/ThemeManager.h"
+
+#include "qnxcar/Theme.h"
 
 #include <QDebug>
 #include <QQmlEngine>
 #include <QQmlComponent>
+#include <QTemporaryDir>
+
+#include <utime.h>
 
 using namespace QnxCarUi;
 
+static bool writePaletteDefinition(const QString &fileName, const QString &dropDownColor)
+{
+    if (!QDir().mkpath(QFileInfo(fileName).path()))
+        return false;
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    file.write("import QtQuick 2.0\n"
+               "Item { property variant palette: { \"DropDown\": \"");
+    file.write(dropDownColor.toUtf8());
+    file.write("\" } }\n");
+    return true;
+}
+
+static bool setModificationTime(const QString &path, time_t time)
+{
+    struct utimbuf times;
+    times.actime = time;
+    times.modtime = time;
+    return ::utime(QFile::encodeName(path).constData(), &times) == 0;
+}
+
 class tst_Palette : public QObject
 {
     Q_OBJECT
@@ -17,6 +48,8 @@ private Q_SLOTS:
     void testPaletteData();
     void testPaletteItem();
     void testPaletteItem_fromString();
+    void testPaletteDataStream();
+    void testPaletteManager();
 };
 
 void tst_Palette::testPaletteParser()
@@ -80,5 +113,82 @@ void tst_Palette::testPaletteItem()
     QCOMPARE(item.color(PaletteItem::DropDown), QColor(Qt::red));
 }
 
+void tst_Palette::testPaletteDataStream()
+{
+    PaletteData data;
+    data.setColor(PaletteItem::DropDown, QColor(Qt::red));
+    data.setColor(PaletteItem::SearchFieldBackground, QColor::fromRgbF(0.980, 0.686, 0.251, 0.5));
+
+    QByteArray buffer;
+    {
+        QDataStream stream(&buffer, QIODevice::WriteOnly);
+        stream << data;
+    }
+
+    PaletteData read;
+    QDataStream stream(buffer);
+    stream >> read;
+    QCOMPARE(stream.status(), QDataStream::Ok);
+    QCOMPARE(read.color(PaletteItem::DropDown).rgba(), data.color(PaletteItem::DropDown).rgba());
+    QCOMPARE(read.color(PaletteItem::SearchFieldBackground).rgba(), data.color(PaletteItem::SearchFieldBackground).rgba());
+
+    // truncated
+    QDataStream truncated(buffer.left(buffer.size() - 1));
+    truncated >> read;
+    QVERIFY(truncated.status() != QDataStream::Ok);
+}
+
+void tst_Palette::testPaletteManager()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    const QString definition = dir.path() + QStringLiteral("/assets/palettes/technology.qml");
+    const QString compiled = dir.path() + QStringLiteral("/cache/palettes/technology.palette");
+    QVERIFY(writePaletteDefinition(definition, QStringLiteral("red")));
+    QVERIFY(writePaletteDefinition(dir.path() + QStringLiteral("/assets/palettes/classic.qml"), QStringLiteral("blue")));
+
+    QnxCar::Theme theme;
+    ThemeManager themeManager(ResolutionManager::Resolution_800x480, &theme);
+    themeManager.setAssetsDirectory(dir.path() + QStringLiteral("/assets"));
+    themeManager.setCacheDirectory(dir.path() + QStringLiteral("/cache"));
+
+    {
+        PaletteManager manager(&themeManager);
+        QCOMPARE(manager.themes().count(), 2);
+        QCOMPARE(manager.paletteForTheme(QStringLiteral("technology")).color(PaletteItem::DropDown), QColor(Qt::red));
+        QCOMPARE(manager.paletteForTheme(QStringLiteral("classic")).color(PaletteItem::DropDown), QColor(Qt::blue));
+        QVERIFY(manager.paletteForTheme(QStringLiteral("missing")).isEmpty());
+        QVERIFY(QFile::exists(compiled));
+    }
+
+    // an up to date compiled palette is read, not written again
+    QVERIFY(setModificationTime(compiled, 1000000));
+    {
+        PaletteManager manager(&themeManager);
+        QCOMPARE(manager.paletteForTheme(QStringLiteral("technology")).color(PaletteItem::DropDown), QColor(Qt::red));
+        QCOMPARE(QFileInfo(compiled).lastModified().toTime_t(), uint(1000000));
+    }
+
+    // a changed definition is compiled again
+    QVERIFY(writePaletteDefinition(definition, QStringLiteral("green")));
+    QVERIFY(setModificationTime(definition, 2000000));
+    {
+        PaletteManager manager(&themeManager);
+        QCOMPARE(manager.paletteForTheme(QStringLiteral("technology")).color(PaletteItem::DropDown), QColor(Qt::green));
+        QVERIFY(QFileInfo(compiled).lastModified().toTime_t() != uint(1000000));
+    }
+
+    // a damaged compiled palette is replaced
+    QFile file(compiled);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("garbage");
+    file.close();
+    {
+        PaletteManager manager(&themeManager);
+        QCOMPARE(manager.paletteForTheme(QStringLiteral("technology")).color(PaletteItem::DropDown), QColor(Qt::green));
+    }
+}
+
 QTEST_MAIN(tst_Palette)
 #include "tst_palette.moc"
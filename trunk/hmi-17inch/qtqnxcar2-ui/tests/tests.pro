@@ -3,3 +3,4 @@ TEMPLATE = subdirs
 SUBDIRS = \
     palette \
     qml \
+    themeassetindex \
@@ -0,0 +1,5 @@
+include(../unittests.pri)
+
+TARGET=tst_themeassetindex
+
+SOURCES += tst_themeassetindex.cpp
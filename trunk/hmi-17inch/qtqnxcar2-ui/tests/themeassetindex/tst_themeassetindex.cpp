@@ -0,0 +1,146 @@
+#include <QtTest/QtTest>
+
+#include "qnxcarui/ThemeAssetIndex.h"
+#include "qnxcarui/ThemeManager.h"
+
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include <utime.h>
+
+using namespace QnxCarUi;
+
+static bool createFile(const QString &fileName)
+{
+    if (!QDir().mkpath(QFileInfo(fileName).path()))
+        return false;
+
+    QFile file(fileName);
+    return file.open(QIODevice::WriteOnly);
+}
+
+/// Moves the modification time of @p path, file systems with a coarse resolution would not notice the change otherwise
+static bool setModificationTime(const QString &path, time_t time)
+{
+    struct utimbuf times;
+    times.actime = time;
+    times.modtime = time;
+    return ::utime(QFile::encodeName(path).constData(), &times) == 0;
+}
+
+class tst_ThemeAssetIndex : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void init();
+
+    void testScan();
+    void testIndexFile();
+    void testInvalidation();
+    void testThemeManager();
+
+private:
+    QScopedPointer<QTemporaryDir> m_dir;
+    QString m_themesDirectory;
+};
+
+void tst_ThemeAssetIndex::init()
+{
+    m_dir.reset(new QTemporaryDir);
+    QVERIFY(m_dir->isValid());
+
+    m_themesDirectory = m_dir->path() + QStringLiteral("/images/themes/800x480/");
+    QVERIFY(createFile(m_themesDirectory + QStringLiteral("technology/Home/background.png")));
+    QVERIFY(createFile(m_themesDirectory + QStringLiteral("technology/Home/button.png")));
+    QVERIFY(createFile(m_themesDirectory + QStringLiteral("classic/Home/background.png")));
+}
+
+void tst_ThemeAssetIndex::testScan()
+{
+    ThemeAssetIndex index;
+    index.load(m_themesDirectory);
+
+    QVERIFY(!index.isCached());
+    QCOMPARE(index.count(), 3);
+    QVERIFY(index.contains(QStringLiteral("technology/Home/button.png")));
+    QVERIFY(index.contains(QStringLiteral("classic/Home/background.png")));
+    QVERIFY(!index.contains(QStringLiteral("classic/Home/button.png")));
+    // directories are no assets
+    QVERIFY(!index.contains(QStringLiteral("classic/Home")));
+}
+
+void tst_ThemeAssetIndex::testIndexFile()
+{
+    const QString indexFile = m_dir->path() + QStringLiteral("/cache/theme-assets.index");
+
+    ThemeAssetIndex scanned;
+    scanned.load(m_themesDirectory, indexFile);
+    QVERIFY(!scanned.isCached());
+    QVERIFY(QFile::exists(indexFile));
+
+    ThemeAssetIndex cached;
+    cached.load(m_themesDirectory, indexFile);
+    QVERIFY(cached.isCached());
+    QCOMPARE(cached.count(), 3);
+    QVERIFY(cached.contains(QStringLiteral("technology/Home/button.png")));
+
+    // written for another themes directory
+    QVERIFY(createFile(m_dir->path() + QStringLiteral("/other/classic/icon.png")));
+    ThemeAssetIndex other;
+    other.load(m_dir->path() + QStringLiteral("/other"), indexFile);
+    QVERIFY(!other.isCached());
+    QCOMPARE(other.count(), 1);
+
+    // a damaged index is replaced
+    QFile file(indexFile);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("garbage");
+    file.close();
+
+    ThemeAssetIndex damaged;
+    damaged.load(m_themesDirectory, indexFile);
+    QVERIFY(!damaged.isCached());
+    QCOMPARE(damaged.count(), 3);
+}
+
+void tst_ThemeAssetIndex::testInvalidation()
+{
+    const QString indexFile = m_dir->path() + QStringLiteral("/theme-assets.index");
+    const QString homeDirectory = m_themesDirectory + QStringLiteral("classic/Home");
+    QVERIFY(setModificationTime(homeDirectory, 1000000));
+
+    ThemeAssetIndex index;
+    index.load(m_themesDirectory, indexFile);
+
+    QVERIFY(createFile(homeDirectory + QStringLiteral("/button.png")));
+    QVERIFY(setModificationTime(homeDirectory, 2000000));
+
+    index.load(m_themesDirectory, indexFile);
+    QVERIFY(!index.isCached());
+    QVERIFY(index.contains(QStringLiteral("classic/Home/button.png")));
+
+    index.load(m_themesDirectory, indexFile);
+    QVERIFY(index.isCached());
+    QVERIFY(index.contains(QStringLiteral("classic/Home/button.png")));
+}
+
+void tst_ThemeAssetIndex::testThemeManager()
+{
+    QnxCar::Theme theme;
+    ThemeManager manager(ResolutionManager::Resolution_800x480, &theme);
+    manager.setAssetsDirectory(m_dir->path());
+
+    // the current theme of the simulator is empty, falls back to the default theme
+    const QString button = m_themesDirectory + QStringLiteral("technology/Home/button.png");
+    QCOMPARE(manager.fromTheme(QStringLiteral("Home/button.png")), QUrl::fromLocalFile(button));
+    QCOMPARE(manager.fromTheme(QStringLiteral("Home/missing.png")), QUrl());
+
+    // resolved once, without checking the file again
+    QVERIFY(QFile::remove(button));
+    QCOMPARE(manager.fromTheme(QStringLiteral("Home/button.png")), QUrl::fromLocalFile(button));
+}
+
+QTEST_MAIN(tst_ThemeAssetIndex)
+#include "tst_themeassetindex.moc"
@@ -6,14 +6,161 @@
 #include <QSqlError>
 #include <QSqlRecord>
 #include <QStringList>
-#include <QRegularExpression>
 #include <QDebug>
+#include <QHash>
+#include <QVariantList>
+#include <QVector>
 
 namespace QnxCar {
 
-struct AddressbookModel::Private
+/// Reduces a phone number to its digits, e.g. "+49 (30) 123-45" to "493012345"
+static QString sanitizeNumber(const QString &number)
 {
-    CallerIDObject *callerID;
+    QString digits;
+    digits.reserve(number.size());
+    for (int i = 0; i < number.size(); ++i) {
+        if (number.at(i).isDigit())
+            digits.append(number.at(i));
+    }
+    return digits;
+}
+
+/// Columns of SQL_SELECT_SYNC
+enum SyncColumn {
+    SyncFirstName,
+    SyncLastName,
+    SyncPicture,
+    // the numbers caller ID is matched against
+    SyncHomePhone,
+    SyncHomePhone2,
+    SyncWorkPhone,
+    SyncWorkPhone2,
+    SyncMobilePhone,
+    SyncOtherPhone,
+    SyncContactId,
+    SyncFormattedName,
+    SyncCompany,
+    SyncPagerPhone,
+    SyncEmail1,
+    SyncEmail2,
+    SyncEmail3,
+    SyncWebPage,
+    SyncHomeAddressStreet,
+    SyncHomeAddressExtended,
+    SyncHomeAddressCity,
+    SyncHomeAddressProvince,
+    SyncHomeAddressCountry,
+    SyncHomeAddressZipCode,
+    SyncWorkAddressStreet,
+    SyncWorkAddressExtended,
+    SyncWorkAddressCity,
+    SyncWorkAddressProvince,
+    SyncWorkAddressCountry,
+    SyncWorkAddressZipCode
+};
+
+/**
+ * The phone numbers of the address book, reduced to their digits and keyed by their last
+ * significant digits. Looking up a caller ID takes a hash lookup and one comparison per number
+ * ending in the same digits, instead of a query scanning every contact.
+ */
+class CallerIDIndex
+{
+public:
+    // NOTE: This assumes that the phone numbers we're checking against are significantly unique to 7 digits, starting from the right
+    static const int significantDigits = 7;
+
+    CallerIDIndex() : m_valid(false) {}
+
+    bool isValid() const { return m_valid; }
+
+    void clear()
+    {
+        m_contacts.clear();
+        m_numbers.clear();
+        m_valid = false;
+    }
+
+    /// Starts a new index, filled by add()
+    void start()
+    {
+        clear();
+        m_valid = true;
+    }
+
+    /// Adds the contact at the current row of @p query, a row of SQL_SELECT_SYNC
+    void add(const QSqlQuery &query)
+    {
+        const Contact contact = {
+            query.value(SyncFirstName).toString() + QStringLiteral(" ") + query.value(SyncLastName).toString(),
+            query.value(SyncPicture).toString()
+        };
+
+        bool hasNumber = false;
+        for (int i = SyncHomePhone; i <= SyncOtherPhone; ++i) {
+            const QString digits = sanitizeNumber(query.value(i).toString());
+            if (digits.isEmpty())
+                continue;
+
+            const Number number = { digits, m_contacts.count() };
+            m_numbers[digits.right(significantDigits)].append(number);
+            hasNumber = true;
+        }
+
+        if (hasNumber)
+            m_contacts.append(contact);
+    }
+
+    /**
+     * Looks up the contact calling from @p digits. A number matching all digits wins, otherwise
+     * the contact is identified by the significant digits if exactly one contact has a number
+     * ending in them.
+     */
+    bool lookup(const QString &digits, QString *name, QString *picture) const
+    {
+        const QVector<Number> numbers = m_numbers.value(digits.right(significantDigits));
+
+        int match = -1;
+        Q_FOREACH (const Number &number, numbers) {
+            if (number.digits == digits) {
+                match = number.contact;
+                break;
+            }
+        }
+
+        // partial matching, but only if the caller ID has enough significant digits
+        if (match < 0 && digits.size() >= significantDigits) {
+            Q_FOREACH (const Number &number, numbers) {
+                if (match >= 0 && number.contact != match)
+                    return false;
+                match = number.contact;
+            }
+        }
+
+        if (match < 0)
+            return false;
+
+        *name = m_contacts.at(match).name;
+        *picture = m_contacts.at(match).picture;
+        return true;
+    }
+
+private:
+    struct Contact {
+        QString name;
+        QString picture;
+    };
+
+    struct Number {
+        QString digits;
+        /// Index into m_contacts
+        int contact;
+    };
+
+    QVector<Contact> m_contacts;
+    /// Numbers by their last significantDigits digits, in phonebook order
+    QHash<QString, QVector<Number> > m_numbers;
+    bool m_valid;
 };
 
 QList<QByteArray> AddressbookModel::columnNames() const {
@@ -55,8 +202,6 @@ QList<QByteArray> AddressbookModel::columnNames() const {
     << "note";
 }
 
-static const QString SQL_RECORD_LIMIT = QLatin1Literal(" LIMIT 20000");
-
 static const QString SQL_SELECT_CONTACTS_TPL = QLatin1Literal(
     "SELECT "
     "contact_id, "
@@ -93,14 +238,53 @@ static const QString SQL_SELECT_CONTACTS_TPL = QLatin1Literal(
     "picture, "
     "pin, "
     "web_page, "
-    "note "
-    "FROM contacts_view"
+    "note, "
+    // derived on sync, in the order of the roles
+    "formatted_home_address, "
+    "formatted_work_address, "
+    "display_name "
+    "FROM contacts_view "
+    "LEFT JOIN contacts_derived USING (contact_id)"
+);
+
+/// The contacts of a block, followed by one placeholder per row of the block
+static const QString SQL_SELECT_CONTACTS_IN = SQL_SELECT_CONTACTS_TPL + QLatin1Literal(" WHERE contact_id IN (%1)");
+
+/// The order of the contacts, read in full whenever the phonebook or the sort order changes
+static const QString SQL_SELECT_CONTACT_IDS = QLatin1Literal("SELECT contact_id FROM contacts_view");
+
+/// The order of the contacts by display name, read from the index of the derived columns
+static const QString SQL_SELECT_CONTACT_IDS_BY_DISPLAY_NAME = QLatin1Literal(
+    "SELECT contact_id FROM contacts_derived ORDER BY display_name COLLATE NOCASE %1, contact_id %1"
+);
+
+/**
+ * Columns derived from the contacts on each phonebook sync, so that neither showing nor sorting
+ * contacts has to format them. Temporary, the phonebook database belongs to the phonebook service.
+ */
+static const QString SQL_CREATE_DERIVED = QLatin1Literal(
+    "CREATE TEMP TABLE IF NOT EXISTS contacts_derived ("
+    "contact_id INTEGER PRIMARY KEY, "
+    "formatted_home_address TEXT, "
+    "formatted_work_address TEXT, "
+    "display_name TEXT)"
+);
+
+static const QString SQL_CREATE_DERIVED_INDEX = QLatin1Literal(
+    "CREATE INDEX IF NOT EXISTS temp.contacts_derived_display_name "
+    "ON contacts_derived (display_name COLLATE NOCASE, contact_id)"
 );
 
-static const QString SQL_SELECT_CONTACTS = SQL_SELECT_CONTACTS_TPL + SQL_RECORD_LIMIT;
+static const QString SQL_DELETE_DERIVED = QLatin1Literal("DELETE FROM contacts_derived");
 
+static const QString SQL_INSERT_DERIVED = QLatin1Literal(
+    "INSERT OR REPLACE INTO contacts_derived "
+    "(contact_id, formatted_home_address, formatted_work_address, display_name) "
+    "VALUES (?, ?, ?, ?)"
+);
 
-static const QString SQL_SELECT_CALLERID = QLatin1Literal(
+/// Every contact with the columns the derived columns and the caller ID index are built from, see SyncColumn
+static const QString SQL_SELECT_SYNC = QLatin1Literal(
     "SELECT "
     "first_name, "
     "last_name, "
@@ -110,14 +294,28 @@ static const QString SQL_SELECT_CALLERID = QLatin1Literal(
     "work_phone, "
     "work_phone_2, "
     "mobile_phone, "
-    "other_phone "
-    "FROM contacts_view "
-    "WHERE home_phone LIKE :pattern OR "
-    "home_phone_2 LIKE :pattern OR "
-    "work_phone LIKE :pattern OR "
-    "work_phone_2 LIKE :pattern OR "
-    "mobile_phone LIKE :pattern OR "
-    "other_phone LIKE :pattern"
+    "other_phone, "
+    "contact_id, "
+    "formatted_name, "
+    "company, "
+    "pager_phone, "
+    "email_1, "
+    "email_2, "
+    "email_3, "
+    "web_page, "
+    "home_address_1, "
+    "home_address_2, "
+    "home_address_city, "
+    "home_address_state_province, "
+    "home_address_country, "
+    "home_address_zip_postal, "
+    "work_address_1, "
+    "work_address_2, "
+    "work_address_city, "
+    "work_address_state_province, "
+    "work_address_country, "
+    "work_address_zip_postal "
+    "FROM contacts_view"
 );
 
 struct IsEmpty
@@ -181,25 +379,437 @@ static QString formatName(const QString &firstName,
         return "";
     }
 }
+
+/// Number of contacts read from the database at a time
+static const int DefaultBlockSize = 50;
+
+/// Number of blocks kept in memory, a few screens of contacts
+static const int DefaultMaximumResidentBlocks = 8;
+
+struct AddressbookModel::Private
+{
+    typedef QVector<QVariant> Row;
+
+    Private()
+        : callerID(0)
+        , sortRole(DisplayName)
+        , sortColumn(-1)
+        , sortOrder(Qt::AscendingOrder)
+        , blockSize(DefaultBlockSize)
+        , maximumResidentBlocks(DefaultMaximumResidentBlocks)
+        , currentBlock(0)
+    {
+    }
+
+    CallerIDObject *callerID;
+    CallerIDIndex callerIDIndex;
+
+    int sortRole;
+    /// -1 for the order of the database
+    int sortColumn;
+    Qt::SortOrder sortOrder;
+
+    /// The contacts in model order, their columns are read in blocks when they are shown
+    QVector<int> contactIds;
+    QHash<int, QVector<Row> > blocks;
+    int blockSize;
+    int maximumResidentBlocks;
+    /// The block of the most recently requested row
+    int currentBlock;
+
+    /**
+     * A connection of the model's own to the phonebook: the derived columns live in a temporary
+     * table, which is dropped whenever a connection is closed, and other models reopen theirs.
+     */
+    QString connectionName;
+    QSqlDatabase database;
+    /// Prepared statements by their SQL
+    QHash<QString, QSqlQuery> statements;
+
+    bool open(const QSqlDatabase &source);
+    void close();
+    QSqlQuery exec(const QString &sql, const QVariantList &values = QVariantList());
+    bool sync();
+    QString contactIdsQuery(const QList<QByteArray> &columns) const;
+    void readContactIds(const QList<QByteArray> &columns);
+    QVariant value(int row, int column);
+    bool loadBlock(int block);
+    void evictBlocks();
+};
+
+bool AddressbookModel::Private::open(const QSqlDatabase &source)
+{
+    if (!source.isValid()) {
+        close();
+        return false;
+    }
+
+    if (!database.isValid() || database.databaseName() != source.databaseName()) {
+        close();
+        database = QSqlDatabase::cloneDatabase(source, connectionName);
+    }
+
+    if (!database.isOpen() && !database.open()) {
+        qWarning() << "Error: Failed to open phonebook database in" << database.databaseName() << ":" << database.lastError();
+        return false;
+    }
+
+    return true;
+}
+
+void AddressbookModel::Private::close()
+{
+    if (!database.isValid())
+        return;
+
+    // no query or copy of the connection may be left when removing it
+    statements.clear();
+    database = QSqlDatabase();
+    QSqlDatabase::removeDatabase(connectionName);
+}
+
+QSqlQuery AddressbookModel::Private::exec(const QString &sql, const QVariantList &values)
+{
+    QHash<QString, QSqlQuery>::iterator it = statements.find(sql);
+    if (it == statements.end()) {
+        QSqlQuery query(database);
+        query.setForwardOnly(true);
+        if (!query.prepare(sql)) {
+            qWarning("%s: %s", Q_FUNC_INFO, qPrintable(query.lastError().text()));
+            return QSqlQuery();
+        }
+        it = statements.insert(sql, query);
+    }
+
+    for (int i = 0; i < values.count(); ++i)
+        it->bindValue(i, values.at(i));
+
+    if (!it->exec()) {
+        qWarning("%s: %s", Q_FUNC_INFO, qPrintable(it->lastError().text()));
+        return QSqlQuery();
+    }
+
+    return it.value();
+}
+
+/**
+ * Reads all contacts once after the phonebook has been synced: stores the derived columns in
+ * a single transaction and builds the caller ID index.
+ */
+bool AddressbookModel::Private::sync()
+{
+    callerIDIndex.clear();
+
+    if (!exec(SQL_CREATE_DERIVED).isActive() || !exec(SQL_CREATE_DERIVED_INDEX).isActive())
+        return false;
+
+    if (!database.transaction()) {
+        qWarning() << Q_FUNC_INFO << database.lastError();
+        return false;
+    }
+
+    exec(SQL_DELETE_DERIVED);
+
+    QSqlQuery contacts = exec(SQL_SELECT_SYNC);
+    if (!contacts.isActive()) {
+        database.rollback();
+        return false;
+    }
+
+    callerIDIndex.start();
+
+    QVariantList values;
+    while (contacts.next()) {
+        callerIDIndex.add(contacts);
+
+        values.clear();
+        values << contacts.value(SyncContactId)
+               << formatAddress(contacts.value(SyncHomeAddressStreet).toString(),
+                                contacts.value(SyncHomeAddressExtended).toString(),
+                                contacts.value(SyncHomeAddressCity).toString(),
+                                contacts.value(SyncHomeAddressProvince).toString(),
+                                contacts.value(SyncHomeAddressCountry).toString(),
+                                contacts.value(SyncHomeAddressZipCode).toString())
+               << formatAddress(contacts.value(SyncWorkAddressStreet).toString(),
+                                contacts.value(SyncWorkAddressExtended).toString(),
+                                contacts.value(SyncWorkAddressCity).toString(),
+                                contacts.value(SyncWorkAddressProvince).toString(),
+                                contacts.value(SyncWorkAddressCountry).toString(),
+                                contacts.value(SyncWorkAddressZipCode).toString())
+               << formatName(contacts.value(SyncFirstName).toString(),
+                             contacts.value(SyncLastName).toString(),
+                             contacts.value(SyncFormattedName).toString(),
+                             contacts.value(SyncCompany).toString(),
+                             contacts.value(SyncHomePhone).toString(),
+                             contacts.value(SyncMobilePhone).toString(),
+                             contacts.value(SyncHomePhone2).toString(),
+                             contacts.value(SyncWorkPhone).toString(),
+                             contacts.value(SyncWorkPhone2).toString(),
+                             contacts.value(SyncPagerPhone).toString(),
+                             contacts.value(SyncEmail1).toString(),
+                             contacts.value(SyncEmail2).toString(),
+                             contacts.value(SyncEmail3).toString(),
+                             contacts.value(SyncWebPage).toString());
+
+        QSqlQuery insert = exec(SQL_INSERT_DERIVED, values);
+        if (!insert.isActive()) {
+            contacts.finish();
+            database.rollback();
+            callerIDIndex.clear();
+            return false;
+        }
+    }
+    contacts.finish();
+
+    if (!database.commit()) {
+        qWarning() << Q_FUNC_INFO << database.lastError();
+        return false;
+    }
+
+    return true;
+}
+
+QString AddressbookModel::Private::contactIdsQuery(const QList<QByteArray> &columns) const
+{
+    if (sortColumn < 0)
+        return SQL_SELECT_CONTACT_IDS;
+
+    const QString direction = sortOrder == Qt::AscendingOrder ? QStringLiteral("ASC") : QStringLiteral("DESC");
+    if (sortRole == DisplayName)
+        return SQL_SELECT_CONTACT_IDS_BY_DISPLAY_NAME.arg(direction);
+
+    if (sortRole > Qt::UserRole && sortRole <= Qt::UserRole + columns.count()) {
+        const QString column = QString::fromLatin1(columns.at(sortRole - Qt::UserRole - 1));
+        return SQL_SELECT_CONTACT_IDS + QStringLiteral(" ORDER BY %1 COLLATE NOCASE %2, contact_id %2").arg(column, direction);
+    }
+
+    qWarning() << Q_FUNC_INFO << "Contacts cannot be sorted by role" << sortRole;
+    return SQL_SELECT_CONTACT_IDS;
+}
+
+void AddressbookModel::Private::readContactIds(const QList<QByteArray> &columns)
+{
+    contactIds.clear();
+    blocks.clear();
+
+    QSqlQuery query = exec(contactIdsQuery(columns));
+    if (!query.isActive())
+        return;
+
+    while (query.next())
+        contactIds.append(query.value(0).toInt());
+    query.finish();
+
+    contactIds.squeeze();
+}
+
+QVariant AddressbookModel::Private::value(int row, int column)
+{
+    const int block = row / blockSize;
+
+    // blocks around this one are kept when evicting
+    currentBlock = block;
+
+    if (!blocks.contains(block) && !loadBlock(block))
+        return QVariant();
+
+    return blocks.value(block).at(row % blockSize).value(column);
+}
+
+bool AddressbookModel::Private::loadBlock(int block)
+{
+    const int first = block * blockSize;
+    const int count = qMin(blockSize, contactIds.count() - first);
+    if (count <= 0)
+        return false;
+
+    // the statement always has blockSize placeholders, so that it is prepared once, NULL matches no contact
+    QVariantList values;
+    values.reserve(blockSize);
+    QHash<int, int> positions;
+    for (int i = 0; i < blockSize; ++i) {
+        if (i < count) {
+            values.append(contactIds.at(first + i));
+            positions.insertMulti(contactIds.at(first + i), i);
+        } else {
+            values.append(QVariant(QVariant::Int));
+        }
+    }
+
+    QStringList placeholders;
+    for (int i = 0; i < blockSize; ++i)
+        placeholders.append(QStringLiteral("?"));
+
+    QSqlQuery query = exec(SQL_SELECT_CONTACTS_IN.arg(placeholders.join(QStringLiteral(", "))), values);
+    if (!query.isActive())
+        return false;
+
+    const int columnCount = query.record().count();
+    QVector<Row> rows(count);
+    while (query.next()) {
+        Row row(columnCount);
+        for (int column = 0; column < columnCount; ++column)
+            row[column] = query.value(column);
+
+        Q_FOREACH (int position, positions.values(row.at(0).toInt()))
+            rows[position] = row;
+    }
+    query.finish();
+
+    blocks.insert(block, rows);
+    evictBlocks();
+    return true;
+}
+
+void AddressbookModel::Private::evictBlocks()
+{
+    if (maximumResidentBlocks == 0)
+        return;
+
+    while (blocks.count() > maximumResidentBlocks) {
+        int furthestBlock = -1;
+        int furthestDistance = 0;
+        QHash<int, QVector<Row> >::const_iterator it = blocks.constBegin();
+        for (; it != blocks.constEnd(); ++it) {
+            const int distance = qAbs(it.key() - currentBlock);
+            if (distance > furthestDistance) {
+                furthestBlock = it.key();
+                furthestDistance = distance;
+            }
+        }
+
+        // only the current block is left
+        if (furthestBlock < 0)
+            return;
+
+        blocks.remove(furthestBlock);
+    }
+}
+
 AddressbookModel::AddressbookModel(QObject* parent)
     : SqlQueryModel(parent), d(new Private)
 {
     d->callerID = new CallerIDObject();
+    d->connectionName = QStringLiteral("AddressbookModel-%1").arg(quintptr(this), 0, 16);
 }
 
 AddressbookModel::~AddressbookModel()
 {
+    d->close();
     delete d;
 }
 
 void AddressbookModel::runQuery()
 {
-    reopenDatabase();
-    setQuery(SQL_SELECT_CONTACTS, database());
-    //TODO: test this with a large contact set around ~10000
-    while (this->canFetchMore()){
-        this->fetchMore();
+    // the phonebook has been synced, derive what showing contacts and an incoming call need once
+    if (d->open(database()))
+        d->sync();
+
+    reload();
+}
+
+void AddressbookModel::reload()
+{
+    beginResetModel();
+
+    if (d->open(database())) {
+        d->readContactIds(columnNames());
+    } else {
+        d->contactIds.clear();
+        d->blocks.clear();
     }
+
+    endResetModel();
+}
+
+void AddressbookModel::clear()
+{
+    beginResetModel();
+    d->contactIds.clear();
+    d->blocks.clear();
+    d->callerIDIndex.clear();
+    endResetModel();
+}
+
+int AddressbookModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : d->contactIds.count();
+}
+
+int AddressbookModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : columnNames().count();
+}
+
+bool AddressbookModel::canFetchMore(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+
+    // rowCount() is the number of all contacts, rows are read when their data is requested
+    return false;
+}
+
+void AddressbookModel::fetchMore(const QModelIndex &parent)
+{
+    Q_UNUSED(parent);
+}
+
+void AddressbookModel::sort(int column, Qt::SortOrder order)
+{
+    if (column == d->sortColumn && order == d->sortOrder)
+        return;
+
+    d->sortColumn = column;
+    d->sortOrder = order;
+
+    if (database().isValid())
+        reload();
+}
+
+int AddressbookModel::sortRole() const
+{
+    return d->sortRole;
+}
+
+void AddressbookModel::setSortRole(int role)
+{
+    if (role == d->sortRole)
+        return;
+
+    d->sortRole = role;
+
+    if (d->sortColumn >= 0 && database().isValid())
+        reload();
+}
+
+int AddressbookModel::blockSize() const
+{
+    return d->blockSize;
+}
+
+void AddressbookModel::setBlockSize(int size)
+{
+    if (size < 1 || size == d->blockSize)
+        return;
+
+    d->blockSize = size;
+    d->blocks.clear();
+}
+
+int AddressbookModel::maximumResidentBlocks() const
+{
+    return d->maximumResidentBlocks;
+}
+
+void AddressbookModel::setMaximumResidentBlocks(int blocks)
+{
+    d->maximumResidentBlocks = qMax(0, blocks);
+    d->evictBlocks();
+}
+
+int AddressbookModel::residentBlockCount() const
+{
+    return d->blocks.count();
 }
 
 QHash< int, QByteArray > AddressbookModel::roleNames() const
@@ -213,70 +823,19 @@ QHash< int, QByteArray > AddressbookModel::roleNames() const
 
 QVariant AddressbookModel::data(const QModelIndex &index, int role) const
 {
-    switch (role) {
-    case FormattedHomeAddress:
-    {
-        const QString street = index.data(HomeAddressStreetRole).toString();
-        const QString ext = index.data(HomeAddressExtendedRole).toString();
-        const QString city = index.data(HomeAddressCityRole).toString();
-        const QString province = index.data(HomeAddressProvinceRole).toString();
-        const QString country = index.data(HomeAddressCountryRole).toString();
-        const QString zip = index.data(HomeAddressZipCodeRole).toString();
-        return formatAddress(street, ext, city, province, country, zip);
-    }
-
-    case FormattedWorkAddress:
-    {
-        const QString street = index.data(WorkAddressStreetRole).toString();
-        const QString ext = index.data(WorkAddressExtendedRole).toString();
-        const QString city = index.data(WorkAddressCityRole).toString();
-        const QString province = index.data(WorkAddressProvinceRole).toString();
-        const QString country = index.data(WorkAddressCountryRole).toString();
-        const QString zip = index.data(WorkAddressZipCodeRole).toString();
-        return formatAddress(street, ext, city, province, country, zip);
-    }
-    case DisplayName:
-    {
-        const QString firstName = index.data(FirstNameRole).toString();
-        const QString lastName = index.data(LastNameRole).toString();
-        const QString formattedName = index.data(FormattedNameRole).toString();
-        const QString company = index.data(CompanyRole).toString();
-        const QString homePhone1 = index.data(HomePhone1Role).toString();
-        const QString mobilePhone = index.data(MobilePhoneRole).toString();
-        const QString homePhone2 = index.data(HomePhone2Role).toString();
-        const QString workPhone1 = index.data(WorkPhone1Role).toString();
-        const QString workPhone2 = index.data(WorkPhone2Role).toString();
-        const QString pagerPhone = index.data(PagerPhoneRole).toString();
-        const QString email1 = index.data(Email1Role).toString();
-        const QString email2 = index.data(Email2Role).toString();
-        const QString email3 = index.data(Email3Role).toString();
-        const QString webPage = index.data(WebPageRole).toString();
-
-        return formatName(firstName, lastName, formattedName, company, homePhone1, mobilePhone,
-                                  homePhone2, workPhone1, workPhone2, pagerPhone, email1, email2, email3,
-                                  webPage);
-    }
-    default:
-        break;
-    }
+    if (!index.isValid() || index.row() >= d->contactIds.count())
+        return QVariant();
 
-    return SqlQueryModel::data(index, role);
-}
+    // the roles follow the columns of SQL_SELECT_CONTACTS_IN, including the ones derived on sync
+    int column = -1;
+    if (role > Qt::UserRole)
+        column = role - Qt::UserRole - 1;
+    else if (role == Qt::DisplayRole || role == Qt::EditRole)
+        column = index.column();
 
-QString sanitizeNumber(const QString &number)
-{
-    const QRegularExpression re(QStringLiteral("\\D"));
-    QString sanitzedCallerIDString(number);
-    sanitzedCallerIDString.replace(re, QStringLiteral(""));
-    return sanitzedCallerIDString;
+    return column >= 0 ? d->value(index.row(), column) : QVariant();
 }
 
-struct Contact {
-    QString name;
-    QString picture;
-    QVector<QString> numbers;
-};
-
 void AddressbookModel::setCallerIDString(const QString &callerIDString)
 {
     CallerID callID;
@@ -294,83 +853,16 @@ void AddressbookModel::setCallerIDString(const QString &callerIDString)
     callID.number = callerIDString;
 
     const QString sanitizedCallerID = sanitizeNumber(callerIDString);
-    // NOTE: This assumes that the phone numbers we're checking against are significantly unique to 7 digits, starting from the right
-    const int significantDigits = 7;
-    const QString pattern =  "%" + sanitizedCallerID.right(1);
-    QSqlQuery query(database());
-    query.prepare(SQL_SELECT_CALLERID);
-    query.bindValue(QStringLiteral(":pattern"), pattern);
-    if (!query.exec()) {
-        qWarning("%s: %s", Q_FUNC_INFO, qPrintable(query.lastError().text()));
-        return;
-    }
-
-    // Attempt to find an exact match in the results
-    while (query.next()) {
-        for (int i = 3; i < 9; ++i){
-            if (sanitizeNumber(query.value(i).toString()) == sanitizedCallerID) {
-                callID.name = query.value(0).toString() + QStringLiteral(" ") + query.value(1).toString();
-                callID.picture = query.value(2).toString();
-                d->callerID->setCallerID(callID);
-                return;
-            }
-        }
-    }
 
-    // If we haven't already found a match, begin partial matching on the results, but
-    // only if the callId has enough significant digits.
-    if (sanitizedCallerID.count() >= significantDigits) {
-        query.seek(-1);
-
-        // Build up a list of contact with the numbers that match the last digit
-        QVector<Contact> contacts;
-        while (query.next()) {
-            Contact contact;
-            contact.name = query.value(0).toString() + QStringLiteral(" ") + query.value(1).toString();
-            contact.picture = query.value(2).toString();
-            for (int i = 3; i < 9; ++i){
-                const QString number = sanitizeNumber(query.value(i).toString());
-                if (!number.isEmpty())
-                    contact.numbers.append(number);
-            }
-            contacts.append(contact);
-        }
-        // If no exact match was found, we can drill down by walking backwards through
-        // the string and pruning contacts that don't have a phone number with the same
-        // digit in that position.
-        for (int pos = 1; pos <= significantDigits; ++pos) {
-            const QChar currentDigit = callerIDString.at(callerIDString.size() - pos);
-            QVector<Contact>::Iterator cit = contacts.begin();
-            // Go through contacts one by one
-            while (cit != contacts.end()) {
-                QVector<QString>::Iterator nit = cit->numbers.begin();
-                // Go through numbers of contact one by one
-                while (nit != cit->numbers.end()) {
-                    if (nit->at(nit->size() - pos) != currentDigit) {
-                        // This number doesn't adhere to the match rules, so remove it
-                        nit = cit->numbers.erase(nit);
-                    } else {
-                        ++nit;
-                    }
-                }
-                if (cit->numbers.isEmpty()) {
-                    // This contact doesn't adhere to the match rules, so remove it
-                    contacts.erase(cit);
-                } else {
-                    ++cit;
-                }
-            }
-            if (contacts.isEmpty()) {
-                // If there are no more left break up searching
-                break;
-            }
-        }
+    // cleared since the last sync
+    if (!d->callerIDIndex.isValid() && d->open(database()))
+        d->sync();
 
-        // If one contacte found set callid info
-        if (contacts.size() == 1) {
-            callID.name = contacts.at(0).name;
-            callID.picture = contacts.at(0).picture;
-        }
+    QString name;
+    QString picture;
+    if (d->callerIDIndex.lookup(sanitizedCallerID, &name, &picture)) {
+        callID.name = name;
+        callID.picture = picture;
     }
 
     d->callerID->setCallerID(callID);
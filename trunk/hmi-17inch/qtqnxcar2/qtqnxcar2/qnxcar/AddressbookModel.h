@@ -16,6 +16,14 @@ class CallerIDObject;
  *
  * To contain data, a bluetooth device supporting the phonebook profile must be connected.
  * The model will be empty if no device is connected.
+ *
+ * Only the order of the contacts is read up front, their data is read in blocks of blockSize()
+ * contacts when it is requested. At most maximumResidentBlocks() blocks are kept, the blocks
+ * furthest from the most recently requested row are dropped and read again when needed.
+ * Sorting happens in the database as well, see setSortRole() and sort().
+ *
+ * The display name and the formatted addresses are derived from the other columns once per
+ * update() and stored next to them, so reading them is no different from reading a column.
  */
 
 class QTQNXCAR2_EXPORT AddressbookModel : public SqlQueryModel
@@ -101,6 +109,8 @@ public:
         WebPageRole,
         /// Note about person, role name @c "note"
         NoteRole,
+        // derived on update(), read like the columns above
+
         /// Home address fields formatted as a single multiline string, role name @c "formatted_home_address"
         FormattedHomeAddress,
         /// Work address fields formatted as a single multiline string, role name @c "formatted_work_address"
@@ -127,8 +137,74 @@ public:
     virtual QHash<int, QByteArray> roleNames() const Q_DECL_OVERRIDE;
     virtual QVariant data(const QModelIndex& item, int role = Qt::DisplayRole) const Q_DECL_OVERRIDE;
 
+    /**
+     * Looks up the contact calling from @p callerIDString and fills callerID() with it.
+     *
+     * The lookup uses an index of the phone numbers built on each update(), matching either
+     * all digits of a number or, if unambiguous, its last seven digits.
+     */
     Q_INVOKABLE void setCallerIDString(const QString &callerIDString);
 
+    /**
+     * Clears the model and the caller ID index
+     */
+    void clear() Q_DECL_OVERRIDE;
+
+    /**
+     * Returns the number of all contacts, whether their data has been read or not
+     */
+    int rowCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
+
+    /**
+     * All rows are known up front, returns false
+     */
+    bool canFetchMore(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
+    void fetchMore(const QModelIndex &parent = QModelIndex()) Q_DECL_OVERRIDE;
+
+    /**
+     * Sorts the contacts by sortRole() in the database, case insensitively.
+     * A @p column of -1 restores the order of the database, which is the default.
+     *
+     * @sa setSortRole()
+     */
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) Q_DECL_OVERRIDE;
+
+    /**
+     * Returns the role the contacts are sorted by when sorted, #DisplayName by default
+     */
+    int sortRole() const;
+
+    /**
+     * Sets the role to sort the contacts by, either #DisplayName or one of the column roles
+     */
+    void setSortRole(int role);
+
+    /**
+     * Returns the number of contacts read from the database at a time
+     */
+    int blockSize() const;
+
+    /**
+     * Sets the number of contacts read from the database at a time, 50 by default
+     */
+    void setBlockSize(int size);
+
+    /**
+     * Returns the maximum number of blocks kept in memory, 0 if blocks are never dropped
+     */
+    int maximumResidentBlocks() const;
+
+    /**
+     * Sets the maximum number of blocks kept in memory, 8 by default
+     */
+    void setMaximumResidentBlocks(int blocks);
+
+    /**
+     * Returns the number of blocks currently kept in memory
+     */
+    int residentBlockCount() const;
+
     CallerIDObject *callerID() const;
 
 protected:
@@ -136,6 +212,9 @@ protected:
     QList<QByteArray> columnNames() const Q_DECL_OVERRIDE;
 
 private:
+    /// Reads the order of the contacts and drops the read blocks
+    void reload();
+
     struct Private;
     Private *const d;
 };
@@ -1,10 +1,16 @@
 #include "DatabaseManager.h"
 
+#include "SqlQueryService.h"
 #include "util/StandardDirs.h"
 #include "util/Util.h"
 
+#include <QCoreApplication>
 #include <QDebug>
 #include <QFileInfo>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QPointer>
+#include <QSet>
 #include <QString>
 #include <QSqlDatabase>
 
@@ -33,6 +39,10 @@ QString DatabaseManager::databasePath(const QString &databaseId)
         return QString(QStringLiteral("%1/%2").arg(databaseDirectory()).arg(databaseId));
 }
 
+// paths of the databases switched to write-ahead logging, read by the query service threads
+static QMutex s_writeAheadLoggingMutex;
+static QSet<QString> s_writeAheadLoggingPaths;
+
 static QSqlDatabase createOrGetDatabase(const QString& filePath)
 {
     // default to one connection per file at the moment
@@ -56,4 +66,33 @@ QSqlDatabase DatabaseManager::forQdbPath(const QString &path)
     return createOrGetDatabase(fileName);
 }
 
+void DatabaseManager::setWriteAheadLogging(const QString &database, bool enabled)
+{
+    const QString path = databasePath(database);
+    if (path.isEmpty())
+        return;
+
+    QMutexLocker locker(&s_writeAheadLoggingMutex);
+    if (enabled)
+        s_writeAheadLoggingPaths.insert(path);
+    else
+        s_writeAheadLoggingPaths.remove(path);
+}
+
+bool DatabaseManager::writeAheadLogging(const QString &path)
+{
+    QMutexLocker locker(&s_writeAheadLoggingMutex);
+    return s_writeAheadLoggingPaths.contains(path);
+}
+
+SqlQueryService *DatabaseManager::queryService()
+{
+    // destroyed with the application, so that its threads stop before the SQL drivers go away
+    static QPointer<SqlQueryService> service;
+    if (!service)
+        service = new SqlQueryService(QCoreApplication::instance());
+
+    return service;
+}
+
 }
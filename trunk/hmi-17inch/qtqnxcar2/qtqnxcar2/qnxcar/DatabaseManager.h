@@ -9,6 +9,8 @@ class QSqlDatabase;
 
 namespace QnxCar {
 
+class SqlQueryService;
+
 /**
  * Contains helper functions for retrieving databases
  */
@@ -45,6 +47,31 @@ public:
      * Retrieve the connection to a database identified by its QDB path
      */
     static QSqlDatabase forQdbPath(const QString &path);
+
+    /**
+     * Sets whether the SqlQueryService switches @p database to write-ahead logging
+     *
+     * Only enable this for databases the HMI owns, the journal mode stays in effect for the file.
+     * Databases of system services, e.g. @c phonebook.db, keep their journal mode. Call this
+     * before the first query on the database is submitted.
+     *
+     * @param database a file name resolved by databasePath(), e.g. @c "personalization.db"
+     */
+    static void setWriteAheadLogging(const QString &database, bool enabled);
+
+    /**
+     * Returns whether setWriteAheadLogging() has been enabled for the database at @p path
+     */
+    static bool writeAheadLogging(const QString &path);
+
+    /**
+     * Returns the service running queries on worker threads, created on first use
+     *
+     * The connections returned by database() belong to the GUI thread, queries that may take
+     * long should be submitted to this service instead. The service is owned by the application
+     * instance. Call this from the GUI thread.
+     */
+    static SqlQueryService *queryService();
 };
 
 }
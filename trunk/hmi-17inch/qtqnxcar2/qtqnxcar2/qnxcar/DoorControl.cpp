@@ -1,6 +1,8 @@
 #include "DoorControl.h"
 #include "DoorControl_p.h"
 
+#include <qpps/key.h>
+
 #include <stdio.h>
 #include <fcntl.h>
 #include <iostream>
@@ -47,8 +49,8 @@ CarDoorControl::Private::Private(CarDoorControl *qq)
     m_ppsObject = new QPps::Object(QStringLiteral("/pps/hinge-tech/ui"), QPps::Object::PublishAndSubscribeMode, true, this);
 
     if (m_ppsObject->isValid()) {
-        connect(m_ppsObject, SIGNAL(attributeChanged(QString,QPps::Variant)),
-                this, SLOT(ppsAttributeChanged(QString,QPps::Variant)));
+        connect(m_ppsObject, SIGNAL(attributeKeyChanged(int,QString,QPps::Variant)),
+                this, SLOT(ppsAttributeChanged(int,QString,QPps::Variant)));
         m_ppsObject->setAttributeCacheEnabled(true);
 
         m_fl = q->getIndexByDoorControl(m_ppsObject->attribute(QString::fromLatin1(pps_flControlCmd)).toString());
@@ -69,85 +71,116 @@ CarDoorControl::Private::Private(CarDoorControl *qq)
     }
 }
 
-void CarDoorControl::Private::ppsAttributeChanged(const QString &name, const QPps::Variant &attribute)
+enum DoorControlKey {
+    Key_flControlCmd,
+    Key_frControlCmd,
+    Key_rlControlCmd,
+    Key_rrControlCmd,
+    Key_bkControlCmd,
+    Key_frontLightControlCmd,
+    Key_amfmStateCmd,
+    Key_amfmValueCmd,
+    Key_ui_styleCmd,
+    Key_chairGoBackCmd,
+    Key_chairUpDownCmd,
+    Key_pm_2_5_StateCmd,
+    DoorControlKeyCount
+};
+
+static const char * const pps_doorControlKeys[DoorControlKeyCount] = {
+    pps_flControlCmd,
+    pps_frControlCmd,
+    pps_rlControlCmd,
+    pps_rrControlCmd,
+    pps_bkControlCmd,
+    pps_frontLightControlCmd,
+    pps_amfmStateCmd,
+    pps_amfmValueCmd,
+    pps_ui_styleCmd,
+    pps_chairGoBackCmd,
+    pps_chairUpDownCmd,
+    pps_pm_2_5_StateCmd
+};
+
+static const QPps::KeyTable s_doorControlKeys(pps_doorControlKeys, DoorControlKeyCount);
+
+void CarDoorControl::Private::ppsAttributeChanged(int key, const QString &, const QPps::Variant &attribute)
 {
-    if (name == QString::fromLatin1(pps_flControlCmd)) {
+    switch (s_doorControlKeys.indexOf(key)) {
+    case Key_flControlCmd:
         if (m_fl != attribute.toInt()) {
             m_fl = attribute.toInt();
             emit q->fl_door_stateChanged(m_fl);
         }
-    }
-    else if (name == QString::fromLatin1(pps_frControlCmd)) {
+        break;
+    case Key_frControlCmd:
         if (m_fr != attribute.toInt()) {
             m_fr = attribute.toInt();
             emit q->fr_door_stateChanged(m_fr);
         }
-    }
-    else if (name == QString::fromLatin1(pps_rlControlCmd)) {
+        break;
+    case Key_rlControlCmd:
         if (m_rl != attribute.toInt()) {
             m_rl = attribute.toInt();
             emit q->rl_door_stateChanged(m_rl);
         }
-    }
-    else if (name == QString::fromLatin1(pps_rrControlCmd)) {
+        break;
+    case Key_rrControlCmd:
         if (m_rr != attribute.toInt()) {
             m_rr = attribute.toInt();
             emit q->rr_door_stateChanged(m_rr);
         }
-    }
-    else if (name == QString::fromLatin1(pps_bkControlCmd)) {
+        break;
+    case Key_bkControlCmd:
         if (m_bk != attribute.toInt()) {
             m_bk = attribute.toInt();
             emit q->bk_door_stateChanged(m_bk);
         }
-    }
-    else if (name == QString::fromLatin1(pps_frontLightControlCmd)) {
+        break;
+    case Key_frontLightControlCmd:
         if (m_front_light != attribute.toInt()) {
             m_front_light = attribute.toInt();
             emit q->front_light_stateChanged(m_front_light);
         }
-    }
-    else if (name == QString::fromLatin1(pps_amfmStateCmd)) {
+        break;
+    case Key_amfmStateCmd:
         if (m_am_fm != (attribute.toString() == "am" ? 0 : 1)) {
             m_am_fm = (attribute.toString() == "am" ? 0 : 1);
             emit q->amfm_stateChanged(m_am_fm);
         }
-    }
-    else if (name == QString::fromLatin1(pps_amfmValueCmd)) {
+        break;
+    case Key_amfmValueCmd:
         if (m_am_fm_value != attribute.toDouble()) {
             m_am_fm_value = attribute.toDouble();
             emit q->amfm_valueChanged(m_am_fm_value);
         }
-    }
-    else if (name == QString::fromLatin1(pps_ui_styleCmd)) {
+        break;
+    case Key_ui_styleCmd:
         if (m_ui_style != attribute.toInt()) {
             m_ui_style = attribute.toInt();
             emit q->amfm_valueChanged(m_am_fm_value);
         }
-    }
-    else if (name == QString::fromLatin1(pps_chairGoBackCmd)) {
+        break;
+    case Key_chairGoBackCmd:
         if (m_chair_go_back != attribute.toString().toFloat()) {
             m_chair_go_back = attribute.toString().toFloat();
             emit q->chairGoBackStateChanged(m_am_fm_value);
         }
-    }
-    else if (name == QString::fromLatin1(pps_chairUpDownCmd)) {
+        break;
+    case Key_chairUpDownCmd:
         if (m_chair_up_down != attribute.toString().toFloat()) {
             m_chair_up_down = attribute.toString().toFloat();
             emit q->chairUpDownStateChanged(m_chair_up_down);
         }
-    }
-    else if (name == QString::fromLatin1(pps_chairGoBackCmd)) {
-        if (m_chair_rotate != attribute.toString().toFloat()) {
-            m_chair_rotate = attribute.toString().toFloat();
-            emit q->chairRotateStateChanged(m_chair_rotate);
-        }
-    }
-    else if (name == QString::fromLatin1(pps_pm_2_5_StateCmd)) {
+        break;
+    case Key_pm_2_5_StateCmd:
         if (m_pm_2_5_state != attribute.toString().toInt()) {
             m_pm_2_5_state = attribute.toString().toInt();
             emit q->pm_2_5StateChanged(m_pm_2_5_state);
         }
+        break;
+    default:
+        break;
     }
 }
 
@@ -33,7 +33,7 @@ public:
     int m_pm_2_5_state;
 
 private Q_SLOTS:
-    void ppsAttributeChanged(const QString &name, const QPps::Variant &attribute);
+    void ppsAttributeChanged(int key, const QString &name, const QPps::Variant &attribute);
 };
 
 }
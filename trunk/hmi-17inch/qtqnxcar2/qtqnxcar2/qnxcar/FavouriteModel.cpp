@@ -31,13 +31,7 @@ FavouriteModel::FavouriteModel(QObject *parent) :
 
 void FavouriteModel::runQuery()
 {
-    reopenDatabase();
-    QSqlQuery query(database());
-    query.prepare(SQL_SELECT_FAVOURITE_LOCATIONS);
-    query.bindValue(QLatin1Literal(":profileId"), D_PTR->activeProfileId);
-    query.exec();
-
-    setQuery(query);
+    submitQuery(SQL_SELECT_FAVOURITE_LOCATIONS, QVariantList() << D_PTR->activeProfileId);
 }
 
 QList<QByteArray> FavouriteModel::columnNames() const
@@ -1,6 +1,8 @@
 #include "Hvac.h"
 #include "Hvac_p.h"
 
+#include <qpps/key.h>
+
 #include <stdio.h>
 #include <fcntl.h>
 #include <iostream>
@@ -67,9 +69,12 @@ Hvac::Private::Private(Hvac *qq)
     m_ppsObject = new QPps::Object(QStringLiteral("/pps/hinge-tech/hvac"), QPps::Object::PublishAndSubscribeMode, true, this);
 
     if (m_ppsObject->isValid()) {
-        connect(m_ppsObject, SIGNAL(attributeChanged(QString,QPps::Variant)),
-                this, SLOT(ppsAttributeChanged(QString,QPps::Variant)));
+        connect(m_ppsObject, SIGNAL(attributeKeyChanged(int,QString,QPps::Variant)),
+                this, SLOT(ppsAttributeChanged(int,QString,QPps::Variant)));
         m_ppsObject->setAttributeCacheEnabled(true);
+        // temperature and fan sliders write on every move, merge them into one write per frame
+        m_ppsObject->setWriteBehindInterval(16);
+        m_ppsObject->setWriteBehindEnabled(true);
 
         m_airCirculationSetting = m_ppsObject->attribute(QString::fromLatin1(pps_airCirculationSettingKey)).toInt();
         m_airConditioningEnabled = m_ppsObject->attribute(QString::fromLatin1(pps_airConditioningEnabledKey)).toBool();
@@ -94,98 +99,160 @@ Hvac::Private::Private(Hvac *qq)
     }
 }
 
-void Hvac::Private::ppsAttributeChanged(const QString &name, const QPps::Variant &attribute)
-{
-    if (name == QString::fromLatin1(pps_airCirculationSettingKey)) {
+enum HvacKey {
+    Key_airCirculationSetting,
+    Key_airConditioningEnabled,
+    Key_fanSettingLeft,
+    Key_fanSettingRight,
+    Key_fanSpeedLeft,
+    Key_fanSpeedRight,
+    Key_fanTemperatureLeft,
+    Key_fanTemperatureRight,
+    Key_heatedSeatLevelLeft,
+    Key_heatedSeatLevelRight,
+    Key_rearDefrostEnabled,
+    Key_zoneLinkEnabled,
+    Key_frontwindow_heating,
+    Key_backwindow_heating,
+    Key_air_condition_ac_mode,
+    Key_air_condition_switch,
+    HvacKeyCount
+};
+
+static const char * const pps_hvacKeys[HvacKeyCount] = {
+    pps_airCirculationSettingKey,
+    pps_airConditioningEnabledKey,
+    pps_fanSettingLeftKey,
+    pps_fanSettingRightKey,
+    pps_fanSpeedLeftKey,
+    pps_fanSpeedRightKey,
+    pps_fanTemperatureLeftKey,
+    pps_fanTemperatureRightKey,
+    pps_heatedSeatLevelLeftKey,
+    pps_heatedSeatLevelRightKey,
+    pps_rearDefrostEnabledKey,
+    pps_zoneLinkEnabledKey,
+    pps_frontwindow_heatingKey,
+    pps_backwindow_heatingKey,
+    pps_air_condition_ac_modeKey,
+    pps_air_condition_switchKey
+};
+
+static const QPps::KeyTable s_hvacKeys(pps_hvacKeys, HvacKeyCount);
+
+void Hvac::Private::ppsAttributeChanged(int key, const QString &, const QPps::Variant &attribute)
+{
+    switch (s_hvacKeys.indexOf(key)) {
+    case Key_airCirculationSetting:
         if (m_airCirculationSetting != attribute.toInt()) {
             m_airCirculationSetting = attribute.toInt();
             emit q->airCirculationSettingChanged(m_airCirculationSetting);
         }
-    } else if (name == QString::fromLatin1(pps_airConditioningEnabledKey)) {
+        break;
+    case Key_airConditioningEnabled:
         if (m_airConditioningEnabled != attribute.toBool()) {
             m_airConditioningEnabled = attribute.toBool();
             emit q->airConditioningEnabledChanged(m_airConditioningEnabled);
         }
-    } else if (name == QString::fromLatin1(pps_fanSettingLeftKey)) {
+        break;
+    case Key_fanSettingLeft:
         if (m_fanSettingLeft != q->getIndexByFansetting(attribute.toString())) {
             m_fanSettingLeft = q->getIndexByFansetting(attribute.toString());
             emit q->fanSettingLeftChanged(m_fanSettingLeft);
         }
-    } else if (name == QString::fromLatin1(pps_fanSettingRightKey)) {
+        break;
+    case Key_fanSettingRight:
         if (m_fanSettingRight != q->getIndexByFansetting(attribute.toString())) {
             m_fanSettingRight = q->getIndexByFansetting(attribute.toString());
             emit q->fanSettingRightChanged(m_fanSettingRight);
         }
-    } else if (name == QString::fromLatin1(pps_fanSpeedLeftKey)) {
+        break;
+    case Key_fanSpeedLeft:
         if (m_fanSpeedLeft != attribute.toInt()) {
             m_fanSpeedLeft = attribute.toInt();
             emit q->fanSpeedLeftChanged(m_fanSpeedLeft);
         }
-    } else if (name == QString::fromLatin1(pps_fanSpeedRightKey)) {
+        break;
+    case Key_fanSpeedRight:
         if (m_fanSpeedRight != attribute.toInt()) {
             m_fanSpeedRight = attribute.toInt();
             emit q->fanSpeedRightChanged(m_fanSpeedRight);
         }
-    } else if (name == QString::fromLatin1(pps_fanTemperatureLeftKey)) {
+        break;
+    case Key_fanTemperatureLeft:
         if (m_fanTemperatureLeft != attribute.toInt()) {
             m_fanTemperatureLeft = attribute.toInt();
             emit q->fanTemperatureLeftChanged(m_fanTemperatureLeft);
         }
-    } else if (name == QString::fromLatin1(pps_fanTemperatureRightKey)) {
+        break;
+    case Key_fanTemperatureRight:
         if (m_fanTemperatureRight != attribute.toInt()) {
             m_fanTemperatureRight = attribute.toInt();
             emit q->fanTemperatureRightChanged(m_fanTemperatureRight);
         }
-    } else if (name == QString::fromLatin1(pps_heatedSeatLevelLeftKey)) {
+        break;
+    case Key_heatedSeatLevelLeft:
         if (m_heatedSeatLevelLeft != attribute.toInt()) {
             m_heatedSeatLevelLeft = attribute.toInt();
             emit q->heatedSeatLevelLeftChanged(m_heatedSeatLevelLeft);
         }
-    } else if (name == QString::fromLatin1(pps_heatedSeatLevelRightKey)) {
+        break;
+    case Key_heatedSeatLevelRight:
         if (m_heatedSeatLevelRight != attribute.toInt()) {
             m_heatedSeatLevelRight = attribute.toInt();
             emit q->heatedSeatLevelRightChanged(m_heatedSeatLevelRight);
         }
-    } else if (name == QString::fromLatin1(pps_rearDefrostEnabledKey)) {
+        break;
+    case Key_rearDefrostEnabled:
         if (m_rearDefrostEnabled != attribute.toBool()) {
             m_rearDefrostEnabled = attribute.toBool();
             emit q->rearDefrostEnabledChanged(m_rearDefrostEnabled);
         }
-    } else if (name == QString::fromLatin1(pps_zoneLinkEnabledKey)) {
+        break;
+    case Key_zoneLinkEnabled:
         if (m_zoneLinkEnabled != attribute.toBool()) {
             m_zoneLinkEnabled = attribute.toBool();
             emit q->zoneLinkEnabledChanged(m_zoneLinkEnabled);
         }
-    }else if (name == QString::fromLatin1(pps_frontwindow_heatingKey)) {
+        break;
+    case Key_frontwindow_heating:
         if (m_frontWindowHeatEnabled != attribute.toBool()) {
             m_frontWindowHeatEnabled = attribute.toBool();
             emit q->frontWindowHeatEnabledChanged(m_frontWindowHeatEnabled);
         }
-    }else if (name == QString::fromLatin1(pps_backwindow_heatingKey)) {
+        break;
+    case Key_backwindow_heating:
         if (m_backWindowHeatEnabled != attribute.toBool()) {
             m_backWindowHeatEnabled = attribute.toBool();
             emit q->backWindowHeatEnabledChanged(m_backWindowHeatEnabled);
         }
-//    }else if (name == QString::fromLatin1(pps_outside_circleKey)) {
+        break;
+//    case Key_outside_circle:
 //        if (m_outsideCircleEnabled != attribute.toBool()) {
 //            m_outsideCircleEnabled = attribute.toBool();
 //            emit q->outsideCircleEnabledChanged(m_outsideCircleEnabled);
 //        }
-//    }else if (name == QString::fromLatin1(pps_inside_circleKey)) {
+//        break;
+//    case Key_inside_circle:
 //        if (m_insideCircleEnabled != attribute.toBool()) {
 //            m_insideCircleEnabled = attribute.toBool();
 //            emit q->insideCircleEnabledChanged(m_insideCircleEnabled);
 //        }
-    }else if (name == QString::fromLatin1(pps_air_condition_ac_modeKey)) {
+//        break;
+    case Key_air_condition_ac_mode:
         if (m_airCondition_AC_modeEnabled != attribute.toBool()) {
             m_airCondition_AC_modeEnabled = attribute.toBool();
             emit q->airCondition_AC_modeEnabledChanged(m_airCondition_AC_modeEnabled);
         }
-    }else if (name == QString::fromLatin1(pps_air_condition_switchKey)) {
+        break;
+    case Key_air_condition_switch:
         if (m_airConditionSwitchOn != attribute.toBool()) {
             m_airConditionSwitchOn = attribute.toBool();
             emit q->airConditionSwitchOnChanged(m_airConditionSwitchOn);
         }
+        break;
+    default:
+        break;
     }
 }
 
@@ -38,7 +38,7 @@ public:
     bool m_airConditionSwitchOn;
 
 private Q_SLOTS:
-    void ppsAttributeChanged(const QString &name, const QPps::Variant &attribute);
+    void ppsAttributeChanged(int key, const QString &name, const QPps::Variant &attribute);
 };
 
 }
@@ -1,6 +1,8 @@
 #include "LampStatus.h"
 #include "LampStatus_p.h"
 
+#include <qpps/key.h>
+
 #include <stdio.h>
 #include <fcntl.h>
 #include <iostream>
@@ -30,8 +32,8 @@ LampStatus::Private::Private(LampStatus *qq)
     m_ppsObject = new QPps::Object(QStringLiteral("/pps/hinge-tech/lampstatus"), QPps::Object::PublishAndSubscribeMode, true, this);
 
     if (m_ppsObject->isValid()) {
-        connect(m_ppsObject, SIGNAL(attributeChanged(QString,QPps::Variant)),
-                this, SLOT(ppsAttributeChanged(QString,QPps::Variant)));
+        connect(m_ppsObject, SIGNAL(attributeKeyChanged(int,QString,QPps::Variant)),
+                this, SLOT(ppsAttributeChanged(int,QString,QPps::Variant)));
         m_ppsObject->setAttributeCacheEnabled(true);
 
         m_ambience = m_ppsObject->attribute(QString::fromLatin1(pps_ambienceSettingKey)).toInt();
@@ -45,38 +47,68 @@ LampStatus::Private::Private(LampStatus *qq)
     }
 }
 
-void LampStatus::Private::ppsAttributeChanged(const QString &name, const QPps::Variant &attribute)
+enum LampStatusKey {
+    Key_ambienceSetting,
+    Key_intersection,
+    Key_turnLeft,
+    Key_turnRight,
+    Key_lampBrightness,
+    Key_steerwheelshcok,
+    LampStatusKeyCount
+};
+
+static const char * const pps_lampStatusKeys[LampStatusKeyCount] = {
+    pps_ambienceSettingKey,
+    pps_intersectionKey,
+    pps_turnLeftKey,
+    pps_turnRightKey,
+    pps_lampBrightness,
+    pps_steerwheelshcok
+};
+
+static const QPps::KeyTable s_lampStatusKeys(pps_lampStatusKeys, LampStatusKeyCount);
+
+void LampStatus::Private::ppsAttributeChanged(int key, const QString &, const QPps::Variant &attribute)
 {
-    if (name == QString::fromLatin1(pps_ambienceSettingKey)) {
+    switch (s_lampStatusKeys.indexOf(key)) {
+    case Key_ambienceSetting:
         if (m_ambience != attribute.toInt()) {
             m_ambience = attribute.toInt();
             emit q->ambienceChanged(m_ambience);
         }
-    } else if (name == QString::fromLatin1(pps_intersectionKey)) {
+        break;
+    case Key_intersection:
         if (m_intersection != attribute.toBool()) {
             m_intersection = attribute.toBool();
             emit q->intersectionChanged(m_intersection);
         }
-    } else if (name == QString::fromLatin1(pps_turnLeftKey)) {
+        break;
+    case Key_turnLeft:
         if (m_turn_left != attribute.toBool()) {
             m_turn_left = attribute.toBool();
             emit q->turnLeftChanged(m_turn_left);
         }
-    } else if (name == QString::fromLatin1(pps_turnRightKey)) {
+        break;
+    case Key_turnRight:
         if (m_turn_right !=  attribute.toBool()) {
             m_turn_right = attribute.toBool();
             emit q->turnRightChanged(m_turn_right);
         }
-    } else if (name == QString::fromLatin1(pps_lampBrightness)) {
+        break;
+    case Key_lampBrightness:
         if (m_lampBrighrness !=  attribute.toInt()) {
             m_lampBrighrness = attribute.toInt();
             emit q->lampBrightnessChanged(m_lampBrighrness);
         }
-    } else if (name == QString::fromLatin1(pps_steerwheelshcok)) {
+        break;
+    case Key_steerwheelshcok:
         if (m_steerwheel_shock !=  attribute.toInt()) {
             m_steerwheel_shock = attribute.toInt();
             emit q->steerWheelShockChanged(m_steerwheel_shock);
         }
+        break;
+    default:
+        break;
     }
 }
 
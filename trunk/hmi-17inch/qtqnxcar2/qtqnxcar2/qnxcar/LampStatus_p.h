@@ -26,7 +26,7 @@ public:
     int m_steerwheel_shock;
 
 private Q_SLOTS:
-    void ppsAttributeChanged(const QString &name, const QPps::Variant &attribute);
+    void ppsAttributeChanged(int key, const QString &name, const QPps::Variant &attribute);
 };
 
 }
@@ -1,8 +1,6 @@
 #include "LocationModel.h"
 #include "Location.h"
 
-#include <QSqlQuery>
-
 namespace QnxCar {
 
 static const QString SQL_RECORD_LIMIT = QLatin1Literal(" LIMIT 20000");
@@ -36,11 +34,7 @@ LocationModel::LocationModel(QObject *parent)
 
 void LocationModel::runQuery()
 {
-    reopenDatabase();
-    QSqlQuery query(database());
-    query.prepare(SQL_SELECT_LOCATIONS);
-    query.exec();
-    setQuery(query);
+    submitQuery(SQL_SELECT_LOCATIONS);
 }
 
 QVariant LocationModel::data(const QModelIndex &index, int role) const
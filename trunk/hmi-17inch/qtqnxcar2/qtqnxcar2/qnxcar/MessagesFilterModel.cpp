@@ -11,10 +11,32 @@ public:
         : showAll(true)
     {}
 
+    /// Sets the filter on @p source if it is a MessagesModel, returns whether it is one
+    bool applyTo(QAbstractItemModel *source) const;
+
     QSet<int> types;
     bool showAll;
 };
 
+bool MessagesFilterModel::Private::applyTo(QAbstractItemModel *source) const
+{
+    MessagesModel *messagesModel = qobject_cast<MessagesModel*>(source);
+    if (!messagesModel)
+        return false;
+
+    if (showAll || types.isEmpty()) {
+        messagesModel->clearFilters();
+        return true;
+    }
+
+    QSet<int>::const_iterator it = types.constBegin();
+    messagesModel->setFilterMessageType(*it);
+    for (++it; it != types.constEnd(); ++it)
+        messagesModel->addFilterMessageType(*it);
+
+    return true;
+}
+
 MessagesFilterModel::MessagesFilterModel(QObject *parent)
     : QSortFilterProxyModel(parent)
     , d(new Private)
@@ -30,6 +52,9 @@ bool MessagesFilterModel::filterAcceptsRow(int source_row, const QModelIndex &so
 {
     if (d->showAll)
         return true;
+    // filtered in the database already
+    if (qobject_cast<MessagesModel*>(sourceModel()))
+        return true;
     const QModelIndex idx = sourceModel()->index(source_row, 0, source_parent);
     const int type = idx.data(MessagesModel::TypeRole).toInt();
     return d->types.contains(type);
@@ -39,6 +64,8 @@ void MessagesFilterModel::setFilterMessageType(int type)
 {
     d->showAll = false;
     d->types = QSet<int>() << type;
+    if (d->applyTo(sourceModel()))
+        return;
     invalidateFilter();
 }
 
@@ -46,6 +73,8 @@ void MessagesFilterModel::addFilterMessageType(int type)
 {
     d->showAll = false;
     d->types << type;
+    if (d->applyTo(sourceModel()))
+        return;
     invalidateFilter();
 }
 
@@ -53,5 +82,13 @@ void MessagesFilterModel::clearFilters()
 {
     d->types.clear();
     d->showAll = true;
+    if (d->applyTo(sourceModel()))
+        return;
     invalidateFilter();
 }
+
+void MessagesFilterModel::setSourceModel(QAbstractItemModel *sourceModel)
+{
+    QSortFilterProxyModel::setSourceModel(sourceModel);
+    d->applyTo(sourceModel);
+}
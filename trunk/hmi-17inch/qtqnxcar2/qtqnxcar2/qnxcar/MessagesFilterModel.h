@@ -11,10 +11,11 @@ namespace QnxCar {
 
 /**
  * Filter model to filter messages from MessagesModel by type.
- * When using different views on the same message data, using a single
- * MessagesModel with different filters on top of a single unfiltered messages model
- * is a more convenient and performant approach than using multiple MessagesModel
- * instances duplicating data.
+ *
+ * A MessagesModel only reads the messages shown, so filtering them here would read all of them.
+ * When the source model is a MessagesModel, the filter is set on it instead and applies to
+ * all views on that model; use one MessagesModel per differently filtered view then.
+ * Other source models are filtered by their #MessagesModel::TypeRole as usual.
  */
 class QTQNXCAR2_EXPORT MessagesFilterModel : public QSortFilterProxyModel
 {
@@ -47,6 +48,8 @@ public:
      */
     Q_INVOKABLE void clearFilters();
 
+    void setSourceModel(QAbstractItemModel *sourceModel) Q_DECL_OVERRIDE;
+
 protected:
     bool filterAcceptsRow(int source_row, const QModelIndex &source_parent) const;
 
@@ -11,8 +11,6 @@
 
 namespace QnxCar {
 
-static const QString SQL_RECORD_LIMIT = QLatin1Literal(" LIMIT 20000");
-
 static const QString SQL_SELECT_MESSAGES_TPL = QLatin1Literal(
     "SELECT "
     "message_id, "
@@ -26,16 +24,38 @@ static const QString SQL_SELECT_MESSAGES_TPL = QLatin1Literal(
     "subject, "
     "datetime "
     "FROM messages_view "
+    "%1 "
+    "ORDER BY datetime DESC, message_id DESC "
+    "LIMIT %2"
 );
 
-static const QString SQL_ORDER = QLatin1Literal(" ORDER BY datetime DESC");
+// the key of the message %3 messages away from the bound, counted in either order
+static const QString SQL_SELECT_KEY_TPL = QLatin1Literal(
+    "SELECT datetime, message_id "
+    "FROM messages_view "
+    "%1 "
+    "ORDER BY %2 "
+    "LIMIT 1 OFFSET %3"
+);
 
-static const QString SQL_SELECT_MESSAGES_BY_TYPE = SQL_SELECT_MESSAGES_TPL + QLatin1Literal(
-    " WHERE type = :messageType") +
-    SQL_ORDER + SQL_RECORD_LIMIT;
+static const QString SQL_ORDER_DESCENDING = QLatin1Literal("datetime DESC, message_id DESC");
+static const QString SQL_ORDER_ASCENDING = QLatin1Literal("datetime ASC, message_id ASC");
 
+// spelled out instead of a row value comparison, which needs SQLite 3.15
+static const QString SQL_BEFORE_KEY = QLatin1Literal("(datetime < ? OR (datetime = ? AND message_id < ?))");
+static const QString SQL_AT_OR_BEFORE_KEY = QLatin1Literal("(datetime < ? OR (datetime = ? AND message_id <= ?))");
 
-static const QString SQL_SELECT_MESSAGES = SQL_SELECT_MESSAGES_TPL + SQL_ORDER + SQL_RECORD_LIMIT;
+static const QString SQL_COUNT_MESSAGES = QLatin1Literal(
+    "SELECT type, COUNT(*) "
+    "FROM messages_view "
+    "GROUP BY type"
+);
+
+static const QString SQL_SELECT_BODIES_TPL = QLatin1Literal(
+    "SELECT handle, account_id, body_plain_text, body_html "
+    "FROM full_messages_view "
+    "WHERE handle IN (%1)"
+);
 
 static const QString SQL_SELECT_PLAIN_TEXT = QLatin1Literal("SELECT "
     "body_plain_text "
@@ -51,6 +71,12 @@ static const QString SQL_SELECT_HTML = QLatin1Literal("SELECT "
 );
 
 
+static const int MessageIdColumn = 0;
+static const int HandleColumn = MessagesModel::MessageHandleRole - MessagesModel::MessageIdRole;
+static const int AccountIdColumn = MessagesModel::AccountIdRole - MessagesModel::MessageIdRole;
+static const int DateTimeColumn = MessagesModel::DateTimeRole - MessagesModel::MessageIdRole;
+static const int ColumnCount = DateTimeColumn + 1;
+
 static MessagesModel::MessageType typeFromString(const QString &str)
 {
     if (str == QStringLiteral("EMAIL"))
@@ -89,6 +115,206 @@ QList<QByteArray> MessagesModel::columnNames() const
         << "datetime";
 }
 
+void MessagesModel::Private::reset()
+{
+    pages.clear();
+    bounds.clear();
+    currentPage = 0;
+
+    rowCount = 0;
+    QHash<QString, int>::const_iterator it = typeCounts.constBegin();
+    for (; it != typeCounts.constEnd(); ++it) {
+        if (messageTypes.isEmpty() || messageTypes.contains(it.key()))
+            rowCount += it.value();
+    }
+}
+
+const MessagesModel::Private::Page *MessagesModel::Private::page(const QSqlDatabase &database, int index) const
+{
+    currentPage = index;
+
+    QHash<int, Page>::const_iterator it = pages.constFind(index);
+    if (it != pages.constEnd())
+        return &it.value();
+
+    Bound bound;
+    if (!findBound(database, index, &bound))
+        return 0;
+
+    QSqlQuery query(database);
+    query.setForwardOnly(true);
+    query.prepare(SQL_SELECT_MESSAGES_TPL.arg(whereClause(bound)).arg(pageSize));
+    bindWhere(query, bound);
+    if (!query.exec()) {
+        qWarning("%s: %s", Q_FUNC_INFO, qPrintable(query.lastError().text()));
+        return 0;
+    }
+
+    Page page;
+    page.rows.reserve(pageSize);
+    while (query.next()) {
+        Row row(ColumnCount);
+        for (int column = 0; column < ColumnCount; ++column)
+            row[column] = query.value(column);
+        page.rows.append(row);
+    }
+
+    // the next page starts right after the last message of this one
+    if (page.rows.count() == pageSize && !bounds.contains(index + 1)) {
+        Bound next;
+        next.datetime = page.rows.last().at(DateTimeColumn);
+        next.messageId = page.rows.last().at(MessageIdColumn);
+        next.inclusive = false;
+        bounds.insert(index + 1, next);
+    }
+
+    pages.insert(index, page);
+    evictPages();
+
+    return &pages.constFind(index).value();
+}
+
+bool MessagesModel::Private::findBound(const QSqlDatabase &database, int index, Bound *bound) const
+{
+    if (index == 0) {
+        *bound = Bound();
+        return true;
+    }
+
+    QHash<int, Bound>::const_iterator it = bounds.constFind(index);
+    if (it != bounds.constEnd()) {
+        *bound = it.value();
+        return true;
+    }
+
+    // skip from the closest known bound before the page or from the last message, whichever is closer,
+    // so that jumping costs as much as the distance skipped and not the position in the list
+    int known = index - 1;
+    while (known > 0 && !bounds.contains(known))
+        --known;
+
+    const Bound from = bounds.value(known);
+    const int forward = (index - known) * pageSize;
+    const int backward = rowCount - index * pageSize - 1;
+    if (backward < 0)
+        return false;
+
+    QSqlQuery query(database);
+    query.setForwardOnly(true);
+    if (backward < forward) {
+        query.prepare(SQL_SELECT_KEY_TPL.arg(whereClause(Bound()), SQL_ORDER_ASCENDING).arg(backward));
+        bindWhere(query, Bound());
+    } else {
+        query.prepare(SQL_SELECT_KEY_TPL.arg(whereClause(from), SQL_ORDER_DESCENDING).arg(forward));
+        bindWhere(query, from);
+    }
+
+    if (!query.exec()) {
+        qWarning("%s: %s", Q_FUNC_INFO, qPrintable(query.lastError().text()));
+        return false;
+    }
+
+    if (!query.next())
+        return false;
+
+    bound->datetime = query.value(0);
+    bound->messageId = query.value(1);
+    bound->inclusive = true;
+    bounds.insert(index, *bound);
+    return true;
+}
+
+QString MessagesModel::Private::whereClause(const Bound &bound) const
+{
+    QStringList conditions;
+
+    if (!messageTypes.isEmpty()) {
+        QStringList placeholders;
+        for (int i = 0; i < messageTypes.count(); ++i)
+            placeholders.append(QStringLiteral("?"));
+        conditions.append(QStringLiteral("type IN (%1)").arg(placeholders.join(QStringLiteral(", "))));
+    }
+
+    if (bound.datetime.isValid())
+        conditions.append(bound.inclusive ? SQL_AT_OR_BEFORE_KEY : SQL_BEFORE_KEY);
+
+    if (conditions.isEmpty())
+        return QString();
+
+    return QStringLiteral("WHERE ") + conditions.join(QStringLiteral(" AND "));
+}
+
+void MessagesModel::Private::bindWhere(QSqlQuery &query, const Bound &bound) const
+{
+    Q_FOREACH (const QString &type, messageTypes)
+        query.addBindValue(type);
+
+    if (bound.datetime.isValid()) {
+        query.addBindValue(bound.datetime);
+        query.addBindValue(bound.datetime);
+        query.addBindValue(bound.messageId);
+    }
+}
+
+void MessagesModel::Private::loadBodies(const QSqlDatabase &database, Page *page) const
+{
+    if (page->rows.isEmpty())
+        return;
+
+    QStringList placeholders;
+    for (int i = 0; i < page->rows.count(); ++i)
+        placeholders.append(QStringLiteral("?"));
+
+    QSqlQuery query(database);
+    query.setForwardOnly(true);
+    query.prepare(SQL_SELECT_BODIES_TPL.arg(placeholders.join(QStringLiteral(", "))));
+    Q_FOREACH (const Row &row, page->rows)
+        query.addBindValue(row.at(HandleColumn));
+
+    if (!query.exec()) {
+        qWarning("%s: %s", Q_FUNC_INFO, qPrintable(query.lastError().text()));
+        return;
+    }
+
+    page->bodies.clear();
+    while (query.next()) {
+        Body body;
+        body.plainText = query.value(2).toString();
+        body.html = query.value(3).toString();
+
+        // not fetched from the phone yet, read again on the next request
+        if (body.plainText.isEmpty() && body.html.isEmpty())
+            continue;
+
+        page->bodies.insert(MessageKey(query.value(0).toString(), query.value(1).toInt()), body);
+    }
+}
+
+void MessagesModel::Private::evictPages() const
+{
+    if (maximumResidentPages == 0)
+        return;
+
+    while (pages.count() > maximumResidentPages) {
+        int furthestPage = -1;
+        int furthestDistance = 0;
+        QHash<int, Page>::const_iterator it = pages.constBegin();
+        for (; it != pages.constEnd(); ++it) {
+            const int distance = qAbs(it.key() - currentPage);
+            if (distance > furthestDistance) {
+                furthestPage = it.key();
+                furthestDistance = distance;
+            }
+        }
+
+        // only the current page is left
+        if (furthestPage < 0)
+            return;
+
+        pages.remove(furthestPage);
+    }
+}
+
 MessagesModel::MessagesModel(QObject* parent)
     : SqlQueryModel(new Private, parent)
 {
@@ -97,16 +323,22 @@ MessagesModel::MessagesModel(QObject* parent)
 void MessagesModel::runQuery()
 {
     reopenDatabase();
-    if (D_PTR->messageType != -1) {
-        const QString typeStr = typeToString(D_PTR->messageType);
-        QSqlQuery query(database());
-        query.prepare(SQL_SELECT_MESSAGES_BY_TYPE);
-        query.bindValue(QStringLiteral(":messageType"), typeStr);
-        query.exec();
-        setQuery(query);
+
+    beginResetModel();
+
+    D_PTR->typeCounts.clear();
+    QSqlQuery query(database());
+    query.setForwardOnly(true);
+    if (query.exec(SQL_COUNT_MESSAGES)) {
+        while (query.next())
+            D_PTR->typeCounts.insert(query.value(0).toString(), query.value(1).toInt());
     } else {
-        setQuery(SQL_SELECT_MESSAGES, database());
+        qWarning("%s: %s", Q_FUNC_INFO, qPrintable(query.lastError().text()));
     }
+
+    D_PTR->reset();
+
+    endResetModel();
 }
 
 QHash<int, QByteArray> MessagesModel::roleNames() const
@@ -119,11 +351,10 @@ QHash<int, QByteArray> MessagesModel::roleNames() const
 
 QVariant MessagesModel::data(const QModelIndex& item, int role) const
 {
-    const QVariant v = SqlQueryModel::data(item, role);
+    if (!item.isValid() || item.row() >= D_PTR->rowCount)
+        return QVariant();
 
     switch (role) {
-    case TypeRole:
-        return typeFromString(v.toString());
     case DateTimeAsStringRole:
         return QnxCar::formatDateTime(data(item, DateTimeRole).toDateTime());
     case SenderLabelRole:
@@ -143,30 +374,147 @@ QVariant MessagesModel::data(const QModelIndex& item, int role) const
         break;
     }
 
+    int column = -1;
+    if (role == Qt::DisplayRole)
+        column = item.column();
+    else if (role >= MessageIdRole && role <= DateTimeRole)
+        column = role - MessageIdRole;
+
+    if (column < 0 || column >= ColumnCount)
+        return QVariant();
+
+    const Private::Page *page = D_PTR->page(database(), item.row() / D_PTR->pageSize);
+    if (!page)
+        return QVariant();
+
+    const QVariant v = page->rows.value(item.row() % D_PTR->pageSize).value(column);
+    if (role == TypeRole)
+        return typeFromString(v.toString());
+
     return v;
 }
 
 void MessagesModel::setFilterMessageType(int type)
 {
-    D_PTR->messageType = type;
-    update();
+    beginResetModel();
+    D_PTR->messageTypes = QStringList(typeToString(type));
+    D_PTR->reset();
+    endResetModel();
+}
+
+void MessagesModel::addFilterMessageType(int type)
+{
+    const QString typeStr = typeToString(type);
+    if (D_PTR->messageTypes.contains(typeStr))
+        return;
+
+    beginResetModel();
+    D_PTR->messageTypes.append(typeStr);
+    D_PTR->reset();
+    endResetModel();
 }
 
 void MessagesModel::clearFilters()
 {
-    D_PTR->messageType = -1;
-    update();
+    beginResetModel();
+    D_PTR->messageTypes.clear();
+    D_PTR->reset();
+    endResetModel();
+}
+
+int MessagesModel::messageCount(int type) const
+{
+    return D_PTR->typeCounts.value(typeToString(type));
 }
 
 void MessagesModel::clear()
 {
-    //clear doesn't seem to suffice to clear the model/notify the views
-    setQuery(QSqlQuery());
-    SqlQueryModel::clear();
+    beginResetModel();
+    D_PTR->typeCounts.clear();
+    D_PTR->reset();
+    endResetModel();
+}
+
+int MessagesModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : D_PTR->rowCount;
+}
+
+int MessagesModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+bool MessagesModel::canFetchMore(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+
+    // rowCount() is the number of all shown messages, pages are read when their data is requested
+    return false;
+}
+
+void MessagesModel::fetchMore(const QModelIndex &parent)
+{
+    Q_UNUSED(parent);
+}
+
+int MessagesModel::pageSize() const
+{
+    return D_PTR->pageSize;
+}
+
+void MessagesModel::setPageSize(int size)
+{
+    if (size < 1 || size == D_PTR->pageSize)
+        return;
+
+    D_PTR->pageSize = size;
+    D_PTR->pages.clear();
+    D_PTR->bounds.clear();
+}
+
+int MessagesModel::maximumResidentPages() const
+{
+    return D_PTR->maximumResidentPages;
+}
+
+void MessagesModel::setMaximumResidentPages(int pages)
+{
+    D_PTR->maximumResidentPages = qMax(0, pages);
+    D_PTR->evictPages();
+}
+
+int MessagesModel::residentPageCount() const
+{
+    return D_PTR->pages.count();
 }
 
 QString MessagesModel::messageBody(int accountId, const QString &messageHandle, TextFormat format) const
 {
+    // read along with the other messages of its page if the message is shown
+    const Private::MessageKey key(messageHandle, accountId);
+    QHash<int, Private::Page>::iterator it = D_PTR->pages.begin();
+    for (; it != D_PTR->pages.end(); ++it) {
+        Private::Page &page = it.value();
+
+        bool onPage = false;
+        Q_FOREACH (const Private::Row &row, page.rows) {
+            if (row.at(AccountIdColumn).toInt() == accountId && row.at(HandleColumn).toString() == messageHandle) {
+                onPage = true;
+                break;
+            }
+        }
+
+        if (!onPage)
+            continue;
+
+        if (!page.bodies.contains(key))
+            D_PTR->loadBodies(database(), &page);
+
+        const Private::Body body = page.bodies.value(key);
+        return format == PlainText ? body.plainText : body.html;
+    }
+
     QSqlQuery query(database());
     query.prepare(format == PlainText ? SQL_SELECT_PLAIN_TEXT : SQL_SELECT_HTML);
     query.bindValue(QStringLiteral(":accountId"), accountId);
@@ -14,6 +14,13 @@ namespace QnxCar {
  *
  * To contain data, a bluetooth device supporting the messages profile must be connected.
  * The model will be empty if no device is connected.
+ *
+ * The messages are read in pages of pageSize() messages when they are requested, newest first.
+ * A page is found by the (datetime, message_id) key of the message before it instead of an offset,
+ * so reading a page costs the same whether it is the first or the thousandth one. At most
+ * maximumResidentPages() pages are kept, the pages furthest from the most recently requested row
+ * are dropped and read again when needed. The number of messages comes from a single aggregate
+ * per update(), filtering by type happens in the database as well.
  */
 class QTQNXCAR2_EXPORT MessagesModel : public SqlQueryModel
 {
@@ -90,17 +97,72 @@ public:
     Q_INVOKABLE void setFilterMessageType(int type);
 
     /**
-     * Clears filtering set by setFilterMessageType()
+     * Adds @p type to the shown message types
+     *
+     * @param type a #MessageType
+     * @sa clearFilters(), setFilterMessageType()
+     */
+    Q_INVOKABLE void addFilterMessageType(int type);
+
+    /**
+     * Clears filtering set by setFilterMessageType(), addFilterMessageType()
      */
     Q_INVOKABLE void clearFilters();
 
+    /**
+     * Returns the number of messages of a given @p type, regardless of the filter
+     *
+     * @param type a #MessageType
+     */
+    Q_INVOKABLE int messageCount(int type) const;
+
     void clear() Q_DECL_OVERRIDE;
 
+    /**
+     * Returns the number of all shown messages, whether they have been read or not
+     */
+    int rowCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
+
+    /**
+     * All rows are known up front, returns false
+     */
+    bool canFetchMore(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
+    void fetchMore(const QModelIndex &parent = QModelIndex()) Q_DECL_OVERRIDE;
+
+    /**
+     * Returns the number of messages read from the database at a time
+     */
+    int pageSize() const;
+
+    /**
+     * Sets the number of messages read from the database at a time, 50 by default
+     */
+    void setPageSize(int size);
+
+    /**
+     * Returns the maximum number of pages kept in memory, 0 if pages are never dropped
+     */
+    int maximumResidentPages() const;
+
+    /**
+     * Sets the maximum number of pages kept in memory, 8 by default
+     */
+    void setMaximumResidentPages(int pages);
+
+    /**
+     * Returns the number of pages currently kept in memory
+     */
+    int residentPageCount() const;
+
     /**
      * Returns a message body of a message from the database.
      * The bodies are not fetched by default and must be requested separately via PPS.
      * Depending on the phone, the body will provided as HTML or plain text.
      * Thus you must
+     *
+     * The bodies of all messages on the page of the message are read with a single query and kept
+     * with the page. Bodies not fetched yet are read again on the next request.
      */
     Q_INVOKABLE QString messageBody(int accountId, const QString &messageHandle, TextFormat format) const;
 
@@ -3,14 +3,83 @@
 
 #include "SqlQueryModel_p.h"
 
+#include <QHash>
+#include <QPair>
+#include <QSqlDatabase>
+#include <QStringList>
+#include <QVariant>
+#include <QVector>
+
+class QSqlQuery;
+
 namespace QnxCar {
 
 class MessagesModel::Private : public SqlQueryModel::Private
 {
 public:
-    Private() : messageType(-1) {}
+    typedef QVector<QVariant> Row;
+
+    /// Handle and account of a message
+    typedef QPair<QString, int> MessageKey;
+
+    struct Body
+    {
+        QString plainText;
+        QString html;
+    };
+
+    /**
+     * Where a page starts in the order of the messages, by the key of a neighbouring message.
+     * An invalid datetime marks the first page.
+     */
+    struct Bound
+    {
+        Bound() : inclusive(true) {}
+
+        QVariant datetime;
+        QVariant messageId;
+        /// Whether the page starts with the message, otherwise right after it
+        bool inclusive;
+    };
+
+    struct Page
+    {
+        QVector<Row> rows;
+        /// Bodies of the messages of the page, read on the first request of one of them
+        QHash<MessageKey, Body> bodies;
+    };
+
+    Private()
+        : rowCount(0)
+        , pageSize(50)
+        , maximumResidentPages(8)
+        , currentPage(0)
+    {}
+
+    /// Drops all pages and what is known about their bounds, e.g. when the filter changes
+    void reset();
+
+    const Page *page(const QSqlDatabase &database, int index) const;
+    bool findBound(const QSqlDatabase &database, int index, Bound *bound) const;
+    QString whereClause(const Bound &bound) const;
+    void bindWhere(QSqlQuery &query, const Bound &bound) const;
+    void loadBodies(const QSqlDatabase &database, Page *page) const;
+    void evictPages() const;
+
+    /// Raw types of the shown messages, empty for all messages
+    QStringList messageTypes;
+
+    /// Number of messages by raw type, read once per update
+    QHash<QString, int> typeCounts;
+    int rowCount;
 
-    int messageType;
+    int pageSize;
+    int maximumResidentPages;
+    /// The page of the most recently requested row
+    mutable int currentPage;
+    mutable QHash<int, Page> pages;
+    /// Bounds of the pages found so far, kept when pages are evicted
+    mutable QHash<int, Bound> bounds;
 };
 
 }
@@ -46,12 +46,7 @@ QHash<int, QByteArray> NavigationHistoryModel::roleNames() const
 
 void NavigationHistoryModel::runQuery()
 {
-    reopenDatabase();
-    QSqlQuery query(database());
-    query.prepare(SQL_SELECT_HISTORY_LOCATIONS);
-    query.bindValue(QLatin1Literal(":profileId"), D_PTR->activeProfileId);
-    query.exec();
-    setQuery(query);
+    submitQuery(SQL_SELECT_HISTORY_LOCATIONS, QVariantList() << D_PTR->activeProfileId);
 }
 
 QList<QByteArray> NavigationHistoryModel::columnNames() const
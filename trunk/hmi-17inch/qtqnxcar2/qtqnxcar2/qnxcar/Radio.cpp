@@ -1,6 +1,8 @@
 #include "Radio.h"
 #include "Radio_p.h"
 
+#include <qpps/key.h>
+
 #include <QDebug>
 #include <QJsonDocument>
 #include <QTime>
@@ -81,11 +83,15 @@ Radio::Private::Private(Radio *qq)
 
     if (!m_ppsControlObject->isValid()) {
         qWarning() << Q_FUNC_INFO << "Could not open PPS object:" << m_ppsControlObject->errorString();
+    } else {
+        // dragging the tuning dial writes a station per move, only the last one per frame matters
+        m_ppsControlObject->setWriteBehindInterval(16);
+        m_ppsControlObject->setWriteBehindEnabled(true);
     }
 
     if (m_ppsStatusObject->isValid()) {
-        connect(m_ppsStatusObject, SIGNAL(attributeChanged(QString,QPps::Variant)),
-                this, SLOT(ppsStatusAttributeChanged(QString,QPps::Variant)));
+        connect(m_ppsStatusObject, SIGNAL(attributeKeyChanged(int,QString,QPps::Variant)),
+                this, SLOT(ppsStatusAttributeChanged(int,QString,QPps::Variant)));
         m_ppsStatusObject->setAttributeCacheEnabled(true);
 
         attributeToStations(m_ppsStatusObject->attribute(QString::fromLatin1(pps_amKey)), m_presetAmStations, m_amStation);
@@ -105,8 +111,8 @@ Radio::Private::Private(Radio *qq)
     }
 
     if (m_ppsTunersObject->isValid()) {
-        connect(m_ppsTunersObject, SIGNAL(attributeChanged(QString,QPps::Variant)),
-                this, SLOT(ppsTunersAttributeChanged(QString,QPps::Variant)));
+        connect(m_ppsTunersObject, SIGNAL(attributeKeyChanged(int,QString,QPps::Variant)),
+                this, SLOT(ppsTunersAttributeChanged(int,QString,QPps::Variant)));
         m_ppsTunersObject->setAttributeCacheEnabled(true);
 
         m_amTuner = m_ppsTunersObject->attribute(QString::fromLatin1(pps_amTunerKey)).toJson().toVariant().toMap();
@@ -181,9 +187,39 @@ void Radio::Private::stopSeeking()
     }
 }
 
-void Radio::Private::ppsStatusAttributeChanged(const QString &name, const QPps::Variant &attribute)
-{
-    if (name == QString::fromLatin1(pps_amKey)) {
+enum RadioStatusKey {
+    Key_am,
+    Key_fm,
+    Key_artist,
+    Key_genre,
+    Key_song,
+    Key_amstation,
+    Key_fmstation,
+    Key_highDefinitionEnabled,
+    Key_tuner,
+    Key_seekState,
+    RadioStatusKeyCount
+};
+
+static const char * const pps_radioStatusKeys[RadioStatusKeyCount] = {
+    pps_amKey,
+    pps_fmKey,
+    pps_artistKey,
+    pps_genreKey,
+    pps_songKey,
+    pps_amstationKey,
+    pps_fmstationKey,
+    pps_highDefinitionEnabledKey,
+    pps_tunerKey,
+    pps_seekStateKey
+};
+
+static const QPps::KeyTable s_radioStatusKeys(pps_radioStatusKeys, RadioStatusKeyCount);
+
+void Radio::Private::ppsStatusAttributeChanged(int key, const QString &, const QPps::Variant &attribute)
+{
+    switch (s_radioStatusKeys.indexOf(key)) {
+    case Key_am: {
         QVariantList presetStations;
         double station;
 
@@ -204,7 +240,9 @@ void Radio::Private::ppsStatusAttributeChanged(const QString &name, const QPps::
                 stopSeeking();
             }
         }
-    } else if (name == QString::fromLatin1(pps_fmKey)) {
+        break;
+    }
+    case Key_fm: {
         QVariantList presetStations;
         double station;
 
@@ -225,22 +263,27 @@ void Radio::Private::ppsStatusAttributeChanged(const QString &name, const QPps::
                 stopSeeking();
             }
         }
-    } else if (name == QString::fromLatin1(pps_artistKey)) {
+        break;
+    }
+    case Key_artist:
         if (m_artist != attribute.toString()) {
             m_artist = attribute.toString();
             emit q->artistChanged(m_artist);
         }
-    } else if (name == QString::fromLatin1(pps_genreKey)) {
+        break;
+    case Key_genre:
         if (m_genre != attribute.toString()) {
             m_genre = attribute.toString();
             emit q->genreChanged(m_genre);
         }
-    } else if (name == QString::fromLatin1(pps_songKey)) {
+        break;
+    case Key_song:
         if (m_song != attribute.toString()) {
             m_song = attribute.toString();
             emit q->songChanged(m_song);
         }
-    } else if (name == QString::fromLatin1(pps_amstationKey)) {
+        break;
+    case Key_amstation:
 //        if (m_stationName != attribute.toString()) {
 //            m_stationName = attribute.toString();
 //            emit q->stationNameChanged(m_stationName);
@@ -250,21 +293,21 @@ void Radio::Private::ppsStatusAttributeChanged(const QString &name, const QPps::
               m_amStation = attribute.toDouble();
               emit q->stationChanged(m_amStation);
           }
-    }
-    else if(name == QString::fromLatin1(pps_fmstationKey))
-    {
+        break;
+    case Key_fmstation:
         if(m_fmStation != attribute.toDouble())
         {
             m_fmStation = attribute.toDouble();
             emit q->stationChanged(m_fmStation);
         }
-    }
-    else if (name == QString::fromLatin1(pps_highDefinitionEnabledKey)) {
+        break;
+    case Key_highDefinitionEnabled:
         if (m_highDefinitionEnabled != attribute.toBool()) {
             m_highDefinitionEnabled = attribute.toBool();
             emit q->highDefinitionEnabledChanged(m_highDefinitionEnabled);
         }
-    } else if (name == QString::fromLatin1(pps_tunerKey)) {
+        break;
+    case Key_tuner: {
         const Tuner tuner = stringToTuner(attribute.toString());
         if (m_tuner != tuner) {
             m_tuner = tuner;
@@ -272,20 +315,43 @@ void Radio::Private::ppsStatusAttributeChanged(const QString &name, const QPps::
             emit q->presetStationsChanged(m_tuner == Radio::AmTuner ? m_presetAmStations : m_presetFmStations);
             emit q->stationChanged(m_tuner == Radio::FmTuner ? m_amStation : m_fmStation);
         }
-    } else if (name == QString::fromLatin1(pps_seekStateKey)) {
+        break;
+    }
+    case Key_seekState:
         if (m_seek_state != attribute.toString()) {
             m_seek_state = attribute.toString();
             emit q->seekStateChanged(m_seek_state);
         }
+        break;
+    default:
+        break;
     }
 }
 
-void Radio::Private::ppsTunersAttributeChanged(const QString &name, const QPps::Variant &attribute)
+enum RadioTunersKey {
+    Key_amTuner,
+    Key_fmTuner,
+    RadioTunersKeyCount
+};
+
+static const char * const pps_radioTunersKeys[RadioTunersKeyCount] = {
+    pps_amTunerKey,
+    pps_fmTunerKey
+};
+
+static const QPps::KeyTable s_radioTunersKeys(pps_radioTunersKeys, RadioTunersKeyCount);
+
+void Radio::Private::ppsTunersAttributeChanged(int key, const QString &, const QPps::Variant &attribute)
 {
-    if (name == QString::fromLatin1(pps_amTunerKey)) {
+    switch (s_radioTunersKeys.indexOf(key)) {
+    case Key_amTuner:
         m_amTuner = attribute.toJson().toVariant().toMap();
-    } else if (name == QString::fromLatin1(pps_fmTunerKey)) {
+        break;
+    case Key_fmTuner:
         m_fmTuner = attribute.toJson().toVariant().toMap();
+        break;
+    default:
+        break;
     }
 }
 
@@ -326,6 +392,7 @@ void Radio::setTuner(Tuner tuner)
         qWarning() << "Radio: unable to write back: tuner";
         return;
     }
+    d->m_ppsControlObject->flush();
 
     d->m_tuner = tuner;
     emit tunerChanged(d->m_tuner);
@@ -375,6 +442,7 @@ void Radio::setAudios(bool audios)
         }
          d->m_IsAudioOn = false;
     }
+    d->m_ppsControlObject->flush();
 }
 
 double Radio::station() const
@@ -475,7 +543,10 @@ void Radio::Private::programmaticSeekUp()
     if (m_simulationModeEnabled)
         simulateSeek(true);
     else
+    {
         m_ppsControlObject->setAttribute(QStringLiteral("seek"), QPps::Variant(QStringLiteral("up")));
+        m_ppsControlObject->flush();
+    }
 }
 
 void Radio::seekUp()
@@ -492,7 +563,10 @@ void Radio::Private::programmaticSeekDown()
     if (m_simulationModeEnabled)
         simulateSeek(false);
     else
+    {
         m_ppsControlObject->setAttribute(QStringLiteral("seek"), QPps::Variant(QStringLiteral("down")));
+        m_ppsControlObject->flush();
+    }
 }
 
 void Radio::seekDown()
@@ -507,6 +581,7 @@ void Radio::stopSeek()
     d->stopSeeking();
 
     d->m_ppsControlObject->setAttribute(QStringLiteral("seek"), QPps::Variant(QStringLiteral("stop")));
+    d->m_ppsControlObject->flush();
 }
 
 void Radio::scanUp()
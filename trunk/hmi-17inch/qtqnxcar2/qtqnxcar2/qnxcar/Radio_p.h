@@ -52,8 +52,8 @@ public:
     void programmaticSeekDown();
 
 private Q_SLOTS:
-    void ppsStatusAttributeChanged(const QString &name, const QPps::Variant &attribute);
-    void ppsTunersAttributeChanged(const QString &name, const QPps::Variant &attribute);
+    void ppsStatusAttributeChanged(int key, const QString &name, const QPps::Variant &attribute);
+    void ppsTunersAttributeChanged(int key, const QString &name, const QPps::Variant &attribute);
     void scan();
 };
 
@@ -1,6 +1,8 @@
 #include "SeatControl.h"
 #include "SeatControl_p.h"
 
+#include <qpps/key.h>
+
 #include <stdio.h>
 #include <fcntl.h>
 #include <iostream>
@@ -111,9 +113,12 @@ SeatControl::Private::Private(SeatControl *qq)
     m_ppsObject = new QPps::Object(QStringLiteral("/pps/hinge-tech/seatcontrol"), QPps::Object::PublishAndSubscribeMode, true, this);
 
     if (m_ppsObject->isValid()) {
-        connect(m_ppsObject, SIGNAL(attributeChanged(QString,QPps::Variant)),
-                this, SLOT(ppsAttributeChanged(QString,QPps::Variant)));
+        connect(m_ppsObject, SIGNAL(attributeKeyChanged(int,QString,QPps::Variant)),
+                this, SLOT(ppsAttributeChanged(int,QString,QPps::Variant)));
         m_ppsObject->setAttributeCacheEnabled(true);
+        // the seat sliders write on every move, merge them into one write per frame
+        m_ppsObject->setWriteBehindInterval(16);
+        m_ppsObject->setWriteBehindEnabled(true);
 
         m_main_heatingstatus = m_ppsObject->attribute(QString::fromLatin1(pps_main_heatingstatusKey)).toInt();
         m_main_height_movement = m_ppsObject->attribute(QString::fromLatin1(pps_main_height_movementKey)).toInt();
@@ -168,233 +173,356 @@ SeatControl::Private::Private(SeatControl *qq)
     }
 }
 
-void SeatControl::Private::ppsAttributeChanged(const QString &name, const QPps::Variant &attribute)
-{
-    if (name == QString::fromLatin1(pps_main_heatingstatusKey)) {
+enum SeatControlKey {
+    Key_main_heatingstatus,
+    Key_main_height_movement,
+    Key_main_lumbar_adjustment,
+    Key_main_recliner_movement,
+    Key_main_slide_movement,
+    Key_main_tilt_movement,
+    Key_copilot_heatingstatus,
+    Key_copilot_height_movement,
+    Key_copilot_lumbar_adjustment,
+    Key_copilot_recliner_movement,
+    Key_copilot_slide_movement,
+    Key_copilot_tilt_movement,
+    Key_main_massage_state,
+    Key_main_ventilation_state,
+    Key_copilot_massage_state,
+    Key_copilot_ventilation_state,
+    Key_main_massage_level,
+    Key_main_ventilation_level,
+    Key_copilot_massage_level,
+    Key_copilot_ventilation_level,
+    Key_watch_type,
+    Key_main_store_recall_position_cmd,
+    Key_copilot_store_recall_position_cmd,
+    Key_main_slider_movement_status,
+    Key_main_recliner_movement_status,
+    Key_copilot_tilt_movement_status,
+    Key_main_height_movement_status,
+    Key_main_lumbar_movement_status,
+    Key_main_slider_position,
+    Key_main_recliner_position,
+    Key_main_tilt_position,
+    Key_main_height_position,
+    Key_main_ventilation_status,
+    Key_copilot_slider_movement_status,
+    Key_copilot_recliner_movement_status,
+    Key_copilot_height_movement_status,
+    Key_copilot_lumbar_movement_status,
+    Key_copilot_slider_position,
+    Key_copilot_recliner_position,
+    Key_copilot_tilt_position,
+    Key_copilot_height_position,
+    Key_copilot_ventilation_status,
+    SeatControlKeyCount
+};
+
+static const char * const pps_seatControlKeys[SeatControlKeyCount] = {
+    pps_main_heatingstatusKey,
+    pps_main_height_movementKey,
+    pps_main_lumbar_adjustmentKey,
+    pps_main_recliner_movementKey,
+    pps_main_slide_movementKey,
+    pps_main_tilt_movementKey,
+    pps_copilot_heatingstatusKey,
+    pps_copilot_height_movementKey,
+    pps_copilot_lumbar_adjustmentKey,
+    pps_copilot_recliner_movementKey,
+    pps_copilot_slide_movementKey,
+    pps_copilot_tilt_movementKey,
+    pps_main_massage_stateKey,
+    pps_main_ventilation_stateKey,
+    pps_copilot_massage_stateKey,
+    pps_copilot_ventilation_stateKey,
+    pps_main_massage_levelKey,
+    pps_main_ventilation_levelKey,
+    pps_copilot_massage_levelKey,
+    pps_copilot_ventilation_levelKey,
+    pps_watch_typeKey,
+    pps_main_store_recall_position_cmdKey,
+    pps_copilot_store_recall_position_cmdKey,
+    pps_main_slider_movement_statusKey,
+    pps_main_recliner_movement_statusKey,
+    pps_copilot_tilt_movement_statusKey,
+    pps_main_height_movement_statusKey,
+    pps_main_lumbar_movement_statusKey,
+    pps_main_slider_positionKey,
+    pps_main_recliner_positionKey,
+    pps_main_tilt_positionKey,
+    pps_main_height_positionKey,
+    pps_main_ventilation_statusKey,
+    pps_copilot_slider_movement_statusKey,
+    pps_copilot_recliner_movement_statusKey,
+    pps_copilot_height_movement_statusKey,
+    pps_copilot_lumbar_movement_statusKey,
+    pps_copilot_slider_positionKey,
+    pps_copilot_recliner_positionKey,
+    pps_copilot_tilt_positionKey,
+    pps_copilot_height_positionKey,
+    pps_copilot_ventilation_statusKey
+};
+
+static const QPps::KeyTable s_seatControlKeys(pps_seatControlKeys, SeatControlKeyCount);
+
+void SeatControl::Private::ppsAttributeChanged(int key, const QString &, const QPps::Variant &attribute)
+{
+    switch (s_seatControlKeys.indexOf(key)) {
+    case Key_main_heatingstatus:
         if (m_main_heatingstatus != attribute.toInt()) {
             m_main_heatingstatus = attribute.toInt();
             emit q->main_heatingstatusChanged(m_main_heatingstatus);
         }
-    } else if (name == QString::fromLatin1(pps_main_height_movementKey)) {
+        break;
+    case Key_main_height_movement:
         if (m_main_height_movement != attribute.toInt()) {
             m_main_height_movement = attribute.toInt();
             emit q->main_height_movementChanged(m_main_height_movement);
         }
-    } else if (name == QString::fromLatin1(pps_main_lumbar_adjustmentKey)) {
+        break;
+    case Key_main_lumbar_adjustment:
         if (m_main_lumbar_adjustment != attribute.toInt()) {
             m_main_lumbar_adjustment = attribute.toInt();
             emit q->main_lumbar_adjustmentChanged(m_main_lumbar_adjustment);
         }
-    } else if (name == QString::fromLatin1(pps_main_recliner_movementKey)) {
+        break;
+    case Key_main_recliner_movement:
         if (m_main_recliner_movement != attribute.toInt()) {
             m_main_recliner_movement = attribute.toInt();
             emit q->main_recliner_movementChanged(m_main_recliner_movement);
         }
-    } else if (name == QString::fromLatin1(pps_main_slide_movementKey)) {
+        break;
+    case Key_main_slide_movement:
         if (m_main_slide_movement != attribute.toInt()) {
             m_main_slide_movement = attribute.toInt();
             emit q->main_slide_movementChanged(m_main_slide_movement);
         }
-    } else if (name == QString::fromLatin1(pps_main_tilt_movementKey)) {
+        break;
+    case Key_main_tilt_movement:
         if (m_main_tilt_movement != attribute.toInt()) {
             m_main_tilt_movement = attribute.toInt();
             emit q->main_tilt_movementChanged(m_main_tilt_movement);
         }
-    } else if (name == QString::fromLatin1(pps_copilot_heatingstatusKey)) {
+        break;
+    case Key_copilot_heatingstatus:
         if (m_copilot_heatingstatus != attribute.toInt()) {
             m_copilot_heatingstatus = attribute.toInt();
             emit q->copilot_heatingstatusChanged(m_copilot_heatingstatus);
         }
-    } else if (name == QString::fromLatin1(pps_copilot_height_movementKey)) {
+        break;
+    case Key_copilot_height_movement:
         if (m_copilot_height_movement != attribute.toInt()) {
             m_copilot_height_movement = attribute.toInt();
             emit q->copilot_height_movementChanged(m_copilot_height_movement);
         }
-    } else if (name == QString::fromLatin1(pps_copilot_lumbar_adjustmentKey)) {
+        break;
+    case Key_copilot_lumbar_adjustment:
         if (m_copilot_lumbar_adjustment != attribute.toInt()) {
             m_copilot_lumbar_adjustment = attribute.toInt();
             emit q->copilot_lumbar_adjustmentChanged(m_copilot_lumbar_adjustment);
         }
-    } else if (name == QString::fromLatin1(pps_copilot_recliner_movementKey)) {
+        break;
+    case Key_copilot_recliner_movement:
         if (m_copilot_recliner_movement != attribute.toInt()) {
             m_copilot_recliner_movement = attribute.toInt();
             emit q->copilot_recliner_movementChanged(m_copilot_recliner_movement);
         }
-    } else if (name == QString::fromLatin1(pps_copilot_slide_movementKey)) {
+        break;
+    case Key_copilot_slide_movement:
         if (m_copilot_slide_movement != attribute.toInt()) {
             m_copilot_slide_movement = attribute.toInt();
             emit q->copilot_slide_movementChanged(m_copilot_slide_movement);
         }
-    } else if (name == QString::fromLatin1(pps_copilot_tilt_movementKey)) {
+        break;
+    case Key_copilot_tilt_movement:
         if (m_copilot_tilt_movement != attribute.toInt()) {
             m_copilot_tilt_movement = attribute.toInt();
             emit q->copilot_tilt_movementChanged(m_copilot_tilt_movement);
         }
-    } else if (name == QString::fromLatin1(pps_main_massage_stateKey)) {
+        break;
+    case Key_main_massage_state:
         if (m_main_massage_state != attribute.toInt()) {
             m_main_massage_state = attribute.toInt();
             emit q->main_massageStateChanged(m_main_massage_state);
         }
-    } else if (name == QString::fromLatin1(pps_main_ventilation_stateKey)) {
+        break;
+    case Key_main_ventilation_state:
         if (m_main_ventilation_state != attribute.toInt()) {
             m_main_ventilation_state = attribute.toInt();
             emit q->main_ventilationStateChanged(m_main_ventilation_state);
         }
-    } else if (name == QString::fromLatin1(pps_copilot_massage_stateKey)) {
+        break;
+    case Key_copilot_massage_state:
         if (m_copilot_massage_state != attribute.toInt()) {
             m_copilot_massage_state = attribute.toInt();
             emit q->copilot_massageStateChanged(m_copilot_massage_state);
         }
-    } else if (name == QString::fromLatin1(pps_copilot_ventilation_stateKey)) {
+        break;
+    case Key_copilot_ventilation_state:
         if (m_copilot_ventilation_state != attribute.toInt()) {
             m_copilot_ventilation_state = attribute.toInt();
             emit q->copilot_ventilationStateChanged(m_copilot_ventilation_state);
         }
-    } else if (name == QString::fromLatin1(pps_main_massage_levelKey)) {
+        break;
+    case Key_main_massage_level:
         if (m_main_massage_level != attribute.toInt()) {
             m_main_massage_level = attribute.toInt();
             emit q->main_massageLevelChanged(m_main_massage_level);
         }
-    } else if (name == QString::fromLatin1(pps_main_ventilation_levelKey)) {
+        break;
+    case Key_main_ventilation_level:
         if (m_main_ventilation_level != attribute.toInt()) {
             m_main_ventilation_level = attribute.toInt();
             emit q->main_ventilationLevelChanged(m_main_ventilation_level);
         }
-    } else if (name == QString::fromLatin1(pps_copilot_massage_levelKey)) {
+        break;
+    case Key_copilot_massage_level:
         if (m_copilot_massage_level != attribute.toInt()) {
             m_copilot_massage_level = attribute.toInt();
             emit q->copilot_massageLevelChanged(m_copilot_massage_level);
         }
-    } else if (name == QString::fromLatin1(pps_copilot_ventilation_levelKey)) {
+        break;
+    case Key_copilot_ventilation_level:
         if (m_copilot_ventilation_level != attribute.toInt()) {
             m_copilot_ventilation_level = attribute.toInt();
             emit q->copilot_ventilationLevelChanged(m_copilot_ventilation_level);
         }
-    } else if (name == QString::fromLatin1(pps_watch_typeKey)) {
+        break;
+    case Key_watch_type:
         if (m_watch_type != attribute.toString()) {
             m_watch_type = attribute.toString();
             emit q->watchTypeChanged(m_watch_type);
         }
-    } else if (name == QString::fromLatin1(pps_main_store_recall_position_cmdKey)) {
+        break;
+    case Key_main_store_recall_position_cmd:
         if (m_main_store_recall_position_cmd != attribute.toInt()) {
             m_main_store_recall_position_cmd = attribute.toInt();
             emit q->mainStoreRecallCmdChanged(m_main_store_recall_position_cmd);
         }
-    } else if (name == QString::fromLatin1(pps_copilot_store_recall_position_cmdKey)) {
+        break;
+    case Key_copilot_store_recall_position_cmd:
         if (m_copilot_store_recall_position_cmd != attribute.toInt()) {
             m_copilot_store_recall_position_cmd = attribute.toInt();
             emit q->copilotStoreRecallCmdChanged(m_copilot_store_recall_position_cmd);
         }
-    } else if (name == QString::fromLatin1(pps_main_slider_movement_statusKey)) {
+        break;
+    case Key_main_slider_movement_status:
         if (m_main_slider_movement_status != attribute.toInt()) {
             m_main_slider_movement_status = attribute.toInt();
             emit q->main_slider_movement_statusChanged(m_main_slider_movement_status);
         }
-    } else if (name == QString::fromLatin1(pps_main_recliner_movement_statusKey)) {
+        break;
+    case Key_main_recliner_movement_status:
         if (m_main_recliner_movement_status != attribute.toInt()) {
             m_main_recliner_movement_status = attribute.toInt();
             emit q->copilotStoreRecallCmdChanged(m_main_recliner_movement_status);
         }
-    } else if (name == QString::fromLatin1(pps_copilot_tilt_movement_statusKey)) {
+        break;
+    case Key_copilot_tilt_movement_status:
         if (m_main_tilt_movement_status != attribute.toInt()) {
             m_main_tilt_movement_status = attribute.toInt();
             emit q->main_tilt_movement_statusChanged(m_main_tilt_movement_status);
         }
-    } else if (name == QString::fromLatin1(pps_main_height_movement_statusKey)) {
+        break;
+    case Key_main_height_movement_status:
         if (m_main_height_movement_status != attribute.toInt()) {
             m_main_height_movement_status = attribute.toInt();
             emit q->main_height_movement_statusChanged(m_main_height_movement_status);
         }
-    } else if (name == QString::fromLatin1(pps_main_lumbar_movement_statusKey)) {
+        break;
+    case Key_main_lumbar_movement_status:
         if (m_main_lumbar_movement_status != attribute.toInt()) {
             m_main_lumbar_movement_status = attribute.toInt();
             emit q->main_lumbar_movement_statusChanged(m_main_lumbar_movement_status);
         }
-    } else if (name == QString::fromLatin1(pps_main_slider_positionKey)) {
+        break;
+    case Key_main_slider_position:
         if (m_main_slider_position != attribute.toInt()) {
             m_main_slider_position = attribute.toInt();
             emit q->main_slider_movement_statusChanged(m_main_slider_position);
         }
-    } else if (name == QString::fromLatin1(pps_main_recliner_positionKey)) {
+        break;
+    case Key_main_recliner_position:
         if (m_main_recliner_position != attribute.toInt()) {
             m_main_recliner_position = attribute.toInt();
             emit q->main_recliner_positionChanged(m_main_recliner_position);
         }
-    } else if (name == QString::fromLatin1(pps_main_tilt_positionKey)) {
+        break;
+    case Key_main_tilt_position:
         if (m_main_tilt_position != attribute.toInt()) {
             m_main_tilt_position = attribute.toInt();
             emit q->main_tilt_positionChanged(m_main_tilt_position);
         }
-    } else if (name == QString::fromLatin1(pps_main_height_positionKey)) {
+        break;
+    case Key_main_height_position:
         if (m_main_height_position != attribute.toInt()) {
             m_main_height_position = attribute.toInt();
             emit q->main_height_positionChanged(m_main_height_position);
         }
-    } else if (name == QString::fromLatin1(pps_main_heatingstatusKey)) {
-        if (m_main_heatingstatus != attribute.toInt()) {
-            m_main_heatingstatus = attribute.toInt();
-            emit q->main_heating_statusChanged(m_main_heatingstatus);
-        }
-    } else if (name == QString::fromLatin1(pps_main_ventilation_statusKey)) {
+        break;
+    case Key_main_ventilation_status:
         if (m_main_ventilation_status != attribute.toInt()) {
             m_main_ventilation_status = attribute.toInt();
             emit q->main_ventilation_statusChanged(m_main_ventilation_status);
         }
-    } else if (name == QString::fromLatin1(pps_copilot_slider_movement_statusKey)) {
+        break;
+    case Key_copilot_slider_movement_status:
         if (m_copilot_slider_movement_status != attribute.toInt()) {
             m_copilot_slider_movement_status = attribute.toInt();
             emit q->copilot_slider_movement_statusChanged(m_copilot_slider_movement_status);
         }
-    } else if (name == QString::fromLatin1(pps_copilot_recliner_movement_statusKey)) {
+        break;
+    case Key_copilot_recliner_movement_status:
         if (m_copilot_recliner_movement_status != attribute.toInt()) {
             m_copilot_recliner_movement_status = attribute.toInt();
             emit q->copilotStoreRecallCmdChanged(m_copilot_recliner_movement_status);
         }
-    } else if (name == QString::fromLatin1(pps_copilot_tilt_movement_statusKey)) {
-        if (m_copilot_tilt_movement_status != attribute.toInt()) {
-            m_copilot_tilt_movement_status = attribute.toInt();
-            emit q->copilot_tilt_movement_statusChanged(m_copilot_tilt_movement_status);
-        }
-    } else if (name == QString::fromLatin1(pps_copilot_height_movement_statusKey)) {
+        break;
+    case Key_copilot_height_movement_status:
         if (m_copilot_height_movement_status != attribute.toInt()) {
             m_copilot_height_movement_status = attribute.toInt();
             emit q->copilot_height_movement_statusChanged(m_copilot_height_movement_status);
         }
-    } else if (name == QString::fromLatin1(pps_copilot_lumbar_movement_statusKey)) {
+        break;
+    case Key_copilot_lumbar_movement_status:
         if (m_copilot_lumbar_movement_status != attribute.toInt()) {
             m_copilot_lumbar_movement_status = attribute.toInt();
             emit q->copilot_lumbar_movement_statusChanged(m_copilot_lumbar_movement_status);
         }
-    } else if (name == QString::fromLatin1(pps_copilot_slider_positionKey)) {
+        break;
+    case Key_copilot_slider_position:
         if (m_copilot_slider_position != attribute.toInt()) {
             m_copilot_slider_position = attribute.toInt();
             emit q->copilot_slider_movement_statusChanged(m_copilot_slider_position);
         }
-    } else if (name == QString::fromLatin1(pps_copilot_recliner_positionKey)) {
+        break;
+    case Key_copilot_recliner_position:
         if (m_copilot_recliner_position != attribute.toInt()) {
             m_copilot_recliner_position = attribute.toInt();
             emit q->copilot_recliner_positionChanged(m_copilot_recliner_position);
         }
-    } else if (name == QString::fromLatin1(pps_copilot_tilt_positionKey)) {
+        break;
+    case Key_copilot_tilt_position:
         if (m_copilot_tilt_position != attribute.toInt()) {
             m_copilot_tilt_position = attribute.toInt();
             emit q->copilot_tilt_positionChanged(m_copilot_tilt_position);
         }
-    } else if (name == QString::fromLatin1(pps_copilot_height_positionKey)) {
+        break;
+    case Key_copilot_height_position:
         if (m_copilot_height_position != attribute.toInt()) {
             m_copilot_height_position = attribute.toInt();
             emit q->copilot_height_positionChanged(m_copilot_height_position);
         }
-    } else if (name == QString::fromLatin1(pps_copilot_heatingstatusKey)) {
-        if (m_copilot_heatingstatus != attribute.toInt()) {
-            m_copilot_heatingstatus = attribute.toInt();
-            emit q->copilot_heating_statusChanged(m_copilot_heatingstatus);
-        }
-    } else if (name == QString::fromLatin1(pps_copilot_ventilation_statusKey)) {
+        break;
+    case Key_copilot_ventilation_status:
         if (m_copilot_ventilation_status != attribute.toInt()) {
             m_copilot_ventilation_status = attribute.toInt();
             emit q->copilot_ventilation_statusChanged(m_copilot_ventilation_status);
         }
+        break;
+    default:
+        break;
     }
 }
 
@@ -818,6 +946,9 @@ void SeatControl::setMainStoreRecallCmd(int mainStoreRecallCmd)
         return;
     }
 
+    // store/recall is a command, don't let it wait for the next slider write
+    d->m_ppsObject->flush();
+
     d->m_main_store_recall_position_cmd = mainStoreRecallCmd;
     emit mainStoreRecallCmdChanged(d->m_main_store_recall_position_cmd);
 }
@@ -838,6 +969,9 @@ void SeatControl::setCopilotStoreRecallCmd(int copilotStoreRecallCmd)
         return;
     }
 
+    // store/recall is a command, don't let it wait for the next slider write
+    d->m_ppsObject->flush();
+
     d->m_copilot_store_recall_position_cmd = copilotStoreRecallCmd;
     emit copilotStoreRecallCmdChanged(d->m_copilot_store_recall_position_cmd);
 }
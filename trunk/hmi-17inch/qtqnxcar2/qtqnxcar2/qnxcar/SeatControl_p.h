@@ -69,7 +69,7 @@ public:
     int m_copilot_ventilation_status;
 
 private Q_SLOTS:
-    void ppsAttributeChanged(const QString &name, const QPps::Variant &attribute);
+    void ppsAttributeChanged(int key, const QString &name, const QPps::Variant &attribute);
 };
 
 }
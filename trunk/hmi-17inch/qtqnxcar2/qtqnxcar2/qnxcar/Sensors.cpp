@@ -1,6 +1,8 @@
 #include "Sensors.h"
 #include "Sensors_p.h"
 
+#include <qpps/key.h>
+
 #include <QDebug>
 
 namespace QnxCar {
@@ -50,10 +52,16 @@ Sensors::Private::Private(Sensors *qq)
                                    QPps::Object::PublishAndSubscribeMode, true, this);
 
     if (m_ppsObject->isValid()) {
-        connect(m_ppsObject, SIGNAL(attributeChanged(QString,QPps::Variant)),
-                this, SLOT(ppsAttributeChanged(QString,QPps::Variant)));
+        connect(m_ppsObject, SIGNAL(attributeKeyChanged(int,QString,QPps::Variant)),
+                this, SLOT(ppsAttributeChanged(int,QString,QPps::Variant)));
         m_ppsObject->setAttributeCacheEnabled(true);
 
+        // sensor values change faster than the display can show them, deliver at most one
+        // value per attribute and frame, and skip changes that would not be visible anyway
+        m_ppsObject->setUpdateCoalescingEnabled(true);
+        m_ppsObject->setUpdateDeadband(QString::fromLatin1(pps_engineRpmKey), 10);
+        m_ppsObject->setUpdateDeadband(QString::fromLatin1(pps_speedKey), 0.5);
+
         m_brakeAbs = m_ppsObject->attribute(QString::fromLatin1(pps_brakeAbsKey)).toBool();
         m_laneDeparture = m_ppsObject->attribute(QString::fromLatin1(pps_laneDepartureKey)).toInt();
     } else {
@@ -61,83 +69,198 @@ Sensors::Private::Private(Sensors *qq)
     }
 }
 
-void Sensors::Private::ppsAttributeChanged(const QString &name, const QPps::Variant &attribute)
-{
-    if (name == QString::fromLatin1(pps_brakeFluidLevelKey)) {
+enum SensorsKey {
+    Key_brakeFluidLevel,
+    Key_brakeAbs,
+    Key_brakeAbsFrontLeft,
+    Key_brakeAbsFrontRight,
+    Key_brakeAbsRearLeft,
+    Key_brakeAbsRearRight,
+    Key_brakeWearFrontLeft,
+    Key_brakeWearFrontRight,
+    Key_brakeWearRearLeft,
+    Key_brakeWearRearRight,
+    Key_engineCoolantLevel,
+    Key_engineOilLevel,
+    Key_engineOilPressure,
+    Key_engineRpm,
+    Key_fuelLevel,
+    Key_lightHeadFrontLeft,
+    Key_lightHeadFrontRight,
+    Key_lightTailRearLeft,
+    Key_lightTailRearRight,
+    Key_speed,
+    Key_tirePressureFrontLeft,
+    Key_tirePressureFrontRight,
+    Key_tirePressureRearLeft,
+    Key_tirePressureRearRight,
+    Key_tireWearFrontLeft,
+    Key_tireWearFrontRight,
+    Key_tireWearRearLeft,
+    Key_tireWearRearRight,
+    Key_transmissionFluidLevel,
+    Key_transmissionClutchWear,
+    Key_transmissionGear,
+    Key_transmissionTemperature,
+    Key_washerFluidLevel,
+    Key_laneDeparture,
+    SensorsKeyCount
+};
+
+static const char * const pps_sensorsKeys[SensorsKeyCount] = {
+    pps_brakeFluidLevelKey,
+    pps_brakeAbsKey,
+    pps_brakeAbsFrontLeftKey,
+    pps_brakeAbsFrontRightKey,
+    pps_brakeAbsRearLeftKey,
+    pps_brakeAbsRearRightKey,
+    pps_brakeWearFrontLeftKey,
+    pps_brakeWearFrontRightKey,
+    pps_brakeWearRearLeftKey,
+    pps_brakeWearRearRightKey,
+    pps_engineCoolantLevelKey,
+    pps_engineOilLevelKey,
+    pps_engineOilPressureKey,
+    pps_engineRpmKey,
+    pps_fuelLevelKey,
+    pps_lightHeadFrontLeftKey,
+    pps_lightHeadFrontRightKey,
+    pps_lightTailRearLeftKey,
+    pps_lightTailRearRightKey,
+    pps_speedKey,
+    pps_tirePressureFrontLeftKey,
+    pps_tirePressureFrontRightKey,
+    pps_tirePressureRearLeftKey,
+    pps_tirePressureRearRightKey,
+    pps_tireWearFrontLeftKey,
+    pps_tireWearFrontRightKey,
+    pps_tireWearRearLeftKey,
+    pps_tireWearRearRightKey,
+    pps_transmissionFluidLevelKey,
+    pps_transmissionClutchWearKey,
+    pps_transmissionGearKey,
+    pps_transmissionTemperatureKey,
+    pps_washerFluidLevelKey,
+    pps_laneDepartureKey
+};
+
+static const QPps::KeyTable s_sensorsKeys(pps_sensorsKeys, SensorsKeyCount);
+
+void Sensors::Private::ppsAttributeChanged(int key, const QString &, const QPps::Variant &attribute)
+{
+    switch (s_sensorsKeys.indexOf(key)) {
+    case Key_brakeFluidLevel:
         emit q->brakeFluidLevelChanged(attribute.toInt());
-    } else if (name == QString::fromLatin1(pps_brakeAbsKey)) {
+        break;
+    case Key_brakeAbs: {
         const bool brakeAbs = attribute.toBool();
         if (m_brakeAbs != brakeAbs) {
             m_brakeAbs = brakeAbs;
             emit q->brakeAbsChanged(m_brakeAbs);
         }
-    } else if (name == QString::fromLatin1(pps_brakeAbsFrontLeftKey)) {
+        break;
+    }
+    case Key_brakeAbsFrontLeft:
         emit q->brakeAbsFrontLeftChanged(attribute.toBool());
-    } else if (name == QString::fromLatin1(pps_brakeAbsFrontRightKey)) {
+        break;
+    case Key_brakeAbsFrontRight:
         emit q->brakeAbsFrontRightChanged(attribute.toBool());
-    } else if (name == QString::fromLatin1(pps_brakeAbsRearLeftKey)) {
+        break;
+    case Key_brakeAbsRearLeft:
         emit q->brakeAbsRearLeftChanged(attribute.toBool());
-    } else if (name == QString::fromLatin1(pps_brakeAbsRearRightKey)) {
+        break;
+    case Key_brakeAbsRearRight:
         emit q->brakeAbsRearRightChanged(attribute.toBool());
-    } else if (name == QString::fromLatin1(pps_brakeWearFrontLeftKey)) {
+        break;
+    case Key_brakeWearFrontLeft:
         emit q->brakeWearFrontLeftChanged(attribute.toInt());
-    } else if (name == QString::fromLatin1(pps_brakeWearFrontRightKey)) {
+        break;
+    case Key_brakeWearFrontRight:
         emit q->brakeWearFrontRightChanged(attribute.toInt());
-    } else if (name == QString::fromLatin1(pps_brakeWearRearLeftKey)) {
+        break;
+    case Key_brakeWearRearLeft:
         emit q->brakeWearRearLeftChanged(attribute.toInt());
-    } else if (name == QString::fromLatin1(pps_brakeWearRearRightKey)) {
+        break;
+    case Key_brakeWearRearRight:
         emit q->brakeWearRearRightChanged(attribute.toInt());
-    } else if (name == QString::fromLatin1(pps_engineCoolantLevelKey)) {
+        break;
+    case Key_engineCoolantLevel:
         emit q->engineCoolantLevelChanged(attribute.toInt());
-    } else if (name == QString::fromLatin1(pps_engineOilLevelKey)) {
+        break;
+    case Key_engineOilLevel:
         emit q->engineOilLevelChanged(attribute.toInt());
-    } else if (name == QString::fromLatin1(pps_engineOilPressureKey)) {
+        break;
+    case Key_engineOilPressure:
         emit q->engineOilPressureChanged(attribute.toInt());
-    } else if (name == QString::fromLatin1(pps_engineRpmKey)) {
+        break;
+    case Key_engineRpm:
         emit q->engineRpmChanged(attribute.toInt());
-    } else if (name == QString::fromLatin1(pps_fuelLevelKey)) {
+        break;
+    case Key_fuelLevel:
         emit q->fuelLevelChanged(attribute.toInt());
-    } else if (name == QString::fromLatin1(pps_lightHeadFrontLeftKey)) {
+        break;
+    case Key_lightHeadFrontLeft:
         emit q->lightHeadFrontLeftChanged(attribute.toBool());
-    } else if (name == QString::fromLatin1(pps_lightHeadFrontRightKey)) {
+        break;
+    case Key_lightHeadFrontRight:
         emit q->lightHeadFrontRightChanged(attribute.toBool());
-    } else if (name == QString::fromLatin1(pps_lightTailRearLeftKey)) {
+        break;
+    case Key_lightTailRearLeft:
         emit q->lightTailRearLeftChanged(attribute.toBool());
-    } else if (name == QString::fromLatin1(pps_lightTailRearRightKey)) {
+        break;
+    case Key_lightTailRearRight:
         emit q->lightTailRearRightChanged(attribute.toBool());
-    } else if (name == QString::fromLatin1(pps_speedKey)) {
+        break;
+    case Key_speed:
         emit q->speedChanged(attribute.toInt());
-    } else if (name == QString::fromLatin1(pps_tirePressureFrontLeftKey)) {
+        break;
+    case Key_tirePressureFrontLeft:
         emit q->tirePressureFrontLeftChanged(attribute.toInt());
-    } else if (name == QString::fromLatin1(pps_tirePressureFrontRightKey)) {
+        break;
+    case Key_tirePressureFrontRight:
         emit q->tirePressureFrontRightChanged(attribute.toInt());
-    } else if (name == QString::fromLatin1(pps_tirePressureRearLeftKey)) {
+        break;
+    case Key_tirePressureRearLeft:
         emit q->tirePressureRearLeftChanged(attribute.toInt());
-    } else if (name == QString::fromLatin1(pps_tirePressureRearRightKey)) {
+        break;
+    case Key_tirePressureRearRight:
         emit q->tirePressureRearRightChanged(attribute.toInt());
-    } else if (name == QString::fromLatin1(pps_tireWearFrontLeftKey)) {
+        break;
+    case Key_tireWearFrontLeft:
         emit q->tireWearFrontLeftChanged(attribute.toInt());
-    } else if (name == QString::fromLatin1(pps_tireWearFrontRightKey)) {
+        break;
+    case Key_tireWearFrontRight:
         emit q->tireWearFrontRightChanged(attribute.toInt());
-    } else if (name == QString::fromLatin1(pps_tireWearRearLeftKey)) {
+        break;
+    case Key_tireWearRearLeft:
         emit q->tireWearRearLeftChanged(attribute.toInt());
-    } else if (name == QString::fromLatin1(pps_tireWearRearRightKey)) {
+        break;
+    case Key_tireWearRearRight:
         emit q->tireWearRearRightChanged(attribute.toInt());
-    } else if (name == QString::fromLatin1(pps_transmissionFluidLevelKey)) {
+        break;
+    case Key_transmissionFluidLevel:
         emit q->transmissionFluidLevelChanged(attribute.toInt());
-    } else if (name == QString::fromLatin1(pps_transmissionClutchWearKey)) {
+        break;
+    case Key_transmissionClutchWear:
         emit q->transmissionClutchWearChanged(attribute.toInt());
-    } else if (name == QString::fromLatin1(pps_transmissionGearKey)) {
+        break;
+    case Key_transmissionGear:
         emit q->transmissionGearChanged(attribute.toString());
-    } else if (name == QString::fromLatin1(pps_transmissionTemperatureKey)) {
+        break;
+    case Key_transmissionTemperature:
         emit q->transmissionTemperatureChanged(attribute.toInt());
-    } else if (name == QString::fromLatin1(pps_washerFluidLevelKey)) {
+        break;
+    case Key_washerFluidLevel:
         emit q->washerFluidLevelChanged(attribute.toInt());
-    } else if (name == QString::fromLatin1(pps_laneDepartureKey)) {
+        break;
+    case Key_laneDeparture:
         if (m_laneDeparture != attribute.toInt()) {
             m_laneDeparture = attribute.toInt();
             emit q->laneDepartureChanged(m_laneDeparture);
         }
+        break;
+    default:
+        break;
     }
 }
 
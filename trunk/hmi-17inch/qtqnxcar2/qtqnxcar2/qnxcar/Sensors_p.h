@@ -21,7 +21,7 @@ public:
     int m_laneDeparture;
 
 private Q_SLOTS:
-    void ppsAttributeChanged(const QString &name, const QPps::Variant &attribute);
+    void ppsAttributeChanged(int key, const QString &name, const QPps::Variant &attribute);
 };
 
 }
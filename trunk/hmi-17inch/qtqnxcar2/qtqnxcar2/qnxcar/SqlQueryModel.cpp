@@ -2,6 +2,8 @@
 
 #include "SqlQueryModel_p.h"
 
+#include "DatabaseManager.h"
+
 #include <QDebug>
 #include <QSqlError>
 
@@ -46,6 +48,10 @@ void SqlQueryModel::reopenDatabase()
 
 void SqlQueryModel::queryChange()
 {
+    // QSqlQueryModel::setQuery() replaces the rows of a submitted query
+    d->hasSnapshot = false;
+    d->snapshot = SqlResult();
+
     if (lastError().isValid())
         qWarning() << lastError();
 }
@@ -61,6 +67,19 @@ QHash<int,QByteArray> SqlQueryModel::roleNames() const
 
 QVariant SqlQueryModel::data(const QModelIndex &item, int role) const
 {
+    if (d->hasSnapshot) {
+        if (!item.isValid())
+            return QVariant();
+
+        if (role == Qt::DisplayRole || role == Qt::EditRole)
+            return d->snapshot.value(item.row(), item.column());
+
+        if (role > Qt::UserRole)
+            return d->snapshot.value(item.row(), role - Qt::UserRole - 1);
+
+        return QVariant();
+    }
+
     if (role < Qt::UserRole)
         return QSqlQueryModel::data(item, role);
 
@@ -69,7 +88,78 @@ QVariant SqlQueryModel::data(const QModelIndex &item, int role) const
     return QSqlQueryModel::data(modelIndex, Qt::DisplayRole);
 }
 
+int SqlQueryModel::rowCount(const QModelIndex &parent) const
+{
+    if (d->hasSnapshot)
+        return parent.isValid() ? 0 : d->snapshot.rowCount();
+
+    return QSqlQueryModel::rowCount(parent);
+}
+
+int SqlQueryModel::columnCount(const QModelIndex &parent) const
+{
+    if (d->hasSnapshot)
+        return parent.isValid() ? 0 : d->snapshot.columnCount();
+
+    return QSqlQueryModel::columnCount(parent);
+}
+
+bool SqlQueryModel::canFetchMore(const QModelIndex &parent) const
+{
+    // a snapshot holds all rows of its query
+    if (d->hasSnapshot)
+        return false;
+
+    return QSqlQueryModel::canFetchMore(parent);
+}
+
+void SqlQueryModel::clear()
+{
+    if (d->pendingQuery) {
+        d->pendingQuery->cancel();
+        d->pendingQuery->deleteLater();
+        d->pendingQuery = 0;
+    }
+
+    beginResetModel();
+    d->hasSnapshot = false;
+    d->snapshot = SqlResult();
+    QSqlQueryModel::clear();
+    endResetModel();
+}
+
 void SqlQueryModel::update()
 {
     runQuery();
 }
+
+void SqlQueryModel::submitQuery(const QString &sql, const QVariantList &values)
+{
+    // superseded, its rows are never shown
+    if (d->pendingQuery) {
+        d->pendingQuery->cancel();
+        d->pendingQuery->deleteLater();
+    }
+
+    d->pendingQuery = DatabaseManager::queryService()->read(d->db.databaseName(), sql, values, this);
+    connect(d->pendingQuery.data(), &SqlFuture::finished, this, &SqlQueryModel::submittedQueryFinished);
+}
+
+void SqlQueryModel::submittedQueryFinished()
+{
+    SqlFuture *future = qobject_cast<SqlFuture*>(sender());
+    if (!future || future != d->pendingQuery)
+        return;
+
+    const SqlResult result = future->result();
+    d->pendingQuery = 0;
+    future->deleteLater();
+
+    if (!result.isValid())
+        qWarning("%s: %s", Q_FUNC_INFO, qPrintable(result.errorString()));
+
+    beginResetModel();
+    d->snapshot = result;
+    d->hasSnapshot = true;
+    endResetModel();
+}
@@ -40,6 +40,18 @@ namespace QnxCar {
  * }
  * @endcode
  *
+ * Instead of running the query in runQuery() with QSqlQueryModel::setQuery(), subclasses can hand it
+ * to submitQuery(). The query then runs on a worker thread of DatabaseManager::queryService() and the
+ * model shows the returned rows once they arrive, so that the GUI thread never waits for SQLite.
+ *
+ * E.g.
+ * @code
+ * void FavouriteModel::runQuery()
+ * {
+ *     submitQuery(SQL_SELECT_FAVOURITE_LOCATIONS, QVariantList() << D_PTR->activeProfileId);
+ * }
+ * @endcode
+ *
  * @sa SqlTableModel
  */
 class QTQNXCAR2_EXPORT SqlQueryModel : public QSqlQueryModel
@@ -95,6 +107,15 @@ public:
      */
     QVariant data(const QModelIndex &item, int role) const Q_DECL_OVERRIDE;
 
+    int rowCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
+    bool canFetchMore(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
+
+    /**
+     * Clears the model, including rows returned by a submitted query
+     */
+    void clear() Q_DECL_OVERRIDE;
+
 public Q_SLOTS:
     /**
      * Updated the model contents by calling runQuery()
@@ -143,6 +164,16 @@ protected:
      */
     virtual void runQuery() = 0;
 
+    /**
+     * Runs @p sql with the positional @p values on a worker thread and shows the returned rows once
+     * they arrive. The rows shown so far stay until then. A query still running is superseded.
+     *
+     * @param sql the query, run on the database file of database()
+     * @param values the values bound to the placeholders of @p sql, in order
+     * @sa DatabaseManager::queryService()
+     */
+    void submitQuery(const QString &sql, const QVariantList &values = QVariantList());
+
     /**
      * Non-const accessor to the Private object
      */
@@ -159,6 +190,9 @@ protected:
         return static_cast<const T*>(d);
     }
 
+private Q_SLOTS:
+    void submittedQueryFinished();
+
 private:
     Private *const d;
 };
@@ -1,6 +1,10 @@
 #ifndef SQLQUERYMODEL_P_H
 #define SQLQUERYMODEL_P_H
 
+#include "SqlQueryService.h"
+
+#include <QPointer>
+
 namespace QnxCar {
 
 /**
@@ -15,10 +19,16 @@ class SqlQueryModel::Private
     friend class SqlQueryModel;
 
 public:
+    Private() : hasSnapshot(false) {}
     virtual ~Private() {}
 
 private:
     QSqlDatabase db;
+
+    /// Rows returned by submitQuery(), shown instead of the QSqlQuery if hasSnapshot is set
+    SqlResult snapshot;
+    bool hasSnapshot;
+    QPointer<SqlFuture> pendingQuery;
 };
 
 }
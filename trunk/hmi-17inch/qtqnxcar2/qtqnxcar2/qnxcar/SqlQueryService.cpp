@@ -0,0 +1,427 @@
+#include "SqlQueryService.h"
+
+#include "DatabaseManager.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QQueue>
+#include <QSharedPointer>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QSqlRecord>
+#include <QThread>
+#include <QWaitCondition>
+
+#include <climits>
+
+namespace QnxCar {
+
+static const QString DEFAULT_DATABASE_TYPE = QStringLiteral("QSQLITE");
+
+/// Prepared statements kept per thread before they are all dropped
+static const int MaximumCachedStatements = 64;
+
+/**
+ * What a request and its future share across threads
+ */
+struct SqlFutureState
+{
+    SqlFutureState()
+        : future(0)
+        , done(false)
+        , cancelled(false)
+    {}
+
+    QMutex mutex;
+    QWaitCondition doneCondition;
+    /// 0 once the future is deleted, which happens in its own thread under the mutex
+    SqlFuture *future;
+    SqlRequest request;
+    SqlResult result;
+    /// Executed or dropped
+    bool done;
+    bool cancelled;
+};
+
+typedef QSharedPointer<SqlFutureState> Job;
+
+SqlRequest::SqlRequest()
+    : m_access(Read)
+{
+}
+
+SqlRequest::SqlRequest(const QString &databaseName, const QString &sql, const QVariantList &values, Access access)
+    : m_databaseName(databaseName)
+    , m_sql(sql)
+    , m_values(values)
+    , m_access(access)
+{
+}
+
+QString SqlRequest::databaseName() const
+{
+    return m_databaseName;
+}
+
+QString SqlRequest::sql() const
+{
+    return m_sql;
+}
+
+QVariantList SqlRequest::values() const
+{
+    return m_values;
+}
+
+SqlRequest::Access SqlRequest::access() const
+{
+    return m_access;
+}
+
+class SqlFuture::Private
+{
+public:
+    explicit Private(const Job &state)
+        : state(state)
+        , delivered(false)
+    {}
+
+    Job state;
+    SqlResult result;
+    bool delivered;
+};
+
+SqlFuture::SqlFuture(Private *d, QObject *parent)
+    : QObject(parent)
+    , d(d)
+{
+    QMutexLocker locker(&d->state->mutex);
+    d->state->future = this;
+}
+
+SqlFuture::~SqlFuture()
+{
+    {
+        QMutexLocker locker(&d->state->mutex);
+        d->state->future = 0;
+        d->state->cancelled = true;
+    }
+
+    delete d;
+}
+
+SqlRequest SqlFuture::request() const
+{
+    return d->state->request;
+}
+
+bool SqlFuture::isFinished() const
+{
+    return d->delivered;
+}
+
+SqlResult SqlFuture::result() const
+{
+    return d->result;
+}
+
+void SqlFuture::cancel()
+{
+    QMutexLocker locker(&d->state->mutex);
+    d->state->cancelled = true;
+}
+
+bool SqlFuture::isCancelled() const
+{
+    QMutexLocker locker(&d->state->mutex);
+    return d->state->cancelled;
+}
+
+bool SqlFuture::waitForFinished(int msecs)
+{
+    {
+        QMutexLocker locker(&d->state->mutex);
+        while (!d->state->done) {
+            if (!d->state->doneCondition.wait(&d->state->mutex, msecs < 0 ? ULONG_MAX : msecs))
+                return false;
+        }
+    }
+
+    deliver();
+    return d->delivered;
+}
+
+void SqlFuture::deliver()
+{
+    if (d->delivered)
+        return;
+
+    {
+        QMutexLocker locker(&d->state->mutex);
+        if (!d->state->done || d->state->cancelled)
+            return;
+
+        d->result = d->state->result;
+    }
+
+    d->delivered = true;
+    emit finished();
+}
+
+class SqlQueryService::Private
+{
+public:
+    class Lane;
+
+    Private()
+        : stopping(false)
+    {
+        lanes[SqlRequest::Read] = 0;
+        lanes[SqlRequest::Write] = 0;
+    }
+
+    Job takeJob(SqlRequest::Access access);
+    void finishJob(const Job &job, const SqlResult &result);
+
+    QMutex mutex;
+    QWaitCondition jobsAvailable;
+    bool stopping;
+    QString connectionPrefix;
+
+    QQueue<Job> pending[2];
+    Lane *lanes[2];
+};
+
+/**
+ * A thread running the requests of one access type on connections of its own
+ */
+class SqlQueryService::Private::Lane : public QThread
+{
+public:
+    Lane(Private *service, SqlRequest::Access access)
+        : m_service(service)
+        , m_access(access)
+    {
+        setObjectName(access == SqlRequest::Read ? QLatin1String("SqlReadThread") : QLatin1String("SqlWriteThread"));
+        m_connectionPrefix = service->connectionPrefix
+                + (access == SqlRequest::Read ? QLatin1String("read-") : QLatin1String("write-"));
+    }
+
+protected:
+    void run() Q_DECL_OVERRIDE
+    {
+        while (const Job job = m_service->takeJob(m_access))
+            m_service->finishJob(job, execute(job->request));
+
+        // connections can only be removed from the thread using them
+        m_statements.clear();
+        const QStringList connectionNames = m_connections.keys();
+        m_connections.clear();
+        Q_FOREACH (const QString &path, connectionNames)
+            QSqlDatabase::removeDatabase(m_connectionPrefix + path);
+    }
+
+private:
+    QSqlDatabase connection(const QString &path);
+    SqlResult execute(const SqlRequest &request);
+
+    Private *m_service;
+    const SqlRequest::Access m_access;
+    QString m_connectionPrefix;
+
+    /// Connections of this thread by database path
+    QHash<QString, QSqlDatabase> m_connections;
+    /// Prepared statements by database path and SQL
+    QHash<QString, QSqlQuery> m_statements;
+};
+
+QSqlDatabase SqlQueryService::Private::Lane::connection(const QString &path)
+{
+    QHash<QString, QSqlDatabase>::const_iterator it = m_connections.constFind(path);
+    if (it != m_connections.constEnd())
+        return it.value();
+
+    QSqlDatabase db = QSqlDatabase::addDatabase(DEFAULT_DATABASE_TYPE, m_connectionPrefix + path);
+    db.setDatabaseName(path);
+    if (!db.open())
+        return db;
+
+    // readers see the last commit while a write is in progress instead of waiting for it,
+    // stays in effect for the file, so only for the databases the HMI owns
+    if (DatabaseManager::writeAheadLogging(path)) {
+        QSqlQuery pragma(db);
+        if (!pragma.exec(QStringLiteral("PRAGMA journal_mode=WAL")))
+            qWarning("%s: %s", Q_FUNC_INFO, qPrintable(pragma.lastError().text()));
+        pragma.finish();
+    }
+
+    m_connections.insert(path, db);
+    return db;
+}
+
+SqlResult SqlQueryService::Private::Lane::execute(const SqlRequest &request)
+{
+    const QString path = DatabaseManager::databasePath(request.databaseName());
+    if (path.isEmpty())
+        return SqlResult(QStringLiteral("No database given"));
+
+    QSqlDatabase db = connection(path);
+    if (!db.isOpen()) {
+        const QString error = db.lastError().text();
+        db = QSqlDatabase();
+        QSqlDatabase::removeDatabase(m_connectionPrefix + path);
+        return SqlResult(error);
+    }
+
+    const QString key = path + QLatin1Char('\n') + request.sql();
+    QHash<QString, QSqlQuery>::iterator it = m_statements.find(key);
+    if (it == m_statements.end()) {
+        if (m_statements.count() >= MaximumCachedStatements)
+            m_statements.clear();
+
+        QSqlQuery query(db);
+        query.setForwardOnly(true);
+        if (!query.prepare(request.sql()))
+            return SqlResult(query.lastError().text());
+
+        it = m_statements.insert(key, query);
+    }
+
+    QSqlQuery &query = it.value();
+    const QVariantList values = request.values();
+    for (int i = 0; i < values.count(); ++i)
+        query.bindValue(i, values.at(i));
+
+    if (!query.exec()) {
+        const SqlResult result(query.lastError().text());
+        query.finish();
+        return result;
+    }
+
+    const QSqlRecord record = query.record();
+    QStringList columnNames;
+    for (int column = 0; column < record.count(); ++column)
+        columnNames.append(record.fieldName(column));
+
+    QVector<SqlResult::Row> rows;
+    while (query.next()) {
+        SqlResult::Row row(columnNames.count());
+        for (int column = 0; column < columnNames.count(); ++column)
+            row[column] = query.value(column);
+        rows.append(row);
+    }
+
+    const SqlResult result(columnNames, rows, query.numRowsAffected(), query.lastInsertId());
+
+    // a statement left active keeps its read transaction open, which holds back WAL checkpoints
+    query.finish();
+
+    return result;
+}
+
+Job SqlQueryService::Private::takeJob(SqlRequest::Access access)
+{
+    QMutexLocker locker(&mutex);
+
+    forever {
+        if (stopping)
+            return Job();
+
+        while (!pending[access].isEmpty()) {
+            const Job job = pending[access].dequeue();
+
+            QMutexLocker jobLocker(&job->mutex);
+            if (!job->cancelled)
+                return job;
+
+            job->done = true;
+            job->doneCondition.wakeAll();
+        }
+
+        jobsAvailable.wait(&mutex);
+    }
+}
+
+void SqlQueryService::Private::finishJob(const Job &job, const SqlResult &result)
+{
+    QMutexLocker locker(&job->mutex);
+
+    job->result = result;
+    job->done = true;
+    job->doneCondition.wakeAll();
+
+    // the future cannot be deleted meanwhile, its destructor takes the mutex
+    if (job->future && !job->cancelled)
+        QMetaObject::invokeMethod(job->future, "deliver", Qt::QueuedConnection);
+}
+
+SqlQueryService::SqlQueryService(QObject *parent)
+    : QObject(parent)
+    , d(new Private)
+{
+    d->connectionPrefix = QStringLiteral("SqlQueryService-%1-").arg(quintptr(this), 0, 16);
+}
+
+SqlQueryService::~SqlQueryService()
+{
+    {
+        QMutexLocker locker(&d->mutex);
+        d->stopping = true;
+        d->jobsAvailable.wakeAll();
+    }
+
+    for (int lane = SqlRequest::Read; lane <= SqlRequest::Write; ++lane) {
+        if (!d->lanes[lane])
+            continue;
+
+        d->lanes[lane]->wait();
+        delete d->lanes[lane];
+    }
+
+    // release anyone waiting for a dropped request
+    for (int lane = SqlRequest::Read; lane <= SqlRequest::Write; ++lane) {
+        Q_FOREACH (const Job &job, d->pending[lane]) {
+            QMutexLocker locker(&job->mutex);
+            job->cancelled = true;
+            job->done = true;
+            job->doneCondition.wakeAll();
+        }
+    }
+
+    delete d;
+}
+
+SqlFuture *SqlQueryService::submit(const SqlRequest &request, QObject *parent)
+{
+    const Job job(new SqlFutureState);
+    job->request = request;
+    SqlFuture *future = new SqlFuture(new SqlFuture::Private(job), parent);
+
+    QMutexLocker locker(&d->mutex);
+
+    const int lane = request.access();
+    if (!d->lanes[lane]) {
+        d->lanes[lane] = new Private::Lane(d, request.access());
+        d->lanes[lane]->start();
+    }
+
+    d->pending[lane].enqueue(job);
+    d->jobsAvailable.wakeAll();
+
+    return future;
+}
+
+SqlFuture *SqlQueryService::read(const QString &databaseName, const QString &sql, const QVariantList &values,
+                                 QObject *parent)
+{
+    return submit(SqlRequest(databaseName, sql, values, SqlRequest::Read), parent);
+}
+
+SqlFuture *SqlQueryService::write(const QString &databaseName, const QString &sql, const QVariantList &values,
+                                  QObject *parent)
+{
+    return submit(SqlRequest(databaseName, sql, values, SqlRequest::Write), parent);
+}
+
+}
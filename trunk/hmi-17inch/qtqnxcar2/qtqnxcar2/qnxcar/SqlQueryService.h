@@ -0,0 +1,155 @@
+#ifndef QTQNXCAR2_SQLQUERYSERVICE_H
+#define QTQNXCAR2_SQLQUERYSERVICE_H
+
+#include "qtqnxcar2_export.h"
+
+#include "SqlResult.h"
+
+#include <QObject>
+#include <QString>
+#include <QVariantList>
+
+namespace QnxCar {
+
+/**
+ * A statement to run by the SqlQueryService
+ */
+class QTQNXCAR2_EXPORT SqlRequest
+{
+public:
+    /// Whether a statement only reads or also writes
+    enum Access {
+        /// Runs on the shared read connection, next to a running write
+        Read,
+        /// Runs on the write connection, one write at a time
+        Write
+    };
+
+    SqlRequest();
+
+    /**
+     * Creates a request
+     *
+     * @param databaseName a file name resolved by DatabaseManager::databasePath(), e.g. @c "phonebook.db"
+     * @param sql the statement, with positional (@c ?) or named placeholders
+     * @param values the values bound to the placeholders, in order
+     * @param access whether the statement writes
+     */
+    SqlRequest(const QString &databaseName, const QString &sql, const QVariantList &values = QVariantList(),
+               Access access = Read);
+
+    QString databaseName() const;
+    QString sql() const;
+    QVariantList values() const;
+    Access access() const;
+
+private:
+    QString m_databaseName;
+    QString m_sql;
+    QVariantList m_values;
+    Access m_access;
+};
+
+/**
+ * The pending result of a request submitted to the SqlQueryService
+ *
+ * finished() is emitted in the thread the future was created in, once the rows have been read.
+ * The future is owned by the caller; deleting it cancels the request.
+ */
+class QTQNXCAR2_EXPORT SqlFuture : public QObject
+{
+    Q_OBJECT
+public:
+    ~SqlFuture();
+
+    SqlRequest request() const;
+
+    /// Whether the result has been delivered
+    bool isFinished() const;
+
+    /// Returns the result once finished, an invalid result before
+    SqlResult result() const;
+
+    /**
+     * Drops the request if it is still waiting, otherwise its result is not delivered.
+     * A cancelled future never emits finished().
+     */
+    void cancel();
+    bool isCancelled() const;
+
+    /**
+     * Blocks until the result has been delivered or @p msecs milliseconds passed, -1 to wait forever.
+     * Returns whether the future is finished. Never call this from the GUI thread while rendering.
+     */
+    bool waitForFinished(int msecs = -1);
+
+Q_SIGNALS:
+    void finished();
+
+private Q_SLOTS:
+    void deliver();
+
+private:
+    friend class SqlQueryService;
+
+    class Private;
+    explicit SqlFuture(Private *d, QObject *parent);
+
+    Private *const d;
+};
+
+/**
+ * Runs SQL statements on worker threads, so that the calling thread never waits for SQLite
+ *
+ * Reads and writes run on a thread each, with connections of their own per database file.
+ * Databases enabled with DatabaseManager::setWriteAheadLogging() are switched to write-ahead
+ * logging, so that reads see the last commit while a write is in progress instead of waiting for
+ * it. Databases of system services, e.g. the phonebook, keep their journal mode; reads on them
+ * still wait for a running write. Statements are prepared once per connection and reused. Within each thread, requests run in the order they
+ * were submitted.
+ *
+ * @code
+ * SqlFuture *future = DatabaseManager::queryService()->read(QStringLiteral("phonebook.db"),
+ *     QStringLiteral("SELECT first_name, last_name FROM contacts_view WHERE contact_id = ?"),
+ *     QVariantList() << contactId, this);
+ * connect(future, &SqlFuture::finished, this, &Contact::contactRead);
+ * @endcode
+ *
+ * @sa DatabaseManager::queryService(), SqlQueryModel::submitQuery()
+ */
+class QTQNXCAR2_EXPORT SqlQueryService : public QObject
+{
+    Q_OBJECT
+public:
+    explicit SqlQueryService(QObject *parent = 0);
+
+    /**
+     * Drops the waiting requests and waits for the running ones to finish
+     */
+    ~SqlQueryService();
+
+    /**
+     * Queues @p request, can be called from any thread
+     *
+     * @param request the statement to run
+     * @param parent the parent of the returned future
+     * @return the future receiving the result, owned by the caller
+     */
+    SqlFuture *submit(const SqlRequest &request, QObject *parent = 0);
+
+    /// Queues a statement reading from @p databaseName, see submit()
+    SqlFuture *read(const QString &databaseName, const QString &sql, const QVariantList &values = QVariantList(),
+                    QObject *parent = 0);
+
+    /// Queues a statement writing to @p databaseName, see submit()
+    SqlFuture *write(const QString &databaseName, const QString &sql, const QVariantList &values = QVariantList(),
+                     QObject *parent = 0);
+
+private:
+    class Private;
+    Private *const d;
+};
+
+}
+
+#endif
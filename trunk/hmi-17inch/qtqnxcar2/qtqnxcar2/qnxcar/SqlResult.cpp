@@ -0,0 +1,111 @@
+#include "SqlResult.h"
+
+namespace QnxCar {
+
+class SqlResult::Data : public QSharedData
+{
+public:
+    Data()
+        : valid(false)
+        , numRowsAffected(-1)
+    {}
+
+    bool valid;
+    QString errorString;
+    QStringList columnNames;
+    QVector<Row> rows;
+    int numRowsAffected;
+    QVariant lastInsertId;
+};
+
+SqlResult::SqlResult()
+    : d(new Data)
+{
+}
+
+SqlResult::SqlResult(const QStringList &columnNames, const QVector<Row> &rows,
+                     int numRowsAffected, const QVariant &lastInsertId)
+    : d(new Data)
+{
+    d->valid = true;
+    d->columnNames = columnNames;
+    d->rows = rows;
+    d->numRowsAffected = numRowsAffected;
+    d->lastInsertId = lastInsertId;
+}
+
+SqlResult::SqlResult(const QString &errorString)
+    : d(new Data)
+{
+    d->errorString = errorString;
+}
+
+SqlResult::SqlResult(const SqlResult &other)
+    : d(other.d)
+{
+}
+
+SqlResult::~SqlResult()
+{
+}
+
+SqlResult &SqlResult::operator=(const SqlResult &other)
+{
+    d = other.d;
+    return *this;
+}
+
+bool SqlResult::isValid() const
+{
+    return d->valid;
+}
+
+QString SqlResult::errorString() const
+{
+    return d->errorString;
+}
+
+QStringList SqlResult::columnNames() const
+{
+    return d->columnNames;
+}
+
+int SqlResult::columnIndex(const QString &name) const
+{
+    return d->columnNames.indexOf(name);
+}
+
+int SqlResult::columnCount() const
+{
+    return d->columnNames.count();
+}
+
+int SqlResult::rowCount() const
+{
+    return d->rows.count();
+}
+
+SqlResult::Row SqlResult::row(int row) const
+{
+    return d->rows.value(row);
+}
+
+QVariant SqlResult::value(int row, int column) const
+{
+    if (row < 0 || row >= d->rows.count())
+        return QVariant();
+
+    return d->rows.at(row).value(column);
+}
+
+int SqlResult::numRowsAffected() const
+{
+    return d->numRowsAffected;
+}
+
+QVariant SqlResult::lastInsertId() const
+{
+    return d->lastInsertId;
+}
+
+}
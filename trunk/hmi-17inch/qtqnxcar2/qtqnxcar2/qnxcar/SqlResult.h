@@ -0,0 +1,84 @@
+#ifndef QTQNXCAR2_SQLRESULT_H
+#define QTQNXCAR2_SQLRESULT_H
+
+#include "qtqnxcar2_export.h"
+
+#include <QSharedDataPointer>
+#include <QStringList>
+#include <QVariant>
+#include <QVector>
+
+namespace QnxCar {
+
+/**
+ * Immutable snapshot of the rows returned by a query
+ *
+ * Results are read completely by the SqlQueryService on its worker thread and handed to the
+ * requesting thread by value. They are implicitly shared, copying them is cheap, and they never
+ * touch the database again.
+ *
+ * @sa SqlQueryService, SqlFuture
+ */
+class QTQNXCAR2_EXPORT SqlResult
+{
+public:
+    typedef QVector<QVariant> Row;
+
+    /**
+     * Creates an invalid result, e.g. of a query that has not finished yet
+     */
+    SqlResult();
+
+    /**
+     * Creates the result of a successful query
+     *
+     * @param columnNames the names of the columns of @p rows
+     * @param rows the returned rows, empty for statements not returning rows
+     * @param numRowsAffected the number of rows changed by a write, -1 if unknown
+     * @param lastInsertId the id of the row inserted by a write, if any
+     */
+    SqlResult(const QStringList &columnNames, const QVector<Row> &rows,
+              int numRowsAffected = -1, const QVariant &lastInsertId = QVariant());
+
+    /**
+     * Creates the result of a failed query
+     *
+     * @param errorString the error reported by the database
+     */
+    explicit SqlResult(const QString &errorString);
+
+    SqlResult(const SqlResult &other);
+    ~SqlResult();
+    SqlResult &operator=(const SqlResult &other);
+
+    /// Whether the query has been executed successfully
+    bool isValid() const;
+
+    /// Returns the error of a failed query, empty otherwise
+    QString errorString() const;
+
+    QStringList columnNames() const;
+
+    /// Returns the column named @p name, -1 if there is none
+    int columnIndex(const QString &name) const;
+
+    int columnCount() const;
+    int rowCount() const;
+
+    /// Returns all columns of @p row, an empty row if @p row is out of range
+    Row row(int row) const;
+
+    /// Returns the value at @p row and @p column, an invalid QVariant if either is out of range
+    QVariant value(int row, int column) const;
+
+    int numRowsAffected() const;
+    QVariant lastInsertId() const;
+
+private:
+    class Data;
+    QSharedDataPointer<Data> d;
+};
+
+}
+
+#endif
@@ -335,6 +335,8 @@ void BrowseModel::Private::doLoadPage(int page) const
     if(mediaSource.ready) {
         // The source is ready, so execute the browse command
         QPlayer::BrowseCommand *command = new QPlayer::BrowseCommand(lastBrowsedMediaSourceId(), lastBrowsedMediaNodeId(), q->pageSize(), q->pageSize() * (page - 1));
+        command->setPriority(q->pagePriority(page));
+        command->setCancellationToken(q->commandToken());
         connect(command, &QPlayer::BrowseCommand::complete, this, &BrowseModel::Private::onBrowseResult);
         connect(command, &QPlayer::BrowseCommand::error, this, &BrowseModel::Private::onBrowseError);
        q->m_qPlayer->browse(command);
@@ -6,6 +6,7 @@ namespace MediaPlayer {
 MediaNode::MediaNode()
     : mediaSourceId(-1)
     , type(MediaNodeType::UNKNOWN)
+    , count(-1)
     , ready(true)
 {
 }
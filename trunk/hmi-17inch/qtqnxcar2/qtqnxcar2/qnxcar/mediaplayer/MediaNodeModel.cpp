@@ -11,6 +11,7 @@ namespace MediaPlayer {
 MediaNodeModel::MediaNodeModel(QPlayer::QPlayer *qPlayer, QObject *parent)
     : QAbstractListModel(parent)
     , m_qPlayer(qPlayer)
+    , m_commandToken(QPlayer::QPlayer::createCancellationToken())
 {
 }
 
@@ -20,18 +21,16 @@ MediaNodeModel::~MediaNodeModel()
 
 int MediaNodeModel::rowCount(const QModelIndex &parent) const
 {
-    return parent.isValid() ? 0 : m_mediaNodes.size();
+    return parent.isValid() ? 0 : m_mediaNodes.count();
 }
 
 QVariant MediaNodeModel::data(const QModelIndex &index, int role) const
 {
-    MediaNode mediaNode;
-    QMap<int, MediaNode>::const_iterator i;
+    // rows that are not (or no longer) loaded read like an empty node
+    static const MediaNode emptyNode;
 
-    i = m_mediaNodes.constFind(index.row());
-    if(i != m_mediaNodes.constEnd()) {
-        mediaNode = i.value();
-    }
+    const MediaNode *node = m_mediaNodes.node(index.row());
+    const MediaNode &mediaNode = node ? *node : emptyNode;
 
 //    QString name = mediaNode.name;
 //    QString title = mediaNode.metadata.title;
@@ -51,15 +50,8 @@ QVariant MediaNodeModel::data(const QModelIndex &index, int role) const
         case MediaSourceIdRole:
             return mediaNode.mediaSourceId;
         case Qt::DisplayRole:
-        case NameRole: {
-            QString name;
-            if(!mediaNode.metadata.title.isEmpty()) {
-                name = mediaNode.metadata.title;
-            } else {
-                name = mediaNode.name;
-            }
-            return name.toUtf8().data();
-        }
+        case NameRole:
+            return mediaNode.metadata.title.isEmpty() ? mediaNode.name : mediaNode.metadata.title;
         case TypeRole:
             return mediaNode.type;
         case ArtworkRole:
@@ -90,16 +82,14 @@ QHash<int,QByteArray> MediaNodeModel::roleNames() const
 
 bool MediaNodeModel::nodeExists(int index) const
 {
-    return m_mediaNodes.contains(index);
+    return m_mediaNodes.node(index) != 0;
 }
 
 void MediaNodeModel::insert(int index, QList<MediaNode> mediaNodes)
 {
     if(mediaNodes.length() > 0) {
         // Append nodes to those already in storage
-        for(int i = 0; i < mediaNodes.length(); i++) {
-            m_mediaNodes.insert(index + i, mediaNodes[i]);
-        }
+        m_mediaNodes.insert(index, mediaNodes);
 
         // TODO: We should only be loading metadata for nodes which are being displayed.
         // The challenge with this is that our only indication that nodes are being displayed is the invocation of
@@ -107,15 +97,17 @@ void MediaNodeModel::insert(int index, QList<MediaNode> mediaNodes)
         // to return, so we'll need a way of checking if there's already one in progress for the node in question.
 
         // Load metadata and extended metadata for the added nodes
-        for(QList<MediaNode>::const_iterator i = mediaNodes.constBegin(); i != mediaNodes.constEnd(); i++) {
-            MediaNode mediaNode = *i;
+        for(QList<MediaNode>::iterator i = mediaNodes.begin(); i != mediaNodes.end(); i++) {
+            MediaNode &mediaNode = *i;
 
             if(mediaNode.type == MediaNodeType::AUDIO) {
                 QPlayer::MetadataCommand *mdCommand = new QPlayer::MetadataCommand(mediaNode.mediaSourceId, mediaNode.id);
+                mdCommand->setCancellationToken(m_commandToken);
                 connect(mdCommand, &QPlayer::MetadataCommand::complete, this, &MediaNodeModel::onMetadataCommandComplete);
                 m_qPlayer->getMetadata(mdCommand);
             } else if(mediaNode.type == MediaNodeType::FOLDER && !mediaNode.hasExtendedMetadata((QStringLiteral("folder_type")))) {
                 QPlayer::ExtendedMetadataCommand *emdCommand = new QPlayer::ExtendedMetadataCommand(mediaNode.mediaSourceId, mediaNode.id, QStringList(QLatin1String("folder_type")));
+                emdCommand->setCancellationToken(m_commandToken);
                 connect(emdCommand, &QPlayer::ExtendedMetadataCommand::complete, this, &MediaNodeModel::onExtendedMetadataCommandComplete);
 
                 m_qPlayer->getExtendedMetadata(emdCommand);
@@ -126,23 +118,35 @@ void MediaNodeModel::insert(int index, QList<MediaNode> mediaNodes)
 
 void MediaNodeModel::clear()
 {
+    // Results of commands issued for the old nodes are of no use anymore
+    if (m_qPlayer)
+        m_qPlayer->cancel(m_commandToken);
+    m_commandToken = QPlayer::QPlayer::createCancellationToken();
+
     // Clear existing nodes
-    beginRemoveRows(QModelIndex(), 0, rowCount());
+    if(rowCount() == 0) {
+        m_mediaNodes.clear();
+        return;
+    }
+
+    beginRemoveRows(QModelIndex(), 0, rowCount() - 1);
     m_mediaNodes.clear();
     endRemoveRows();
 }
 
+quint32 MediaNodeModel::commandToken() const
+{
+    return m_commandToken;
+}
+
 void MediaNodeModel::onMetadataCommandComplete(QPlayer::MetadataCommand *command)
 {
     // Find the media node in storage
-    int index = findMediaNodeIndex(command->mediaSourceId(), command->mediaNodeId());
+    const int index = m_mediaNodes.indexOf(command->mediaSourceId(), command->mediaNodeId());
 
     if(index != -1) {
-        // Convert the metadata
-        Metadata metadata = TypeConverter::convertMetadata(command->result());
-
         // Update the node's metadata and notify of the changed data
-        m_mediaNodes.find(index).value().metadata = metadata;
+        m_mediaNodes.node(index)->metadata = TypeConverter::convertMetadata(command->result());
 
         emit dataChanged(createIndex(index, 0), createIndex(index, 0));
     } else {
@@ -153,13 +157,13 @@ void MediaNodeModel::onMetadataCommandComplete(QPlayer::MetadataCommand *command
 void MediaNodeModel::onExtendedMetadataCommandComplete(QPlayer::ExtendedMetadataCommand *command)
 {
     // Find the media node in storage
-    int index = findMediaNodeIndex(command->mediaSourceId(), command->mediaNodeId());
+    const int index = m_mediaNodes.indexOf(command->mediaSourceId(), command->mediaNodeId());
 
     if(index != -1) {
         QStringList keys = command->result().keys();
-        QMap<int, MediaNode>::iterator mn = m_mediaNodes.find(index);
+        MediaNode *mediaNode = m_mediaNodes.node(index);
         for(int i = 0; i < keys.size(); i++) {
-            mn.value().setExtendedMetadata(keys[i], command->result().value(keys[i]));
+            mediaNode->setExtendedMetadata(keys[i], command->result().value(keys[i]));
         }
 
         // Notify of the changed data
@@ -169,19 +173,5 @@ void MediaNodeModel::onExtendedMetadataCommandComplete(QPlayer::ExtendedMetadata
     }
 }
 
-int MediaNodeModel::findMediaNodeIndex(const int mediaSourceId, const QString mediaNodeId)
-{
-    int index = -1;
-
-    for(QMap<int, MediaNode>::const_iterator i = m_mediaNodes.constBegin(); i != m_mediaNodes.constEnd(); i++) {
-        if(i.value().mediaSourceId == mediaSourceId && i.value().id == mediaNodeId) {
-            index = i.key();
-            break;
-        }
-    }
-
-    return index;
-}
-
 }
 }
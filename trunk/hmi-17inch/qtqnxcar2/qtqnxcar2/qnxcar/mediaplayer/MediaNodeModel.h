@@ -9,6 +9,7 @@
 
 #include "qplayer/qplayer.h"
 #include "MediaNode.h"
+#include "MediaNodeStore_p.h"
 
 namespace QnxCar {
 namespace MediaPlayer {
@@ -76,6 +77,17 @@ protected:
      */
     virtual void clear();
 
+    /**
+     * @brief Returns the cancellation token of the QPlayer commands issued for the current content of the model. All
+     * commands still waiting or running with this token are cancelled when the model is cleared.
+     */
+    quint32 commandToken() const;
+
+    /**
+     * @brief MediaNode storage.
+     */
+    MediaNodeStore m_mediaNodes;
+
 protected slots:
     /**
      * @brief Updates the metadata for the associated media node in storage.
@@ -90,19 +102,7 @@ protected slots:
     void onExtendedMetadataCommandComplete(QPlayer::ExtendedMetadataCommand *command);
 
 private:
-    /**
-     * @brief MediaNode storage.
-     */
-    QMap<int, MediaNode> m_mediaNodes;
-
-    /**
-     * @brief Returns the index of the media node in the media node storage with the matching media source ID and
-     * media node ID.
-     * @param mediaSourceId The node's media source ID.
-     * @param mediaNodeId The node ID.
-     * @return The index of the media node in the media node storage, or -1 if the node is not found.
-     */
-    int findMediaNodeIndex(const int mediaSourceId, const QString mediaNodeId);
+    quint32 m_commandToken;
 };
 
 }
@@ -0,0 +1,148 @@
+#include "MediaNodeStore_p.h"
+
+namespace QnxCar {
+namespace MediaPlayer {
+
+MediaNodeStore::MediaNodeStore(int pageSize)
+    : m_pageSize(qMax(1, pageSize))
+    , m_count(0)
+    , m_residentPageCount(0)
+{
+}
+
+MediaNodeStore::~MediaNodeStore()
+{
+    clear();
+}
+
+int MediaNodeStore::pageSize() const
+{
+    return m_pageSize;
+}
+
+void MediaNodeStore::setPageSize(int size)
+{
+    clear();
+    m_pageSize = qMax(1, size);
+}
+
+int MediaNodeStore::count() const
+{
+    return m_count;
+}
+
+const MediaNode *MediaNodeStore::node(int index) const
+{
+    if (index < 0)
+        return 0;
+
+    const int page = index / m_pageSize;
+    if (page >= m_pages.size() || !m_pages.at(page))
+        return 0;
+
+    const Page *p = m_pages.at(page);
+    const int offset = index % m_pageSize;
+    return p->present.testBit(offset) ? &p->nodes.at(offset) : 0;
+}
+
+MediaNode *MediaNodeStore::node(int index)
+{
+    return const_cast<MediaNode *>(static_cast<const MediaNodeStore *>(this)->node(index));
+}
+
+void MediaNodeStore::insert(int index, const QList<MediaNode> &mediaNodes)
+{
+    if (index < 0 || mediaNodes.isEmpty())
+        return;
+
+    const int end = index + mediaNodes.size();
+    const int pageCount = (end + m_pageSize - 1) / m_pageSize;
+    if (m_pages.size() < pageCount)
+        m_pages.resize(pageCount);
+    if (m_stored.size() < end)
+        m_stored.resize(end);
+
+    for (int i = 0; i < mediaNodes.size(); ++i) {
+        const int row = index + i;
+        const int offset = row % m_pageSize;
+
+        Page *&page = m_pages[row / m_pageSize];
+        if (!page) {
+            page = new Page;
+            page->nodes.resize(m_pageSize);
+            page->present.resize(m_pageSize);
+            ++m_residentPageCount;
+        }
+
+        // the node that is replaced is not found by its ID anymore
+        if (page->present.testBit(offset))
+            removeFromIndex(page->nodes.at(offset), row);
+
+        const MediaNode &mediaNode = mediaNodes.at(i);
+        page->nodes[offset] = mediaNode;
+        page->present.setBit(offset);
+        m_indexes.insert(NodeKey(mediaNode.mediaSourceId, mediaNode.id), row);
+
+        if (!m_stored.testBit(row)) {
+            m_stored.setBit(row);
+            ++m_count;
+        }
+    }
+}
+
+int MediaNodeStore::indexOf(int mediaSourceId, const QString &mediaNodeId) const
+{
+    return m_indexes.value(NodeKey(mediaSourceId, mediaNodeId), -1);
+}
+
+int MediaNodeStore::residentPageCount() const
+{
+    return m_residentPageCount;
+}
+
+QList<int> MediaNodeStore::residentPages() const
+{
+    QList<int> pages;
+    for (int i = 0; i < m_pages.size(); ++i) {
+        if (m_pages.at(i))
+            pages.append(i);
+    }
+    return pages;
+}
+
+void MediaNodeStore::evictPage(int page)
+{
+    if (page < 0 || page >= m_pages.size() || !m_pages.at(page))
+        return;
+
+    Page *p = m_pages.at(page);
+    for (int offset = 0; offset < m_pageSize; ++offset) {
+        if (p->present.testBit(offset))
+            removeFromIndex(p->nodes.at(offset), page * m_pageSize + offset);
+    }
+
+    delete p;
+    m_pages[page] = 0;
+    --m_residentPageCount;
+}
+
+void MediaNodeStore::removeFromIndex(const MediaNode &mediaNode, int index)
+{
+    // several rows may share an ID, e.g. virtual nodes; only drop the entry if it points to this row
+    QHash<NodeKey, int>::Iterator it = m_indexes.find(NodeKey(mediaNode.mediaSourceId, mediaNode.id));
+    if (it != m_indexes.end() && it.value() == index)
+        m_indexes.erase(it);
+}
+
+void MediaNodeStore::clear()
+{
+    qDeleteAll(m_pages);
+    m_pages.clear();
+    m_stored.clear();
+    m_indexes.clear();
+    m_count = 0;
+    m_residentPageCount = 0;
+}
+
+}
+}
@@ -0,0 +1,115 @@
+#ifndef QTQNXCAR2_MEDIAPLAYER_MEDIANODESTORE_P_H
+#define QTQNXCAR2_MEDIAPLAYER_MEDIANODESTORE_P_H
+
+#include "MediaNode.h"
+
+#include <QBitArray>
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QVector>
+
+namespace QnxCar {
+namespace MediaPlayer {
+
+/**
+ * @brief Row storage of MediaNodeModel.
+ *
+ * Nodes are kept in a vector of fixed-size pages, each page a contiguous block of nodes, so looking up a row is two
+ * array accesses and rows can be handed out by reference. Pages can be evicted to bound memory use; the rows they
+ * held stay counted, so the model's row count does not change when data is dropped and loaded again later.
+ */
+class MediaNodeStore
+{
+public:
+    static const int DefaultPageSize = 20;
+
+    explicit MediaNodeStore(int pageSize = DefaultPageSize);
+    ~MediaNodeStore();
+
+    /**
+     * @brief Returns the number of rows per page.
+     */
+    int pageSize() const;
+
+    /**
+     * @brief Sets the number of rows per page, clearing the store.
+     */
+    void setPageSize(int size);
+
+    /**
+     * @brief Returns the number of rows that have been stored, including those whose page has been evicted since.
+     */
+    int count() const;
+
+    /**
+     * @brief Returns the node at @p index, or @c 0 if there is none or its page has been evicted.
+     */
+    const MediaNode *node(int index) const;
+    MediaNode *node(int index);
+
+    /**
+     * @brief Stores @p mediaNodes at @p index and the following rows, replacing the nodes that were there.
+     */
+    void insert(int index, const QList<MediaNode> &mediaNodes);
+
+    /**
+     * @brief Returns the index of the node with the given media source ID and node ID, or -1 if it is not stored.
+     */
+    int indexOf(int mediaSourceId, const QString &mediaNodeId) const;
+
+    /**
+     * @brief Returns the page holding the row at @p index.
+     */
+    int pageOf(int index) const { return index / m_pageSize; }
+
+    /**
+     * @brief Returns the number of pages currently held in memory.
+     */
+    int residentPageCount() const;
+
+    /**
+     * @brief Returns the pages currently held in memory, in ascending order.
+     */
+    QList<int> residentPages() const;
+
+    /**
+     * @brief Drops the nodes of @p page from memory.
+     */
+    void evictPage(int page);
+
+    /**
+     * @brief Removes all rows.
+     */
+    void clear();
+
+private:
+    Q_DISABLE_COPY(MediaNodeStore)
+
+    struct Page
+    {
+        QVector<MediaNode> nodes;
+        QBitArray present;
+    };
+
+    typedef QPair<int, QString> NodeKey;
+
+    void removeFromIndex(const MediaNode &mediaNode, int index);
+
+    int m_pageSize;
+    int m_count;
+    int m_residentPageCount;
+
+    // 0 for pages that have not been loaded or have been evicted
+    QVector<Page *> m_pages;
+
+    // rows that hold or held a node
+    QBitArray m_stored;
+
+    QHash<NodeKey, int> m_indexes;
+};
+
+}
+}
+
+#endif
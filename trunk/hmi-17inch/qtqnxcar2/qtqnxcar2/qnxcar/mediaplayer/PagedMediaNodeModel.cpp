@@ -1,14 +1,15 @@
 #include "PagedMediaNodeModel.h"
 
-#include <math.h>
-
 namespace QnxCar {
 namespace MediaPlayer {
 
 PagedMediaNodeModel::PagedMediaNodeModel(QPlayer::QPlayer *qPlayer, QObject *parent)
     : MediaNodeModel(qPlayer, parent)
-    , m_pageSize(20)
+    , m_pageSize(MediaNodeStore::DefaultPageSize)
+    , m_maximumResidentPages(50)
+    , m_currentPage(1)
 {
+    m_mediaNodes.setPageSize(m_pageSize);
 }
 
 PagedMediaNodeModel::~PagedMediaNodeModel()
@@ -17,9 +18,12 @@ PagedMediaNodeModel::~PagedMediaNodeModel()
 
 QVariant PagedMediaNodeModel::data(const QModelIndex &index, int role) const
 {
-    int currentPage = floor(index.row() / pageSize()) + 1;
-    int nextPage = currentPage + 1;
-    int previousPage = (1 > currentPage - 1 ? 1 : currentPage - 1);
+    const int currentPage = index.row() / pageSize() + 1;
+    const int nextPage = currentPage + 1;
+    const int previousPage = qMax(1, currentPage - 1);
+
+    // pages around this one are kept when evicting
+    m_currentPage = currentPage;
 
     // Load the current page if it doesn't already exist (it should)
     loadPage(currentPage);
@@ -40,20 +44,53 @@ int PagedMediaNodeModel::pageSize() const
 
 void PagedMediaNodeModel::setPageSize(int size)
 {
+    if(size == m_pageSize)
+        return;
+
+    // store pages match the loaded pages, so that evicting a store page can mark the page for loading again
+    clear();
     m_pageSize = size;
+    m_mediaNodes.setPageSize(size);
+}
+
+int PagedMediaNodeModel::maximumResidentPages() const
+{
+    return m_maximumResidentPages;
+}
+
+void PagedMediaNodeModel::setMaximumResidentPages(int pages)
+{
+    m_maximumResidentPages = qMax(0, pages);
+    evictPages();
+}
+
+int PagedMediaNodeModel::residentPageCount() const
+{
+    return m_mediaNodes.residentPageCount();
 }
 
 void PagedMediaNodeModel::loadPage(int page) const
 {
-    if(!m_loadedPages.contains(page)) {
-        // Add the page number to known list of loaded pages so we don't try to load the same page again
-        m_loadedPages.append(page);
+    if(page < 1)
+        return;
+
+    if(page >= m_loadedPages.size())
+        m_loadedPages.resize(qMax(page + 1, m_loadedPages.size() * 2));
+
+    if(!m_loadedPages.testBit(page)) {
+        // Mark the page as loaded so we don't try to load the same page again
+        m_loadedPages.setBit(page);
 
         // Load the page
         doLoadPage(page);
     }
 }
 
+QPlayer::BaseCommand::Priority PagedMediaNodeModel::pagePriority(int page) const
+{
+    return page == m_currentPage ? QPlayer::BaseCommand::ForegroundPriority : QPlayer::BaseCommand::PrefetchPriority;
+}
+
 void PagedMediaNodeModel::doLoadPage(int page) const
 {
     Q_UNUSED(page);
@@ -81,9 +118,51 @@ void PagedMediaNodeModel::insert(int index, QList<MediaNode> mediaNodes)
 
     // Create indicies for the added nodes as we append them
     if(mediaNodes.length() > 0) {
-        beginInsertRows(QModelIndex(), index, index + mediaNodes.length() - 1);
-        MediaNodeModel::insert(index, mediaNodes);
-        endInsertRows();
+        // Rows that are loaded again after their page was evicted are already known to clients
+        const int previousRowCount = rowCount();
+        const int end = index + mediaNodes.length();
+
+        if(end > previousRowCount) {
+            beginInsertRows(QModelIndex(), previousRowCount, end - 1);
+            MediaNodeModel::insert(index, mediaNodes);
+            endInsertRows();
+        } else {
+            MediaNodeModel::insert(index, mediaNodes);
+        }
+
+        if(index < previousRowCount)
+            emit dataChanged(createIndex(index, 0), createIndex(qMin(end, previousRowCount) - 1, 0));
+
+        evictPages();
+    }
+}
+
+void PagedMediaNodeModel::evictPages()
+{
+    if(m_maximumResidentPages == 0)
+        return;
+
+    while(m_mediaNodes.residentPageCount() > m_maximumResidentPages) {
+        // store pages are numbered from 0, loaded pages from 1
+        const int current = m_currentPage - 1;
+
+        int furthestPage = -1;
+        int furthestDistance = 1;
+        Q_FOREACH(int page, m_mediaNodes.residentPages()) {
+            const int distance = qAbs(page - current);
+            if(distance > furthestDistance) {
+                furthestPage = page;
+                furthestDistance = distance;
+            }
+        }
+
+        // only the pages around the viewport are left
+        if(furthestPage == -1)
+            break;
+
+        m_mediaNodes.evictPage(furthestPage);
+        if(furthestPage + 1 < m_loadedPages.size())
+            m_loadedPages.clearBit(furthestPage + 1);
     }
 }
 
@@ -5,6 +5,8 @@
 
 #include "MediaNodeModel.h"
 
+#include <QBitArray>
+
 namespace QnxCar {
 namespace MediaPlayer {
 
@@ -35,11 +37,30 @@ public:
 
     /**
      * @brief Sets the page size for this model. All MediaNodeModel instances are created with a default page size
-     * of 20.
+     * of 20. Changing the page size clears the model.
      * @param size The page size.
      */
     void setPageSize(int size);
 
+    /**
+     * @brief Returns the maximum number of pages kept in memory.
+     * @return The maximum number of pages, or 0 if pages are never evicted.
+     */
+    int maximumResidentPages() const;
+
+    /**
+     * @brief Sets the maximum number of pages kept in memory. Once more pages are loaded, the pages furthest away from
+     * the most recently requested row are evicted and loaded again when they are requested next. The default is 50.
+     * @param pages The maximum number of pages, or 0 to never evict pages.
+     */
+    void setMaximumResidentPages(int pages);
+
+    /**
+     * @brief Returns the number of pages currently kept in memory.
+     * @return The number of resident pages.
+     */
+    int residentPageCount() const;
+
     /**
     * @brief Checks if the requested page has already been loaded, and if not, loads it and keeps a record, otherwise
     * does nothing.
@@ -70,16 +91,39 @@ protected:
      */
     void clear() Q_DECL_OVERRIDE;
 
+    /**
+     * @brief Returns the priority for the QPlayer commands loading @p page: the page the view is showing is loaded
+     * before the pages prefetched around it.
+     */
+    QPlayer::BaseCommand::Priority pagePriority(int page) const;
+
 private:
+    /**
+     * @brief Evicts the pages furthest away from the current page until at most the maximum number of pages is
+     * resident. The current page and its neighbours are never evicted.
+     */
+    void evictPages();
+
     /**
      * @brief The number of items in each page.
      */
     int m_pageSize;
 
     /**
-     * @brief A list of known loaded pages, used to prevent pages from being loaded more than once.
+     * @brief The maximum number of resident pages, 0 for no limit.
+     */
+    int m_maximumResidentPages;
+
+    /**
+     * @brief The page of the most recently requested row.
+     */
+    mutable int m_currentPage;
+
+    /**
+     * @brief One bit per page, set for pages that have been requested, used to prevent pages from being loaded more
+     * than once. Bit 0 is unused, pages are numbered from 1.
      */
-    mutable QVector<int> m_loadedPages;
+    mutable QBitArray m_loadedPages;
 };
 
 }
@@ -1,19 +1,24 @@
 #include "SearchModel.h"
 
 #include <QDebug>
+#include <QMap>
+#include <QTimer>
 
 #include "TypeConverter.h"
 
 namespace QnxCar {
 namespace MediaPlayer {
 
+/// Dynamic property of the QPlayer commands, holding the generation of the search they were executed for
+static const char generationProperty[] = "searchGeneration";
+
 class SearchModel::Private : public QObject
 {
 public:
     explicit Private(SearchModel *qq);
 
     /**
-     * @brief Executes the search using the QPlayer library.
+     * @brief Starts a search with new parameters, answered from the cache or executed once the search term settled.
      * @param mediaSourceId The media source ID to search.
      * @param searchTerm The search term.
      * @param filter The search result filter.
@@ -37,8 +42,71 @@ public:
     void setSearchIsValid(bool isValid);
 
     void doLoadPage(int page) const;
+    void doSearch(int generation);
+    void doLoadResultPage(int generation, const MediaNode &resultNode, int page);
+    void searchCompleted(int generation, const MediaNode &resultNode);
+    void resultPageLoaded(int generation, int offset, const QList<MediaNode> &mediaNodes);
+
+    /**
+     * @brief Delays the search until the search term did not change for the debounce interval.
+     */
+    QTimer m_searchTimer;
+
+    int m_maximumCachedResults;
 
 private:
+    /**
+     * @brief The result of a search executed by mm-player, collected page by page.
+     */
+    struct ResultCache
+    {
+        ResultCache()
+            : generation(-1)
+            , mediaSourceId(-1)
+            , complete(false)
+        {
+        }
+
+        int generation;
+        int mediaSourceId;
+        QString searchTerm;
+        QString filter;
+        /// The pages loaded so far, by offset, until the result is complete
+        QMap<int, QList<MediaNode> > pages;
+        /// All nodes of the result, once it is complete
+        QList<MediaNode> mediaNodes;
+        bool complete;
+    };
+
+    /**
+     * @brief Starts a new generation: drops the results of the previous search and cancels the commands still loading
+     * them, as well as a search waiting for the search term to settle.
+     */
+    void startGeneration();
+
+    /**
+     * @brief Answers the current search by filtering the cached result, if the search term extends the cached one.
+     * @return @c True if the search has been answered.
+     */
+    bool searchCache();
+
+    /**
+     * @brief Adds a page of the current result to the cache, until it is complete or grows too large. The cache is
+     * dropped as well if a node does not match the search term by its name: mm-player matched it by metadata the
+     * result nodes do not carry, so that the cached nodes cannot be filtered for a longer search term.
+     */
+    void cachePage(int offset, const QList<MediaNode> &mediaNodes);
+
+    /**
+     * @brief Loads the next page missing from the cache in the background, the view only loads the pages it shows.
+     */
+    void fillCache();
+
+    /**
+     * @brief Returns whether @p mediaNode matches @p searchTerm, like it does for mm-player.
+     */
+    static bool matches(const MediaNode &mediaNode, const QString &searchTerm);
+
     void setMediaSourceId(const int mediaSourceId);
     void setSearchTerm(const QString searchTerm);
     void setFilter(const QString filter);
@@ -49,9 +117,47 @@ private:
     bool m_searchInProgress;
     bool m_searchIsValid;
 
+    /**
+     * @brief The generation of the current search, incremented for each search and reset.
+     */
+    int m_generation;
+
     MediaPlayer::MediaNode m_searchResultNode;
 
+    ResultCache m_cache;
+
+    /**
+     * @brief Whether the current search has been answered from the cache.
+     */
+    bool m_cachedSearch;
+
+    /**
+     * @brief The cached nodes matching the current search term.
+     */
+    QList<MediaNode> m_cachedNodes;
+
+    /**
+     * @brief The pages of the cached nodes requested, inserted from the event loop like the pages loaded by mm-player.
+     */
+    mutable QList<int> m_cachedPages;
+    mutable QTimer m_cachedPageTimer;
+
+    /**
+     * @brief The page fillCache() is loading, 0 otherwise. It is loaded at background priority.
+     */
+    int m_cacheFillPage;
+
 private slots:
+    /**
+     * @brief Executes the search once the search term settled.
+     */
+    void onSearchTimeout();
+
+    /**
+     * @brief Inserts the requested pages of the cached nodes.
+     */
+    void onCachedPagesRequested();
+
     /**
      * @brief Search success handler. Browses the search result node.
      * @param command A pointer to the SearchCommand instance used to invoke the search method.
@@ -79,12 +185,22 @@ private slots:
 
 SearchModel::Private::Private(SearchModel *qq)
     : q(qq)
+    , m_maximumCachedResults(1000)
     , m_mediaSourceId(-1)
     , m_searchTerm("")
     , m_filter("")
     , m_searchInProgress(false)
     , m_searchIsValid(false)
+    , m_generation(0)
+    , m_cachedSearch(false)
+    , m_cacheFillPage(0)
 {
+    m_searchTimer.setSingleShot(true);
+    m_searchTimer.setInterval(300);
+    connect(&m_searchTimer, &QTimer::timeout, this, &SearchModel::Private::onSearchTimeout);
+
+    m_cachedPageTimer.setSingleShot(true);
+    connect(&m_cachedPageTimer, &QTimer::timeout, this, &SearchModel::Private::onCachedPagesRequested);
 }
 
 void SearchModel::Private::search(const int mediaSourceId, QString searchTerm, QString filter)
@@ -92,37 +208,132 @@ void SearchModel::Private::search(const int mediaSourceId, QString searchTerm, Q
     // Check if we have a valid search term and that we're not attempting to search for the same results
     if(searchTerm.trimmed() != ""
             && (mediaSourceId != m_mediaSourceId || searchTerm != m_searchTerm || filter != m_filter)) {
-        // Reset the search results
-        resetSearch();
+        // The results of the previous search do not match anymore
+        startGeneration();
 
         // Set the search parameters
         setMediaSourceId(mediaSourceId);
         setSearchTerm(searchTerm);
         setFilter(filter);
+        setSearchIsValid(false);
+        setSearchInProgress(true);
 
-        // Perform the search
-        QPlayer::SearchCommand *command = new QPlayer::SearchCommand(m_mediaSourceId, m_searchTerm, m_filter);
-        connect(command, &QPlayer::SearchCommand::complete, this, &SearchModel::Private::onSearchResult);
-        connect(command, &QPlayer::SearchCommand::error, this, &SearchModel::Private::onSearchError);
-        q->m_qPlayer->search(command);
+        // Refine the result of a shorter search term, or ask mm-player once the user stopped typing
+        if(!searchCache())
+            m_searchTimer.start();
     }
 }
 
 void SearchModel::Private::resetSearch()
 {
+    startGeneration();
+
+    // The media source may be synchronized again before the next search
+    m_cache = ResultCache();
+
     setMediaSourceId(-1);
     setSearchTerm("");
     setFilter("");
     setSearchInProgress(false);
     setSearchIsValid(false);
+}
+
+void SearchModel::Private::startGeneration()
+{
+    ++m_generation;
+    m_searchTimer.stop();
 
     MediaPlayer::MediaNode emptyNode;
     m_searchResultNode = emptyNode;
 
-    // Clear existing search results
+    m_cachedSearch = false;
+    m_cachedNodes.clear();
+    m_cachedPages.clear();
+    m_cachedPageTimer.stop();
+
+    // Clear existing search results, cancelling the commands still loading them
     q->clear();
 }
 
+bool SearchModel::Private::searchCache()
+{
+    if(!m_cache.complete || m_cache.mediaSourceId != m_mediaSourceId || m_cache.filter != m_filter
+            || !m_searchTerm.startsWith(m_cache.searchTerm, Qt::CaseInsensitive))
+        return false;
+
+    // A longer search term matches a subset of the nodes
+    Q_FOREACH(const MediaNode &mediaNode, m_cache.mediaNodes) {
+        if(matches(mediaNode, m_searchTerm))
+            m_cachedNodes.append(mediaNode);
+    }
+
+    m_cachedSearch = true;
+    q->loadPage(1);
+    return true;
+}
+
+void SearchModel::Private::cachePage(int offset, const QList<MediaNode> &mediaNodes)
+{
+    Q_FOREACH(const MediaNode &mediaNode, mediaNodes) {
+        if(!mediaNode.name.contains(m_cache.searchTerm, Qt::CaseInsensitive)) {
+            m_cache = ResultCache();
+            return;
+        }
+    }
+
+    m_cache.pages.insert(offset, mediaNodes);
+
+    // Pages may arrive out of order, the result is complete once the pages from the start reach a short page
+    QList<MediaNode> result;
+    int cachedNodes = 0;
+    bool complete = false;
+    for(QMap<int, QList<MediaNode> >::const_iterator it = m_cache.pages.constBegin(); it != m_cache.pages.constEnd(); ++it) {
+        cachedNodes += it.value().count();
+
+        if(!complete && it.key() == result.count()) {
+            result += it.value();
+            complete = it.value().count() < q->pageSize();
+        }
+    }
+
+    if(complete && result.count() <= m_maximumCachedResults) {
+        m_cache.pages.clear();
+        m_cache.mediaNodes = result;
+        m_cache.complete = true;
+    } else if(cachedNodes >= m_maximumCachedResults) {
+        // No more pages are loaded for it, see fillCache()
+        m_cache = ResultCache();
+    }
+}
+
+void SearchModel::Private::fillCache()
+{
+    if(m_cache.generation != m_generation || m_cache.complete)
+        return;
+
+    // The pages from the start of the result, the next one is missing
+    int offset = 0;
+    while(!m_cache.pages.value(offset).isEmpty())
+        offset += m_cache.pages.value(offset).count();
+
+    // The nodes beyond the maximum would be dropped with the cache
+    if(offset >= m_maximumCachedResults)
+        return;
+
+    // Pages requested by the view already are not loaded twice
+    m_cacheFillPage = offset / q->pageSize() + 1;
+    q->loadPage(m_cacheFillPage);
+    m_cacheFillPage = 0;
+}
+
+bool SearchModel::Private::matches(const MediaNode &mediaNode, const QString &searchTerm)
+{
+    return mediaNode.name.contains(searchTerm, Qt::CaseInsensitive)
+            || mediaNode.metadata.title.contains(searchTerm, Qt::CaseInsensitive)
+            || mediaNode.metadata.artist.contains(searchTerm, Qt::CaseInsensitive)
+            || mediaNode.metadata.album.contains(searchTerm, Qt::CaseInsensitive);
+}
+
 int SearchModel::Private::mediaSourceId() const
 {
     return m_mediaSourceId;
@@ -190,33 +401,120 @@ void SearchModel::Private::setFilter(const QString filter)
 
 void SearchModel::Private::doLoadPage(int page) const
 {
-    QPlayer::BrowseCommand *command = new QPlayer::BrowseCommand(m_searchResultNode.mediaSourceId, m_searchResultNode.id, q->pageSize(), q->pageSize() * (page - 1));
+    if(m_cachedSearch) {
+        m_cachedPages.append(page);
+        m_cachedPageTimer.start();
+    } else if(!m_searchResultNode.id.isEmpty()) {
+        q->doLoadResultPage(m_generation, m_searchResultNode, page);
+    }
+}
+
+void SearchModel::Private::doSearch(int generation)
+{
+    QPlayer::SearchCommand *command = new QPlayer::SearchCommand(m_mediaSourceId, m_searchTerm, m_filter);
+    command->setCancellationToken(q->commandToken());
+    command->setProperty(generationProperty, generation);
+    connect(command, &QPlayer::SearchCommand::complete, this, &SearchModel::Private::onSearchResult);
+    connect(command, &QPlayer::SearchCommand::error, this, &SearchModel::Private::onSearchError);
+    q->m_qPlayer->search(command);
+}
+
+void SearchModel::Private::doLoadResultPage(int generation, const MediaNode &resultNode, int page)
+{
+    QPlayer::BrowseCommand *command = new QPlayer::BrowseCommand(resultNode.mediaSourceId, resultNode.id, q->pageSize(), q->pageSize() * (page - 1));
+    command->setPriority(page == m_cacheFillPage ? QPlayer::BaseCommand::BackgroundPriority : q->pagePriority(page));
+    command->setCancellationToken(q->commandToken());
+    command->setProperty(generationProperty, generation);
     connect(command, &QPlayer::BrowseCommand::complete, this, &SearchModel::Private::onBrowseResult);
     connect(command, &QPlayer::BrowseCommand::error, this, &SearchModel::Private::onBrowseError);
     q->m_qPlayer->browse(command);
 }
 
-void SearchModel::Private::onSearchResult(QPlayer::SearchCommand *command)
+void SearchModel::Private::searchCompleted(int generation, const MediaNode &resultNode)
 {
-    // Verify that we received a search result node
-    if(command->result().length() == 1) {
-        // Cache the search result node in case we need it
-        m_searchResultNode = MediaPlayer::TypeConverter::convertMediaNode(command->result()[0]);
+    // A newer search has been started since
+    if(generation != m_generation)
+        return;
+
+    // Collect the result for answering longer search terms, unless mm-player knows it does not fit
+    m_cache = ResultCache();
+    if(m_maximumCachedResults > 0 && resultNode.count <= m_maximumCachedResults) {
+        m_cache.generation = generation;
+        m_cache.mediaSourceId = m_mediaSourceId;
+        m_cache.searchTerm = m_searchTerm;
+        m_cache.filter = m_filter;
+    }
+
+    if(resultNode.id.isEmpty()) {
+        // The search returned no results, neither will a longer search term
+        if(m_cache.generation == generation)
+            m_cache.complete = true;
 
-        // Browse the search result node
-        q->loadPage(1);
-    } else {
-        // The search returned no results
         setSearchInProgress(false);
         setSearchIsValid(true);
+        return;
     }
+
+    // Cache the search result node and browse it
+    m_searchResultNode = resultNode;
+    q->loadPage(1);
+}
+
+void SearchModel::Private::resultPageLoaded(int generation, int offset, const QList<MediaNode> &mediaNodes)
+{
+    // A newer search has been started since
+    if(generation != m_generation)
+        return;
+
+    if(m_cache.generation == generation && !m_cache.complete)
+        cachePage(offset, mediaNodes);
+
+    q->insert(offset, mediaNodes);
+
+    setSearchInProgress(false);
+    setSearchIsValid(true);
+
+    // Complete the cache page by page, behind the pages the view is waiting for
+    fillCache();
+}
+
+void SearchModel::Private::onSearchTimeout()
+{
+    q->doSearch(m_generation);
+}
+
+void SearchModel::Private::onCachedPagesRequested()
+{
+    const QList<int> pages = m_cachedPages;
+    m_cachedPages.clear();
+
+    Q_FOREACH(int page, pages) {
+        const int offset = q->pageSize() * (page - 1);
+        if(offset < m_cachedNodes.count())
+            q->insert(offset, m_cachedNodes.mid(offset, q->pageSize()));
+    }
+
+    setSearchInProgress(false);
+    setSearchIsValid(true);
+}
+
+void SearchModel::Private::onSearchResult(QPlayer::SearchCommand *command)
+{
+    MediaPlayer::MediaNode resultNode;
+
+    // Verify that we received a search result node, the search returned no results otherwise
+    if(command->result().length() == 1)
+        resultNode = MediaPlayer::TypeConverter::convertMediaNode(command->result()[0]);
+
+    q->searchCompleted(command->property(generationProperty).toInt(), resultNode);
 }
 
 void SearchModel::Private::onSearchError(QPlayer::SearchCommand *command)
 {
-    Q_UNUSED(command);
+    if(command->property(generationProperty).toInt() != m_generation)
+        return;
 
-    // We treat this as the search returning no results.
+    // We treat this as the search returning no results, without caching it.
     setSearchInProgress(false);
     setSearchIsValid(true);
 }
@@ -229,15 +527,13 @@ void SearchModel::Private::onBrowseResult(QPlayer::BrowseCommand *command)
         mediaNodes.append(TypeConverter::convertMediaNode(command->result()[i]));
     }
 
-    q->insert(command->offset(), mediaNodes);
-
-    setSearchInProgress(false);
-    setSearchIsValid(true);
+    q->resultPageLoaded(command->property(generationProperty).toInt(), command->offset(), mediaNodes);
 }
 
 void SearchModel::Private::onBrowseError(QPlayer::BrowseCommand *command)
 {
-    Q_UNUSED(command);
+    if(command->property(generationProperty).toInt() != m_generation)
+        return;
 
     // We treat this as the search returning no results.
     setSearchInProgress(false);
@@ -280,6 +576,26 @@ bool SearchModel::searchIsValid() const
     return d->searchIsValid();
 }
 
+int SearchModel::debounceInterval() const
+{
+    return d->m_searchTimer.interval();
+}
+
+void SearchModel::setDebounceInterval(int msecs)
+{
+    d->m_searchTimer.setInterval(qMax(0, msecs));
+}
+
+int SearchModel::maximumCachedResults() const
+{
+    return d->m_maximumCachedResults;
+}
+
+void SearchModel::setMaximumCachedResults(int nodes)
+{
+    d->m_maximumCachedResults = qMax(0, nodes);
+}
+
 void SearchModel::resetSearch()
 {
     d->resetSearch();
@@ -290,5 +606,25 @@ void SearchModel::doLoadPage(int page) const
     d->doLoadPage(page);
 }
 
+void SearchModel::doSearch(int generation)
+{
+    d->doSearch(generation);
+}
+
+void SearchModel::doLoadResultPage(int generation, const MediaNode &resultNode, int page)
+{
+    d->doLoadResultPage(generation, resultNode, page);
+}
+
+void SearchModel::searchCompleted(int generation, const MediaNode &resultNode)
+{
+    d->searchCompleted(generation, resultNode);
+}
+
+void SearchModel::resultPageLoaded(int generation, int offset, const QList<MediaNode> &mediaNodes)
+{
+    d->resultPageLoaded(generation, offset, mediaNodes);
+}
+
 }
 }
@@ -10,6 +10,18 @@ namespace MediaPlayer {
 
 /**
  * Model for searching and displaying media search results.
+ *
+ * The model is meant to be searched as the user types: a search is only sent to mm-player once the search term did
+ * not change for debounceInterval() milliseconds, and the search it supersedes is cancelled, stopping between the
+ * chunks it is reading. Each search is tagged with a generation, results of earlier generations are dropped.
+ *
+ * The complete result of the last search sent to mm-player is kept if it has at most maximumCachedResults() nodes.
+ * The pages of the result the view does not request are loaded at background priority to complete it. This stops
+ * once the result is known not to fit: right away if mm-player reports the number of results, after
+ * maximumCachedResults() nodes otherwise.
+ * A search term extending the cached one is answered by filtering the cached result, without searching again. This
+ * requires all cached nodes to match the cached search term by their name: mm-player matches metadata as well, which
+ * the result nodes do not carry, so a result with nodes found by their metadata is not kept.
  */
 class QTQNXCAR2_EXPORT SearchModel : public PagedMediaNodeModel
 {
@@ -99,6 +111,28 @@ public:
      */
     bool searchIsValid() const;
 
+    /**
+     * Returns the time in milliseconds the search term has to stay unchanged before it is searched for.
+     */
+    int debounceInterval() const;
+
+    /**
+     * Sets the time in milliseconds the search term has to stay unchanged before it is searched for. The default
+     * is 300 milliseconds, 0 searches from the event loop right away.
+     */
+    void setDebounceInterval(int msecs);
+
+    /**
+     * Returns the maximum number of result nodes kept for answering longer search terms.
+     */
+    int maximumCachedResults() const;
+
+    /**
+     * Sets the maximum number of result nodes kept for answering longer search terms. The default is 1000, 0 disables
+     * the cache.
+     */
+    void setMaximumCachedResults(int nodes);
+
 Q_SIGNALS:
     void mediaSourceIdChanged(const int mediaSourceId);
     void searchTermChanged(const QString &searchTerm);
@@ -110,7 +144,7 @@ public Q_SLOTS:
     /**
      * @brief Executes a search against the specified media source and changes the #searchInProgress
      * property to @c true. When the search completes, the #searchInProgress property will be changed
-     * to @c false.
+     * to @c false. The results of the previous search are cleared right away.
      * @param mediaSourceId The media source ID.
      * @param searchTerm The search term.
      * @param filter The search result filter.
@@ -130,6 +164,37 @@ protected:
      */
     void doLoadPage(int page) const Q_DECL_OVERRIDE;
 
+    /**
+     * @brief Searches mm-player for the current #mediaSourceId, #searchTerm and #filter, once the search term settled.
+     * The default implementation executes a search command and reports its result node to searchCompleted().
+     * @param generation The generation of the search, passed on to searchCompleted().
+     */
+    virtual void doSearch(int generation);
+
+    /**
+     * @brief Loads a page of the result node of a search. The default implementation executes a browse command and
+     * reports the nodes to resultPageLoaded().
+     * @param generation The generation of the search, passed on to resultPageLoaded().
+     * @param resultNode The result node passed to searchCompleted().
+     * @param page The number of the page of nodes to load.
+     */
+    virtual void doLoadResultPage(int generation, const MediaNode &resultNode, int page);
+
+    /**
+     * @brief Takes the result node of a search started by doSearch(), dropped if a newer search has been started.
+     * @param generation The generation passed to doSearch().
+     * @param resultNode The node containing the results, a node without an ID if nothing has been found.
+     */
+    void searchCompleted(int generation, const MediaNode &resultNode);
+
+    /**
+     * @brief Takes the nodes of a result page loaded by doLoadResultPage(), dropped if a newer search has been started.
+     * @param generation The generation passed to doLoadResultPage().
+     * @param offset The offset of the first node in the result.
+     * @param mediaNodes The nodes, fewer than pageSize() at the end of the result.
+     */
+    void resultPageLoaded(int generation, int offset, const QList<MediaNode> &mediaNodes);
+
 private:
     class Private;
     Private *d;
@@ -28,6 +28,8 @@ SOURCES += \
 	$$PWD/SettingsModels.cpp \
 	$$PWD/SourcesModel.cpp \
 	$$PWD/SqlQueryModel.cpp \
+	$$PWD/SqlQueryService.cpp \
+	$$PWD/SqlResult.cpp \
 	$$PWD/SqlTableModel.cpp \
 	$$PWD/Theme.cpp \
 	$$PWD/User.cpp \
@@ -40,6 +42,7 @@ SOURCES += \
 	$$PWD/mediaplayer/MediaSource.cpp \
 	$$PWD/mediaplayer/TypeConverter.cpp \
 	qnxcar/mediaplayer/MediaNodeModel.cpp \
+	qnxcar/mediaplayer/MediaNodeStore.cpp \
 	qnxcar/mediaplayer/BrowseModel.cpp \
 	qnxcar/mediaplayer/Metadata.cpp \
 	qnxcar/mediaplayer/Track.cpp \
@@ -101,6 +104,8 @@ HEADERS += \
 	$$PWD/SourcesModel.h \
 	$$PWD/SqlQueryModel.h \
 	$$PWD/SqlQueryModel_p.h \
+	$$PWD/SqlQueryService.h \
+	$$PWD/SqlResult.h \
 	$$PWD/SqlTableModel.h \
 	$$PWD/SqlTableModel_p.h \
 	$$PWD/Theme.h \
@@ -122,6 +127,7 @@ HEADERS += \
 	$$PWD/mediaplayer/MediaSourceType.h \
 	$$PWD/mediaplayer/TypeConverter.h \
 	qnxcar/mediaplayer/MediaNodeModel.h \
+	qnxcar/mediaplayer/MediaNodeStore_p.h \
 	qnxcar/mediaplayer/BrowseModel.h \
 	qnxcar/mediaplayer/Metadata.h \
 	qnxcar/mediaplayer/Track.h \
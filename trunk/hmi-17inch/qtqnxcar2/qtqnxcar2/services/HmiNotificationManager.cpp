@@ -9,9 +9,12 @@
 
 #include <QDebug>
 
-#include "qpps/dirwatcher.h"
+#include <qpps/servicewaiter.h>
 
 namespace QnxCar {
+static const QString ppsMessagingPath = QStringLiteral("/pps/services/hmi-notification/Messaging");
+static const QString ppsStatusPath = QStringLiteral("/pps/services/hmi-notification/Status");
+
 /**
  * Static function to convert incoming state values from PPS
  * to the proper state ennumerations supported by the HmiNotificationManager service
@@ -55,14 +58,15 @@ HmiNotificationManager::Private::Private(HmiNotificationManager *qq)
     : QObject(qq)
     , q(qq)
 {
-    m_ppsObjectDirWatcher = new QPps::DirWatcher(QStringLiteral("/pps/services/hmi-notification"), this);
+    m_ppsServiceWaiter = new QPps::ServiceWaiter(QStringList() << ppsMessagingPath << ppsStatusPath, this);
 
-    connect(m_ppsObjectDirWatcher, &QPps::DirWatcher::objectAdded, this, &Private::connectPPSObjects);
+    // the objects are used independently, connect to each as soon as it exists
+    connect(m_ppsServiceWaiter, &QPps::ServiceWaiter::objectReady, this, &Private::connectPPSObjects);
 }
-void HmiNotificationManager::Private::connectPPSObjects(const QString &object){
+void HmiNotificationManager::Private::connectPPSObjects(const QString &objectPath){
 
-    if(object == QStringLiteral("Messaging")){
-        m_ppsMessageObject = new QPps::Object(QStringLiteral("/pps/services/hmi-notification/Messaging"),
+    if(objectPath == ppsMessagingPath){
+        m_ppsMessageObject = new QPps::Object(ppsMessagingPath,
                                                 QPps::Object::PublishAndSubscribeMode, false, this);
         if (m_ppsMessageObject->isValid()) {
             connect(m_ppsMessageObject, SIGNAL(attributeChanged(QString,QPps::Variant)),
@@ -72,8 +76,8 @@ void HmiNotificationManager::Private::connectPPSObjects(const QString &object){
             qWarning() << Q_FUNC_INFO << "Could not open PPS object:" << m_ppsMessageObject->errorString();
         }
 
-    }else if(object == QStringLiteral("Status")){
-        m_ppsStatusObject = new QPps::Object(QStringLiteral("/pps/services/hmi-notification/Status"),
+    }else if(objectPath == ppsStatusPath){
+        m_ppsStatusObject = new QPps::Object(ppsStatusPath,
                                               QPps::Object::SubscribeMode, true, this);
         if (m_ppsStatusObject->isValid()) {
             connect(m_ppsStatusObject, SIGNAL(attributeChanged(QString,QPps::Variant)),
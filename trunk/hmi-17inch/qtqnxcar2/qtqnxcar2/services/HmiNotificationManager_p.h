@@ -5,7 +5,7 @@
 
 #include <qpps/object.h>
 
-#include "qpps/dirwatcher.h"
+#include <qpps/servicewaiter.h>
 
 namespace QnxCar {
 
@@ -28,10 +28,10 @@ public:
      */
     QPps::Object *m_ppsStatusObject;
     /**
-     * @brief m_ppsObjectDirWatcher
-     * member variable for the HNM pps directory watcher
+     * @brief m_ppsServiceWaiter
+     * member variable waiting for the HNM pps objects
      */
-    QPps::DirWatcher *m_ppsObjectDirWatcher;
+    QPps::ServiceWaiter *m_ppsServiceWaiter;
 
 
 private Q_SLOTS:
@@ -57,10 +57,10 @@ private Q_SLOTS:
     /**
      * @brief connectPPSObjects
      * function to notify when the pps objects are created on the system allowing us to bind to them
-     * @param object
-     * Name of the created pps object
+     * @param objectPath
+     * Path of the created pps object
      */
-    void connectPPSObjects(const QString &object);
+    void connectPPSObjects(const QString &objectPath);
 
 };
 
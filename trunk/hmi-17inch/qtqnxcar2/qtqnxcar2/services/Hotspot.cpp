@@ -28,49 +28,45 @@ namespace QnxCar {
         m_securityType = QStringLiteral("wpa_mixed"); // TODO fix it, currently hardcoded
         m_band = QStringLiteral("bg");
 
-        m_ppsServicesDirWatcher = new QPps::DirWatcher(QStringLiteral("/pps/services/tethering"), this);
-        connect(m_ppsServicesDirWatcher, &QPps::DirWatcher::objectAdded, this, &HotSpot::initPPS);
+        m_ppsServiceWaiter = new QPps::ServiceWaiter(QStringList() << QStringLiteral("/pps/services/tethering/control")
+                                                                   << QStringLiteral("/pps/services/tethering/status"), this);
+        connect(m_ppsServiceWaiter, &QPps::ServiceWaiter::ready, this, &HotSpot::initPPS);
     }
 
-    void HotSpot::initPPS(const QString &object) {
+    void HotSpot::initPPS() {
 
-       if (object == QStringLiteral("control")){
-           // Delete the dir watcher since it's no longer needed (this also disconnects any signal connections)
-           m_ppsServicesDirWatcher->deleteLater();
+        // initialise PPS objects
+        this->m_tm_ppsControlObject = new QPps::Object(QStringLiteral("/pps/services/tethering/control"),QPps::Object::PublishAndSubscribeMode, false, this);
+        this->m_tm_ppsStatusObject = new QPps::Object(QStringLiteral("/pps/services/tethering/status"),QPps::Object::PublishAndSubscribeMode, false, this);
 
-           // initialise PPS objects
-           this->m_tm_ppsControlObject = new QPps::Object(QStringLiteral("/pps/services/tethering/control"),QPps::Object::PublishAndSubscribeMode, false, this);
-           this->m_tm_ppsStatusObject = new QPps::Object(QStringLiteral("/pps/services/tethering/status"),QPps::Object::PublishAndSubscribeMode, false, this);
+        if (this->m_tm_ppsControlObject->isValid()) {
+            connect(this->m_tm_ppsControlObject, SIGNAL(attributesChanged(QPps::Changeset)),this, SLOT(ppsTetherManReply(QPps::Changeset)));
+            this->m_tm_ppsControlObject->setAttributeCacheEnabled(true);
 
-           if (this->m_tm_ppsControlObject->isValid()) {
-                connect(this->m_tm_ppsControlObject, SIGNAL(attributesChanged(QPps::Changeset)),this, SLOT(ppsTetherManReply(QPps::Changeset)));
-                this->m_tm_ppsControlObject->setAttributeCacheEnabled(true);
+            if (this->m_tm_ppsStatusObject->isValid()) {
+                connect(this->m_tm_ppsStatusObject, SIGNAL(attributeChanged(QString,QPps::Variant)),
+                        this, SLOT(ppsTetherManStatusChanged(QString,QPps::Variant)));
+                this->m_tm_ppsStatusObject->setAttributeCacheEnabled(true);
 
-                if (this->m_tm_ppsStatusObject->isValid()) {
-                    connect(this->m_tm_ppsStatusObject, SIGNAL(attributeChanged(QString,QPps::Variant)),
-                            this, SLOT(ppsTetherManStatusChanged(QString,QPps::Variant)));
-                    this->m_tm_ppsStatusObject->setAttributeCacheEnabled(true);
+                // all good - service is available
+                setAvailable(true);
 
-                    // all good - service is available
-                    setAvailable(true);
-
-                    // check the operational status of TetherMan
-                    if(this->m_tm_ppsStatusObject->attribute(QString::fromLatin1(PPS_STATE_KEY)).toString() == QString::fromLatin1("ACTIVE")) {
-                        setEnabled(true);
-                    } else {
-                        setEnabled(false);
-                    }
-
-                    retrieveProfile();
+                // check the operational status of TetherMan
+                if(this->m_tm_ppsStatusObject->attribute(QString::fromLatin1(PPS_STATE_KEY)).toString() == QString::fromLatin1("ACTIVE")) {
+                    setEnabled(true);
                 } else {
-                    qWarning() << Q_FUNC_INFO << "Could not open PPS object:" << this->m_tm_ppsStatusObject->errorString();
-                    setAvailable(false);
+                    setEnabled(false);
                 }
 
+                retrieveProfile();
             } else {
-                qWarning() << Q_FUNC_INFO << "Could not open PPS object:" << this->m_tm_ppsControlObject->errorString();
+                qWarning() << Q_FUNC_INFO << "Could not open PPS object:" << this->m_tm_ppsStatusObject->errorString();
                 setAvailable(false);
             }
+
+        } else {
+            qWarning() << Q_FUNC_INFO << "Could not open PPS object:" << this->m_tm_ppsControlObject->errorString();
+            setAvailable(false);
         }
     }
 
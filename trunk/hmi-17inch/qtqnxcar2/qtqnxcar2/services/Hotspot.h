@@ -4,7 +4,7 @@
 #include "Wifi.h"
 
 #include <qpps/object.h>
-#include "qpps/dirwatcher.h"
+#include "qpps/servicewaiter.h"
 
 #include <QObject>
 
@@ -53,7 +53,7 @@ namespace QnxCar {
     private:
         QPps::Object *m_tm_ppsControlObject;                // tetherman control object (server mode)
         QPps::Object *m_tm_ppsStatusObject;                 // tetherman status
-        QPps::DirWatcher *m_ppsServicesDirWatcher;          // dirwatcher to monitor if control object available
+        QPps::ServiceWaiter *m_ppsServiceWaiter;            // waits for the control and status objects
 
         bool m_available;                                   // if service available or not
 
@@ -100,11 +100,10 @@ namespace QnxCar {
         void stopTethering();
 
         /**
-         * Function initialises PPS if "control" object available
+         * Function initialises PPS once the "control" and "status" objects are available
          * @brief initialises PPS
-         * @param object PPS object name
          */
-        void initPPS(const QString &object);
+        void initPPS();
 
     public:
         /**
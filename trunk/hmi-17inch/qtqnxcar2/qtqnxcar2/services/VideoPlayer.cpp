@@ -50,7 +50,7 @@ VideoPlayer::Private::Private(VideoPlayer *qq)
     , m_ppsInputObject(0)
     , m_ppsStateObject(0)
     , m_ppsStatusObject(0)
-    , m_contextDirWatcher(0)
+    , m_metadataWaiter(0)
     , m_metadata(0)
     , m_videoOutputId(-1)
     , m_audioOutputId(-1)
@@ -197,44 +197,39 @@ void VideoPlayer::Private::initStatusMonitor()
     //Opening m_metadata in subscribe mode creates the file if not already present
     //metadata is created and deleted as videos are played/stopped though, and mm-renderer
     //doesn't like it when the metadata file already exists at the time it creates it.
-    //So we monitor the directory and create and destroy the metadata object as needed.
-    m_contextDirWatcher = new QPps::DirWatcher(ppsContextPath, this);
-    connect(m_contextDirWatcher, &QPps::DirWatcher::objectAdded, this, &Private::contextObjectAdded);
-    connect(m_contextDirWatcher, &QPps::DirWatcher::objectRemoved, this, &Private::contextObjectRemoved);
+    //So we watch for the object and create and destroy the metadata object as needed.
+    m_metadataWaiter = new QPps::ServiceWaiter(ppsContextPath + QStringLiteral("/metadata"), this);
+    m_metadataWaiter->setSingleShot(false);
+    connect(m_metadataWaiter, &QPps::ServiceWaiter::ready, this, &Private::metadataObjectAdded);
+    connect(m_metadataWaiter, &QPps::ServiceWaiter::lost, this, &Private::metadataObjectRemoved);
 }
 
-void VideoPlayer::Private::contextObjectAdded(const QString &object)
+void VideoPlayer::Private::metadataObjectAdded()
 {
-    if (object == QStringLiteral("metadata"))
-    {
-        Q_ASSERT(!m_metadata);
-        m_metadata = new RendererMetadata(q->contextName(), this);
-        connect(m_metadata, &RendererMetadata::videoWidthChanged, q, &VideoPlayer::videoPhysicalWidthChanged);
-        connect(m_metadata, &RendererMetadata::videoHeightChanged, q, &VideoPlayer::videoPhysicalHeightChanged);
-        connect(m_metadata, &RendererMetadata::videoPixelWidthChanged, q, &VideoPlayer::videoPixelWidthChanged);
-        connect(m_metadata, &RendererMetadata::videoPixelHeightChanged, q, &VideoPlayer::videoPixelHeightChanged);
-        connect(m_metadata, &RendererMetadata::durationChanged, q, &VideoPlayer::durationChanged);
-        q->videoPhysicalWidthChanged(m_metadata->videoWidth());
-        q->videoPhysicalHeightChanged(m_metadata->videoHeight());
-        q->videoPixelWidthChanged(m_metadata->videoPixelWidth());
-        q->videoPixelHeightChanged(m_metadata->videoPixelHeight());
-        q->durationChanged(m_metadata->duration());
-    }
+    Q_ASSERT(!m_metadata);
+    m_metadata = new RendererMetadata(q->contextName(), this);
+    connect(m_metadata, &RendererMetadata::videoWidthChanged, q, &VideoPlayer::videoPhysicalWidthChanged);
+    connect(m_metadata, &RendererMetadata::videoHeightChanged, q, &VideoPlayer::videoPhysicalHeightChanged);
+    connect(m_metadata, &RendererMetadata::videoPixelWidthChanged, q, &VideoPlayer::videoPixelWidthChanged);
+    connect(m_metadata, &RendererMetadata::videoPixelHeightChanged, q, &VideoPlayer::videoPixelHeightChanged);
+    connect(m_metadata, &RendererMetadata::durationChanged, q, &VideoPlayer::durationChanged);
+    q->videoPhysicalWidthChanged(m_metadata->videoWidth());
+    q->videoPhysicalHeightChanged(m_metadata->videoHeight());
+    q->videoPixelWidthChanged(m_metadata->videoPixelWidth());
+    q->videoPixelHeightChanged(m_metadata->videoPixelHeight());
+    q->durationChanged(m_metadata->duration());
 }
 
-void VideoPlayer::Private::contextObjectRemoved(const QString &object)
+void VideoPlayer::Private::metadataObjectRemoved()
 {
-    if (object == QStringLiteral("metadata"))
-    {
-        Q_ASSERT(m_metadata);
-        delete m_metadata;
-        m_metadata = 0;
-        q->videoPhysicalWidthChanged(0);
-        q->videoPhysicalHeightChanged(0);
-        q->videoPixelWidthChanged(0);
-        q->videoPixelHeightChanged(0);
-        q->durationChanged(0);
-    }
+    Q_ASSERT(m_metadata);
+    delete m_metadata;
+    m_metadata = 0;
+    q->videoPhysicalWidthChanged(0);
+    q->videoPhysicalHeightChanged(0);
+    q->videoPixelWidthChanged(0);
+    q->videoPixelHeightChanged(0);
+    q->durationChanged(0);
 }
 
 void VideoPlayer::Private::destroyStatusMonitor()
@@ -249,8 +244,8 @@ void VideoPlayer::Private::destroyStatusMonitor()
     m_ppsStateObject = 0;
     delete m_ppsStatusObject;
     m_ppsStatusObject = 0;
-    delete m_contextDirWatcher;
-    m_contextDirWatcher = 0;
+    delete m_metadataWaiter;
+    m_metadataWaiter = 0;
     delete m_metadata;
     m_metadata = 0;
 }
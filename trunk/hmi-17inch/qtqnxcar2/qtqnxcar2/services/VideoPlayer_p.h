@@ -10,8 +10,8 @@
 #include <QVector>
 
 #include <qpps/changeset.h>
-#include <qpps/dirwatcher.h>
 #include <qpps/object.h>
+#include <qpps/servicewaiter.h>
 
 class QDebug;
 
@@ -45,7 +45,7 @@ public:
     QPps::Object *m_ppsStateObject;
     QPps::Object *m_ppsStatusObject;
 
-    QPps::DirWatcher *m_contextDirWatcher;
+    QPps::ServiceWaiter *m_metadataWaiter;
     RendererMetadata *m_metadata;
 
     QString m_windowGroup;
@@ -85,8 +85,8 @@ private Q_SLOTS:
     void handleVideoOutputAttached(QnxCar::ControlCommand *cmd);
     void handleAudioOutputAttached(QnxCar::ControlCommand *cmd);
 
-    void contextObjectAdded(const QString &object);
-    void contextObjectRemoved(const QString &object);
+    void metadataObjectAdded();
+    void metadataObjectRemoved();
 
 private:
     int m_videoOutputId;
@@ -23,61 +23,57 @@ static const char* WIFI_KEY_MNGT_WPA_PSK = "WPA-PSK";
 
 Wifi::Private::Private(Wifi *qq):QObject(qq),  m_available(false),q(qq) {
     accessPoints = new WifiAPModel(q->parent());
-    m_ppsServicesDirWatcher = new QPps::DirWatcher(QStringLiteral("/pps/services/wifi"), this);
-    connect(m_ppsServicesDirWatcher, &QPps::DirWatcher::objectAdded, this, &Private::initPPS);
+    m_ppsServiceWaiter = new QPps::ServiceWaiter(QStringList() << QStringLiteral("/pps/services/wifi/control")
+                                                               << QStringLiteral("/pps/services/wifi/status"), this);
+    connect(m_ppsServiceWaiter, &QPps::ServiceWaiter::ready, this, &Private::initPPS);
 }
 
-void Wifi::Private::initPPS(const QString &object) {
-     if (object == QStringLiteral("control")){
-        // Delete the dir watcher since it's no longer needed (this also disconnects any signal connections)
-        m_ppsServicesDirWatcher->deleteLater();
+void Wifi::Private::initPPS() {
+    // setup scan timer
+    scanTimer = new QTimer(this);
+    connect(scanTimer, SIGNAL(timeout()), this, SLOT(onTimer()));
 
-        // setup scan timer
-        scanTimer = new QTimer(this);
-        connect(scanTimer, SIGNAL(timeout()), this, SLOT(onTimer()));
+    this->m_wf_ppsControlObject = new QPps::Object(QStringLiteral("/pps/services/wifi/control"),QPps::Object::PublishAndSubscribeMode, false, this);
+    this->m_wf_ppsStatusObject = new QPps::Object(QStringLiteral("/pps/services/wifi/status"),QPps::Object::PublishAndSubscribeMode, false, this);
 
-        this->m_wf_ppsControlObject = new QPps::Object(QStringLiteral("/pps/services/wifi/control"),QPps::Object::PublishAndSubscribeMode, false, this);
-        this->m_wf_ppsStatusObject = new QPps::Object(QStringLiteral("/pps/services/wifi/status"),QPps::Object::PublishAndSubscribeMode, false, this);
+    if (this->m_wf_ppsControlObject->isValid()) {
 
-        if (this->m_wf_ppsControlObject->isValid()) {
+        if (this->m_wf_ppsStatusObject->isValid()) {
 
-            if (this->m_wf_ppsStatusObject->isValid()) {
+            connect(m_wf_ppsStatusObject, SIGNAL(attributeChanged(QString,QPps::Variant)),
+                    this, SLOT(ppsStatusAttributeChanged(QString,QPps::Variant)));
 
-                connect(m_wf_ppsStatusObject, SIGNAL(attributeChanged(QString,QPps::Variant)),
-                        this, SLOT(ppsStatusAttributeChanged(QString,QPps::Variant)));
+            this->m_wf_ppsStatusObject->setAttributeCacheEnabled(true);
 
-                this->m_wf_ppsStatusObject->setAttributeCacheEnabled(true);
-
-                if(this->m_wf_ppsStatusObject->attribute(QString::fromLatin1(PPS_WIFI_POWER_KEY)).toString() == QString::fromLatin1("on")) {
-                    m_powered = true;
-                    doScan();
-                } else if(this->m_wf_ppsStatusObject->attribute(QString::fromLatin1(PPS_WIFI_POWER_KEY)).toString() == QString::fromLatin1("off")) {
-                    m_powered = false;
-                }
+            if(this->m_wf_ppsStatusObject->attribute(QString::fromLatin1(PPS_WIFI_POWER_KEY)).toString() == QString::fromLatin1("on")) {
+                m_powered = true;
+                doScan();
+            } else if(this->m_wf_ppsStatusObject->attribute(QString::fromLatin1(PPS_WIFI_POWER_KEY)).toString() == QString::fromLatin1("off")) {
+                m_powered = false;
+            }
 
-                if(this->m_wf_ppsStatusObject->attribute(QString::fromLatin1(PPS_WIFI_CONNECTED_KEY)).toString() == QString::fromLatin1("true")) {
-                    m_connected = true;
-                    QPps::Variant attribute = this->m_wf_ppsStatusObject->attribute(QString::fromLatin1(PPS_WIFI_STATUS_KEY));
-                    if(attribute.isValid()) {
-                        processStatusResult(attribute);
-                    }
-                } else if(this->m_wf_ppsStatusObject->attribute(QString::fromLatin1(PPS_WIFI_POWER_KEY)).toString() == QString::fromLatin1("false")) {
-                    m_connected = false;
+            if(this->m_wf_ppsStatusObject->attribute(QString::fromLatin1(PPS_WIFI_CONNECTED_KEY)).toString() == QString::fromLatin1("true")) {
+                m_connected = true;
+                QPps::Variant attribute = this->m_wf_ppsStatusObject->attribute(QString::fromLatin1(PPS_WIFI_STATUS_KEY));
+                if(attribute.isValid()) {
+                    processStatusResult(attribute);
                 }
-
-                // all good - service is available
-                setAvailable(true);
-            } else {
-                qWarning() << Q_FUNC_INFO << "Could not open PPS object:" << this->m_wf_ppsStatusObject->errorString();
-                setAvailable(false);
+            } else if(this->m_wf_ppsStatusObject->attribute(QString::fromLatin1(PPS_WIFI_POWER_KEY)).toString() == QString::fromLatin1("false")) {
+                m_connected = false;
             }
+
+            // all good - service is available
+            setAvailable(true);
         } else {
-            qWarning() << Q_FUNC_INFO << "Could not open PPS object:" << this->m_wf_ppsControlObject->errorString();
+            qWarning() << Q_FUNC_INFO << "Could not open PPS object:" << this->m_wf_ppsStatusObject->errorString();
             setAvailable(false);
         }
+    } else {
+        qWarning() << Q_FUNC_INFO << "Could not open PPS object:" << this->m_wf_ppsControlObject->errorString();
+        setAvailable(false);
+    }
 
-        this->m_messageId = 0;
-     }
+    this->m_messageId = 0;
 }
 
 void Wifi::Private::ppsStatusAttributeChanged(const QString &name, const QPps::Variant &attribute) {
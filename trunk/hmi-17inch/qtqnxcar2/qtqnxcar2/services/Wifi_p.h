@@ -2,7 +2,7 @@
 #define WIFI_P_H
 
 #include <qpps/object.h>
-#include "qpps/dirwatcher.h"
+#include <qpps/servicewaiter.h>
 #include "pps/ControlCommand.h"
 
 #include "Wifi.h"
@@ -18,7 +18,7 @@ class QnxCar::Wifi::Private : public QObject
 
     QPps::Object *m_wf_ppsControlObject;        // wifi control PPS obect
     QPps::Object *m_wf_ppsStatusObject;         // wifi status PPS object
-    QPps::DirWatcher *m_ppsServicesDirWatcher;  // dirwatcher to monitor if control object available
+    QPps::ServiceWaiter *m_ppsServiceWaiter;    // waits for the control and status objects
 
     int m_messageId;                            // current message id
 
@@ -39,7 +39,7 @@ class QnxCar::Wifi::Private : public QObject
     WifiAPModel* accessPoints;
 
     /* initiates PPS objects*/
-    void initPPS(const QString &object);
+    void initPPS();
     /* Intiates wifi  and power it up*/
     void doStart();
     /* Powers WIFI system down*/
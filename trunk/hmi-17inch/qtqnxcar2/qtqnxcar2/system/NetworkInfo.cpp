@@ -2,6 +2,7 @@
 
 #include <qpps/changeset.h>
 #include <qpps/object.h>
+#include <qpps/servicewaiter.h>
 #include <unistd.h>
 
 #include <QDebug>
@@ -12,8 +13,6 @@
 #include <QRegularExpressionMatch>
 #include <QStringList>
 
-#include <QDateTime>
-
 namespace {
 static const QString networkControlDir = QStringLiteral("/pps/services/networking/control");
 static const QString networkInterfacesDir = QStringLiteral("/pps/services/networking/all/interfaces/");
@@ -49,7 +48,7 @@ namespace QnxCar {
 class NetworkInfo::Private
 {
 public:
-    Private() : dhcp(true), networkInfo(0) {}
+    Private() : dhcp(true), networkInfo(0), networkControl(0), interfaceWaiter(0) {}
 
     QString ipAddress;
     QString netmask;
@@ -58,84 +57,62 @@ public:
     QPps::Object *networkInfo;
     QPps::Object *networkControl;
     QString interfaceIdentifier;
+    /// Waits for the object of the default interface
+    QPps::ServiceWaiter *interfaceWaiter;
 };
 
 NetworkInfo::NetworkInfo(QObject *parent)
     : QObject(parent)
     , d(new Private)
 {
-   QString sFilePath = QStringLiteral( "/var/lognet.txt");
-   file = new QFile(sFilePath);
-
-    connect(&m_timer,SIGNAL(timeout()),this,SLOT(myTimerProcess()));
-    m_timer.start(18000);
+    // the networking service comes up late on a slow boot
+    QPps::ServiceWaiter *serviceWaiter = new QPps::ServiceWaiter(QStringList() << networkInfoDir << networkControlDir, this);
+    connect(serviceWaiter, SIGNAL(ready()), this, SLOT(openServiceObjects()));
 }
 
 NetworkInfo::~NetworkInfo()
 {
-    delete file;
     delete d;
 }
-void NetworkInfo::myTimerProcess()
+
+void NetworkInfo::openServiceObjects()
 {
-    if (!file->open(QIODevice::WriteOnly|QIODevice::Append)) {
-        //QMessageBox::critical(NULL, "提示", "无法创建文件");
-        // return -1;
+    QPps::Object *networkInfo = new QPps::Object(networkInfoDir, QPps::Object::SubscribeMode, true, this);
+    if (networkInfo->isValid()) {
+        networkInfo->setAttributeCacheEnabled(true);
+        connect(networkInfo, SIGNAL(attributeChanged(QString,QPps::Variant)), this, SLOT(updateInterfaceInfo(QString,QPps::Variant)));
+
+        waitForInterface(networkInfo->attribute(QLatin1Literal(pps_defaultInterfaceKey)).toString());
+    } else {
+        qWarning() << Q_FUNC_INFO << "Could not open PPS object:" << networkInfo->errorString();
     }
-    QTextStream out(file);
-    QTime current_time ;
-    current_time = QTime::currentTime();
-    int hournow = current_time.hour();//当前的小时
-    int minutenow = current_time.minute();//当前的分
-    int secondnow = current_time.second();//当前的秒
-    int msecnow = current_time.msec();//当前的毫秒
-    out << "NetworkInfoFirst:" << hournow << ":"<<minutenow << ":"<<secondnow << ":"<< msecnow << endl;
-    if(QFile::exists(networkInfoDir))
-    {
-        if(QFile::exists(networkControlDir))
-        {
-            m_timer.stop();
-            //方式：Append为追加，WriteOnly，ReadOnly
-
-            QTime current_time ;
-            current_time = QTime::currentTime();
-            int hournow = current_time.hour();//当前的小时
-            int minutenow = current_time.minute();//当前的分
-            int secondnow = current_time.second();//当前的秒
-            int msecnow = current_time.msec();//当前的毫秒
-            out << "NetworkInfo1:" << hournow << ":"<<minutenow << ":"<<secondnow << ":"<< msecnow << endl;
-            QPps::Object *networkInfo = new QPps::Object(networkInfoDir, QPps::Object::SubscribeMode, true, this);
-            if (networkInfo->isValid())
-            {
-                networkInfo->setAttributeCacheEnabled(true);
-                connect(networkInfo, SIGNAL(attributeChanged(QString,QPps::Variant)), this, SLOT(updateInterfaceInfo(QString,QPps::Variant)));
-
-                const QString defaultInterface = networkInfo->attribute(QLatin1Literal(pps_defaultInterfaceKey)).toString();
-
-                while(!QFile::exists(networkInterfacesDir + defaultInterface));
-                updateFromInterface(defaultInterface);
-            }
-
-            d->networkControl = new QPps::Object(networkControlDir, QPps::Object::PublishAndSubscribeMode, true, this);
-            if (!d->networkControl->isValid())
-            {
-                qWarning() << Q_FUNC_INFO << "Could not open PPS object:" << d->networkControl->errorString();
-            } else
-            {
-                connect(d->networkControl, SIGNAL(attributeChanged(QString,QPps::Variant)), this, SLOT(onReply(QString,QPps::Variant)));
-            }
-            current_time = QTime::currentTime();
-            hournow = current_time.hour();//当前的小时
-            minutenow = current_time.minute();//当前的分
-            secondnow = current_time.second();//当前的秒
-            msecnow = current_time.msec();//当前的毫秒
-            out << "NetworkInfo4:" << hournow << ":"<<minutenow << ":"<<secondnow << ":"<< msecnow << endl;
 
-        }
+    d->networkControl = new QPps::Object(networkControlDir, QPps::Object::PublishAndSubscribeMode, true, this);
+    if (!d->networkControl->isValid()) {
+        qWarning() << Q_FUNC_INFO << "Could not open PPS object:" << d->networkControl->errorString();
+    } else {
+        connect(d->networkControl, SIGNAL(attributeChanged(QString,QPps::Variant)), this, SLOT(onReply(QString,QPps::Variant)));
     }
-    out.flush();
-    file->close();
 }
+
+void NetworkInfo::waitForInterface(const QString &identifier)
+{
+    delete d->interfaceWaiter;
+    d->interfaceWaiter = 0;
+
+    if (identifier.isEmpty())
+        return;
+
+    // the status may name the interface before its object is published
+    d->interfaceWaiter = new QPps::ServiceWaiter(networkInterfacesDir + identifier, this);
+    connect(d->interfaceWaiter, SIGNAL(objectReady(QString)), this, SLOT(interfaceReady(QString)));
+}
+
+void NetworkInfo::interfaceReady(const QString &objectPath)
+{
+    updateFromInterface(objectPath.mid(networkInterfacesDir.length()));
+}
+
 QString NetworkInfo::ipAddress() const
 {
     return d->ipAddress;
@@ -213,7 +190,7 @@ void NetworkInfo::updateNetworkInfo(const QString &attribute, const QPps::Varian
 void NetworkInfo::updateInterfaceInfo(const QString &attribute, const QPps::Variant &value)
 {
     if (attribute == QString::fromLatin1(pps_defaultInterfaceKey))
-        updateFromInterface(value.toString());
+        waitForInterface(value.toString());
 }
 
 void NetworkInfo::setStaticNetworkConfig(const QString &ipAddress,const QString &netmask,const QString &gateway) {
@@ -269,7 +246,7 @@ void NetworkInfo::setDhcp(bool dhcp)
 }
 
 void NetworkInfo::connectNetwork(const QString &ipAddress,const QString &netmask,const QString &gateway) {
-    if (d->networkControl->isValid()) {
+    if (d->networkControl && d->networkControl->isValid()) {
         QJsonObject json;
         QJsonArray jsonDat;
 
@@ -308,7 +285,7 @@ void NetworkInfo::connectNetwork(const QString &ipAddress,const QString &netmask
 }
 
 void NetworkInfo::disconnectNetwork(){
-    if (d->networkControl->isValid()) {
+    if (d->networkControl && d->networkControl->isValid()) {
         // hardcoded payload for now
         QPps::Changeset changeset;
         changeset.assignments.clear();
@@ -5,8 +5,7 @@
 
 #include "pps/ControlCommand.h"
 #include "qtqnxcar2_export.h"
-#include <QTimer>
-#include <QFile>
+
 namespace QPps {
 class Variant;
 }
@@ -127,9 +126,13 @@ private slots:
     void updateNetworkInfo(const QString &attribute, const QPps::Variant &value);
     void updateInterfaceInfo(const QString &attribute, const QPps::Variant &value);
     void onReply(const QString &attribute, const QPps::Variant &value);
-    void myTimerProcess();
+    /// Opens the status and control objects once the networking service published them
+    void openServiceObjects();
+    void interfaceReady(const QString &objectPath);
 
 private:
+    /// Updates from the interface @p identifier once its object exists
+    void waitForInterface(const QString &identifier);
     void updateFromInterface(const QString &identifier);
     /// #ipAddress
     void setIpAddress(const QString &ipAddress);
@@ -145,8 +148,6 @@ private:
 private:
     class Private;
     Private *const d;
-    QTimer  m_timer;
-    QFile * file;
 };
 
 }
@@ -5,8 +5,12 @@
 #include "qnxcar/MessagesModel.h"
 #include "qnxcar/CallerIDObject.h"
 
+#include <QSignalSpy>
+#include <QSqlError>
+#include <QSqlQuery>
 #include <QSqlRecord>
 #include <QString>
+#include <QTemporaryDir>
 
 using QnxCar::AddressbookModel;
 using QnxCar::DatabaseManager;
@@ -19,8 +23,159 @@ class tst_CommunicationsModels : public QObject
 private Q_SLOTS:
     void testAddressbookModel();
     void testMessagesModel();
+    void testCallerID();
+    void testAddressbookWindow();
+    void testAddressbookDerivedColumns();
+    void benchmarkAddressbookScrolling();
+    void benchmarkAddressbookFirstPaint_data();
+    void benchmarkAddressbookFirstPaint();
+    void benchmarkCallerIDIndex();
+    void benchmarkCallerIDLookup();
+    void testMessagesPaging();
+    void testMessagesFilter();
+    void testMessageBodies();
+    void benchmarkMessagesWindow_data();
+    void benchmarkMessagesWindow();
+
+private:
+    QSqlDatabase createPhonebook(const QString &connectionName);
+    bool addContact(QSqlDatabase &db, const QString &firstName, const QString &lastName,
+                    const QString &homePhone, const QString &workPhone, const QString &mobilePhone);
+    bool addSyntheticContacts(QSqlDatabase &db, int count);
+    QSqlDatabase createMessages(const QString &connectionName, int count);
+
+    QTemporaryDir m_dir;
 };
 
+/// A phonebook with the columns of contacts_view read by AddressbookModel
+QSqlDatabase tst_CommunicationsModels::createPhonebook(const QString &connectionName)
+{
+    QSqlDatabase db = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), connectionName);
+    db.setDatabaseName(m_dir.path() + QLatin1Char('/') + connectionName + QStringLiteral(".db"));
+    if (!db.open())
+        return db;
+
+    QStringList columns;
+    Q_FOREACH (const QByteArray &name, QList<QByteArray>()
+               << "last_name" << "first_name" << "formatted_name" << "birthday" << "anniversary"
+               << "company" << "job_title" << "home_phone" << "home_phone_2" << "work_phone"
+               << "work_phone_2" << "mobile_phone" << "pager_phone" << "fax_phone" << "other_phone"
+               << "email_1" << "email_2" << "email_3" << "home_address_1" << "home_address_2"
+               << "home_address_city" << "home_address_country" << "home_address_state_province"
+               << "home_address_zip_postal" << "work_address_1" << "work_address_2" << "work_address_city"
+               << "work_address_country" << "work_address_state_province" << "work_address_zip_postal"
+               << "picture" << "pin" << "web_page" << "note") {
+        columns << QString::fromLatin1(name) + QStringLiteral(" TEXT");
+    }
+
+    QSqlQuery query(db);
+    if (!query.exec(QStringLiteral("CREATE TABLE contacts_view (contact_id INTEGER PRIMARY KEY, %1)").arg(columns.join(QStringLiteral(", ")))))
+        qWarning() << query.lastError();
+
+    return db;
+}
+
+bool tst_CommunicationsModels::addContact(QSqlDatabase &db, const QString &firstName, const QString &lastName,
+                                          const QString &homePhone, const QString &workPhone, const QString &mobilePhone)
+{
+    QSqlQuery query(db);
+    query.prepare(QStringLiteral("INSERT INTO contacts_view (first_name, last_name, home_phone, work_phone, mobile_phone) "
+                                 "VALUES (:first_name, :last_name, :home_phone, :work_phone, :mobile_phone)"));
+    query.bindValue(QStringLiteral(":first_name"), firstName);
+    query.bindValue(QStringLiteral(":last_name"), lastName);
+    query.bindValue(QStringLiteral(":home_phone"), homePhone);
+    query.bindValue(QStringLiteral(":work_phone"), workPhone);
+    query.bindValue(QStringLiteral(":mobile_phone"), mobilePhone);
+    return query.exec();
+}
+
+/// Adds @p count contacts with a formatted mobile and a plain home number each, all distinct in their last 7 digits
+bool tst_CommunicationsModels::addSyntheticContacts(QSqlDatabase &db, int count)
+{
+    if (!db.transaction())
+        return false;
+
+    for (int i = 0; i < count; ++i) {
+        const QString mobile = QStringLiteral("+1 (613) %1-%2").arg(200 + i / 10000).arg(i % 10000, 4, 10, QLatin1Char('0'));
+        const QString home = QStringLiteral("0049 30 %1").arg(5000000 + i);
+        if (!addContact(db, QStringLiteral("First%1").arg(i), QStringLiteral("Last%1").arg(i), home, QString(), mobile))
+            return false;
+    }
+
+    return db.commit();
+}
+
+/**
+ * A messages database with the columns of messages_view and full_messages_view read by MessagesModel,
+ * filled with @p count messages. Message i (1-based) is an SMS if i % 4 == 1 and an e-mail otherwise,
+ * two messages share each time stamp, so the newest message comes first and has the highest id.
+ * Messages with i % 3 == 0 have no body yet.
+ */
+QSqlDatabase tst_CommunicationsModels::createMessages(const QString &connectionName, int count)
+{
+    QSqlDatabase db = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), connectionName);
+    db.setDatabaseName(m_dir.path() + QLatin1Char('/') + connectionName + QStringLiteral(".db"));
+    if (!db.open())
+        return db;
+
+    QSqlQuery query(db);
+    Q_FOREACH (const QString &statement, QStringList()
+               << QStringLiteral("CREATE TABLE messages_view (message_id INTEGER PRIMARY KEY, handle TEXT, account_id INTEGER, "
+                                 "type TEXT, sender_last_name TEXT, sender_first_name TEXT, sender_email TEXT, "
+                                 "sender_number TEXT, subject TEXT, datetime TEXT)")
+               << QStringLiteral("CREATE INDEX messages_by_datetime ON messages_view (datetime, message_id)")
+               << QStringLiteral("CREATE INDEX messages_by_type ON messages_view (type, datetime, message_id)")
+               << QStringLiteral("CREATE TABLE full_messages_view (message_id INTEGER PRIMARY KEY, handle TEXT, account_id INTEGER, "
+                                 "body_plain_text TEXT, body_html TEXT)")
+               << QStringLiteral("CREATE INDEX full_messages_by_handle ON full_messages_view (handle)")) {
+        if (!query.exec(statement)) {
+            qWarning() << query.lastError();
+            return db;
+        }
+    }
+
+    if (!db.transaction())
+        return db;
+
+    QSqlQuery message(db);
+    message.prepare(QStringLiteral("INSERT INTO messages_view (message_id, handle, account_id, type, sender_number, subject, datetime) "
+                                   "VALUES (?, ?, ?, ?, ?, ?, ?)"));
+    QSqlQuery body(db);
+    body.prepare(QStringLiteral("INSERT INTO full_messages_view (message_id, handle, account_id, body_plain_text, body_html) "
+                                "VALUES (?, ?, ?, ?, ?)"));
+
+    const QDateTime start(QDate(2013, 1, 1), QTime(0, 0));
+    for (int i = 1; i <= count; ++i) {
+        const QString handle = QStringLiteral("handle%1").arg(i);
+        const int accountId = i % 2;
+
+        message.addBindValue(i);
+        message.addBindValue(handle);
+        message.addBindValue(accountId);
+        message.addBindValue(i % 4 == 1 ? QStringLiteral("SMS_GSM") : QStringLiteral("EMAIL"));
+        message.addBindValue(QStringLiteral("+1613555%1").arg(i % 10000, 4, 10, QLatin1Char('0')));
+        message.addBindValue(QStringLiteral("Subject %1").arg(i));
+        message.addBindValue(start.addSecs(i / 2).toString(Qt::ISODate));
+        if (!message.exec()) {
+            qWarning() << message.lastError();
+            return db;
+        }
+
+        body.addBindValue(i);
+        body.addBindValue(handle);
+        body.addBindValue(accountId);
+        body.addBindValue(i % 3 == 0 ? QString() : QStringLiteral("Body %1").arg(i));
+        body.addBindValue(QString());
+        if (!body.exec()) {
+            qWarning() << body.lastError();
+            return db;
+        }
+    }
+
+    db.commit();
+    return db;
+}
+
 void tst_CommunicationsModels::testAddressbookModel()
 {
     QSqlDatabase db = DatabaseManager::database(QStringLiteral("phonebook.db"));;
@@ -134,5 +289,407 @@ void tst_CommunicationsModels::testMessagesModel()
     QCOMPARE(model.data(model.index(0, 0), MessagesModel::AccountIdRole).toInt(), 0);
 }
 
+void tst_CommunicationsModels::testCallerID()
+{
+    QSqlDatabase db = createPhonebook(QStringLiteral("callerid"));
+    QVERIFY(db.isOpen());
+    QVERIFY(addContact(db, QStringLiteral("Ann"), QStringLiteral("Able"), QString(), QString(), QStringLiteral("+1 (613) 555-0101")));
+    // same last 7 digits as Ann's mobile
+    QVERIFY(addContact(db, QStringLiteral("Bob"), QStringLiteral("Baker"), QStringLiteral("0613 5550101"), QString(), QString()));
+    QVERIFY(addContact(db, QStringLiteral("Carl"), QStringLiteral("Clay"), QString(), QStringLiteral("555-0199"), QStringLiteral("+49 30 1234567")));
+
+    AddressbookModel model;
+    model.setDatabase(db);
+
+    // exact matches
+    model.setCallerIDString(QStringLiteral("16135550101"));
+    QCOMPARE(model.callerID()->name(), QStringLiteral("Ann Able"));
+    model.setCallerIDString(QStringLiteral("+1-613-555-0101"));
+    QCOMPARE(model.callerID()->name(), QStringLiteral("Ann Able"));
+    model.setCallerIDString(QStringLiteral("06135550101"));
+    QCOMPARE(model.callerID()->name(), QStringLiteral("Bob Baker"));
+    model.setCallerIDString(QStringLiteral("5550199"));
+    QCOMPARE(model.callerID()->name(), QStringLiteral("Carl Clay"));
+
+    // the last 7 digits identify a single contact
+    model.setCallerIDString(QStringLiteral("030 1234567"));
+    QCOMPARE(model.callerID()->name(), QStringLiteral("Carl Clay"));
+    QCOMPARE(model.callerID()->number(), QStringLiteral("030 1234567"));
+
+    // the last 7 digits are ambiguous
+    model.setCallerIDString(QStringLiteral("0016135550101"));
+    QCOMPARE(model.callerID()->name(), QString());
+
+    // too few digits for a partial match
+    model.setCallerIDString(QStringLiteral("0199"));
+    QCOMPARE(model.callerID()->name(), QString());
+
+    // the index is rebuilt on update
+    QVERIFY(addContact(db, QStringLiteral("Dora"), QStringLiteral("Dunn"), QStringLiteral("0199"), QString(), QString()));
+    model.setCallerIDString(QStringLiteral("0199"));
+    QCOMPARE(model.callerID()->name(), QString());
+    model.update();
+    model.setCallerIDString(QStringLiteral("0199"));
+    QCOMPARE(model.callerID()->name(), QStringLiteral("Dora Dunn"));
+}
+
+void tst_CommunicationsModels::testAddressbookWindow()
+{
+    QSqlDatabase db = createPhonebook(QStringLiteral("window"));
+    QVERIFY(db.isOpen());
+    QVERIFY(addSyntheticContacts(db, 1000));
+
+    AddressbookModel model;
+    model.setBlockSize(50);
+    model.setMaximumResidentBlocks(4);
+    model.setDatabase(db);
+
+    // all rows are known, none has been read yet
+    QCOMPARE(model.rowCount(), 1000);
+    QVERIFY(!model.canFetchMore(QModelIndex()));
+    QCOMPARE(model.residentBlockCount(), 0);
+
+    QCOMPARE(model.data(model.index(0, 0), AddressbookModel::FirstNameRole).toString(), QStringLiteral("First0"));
+    QCOMPARE(model.residentBlockCount(), 1);
+
+    for (int row = 0; row < model.rowCount(); ++row) {
+        QCOMPARE(model.data(model.index(row, 0), AddressbookModel::LastNameRole).toString(), QStringLiteral("Last%1").arg(row));
+        QVERIFY(model.residentBlockCount() <= 4);
+    }
+
+    // an evicted block is read again
+    QCOMPARE(model.data(model.index(10, 0), AddressbookModel::DisplayName).toString(), QStringLiteral("First10 Last10"));
+    QCOMPARE(model.data(model.index(10, 0), Qt::DisplayRole).toInt(), model.data(model.index(10, 0), AddressbookModel::ContactIdRole).toInt());
+
+    // sorted in the database, case insensitively
+    QSignalSpy resetSpy(&model, SIGNAL(modelReset()));
+    QVERIFY(addContact(db, QStringLiteral("first5"), QStringLiteral("last5a"), QString(), QString(), QString()));
+    model.update();
+    QCOMPARE(resetSpy.count(), 1);
+    QCOMPARE(model.rowCount(), 1001);
+
+    model.setSortRole(AddressbookModel::DisplayName);
+    model.sort(0);
+    QCOMPARE(resetSpy.count(), 2);
+    QCOMPARE(model.data(model.index(0, 0), AddressbookModel::DisplayName).toString(), QStringLiteral("First0 Last0"));
+    QCOMPARE(model.data(model.index(2, 0), AddressbookModel::DisplayName).toString(), QStringLiteral("First10 Last10"));
+    // after "First0" and the 111 names starting with each of "First1" to "First4"
+    const int fifth = 1 + 4 * 111;
+    QCOMPARE(model.data(model.index(fifth, 0), AddressbookModel::DisplayName).toString(), QStringLiteral("First5 Last5"));
+    QCOMPARE(model.data(model.index(fifth + 1, 0), AddressbookModel::DisplayName).toString(), QStringLiteral("first5 last5a"));
+
+    model.sort(0, Qt::DescendingOrder);
+    QCOMPARE(model.data(model.index(0, 0), AddressbookModel::DisplayName).toString(), QStringLiteral("First999 Last999"));
+
+    model.setSortRole(AddressbookModel::LastNameRole);
+    QCOMPARE(model.data(model.index(0, 0), AddressbookModel::LastNameRole).toString(), QStringLiteral("Last999"));
+
+    // the order of the database
+    model.sort(-1);
+    QCOMPARE(model.data(model.index(0, 0), AddressbookModel::FirstNameRole).toString(), QStringLiteral("First0"));
+    QCOMPARE(model.data(model.index(1000, 0), AddressbookModel::FirstNameRole).toString(), QStringLiteral("first5"));
+
+    model.clear();
+    QCOMPARE(model.rowCount(), 0);
+    QCOMPARE(model.residentBlockCount(), 0);
+}
+
+void tst_CommunicationsModels::testAddressbookDerivedColumns()
+{
+    QSqlDatabase db = createPhonebook(QStringLiteral("derived"));
+    QVERIFY(db.isOpen());
+
+    QSqlQuery query(db);
+    QVERIFY(query.exec(QStringLiteral(
+        "INSERT INTO contacts_view (first_name, last_name, home_address_1, home_address_city, home_address_country, "
+        "work_address_1, work_address_2, work_address_city, work_address_state_province, work_address_zip_postal) "
+        "VALUES (' Hans ', 'Maulwurf', 'Maulwurfallee 13', 'Berlin', 'Germany', "
+        "'Maulwurfweg 12', 'XYZ54', 'Berlin', 'Berlin', '13131')")));
+    QVERIFY(query.exec(QStringLiteral("INSERT INTO contacts_view (company, home_phone) VALUES ('QNX', '5551234')")));
+    QVERIFY(query.exec(QStringLiteral("INSERT INTO contacts_view (email_2) VALUES ('moleman@simpsons.com')")));
+
+    AddressbookModel model;
+    model.setDatabase(db);
+    QCOMPARE(model.rowCount(), 3);
+
+    QCOMPARE(model.data(model.index(0, 0), AddressbookModel::DisplayName).toString(), QStringLiteral("Hans Maulwurf"));
+    QCOMPARE(model.data(model.index(0, 0), AddressbookModel::FormattedHomeAddress).toString(),
+             QStringLiteral("Maulwurfallee 13\nBerlin, Germany"));
+    QCOMPARE(model.data(model.index(0, 0), AddressbookModel::FormattedWorkAddress).toString(),
+             QStringLiteral("Maulwurfweg 12\nXYZ54\nBerlin, Berlin, 13131"));
+    QCOMPARE(model.data(model.index(1, 0), AddressbookModel::DisplayName).toString(), QStringLiteral("QNX"));
+    QCOMPARE(model.data(model.index(1, 0), AddressbookModel::FormattedHomeAddress).toString(), QString());
+    QCOMPARE(model.data(model.index(2, 0), AddressbookModel::DisplayName).toString(), QStringLiteral("moleman@simpsons.com"));
+
+    // derived again on update
+    QVERIFY(query.exec(QStringLiteral("UPDATE contacts_view SET company = 'BlackBerry' WHERE company = 'QNX'")));
+    QCOMPARE(model.data(model.index(1, 0), AddressbookModel::DisplayName).toString(), QStringLiteral("QNX"));
+    model.update();
+    QCOMPARE(model.data(model.index(1, 0), AddressbookModel::DisplayName).toString(), QStringLiteral("BlackBerry"));
+
+    // the phonebook database is left alone
+    QVERIFY(!db.tables().contains(QStringLiteral("contacts_derived")));
+}
+
+/**
+ * Reads the roles a contacts list delegate shows for each of 10000 contacts, with all of them
+ * resident, so that only the cost of data() is measured.
+ */
+void tst_CommunicationsModels::benchmarkAddressbookScrolling()
+{
+    QSqlDatabase db = createPhonebook(QStringLiteral("scrolling"));
+    QVERIFY(db.isOpen());
+    QVERIFY(addSyntheticContacts(db, 10000));
+
+    AddressbookModel model;
+    model.setMaximumResidentBlocks(0);
+    model.setDatabase(db);
+
+    for (int row = 0; row < model.rowCount(); ++row)
+        model.data(model.index(row, 0), AddressbookModel::ContactIdRole);
+
+    QBENCHMARK {
+        for (int row = 0; row < model.rowCount(); ++row) {
+            const QModelIndex index = model.index(row, 0);
+            model.data(index, AddressbookModel::DisplayName);
+            model.data(index, AddressbookModel::FormattedHomeAddress);
+            model.data(index, AddressbookModel::FormattedWorkAddress);
+            model.data(index, AddressbookModel::MobilePhoneRole);
+        }
+    }
+}
+
+/// Returns the resident set size of the process in kB, 0 where unknown
+static qint64 residentSetSize()
+{
+    QFile status(QStringLiteral("/proc/self/status"));
+    if (!status.open(QIODevice::ReadOnly))
+        return 0;
+
+    Q_FOREACH (const QByteArray &line, status.readAll().split('\n')) {
+        if (line.startsWith("VmRSS:"))
+            return line.mid(6).trimmed().split(' ').first().toLongLong();
+    }
+
+    return 0;
+}
+
+void tst_CommunicationsModels::benchmarkAddressbookFirstPaint_data()
+{
+    QTest::addColumn<int>("contacts");
+
+    QTest::newRow("1k") << 1000;
+    QTest::newRow("10k") << 10000;
+    QTest::newRow("50k") << 50000;
+}
+
+/**
+ * Opens a sorted phonebook and reads the first screen of contacts, like the contacts list does
+ * when it is shown. Then scrolls through all contacts and reports how much stays resident.
+ */
+void tst_CommunicationsModels::benchmarkAddressbookFirstPaint()
+{
+    QFETCH(int, contacts);
+
+    QSqlDatabase db = createPhonebook(QStringLiteral("firstpaint%1").arg(contacts));
+    QVERIFY(db.isOpen());
+    QVERIFY(addSyntheticContacts(db, contacts));
+
+    AddressbookModel model;
+    model.setSortRole(AddressbookModel::DisplayName);
+    model.sort(0);
+
+    QBENCHMARK {
+        model.setDatabase(db);
+        for (int row = 0; row < 10; ++row)
+            model.data(model.index(row, 0), AddressbookModel::DisplayName);
+    }
+
+    QCOMPARE(model.rowCount(), contacts);
+
+    const qint64 sizeBefore = residentSetSize();
+    for (int row = 0; row < model.rowCount(); ++row)
+        model.data(model.index(row, 0), AddressbookModel::DisplayName);
+    const qint64 sizeAfter = residentSetSize();
+
+    QVERIFY(model.residentBlockCount() <= model.maximumResidentBlocks());
+    qDebug() << contacts << "contacts:" << model.residentBlockCount() * model.blockSize() << "resident rows,"
+             << sizeAfter << "kB resident," << (sizeAfter - sizeBefore) << "kB grown while scrolling";
+}
+
+/**
+ * Builds the caller ID index of a synced phonebook with 20000 contacts.
+ */
+void tst_CommunicationsModels::benchmarkCallerIDIndex()
+{
+    QSqlDatabase db = createPhonebook(QStringLiteral("benchmarkindex"));
+    QVERIFY(db.isOpen());
+    QVERIFY(addSyntheticContacts(db, 20000));
+
+    AddressbookModel model;
+    model.setDatabase(db);
+
+    QBENCHMARK {
+        model.update();
+    }
+
+    QCOMPARE(model.rowCount(), 20000);
+}
+
+/**
+ * Looks up incoming calls in a phonebook with 20000 contacts, matching all digits or the last 7.
+ */
+void tst_CommunicationsModels::benchmarkCallerIDLookup()
+{
+    QSqlDatabase db = createPhonebook(QStringLiteral("benchmarklookup"));
+    QVERIFY(db.isOpen());
+    QVERIFY(addSyntheticContacts(db, 20000));
+
+    AddressbookModel model;
+    model.setDatabase(db);
+
+    model.setCallerIDString(QStringLiteral("+16132011234"));
+    QCOMPARE(model.callerID()->name(), QStringLiteral("First11234 Last11234"));
+    model.setCallerIDString(QStringLiteral("030 5019999"));
+    QCOMPARE(model.callerID()->name(), QStringLiteral("First19999 Last19999"));
+
+    QBENCHMARK {
+        for (int i = 0; i < 20000; i += 200) {
+            model.setCallerIDString(QStringLiteral("+1613%1%2").arg(200 + i / 10000).arg(i % 10000, 4, 10, QLatin1Char('0')));
+            model.setCallerIDString(QStringLiteral("030 %1").arg(5000000 + i));
+        }
+    }
+}
+
+void tst_CommunicationsModels::testMessagesPaging()
+{
+    QSqlDatabase db = createMessages(QStringLiteral("paging"), 100000);
+    QVERIFY(db.isOpen());
+
+    MessagesModel model;
+    model.setDatabase(db);
+    QVERIFY(!model.canFetchMore(QModelIndex()));
+    QCOMPARE(model.rowCount(), 100000);
+    QCOMPARE(model.residentPageCount(), 0);
+
+    // across several page bounds, including messages sharing a time stamp
+    for (int row = 0; row < 3 * model.pageSize() + 7; ++row)
+        QCOMPARE(model.data(model.index(row, 0), MessagesModel::MessageIdRole).toInt(), 100000 - row);
+
+    // jumps, from the last known page bound and from the end
+    QCOMPARE(model.data(model.index(50000, 0), MessagesModel::MessageIdRole).toInt(), 50000);
+    QCOMPARE(model.data(model.index(99999, 0), MessagesModel::MessageIdRole).toInt(), 1);
+    QCOMPARE(model.data(model.index(99999, 0), MessagesModel::SubjectRole).toString(), QStringLiteral("Subject 1"));
+    QCOMPARE(model.data(model.index(99999, 0), MessagesModel::DateTimeRole).toDateTime(), QDateTime(QDate(2013, 1, 1), QTime(0, 0)));
+    QCOMPARE(model.data(model.index(70001, 0), MessagesModel::MessageIdRole).toInt(), 29999);
+    QCOMPARE(model.data(model.index(50049, 0), MessagesModel::MessageIdRole).toInt(), 49951);
+    QCOMPARE(model.data(model.index(49999, 0), MessagesModel::MessageIdRole).toInt(), 50001);
+
+    QVERIFY(model.residentPageCount() <= model.maximumResidentPages());
+
+    QCOMPARE(model.data(model.index(100000, 0), MessagesModel::MessageIdRole), QVariant());
+
+    model.clear();
+    QCOMPARE(model.rowCount(), 0);
+    QCOMPARE(model.residentPageCount(), 0);
+}
+
+void tst_CommunicationsModels::testMessagesFilter()
+{
+    QSqlDatabase db = createMessages(QStringLiteral("filter"), 100000);
+    QVERIFY(db.isOpen());
+
+    MessagesModel model;
+    model.setDatabase(db);
+    QCOMPARE(model.messageCount(MessagesModel::SMS), 25000);
+    QCOMPARE(model.messageCount(MessagesModel::EMail), 75000);
+
+    model.setFilterMessageType(MessagesModel::SMS);
+    QCOMPARE(model.rowCount(), 25000);
+    QCOMPARE(model.data(model.index(0, 0), MessagesModel::MessageIdRole).toInt(), 99997);
+    QCOMPARE(model.data(model.index(0, 0), MessagesModel::TypeRole).toInt(), static_cast<int>(MessagesModel::SMS));
+    QCOMPARE(model.data(model.index(12345, 0), MessagesModel::MessageIdRole).toInt(), 99997 - 4 * 12345);
+    QCOMPARE(model.data(model.index(24999, 0), MessagesModel::MessageIdRole).toInt(), 1);
+
+    model.addFilterMessageType(MessagesModel::EMail);
+    QCOMPARE(model.rowCount(), 100000);
+    QCOMPARE(model.data(model.index(3, 0), MessagesModel::MessageIdRole).toInt(), 99997);
+
+    model.setFilterMessageType(MessagesModel::EMail);
+    QCOMPARE(model.rowCount(), 75000);
+    QCOMPARE(model.data(model.index(0, 0), MessagesModel::MessageIdRole).toInt(), 100000);
+    QCOMPARE(model.data(model.index(3, 0), MessagesModel::MessageIdRole).toInt(), 99996);
+
+    model.clearFilters();
+    QCOMPARE(model.rowCount(), 100000);
+    QCOMPARE(model.data(model.index(3, 0), MessagesModel::MessageIdRole).toInt(), 99997);
+}
+
+void tst_CommunicationsModels::testMessageBodies()
+{
+    QSqlDatabase db = createMessages(QStringLiteral("bodies"), 1000);
+    QVERIFY(db.isOpen());
+
+    MessagesModel model;
+    model.setDatabase(db);
+
+    // shown, read with the other messages of the page
+    QCOMPARE(model.data(model.index(0, 0), MessagesModel::MessageIdRole).toInt(), 1000);
+    QCOMPARE(model.messageBody(0, QStringLiteral("handle1000"), MessagesModel::PlainText), QStringLiteral("Body 1000"));
+    QCOMPARE(model.messageBody(1, QStringLiteral("handle997"), MessagesModel::PlainText), QStringLiteral("Body 997"));
+    QCOMPARE(model.messageBody(1, QStringLiteral("handle997"), MessagesModel::Html), QString());
+    // wrong account
+    QCOMPARE(model.messageBody(0, QStringLiteral("handle997"), MessagesModel::PlainText), QString());
+
+    // not fetched yet, read again once it is
+    QCOMPARE(model.messageBody(1, QStringLiteral("handle999"), MessagesModel::PlainText), QString());
+    QSqlQuery query(db);
+    QVERIFY(query.exec(QStringLiteral("UPDATE full_messages_view SET body_plain_text = 'Body 999' WHERE handle = 'handle999'")));
+    QCOMPARE(model.messageBody(1, QStringLiteral("handle999"), MessagesModel::PlainText), QStringLiteral("Body 999"));
+
+    // not shown
+    QCOMPARE(model.messageBody(1, QStringLiteral("handle1"), MessagesModel::PlainText), QStringLiteral("Body 1"));
+}
+
+void tst_CommunicationsModels::benchmarkMessagesWindow_data()
+{
+    QTest::addColumn<int>("messages");
+    QTest::addColumn<bool>("last");
+
+    QTest::newRow("1k, first") << 1000 << false;
+    QTest::newRow("1k, last") << 1000 << true;
+    QTest::newRow("100k, first") << 100000 << false;
+    QTest::newRow("100k, last") << 100000 << true;
+}
+
+/**
+ * Opens the messages and reads a screen of messages at the top or the bottom of the list,
+ * which should take as long for 100000 messages as for 1000.
+ */
+void tst_CommunicationsModels::benchmarkMessagesWindow()
+{
+    QFETCH(int, messages);
+    QFETCH(bool, last);
+
+    QSqlDatabase db = createMessages(QStringLiteral("window%1").arg(messages), messages);
+    QVERIFY(db.isOpen());
+
+    MessagesModel model;
+    model.setDatabase(db);
+
+    const int first = last ? messages - 10 : 0;
+    QBENCHMARK {
+        model.update();
+        for (int row = first; row < first + 10; ++row) {
+            const QModelIndex index = model.index(row, 0);
+            model.data(index, MessagesModel::SenderLabelRole);
+            model.data(index, MessagesModel::SubjectRole);
+            model.data(index, MessagesModel::DateTimeAsStringRole);
+        }
+    }
+
+    QCOMPARE(model.data(model.index(first, 0), MessagesModel::MessageIdRole).toInt(), messages - first);
+}
+
 QTEST_MAIN(tst_CommunicationsModels)
 #include "tst_communicationsmodels.moc"
@@ -0,0 +1,18 @@
+include(../../../common.pri)
+
+TEMPLATE = app
+
+QT += testlib
+
+# on QNX, do not run as part of make check/test
+!qnx:CONFIG += testcase
+
+include(../../../addlibraries.pri)
+
+TARGET = tst_medianodemodel
+
+SOURCES += tst_medianodemodel.cpp \
+
+HEADERS += \
+
+include(../../unittests.pri)
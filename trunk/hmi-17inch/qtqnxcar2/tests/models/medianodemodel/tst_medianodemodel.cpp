@@ -0,0 +1,468 @@
+#include <QtTest/QtTest>
+
+#include "qnxcar/mediaplayer/PagedMediaNodeModel.h"
+#include "qnxcar/mediaplayer/SearchModel.h"
+
+#include <QQueue>
+
+using QnxCar::MediaPlayer::MediaNode;
+using QnxCar::MediaPlayer::MediaNodeModel;
+using QnxCar::MediaPlayer::MediaNodeType;
+using QnxCar::MediaPlayer::Metadata;
+using QnxCar::MediaPlayer::PagedMediaNodeModel;
+using QnxCar::MediaPlayer::SearchModel;
+
+/**
+ * A paged model that serves a fixed number of generated video nodes, the way BrowseModel serves the
+ * results of browse commands: pages are requested from data() and arrive later through the event loop.
+ */
+class SyntheticModel : public PagedMediaNodeModel
+{
+    Q_OBJECT
+
+public:
+    explicit SyntheticModel(int total, QObject *parent = 0)
+        : PagedMediaNodeModel(0, parent)
+        , loadCount(0)
+        , m_total(total)
+    {
+    }
+
+    void doLoadPage(int page) const Q_DECL_OVERRIDE
+    {
+        QMetaObject::invokeMethod(const_cast<SyntheticModel *>(this), "pageLoaded", Qt::QueuedConnection, Q_ARG(int, page));
+    }
+
+    int loadCount;
+
+private Q_SLOTS:
+    void pageLoaded(int page)
+    {
+        const int offset = pageSize() * (page - 1);
+        const int end = qMin(m_total, offset + pageSize());
+
+        QList<MediaNode> mediaNodes;
+        for (int i = offset; i < end; ++i) {
+            MediaNode mediaNode;
+            mediaNode.id = QStringLiteral("/videos/%1").arg(i);
+            mediaNode.mediaSourceId = 1;
+            mediaNode.name = QStringLiteral("Track %1").arg(i);
+            // videos do not request metadata, no player needed
+            mediaNode.type = MediaNodeType::VIDEO;
+            mediaNodes << mediaNode;
+        }
+
+        ++loadCount;
+        insert(offset, mediaNodes);
+    }
+
+private:
+    int m_total;
+};
+
+/**
+ * A search model searching a library of generated video nodes instead of mm-player, matching the search term
+ * against the node names and artists. Search results arrive searchLatency milliseconds later, result pages from the
+ * event loop.
+ */
+class StubSearchModel : public SearchModel
+{
+    Q_OBJECT
+
+public:
+    explicit StubSearchModel(int total, QObject *parent = 0)
+        : SearchModel(0, parent)
+        , searchLatency(0)
+        , reportsCount(false)
+        , loadedPages(0)
+    {
+        for (int i = 0; i < total; ++i) {
+            MediaNode mediaNode;
+            mediaNode.id = QStringLiteral("/videos/%1").arg(i);
+            mediaNode.mediaSourceId = 1;
+            mediaNode.name = QStringLiteral("Track %1").arg(i);
+            mediaNode.type = MediaNodeType::VIDEO;
+            m_library << mediaNode;
+        }
+    }
+
+    /// Adds an audio node to the library, found by its @p name or its @p artist
+    void addTrack(const QString &name, const QString &artist)
+    {
+        MediaNode mediaNode;
+        mediaNode.id = QStringLiteral("/audio/%1").arg(m_library.count());
+        mediaNode.mediaSourceId = 1;
+        mediaNode.name = name;
+        mediaNode.type = MediaNodeType::AUDIO;
+        mediaNode.metadata.artist = artist;
+        m_library << mediaNode;
+    }
+
+    /// The search terms sent to the backend
+    QStringList searchedTerms;
+    int searchLatency;
+    /// Whether the result node has the number of results as its count, mm-player may report -1
+    bool reportsCount;
+    /// The number of result pages loaded from the backend
+    int loadedPages;
+
+protected:
+    void doSearch(int generation) Q_DECL_OVERRIDE
+    {
+        searchedTerms << searchTerm();
+
+        QList<MediaNode> result;
+        Q_FOREACH (const MediaNode &mediaNode, m_library) {
+            if (mediaNode.name.contains(searchTerm(), Qt::CaseInsensitive)
+                    || mediaNode.metadata.artist.contains(searchTerm(), Qt::CaseInsensitive)) {
+                // like the nodes browsed from mm-player, without metadata
+                MediaNode resultNode = mediaNode;
+                resultNode.metadata = Metadata();
+                result << resultNode;
+            }
+        }
+
+        // like mm-player, a node containing the results if there are any
+        MediaNode resultNode;
+        if (!result.isEmpty()) {
+            resultNode.id = QStringLiteral("/search/%1").arg(generation);
+            resultNode.mediaSourceId = 1;
+            if (reportsCount)
+                resultNode.count = result.count();
+            m_results.insert(resultNode.id, result);
+        }
+
+        m_pendingSearches.enqueue(qMakePair(generation, resultNode));
+        QTimer::singleShot(searchLatency, this, SLOT(searchFinished()));
+    }
+
+    void doLoadResultPage(int generation, const MediaNode &resultNode, int page) Q_DECL_OVERRIDE
+    {
+        ++loadedPages;
+        QMetaObject::invokeMethod(this, "pageLoaded", Qt::QueuedConnection, Q_ARG(int, generation),
+                                  Q_ARG(QString, resultNode.id), Q_ARG(int, page));
+    }
+
+private Q_SLOTS:
+    void searchFinished()
+    {
+        const QPair<int, MediaNode> search = m_pendingSearches.dequeue();
+        searchCompleted(search.first, search.second);
+    }
+
+    void pageLoaded(int generation, const QString &resultId, int page)
+    {
+        const int offset = pageSize() * (page - 1);
+        resultPageLoaded(generation, offset, m_results.value(resultId).mid(offset, pageSize()));
+    }
+
+private:
+    QList<MediaNode> m_library;
+    QHash<QString, QList<MediaNode> > m_results;
+    QQueue<QPair<int, MediaNode> > m_pendingSearches;
+};
+
+/// Counts the rows inserted into a search model that do not match its current search term
+class StaleRowCounter : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit StaleRowCounter(SearchModel *model)
+        : staleRows(0)
+        , m_model(model)
+    {
+        connect(model, SIGNAL(rowsInserted(QModelIndex,int,int)), this, SLOT(rowsInserted(QModelIndex,int,int)));
+    }
+
+    int staleRows;
+
+private Q_SLOTS:
+    void rowsInserted(const QModelIndex &parent, int first, int last)
+    {
+        Q_UNUSED(parent);
+
+        for (int row = first; row <= last; ++row) {
+            // without loading the pages around the row
+            const QString name = m_model->MediaNodeModel::data(m_model->index(row, 0), MediaNodeModel::NameRole).toString();
+            if (!name.contains(m_model->searchTerm(), Qt::CaseInsensitive))
+                ++staleRows;
+        }
+    }
+
+private:
+    SearchModel *m_model;
+};
+
+class tst_MediaNodeModel : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testPaging();
+    void testEviction();
+    void benchmarkScrolling();
+
+    void testSearchDebounce();
+    void testSearchCache();
+    void testStaleSearchResults();
+};
+
+static QString nameAt(const QAbstractItemModel &model, int row)
+{
+    return model.data(model.index(row, 0), MediaNodeModel::NameRole).toString();
+}
+
+void tst_MediaNodeModel::testPaging()
+{
+    SyntheticModel model(50);
+    QSignalSpy rowsInserted(&model, SIGNAL(rowsInserted(QModelIndex,int,int)));
+
+    model.loadPage(1);
+    QTRY_COMPARE(model.rowCount(), 20);
+
+    // requesting a row loads the page before and after it
+    QCOMPARE(nameAt(model, 19), QStringLiteral("Track 19"));
+    QTRY_COMPARE(model.rowCount(), 40);
+    QCOMPARE(nameAt(model, 39), QStringLiteral("Track 39"));
+    QTRY_COMPARE(model.rowCount(), 50);
+    QCOMPARE(nameAt(model, 49), QStringLiteral("Track 49"));
+
+    // every page is loaded once, including the empty one after the end
+    QTest::qWait(10);
+    QCOMPARE(model.loadCount, 4);
+    QCOMPARE(rowsInserted.count(), 3);
+    QCOMPARE(model.residentPageCount(), 3);
+
+    model.setPageSize(10);
+    QCOMPARE(model.rowCount(), 0);
+    QCOMPARE(model.residentPageCount(), 0);
+}
+
+void tst_MediaNodeModel::testEviction()
+{
+    SyntheticModel model(1000);
+    model.setMaximumResidentPages(5);
+
+    model.loadPage(1);
+    QTRY_COMPARE(model.rowCount(), 20);
+
+    // scroll to the end, one page at a time
+    for (int row = 0; row < 1000; row += 20) {
+        QTRY_VERIFY(model.rowCount() > row);
+        QCOMPARE(nameAt(model, row), QStringLiteral("Track %1").arg(row));
+        QVERIFY(model.residentPageCount() <= 5);
+    }
+    QTRY_COMPARE(model.rowCount(), 1000);
+    const int loadCount = model.loadCount;
+
+    // the beginning has been evicted, rows stay but read empty until they are loaded again
+    QSignalSpy rowsInserted(&model, SIGNAL(rowsInserted(QModelIndex,int,int)));
+    QSignalSpy dataChanged(&model, SIGNAL(dataChanged(QModelIndex,QModelIndex,QVector<int>)));
+
+    QCOMPARE(nameAt(model, 0), QString());
+    QTRY_COMPARE(nameAt(model, 0), QStringLiteral("Track 0"));
+    QCOMPARE(model.rowCount(), 1000);
+    QVERIFY(model.loadCount > loadCount);
+    QCOMPARE(rowsInserted.count(), 0);
+    QVERIFY(dataChanged.count() > 0);
+    QVERIFY(model.residentPageCount() <= 5);
+}
+
+/**
+ * Scrolls through 50000 nodes and back, the way a list view does, reading the roles a delegate shows.
+ */
+void tst_MediaNodeModel::benchmarkScrolling()
+{
+    static const int total = 50000;
+
+    SyntheticModel model(total);
+    model.loadPage(1);
+    QTRY_COMPARE(model.rowCount(), model.pageSize());
+
+    QBENCHMARK_ONCE {
+        for (int row = 0; row < total; ++row) {
+            // wait for the prefetched page, like a view at the end of its content
+            while (row >= model.rowCount())
+                QCoreApplication::processEvents();
+
+            const QModelIndex index = model.index(row, 0);
+            model.data(index, MediaNodeModel::NameRole);
+            model.data(index, MediaNodeModel::ArtworkRole);
+        }
+
+        for (int row = total - 1; row >= 0; --row) {
+            const QModelIndex index = model.index(row, 0);
+            model.data(index, MediaNodeModel::NameRole);
+            model.data(index, MediaNodeModel::ArtworkRole);
+            QCoreApplication::processEvents();
+        }
+    }
+
+    QCOMPARE(model.rowCount(), total);
+    QVERIFY(model.residentPageCount() <= model.maximumResidentPages());
+    QCOMPARE(nameAt(model, 0), QStringLiteral("Track 0"));
+}
+
+/// Types @p text into the search field of @p model, starting at @p from characters, @p interval milliseconds apart
+static void typeSearchTerm(SearchModel &model, const QString &text, int interval, int from = 1)
+{
+    for (int length = from; length <= text.length(); ++length) {
+        model.search(1, text.left(length), QString());
+        QTest::qWait(interval);
+    }
+}
+
+/**
+ * Types a 10 character search term against a library of 50000 tracks, without and with a pause.
+ */
+void tst_MediaNodeModel::testSearchDebounce()
+{
+    StubSearchModel model(50000);
+    model.setDebounceInterval(200);
+    StaleRowCounter counter(&model);
+
+    typeSearchTerm(model, QStringLiteral("Track 1234"), 10);
+    QVERIFY(model.searchInProgress());
+    QTRY_VERIFY(model.searchIsValid());
+
+    // Track 1234 and Track 12340 to 12349
+    QCOMPARE(model.searchedTerms, QStringList(QStringLiteral("Track 1234")));
+    QVERIFY(!model.searchInProgress());
+    QCOMPARE(model.rowCount(), 11);
+    QCOMPARE(nameAt(model, 0), QStringLiteral("Track 1234"));
+    QCOMPARE(nameAt(model, 10), QStringLiteral("Track 12349"));
+
+    // pausing once searches once more, the result of "Track" is too large to be refined
+    model.resetSearch();
+    QCOMPARE(model.rowCount(), 0);
+    model.searchedTerms.clear();
+
+    typeSearchTerm(model, QStringLiteral("Track"), 10);
+    QTRY_VERIFY(model.searchIsValid());
+    QVERIFY(model.rowCount() >= model.pageSize());
+
+    typeSearchTerm(model, QStringLiteral("Track 1234"), 10, 6);
+    QTRY_VERIFY(model.searchIsValid());
+    QCOMPARE(model.searchedTerms, QStringList() << QStringLiteral("Track") << QStringLiteral("Track 1234"));
+    QCOMPARE(model.rowCount(), 11);
+
+    QCOMPARE(counter.staleRows, 0);
+}
+
+void tst_MediaNodeModel::testSearchCache()
+{
+    StubSearchModel model(50000);
+    model.setDebounceInterval(0);
+
+    // the pages beyond the first one are loaded in the background, without scrolling
+    model.search(1, QStringLiteral("Track 123"), QString());
+    QTRY_VERIFY(model.searchIsValid());
+    QTRY_COMPARE(model.rowCount(), 111);
+    QCOMPARE(nameAt(model, 110), QStringLiteral("Track 12399"));
+
+    // refined without searching again
+    model.search(1, QStringLiteral("Track 1234"), QString());
+    QVERIFY(model.searchInProgress());
+    QCOMPARE(model.rowCount(), 0);
+    QTRY_VERIFY(model.searchIsValid());
+    QCOMPARE(model.rowCount(), 11);
+    QCOMPARE(nameAt(model, 10), QStringLiteral("Track 12349"));
+
+    model.search(1, QStringLiteral("track 12345"), QString());
+    QTRY_VERIFY(model.searchIsValid());
+    QCOMPARE(model.rowCount(), 1);
+
+    model.search(1, QStringLiteral("Track 1234x"), QString());
+    QTRY_VERIFY(model.searchIsValid());
+    QCOMPARE(model.rowCount(), 0);
+
+    QTest::qWait(10);
+    QCOMPARE(model.searchedTerms, QStringList(QStringLiteral("Track 123")));
+
+    // another term, source or filter is searched for
+    model.search(1, QStringLiteral("Track 124"), QString());
+    QTRY_VERIFY(model.searchIsValid());
+    model.search(2, QStringLiteral("Track 1245"), QString());
+    QTRY_VERIFY(model.searchIsValid());
+    QCOMPARE(model.searchedTerms.count(), 3);
+
+    // an empty result is refined as well
+    model.search(2, QStringLiteral("Track x"), QString());
+    QTRY_VERIFY(model.searchIsValid());
+    model.search(2, QStringLiteral("Track xy"), QString());
+    QTRY_VERIFY(model.searchIsValid());
+    QCOMPARE(model.rowCount(), 0);
+    QCOMPARE(model.searchedTerms.count(), 4);
+
+    // dropped when the search is reset, the media source might change
+    model.resetSearch();
+    model.search(2, QStringLiteral("Track xyz"), QString());
+    QTRY_VERIFY(model.searchIsValid());
+    QCOMPARE(model.searchedTerms.count(), 5);
+
+    // too large to be kept, loading stops once the maximum is reached
+    model.setMaximumCachedResults(100);
+    model.loadedPages = 0;
+    model.search(1, QStringLiteral("Track 123"), QString());
+    QTRY_VERIFY(model.searchIsValid());
+    QTRY_COMPARE(model.rowCount(), 100);
+    QTest::qWait(50);
+    QCOMPARE(model.loadedPages, 5);
+    model.search(1, QStringLiteral("Track 1234"), QString());
+    QTRY_VERIFY(model.searchIsValid());
+    QCOMPARE(model.rowCount(), 11);
+    QCOMPARE(model.searchedTerms.count(), 7);
+
+    // not loaded beyond the first page if the result reports its size
+    model.reportsCount = true;
+    model.loadedPages = 0;
+    model.search(1, QStringLiteral("Track 124"), QString());
+    QTRY_VERIFY(model.searchIsValid());
+    QTest::qWait(50);
+    QCOMPARE(model.loadedPages, 1);
+    QCOMPARE(model.rowCount(), model.pageSize());
+    model.search(1, QStringLiteral("Track 1245"), QString());
+    QTRY_VERIFY(model.searchIsValid());
+    QCOMPARE(model.searchedTerms.count(), 9);
+
+    // found by its artist, which the result nodes do not carry: filtering the names would drop it
+    StubSearchModel artistModel(100);
+    artistModel.setDebounceInterval(0);
+    artistModel.addTrack(QStringLiteral("Yesterday"), QStringLiteral("The Beatles"));
+    artistModel.addTrack(QStringLiteral("Beatle Bop"), QStringLiteral("Someone Else"));
+
+    artistModel.search(1, QStringLiteral("Beatl"), QString());
+    QTRY_VERIFY(artistModel.searchIsValid());
+    QTRY_COMPARE(artistModel.rowCount(), 2);
+
+    artistModel.search(1, QStringLiteral("Beatle"), QString());
+    QTRY_VERIFY(artistModel.searchIsValid());
+    QTRY_COMPARE(artistModel.rowCount(), 2);
+    QCOMPARE(artistModel.searchedTerms, QStringList() << QStringLiteral("Beatl") << QStringLiteral("Beatle"));
+}
+
+void tst_MediaNodeModel::testStaleSearchResults()
+{
+    StubSearchModel model(50000);
+    model.setDebounceInterval(50);
+    model.searchLatency = 200;
+    StaleRowCounter counter(&model);
+
+    // the search for "Track 1" is running while the user types on
+    model.search(1, QStringLiteral("Track 1"), QString());
+    QTRY_COMPARE(model.searchedTerms.count(), 1);
+    typeSearchTerm(model, QStringLiteral("Track 1234"), 5, 8);
+
+    QTRY_VERIFY(model.searchIsValid());
+    QCOMPARE(model.searchedTerms, QStringList() << QStringLiteral("Track 1") << QStringLiteral("Track 1234"));
+    QCOMPARE(model.rowCount(), 11);
+
+    // the result of "Track 1" arrived in between and has been dropped
+    QTest::qWait(250);
+    QCOMPARE(model.rowCount(), 11);
+    QCOMPARE(counter.staleRows, 0);
+}
+
+QTEST_MAIN(tst_MediaNodeModel)
+#include "tst_medianodemodel.moc"
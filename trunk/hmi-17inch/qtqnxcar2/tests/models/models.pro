@@ -2,5 +2,6 @@ TEMPLATE = subdirs
 
 SUBDIRS = \
     communicationsmodels \
+    medianodemodel \
     mediaplayermodels \
     settingsmodels
@@ -4,11 +4,16 @@
 #include "qnxcar/ApplicationListModel.h"
 #include "qnxcar/Launcher.h"
 
+#include <qpps/changeset.h>
 #include <qpps/object.h>
 #include <qpps/simulator.h>
 
+#include <QSignalSpy>
+
 #include <QString>
 
+Q_DECLARE_METATYPE(QPps::Changeset)
+
 using QnxCar::ApplicationData;
 using QnxCar::ApplicationListModel;
 using QnxCar::Launcher;
@@ -19,6 +24,8 @@ class tst_Launcher : public QObject
 
 private Q_SLOTS:
     void testFindIdByName();
+    void benchmarkApplicationListRebuilds_data();
+    void benchmarkApplicationListRebuilds();
 };
 
 void tst_Launcher::testFindIdByName()
@@ -59,6 +66,57 @@ void tst_Launcher::testFindIdByName()
     QCOMPARE(model->index(25, 0).data(ApplicationListModel::AppIdRole).toString(), QStringLiteral("HelloKitty_1234"));
 }
 
+void tst_Launcher::benchmarkApplicationListRebuilds_data()
+{
+    QTest::addColumn<bool>("batched");
+
+    QTest::newRow("one changeset per application") << false;
+    QTest::newRow("one changeset for all applications") << true;
+}
+
+/**
+ * Navigator publishing a list of 200 applications. The Launcher rebuilds the app-launcher list
+ * once per changeset it receives.
+ */
+void tst_Launcher::benchmarkApplicationListRebuilds()
+{
+    QFETCH(bool, batched);
+
+    static const int applicationCount = 200;
+    const QString applicationsPath = QStringLiteral("/pps/system/navigator/applications/applications");
+
+    QPps::Simulator::self()->reset();
+    QPps::Simulator::self()->insertObject(applicationsPath);
+
+    Launcher launcher;
+
+    qRegisterMetaType<QPps::Changeset>("QPps::Changeset");
+    QPps::Object appLauncher(QStringLiteral("/pps/services/app-launcher"), QPps::Object::SubscribeMode);
+    QSignalSpy rebuildSpy(&appLauncher, SIGNAL(attributesChanged(QPps::Changeset)));
+
+    QPps::Changeset applications;
+    for (int i = 0; i < applicationCount; ++i) {
+        applications.assignments.insert(QStringLiteral("App%1.testDev_App%1").arg(i),
+                                        QPps::Variant(QStringLiteral("{86x86}native/icon.png,App %1,games,,auto,,").arg(i)));
+    }
+
+    QBENCHMARK_ONCE {
+        if (batched) {
+            QPps::Simulator::self()->setObjectAttributes(applicationsPath, applications);
+        } else {
+            QMap<QString, QPps::Variant>::ConstIterator it = applications.assignments.constBegin();
+            for (; it != applications.assignments.constEnd(); ++it) {
+                QPps::Changeset single;
+                single.assignments.insert(it.key(), it.value());
+                QPps::Simulator::self()->setObjectAttributes(applicationsPath, single);
+            }
+        }
+    }
+
+    QCOMPARE(launcher.applicationListModel()->rowCount(), applicationCount);
+    QCOMPARE(rebuildSpy.count(), batched ? 1 : applicationCount);
+    qDebug("%d app-launcher list rebuilds", rebuildSpy.count());
+}
 
 QTEST_MAIN(tst_Launcher)
 #include "tst_launcher.moc"
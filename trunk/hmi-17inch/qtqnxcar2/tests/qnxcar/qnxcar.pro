@@ -9,3 +9,4 @@ SUBDIRS = \
     theme \
     user \
     sensors \
+    sqlqueryservice \
@@ -3,10 +3,71 @@
 #include "simulator/Simulator.h"
 #include "qnxcar/Sensors.h"
 
+#include <qpps/key.h>
+#include <qpps/object.h>
 #include <qpps/simulator.h>
 
 using QnxCar::Sensors;
 
+static const char * const s_sensorKeys[] = {
+    "brakeFluidLevel", "brakeAbsEnabled", "brakeAbsFrontLeft", "brakeAbsFrontRight", "brakeAbsRearLeft",
+    "brakeAbsRearRight", "brakePadWearFrontLeft", "brakePadWearFrontRight", "brakePadWearRearLeft",
+    "brakePadWearRearRight", "coolantLevel", "engineOilLevel", "engineOilPressure", "rpm", "fuelLevel",
+    "lightHeadLeft", "lightHeadRight", "lightTailLeft", "lightTailRight", "speed", "tirePressureFrontLeft",
+    "tirePressureFrontRight", "tirePressureRearLeft", "tirePressureRearRight", "tireWearFrontLeft",
+    "tireWearFrontRight", "tireWearRearLeft", "tireWearRearRight", "transmissionFluidLevel",
+    "transmissionClutchWear", "transmissionGear", "transmissionFluidTemperature", "washerFluidLevel",
+    "laneDeparture"
+};
+static const int s_sensorKeyCount = sizeof(s_sensorKeys) / sizeof(s_sensorKeys[0]);
+// interned before any change is delivered, like the static KeyTable of Sensors
+static const QPps::KeyTable s_sensorKeyTable(s_sensorKeys, s_sensorKeyCount);
+
+/**
+ * Dispatches like Sensors did before attribute keys were interned: one temporary
+ * QString per comparison, walking the whole chain for keys at the end.
+ */
+class LegacySensorDispatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    LegacySensorDispatcher() : matches(0) {}
+
+    int matches;
+
+public Q_SLOTS:
+    void ppsAttributeChanged(const QString &name, const QPps::Variant &attribute)
+    {
+        for (int i = 0; i < s_sensorKeyCount; ++i) {
+            if (name == QString::fromLatin1(s_sensorKeys[i])) {
+                matches += attribute.toInt() >= 0 ? 1 : 0;
+                return;
+            }
+        }
+    }
+};
+
+/**
+ * Dispatches like Sensors does now: the interned key is translated to the table position.
+ */
+class KeySensorDispatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    KeySensorDispatcher() : matches(0) {}
+
+    int matches;
+
+public Q_SLOTS:
+    void ppsAttributeChanged(int key, const QString &, const QPps::Variant &attribute)
+    {
+        if (s_sensorKeyTable.indexOf(key) != -1)
+            matches += attribute.toInt() >= 0 ? 1 : 0;
+    }
+};
+
 class tst_Sensors : public QObject
 {
     Q_OBJECT
@@ -16,6 +77,8 @@ private Q_SLOTS:
     void changeProperty_data();
     void changeProperty();
     void testAbsSwitch();
+    void benchmarkDispatch_data();
+    void benchmarkDispatch();
 };
 
 void tst_Sensors::ppsAccessible()
@@ -150,7 +213,8 @@ void tst_Sensors::changeProperty()
     QSignalSpy simulatorSpy(QPps::Simulator::self(), SIGNAL(attributeChanged(QString,QString,QByteArray,QByteArray)));
     QPps::Simulator::self()->clientSetAttribute(&sensor, key, propertyValue.toByteArray(), propertyType);
 
-    QCOMPARE(sensorSpy.count(), 1);
+    // sensor updates are coalesced and delivered once per frame
+    QTRY_COMPARE(sensorSpy.count(), 1);
     QCOMPARE(QVariant(sensorSpy.at(0).at(0)), propertyValue);
     QCOMPARE(simulatorSpy.count(), 1);
     QCOMPARE(simulatorSpy.at(0).at(1).toString(), key);
@@ -174,5 +238,53 @@ void tst_Sensors::testAbsSwitch()
     QCOMPARE(QVariant(sensorSpy.at(0).at(0)), QVariant::fromValue(false));
 }
 
+void tst_Sensors::benchmarkDispatch_data()
+{
+    QTest::addColumn<bool>("legacy");
+
+    QTest::newRow("string comparison chain") << true;
+    QTest::newRow("interned key switch") << false;
+}
+
+void tst_Sensors::benchmarkDispatch()
+{
+    QFETCH(bool, legacy);
+
+    static const int deltaCount = 100000;
+
+    QnxCar2Simulator::initDemoData();
+
+    QObject publisher;
+    QVERIFY(QPps::Simulator::self()->registerClient(QStringLiteral("/pps/qnxcar/sensors"), &publisher));
+
+    // the same object for both, only the signal and the dispatch differ
+    QPps::Object object(QStringLiteral("/pps/qnxcar/sensors"), QPps::Object::SubscribeMode);
+    LegacySensorDispatcher legacyDispatcher;
+    KeySensorDispatcher keyDispatcher;
+    if (legacy) {
+        connect(&object, SIGNAL(attributeChanged(QString,QPps::Variant)),
+                &legacyDispatcher, SLOT(ppsAttributeChanged(QString,QPps::Variant)));
+    } else {
+        connect(&object, SIGNAL(attributeKeyChanged(int,QString,QPps::Variant)),
+                &keyDispatcher, SLOT(ppsAttributeChanged(int,QString,QPps::Variant)));
+    }
+
+    // mixed deltas, the values change on every update so that the simulator forwards them
+    QList<QString> keys;
+    for (int i = 0; i < s_sensorKeyCount; ++i)
+        keys << QString::fromLatin1(s_sensorKeys[i]);
+
+    QBENCHMARK_ONCE {
+        for (int i = 0; i < deltaCount; ++i) {
+            const QString &key = keys.at((i * 7) % keys.count());
+            QPps::Simulator::self()->clientSetAttribute(&publisher, key, QByteArray::number(deltaCount + i), QByteArrayLiteral("n"));
+        }
+    }
+
+    QCOMPARE(legacy ? legacyDispatcher.matches : keyDispatcher.matches, deltaCount);
+
+    QPps::Simulator::self()->unregisterClient(&publisher);
+}
+
 QTEST_MAIN(tst_Sensors)
 #include "tst_sensors.moc"
@@ -0,0 +1,20 @@
+include(../../../common.pri)
+
+TEMPLATE = app
+
+QT += testlib
+
+# on QNX, do not run as part of make check/test
+!qnx:CONFIG += testcase
+
+include(../../../addlibraries.pri)
+
+QT += sql
+
+TARGET = tst_sqlqueryservice
+
+SOURCES += tst_sqlqueryservice.cpp
+
+HEADERS +=
+
+include(../../unittests.pri)
@@ -0,0 +1,323 @@
+#include <QtTest/QtTest>
+
+#include "qnxcar/DatabaseManager.h"
+#include "qnxcar/SqlQueryModel.h"
+#include "qnxcar/SqlQueryService.h"
+
+#include <QElapsedTimer>
+#include <QSignalSpy>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QTemporaryDir>
+
+using QnxCar::DatabaseManager;
+using QnxCar::SqlFuture;
+using QnxCar::SqlQueryModel;
+using QnxCar::SqlQueryService;
+using QnxCar::SqlRequest;
+using QnxCar::SqlResult;
+
+/// Counts to @p count in SQLite, which takes a while for a few million
+static QString slowQuery(int count)
+{
+    return QStringLiteral("WITH RECURSIVE counter(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM counter WHERE x < %1) "
+                          "SELECT COUNT(*) FROM counter").arg(count);
+}
+
+class NamesModel : public SqlQueryModel
+{
+public:
+    NamesModel() : SqlQueryModel() {}
+
+protected:
+    QList<QByteArray> columnNames() const Q_DECL_OVERRIDE
+    {
+        return QList<QByteArray>() << "id" << "name";
+    }
+
+    void runQuery() Q_DECL_OVERRIDE
+    {
+        submitQuery(QStringLiteral("SELECT id, name FROM names WHERE id >= ? ORDER BY id"), QVariantList() << 2);
+    }
+};
+
+/// Measures how regularly the event loop runs a timer
+class TickCounter : public QObject
+{
+public:
+    TickCounter() : m_ticks(0), m_longestGap(0) {}
+
+    void start(int interval)
+    {
+        m_sinceLastTick.start();
+        startTimer(interval);
+    }
+
+    int ticks() const { return m_ticks; }
+    qint64 longestGap() const { return m_longestGap; }
+
+protected:
+    void timerEvent(QTimerEvent *) Q_DECL_OVERRIDE
+    {
+        m_longestGap = qMax(m_longestGap, m_sinceLastTick.restart());
+        ++m_ticks;
+    }
+
+private:
+    QElapsedTimer m_sinceLastTick;
+    int m_ticks;
+    qint64 m_longestGap;
+};
+
+class tst_SqlQueryService : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void init();
+    void cleanup();
+
+    void testRead();
+    void testWrite();
+    void testErrors();
+    void testCancel();
+    void testJournalMode();
+    void testReadDuringWrite();
+    void testResponsiveness();
+    void testModel();
+
+private:
+    QScopedPointer<QTemporaryDir> m_dir;
+    QString m_path;
+};
+
+static const QString CONNECTION_NAME = QStringLiteral("tst_sqlqueryservice");
+
+void tst_SqlQueryService::init()
+{
+    m_dir.reset(new QTemporaryDir);
+    QVERIFY(m_dir->isValid());
+    m_path = m_dir->path() + QStringLiteral("/names.db");
+
+    QSqlDatabase db = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), CONNECTION_NAME);
+    db.setDatabaseName(m_path);
+    QVERIFY(db.open());
+
+    QSqlQuery query(db);
+    QVERIFY(query.exec(QStringLiteral("CREATE TABLE names (id INTEGER PRIMARY KEY, name TEXT)")));
+    QVERIFY(query.exec(QStringLiteral("INSERT INTO names (id, name) VALUES (1, 'a')")));
+    QVERIFY(query.exec(QStringLiteral("INSERT INTO names (id, name) VALUES (2, 'b')")));
+    QVERIFY(query.exec(QStringLiteral("INSERT INTO names (id, name) VALUES (3, 'c')")));
+}
+
+void tst_SqlQueryService::cleanup()
+{
+    DatabaseManager::setWriteAheadLogging(m_path, false);
+    QSqlDatabase::removeDatabase(CONNECTION_NAME);
+}
+
+void tst_SqlQueryService::testRead()
+{
+    SqlQueryService service;
+
+    QScopedPointer<SqlFuture> future(service.read(m_path, QStringLiteral("SELECT id, name FROM names WHERE id > ? ORDER BY id"),
+                                                  QVariantList() << 1));
+    QSignalSpy finishedSpy(future.data(), SIGNAL(finished()));
+
+    // delivered from the event loop
+    QVERIFY(!future->isFinished());
+    QTRY_COMPARE(finishedSpy.count(), 1);
+    QVERIFY(future->isFinished());
+
+    const SqlResult result = future->result();
+    QVERIFY(result.isValid());
+    QCOMPARE(result.columnNames(), QStringList() << QStringLiteral("id") << QStringLiteral("name"));
+    QCOMPARE(result.columnIndex(QStringLiteral("name")), 1);
+    QCOMPARE(result.rowCount(), 2);
+    QCOMPARE(result.value(0, 0).toInt(), 2);
+    QCOMPARE(result.value(1, 1).toString(), QStringLiteral("c"));
+    QCOMPARE(result.value(2, 1), QVariant());
+
+    // the prepared statement is reused with other values
+    QScopedPointer<SqlFuture> again(service.read(m_path, QStringLiteral("SELECT id, name FROM names WHERE id > ? ORDER BY id"),
+                                                 QVariantList() << 2));
+    QVERIFY(again->waitForFinished(5000));
+    QCOMPARE(again->result().rowCount(), 1);
+    QCOMPARE(again->result().value(0, 1).toString(), QStringLiteral("c"));
+
+    // the first snapshot is unaffected
+    QCOMPARE(result.rowCount(), 2);
+}
+
+void tst_SqlQueryService::testWrite()
+{
+    SqlQueryService service;
+
+    QScopedPointer<SqlFuture> insert(service.write(m_path, QStringLiteral("INSERT INTO names (name) VALUES (?)"),
+                                                   QVariantList() << QStringLiteral("d")));
+    QVERIFY(insert->waitForFinished(5000));
+    QVERIFY(insert->result().isValid());
+    QCOMPARE(insert->result().numRowsAffected(), 1);
+    QCOMPARE(insert->result().lastInsertId().toInt(), 4);
+
+    QScopedPointer<SqlFuture> count(service.read(m_path, QStringLiteral("SELECT COUNT(*) FROM names")));
+    QVERIFY(count->waitForFinished(5000));
+    QCOMPARE(count->result().value(0, 0).toInt(), 4);
+}
+
+void tst_SqlQueryService::testErrors()
+{
+    SqlQueryService service;
+
+    QScopedPointer<SqlFuture> missingTable(service.read(m_path, QStringLiteral("SELECT * FROM missing")));
+    QVERIFY(missingTable->waitForFinished(5000));
+    QVERIFY(!missingTable->result().isValid());
+    QVERIFY(!missingTable->result().errorString().isEmpty());
+
+    QScopedPointer<SqlFuture> missingFile(service.read(m_dir->path() + QStringLiteral("/missing/names.db"),
+                                                       QStringLiteral("SELECT * FROM names")));
+    QVERIFY(missingFile->waitForFinished(5000));
+    QVERIFY(!missingFile->result().isValid());
+
+    // the service keeps working
+    QScopedPointer<SqlFuture> names(service.read(m_path, QStringLiteral("SELECT * FROM names")));
+    QVERIFY(names->waitForFinished(5000));
+    QCOMPARE(names->result().rowCount(), 3);
+}
+
+void tst_SqlQueryService::testCancel()
+{
+    SqlQueryService service;
+
+    QScopedPointer<SqlFuture> slow(service.read(m_path, slowQuery(1000000)));
+    QScopedPointer<SqlFuture> cancelled(service.read(m_path, QStringLiteral("SELECT * FROM names")));
+    QSignalSpy cancelledSpy(cancelled.data(), SIGNAL(finished()));
+    cancelled->cancel();
+    QVERIFY(cancelled->isCancelled());
+
+    // deleting a waiting future is fine as well
+    delete service.read(m_path, QStringLiteral("SELECT * FROM names"));
+
+    QVERIFY(slow->waitForFinished(10000));
+    QCOMPARE(slow->result().value(0, 0).toInt(), 1000000);
+
+    QTest::qWait(50);
+    QVERIFY(!cancelled->waitForFinished(0));
+    QCOMPARE(cancelledSpy.count(), 0);
+}
+
+/**
+ * Checks that a database which did not opt in to write-ahead logging, like the phonebook of the
+ * system, keeps its journal mode.
+ */
+void tst_SqlQueryService::testJournalMode()
+{
+    SqlQueryService service;
+
+    QScopedPointer<SqlFuture> read(service.read(m_path, QStringLiteral("SELECT COUNT(*) FROM names")));
+    QVERIFY(read->waitForFinished(5000));
+    QScopedPointer<SqlFuture> write(service.write(m_path, QStringLiteral("INSERT INTO names (name) VALUES ('d')")));
+    QVERIFY(write->waitForFinished(5000));
+
+    QSqlQuery query(QSqlDatabase::database(CONNECTION_NAME));
+    QVERIFY(query.exec(QStringLiteral("PRAGMA journal_mode")));
+    QVERIFY(query.next());
+    QCOMPARE(query.value(0).toString(), QStringLiteral("delete"));
+}
+
+void tst_SqlQueryService::testReadDuringWrite()
+{
+    SqlQueryService service;
+
+    // the service switches the file to write-ahead logging once enabled
+    DatabaseManager::setWriteAheadLogging(m_path, true);
+    QScopedPointer<SqlFuture> first(service.read(m_path, QStringLiteral("SELECT COUNT(*) FROM names")));
+    QVERIFY(first->waitForFinished(5000));
+
+    QSqlDatabase db = QSqlDatabase::database(CONNECTION_NAME);
+    QSqlQuery query(db);
+    QVERIFY(query.exec(QStringLiteral("PRAGMA journal_mode")));
+    QVERIFY(query.next());
+    QCOMPARE(query.value(0).toString(), QStringLiteral("wal"));
+    query.finish();
+
+    // like a phonebook sync in progress
+    QVERIFY(query.exec(QStringLiteral("BEGIN IMMEDIATE")));
+    QVERIFY(query.exec(QStringLiteral("INSERT INTO names (name) VALUES ('d')")));
+
+    QScopedPointer<SqlFuture> during(service.read(m_path, QStringLiteral("SELECT COUNT(*) FROM names")));
+    QVERIFY(during->waitForFinished(1000));
+    QCOMPARE(during->result().value(0, 0).toInt(), 3);
+
+    QVERIFY(query.exec(QStringLiteral("COMMIT")));
+
+    QScopedPointer<SqlFuture> after(service.read(m_path, QStringLiteral("SELECT COUNT(*) FROM names")));
+    QVERIFY(after->waitForFinished(5000));
+    QCOMPARE(after->result().value(0, 0).toInt(), 4);
+}
+
+/**
+ * Runs a query taking a while and checks that the timers of the GUI thread keep firing meanwhile.
+ */
+void tst_SqlQueryService::testResponsiveness()
+{
+    SqlQueryService service;
+
+    QElapsedTimer queryTime;
+    queryTime.start();
+    QScopedPointer<SqlFuture> slow(service.read(m_path, slowQuery(5000000)));
+    QSignalSpy finishedSpy(slow.data(), SIGNAL(finished()));
+
+    QEventLoop loop;
+    connect(slow.data(), SIGNAL(finished()), &loop, SLOT(quit()));
+    QTimer::singleShot(30000, &loop, SLOT(quit()));
+
+    TickCounter counter;
+    counter.start(10);
+    loop.exec();
+
+    QCOMPARE(finishedSpy.count(), 1);
+    QCOMPARE(slow->result().value(0, 0).toInt(), 5000000);
+
+    qDebug() << "query took" << queryTime.elapsed() << "ms," << counter.ticks() << "ticks, longest gap"
+             << counter.longestGap() << "ms";
+
+    // the GUI thread kept running its event loop the whole time
+    QVERIFY(counter.ticks() >= queryTime.elapsed() / 10 / 4);
+    QVERIFY(counter.longestGap() < 200);
+}
+
+void tst_SqlQueryService::testModel()
+{
+    NamesModel model;
+    QSignalSpy resetSpy(&model, SIGNAL(modelReset()));
+
+    model.setDatabase(QSqlDatabase::database(CONNECTION_NAME));
+    // nothing shown until the rows arrive
+    QCOMPARE(model.rowCount(), 0);
+    QTRY_COMPARE(resetSpy.count(), 1);
+
+    QCOMPARE(model.rowCount(), 2);
+    QCOMPARE(model.columnCount(), 2);
+    QVERIFY(!model.canFetchMore());
+    QCOMPARE(model.data(model.index(0, 0), Qt::UserRole + 1).toInt(), 2);
+    QCOMPARE(model.data(model.index(1, 0), Qt::UserRole + 2).toString(), QStringLiteral("c"));
+    QCOMPARE(model.data(model.index(1, 1), Qt::DisplayRole).toString(), QStringLiteral("c"));
+
+    // the old rows stay until the update arrives, superseded updates are never shown
+    QSqlQuery query(QSqlDatabase::database(CONNECTION_NAME));
+    QVERIFY(query.exec(QStringLiteral("INSERT INTO names (id, name) VALUES (4, 'd')")));
+    model.update();
+    model.update();
+    QCOMPARE(model.rowCount(), 2);
+    QTRY_COMPARE(model.rowCount(), 3);
+    QTest::qWait(50);
+    QCOMPARE(resetSpy.count(), 2);
+
+    model.clear();
+    QCOMPARE(model.rowCount(), 0);
+}
+
+QTEST_MAIN(tst_SqlQueryService)
+#include "tst_sqlqueryservice.moc"
@@ -0,0 +1,30 @@
+#!/bin/bash
+
+# This script builds and tests QPPS on a Linux host twice, once against the in-process simulator
+# and once with the real QNX backend against qppsserver (CONFIG+=pps_server). It is meant to be
+# run by CI; the roundtrip benchmark output of both builds can be compared in the log.
+# It is recommended to call this script out-of-source, it creates the build directories
+# qpps-simulator and qpps-server in the current directory
+
+SCRIPT_DIR="$( cd "$( dirname "${BASH_SOURCE[0]}" )" && pwd )"
+SOURCE_DIR=$SCRIPT_DIR/../qpps
+
+# exit immediately if a command returns with non-zero status
+set -e
+
+for BACKEND in simulator server; do
+    mkdir -p qpps-$BACKEND
+    cd qpps-$BACKEND
+
+    if [ "$BACKEND" = "server" ]; then
+        qmake -r CONFIG+=pps_server CONFIG+=release CONFIG-=debug $SOURCE_DIR
+    else
+        qmake -r CONFIG+=release CONFIG-=debug $SOURCE_DIR
+    fi
+
+    make
+    # the qppsserver tests start their own server on a private socket
+    make check
+
+    cd ..
+done
@@ -2,10 +2,12 @@ TEMPLATE = subdirs
 
 SUBDIRS += \
     modules \
+    serviceregistry \
 
 !qnx:SUBDIRS += \
     screenmanager \
     util \
+    windowmanagerloop \
 
 qnx:SUBDIRS += \
     windowmanager \
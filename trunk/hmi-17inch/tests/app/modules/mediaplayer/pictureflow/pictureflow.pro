@@ -0,0 +1,10 @@
+include(../../../../unittests.pri)
+
+TARGET=tst_pictureflow
+
+QT += widgets
+
+SOURCES += tst_pictureflow.cpp \
+           $$SOURCE_ROOT/app/modules/mediaplayer/pictureflow.cpp
+
+HEADERS += $$SOURCE_ROOT/app/modules/mediaplayer/pictureflow.h
@@ -0,0 +1,365 @@
+#include <QtTest/QtTest>
+
+#include "modules/mediaplayer/pictureflow.h"
+
+class tst_PictureFlow : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void preparation();
+    void contentAddressed();
+    void cacheBudget();
+    void diskCache();
+    void renderThreads_data();
+    void renderThreads();
+    void benchmarkAnimation_data();
+    void benchmarkAnimation();
+    void benchmarkPreparation();
+    void benchmarkDiskCache();
+};
+
+static QColor slideColor(int index)
+{
+    return QColor::fromHsv((index * 37) % 360, 200, 220);
+}
+
+static void addSlides(PictureFlow *flow, int count, const QSize &size)
+{
+    for (int i = 0; i < count; ++i) {
+        QImage image(size, QImage::Format_RGB32);
+        image.fill(slideColor(i));
+        // some detail on the left, so that misplaced columns show
+        for (int y = 0; y < size.height(); ++y)
+            for (int x = 0; x < size.width() / 4; ++x)
+                image.setPixel(x, y, qRgb(x * 4 % 256, y % 256, i % 256));
+        flow->addSlide(image);
+    }
+}
+
+// renders the current state of the animation offscreen
+static QImage renderFrame(PictureFlow *flow)
+{
+    QImage frame(flow->size(), QImage::Format_RGB32);
+    flow->render();
+    flow->QWidget::render(&frame);
+    return frame;
+}
+
+// renders until all visible slides show their surfaces instead of the placeholder
+static QImage settle(PictureFlow *flow)
+{
+    renderFrame(flow);
+
+    QElapsedTimer timer;
+    timer.start();
+    while (flow->isPreparingSlides() && timer.elapsed() < 10000)
+        QTest::qWait(5);
+
+    return renderFrame(flow);
+}
+
+// advances the animation by one timer tick
+static void stepAnimation(PictureFlow *flow)
+{
+    QMetaObject::invokeMethod(flow, "updateAnimation");
+}
+
+void tst_PictureFlow::preparation()
+{
+    PictureFlow flow;
+    flow.resize(643, 401);
+    flow.setSlideSize(QSize(150, 180));
+    addSlides(&flow, 30, QSize(150, 180));
+    flow.setCenterIndex(10);
+
+    // a placeholder first, surfaces are prepared in the background
+    const QPoint center(flow.width() / 2, flow.height() / 2);
+    QVERIFY(renderFrame(&flow).pixel(center) != slideColor(10).rgb());
+    QVERIFY(flow.isPreparingSlides());
+
+    QCOMPARE(settle(&flow).pixel(center), slideColor(10).rgb());
+
+    // the slides next to the visible ones have been prepared ahead
+    flow.setCenterIndex(20);
+    QCOMPARE(renderFrame(&flow).pixel(center), slideColor(20).rgb());
+
+    // replaced images are prepared again
+    QImage image(150, 180, QImage::Format_RGB32);
+    image.fill(Qt::white);
+    flow.setSlide(20, image);
+    QVERIFY(renderFrame(&flow).pixel(center) != qRgb(255, 255, 255));
+    QCOMPARE(settle(&flow).pixel(center), qRgb(255, 255, 255));
+}
+
+void tst_PictureFlow::contentAddressed()
+{
+    PictureFlow flow;
+    flow.resize(643, 401);
+    flow.setSlideSize(QSize(150, 180));
+    addSlides(&flow, 30, QSize(150, 180));
+    flow.setCenterIndex(10);
+    const QPoint center(flow.width() / 2, flow.height() / 2);
+    settle(&flow);
+
+    // reordered slides keep their surfaces
+    const QImage left = flow.slide(9);
+    const QImage right = flow.slide(11);
+    flow.setSlide(9, right);
+    flow.setSlide(10, left);
+    QCOMPARE(renderFrame(&flow).pixel(center), slideColor(9).rgb());
+    QVERIFY(!flow.isPreparingSlides());
+
+    // slides with the same artwork share one
+    PictureFlow same;
+    same.resize(643, 401);
+    same.setSlideSize(QSize(150, 180));
+    QImage image(150, 180, QImage::Format_RGB32);
+    image.fill(Qt::red);
+    for (int i = 0; i < 30; ++i)
+        same.addSlide(image);
+    same.setCenterIndex(10);
+    QCOMPARE(settle(&same).pixel(center), qRgb(255, 0, 0));
+    // 360x150 pixels, the slide and its reflection
+    QCOMPARE(same.cachedBytes(), qint64(360 * 150 * 4));
+
+    // large artwork is only kept at the slide size once shown
+    QImage artwork(600, 720, QImage::Format_RGB32);
+    artwork.fill(Qt::blue);
+    same.setSlide(10, artwork);
+    settle(&same);
+    QCOMPARE(same.slide(10).size(), QSize(150, 180));
+}
+
+void tst_PictureFlow::cacheBudget()
+{
+    static const qint64 budget = 4 * 1024 * 1024;
+
+    PictureFlow flow;
+    flow.resize(643, 401);
+    flow.setSlideSize(QSize(150, 180));
+    flow.setCacheSize(budget);
+    addSlides(&flow, 100, QSize(150, 180));
+    const QPoint center(flow.width() / 2, flow.height() / 2);
+
+    for (int index = 0; index < 100; index += 10) {
+        flow.setCenterIndex(index);
+        QCOMPARE(settle(&flow).pixel(center), slideColor(index).rgb());
+        QVERIFY(flow.cachedBytes() <= budget);
+    }
+
+    // the first slides have been evicted and are prepared again
+    flow.setCenterIndex(0);
+    QVERIFY(renderFrame(&flow).pixel(center) != slideColor(0).rgb());
+    QCOMPARE(settle(&flow).pixel(center), slideColor(0).rgb());
+    QVERIFY(flow.cachedBytes() <= budget);
+}
+
+void tst_PictureFlow::diskCache()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QPoint center(643 / 2, 401 / 2);
+
+    QImage steady;
+    {
+        PictureFlow flow;
+        flow.resize(643, 401);
+        flow.setSlideSize(QSize(150, 180));
+        flow.setCacheDirectory(dir.path());
+        addSlides(&flow, 30, QSize(150, 180));
+        flow.setCenterIndex(10);
+        steady = settle(&flow);
+    }
+    QVERIFY(!QDir(dir.path()).entryList(QDir::Files).isEmpty());
+
+    // after a restart, the slides show right away
+    {
+        PictureFlow flow;
+        flow.resize(643, 401);
+        flow.setSlideSize(QSize(150, 180));
+        flow.setCacheDirectory(dir.path());
+        addSlides(&flow, 30, QSize(150, 180));
+        flow.setCenterIndex(10);
+        QCOMPARE(renderFrame(&flow), steady);
+        QVERIFY(!flow.isPreparingSlides());
+    }
+
+    // damaged files are prepared again
+    Q_FOREACH (const QFileInfo &file, QDir(dir.path()).entryInfoList(QDir::Files)) {
+        QFile surface(file.filePath());
+        QVERIFY(surface.open(QIODevice::ReadWrite));
+        QVERIFY(surface.resize(file.size() / 2));
+    }
+    {
+        PictureFlow flow;
+        flow.resize(643, 401);
+        flow.setSlideSize(QSize(150, 180));
+        flow.setCacheDirectory(dir.path());
+        addSlides(&flow, 30, QSize(150, 180));
+        flow.setCenterIndex(10);
+        QVERIFY(renderFrame(&flow).pixel(center) != slideColor(10).rgb());
+        QCOMPARE(settle(&flow), steady);
+    }
+
+    // beyond its size, the oldest files are removed
+    {
+        PictureFlow flow;
+        flow.setCacheDirectory(dir.path(), 360 * 150 * 4 * 3);
+        renderFrame(&flow);
+    }
+    QVERIFY(QDir(dir.path()).entryList(QDir::Files).count() <= 3);
+
+    // and while surfaces are stored
+    QTemporaryDir sessionDir;
+    QVERIFY(sessionDir.isValid());
+    {
+        PictureFlow flow;
+        flow.resize(643, 401);
+        flow.setSlideSize(QSize(150, 180));
+        flow.setCacheDirectory(sessionDir.path(), 360 * 150 * 4 * 3);
+        addSlides(&flow, 30, QSize(150, 180));
+        flow.setCenterIndex(10);
+        settle(&flow);
+        flow.setCenterIndex(25);
+        settle(&flow);
+        QVERIFY(QDir(sessionDir.path()).entryList(QDir::Files).count() <= 3);
+    }
+}
+
+void tst_PictureFlow::renderThreads_data()
+{
+    QTest::addColumn<int>("threads");
+
+    QTest::newRow("2 threads") << 2;
+    QTest::newRow("3 threads") << 3;
+    QTest::newRow("7 threads") << 7;
+    QTest::newRow("one per core") << 0;
+}
+
+void tst_PictureFlow::renderThreads()
+{
+    QFETCH(int, threads);
+
+    PictureFlow flow;
+    flow.resize(643, 401);
+    flow.setSlideSize(QSize(150, 180));
+    addSlides(&flow, 12, QSize(150, 180));
+    flow.setCenterIndex(5);
+
+    flow.setRenderThreadCount(1);
+    const QImage steady = settle(&flow);
+    // the center slide is drawn unblended
+    QCOMPARE(steady.pixel(flow.width() / 2, flow.height() / 2), slideColor(5).rgb());
+
+    flow.setRenderThreadCount(threads);
+    QCOMPARE(renderFrame(&flow), steady);
+
+    // in the middle of the transition, with fading side slides
+    flow.showNext();
+    for (int i = 0; i < 3; ++i)
+        stepAnimation(&flow);
+
+    flow.setRenderThreadCount(1);
+    const QImage moving = settle(&flow);
+    QVERIFY(moving != steady);
+
+    flow.setRenderThreadCount(threads);
+    QCOMPARE(renderFrame(&flow), moving);
+}
+
+void tst_PictureFlow::benchmarkAnimation_data()
+{
+    QTest::addColumn<int>("threads");
+
+    QTest::newRow("1 thread") << 1;
+    QTest::newRow("one per core") << 0;
+}
+
+/**
+ * Renders 60 frames of the cover flow animation at 1920x1200, the size of the target screen.
+ */
+void tst_PictureFlow::benchmarkAnimation()
+{
+    QFETCH(int, threads);
+
+    PictureFlow flow;
+    flow.resize(1920, 1200);
+    flow.setSlideSize(QSize(400, 400));
+    flow.setRenderThreadCount(threads);
+    addSlides(&flow, 40, QSize(400, 400));
+    flow.setCenterIndex(0);
+
+    // prepare the surfaces outside of the measurement
+    for (int index = 0; index < 40; index += 5) {
+        flow.setCenterIndex(index);
+        settle(&flow);
+    }
+    flow.setCenterIndex(0);
+    settle(&flow);
+
+    QBENCHMARK {
+        flow.setCenterIndex(0);
+        flow.showSlide(39);
+        for (int i = 0; i < 60; ++i) {
+            stepAnimation(&flow);
+            renderFrame(&flow);
+        }
+    }
+}
+
+/**
+ * Prepares the surfaces of 40 400x400 covers with blurred reflections, the way the slides of a flick
+ * through a music library come into view.
+ */
+void tst_PictureFlow::benchmarkPreparation()
+{
+    QBENCHMARK {
+        PictureFlow flow;
+        flow.resize(1920, 1200);
+        flow.setSlideSize(QSize(400, 400));
+        addSlides(&flow, 40, QSize(400, 400));
+
+        for (int index = 0; index < 40; index += 10) {
+            flow.setCenterIndex(index);
+            settle(&flow);
+        }
+    }
+}
+
+/**
+ * The same as benchmarkPreparation, after a restart with the surfaces of the previous run on disk.
+ */
+void tst_PictureFlow::benchmarkDiskCache()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    {
+        PictureFlow flow;
+        flow.resize(1920, 1200);
+        flow.setSlideSize(QSize(400, 400));
+        flow.setCacheDirectory(dir.path());
+        addSlides(&flow, 40, QSize(400, 400));
+        for (int index = 0; index < 40; index += 10) {
+            flow.setCenterIndex(index);
+            settle(&flow);
+        }
+    }
+
+    QBENCHMARK {
+        PictureFlow flow;
+        flow.resize(1920, 1200);
+        flow.setSlideSize(QSize(400, 400));
+        flow.setCacheDirectory(dir.path());
+        addSlides(&flow, 40, QSize(400, 400));
+
+        for (int index = 0; index < 40; index += 10) {
+            flow.setCenterIndex(index);
+            settle(&flow);
+        }
+    }
+}
+
+QTEST_MAIN(tst_PictureFlow)
+#include "tst_pictureflow.moc"
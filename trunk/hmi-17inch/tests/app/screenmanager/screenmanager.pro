@@ -1,5 +1,7 @@
 include(../../unittests.pri)
 
+include($$SOURCE_ROOT/app/windowmanager/windowmanager.pri)
+
 TARGET=tst_screenmanager
 
 SOURCES += tst_screenmanager.cpp \
@@ -0,0 +1,10 @@
+include(../../unittests.pri)
+
+QT += qml
+
+TARGET = tst_serviceregistry
+
+SOURCES += tst_serviceregistry.cpp \
+           $$SOURCE_ROOT/app/ServiceRegistry.cpp
+
+HEADERS += $$SOURCE_ROOT/app/ServiceRegistry.h
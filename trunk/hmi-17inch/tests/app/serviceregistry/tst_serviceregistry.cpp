@@ -0,0 +1,265 @@
+#include <QtTest/QtTest>
+
+#include <ServiceRegistry.h>
+
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QQmlComponent>
+#include <QQmlContext>
+#include <QQmlEngine>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QThread>
+
+/// How long a slow service takes to create, like one opening PPS objects that are not there yet
+static const int SLOW_SERVICE_MSECS = 200;
+
+class CounterService : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(int value READ value CONSTANT)
+
+public:
+    explicit CounterService(QObject *parent = 0)
+        : QObject(parent)
+    {
+        ++s_instances;
+    }
+
+    int value() const
+    {
+        return 42;
+    }
+
+    static int s_instances;
+};
+
+int CounterService::s_instances = 0;
+
+static QObject *createService(const char *name)
+{
+    QObject *service = new QObject;
+    service->setObjectName(QLatin1String(name));
+    service->setProperty("createdOn", qulonglong(quintptr(QThread::currentThread())));
+    return service;
+}
+
+static QObject *createSlowService(ServiceRegistry *registry)
+{
+    Q_UNUSED(registry);
+
+    QThread::msleep(SLOW_SERVICE_MSECS);
+    return createService("slow");
+}
+
+static QObject *createPlainService(ServiceRegistry *registry)
+{
+    Q_UNUSED(registry);
+    return createService("plain");
+}
+
+static QObject *createDependentService(ServiceRegistry *registry)
+{
+    QObject *service = createService("dependent");
+    service->setProperty("dependencyFound", registry->service(QStringLiteral("first")) != 0
+                                            && registry->service(QStringLiteral("second")) != 0);
+    return service;
+}
+
+static QObject *createNullService(ServiceRegistry *registry)
+{
+    Q_UNUSED(registry);
+    return 0;
+}
+
+static QThread *createdOn(QObject *service)
+{
+    return reinterpret_cast<QThread *>(quintptr(service->property("createdOn").toULongLong()));
+}
+
+class tst_ServiceRegistry : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testDependencies();
+    void testConcurrentCreation();
+    void testThreadAffinity();
+    void testPhases();
+    void testMissingDependencies();
+    void testExport();
+    void testQmlSingleton();
+    void testTimeline();
+};
+
+void tst_ServiceRegistry::testDependencies()
+{
+    ServiceRegistry registry;
+    // added before its dependencies
+    registry.add(QStringLiteral("dependent"), &createDependentService, ServiceRegistry::BeforeFirstFrame,
+                 QStringList() << QStringLiteral("first") << QStringLiteral("second"));
+    registry.add(QStringLiteral("first"), &createSlowService, ServiceRegistry::BeforeFirstFrame);
+    registry.add(QStringLiteral("second"), &createPlainService, ServiceRegistry::BeforeFirstFrame, QStringList(), ServiceRegistry::GuiThread);
+
+    QSignalSpy createdSpy(&registry, SIGNAL(serviceCreated(QString,QObject*)));
+    QVERIFY(registry.start(ServiceRegistry::BeforeFirstFrame));
+
+    QObject *dependent = registry.service(QStringLiteral("dependent"));
+    QVERIFY(dependent);
+    QVERIFY(dependent->property("dependencyFound").toBool());
+
+    QCOMPARE(createdSpy.count(), 3);
+    QCOMPARE(createdSpy.last().at(0).toString(), QStringLiteral("dependent"));
+}
+
+void tst_ServiceRegistry::testConcurrentCreation()
+{
+    ServiceRegistry registry;
+    registry.add(QStringLiteral("slow1"), &createSlowService, ServiceRegistry::BeforeFirstFrame);
+    registry.add(QStringLiteral("slow2"), &createSlowService, ServiceRegistry::BeforeFirstFrame);
+    registry.add(QStringLiteral("slow3"), &createSlowService, ServiceRegistry::BeforeFirstFrame);
+
+    QElapsedTimer timer;
+    timer.start();
+    QVERIFY(registry.start(ServiceRegistry::BeforeFirstFrame));
+    if (QThread::idealThreadCount() >= 3)
+        QVERIFY(timer.elapsed() < 2 * SLOW_SERVICE_MSECS);
+
+    // created on the pool, used on the GUI thread
+    QObject *service = registry.service(QStringLiteral("slow1"));
+    QVERIFY(createdOn(service) != QThread::currentThread());
+    QCOMPARE(service->thread(), QThread::currentThread());
+}
+
+void tst_ServiceRegistry::testThreadAffinity()
+{
+    ServiceRegistry registry;
+    registry.add(QStringLiteral("gui"), &createPlainService, ServiceRegistry::BeforeFirstFrame, QStringList(), ServiceRegistry::GuiThread);
+    QVERIFY(registry.start(ServiceRegistry::BeforeFirstFrame));
+
+    QObject *service = registry.service(QStringLiteral("gui"));
+    QCOMPARE(createdOn(service), QThread::currentThread());
+}
+
+void tst_ServiceRegistry::testPhases()
+{
+    ServiceRegistry registry;
+    registry.add(QStringLiteral("visible"), &createPlainService, ServiceRegistry::BeforeFirstFrame);
+    registry.add(QStringLiteral("later"), &createPlainService, ServiceRegistry::AfterFirstFrame);
+    registry.add(QStringLiteral("lazy"), &createPlainService, ServiceRegistry::OnDemand);
+    registry.add(QStringLiteral("lazyDependent"), &createPlainService, ServiceRegistry::OnDemand,
+                 QStringList() << QStringLiteral("lazy"));
+
+    QVERIFY(registry.start(ServiceRegistry::BeforeFirstFrame));
+    QVERIFY(registry.isCreated(QStringLiteral("visible")));
+    QVERIFY(!registry.isCreated(QStringLiteral("later")));
+    QVERIFY(!registry.isCreated(QStringLiteral("lazy")));
+
+    QVERIFY(registry.start(ServiceRegistry::AfterFirstFrame));
+    QVERIFY(registry.isCreated(QStringLiteral("later")));
+    QVERIFY(!registry.isCreated(QStringLiteral("lazy")));
+
+    // created with its dependencies when it is used
+    QVERIFY(registry.service(QStringLiteral("lazyDependent")));
+    QVERIFY(registry.isCreated(QStringLiteral("lazy")));
+}
+
+void tst_ServiceRegistry::testMissingDependencies()
+{
+    ServiceRegistry registry;
+    registry.add(QStringLiteral("chicken"), &createPlainService, ServiceRegistry::BeforeFirstFrame, QStringList() << QStringLiteral("egg"));
+    registry.add(QStringLiteral("egg"), &createPlainService, ServiceRegistry::BeforeFirstFrame, QStringList() << QStringLiteral("chicken"));
+    QVERIFY(!registry.start(ServiceRegistry::BeforeFirstFrame));
+    QVERIFY(!registry.isCreated(QStringLiteral("egg")));
+
+    ServiceRegistry unknownRegistry;
+    unknownRegistry.add(QStringLiteral("orphan"), &createPlainService, ServiceRegistry::BeforeFirstFrame, QStringList() << QStringLiteral("parent"));
+    QVERIFY(!unknownRegistry.start(ServiceRegistry::BeforeFirstFrame));
+    QVERIFY(!unknownRegistry.service(QStringLiteral("orphan")));
+
+    ServiceRegistry failingRegistry;
+    failingRegistry.add(QStringLiteral("null"), &createNullService, ServiceRegistry::BeforeFirstFrame);
+    QVERIFY(!failingRegistry.start(ServiceRegistry::BeforeFirstFrame));
+}
+
+void tst_ServiceRegistry::testExport()
+{
+    ServiceRegistry registry;
+    registry.add(QStringLiteral("plain"), &createPlainService, ServiceRegistry::BeforeFirstFrame);
+    registry.add(QStringLiteral("lazy"), &createPlainService, ServiceRegistry::OnDemand);
+    QVERIFY(registry.start(ServiceRegistry::BeforeFirstFrame));
+
+    QQmlEngine engine;
+    registry.exportTo(engine.rootContext());
+    QCOMPARE(engine.rootContext()->contextProperty(QStringLiteral("_plain")).value<QObject *>(),
+             registry.service(QStringLiteral("plain")));
+    QVERIFY(!engine.rootContext()->contextProperty(QStringLiteral("_lazy")).isValid());
+}
+
+void tst_ServiceRegistry::testQmlSingleton()
+{
+    ServiceRegistry registry;
+    registry.add<CounterService>(QStringLiteral("counter"), ServiceRegistry::OnDemand);
+    registry.registerQmlSingleton<CounterService>(QStringLiteral("counter"), "test.services", 1, 0, "Counter");
+
+    QQmlEngine engine;
+    registry.exportTo(engine.rootContext());
+    QCOMPARE(CounterService::s_instances, 0);
+
+    QQmlComponent component(&engine);
+    component.setData("import QtQml 2.0\n"
+                      "import test.services 1.0 as Services\n"
+                      "QtObject { property int value: Services.Counter.value }\n", QUrl());
+    QScopedPointer<QObject> object(component.create());
+    QVERIFY2(object, qPrintable(component.errorString()));
+
+    QCOMPARE(object->property("value").toInt(), 42);
+    QCOMPARE(CounterService::s_instances, 1);
+    QVERIFY(registry.isCreated(QStringLiteral("counter")));
+}
+
+void tst_ServiceRegistry::testTimeline()
+{
+    ServiceRegistry registry;
+    registry.add(QStringLiteral("slow"), &createSlowService, ServiceRegistry::BeforeFirstFrame);
+    registry.add(QStringLiteral("gui"), &createPlainService, ServiceRegistry::BeforeFirstFrame, QStringList(), ServiceRegistry::GuiThread);
+
+    const qint64 start = registry.timestamp();
+    QVERIFY(registry.start(ServiceRegistry::BeforeFirstFrame));
+    registry.addSpan(QStringLiteral("Loading main.qml"), start);
+    registry.addMark(QStringLiteral("First frame"));
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString fileName = dir.path() + QStringLiteral("/startup.json");
+    QVERIFY(registry.writeTimeline(fileName));
+
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QJsonParseError error;
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &error);
+    QCOMPARE(error.error, QJsonParseError::NoError);
+
+    QHash<QString, QJsonObject> events;
+    Q_FOREACH (const QJsonValue &value, document.object().value(QStringLiteral("traceEvents")).toArray()) {
+        const QJsonObject event = value.toObject();
+        if (event.value(QStringLiteral("ph")).toString() != QLatin1String("M"))
+            events.insert(event.value(QStringLiteral("name")).toString(), event);
+    }
+
+    const QJsonObject slow = events.value(QStringLiteral("slow"));
+    QCOMPARE(slow.value(QStringLiteral("ph")).toString(), QStringLiteral("X"));
+    QCOMPARE(slow.value(QStringLiteral("cat")).toString(), QStringLiteral("service"));
+    QVERIFY(slow.value(QStringLiteral("dur")).toDouble() >= SLOW_SERVICE_MSECS * 1000);
+    QVERIFY(slow.value(QStringLiteral("tid")).toInt() != 0);
+    QCOMPARE(events.value(QStringLiteral("gui")).value(QStringLiteral("tid")).toInt(), 0);
+
+    QVERIFY(events.contains(QStringLiteral("BeforeFirstFrame")));
+    QVERIFY(events.contains(QStringLiteral("Loading main.qml")));
+    QCOMPARE(events.value(QStringLiteral("First frame")).value(QStringLiteral("ph")).toString(), QStringLiteral("i"));
+}
+
+QTEST_MAIN(tst_ServiceRegistry)
+#include "tst_serviceregistry.moc"
@@ -0,0 +1,277 @@
+#include <QtTest/QtTest>
+
+#include <MockScreen.h>
+#include <WindowManager.h>
+
+#include <QElapsedTimer>
+#include <QSignalSpy>
+#include <QThread>
+
+static const Q_PID TEST_PID = 4242;
+
+/**
+ * Runs the WindowManager event loop against the mock screen backend, the way main.cpp runs it on the target.
+ */
+class tst_WindowManagerLoop : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void init();
+    void cleanup();
+
+    void testRequestLatency();
+    void testCoalescing();
+    void testWindowEvents();
+    void testTransaction();
+    void testWindowGroup();
+    void testWindowGroupOrdering();
+    void testQuit();
+    void benchmarkRequestLatency();
+
+private:
+    WindowManager *windowManager;
+    QThread *windowManagerThread;
+    screen_window_t window;
+};
+
+void tst_WindowManagerLoop::init()
+{
+    MockScreen::reset();
+
+    windowManager = new WindowManager;
+    QVERIFY(windowManager->init());
+
+    windowManagerThread = new QThread;
+    windowManager->moveToThread(windowManagerThread);
+    QObject::connect(windowManager, SIGNAL(quit(int,QString)),
+                     windowManagerThread, SLOT(quit()), Qt::DirectConnection);
+    windowManagerThread->start();
+    QMetaObject::invokeMethod(windowManager, "run", Qt::QueuedConnection);
+
+    QSignalSpy postedSpy(windowManager, SIGNAL(windowPosted(Q_PID)));
+    window = MockScreen::postWindow(TEST_PID, QStringLiteral("test"));
+    QTRY_COMPARE(postedSpy.count(), 1);
+
+    // a posted window gets the properties requested for its process
+    QTRY_COMPARE(windowManager->flushStatistics().flushes, 1);
+    windowManager->resetFlushStatistics();
+}
+
+void tst_WindowManagerLoop::cleanup()
+{
+    windowManager->requestQuit();
+    QVERIFY(windowManagerThread->wait(5000));
+
+    delete windowManager;
+    delete windowManagerThread;
+}
+
+void tst_WindowManagerLoop::testRequestLatency()
+{
+    windowManager->setZValue(TEST_PID, 10);
+    QTRY_COMPARE(windowManager->flushStatistics().flushes, 1);
+    QCOMPARE(MockScreen::windowProperty(window, SCREEN_PROPERTY_ZORDER), 10);
+
+    windowManager->setGeometry(TEST_PID, QRect(10, 20, 300, 200));
+    windowManager->setVisible(TEST_PID, false);
+    QTRY_COMPARE(windowManager->flushStatistics().requests, 3);
+    QCOMPARE(MockScreen::windowProperty(window, SCREEN_PROPERTY_POSITION, 0), 10);
+    QCOMPARE(MockScreen::windowProperty(window, SCREEN_PROPERTY_POSITION, 1), 20);
+    QCOMPARE(MockScreen::windowProperty(window, SCREEN_PROPERTY_SIZE, 0), 300);
+    QCOMPARE(MockScreen::windowProperty(window, SCREEN_PROPERTY_SIZE, 1), 200);
+    QCOMPARE(MockScreen::windowProperty(window, SCREEN_PROPERTY_VISIBLE), 0);
+
+    // the event loop used to pick up requests every 100ms
+    QVERIFY(windowManager->flushStatistics().maxLatency < 50 * 1000000);
+}
+
+void tst_WindowManagerLoop::testCoalescing()
+{
+    // requests made while a flush is in progress are applied with the next one
+    MockScreen::setFlushLatency(50);
+    const int flushCount = MockScreen::flushCount();
+
+    windowManager->setZValue(TEST_PID, 1);
+    for (int i = 0; i < 10; ++i)
+        windowManager->setPosition(TEST_PID, QPoint(i, 2 * i));
+
+    QTRY_COMPARE(windowManager->flushStatistics().requests, 11);
+    const WindowManager::FlushStatistics statistics = windowManager->flushStatistics();
+    QVERIFY(statistics.flushes <= 2);
+    QCOMPARE(MockScreen::flushCount() - flushCount, statistics.flushes);
+
+    QCOMPARE(MockScreen::windowProperty(window, SCREEN_PROPERTY_ZORDER), 1);
+    QCOMPARE(MockScreen::windowProperty(window, SCREEN_PROPERTY_POSITION, 0), 9);
+    QCOMPARE(MockScreen::windowProperty(window, SCREEN_PROPERTY_POSITION, 1), 18);
+}
+
+void tst_WindowManagerLoop::testWindowEvents()
+{
+    QSignalSpy groupSpy(windowManager, SIGNAL(windowGroupPosted(QString,Q_PID)));
+    QSignalSpy closedSpy(windowManager, SIGNAL(windowClosed(Q_PID)));
+
+    // requests for a process apply to windows it posts later
+    windowManager->setZValue(TEST_PID + 1, 5);
+    screen_window_t other = MockScreen::postWindow(TEST_PID + 1, QStringLiteral("other"));
+
+    QTRY_COMPARE(groupSpy.count(), 1);
+    QCOMPARE(groupSpy.at(0).at(0).toString(), QStringLiteral("other"));
+    QCOMPARE(groupSpy.at(0).at(1).value<Q_PID>(), TEST_PID + 1);
+    QTRY_COMPARE(MockScreen::windowProperty(other, SCREEN_PROPERTY_ZORDER), 5);
+
+    MockScreen::closeWindow(other);
+    QTRY_COMPARE(closedSpy.count(), 1);
+    QCOMPARE(closedSpy.at(0).at(0).value<Q_PID>(), TEST_PID + 1);
+}
+
+void tst_WindowManagerLoop::testTransaction()
+{
+    QSignalSpy postedSpy(windowManager, SIGNAL(windowPosted(Q_PID)));
+    screen_window_t other = MockScreen::postWindow(TEST_PID + 1, QStringLiteral("other"));
+    QTRY_COMPARE(postedSpy.count(), 1);
+    QTRY_COMPARE(windowManager->flushStatistics().flushes, 1);
+    windowManager->resetFlushStatistics();
+
+    QSignalSpy flushedSpy(windowManager, SIGNAL(transactionFlushed(quint64)));
+
+    // a screen switch: one window goes away, the other one comes up
+    const quint64 id = windowManager->begin();
+    windowManager->setZValue(TEST_PID, -1);
+    windowManager->setVisible(TEST_PID, false);
+
+    // nested transactions are part of the outer one
+    QCOMPARE(windowManager->begin(), id);
+    windowManager->setGeometry(TEST_PID + 1, QRect(0, 100, 800, 600));
+    windowManager->setZValue(TEST_PID + 1, 10);
+    QCOMPARE(windowManager->commit(), id);
+
+    QTest::qWait(50);
+    QCOMPARE(windowManager->flushStatistics().flushes, 0);
+    QCOMPARE(flushedSpy.count(), 0);
+
+    QCOMPARE(windowManager->commit(), id);
+    QTRY_COMPARE(flushedSpy.count(), 1);
+    QCOMPARE(flushedSpy.at(0).at(0).value<quint64>(), id);
+
+    const WindowManager::FlushStatistics statistics = windowManager->flushStatistics();
+    QCOMPARE(statistics.flushes, 1);
+    QCOMPARE(statistics.requests, 4);
+
+    QCOMPARE(MockScreen::windowProperty(window, SCREEN_PROPERTY_ZORDER), -1);
+    QCOMPARE(MockScreen::windowProperty(window, SCREEN_PROPERTY_VISIBLE), 0);
+    QCOMPARE(MockScreen::windowProperty(other, SCREEN_PROPERTY_POSITION, 1), 100);
+    QCOMPARE(MockScreen::windowProperty(other, SCREEN_PROPERTY_SIZE, 0), 800);
+    QCOMPARE(MockScreen::windowProperty(other, SCREEN_PROPERTY_ZORDER), 10);
+
+    // an empty transaction is reported as well
+    const quint64 emptyId = windowManager->begin();
+    QVERIFY(emptyId != id);
+    windowManager->commit();
+    QTRY_COMPARE(flushedSpy.count(), 2);
+    QCOMPARE(flushedSpy.at(1).at(0).value<quint64>(), emptyId);
+    QCOMPARE(windowManager->flushStatistics().flushes, 1);
+
+    // transactions committed during a flush share the next one, reported with the last id only
+    MockScreen::setFlushLatency(50);
+    windowManager->setPosition(TEST_PID, QPoint(1, 1));
+    QTest::qWait(10);
+    const quint64 skippedId = windowManager->begin();
+    windowManager->setPosition(TEST_PID, QPoint(2, 2));
+    windowManager->commit();
+    const quint64 lastId = windowManager->begin();
+    windowManager->setPosition(TEST_PID, QPoint(3, 3));
+    windowManager->commit();
+    QVERIFY(lastId > skippedId);
+
+    QTRY_COMPARE(flushedSpy.count(), 3);
+    QCOMPARE(flushedSpy.at(2).at(0).value<quint64>(), lastId);
+    QTest::qWait(100);
+    QCOMPARE(flushedSpy.count(), 3);
+    QCOMPARE(MockScreen::windowProperty(window, SCREEN_PROPERTY_POSITION, 0), 3);
+}
+
+void tst_WindowManagerLoop::testWindowGroup()
+{
+    windowManager->setZValue(QStringLiteral("test"), 7);
+    windowManager->setSensitivity(QStringLiteral("test"), WindowManager::Always);
+    QTRY_COMPARE(windowManager->flushStatistics().requests, 2);
+    QCOMPARE(MockScreen::windowProperty(window, SCREEN_PROPERTY_ZORDER), 7);
+    QCOMPARE(MockScreen::windowProperty(window, SCREEN_PROPERTY_SENSITIVITY), int(WindowManager::Always));
+
+    // unknown window groups are ignored
+    windowManager->setZValue(QStringLiteral("unknown"), 1);
+    QTest::qWait(50);
+    QCOMPARE(windowManager->flushStatistics().requests, 2);
+}
+
+void tst_WindowManagerLoop::testWindowGroupOrdering()
+{
+    // as in main.cpp: the window group is raised once, ApplicationManager raises the process later on
+    windowManager->setZValue(QStringLiteral("test"), 7);
+    windowManager->setSensitivity(QStringLiteral("test"), WindowManager::Always);
+    QTRY_COMPARE(windowManager->flushStatistics().requests, 2);
+    QCOMPARE(MockScreen::windowProperty(window, SCREEN_PROPERTY_ZORDER), 7);
+
+    windowManager->setZValue(TEST_PID, 3);
+    windowManager->setSensitivity(TEST_PID, WindowManager::Never);
+    QTRY_COMPARE(windowManager->flushStatistics().requests, 4);
+    QCOMPARE(MockScreen::windowProperty(window, SCREEN_PROPERTY_ZORDER), 3);
+    QCOMPARE(MockScreen::windowProperty(window, SCREEN_PROPERTY_SENSITIVITY), int(WindowManager::Never));
+
+    QSignalSpy flushedSpy(windowManager, SIGNAL(transactionFlushed(quint64)));
+
+    // within a flush, the last request wins
+    windowManager->begin();
+    windowManager->setZValue(QStringLiteral("test"), 8);
+    windowManager->setZValue(TEST_PID, 4);
+    windowManager->commit();
+    QTRY_COMPARE(flushedSpy.count(), 1);
+    QCOMPARE(MockScreen::windowProperty(window, SCREEN_PROPERTY_ZORDER), 4);
+
+    windowManager->begin();
+    windowManager->setZValue(TEST_PID, 5);
+    windowManager->setZValue(QStringLiteral("test"), 9);
+    windowManager->commit();
+    QTRY_COMPARE(flushedSpy.count(), 2);
+    QCOMPARE(MockScreen::windowProperty(window, SCREEN_PROPERTY_ZORDER), 9);
+
+    // the window group request is applied once, later requests for the process bring back its own z-order
+    windowManager->setVisible(TEST_PID, true);
+    QTRY_COMPARE(windowManager->flushStatistics().requests, 9);
+    QCOMPARE(MockScreen::windowProperty(window, SCREEN_PROPERTY_ZORDER), 5);
+}
+
+void tst_WindowManagerLoop::testQuit()
+{
+    // woken up right away, not after the event timeout
+    QElapsedTimer timer;
+    timer.start();
+    windowManager->requestQuit();
+    QVERIFY(windowManagerThread->wait(5000));
+    QVERIFY(timer.elapsed() < 500);
+}
+
+/**
+ * Measures how long a position change takes to reach the screen, as when switching between Navigation and the HMI.
+ */
+void tst_WindowManagerLoop::benchmarkRequestLatency()
+{
+    int flushes = 0;
+    int position = 0;
+
+    QBENCHMARK {
+        windowManager->setPosition(TEST_PID, QPoint(++position, 0));
+        ++flushes;
+
+        while (windowManager->flushStatistics().flushes < flushes)
+            QThread::yieldCurrentThread();
+    }
+
+    const WindowManager::FlushStatistics statistics = windowManager->flushStatistics();
+    qDebug("%d flushes, average latency %lld us, max %lld us", statistics.flushes,
+           statistics.totalLatency / qMax(statistics.flushes, 1) / 1000, statistics.maxLatency / 1000);
+}
+
+QTEST_MAIN(tst_WindowManagerLoop)
+#include "tst_windowmanagerloop.moc"
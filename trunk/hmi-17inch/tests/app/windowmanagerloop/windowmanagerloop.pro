@@ -0,0 +1,7 @@
+include(../../unittests.pri)
+
+include($$SOURCE_ROOT/app/windowmanager/windowmanager.pri)
+
+TARGET = tst_windowmanagerloop
+
+SOURCES += tst_windowmanagerloop.cpp